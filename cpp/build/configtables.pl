@@ -0,0 +1,337 @@
+#!/usr/bin/perl
+#
+# Compile device_classes.xml, NotificationCCTypes.xml and SensorMultiLevelCCTypes.xml
+# into the constant tables of cpp/src/ConfigTableData.h, so the library does not
+# have to parse them at startup.  Every table is sorted by id for binary search,
+# and the entries that belong to another (the specific device classes of a generic
+# one, the events of a notification type...) are stored as a run of consecutive
+# entries that the parent refers to by index and count.
+#
+# usage: configtables.pl <config directory> <output file>
+
+use strict;
+use warnings;
+
+my ($configDir, $output) = @ARGV;
+die "usage: $0 <config directory> <output file>\n" unless defined $output;
+
+# The XML files are plain enough that a small parser will do, which keeps the
+# build free of perl modules.  Each element becomes a hash with its name,
+# attributes, child elements and text.
+sub Unescape {
+	my ($str) = @_;
+	$str =~ s/&lt;/</g;
+	$str =~ s/&gt;/>/g;
+	$str =~ s/&quot;/"/g;
+	$str =~ s/&apos;/'/g;
+	$str =~ s/&#x([0-9a-fA-F]+);/chr(hex($1))/ge;
+	$str =~ s/&#([0-9]+);/chr($1)/ge;
+	$str =~ s/&amp;/&/g;
+	return $str;
+}
+
+sub Trim {
+	my ($str) = @_;
+	$str =~ s/^\s+|\s+$//g;
+	return $str;
+}
+
+sub ParseXml {
+	my ($file) = @_;
+	open(my $fh, '<:raw', $file) or die "$0: cannot open $file: $!\n";
+	local $/;
+	my $text = <$fh>;
+	close($fh);
+	$text =~ s/<!--.*?-->//gs;
+	$text =~ s/<\?.*?\?>//gs;
+
+	my $top = { name => '', attrs => {}, children => [], text => '' };
+	my @stack = ($top);
+	while ($text =~ /\G([^<]*)<(\/?)([\w:.-]+)((?:[^>"']|"[^"]*"|'[^']*')*?)(\/?)>/gc) {
+		my ($content, $close, $name, $attrText, $empty) = ($1, $2, $3, $4, $5);
+		$stack[-1]{text} .= Unescape($content);
+		if ($close) {
+			my $element = pop @stack;
+			die "$0: $file: </$name> closes <$element->{name}>\n" if @stack == 0 || $element->{name} ne $name;
+			next;
+		}
+		my %attrs;
+		while ($attrText =~ /([\w:.-]+)\s*=\s*(?:"([^"]*)"|'([^']*)')/g) {
+			$attrs{$1} = Unescape(defined $2 ? $2 : $3);
+		}
+		my $element = { name => $name, attrs => \%attrs, children => [], text => '' };
+		push @{$stack[-1]{children}}, $element;
+		push @stack, $element unless $empty;
+	}
+	die "$0: $file: unexpected text or unclosed element\n" if @stack != 1 || $text !~ /\G\s*$/g;
+	die "$0: $file: no root element\n" unless @{$top->{children}};
+	return $top->{children}[0];
+}
+
+# C string literal, with anything but plain printable ASCII as octal escapes
+sub Quote {
+	my ($str) = @_;
+	return 'NULL' unless defined $str;
+	my $out = '';
+	foreach my $c (split //, $str) {
+		my $o = ord($c);
+		$out .= ($o < 0x20 || $o >= 0x7f || $c eq '"' || $c eq '\\' || $c eq '?') ? sprintf('\\%03o', $o) : $c;
+	}
+	return "\"$out\"";
+}
+
+# Command class list as a zero terminated string of octal escapes
+sub QuoteBytes {
+	my ($bytes) = @_;
+	return 'NULL' unless defined $bytes;
+	return '"' . join('', map { sprintf('\\%03o', ord($_)) } split(//, $bytes)) . '"';
+}
+
+sub Required {
+	my ($file, $element, $attr) = @_;
+	my $value = $element->{attrs}{$attr};
+	die "$0: $file: <$element->{name}> is missing its $attr attribute\n" unless defined $value;
+	return $value;
+}
+
+# Add an entry to a map of id to entry, keeping the first like the runtime parser does
+sub AddEntry {
+	my ($file, $map, $id, $entry, $what) = @_;
+	if (exists $map->{$id}) {
+		warn "$0: $file: duplicate $what $id, skipped\n";
+		return;
+	}
+	$map->{$id} = $entry;
+}
+
+my @out;
+
+#-----------------------------------------------------------------------------
+# device_classes.xml
+#-----------------------------------------------------------------------------
+sub DeviceClassEntry {
+	my ($element) = @_;
+	my $ccs;
+	if (defined $element->{attrs}{command_classes}) {
+		$ccs = join('', map { chr(hex($_) & 0xff) } grep { /\S/ } split(/,/, $element->{attrs}{command_classes}));
+	}
+	return {
+		label => defined $element->{attrs}{label} ? $element->{attrs}{label} : '',
+		ccs => $ccs,
+		basic => defined $element->{attrs}{basic} ? hex($element->{attrs}{basic}) & 0xff : 0,
+		specific => {}
+	};
+}
+
+sub WriteDeviceClasses {
+	my ($name, $map, $specifics) = @_;
+	push @out, "\t\t\t\tconstexpr DeviceClass $name\[] =";
+	push @out, "\t\t\t\t{";
+	foreach my $id (sort { $a <=> $b } keys %$map) {
+		my $entry = $map->{$id};
+		my ($first, $count) = (0, 0);
+		if ($specifics) {
+			$first = scalar(@$specifics);
+			foreach my $specific (sort { $a <=> $b } keys %{$entry->{specific}}) {
+				push @$specifics, [ $specific, $entry->{specific}{$specific} ];
+				++$count;
+			}
+		}
+		push @out, sprintf("\t\t\t\t\t{ 0x%02x, %s, %s, 0x%02x, %d, %d },", $id, Quote($entry->{label}), QuoteBytes($entry->{ccs}), $entry->{basic}, $first, $count);
+	}
+	push @out, "\t\t\t\t};";
+	push @out, '';
+}
+
+{
+	my $file = "$configDir/device_classes.xml";
+	my $root = ParseXml($file);
+	my (%basic, %generic, %roles, %deviceTypes, %nodeTypes);
+	foreach my $element (@{$root->{children}}) {
+		next unless defined $element->{attrs}{key};
+		# The key of a DeviceType is a short, the others a byte
+		my $key = hex($element->{attrs}{key}) & 0xffff;
+		if ($element->{name} eq 'Basic') {
+			AddEntry($file, \%basic, $key & 0xff, $element->{attrs}{label}, 'Basic device class') if defined $element->{attrs}{label};
+		}
+		elsif ($element->{name} eq 'Generic') {
+			my $entry = DeviceClassEntry($element);
+			foreach my $child (@{$element->{children}}) {
+				next unless $child->{name} eq 'Specific' && defined $child->{attrs}{key};
+				AddEntry($file, $entry->{specific}, hex($child->{attrs}{key}) & 0xff, DeviceClassEntry($child), 'Specific device class');
+			}
+			AddEntry($file, \%generic, $key & 0xff, $entry, 'Generic device class');
+		}
+		elsif ($element->{name} eq 'Role') {
+			AddEntry($file, \%roles, $key & 0xff, DeviceClassEntry($element), 'Role device class');
+		}
+		elsif ($element->{name} eq 'DeviceType') {
+			AddEntry($file, \%deviceTypes, $key, DeviceClassEntry($element), 'Device type class');
+		}
+		elsif ($element->{name} eq 'NodeType') {
+			AddEntry($file, \%nodeTypes, $key & 0xff, DeviceClassEntry($element), 'Node type');
+		}
+	}
+
+	push @out, "\t\t\t\t// device_classes.xml";
+	push @out, "\t\t\t\tconstexpr BasicDeviceClass c_basicDeviceClasses[] =";
+	push @out, "\t\t\t\t{";
+	push @out, sprintf("\t\t\t\t\t{ 0x%02x, %s },", $_, Quote($basic{$_})) foreach sort { $a <=> $b } keys %basic;
+	push @out, "\t\t\t\t};";
+	push @out, '';
+	my @specifics;
+	WriteDeviceClasses('c_genericDeviceClasses', \%generic, \@specifics);
+	push @out, "\t\t\t\tconstexpr DeviceClass c_specificDeviceClasses[] =";
+	push @out, "\t\t\t\t{";
+	foreach my $specific (@specifics) {
+		my ($id, $entry) = @$specific;
+		push @out, sprintf("\t\t\t\t\t{ 0x%02x, %s, %s, 0x%02x, 0, 0 },", $id, Quote($entry->{label}), QuoteBytes($entry->{ccs}), $entry->{basic});
+	}
+	push @out, "\t\t\t\t};";
+	push @out, '';
+	WriteDeviceClasses('c_roleDeviceClasses', \%roles);
+	WriteDeviceClasses('c_deviceTypeClasses', \%deviceTypes);
+	WriteDeviceClasses('c_nodeTypes', \%nodeTypes);
+}
+
+#-----------------------------------------------------------------------------
+# NotificationCCTypes.xml
+#-----------------------------------------------------------------------------
+my %paramTypes = (
+	location => 'NotificationCCTypes::NEPT_Location',
+	list => 'NotificationCCTypes::NEPT_List',
+	usercodereport => 'NotificationCCTypes::NEPT_UserCodeReport',
+	byte => 'NotificationCCTypes::NEPT_Byte',
+	string => 'NotificationCCTypes::NEPT_String',
+	duration => 'NotificationCCTypes::NEPT_Time'
+);
+
+{
+	my $file = "$configDir/NotificationCCTypes.xml";
+	my $root = ParseXml($file);
+	my $revision = int(Required($file, $root, 'Revision'));
+	my %types;
+	foreach my $typeElement (grep { $_->{name} eq 'AlarmType' } @{$root->{children}}) {
+		my $type = { name => Trim(Required($file, $typeElement, 'name')), events => {} };
+		foreach my $eventElement (grep { $_->{name} eq 'AlarmEvent' } @{$typeElement->{children}}) {
+			my $event = { name => Trim(Required($file, $eventElement, 'name')), params => {} };
+			foreach my $paramElement (grep { $_->{name} eq 'AlarmEventParam' } @{$eventElement->{children}}) {
+				my $paramType = lc(Required($file, $paramElement, 'type'));
+				die "$0: $file: unknown AlarmEventParam type $paramType\n" unless exists $paramTypes{$paramType};
+				my $param = { name => Trim(Required($file, $paramElement, 'name')), type => $paramTypes{$paramType}, items => {} };
+				if ($paramType eq 'list') {
+					foreach my $itemElement (grep { $_->{name} eq 'Item' } @{$paramElement->{children}}) {
+						AddEntry($file, $param->{items}, int(Required($file, $itemElement, 'id')), Required($file, $itemElement, 'label'), 'Item');
+					}
+				}
+				AddEntry($file, $event->{params}, int(Required($file, $paramElement, 'id')), $param, 'AlarmEventParam');
+			}
+			AddEntry($file, $type->{events}, int(Required($file, $eventElement, 'id')), $event, 'AlarmEvent');
+		}
+		AddEntry($file, \%types, int(Required($file, $typeElement, 'id')), $type, 'AlarmType');
+	}
+
+	my (@types, @events, @params, @items);
+	foreach my $typeId (sort { $a <=> $b } keys %types) {
+		my $type = $types{$typeId};
+		my $firstEvent = scalar(@events);
+		foreach my $eventId (sort { $a <=> $b } keys %{$type->{events}}) {
+			my $event = $type->{events}{$eventId};
+			my $firstParam = scalar(@params);
+			foreach my $paramId (sort { $a <=> $b } keys %{$event->{params}}) {
+				my $param = $event->{params}{$paramId};
+				my $firstItem = scalar(@items);
+				push @items, sprintf("\t\t\t\t\t{ %d, %s },", $_, Quote($param->{items}{$_})) foreach sort { $a <=> $b } keys %{$param->{items}};
+				push @params, sprintf("\t\t\t\t\t{ %d, %s, %s, %d, %d },", $paramId, Quote($param->{name}), $param->{type}, $firstItem, scalar(@items) - $firstItem);
+			}
+			push @events, sprintf("\t\t\t\t\t{ %d, %s, %d, %d },", $eventId, Quote($event->{name}), $firstParam, scalar(@params) - $firstParam);
+		}
+		push @types, sprintf("\t\t\t\t\t{ %d, %s, %d, %d },", $typeId, Quote($type->{name}), $firstEvent, scalar(@events) - $firstEvent);
+	}
+
+	push @out, "\t\t\t\t// NotificationCCTypes.xml";
+	push @out, "\t\t\t\tconstexpr uint32 c_notificationRevision = $revision;";
+	push @out, '';
+	foreach my $table ([ 'NotificationType', 'c_notificationTypes', \@types ], [ 'NotificationEvent', 'c_notificationEvents', \@events ], [ 'NotificationEventParam', 'c_notificationEventParams', \@params ], [ 'NotificationListItem', 'c_notificationListItems', \@items ]) {
+		push @out, "\t\t\t\tconstexpr $table->[0] $table->[1]\[] =";
+		push @out, "\t\t\t\t{";
+		push @out, @{$table->[2]};
+		push @out, "\t\t\t\t};";
+		push @out, '';
+	}
+}
+
+#-----------------------------------------------------------------------------
+# SensorMultiLevelCCTypes.xml
+#-----------------------------------------------------------------------------
+{
+	my $file = "$configDir/SensorMultiLevelCCTypes.xml";
+	my $root = ParseXml($file);
+	my $revision = int(Required($file, $root, 'Revision'));
+	my %types;
+	foreach my $typeElement (grep { $_->{name} eq 'SensorType' } @{$root->{children}}) {
+		my $type = { name => Trim(Required($file, $typeElement, 'name')), scales => {} };
+		foreach my $scaleElement (grep { $_->{name} eq 'SensorScale' } @{$typeElement->{children}}) {
+			my $scale = { name => Trim(Required($file, $scaleElement, 'name')), unit => Trim($scaleElement->{text}) };
+			AddEntry($file, $type->{scales}, int(Required($file, $scaleElement, 'id')), $scale, 'SensorScale');
+		}
+		AddEntry($file, \%types, int(Required($file, $typeElement, 'id')), $type, 'SensorType');
+	}
+
+	my (@types, @scales);
+	foreach my $typeId (sort { $a <=> $b } keys %types) {
+		my $type = $types{$typeId};
+		my $firstScale = scalar(@scales);
+		foreach my $scaleId (sort { $a <=> $b } keys %{$type->{scales}}) {
+			my $scale = $type->{scales}{$scaleId};
+			push @scales, sprintf("\t\t\t\t\t{ %d, %s, %s },", $scaleId, Quote($scale->{name}), Quote($scale->{unit}));
+		}
+		push @types, sprintf("\t\t\t\t\t{ %d, %s, %d, %d },", $typeId, Quote($type->{name}), $firstScale, scalar(@scales) - $firstScale);
+	}
+
+	push @out, "\t\t\t\t// SensorMultiLevelCCTypes.xml";
+	push @out, "\t\t\t\tconstexpr uint32 c_sensorRevision = $revision;";
+	push @out, '';
+	push @out, "\t\t\t\tconstexpr SensorType c_sensorTypes[] =";
+	push @out, "\t\t\t\t{";
+	push @out, @types;
+	push @out, "\t\t\t\t};";
+	push @out, '';
+	push @out, "\t\t\t\tconstexpr SensorScale c_sensorScales[] =";
+	push @out, "\t\t\t\t{";
+	push @out, @scales;
+	push @out, "\t\t\t\t};";
+}
+
+open(my $fh, '>:raw', "$output.tmp") or die "$0: cannot write $output.tmp: $!\n";
+print $fh <<'EOF';
+//-----------------------------------------------------------------------------
+//
+//	ConfigTableData.h
+//
+//	Generated by cpp/build/configtables.pl from device_classes.xml,
+//	NotificationCCTypes.xml and SensorMultiLevelCCTypes.xml.  Do not edit,
+//	run "make updateConfigTables" after changing any of those files.
+//
+//-----------------------------------------------------------------------------
+
+// Included by ConfigTables.cpp only
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace ConfigTables
+		{
+			namespace
+			{
+EOF
+print $fh join("\n", @out), "\n";
+print $fh <<'EOF';
+			}
+		} // namespace ConfigTables
+	} // namespace Internal
+} // namespace OpenZWave
+EOF
+close($fh) or die "$0: cannot write $output.tmp: $!\n";
+rename("$output.tmp", $output) or die "$0: cannot rename $output.tmp: $!\n";
@@ -34,6 +34,8 @@ DOT := $(shell which dot)
 MACHINE := $(shell uname -m)
 #the location of xmllink for checking our config files
 XMLLINT := $(shell which xmllint)
+#perl, to regenerate ConfigTableData.h from the config xml files
+PERL := $(shell which perl)
 #temp directory to build our tarfile for make dist target
 TMP     := /tmp
 #pkg-config binary for package config files
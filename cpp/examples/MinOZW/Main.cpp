@@ -328,6 +328,11 @@ int main( int argc, char* argv[] )
 	{
 		Manager::Get()->AddDriver( "HID Controller", Driver::ControllerInterface_Hid );
 	}
+	else if( strncasecmp( port.c_str(), "virtual:", 8 ) == 0 )
+	{
+		// A simulated network, such as "virtual:nodes=20,latency=10"
+		Manager::Get()->AddDriver( port, Driver::ControllerInterface_Virtual );
+	}
 	else
 	{
 		Manager::Get()->AddDriver( port );
@@ -0,0 +1,413 @@
+//-----------------------------------------------------------------------------
+//
+//	AesKey.cpp
+//
+//	AES-128 key schedules, with hardware AES where the CPU has it
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "AesKey.h"
+
+// The hardware backends are compiled for the instructions they use, without
+// changing the flags of the rest of the library, and only run once the CPU
+// has been seen to have them.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define OZW_AES_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define OZW_AES_TARGET
+#else
+#include <cpuid.h>
+#define OZW_AES_TARGET __attribute__((target("aes,sse2")))
+#endif
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO) || (defined(__GNUC__) && !defined(__clang__)))
+#define OZW_AES_ARM
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#if !defined(__ARM_FEATURE_AES) && !defined(__ARM_FEATURE_CRYPTO)
+// GCC declares the crypto intrinsics for any target, but they can only be used
+// in functions compiled for the crypto extension
+#define OZW_AES_TARGET __attribute__((target("+crypto")))
+#else
+#define OZW_AES_TARGET
+#endif
+#endif
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace
+		{
+			typedef void (*EncryptFunction)(aes_encrypt_ctx const* _ctx, uint8 const* _in, uint8* _out);
+			typedef void (*Encrypt2Function)(aes_encrypt_ctx const* _ctxA, uint8 const* _inA, uint8* _outA, aes_encrypt_ctx const* _ctxB, uint8 const* _inB, uint8* _outB);
+
+			struct BackendFunctions
+			{
+					char const* m_name;
+					EncryptFunction m_encrypt;
+					Encrypt2Function m_encrypt2;				// Two blocks with two keys
+			};
+
+			void EncryptPortable(aes_encrypt_ctx const* _ctx, uint8 const* _in, uint8* _out)
+			{
+				aes_encrypt(_in, _out, _ctx);
+			}
+
+			void EncryptPortable2(aes_encrypt_ctx const* _ctxA, uint8 const* _inA, uint8* _outA, aes_encrypt_ctx const* _ctxB, uint8 const* _inB, uint8* _outB)
+			{
+				aes_encrypt(_inA, _outA, _ctxA);
+				aes_encrypt(_inB, _outB, _ctxB);
+			}
+
+#if defined(OZW_AES_X86)
+			bool CpuHasAes()
+			{
+				// CPUID leaf 1, ECX bit 25
+#if defined(_MSC_VER)
+				int info[4];
+				__cpuid(info, 1);
+				return (info[2] & (1 << 25)) != 0;
+#else
+				unsigned int eax, ebx, ecx, edx;
+				return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1u << 25)) != 0;
+#endif
+			}
+
+			OZW_AES_TARGET void EncryptAesNi(aes_encrypt_ctx const* _ctx, uint8 const* _in, uint8* _out)
+			{
+				__m128i const* keys = (__m128i const*) _ctx->ks;
+				__m128i block = _mm_xor_si128(_mm_loadu_si128((__m128i const*) _in), _mm_loadu_si128(keys));
+				for (int round = 1; round < 10; ++round)
+				{
+					block = _mm_aesenc_si128(block, _mm_loadu_si128(keys + round));
+				}
+				_mm_storeu_si128((__m128i*) _out, _mm_aesenclast_si128(block, _mm_loadu_si128(keys + 10)));
+			}
+
+			OZW_AES_TARGET void EncryptAesNi2(aes_encrypt_ctx const* _ctxA, uint8 const* _inA, uint8* _outA, aes_encrypt_ctx const* _ctxB, uint8 const* _inB, uint8* _outB)
+			{
+				__m128i const* keysA = (__m128i const*) _ctxA->ks;
+				__m128i const* keysB = (__m128i const*) _ctxB->ks;
+				__m128i blockA = _mm_xor_si128(_mm_loadu_si128((__m128i const*) _inA), _mm_loadu_si128(keysA));
+				__m128i blockB = _mm_xor_si128(_mm_loadu_si128((__m128i const*) _inB), _mm_loadu_si128(keysB));
+				for (int round = 1; round < 10; ++round)
+				{
+					blockA = _mm_aesenc_si128(blockA, _mm_loadu_si128(keysA + round));
+					blockB = _mm_aesenc_si128(blockB, _mm_loadu_si128(keysB + round));
+				}
+				_mm_storeu_si128((__m128i*) _outA, _mm_aesenclast_si128(blockA, _mm_loadu_si128(keysA + 10)));
+				_mm_storeu_si128((__m128i*) _outB, _mm_aesenclast_si128(blockB, _mm_loadu_si128(keysB + 10)));
+			}
+#endif
+
+#if defined(OZW_AES_ARM)
+			bool CpuHasAes()
+			{
+#if defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO) || defined(__APPLE__)
+				return true;
+#elif defined(__linux__)
+				return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+				return false;
+#endif
+			}
+
+			OZW_AES_TARGET void EncryptArmCrypto(aes_encrypt_ctx const* _ctx, uint8 const* _in, uint8* _out)
+			{
+				// AESE adds the round key before SubBytes and ShiftRows, so the last key is added on its own
+				uint8 const* keys = (uint8 const*) _ctx->ks;
+				uint8x16_t block = vld1q_u8(_in);
+				for (int round = 0; round < 9; ++round)
+				{
+					block = vaesmcq_u8(vaeseq_u8(block, vld1q_u8(keys + 16 * round)));
+				}
+				block = vaeseq_u8(block, vld1q_u8(keys + 144));
+				vst1q_u8(_out, veorq_u8(block, vld1q_u8(keys + 160)));
+			}
+
+			OZW_AES_TARGET void EncryptArmCrypto2(aes_encrypt_ctx const* _ctxA, uint8 const* _inA, uint8* _outA, aes_encrypt_ctx const* _ctxB, uint8 const* _inB, uint8* _outB)
+			{
+				uint8 const* keysA = (uint8 const*) _ctxA->ks;
+				uint8 const* keysB = (uint8 const*) _ctxB->ks;
+				uint8x16_t blockA = vld1q_u8(_inA);
+				uint8x16_t blockB = vld1q_u8(_inB);
+				for (int round = 0; round < 9; ++round)
+				{
+					blockA = vaesmcq_u8(vaeseq_u8(blockA, vld1q_u8(keysA + 16 * round)));
+					blockB = vaesmcq_u8(vaeseq_u8(blockB, vld1q_u8(keysB + 16 * round)));
+				}
+				blockA = vaeseq_u8(blockA, vld1q_u8(keysA + 144));
+				blockB = vaeseq_u8(blockB, vld1q_u8(keysB + 144));
+				vst1q_u8(_outA, veorq_u8(blockA, vld1q_u8(keysA + 160)));
+				vst1q_u8(_outB, veorq_u8(blockB, vld1q_u8(keysB + 160)));
+			}
+#endif
+
+			BackendFunctions const c_backends[AesKey::Backend_Count] =
+			{
+			{ "portable", EncryptPortable, EncryptPortable2 },
+#if defined(OZW_AES_X86)
+			{ "AES-NI", EncryptAesNi, EncryptAesNi2 },
+#else
+			{ "AES-NI", NULL, NULL },
+#endif
+#if defined(OZW_AES_ARM)
+			{ "ARMv8 crypto", EncryptArmCrypto, EncryptArmCrypto2 }
+#else
+			{ "ARMv8 crypto", NULL, NULL }
+#endif
+			};
+
+			AesKey::Backend DetectBackend()
+			{
+				// The tables of the portable code are fixed, unless the build says otherwise
+				aes_init();
+				if (AesKey::IsBackendSupported(AesKey::Backend_AesNi))
+				{
+					return AesKey::Backend_AesNi;
+				}
+				if (AesKey::IsBackendSupported(AesKey::Backend_ArmCrypto))
+				{
+					return AesKey::Backend_ArmCrypto;
+				}
+				return AesKey::Backend_Portable;
+			}
+
+			AesKey::Backend& ActiveBackend()
+			{
+				static AesKey::Backend backend = DetectBackend();
+				return backend;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::AesKey>
+// Constructors
+//-----------------------------------------------------------------------------
+		AesKey::AesKey() :
+				m_backend(Backend_Portable)
+		{
+			memset(&m_ctx, 0, sizeof(m_ctx));
+		}
+
+		AesKey::AesKey(uint8 const _key[16]) :
+				m_backend(Backend_Portable)
+		{
+			SetKey(_key);
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::SetKey>
+// Expand a key
+//-----------------------------------------------------------------------------
+		void AesKey::SetKey(uint8 const _key[16])
+		{
+			m_backend = ActiveBackend();
+			aes_encrypt_key128(_key, &m_ctx);
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::Encrypt>
+// Encrypt one block
+//-----------------------------------------------------------------------------
+		void AesKey::Encrypt(uint8 const _in[16], uint8 _out[16]) const
+		{
+			c_backends[m_backend].m_encrypt(&m_ctx, _in, _out);
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::Ofb>
+// Encrypt or decrypt in OFB mode
+//-----------------------------------------------------------------------------
+		void AesKey::Ofb(uint8 const _iv[16], uint8 const* _in, uint8* _out, uint32 _length) const
+		{
+			uint8 stream[16];
+			memcpy(stream, _iv, 16);
+			for (uint32 offset = 0; offset < _length; offset += 16)
+			{
+				Encrypt(stream, stream);
+				uint32 count = _length - offset < 16 ? _length - offset : 16;
+				for (uint32 i = 0; i < count; ++i)
+				{
+					_out[offset + i] = _in[offset + i] ^ stream[i];
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::CbcMac>
+// CBC-MAC of zero padded data, starting from the encrypted IV
+//-----------------------------------------------------------------------------
+		void AesKey::CbcMac(uint8 const _iv[16], uint8 const* _data, uint32 _length, uint8 _mac[16]) const
+		{
+			Encrypt(_iv, _mac);
+			for (uint32 offset = 0; offset < _length; offset += 16)
+			{
+				uint32 count = _length - offset < 16 ? _length - offset : 16;
+				for (uint32 i = 0; i < count; ++i)
+				{
+					_mac[i] ^= _data[offset + i];
+				}
+				Encrypt(_mac, _mac);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::EncryptAndMac>
+// OFB encrypt, and authenticate the header and the ciphertext
+//-----------------------------------------------------------------------------
+		void AesKey::EncryptAndMac(AesKey const& _encKey, AesKey const& _authKey, uint8 const _iv[16], uint8 const* _header, uint32 _headerLength, uint8 const* _in, uint8* _out, uint32 _length, uint8 _mac[16])
+		{
+			OfbAndMac(_encKey, _authKey, _iv, _header, _headerLength, _in, _out, _length, false, _mac);
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::DecryptAndMac>
+// OFB decrypt, and authenticate the header and the ciphertext
+//-----------------------------------------------------------------------------
+		void AesKey::DecryptAndMac(AesKey const& _encKey, AesKey const& _authKey, uint8 const _iv[16], uint8 const* _header, uint32 _headerLength, uint8 const* _in, uint8* _out, uint32 _length, uint8 _mac[16])
+		{
+			OfbAndMac(_encKey, _authKey, _iv, _header, _headerLength, _in, _out, _length, true, _mac);
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::OfbAndMac>
+// Run the OFB key stream and the CBC-MAC chain side by side.  MAC block i
+// covers ciphertext that is at most in key stream block i, so block i + 1 of
+// the key stream and block i + 1 of the MAC can be encrypted together.
+//-----------------------------------------------------------------------------
+		void AesKey::OfbAndMac(AesKey const& _encKey, AesKey const& _authKey, uint8 const _iv[16], uint8 const* _header, uint32 _headerLength, uint8 const* _in, uint8* _out, uint32 _length, bool _decrypt, uint8 _mac[16])
+		{
+			Encrypt2Function encrypt2 = c_backends[_encKey.m_backend].m_encrypt2;
+			uint32 const macLength = _headerLength + _length;
+			uint32 const macBlocks = (macLength + 15) / 16;
+			uint32 const streamBlocks = (_length + 15) / 16;
+			uint8 const* ciphertext = _decrypt ? _in : _out;
+
+			uint8 stream[16];
+			uint8 block[16];
+			encrypt2(&_encKey.m_ctx, _iv, stream, &_authKey.m_ctx, _iv, _mac);
+			for (uint32 i = 0; i < macBlocks; ++i)
+			{
+				uint32 offset = i * 16;
+				if (i < streamBlocks)
+				{
+					uint32 count = _length - offset < 16 ? _length - offset : 16;
+					for (uint32 j = 0; j < count; ++j)
+					{
+						_out[offset + j] = _in[offset + j] ^ stream[j];
+					}
+				}
+
+				for (uint32 j = 0; j < 16; ++j)
+				{
+					uint32 pos = offset + j;
+					uint8 data = 0;
+					if (pos < _headerLength)
+					{
+						data = _header[pos];
+					}
+					else if (pos < macLength)
+					{
+						data = ciphertext[pos - _headerLength];
+					}
+					block[j] = _mac[j] ^ data;
+				}
+
+				if (i + 1 < streamBlocks)
+				{
+					encrypt2(&_encKey.m_ctx, stream, stream, &_authKey.m_ctx, block, _mac);
+				}
+				else
+				{
+					_authKey.Encrypt(block, _mac);
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::GetBackend>
+// The backend keys use when they are set
+//-----------------------------------------------------------------------------
+		AesKey::Backend AesKey::GetBackend()
+		{
+			return ActiveBackend();
+		}
+
+		char const* AesKey::GetBackendName(Backend _backend)
+		{
+			return _backend < Backend_Count ? c_backends[_backend].m_name : "unknown";
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::IsBackendSupported>
+// Whether the build and the CPU can use a backend
+//-----------------------------------------------------------------------------
+		bool AesKey::IsBackendSupported(Backend _backend)
+		{
+			switch (_backend)
+			{
+				case Backend_Portable:
+				{
+					return true;
+				}
+#if defined(OZW_AES_X86)
+				case Backend_AesNi:
+				{
+					static bool const supported = CpuHasAes();
+					return supported;
+				}
+#endif
+#if defined(OZW_AES_ARM)
+				case Backend_ArmCrypto:
+				{
+					static bool const supported = CpuHasAes();
+					return supported;
+				}
+#endif
+				default:
+				{
+					return false;
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <AesKey::SetBackend>
+// Choose the backend for keys set from now on
+//-----------------------------------------------------------------------------
+		bool AesKey::SetBackend(Backend _backend)
+		{
+			if (!IsBackendSupported(_backend))
+			{
+				return false;
+			}
+			ActiveBackend() = _backend;
+			return true;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
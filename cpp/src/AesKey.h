@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+//
+//	AesKey.h
+//
+//	AES-128 key schedules, with hardware AES where the CPU has it
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _AesKey_H
+#define _AesKey_H
+
+#include "Defs.h"
+#include "aes/aes.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief An expanded AES-128 key, and the modes Security S0 uses with it.
+		 * \ingroup Main
+		 *
+		 * The key schedule is computed once, when the key is set, and is not
+		 * changed by encrypting, so one key can be used for any number of frames,
+		 * from any thread.  Unlike the aes_*_encrypt mode functions, nothing here
+		 * keeps state between calls or changes the IV it is given.
+		 *
+		 * Blocks are encrypted with the AES instructions of the CPU where they are
+		 * present: AES-NI on x86 and the ARMv8 cryptography extension on 64 bit ARM.
+		 * Otherwise the portable code in cpp/src/aes is used.  The choice is made at
+		 * runtime, the first time a key is set.
+		 */
+		class AesKey
+		{
+			public:
+				enum Backend
+				{
+					Backend_Portable = 0,
+					Backend_AesNi,
+					Backend_ArmCrypto,
+					Backend_Count
+				};
+
+				AesKey();
+				explicit AesKey(uint8 const _key[16]);
+
+				void SetKey(uint8 const _key[16]);
+
+				/**
+				 * Encrypt one block.  _in and _out may be the same.
+				 */
+				void Encrypt(uint8 const _in[16], uint8 _out[16]) const;
+
+				/**
+				 * Encrypt or decrypt _length bytes in OFB mode.  _in and _out may be the same.
+				 */
+				void Ofb(uint8 const _iv[16], uint8 const* _in, uint8* _out, uint32 _length) const;
+
+				/**
+				 * CBC-MAC of _data zero padded to whole blocks, with the encrypted IV as
+				 * the first block, which is how S0 authenticates a frame.
+				 */
+				void CbcMac(uint8 const _iv[16], uint8 const* _data, uint32 _length, uint8 _mac[16]) const;
+
+				/**
+				 * OFB with _encKey and the CbcMac with _authKey of _header followed by
+				 * the ciphertext, in one pass.  The blocks of the two chains are
+				 * independent of each other, so they are encrypted in pairs, which the
+				 * AES instructions can work on at the same time.  _in and _out must
+				 * not overlap.
+				 */
+				static void EncryptAndMac(AesKey const& _encKey, AesKey const& _authKey, uint8 const _iv[16], uint8 const* _header, uint32 _headerLength, uint8 const* _in, uint8* _out, uint32 _length, uint8 _mac[16]);
+				static void DecryptAndMac(AesKey const& _encKey, AesKey const& _authKey, uint8 const _iv[16], uint8 const* _header, uint32 _headerLength, uint8 const* _in, uint8* _out, uint32 _length, uint8 _mac[16]);
+
+				/**
+				 * The backend keys use when they are set.
+				 */
+				static Backend GetBackend();
+				static char const* GetBackendName(Backend _backend);
+				static bool IsBackendSupported(Backend _backend);
+
+				/**
+				 * Use another backend for the keys set from now on, to compare them.
+				 * \return false if this CPU or build cannot use it.
+				 */
+				static bool SetBackend(Backend _backend);
+
+			private:
+				static void OfbAndMac(AesKey const& _encKey, AesKey const& _authKey, uint8 const _iv[16], uint8 const* _header, uint32 _headerLength, uint8 const* _in, uint8* _out, uint32 _length, bool _decrypt, uint8 _mac[16]);
+
+				// The words of the schedule are in the byte order of the platform, so
+				// in memory they are the round keys the AES instructions expect
+				aes_encrypt_ctx m_ctx;
+				Backend m_backend;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_AesKey_H
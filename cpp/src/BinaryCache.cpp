@@ -0,0 +1,438 @@
+//-----------------------------------------------------------------------------
+//
+//	BinaryCache.cpp
+//
+//	Compact binary encoding of the network cache
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <cstring>
+#include <map>
+
+#include "BinaryCache.h"
+#include "platform/FileOps.h"
+#include "platform/Log.h"
+
+#include "tinyxml.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		// File header: magic, format version and the number of blocks
+		static char const c_binaryCacheMagic[4] =
+		{ 'O', 'Z', 'W', 'B' };
+		static uint32 const c_binaryCacheVersion = 1;
+		static uint32 const c_binaryCacheHeaderSize = 12;
+
+		// Element record: size, name, text, attribute count and child count
+		static uint32 const c_elementHeaderSize = 20;
+
+		// String index of an element without text
+		static uint32 const c_noString = 0xffffffff;
+
+		// Protects the decoder against corrupt files nesting without end
+		static uint32 const c_maxDepth = 64;
+
+		static void Put32(vector<uint8>* _out, uint32 _value)
+		{
+			_out->push_back((uint8) (_value & 0xff));
+			_out->push_back((uint8) ((_value >> 8) & 0xff));
+			_out->push_back((uint8) ((_value >> 16) & 0xff));
+			_out->push_back((uint8) ((_value >> 24) & 0xff));
+		}
+
+		static void Patch32(vector<uint8>* _out, size_t _pos, uint32 _value)
+		{
+			(*_out)[_pos] = (uint8) (_value & 0xff);
+			(*_out)[_pos + 1] = (uint8) ((_value >> 8) & 0xff);
+			(*_out)[_pos + 2] = (uint8) ((_value >> 16) & 0xff);
+			(*_out)[_pos + 3] = (uint8) ((_value >> 24) & 0xff);
+		}
+
+		static uint32 Get32(uint8 const* _data)
+		{
+			return (uint32) _data[0] | ((uint32) _data[1] << 8) | ((uint32) _data[2] << 16) | ((uint32) _data[3] << 24);
+		}
+
+		// The strings of one block, each stored once
+		class BinaryCacheStrings
+		{
+			public:
+				uint32 Add(char const* _str)
+				{
+					string str(_str ? _str : "");
+					map<string, uint32>::iterator it = m_index.find(str);
+					if (it != m_index.end())
+					{
+						return it->second;
+					}
+					uint32 index = (uint32) m_strings.size();
+					m_index[str] = index;
+					m_strings.push_back(str);
+					return index;
+				}
+
+				map<string, uint32> m_index;
+				vector<string> m_strings;
+		};
+
+//-----------------------------------------------------------------------------
+// <EncodeElement>
+// Append the record of an element and its children
+//-----------------------------------------------------------------------------
+		static void EncodeElement(TiXmlElement const* _element, BinaryCacheStrings* _strings, vector<uint8>* _out)
+		{
+			size_t start = _out->size();
+			Put32(_out, 0);
+			Put32(_out, _strings->Add(_element->Value()));
+
+			string text;
+			bool hasText = false;
+			uint32 childCount = 0;
+			for (TiXmlNode const* child = _element->FirstChild(); child; child = child->NextSibling())
+			{
+				if (TiXmlText const* textNode = child->ToText())
+				{
+					text += textNode->Value();
+					hasText = true;
+				}
+				else if (child->ToElement())
+				{
+					++childCount;
+				}
+			}
+			Put32(_out, hasText ? _strings->Add(text.c_str()) : c_noString);
+
+			uint32 attributeCount = 0;
+			for (TiXmlAttribute const* attribute = _element->FirstAttribute(); attribute; attribute = attribute->Next())
+			{
+				++attributeCount;
+			}
+			Put32(_out, attributeCount);
+			Put32(_out, childCount);
+			for (TiXmlAttribute const* attribute = _element->FirstAttribute(); attribute; attribute = attribute->Next())
+			{
+				Put32(_out, _strings->Add(attribute->Name()));
+				Put32(_out, _strings->Add(attribute->Value()));
+			}
+
+			for (TiXmlElement const* child = _element->FirstChildElement(); child; child = child->NextSiblingElement())
+			{
+				EncodeElement(child, _strings, _out);
+			}
+			Patch32(_out, start, (uint32) (_out->size() - start));
+		}
+
+//-----------------------------------------------------------------------------
+// <DecodeElement>
+// Create an element and its children from their record
+//-----------------------------------------------------------------------------
+		static TiXmlElement* DecodeElement(uint8 const** _pos, uint8 const* _end, vector<string> const& _strings, uint32 _depth)
+		{
+			uint8 const* start = *_pos;
+			if (_depth > c_maxDepth || (size_t) (_end - start) < c_elementHeaderSize)
+			{
+				return NULL;
+			}
+			uint32 size = Get32(start);
+			uint32 name = Get32(start + 4);
+			uint32 text = Get32(start + 8);
+			uint32 attributeCount = Get32(start + 12);
+			uint32 childCount = Get32(start + 16);
+			uint8 const* recordEnd = start + size;
+			if (size < c_elementHeaderSize || size > (size_t) (_end - start) || name >= _strings.size() || (text != c_noString && text >= _strings.size()) || attributeCount > (size - c_elementHeaderSize) / 8)
+			{
+				return NULL;
+			}
+
+			TiXmlElement* element = new TiXmlElement(_strings[name].c_str());
+			uint8 const* pos = start + c_elementHeaderSize;
+			for (uint32 i = 0; i < attributeCount; ++i, pos += 8)
+			{
+				uint32 attributeName = Get32(pos);
+				uint32 attributeValue = Get32(pos + 4);
+				if (attributeName >= _strings.size() || attributeValue >= _strings.size())
+				{
+					delete element;
+					return NULL;
+				}
+				element->SetAttribute(_strings[attributeName].c_str(), _strings[attributeValue].c_str());
+			}
+			if (text != c_noString)
+			{
+				element->LinkEndChild(new TiXmlText(_strings[text].c_str()));
+			}
+			for (uint32 i = 0; i < childCount; ++i)
+			{
+				TiXmlElement* child = DecodeElement(&pos, recordEnd, _strings, _depth + 1);
+				if (!child)
+				{
+					delete element;
+					return NULL;
+				}
+				element->LinkEndChild(child);
+			}
+			if (pos != recordEnd)
+			{
+				delete element;
+				return NULL;
+			}
+			*_pos = recordEnd;
+			return element;
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::Encode>
+// Append a block holding an element and all of its children
+//-----------------------------------------------------------------------------
+		void BinaryCache::Encode(TiXmlElement const* _element, vector<uint8>* _block)
+		{
+			BinaryCacheStrings strings;
+			vector<uint8> records;
+			EncodeElement(_element, &strings, &records);
+
+			size_t start = _block->size();
+			Put32(_block, 0);
+			Put32(_block, (uint32) strings.m_strings.size());
+			for (vector<string>::iterator it = strings.m_strings.begin(); it != strings.m_strings.end(); ++it)
+			{
+				Put32(_block, (uint32) it->size());
+				_block->insert(_block->end(), it->begin(), it->end());
+			}
+			_block->insert(_block->end(), records.begin(), records.end());
+			Patch32(_block, start, (uint32) (_block->size() - start));
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::Decode>
+// Decode a block created by Encode
+//-----------------------------------------------------------------------------
+		TiXmlElement* BinaryCache::Decode(uint8 const* _data, size_t _size)
+		{
+			if (_size < 8)
+			{
+				return NULL;
+			}
+			uint32 size = Get32(_data);
+			uint32 stringCount = Get32(_data + 4);
+			if (size < 8 || size > _size || stringCount > (size - 8) / 4)
+			{
+				return NULL;
+			}
+			uint8 const* end = _data + size;
+			uint8 const* pos = _data + 8;
+
+			vector<string> strings;
+			strings.reserve(stringCount);
+			for (uint32 i = 0; i < stringCount; ++i)
+			{
+				if (end - pos < 4)
+				{
+					return NULL;
+				}
+				uint32 length = Get32(pos);
+				pos += 4;
+				if (length > (size_t) (end - pos))
+				{
+					return NULL;
+				}
+				strings.push_back(string((char const*) pos, length));
+				pos += length;
+			}
+
+			TiXmlElement* element = DecodeElement(&pos, end, strings, 0);
+			if (element && pos != end)
+			{
+				delete element;
+				return NULL;
+			}
+			return element;
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::Save>
+// Write the Driver element and the encoded Node elements to a file
+//-----------------------------------------------------------------------------
+		bool BinaryCache::Save(string const& _filename, TiXmlElement const* _root, vector<vector<uint8> const*> const& _blocks)
+		{
+			vector<uint8> data(sizeof(c_binaryCacheMagic));
+			memcpy(&data[0], c_binaryCacheMagic, sizeof(c_binaryCacheMagic));
+			Put32(&data, c_binaryCacheVersion);
+			Put32(&data, (uint32) (_blocks.size() + 1));
+
+			// The first block only holds the attributes of the root element
+			TiXmlElement root(_root->Value());
+			for (TiXmlAttribute const* attribute = _root->FirstAttribute(); attribute; attribute = attribute->Next())
+			{
+				root.SetAttribute(attribute->Name(), attribute->Value());
+			}
+			Encode(&root, &data);
+
+			for (vector<vector<uint8> const*>::const_iterator it = _blocks.begin(); it != _blocks.end(); ++it)
+			{
+				data.insert(data.end(), (*it)->begin(), (*it)->end());
+			}
+
+			if (!Platform::FileOps::Create()->FileWriteAtomic(_filename, string((char const*) &data[0], data.size())))
+			{
+				Log::Write(LogLevel_Warning, "WARNING: Failed to write binary cache %s", _filename.c_str());
+				return false;
+			}
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::Save>
+// Write a document as a binary cache file
+//-----------------------------------------------------------------------------
+		bool BinaryCache::Save(string const& _filename, TiXmlDocument const& _doc)
+		{
+			TiXmlElement const* root = _doc.RootElement();
+			if (!root)
+			{
+				return false;
+			}
+
+			vector<vector<uint8> > blocks;
+			for (TiXmlElement const* child = root->FirstChildElement(); child; child = child->NextSiblingElement())
+			{
+				blocks.push_back(vector<uint8>());
+				Encode(child, &blocks.back());
+			}
+
+			vector<vector<uint8> const*> blockPtrs;
+			for (vector<vector<uint8> >::iterator it = blocks.begin(); it != blocks.end(); ++it)
+			{
+				blockPtrs.push_back(&(*it));
+			}
+			return Save(_filename, root, blockPtrs);
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::Load>
+// Read a binary cache file into a document
+//-----------------------------------------------------------------------------
+		bool BinaryCache::Load(string const& _filename, TiXmlDocument* _doc)
+		{
+			if (!Platform::FileOps::Create()->FileExists(_filename))
+			{
+				return false;
+			}
+			char const* mapped = NULL;
+			uint64 fileSize = 0;
+			if (!Platform::FileOps::FileMap(_filename, &mapped, &fileSize))
+			{
+				Log::Write(LogLevel_Warning, "WARNING: Failed to read binary cache %s", _filename.c_str());
+				return false;
+			}
+			TiXmlElement* root = Decode(_filename, (uint8 const*) mapped, (size_t) fileSize);
+			Platform::FileOps::FileUnmap(mapped, fileSize);
+			if (!root)
+			{
+				return false;
+			}
+
+			_doc->Clear();
+			_doc->LinkEndChild(new TiXmlDeclaration("1.0", "utf-8", ""));
+			_doc->LinkEndChild(root);
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::Decode>
+// Decode the blocks of a whole file, which is read in place
+//-----------------------------------------------------------------------------
+		TiXmlElement* BinaryCache::Decode(string const& _filename, uint8 const* _data, size_t _size)
+		{
+			if (_size < c_binaryCacheHeaderSize)
+			{
+				Log::Write(LogLevel_Warning, "WARNING: Binary cache %s is truncated", _filename.c_str());
+				return NULL;
+			}
+			if (memcmp(_data, c_binaryCacheMagic, sizeof(c_binaryCacheMagic)) || Get32(&_data[4]) != c_binaryCacheVersion)
+			{
+				Log::Write(LogLevel_Warning, "WARNING: %s is not a binary cache this version of OpenZWave can read", _filename.c_str());
+				return NULL;
+			}
+			uint32 blockCount = Get32(&_data[8]);
+
+			TiXmlElement* root = NULL;
+			size_t pos = c_binaryCacheHeaderSize;
+			for (uint32 i = 0; i < blockCount; ++i)
+			{
+				TiXmlElement* element = (pos < _size) ? Decode(&_data[pos], _size - pos) : NULL;
+				if (!element)
+				{
+					Log::Write(LogLevel_Warning, "WARNING: Binary cache %s is corrupt", _filename.c_str());
+					delete root;
+					return NULL;
+				}
+				pos += Get32(&_data[pos]);
+				if (root)
+				{
+					root->LinkEndChild(element);
+				}
+				else
+				{
+					root = element;
+				}
+			}
+			if (root && pos != _size)
+			{
+				Log::Write(LogLevel_Warning, "WARNING: Binary cache %s is corrupt", _filename.c_str());
+				delete root;
+				return NULL;
+			}
+			return root;
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::ConvertToBinary>
+// Convert an XML cache file to the binary format
+//-----------------------------------------------------------------------------
+		bool BinaryCache::ConvertToBinary(string const& _xmlFilename, string const& _binaryFilename)
+		{
+			TiXmlDocument doc;
+			if (!doc.LoadFile(_xmlFilename.c_str(), TIXML_ENCODING_UTF8))
+			{
+				Log::Write(LogLevel_Warning, "WARNING: Failed to load %s for conversion", _xmlFilename.c_str());
+				return false;
+			}
+			return Save(_binaryFilename, doc);
+		}
+
+//-----------------------------------------------------------------------------
+// <BinaryCache::ConvertToXml>
+// Convert a binary cache file to XML
+//-----------------------------------------------------------------------------
+		bool BinaryCache::ConvertToXml(string const& _binaryFilename, string const& _xmlFilename)
+		{
+			TiXmlDocument doc;
+			if (!Load(_binaryFilename, &doc))
+			{
+				return false;
+			}
+			TiXmlPrinter printer;
+			doc.Accept(&printer);
+			return Platform::FileOps::Create()->FileWriteAtomic(_xmlFilename, string(printer.CStr(), printer.Size()));
+		}
+	} // namespace Internal
+} // namespace OpenZWave
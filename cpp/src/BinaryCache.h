@@ -0,0 +1,120 @@
+//-----------------------------------------------------------------------------
+//
+//	BinaryCache.h
+//
+//	Compact binary encoding of the network cache
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _BinaryCache_H
+#define _BinaryCache_H
+
+#include <string>
+#include <vector>
+
+#include "Defs.h"
+
+class TiXmlDocument;
+class TiXmlElement;
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief Reads and writes the network cache in a compact binary form.
+		 *
+		 * The binary cache holds the same tree as ozwcache_0x%08x.xml, so the code
+		 * that loads nodes, command classes and values from the XML is shared by
+		 * both formats.  It is only the text parser that is skipped.
+		 *
+		 * A file is a header followed by self contained blocks.  The first block
+		 * holds the Driver element without its children, and every following
+		 * block holds one Node element.  A block starts with its size and its own
+		 * string table, so it can be decoded (or skipped) on its own.  Every
+		 * element record starts with its size too, so a reader can skip a command
+		 * class or value without decoding it.  All integers are 32 bit little
+		 * endian, and the layout holds no pointers, so a file can be mapped into
+		 * memory and decoded in place.
+		 * \ingroup Main
+		 */
+		class BinaryCache
+		{
+			public:
+				/**
+				 * Append a block holding an element and all of its children.
+				 * \param _element the element to encode.
+				 * \param _block the block is appended to this buffer.
+				 */
+				static void Encode(TiXmlElement const* _element, vector<uint8>* _block);
+
+				/**
+				 * Decode a block created by Encode.
+				 * \param _data start of the block.
+				 * \param _size number of bytes available at _data.
+				 * \return a new element that the caller owns, or NULL if the block is malformed.
+				 */
+				static TiXmlElement* Decode(uint8 const* _data, size_t _size);
+
+				/**
+				 * Write a binary cache file.  The attributes of _root make up the first
+				 * block and each of _blocks follows it.  The file is replaced atomically.
+				 * \param _filename name of the file to write.
+				 * \param _root the Driver element.  Its children are ignored.
+				 * \param _blocks the encoded Node elements.
+				 * \return true if the file was written.
+				 */
+				static bool Save(string const& _filename, TiXmlElement const* _root, vector<vector<uint8> const*> const& _blocks);
+
+				/**
+				 * Write a document as a binary cache file.
+				 * \param _filename name of the file to write.
+				 * \param _doc the document.  Each child of its root element becomes a block.
+				 * \return true if the file was written.
+				 */
+				static bool Save(string const& _filename, TiXmlDocument const& _doc);
+
+				/**
+				 * Read a binary cache file into a document.  The file is mapped into
+				 * memory and decoded where it is.
+				 * \param _filename name of the file to read.
+				 * \param _doc the document to fill in.
+				 * \return true if the file was read, false if it is missing or malformed.
+				 */
+				static bool Load(string const& _filename, TiXmlDocument* _doc);
+
+				/**
+				 * Convert an XML cache file to the binary format.
+				 * \return true on success.
+				 */
+				static bool ConvertToBinary(string const& _xmlFilename, string const& _binaryFilename);
+
+				/**
+				 * Convert a binary cache file to XML.
+				 * \return true on success.
+				 */
+				static bool ConvertToXml(string const& _binaryFilename, string const& _xmlFilename);
+
+			private:
+				static TiXmlElement* Decode(string const& _filename, uint8 const* _data, size_t _size);
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_BinaryCache_H
@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+//
+//	BlockPool.cpp
+//
+//	Allocator for many objects of the same size
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <new>
+
+#include "BlockPool.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace
+		{
+			// The first block of a slab starts after the slab link, at this offset
+			size_t const c_alignment = sizeof(void*) * 2;
+		}
+
+//-----------------------------------------------------------------------------
+// <BlockPool::BlockPool>
+// Constructor
+//-----------------------------------------------------------------------------
+		BlockPool::BlockPool(size_t const _blockSize, uint32 const _blocksPerSlab) :
+				m_blockSize((_blockSize + c_alignment - 1) & ~(c_alignment - 1)), m_blocksPerSlab(_blocksPerSlab ? _blocksPerSlab : 1), m_free(NULL), m_slabs(NULL), m_allocations(0), m_slabCount(0), m_inUse(0)
+		{
+		}
+
+//-----------------------------------------------------------------------------
+// <BlockPool::~BlockPool>
+// Destructor
+//-----------------------------------------------------------------------------
+		BlockPool::~BlockPool()
+		{
+			while (m_slabs)
+			{
+				void* next = *(void**) m_slabs;
+				::operator delete(m_slabs);
+				m_slabs = next;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <BlockPool::Allocate>
+// Take a block from the free list, getting a new slab if it is empty
+//-----------------------------------------------------------------------------
+		void* BlockPool::Allocate()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_free)
+			{
+				uint8* slab = (uint8*) ::operator new(c_alignment + m_blockSize * m_blocksPerSlab);
+				*(void**) slab = m_slabs;
+				m_slabs = slab;
+				++m_slabCount;
+
+				// Push the blocks in reverse, so they are handed out in address order
+				for (uint32 i = m_blocksPerSlab; i > 0; --i)
+				{
+					void* block = slab + c_alignment + (i - 1) * m_blockSize;
+					*(void**) block = m_free;
+					m_free = block;
+				}
+			}
+
+			void* block = m_free;
+			m_free = *(void**) block;
+			++m_allocations;
+			++m_inUse;
+			return block;
+		}
+
+//-----------------------------------------------------------------------------
+// <BlockPool::Free>
+// Put a block back on the free list
+//-----------------------------------------------------------------------------
+		void BlockPool::Free(void* _block)
+		{
+			if (!_block)
+			{
+				return;
+			}
+			std::lock_guard<std::mutex> lock(m_mutex);
+			*(void**) _block = m_free;
+			m_free = _block;
+			--m_inUse;
+		}
+
+//-----------------------------------------------------------------------------
+// <BlockPool::GetStatistics>
+// Report how the pool has been used
+//-----------------------------------------------------------------------------
+		void BlockPool::GetStatistics(uint32* o_allocations, uint32* o_slabs, uint32* o_inUse)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			*o_allocations = m_allocations;
+			*o_slabs = m_slabCount;
+			*o_inUse = m_inUse;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
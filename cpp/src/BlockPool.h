@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------
+//
+//	BlockPool.h
+//
+//	Allocator for many objects of the same size
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _BlockPool_H
+#define _BlockPool_H
+
+#include <mutex>
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief Hands out fixed size blocks carved from larger slabs.
+		 *
+		 * Freed blocks are kept on a free list for the next allocation, and slabs
+		 * are never returned to the heap, so the pool only grows to the peak number
+		 * of blocks in use.  Blocks are aligned like the result of operator new.
+		 * All methods are thread safe.
+		 * \ingroup Main
+		 */
+		class BlockPool
+		{
+			public:
+				/**
+				 * \param _blockSize size of each block.  Rounded up to keep the blocks aligned.
+				 * \param _blocksPerSlab number of blocks to get from the heap at a time.
+				 */
+				BlockPool(size_t const _blockSize, uint32 const _blocksPerSlab);
+
+				/**
+				 * Return the slabs to the heap.  Any block still in use becomes invalid.
+				 */
+				~BlockPool();
+
+				void* Allocate();
+				void Free(void* _block);
+
+				size_t GetBlockSize() const
+				{
+					return m_blockSize;
+				}
+
+				/**
+				 * \param o_allocations receives the number of blocks handed out so far.
+				 * \param o_slabs receives the number of slabs taken from the heap.
+				 * \param o_inUse receives the number of blocks that have not been freed.
+				 */
+				void GetStatistics(uint32* o_allocations, uint32* o_slabs, uint32* o_inUse);
+
+			private:
+				BlockPool(BlockPool const&);					// prevent copy
+				BlockPool& operator =(BlockPool const&);		// prevent assignment
+
+				std::mutex m_mutex;
+				size_t m_blockSize;
+				uint32 m_blocksPerSlab;
+				void* m_free;							// Free blocks, linked through their first word
+				void* m_slabs;							// Slabs, linked through their first word
+				uint32 m_allocations;
+				uint32 m_slabCount;
+				uint32 m_inUse;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_BlockPool_H
@@ -25,6 +25,8 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
+
 #include "command_classes/CommandClass.h"
 #include "CompatOptionManager.h"
 #include "platform/Log.h"
@@ -85,9 +87,48 @@ namespace OpenZWave
 
 		uint16_t availableDiscoveryFlagsCount = sizeof(availableDiscoveryFlags) / sizeof(availableDiscoveryFlags[0]);
 
+		namespace
+		{
+			bool IsArrayType(CompatOptionFlagType type)
+			{
+				return type >= COMPAT_FLAG_TYPE_BOOL_ARRAY;
+			}
+
+			/* The value of a flag, or the default of an array flag, widened to an int */
+			uint32_t GetStoredValue(CompatOptionFlagStorage const& storage)
+			{
+				switch (storage.type)
+				{
+					case COMPAT_FLAG_TYPE_BOOL:
+					case COMPAT_FLAG_TYPE_BOOL_ARRAY:
+						return storage.valBool ? 1 : 0;
+					case COMPAT_FLAG_TYPE_BYTE:
+					case COMPAT_FLAG_TYPE_BYTE_ARRAY:
+						return storage.valByte;
+					case COMPAT_FLAG_TYPE_SHORT:
+					case COMPAT_FLAG_TYPE_SHORT_ARRAY:
+						return storage.valShort;
+					case COMPAT_FLAG_TYPE_INT:
+					case COMPAT_FLAG_TYPE_INT_ARRAY:
+						return storage.valInt;
+				}
+				return 0;
+			}
+
+			bool CompareIndexedValue(CompatOptionIndexedValue const& a, CompatOptionIndexedValue const& b)
+			{
+				if (a.flag != b.flag)
+				{
+					return a.flag < b.flag;
+				}
+				return a.index < b.index;
+			}
+		}
+
 		CompatOptionManager::CompatOptionManager(CompatOptionType type, Internal::CC::CommandClass *owner) :
 				m_owner(owner), m_comtype(type)
 		{
+			memset(m_CompatVals, 0, sizeof(m_CompatVals));
 			switch (m_comtype)
 			{
 				case CompatOptionType_Compatibility:
@@ -111,9 +152,10 @@ namespace OpenZWave
 			{
 				if (m_availableFlags[i].flag == flag)
 				{
-					m_enabledCompatFlags[m_availableFlags[i].name] = flag;
-					m_CompatVals[flag].type = m_availableFlags[i].type;
-					m_CompatVals[flag].changed = false;
+					CompatOptionFlagStorage& storage = m_CompatVals[flag];
+					storage.type = m_availableFlags[i].type;
+					storage.enabled = true;
+					storage.changed = false;
 					switch (m_availableFlags[i].type)
 					{
 						case COMPAT_FLAG_TYPE_BOOL:
@@ -123,7 +165,7 @@ namespace OpenZWave
 								Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "EnableFlag: Default Value for %s is not a Bool", m_availableFlags[i].name.c_str());
 								defaultval = 0;
 							}
-							m_CompatVals[flag].valBool = (defaultval == 0 ? false : true);
+							storage.valBool = (defaultval == 0 ? false : true);
 							break;
 						case COMPAT_FLAG_TYPE_BYTE:
 						case COMPAT_FLAG_TYPE_BYTE_ARRAY:
@@ -132,7 +174,7 @@ namespace OpenZWave
 								Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "EnableFlag: Default Value for %s is larger than a byte", m_availableFlags[i].name.c_str());
 								defaultval = 0;
 							}
-							m_CompatVals[flag].valByte = defaultval;
+							storage.valByte = defaultval;
 							break;
 						case COMPAT_FLAG_TYPE_SHORT:
 						case COMPAT_FLAG_TYPE_SHORT_ARRAY:
@@ -141,16 +183,11 @@ namespace OpenZWave
 								Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "EnableFlag: Default Value for %s is larger than a short", m_availableFlags[i].name.c_str());
 								defaultval = 0;
 							}
-							m_CompatVals[flag].valShort = defaultval;
+							storage.valShort = defaultval;
 							break;
 						case COMPAT_FLAG_TYPE_INT:
 						case COMPAT_FLAG_TYPE_INT_ARRAY:
-							if (defaultval > UINT32_MAX)
-							{
-								Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "EnableFlag: Default Value for %s is larger than a int", m_availableFlags[i].name.c_str());
-								defaultval = 0;
-							}
-							m_CompatVals[flag].valInt = defaultval;
+							storage.valInt = defaultval;
 							break;
 					}
 				}
@@ -163,162 +200,116 @@ namespace OpenZWave
 
 			if (compatElement)
 			{
-				map<string, CompatOptionFlags>::iterator it;
 				string value;
-				for (it = m_enabledCompatFlags.begin(); it != m_enabledCompatFlags.end(); it++)
+				for (uint32_t i = 0; i < m_availableFlagsCount; i++)
 				{
-					TiXmlElement const *valElement = compatElement->FirstChildElement(it->first.c_str());
+					CompatOptionFlags flag = m_availableFlags[i].flag;
+					CompatOptionFlagStorage& storage = m_CompatVals[flag];
+					if (!storage.enabled)
+					{
+						continue;
+					}
+					char const* name = m_availableFlags[i].name.c_str();
+					TiXmlElement const *valElement = compatElement->FirstChildElement(name);
 					if (valElement)
 					{
 						value = valElement->GetText();
 						char* pStopChar;
 						uint32_t val = strtol(value.c_str(), &pStopChar, 10);
-						switch (m_CompatVals[it->second].type)
+						switch (storage.type)
 						{
 							case COMPAT_FLAG_TYPE_BOOL:
-								if (m_CompatVals[it->second].valBool != !strcmp(value.c_str(), "true"))
-								{
-									m_CompatVals[it->second].valBool = !strcmp(value.c_str(), "true");
-									m_CompatVals[it->second].changed = true;
-								}
-								break;
 							case COMPAT_FLAG_TYPE_BOOL_ARRAY:
-								{
-									if (m_CompatVals[it->second].valBool != !strcmp(value.c_str(), "true"))
-									{
-										string indexVal = valElement->Attribute("index");
-										uint32 index = strtol(indexVal.c_str(), &pStopChar, 10);
-										m_CompatVals[it->second].valBoolArray.insert(std::pair<uint32, bool>(index, !strcmp(value.c_str(), "true")));
-										m_CompatVals[it->second].changed = true;
-									}
-									break;
-								}
-							case COMPAT_FLAG_TYPE_BYTE:
-								if (val > UINT8_MAX)
-								{
-									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a byte", m_owner->GetCommandClassName().c_str(), it->first.c_str());
-									val = 0;
-								}
-								if (m_CompatVals[it->second].valByte != val)
-								{
-									m_CompatVals[it->second].valByte = val;
-									m_CompatVals[it->second].changed = true;
-								}
+								val = !strcmp(value.c_str(), "true");
 								break;
+							case COMPAT_FLAG_TYPE_BYTE:
 							case COMPAT_FLAG_TYPE_BYTE_ARRAY:
 								if (val > UINT8_MAX)
 								{
-									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a byte", m_owner->GetCommandClassName().c_str(), it->first.c_str());
+									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a byte", m_owner->GetCommandClassName().c_str(), name);
 									val = 0;
 								}
-								if (m_CompatVals[it->second].valByte != val)
-								{
-									string indexVal = valElement->Attribute("index");
-									uint32 index = strtol(indexVal.c_str(), &pStopChar, 10);
-									m_CompatVals[it->second].valByteArray.insert(std::pair<uint32_t, uint8_t>(index, val));
-									m_CompatVals[it->second].changed = true;
-								}
 								break;
-
 							case COMPAT_FLAG_TYPE_SHORT:
-								if (val > UINT16_MAX)
-								{
-									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a short", m_owner->GetCommandClassName().c_str(), it->first.c_str());
-									val = 0;
-								}
-								if (m_CompatVals[it->second].valShort != val)
-								{
-									m_CompatVals[it->second].valShort = val;
-									m_CompatVals[it->second].changed = true;
-								}
-								break;
 							case COMPAT_FLAG_TYPE_SHORT_ARRAY:
 								if (val > UINT16_MAX)
 								{
-									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a short", m_owner->GetCommandClassName().c_str(), it->first.c_str());
+									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a short", m_owner->GetCommandClassName().c_str(), name);
 									val = 0;
 								}
-								if (m_CompatVals[it->second].valShort != val)
-								{
-									string indexVal = valElement->Attribute("index");
-									uint32 index = strtol(indexVal.c_str(), &pStopChar, 10);
-									m_CompatVals[it->second].valShortArray.insert(std::pair<uint32_t, uint16_t>(index, val));
-									m_CompatVals[it->second].changed = true;
-								}
 								break;
 							case COMPAT_FLAG_TYPE_INT:
-								if (val > UINT32_MAX)
-								{
-									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a int", m_owner->GetCommandClassName().c_str(), it->first.c_str());
-									val = 0;
-								}
-								if (m_CompatVals[it->second].valInt != val)
-								{
-									m_CompatVals[it->second].valInt = val;
-									m_CompatVals[it->second].changed = true;
-								}
-								break;
 							case COMPAT_FLAG_TYPE_INT_ARRAY:
-								if (val > UINT32_MAX)
-								{
-									Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "ReadXML: (%s) - Value for %s is larger than a int", m_owner->GetCommandClassName().c_str(), it->first.c_str());
-									val = 0;
-								}
-								if (m_CompatVals[it->second].valInt != val)
-								{
-									string indexVal = valElement->Attribute("index");
-									uint32 index = strtol(indexVal.c_str(), &pStopChar, 10);
-									m_CompatVals[it->second].valIntArray.insert(std::pair<uint32_t, uint32_t>(index, val));
-									m_CompatVals[it->second].changed = true;
-								}
 								break;
+						}
 
+						if (GetStoredValue(storage) != val)
+						{
+							if (IsArrayType(storage.type))
+							{
+								string indexVal = valElement->Attribute("index");
+								uint32 index = strtol(indexVal.c_str(), &pStopChar, 10);
+								SetIndexedValue(flag, index, val);
+							}
+							else
+							{
+								switch (storage.type)
+								{
+									case COMPAT_FLAG_TYPE_BOOL:
+										storage.valBool = (val != 0);
+										break;
+									case COMPAT_FLAG_TYPE_BYTE:
+										storage.valByte = val;
+										break;
+									case COMPAT_FLAG_TYPE_SHORT:
+										storage.valShort = val;
+										break;
+									default:
+										storage.valInt = val;
+										break;
+								}
+							}
+							storage.changed = true;
 						}
 					}
 				}
 			}
 			{
-				map<string, CompatOptionFlags>::iterator it;
 				Log::Write(LogLevel_Info, m_owner->GetNodeId(), "(%d - %s) - %s Flags:", m_owner->GetCommandClassId(), m_owner->GetCommandClassName().c_str(), GetXMLTagName().c_str());
-				for (it = m_enabledCompatFlags.begin(); it != m_enabledCompatFlags.end(); it++)
+				for (uint32_t i = 0; i < m_availableFlagsCount; i++)
 				{
-					if (m_CompatVals[it->second].changed)
+					CompatOptionFlags flag = m_availableFlags[i].flag;
+					CompatOptionFlagStorage const& storage = m_CompatVals[flag];
+					if (storage.enabled && storage.changed)
 					{
-						switch (m_CompatVals[it->second].type)
+						char const* name = m_availableFlags[i].name.c_str();
+						if (storage.type == COMPAT_FLAG_TYPE_BOOL)
 						{
-							case COMPAT_FLAG_TYPE_BOOL:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s: %s", it->first.c_str(), m_CompatVals[it->second].valBool ? "true" : "false");
-								break;
-							case COMPAT_FLAG_TYPE_BOOL_ARRAY:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s (Default): %s", it->first.c_str(), m_CompatVals[it->second].valBool ? "true" : "false");
-								for (std::map<uint32_t, bool>::iterator it2 = m_CompatVals[it->second].valBoolArray.begin(); it2 != m_CompatVals[it->second].valBoolArray.end(); it2++)
-									Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t\t %s - %d: %s", it->first.c_str(), it2->first, it2->second ? "true" : "false");
-								break;
-							case COMPAT_FLAG_TYPE_BYTE:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s: %d", it->first.c_str(), m_CompatVals[it->second].valByte);
-								break;
-							case COMPAT_FLAG_TYPE_BYTE_ARRAY:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s (Default): %d", it->first.c_str(), m_CompatVals[it->second].valByte);
-								for (std::map<uint32_t, uint8_t>::iterator it2 = m_CompatVals[it->second].valByteArray.begin(); it2 != m_CompatVals[it->second].valByteArray.end(); it2++)
-									Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t\t %s - %d: %d", it->first.c_str(), it2->first, it2->second );
-								break;
-							case COMPAT_FLAG_TYPE_SHORT:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s: %d", it->first.c_str(), m_CompatVals[it->second].valShort);
-								break;
-							case COMPAT_FLAG_TYPE_SHORT_ARRAY:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s (Default): %d", it->first.c_str(), m_CompatVals[it->second].valShort);
-								for (std::map<uint32_t, uint16_t>::iterator it2 = m_CompatVals[it->second].valShortArray.begin(); it2 != m_CompatVals[it->second].valShortArray.end(); it2++)
-									Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t\t %s - %d: %d", it->first.c_str(), it2->first, it2->second );
-								break;
-							case COMPAT_FLAG_TYPE_INT:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s: %d", it->first.c_str(), m_CompatVals[it->second].valInt);
-								break;
-							case COMPAT_FLAG_TYPE_INT_ARRAY:
-								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s (Default): %d", it->first.c_str(), m_CompatVals[it->second].valShort);
-								for (std::map<uint32_t, uint32_t>::iterator it2 = m_CompatVals[it->second].valIntArray.begin(); it2 != m_CompatVals[it->second].valIntArray.end(); it2++)
-									Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t\t %s - %d: %d", it->first.c_str(), it2->first, it2->second );
-								break;
+							Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s: %s", name, storage.valBool ? "true" : "false");
+						}
+						else if (storage.type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
+						{
+							Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s (Default): %s", name, storage.valBool ? "true" : "false");
+						}
+						else if (IsArrayType(storage.type))
+						{
+							Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s (Default): %d", name, GetStoredValue(storage));
+						}
+						else
+						{
+							Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t %s: %d", name, GetStoredValue(storage));
+						}
 
+						for (vector<CompatOptionIndexedValue>::const_iterator it = m_indexedVals.begin(); it != m_indexedVals.end(); ++it)
+						{
+							if (it->flag != flag)
+							{
+								continue;
+							}
+							if (storage.type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
+								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t\t %s - %d: %s", name, it->index, it->value ? "true" : "false");
+							else
+								Log::Write(LogLevel_Info, m_owner->GetNodeId(), "\t\t %s - %d: %d", name, it->index, it->value);
 						}
 					}
 				}
@@ -330,134 +321,71 @@ namespace OpenZWave
 		{
 			TiXmlElement* compatElement = new TiXmlElement(GetXMLTagName().c_str());
 
-			map<string, CompatOptionFlags>::iterator it;
-			string value;
-			for (it = m_enabledCompatFlags.begin(); it != m_enabledCompatFlags.end(); it++)
+			for (uint32_t i = 0; i < m_availableFlagsCount; i++)
 			{
-				if (m_CompatVals[it->second].changed == false)
+				CompatOptionFlags flag = m_availableFlags[i].flag;
+				CompatOptionFlagStorage const& storage = m_CompatVals[flag];
+				if (!storage.enabled || (storage.changed == false))
 				{
 					/* skip writing out default values */
 					continue;
 				}
+				char const* name = m_availableFlags[i].name.c_str();
 				char str[32];
-				switch (m_CompatVals[it->second].type)
+				if (IsArrayType(storage.type))
 				{
-					case COMPAT_FLAG_TYPE_BOOL:
-					{
-						TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-						TiXmlText *text = new TiXmlText(m_CompatVals[it->second].valBool == true ? "true" : "false");
-						valElement->LinkEndChild(text);
-						compatElement->LinkEndChild(valElement);
-						break;
-					}
-					case COMPAT_FLAG_TYPE_BOOL_ARRAY:
-					{
-						for (std::map<uint32_t, bool>::iterator it2 = m_CompatVals[it->second].valBoolArray.begin(); it2 != m_CompatVals[it->second].valBoolArray.end(); it2++) {
-							if (it2->second != m_CompatVals[it->second].valBool) {
-								TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-								valElement->SetAttribute("index", it2->first);
-								TiXmlText *text = new TiXmlText(it2->second == true ? "true" : "false");
-								valElement->LinkEndChild(text);
-								compatElement->LinkEndChild(valElement);
-							}
-						}
-						break;
-					}
-					case COMPAT_FLAG_TYPE_BYTE:
-					{
-						snprintf(str, sizeof(str), "%d", m_CompatVals[it->second].valByte);
-						TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-						TiXmlText *text = new TiXmlText(str);
-						valElement->LinkEndChild(text);
-						compatElement->LinkEndChild(valElement);
-						break;
-					}
-					case COMPAT_FLAG_TYPE_BYTE_ARRAY:
-					{
-						for (std::map<uint32_t, uint8_t>::iterator it2 = m_CompatVals[it->second].valByteArray.begin(); it2 != m_CompatVals[it->second].valByteArray.end(); it2++) {
-							if (it2->second != m_CompatVals[it->second].valByte) {
-								snprintf(str, sizeof(str), "%d", it2->second);
-								TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-								valElement->SetAttribute("index", it2->first);
-								TiXmlText *text = new TiXmlText(str);
-								valElement->LinkEndChild(text);
-								compatElement->LinkEndChild(valElement);
-							}
-						}
-						break;
-					}
-					case COMPAT_FLAG_TYPE_SHORT:
+					for (vector<CompatOptionIndexedValue>::const_iterator it = m_indexedVals.begin(); it != m_indexedVals.end(); ++it)
 					{
-						snprintf(str, sizeof(str), "%d", m_CompatVals[it->second].valShort);
-						TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-						TiXmlText *text = new TiXmlText(str);
-						valElement->LinkEndChild(text);
-						compatElement->LinkEndChild(valElement);
-						break;
-					}
-					case COMPAT_FLAG_TYPE_SHORT_ARRAY:
-					{
-						for (std::map<uint32_t, uint16_t>::iterator it2 = m_CompatVals[it->second].valShortArray.begin(); it2 != m_CompatVals[it->second].valShortArray.end(); it2++) {
-							if (it2->second != m_CompatVals[it->second].valShort) {
-								snprintf(str, sizeof(str), "%d", it2->second);
-								TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-								valElement->SetAttribute("index", it2->first);
-								TiXmlText *text = new TiXmlText(str);
-								valElement->LinkEndChild(text);
-								compatElement->LinkEndChild(valElement);
-							}
-						}
-						break;
-					}
-					case COMPAT_FLAG_TYPE_INT:
-					{
-						snprintf(str, sizeof(str), "%d", m_CompatVals[it->second].valInt);
-						TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-						TiXmlText *text = new TiXmlText(str);
-						valElement->LinkEndChild(text);
-						compatElement->LinkEndChild(valElement);
-						break;
-					}
-					case COMPAT_FLAG_TYPE_INT_ARRAY:
-					{
-						for (std::map<uint32_t, uint32_t>::iterator it2 = m_CompatVals[it->second].valIntArray.begin(); it2 != m_CompatVals[it->second].valIntArray.end(); it2++) {
-							if (it2->second != m_CompatVals[it->second].valInt) {
-								snprintf(str, sizeof(str), "%d", it2->second);
-								TiXmlElement* valElement = new TiXmlElement(it->first.c_str());
-								valElement->SetAttribute("index", it2->first);
-								TiXmlText *text = new TiXmlText(str);
-								valElement->LinkEndChild(text);
-								compatElement->LinkEndChild(valElement);
-							}
+						if ((it->flag == flag) && (it->value != GetStoredValue(storage)))
+						{
+							if (storage.type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
+								snprintf(str, sizeof(str), "%s", it->value ? "true" : "false");
+							else
+								snprintf(str, sizeof(str), "%d", it->value);
+							TiXmlElement* valElement = new TiXmlElement(name);
+							valElement->SetAttribute("index", it->index);
+							TiXmlText *text = new TiXmlText(str);
+							valElement->LinkEndChild(text);
+							compatElement->LinkEndChild(valElement);
 						}
-						break;
 					}
 				}
+				else
+				{
+					if (storage.type == COMPAT_FLAG_TYPE_BOOL)
+						snprintf(str, sizeof(str), "%s", storage.valBool ? "true" : "false");
+					else
+						snprintf(str, sizeof(str), "%d", GetStoredValue(storage));
+					TiXmlElement* valElement = new TiXmlElement(name);
+					TiXmlText *text = new TiXmlText(str);
+					valElement->LinkEndChild(text);
+					compatElement->LinkEndChild(valElement);
+				}
 			}
 			_ccElement->LinkEndChild(compatElement);
 		}
 
 		bool CompatOptionManager::GetFlagBool(CompatOptionFlags const flag, uint32_t index) const
 		{
-			if (m_CompatVals.count(flag) == 0)
+			CompatOptionFlagStorage const* storage = GetStorage(flag, "GetFlagBool");
+			if (!storage)
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagBool: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return false;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BOOL)
+			if (storage->type == COMPAT_FLAG_TYPE_BOOL)
 			{
-				return m_CompatVals.at(flag).valBool;
+				return storage->valBool;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
+			if (storage->type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagBool: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
-					return m_CompatVals.at(flag).valBool;
+					return storage->valBool;
 				}
-				if (m_CompatVals.at(flag).valBoolArray.count(index))
-					return m_CompatVals.at(flag).valBoolArray.at(index);
+				if (uint32_t const* value = FindIndexedValue(flag, index))
+					return *value != 0;
 				/* Return our Default */
-				return m_CompatVals.at(flag).valBool;
+				return storage->valBool;
 			}
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagBool: (%s) - Flag %s Not a Boolean Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 			return false;
@@ -466,25 +394,25 @@ namespace OpenZWave
 
 		uint8_t CompatOptionManager::GetFlagByte(CompatOptionFlags flag, uint32_t index) const
 		{
-			if (m_CompatVals.count(flag) == 0)
+			CompatOptionFlagStorage const* storage = GetStorage(flag, "GetFlagByte");
+			if (!storage)
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagByte: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return 0;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BYTE)
+			if (storage->type == COMPAT_FLAG_TYPE_BYTE)
 			{
-				return m_CompatVals.at(flag).valByte;
+				return storage->valByte;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BYTE_ARRAY)
+			if (storage->type == COMPAT_FLAG_TYPE_BYTE_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagByte: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
-					return m_CompatVals.at(flag).valByte;
+					return storage->valByte;
 				}
-				if (m_CompatVals.at(flag).valByteArray.count(index))
-					return m_CompatVals.at(flag).valByteArray.at(index);
+				if (uint32_t const* value = FindIndexedValue(flag, index))
+					return (uint8_t) *value;
 				/* Return our Default */
-				return m_CompatVals.at(flag).valByte;
+				return storage->valByte;
 
 			}
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagByte: (%s) - Flag %s Not a Byte Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
@@ -494,25 +422,25 @@ namespace OpenZWave
 
 		uint16_t CompatOptionManager::GetFlagShort(CompatOptionFlags flag, uint32_t index) const
 		{
-			if (m_CompatVals.count(flag) == 0)
+			CompatOptionFlagStorage const* storage = GetStorage(flag, "GetFlagShort");
+			if (!storage)
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagShort: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return 0;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_SHORT)
+			if (storage->type == COMPAT_FLAG_TYPE_SHORT)
 			{
-				return m_CompatVals.at(flag).valShort;
+				return storage->valShort;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_SHORT_ARRAY)
+			if (storage->type == COMPAT_FLAG_TYPE_SHORT_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagShort: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
-					return m_CompatVals.at(flag).valShort;
+					return storage->valShort;
 				}
-				if (m_CompatVals.at(flag).valShortArray.count(index))
-					return m_CompatVals.at(flag).valShortArray.at(index);
+				if (uint32_t const* value = FindIndexedValue(flag, index))
+					return (uint16_t) *value;
 				/* Return our Default */
-				return m_CompatVals.at(flag).valShort;
+				return storage->valShort;
 			}
 
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagShort: (%s) - Flag %s Not a Short Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
@@ -522,25 +450,25 @@ namespace OpenZWave
 
 		uint32_t CompatOptionManager::GetFlagInt(CompatOptionFlags flag, uint32_t index) const
 		{
-			if (m_CompatVals.count(flag) == 0)
+			CompatOptionFlagStorage const* storage = GetStorage(flag, "GetFlagInt");
+			if (!storage)
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagInt: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return 0;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_INT)
+			if (storage->type == COMPAT_FLAG_TYPE_INT)
 			{
-				return m_CompatVals.at(flag).valInt;
+				return storage->valInt;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_INT_ARRAY)
+			if (storage->type == COMPAT_FLAG_TYPE_INT_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagInt: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
-					return m_CompatVals.at(flag).valInt;
+					return storage->valInt;
 				}
-				if (m_CompatVals.at(flag).valIntArray.count(index))
-					return m_CompatVals.at(flag).valIntArray.at(index);
+				if (uint32_t const* value = FindIndexedValue(flag, index))
+					return *value;
 				/* Return our Default */
-				return m_CompatVals.at(flag).valInt;
+				return storage->valInt;
 			}
 
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "GetFlagInt: (%s) - Flag %s Not a Int Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
@@ -550,31 +478,26 @@ namespace OpenZWave
 
 		bool CompatOptionManager::SetFlagBool(CompatOptionFlags flag, bool value, uint32_t index)
 		{
-			if (m_CompatVals.count(flag) == 0)
+			if (!GetStorage(flag, "SetFlagBool"))
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagBool: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return false;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BOOL)
+			CompatOptionFlagStorage& storage = m_CompatVals[flag];
+			if (storage.type == COMPAT_FLAG_TYPE_BOOL)
 			{
-				m_CompatVals.at(flag).valBool = value;
-				m_CompatVals.at(flag).changed = true;
+				storage.valBool = value;
+				storage.changed = true;
 				return true;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
+			if (storage.type == COMPAT_FLAG_TYPE_BOOL_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagBool: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 					return false;
 				}
-				m_CompatVals.at(flag).changed = true;
-				if (m_CompatVals.at(flag).valBoolArray.count(index)) {
-					m_CompatVals.at(flag).valBoolArray.at(index) = value;
-					return true;
-				} else {
-					m_CompatVals.at(flag).valBoolArray.insert(std::pair<uint32_t, bool>(index, value));
-					return true;
-				}
+				storage.changed = true;
+				SetIndexedValue(flag, index, value);
+				return true;
 			}
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagBool: (%s) - Flag %s Not a Bool Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 			return false;
@@ -582,31 +505,26 @@ namespace OpenZWave
 
 		bool CompatOptionManager::SetFlagByte(CompatOptionFlags flag, uint8_t value, uint32_t index)
 		{
-			if (m_CompatVals.count(flag) == 0)
+			if (!GetStorage(flag, "SetFlagByte"))
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagByte: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return false;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BYTE)
+			CompatOptionFlagStorage& storage = m_CompatVals[flag];
+			if (storage.type == COMPAT_FLAG_TYPE_BYTE)
 			{
-				m_CompatVals.at(flag).valByte = value;
-				m_CompatVals.at(flag).changed = true;
+				storage.valByte = value;
+				storage.changed = true;
 				return true;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_BYTE_ARRAY)
+			if (storage.type == COMPAT_FLAG_TYPE_BYTE_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagByte: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 					return false;
 				}
-				m_CompatVals.at(flag).changed = true;
-				if (m_CompatVals.at(flag).valByteArray.count(index)) {
-					m_CompatVals.at(flag).valByteArray.at(index) = value;
-					return true;
-				} else {
-					m_CompatVals.at(flag).valByteArray.insert(std::pair<uint32_t, uint8_t>(index, value));
-					return true;
-				}
+				storage.changed = true;
+				SetIndexedValue(flag, index, value);
+				return true;
 			}
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagByte: (%s) - Flag %s Not a Byte Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 			return false;
@@ -614,31 +532,26 @@ namespace OpenZWave
 
 		bool CompatOptionManager::SetFlagShort(CompatOptionFlags flag, uint16_t value, uint32_t index)
 		{
-			if (m_CompatVals.count(flag) == 0)
+			if (!GetStorage(flag, "SetFlagShort"))
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagShort: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return false;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_SHORT)
+			CompatOptionFlagStorage& storage = m_CompatVals[flag];
+			if (storage.type == COMPAT_FLAG_TYPE_SHORT)
 			{
-				m_CompatVals.at(flag).valShort = value;
-				m_CompatVals.at(flag).changed = true;
+				storage.valShort = value;
+				storage.changed = true;
 				return true;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_SHORT_ARRAY)
+			if (storage.type == COMPAT_FLAG_TYPE_SHORT_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagShort: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 					return false;
 				}
-				m_CompatVals.at(flag).changed = true;
-				if (m_CompatVals.at(flag).valShortArray.count(index)) {
-					m_CompatVals.at(flag).valShortArray.at(index) = value;
-					return true;
-				} else {
-					m_CompatVals.at(flag).valShortArray.insert(std::pair<uint32_t, uint16_t>(index, value));
-					return true;
-				}
+				storage.changed = true;
+				SetIndexedValue(flag, index, value);
+				return true;
 			}
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagShort: (%s) - Flag %s Not a Short Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 			return false;
@@ -646,36 +559,66 @@ namespace OpenZWave
 
 		bool CompatOptionManager::SetFlagInt(CompatOptionFlags flag, uint32_t value, uint32_t index)
 		{
-			if (m_CompatVals.count(flag) == 0)
+			if (!GetStorage(flag, "SetFlagInt"))
 			{
-				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagInt: (%s) - Flag %s Not Enabled!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 				return false;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_INT)
+			CompatOptionFlagStorage& storage = m_CompatVals[flag];
+			if (storage.type == COMPAT_FLAG_TYPE_INT)
 			{
-				m_CompatVals.at(flag).valInt = value;
-				m_CompatVals.at(flag).changed = true;
+				storage.valInt = value;
+				storage.changed = true;
 				return true;
 			}
-			if (m_CompatVals.at(flag).type == COMPAT_FLAG_TYPE_INT_ARRAY)
+			if (storage.type == COMPAT_FLAG_TYPE_INT_ARRAY)
 			{
 				if (index == (uint32_t)-1) {
 					Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagInt: (%s) - Flag %s had Invalid Index", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 					return false;
 				}
-				m_CompatVals.at(flag).changed = true;
-				if (m_CompatVals.at(flag).valIntArray.count(index)) {
-					m_CompatVals.at(flag).valIntArray.at(index) = value;
-					return true;
-				} else {
-					m_CompatVals.at(flag).valIntArray.insert(std::pair<uint32_t, uint32_t>(index, value));
-					return true;
-				}
+				storage.changed = true;
+				SetIndexedValue(flag, index, value);
+				return true;
 			}
 			Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "SetFlagInt: (%s) - Flag %s Not a Int Value!", m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
 			return false;
 		}
 
+		CompatOptionFlagStorage const* CompatOptionManager::GetStorage(CompatOptionFlags flag, char const* caller) const
+		{
+			if ((flag >= COMPAT_FLAG_COUNT) || !m_CompatVals[flag].enabled)
+			{
+				Log::Write(LogLevel_Warning, m_owner->GetNodeId(), "%s: (%s) - Flag %s Not Enabled!", caller, m_owner->GetCommandClassName().c_str(), GetFlagName(flag).c_str());
+				return NULL;
+			}
+			return &m_CompatVals[flag];
+		}
+
+		uint32_t const* CompatOptionManager::FindIndexedValue(CompatOptionFlags flag, uint32_t index) const
+		{
+			CompatOptionIndexedValue key = { flag, index, 0 };
+			vector<CompatOptionIndexedValue>::const_iterator it = std::lower_bound(m_indexedVals.begin(), m_indexedVals.end(), key, CompareIndexedValue);
+			if ((it != m_indexedVals.end()) && (it->flag == flag) && (it->index == index))
+			{
+				return &it->value;
+			}
+			return NULL;
+		}
+
+		void CompatOptionManager::SetIndexedValue(CompatOptionFlags flag, uint32_t index, uint32_t value)
+		{
+			CompatOptionIndexedValue key = { flag, index, value };
+			vector<CompatOptionIndexedValue>::iterator it = std::lower_bound(m_indexedVals.begin(), m_indexedVals.end(), key, CompareIndexedValue);
+			if ((it != m_indexedVals.end()) && (it->flag == flag) && (it->index == index))
+			{
+				it->value = value;
+			}
+			else
+			{
+				m_indexedVals.insert(it, key);
+			}
+		}
+
 		string CompatOptionManager::GetFlagName(CompatOptionFlags flag) const
 		{
 			for (uint32_t i = 0; i < m_availableFlagsCount; i++)
@@ -31,7 +31,7 @@
 #include "Defs.h"
 #include "tinyxml.h"
 
-#include <map>
+#include <vector>
 
 namespace OpenZWave
 {
@@ -85,6 +85,7 @@ namespace OpenZWave
 			STATE_FLAG_DOORLOCK_TIMEOUTSECS,
 			STATE_FLAG_DOORLOCKLOG_MAXRECORDS,
 			STATE_FLAG_USERCODE_COUNT,
+			COMPAT_FLAG_COUNT				// Number of flags.  Not a flag itself
 		};
 
 		enum CompatOptionFlagType
@@ -107,8 +108,8 @@ namespace OpenZWave
 
 		struct CompatOptionFlagStorage
 		{
-				CompatOptionFlags flag;
 				CompatOptionFlagType type;
+				bool enabled;
 				bool changed;
 				/* when a single Value (not a FLAG_TYPE_*_ARRAY) this union holds the actual value
 				 * but when its a FLAG_*_ARRAY, this union holds the default value
@@ -120,15 +121,16 @@ namespace OpenZWave
 						uint16_t valShort;
 						uint32_t valInt;
 				};
-				/* Only when FLAG_TYPE_*_ARRAY is this union used, and holds
-				 * individual values for each key. Default Value is taken from
-				 * the above Union
-				 */
-				/* oh - And we can't use a Union here with a non-POD type */
-				std::map<uint32_t, bool> valBoolArray;
-				std::map<uint32_t, uint8_t> valByteArray;
-				std::map<uint32_t, uint16_t> valShortArray;
-				std::map<uint32_t, uint32_t> valIntArray;
+		};
+
+		/* The value of a FLAG_TYPE_*_ARRAY flag for one index, when it is not the default.
+		 * Bools, bytes and shorts are all stored as an int.
+		 */
+		struct CompatOptionIndexedValue
+		{
+				CompatOptionFlags flag;
+				uint32_t index;
+				uint32_t value;
 		};
 
 		struct CompatOptionFlagDefintions
@@ -160,8 +162,12 @@ namespace OpenZWave
 			private:
 				string GetFlagName(CompatOptionFlags flag) const;
 				string GetXMLTagName();
-				map<CompatOptionFlags, CompatOptionFlagStorage> m_CompatVals;
-				map<string, CompatOptionFlags> m_enabledCompatFlags;
+				CompatOptionFlagStorage const* GetStorage(CompatOptionFlags flag, char const* caller) const;
+				uint32_t const* FindIndexedValue(CompatOptionFlags flag, uint32_t index) const;
+				void SetIndexedValue(CompatOptionFlags flag, uint32_t index, uint32_t value);
+
+				CompatOptionFlagStorage m_CompatVals[COMPAT_FLAG_COUNT];		// Indexed by flag.  Only the flags passed to EnableFlag are enabled
+				vector<CompatOptionIndexedValue> m_indexedVals;					// Sorted by flag, then index
 				Internal::CC::CommandClass *m_owner;
 				CompatOptionType m_comtype;
 				CompatOptionFlagDefintions *m_availableFlags;
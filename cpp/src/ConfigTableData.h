@@ -0,0 +1,1008 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigTableData.h
+//
+//	Generated by cpp/build/configtables.pl from device_classes.xml,
+//	NotificationCCTypes.xml and SensorMultiLevelCCTypes.xml.  Do not edit,
+//	run "make updateConfigTables" after changing any of those files.
+//
+//-----------------------------------------------------------------------------
+
+// Included by ConfigTables.cpp only
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace ConfigTables
+		{
+			namespace
+			{
+				// device_classes.xml
+				constexpr BasicDeviceClass c_basicDeviceClasses[] =
+				{
+					{ 0x01, "Controller" },
+					{ 0x02, "Static Controller" },
+					{ 0x03, "Slave" },
+					{ 0x04, "Routing Slave" },
+				};
+
+				constexpr DeviceClass c_genericDeviceClasses[] =
+				{
+					{ 0x01, "Remote Controller", "\357\040", 0x00, 0, 5 },
+					{ 0x02, "Static Controller", "\357\040", 0x00, 5, 7 },
+					{ 0x03, "AV Control Point", "\040", 0x00, 12, 4 },
+					{ 0x04, "Display", "\040", 0x00, 16, 1 },
+					{ 0x05, "Network Extender", "\040", 0x00, 17, 1 },
+					{ 0x06, "Appliance", "\040", 0x00, 18, 3 },
+					{ 0x07, "Notification Sensor", "\040", 0x00, 21, 1 },
+					{ 0x08, "Thermostat", "\040", 0x00, 22, 6 },
+					{ 0x09, "Window Covering", "\040", 0x00, 28, 1 },
+					{ 0x0f, "Repeater Slave", "\040", 0x00, 29, 2 },
+					{ 0x10, "Binary Switch", "\040\045", 0x25, 31, 7 },
+					{ 0x11, "Multilevel Switch", "\040\046", 0x26, 38, 8 },
+					{ 0x12, "Remote Switch", "\357\040", 0x00, 46, 4 },
+					{ 0x13, "Toggle Switch", "\040", 0x00, 50, 2 },
+					{ 0x14, "Z/IP Gateway", "\040", 0x00, 52, 2 },
+					{ 0x15, "Z/IP Node", NULL, 0x00, 54, 2 },
+					{ 0x16, "Ventilation", "\040", 0x00, 56, 1 },
+					{ 0x17, "Security Panel", "\040", 0x00, 57, 1 },
+					{ 0x18, "Wall Controller", "\040", 0x00, 58, 1 },
+					{ 0x20, "Binary Sensor", "\060\357\040", 0x30, 59, 1 },
+					{ 0x21, "Multilevel Sensor", "\061\357\040", 0x31, 60, 2 },
+					{ 0x30, "Pulse Meter", "\065\357\040", 0x35, 62, 0 },
+					{ 0x31, "Meter", "\357\040", 0x00, 62, 3 },
+					{ 0x40, "Entry Control", "\040", 0x00, 65, 11 },
+					{ 0x50, "Semi Interoperable", "\040\162\206\210", 0x00, 76, 1 },
+					{ 0xa1, "Alarm Sensor", "\357\040", 0x71, 77, 11 },
+					{ 0xff, "Non Interoperable", NULL, 0x00, 88, 0 },
+				};
+
+				constexpr DeviceClass c_specificDeviceClasses[] =
+				{
+					{ 0x01, "Portable Remote Controller", NULL, 0x00, 0, 0 },
+					{ 0x02, "Portable Scene Controller", "\055\162\205\357\053", 0x00, 0, 0 },
+					{ 0x03, "Portable Installer Tool", "\041\162\206\217\357\041\140\160\162\204\205\206\216", 0x00, 0, 0 },
+					{ 0x04, "Remote Control AV", NULL, 0x00, 0, 0 },
+					{ 0x06, "Remote Control Simple", NULL, 0x00, 0, 0 },
+					{ 0x01, "Static PC Controller", NULL, 0x00, 0, 0 },
+					{ 0x02, "Static Scene Controller", "\055\162\205\357\053", 0x00, 0, 0 },
+					{ 0x03, "Static Installer Tool", "\041\162\206\217\357\041\140\160\162\204\205\206\216", 0x00, 0, 0 },
+					{ 0x04, "Set Top Box", NULL, 0x00, 0, 0 },
+					{ 0x05, "Sub System Controller", NULL, 0x00, 0, 0 },
+					{ 0x06, "TV", NULL, 0x00, 0, 0 },
+					{ 0x07, "Gateway", NULL, 0x00, 0, 0 },
+					{ 0x01, "Sound Switch", "\125\131\132\136\154\162\163\171\205\206\237", 0x00, 0, 0 },
+					{ 0x04, "Satellite Receiver", "\162\206\224", 0x00, 0, 0 },
+					{ 0x11, "Satellite Receiver V2", "\162\206\224", 0x94, 0, 0 },
+					{ 0x12, "Doorbell", "\060\162\205\206", 0x30, 0, 0 },
+					{ 0x01, "Simple Display", "\162\206\222\223", 0x00, 0, 0 },
+					{ 0x01, "Secure Extender", NULL, 0x00, 0, 0 },
+					{ 0x01, "General Appliance", NULL, 0x00, 0, 0 },
+					{ 0x02, "Kitchen Appliance", NULL, 0x00, 0, 0 },
+					{ 0x03, "Laundry Appliance", NULL, 0x00, 0, 0 },
+					{ 0x01, "Notification Sensor", NULL, 0x00, 0, 0 },
+					{ 0x01, "Heating Thermostat", NULL, 0x00, 0, 0 },
+					{ 0x02, "General Thermostat", "\100\103\162", 0x40, 0, 0 },
+					{ 0x03, "Setback Schedule Thermostat", "\106\162\206\217\357\106\201\217", 0x46, 0, 0 },
+					{ 0x04, "Setpoint Thermostat", "\103\162\206\217\357\103\217", 0x43, 0, 0 },
+					{ 0x05, "Setback Thermostat", "\100\103\107\162\206", 0x40, 0, 0 },
+					{ 0x06, "General Thermostat V2", "\100\103\162\206", 0x40, 0, 0 },
+					{ 0x01, "Simple Window Covering", "\120", 0x50, 0, 0 },
+					{ 0x01, "Basic Repeater Slave", NULL, 0x00, 0, 0 },
+					{ 0x02, "Virtual Node", NULL, 0x00, 0, 0 },
+					{ 0x01, "Binary Power Switch", "\047", 0x00, 0, 0 },
+					{ 0x02, "Binary Tunable Color Light", "\047\063\162", 0x25, 0, 0 },
+					{ 0x03, "Binary Scene Switch", "\053\054\162", 0x00, 0, 0 },
+					{ 0x04, "Power Strip", "\040\045", 0x25, 0, 0 },
+					{ 0x05, "Siren", "\040\045", 0x25, 0, 0 },
+					{ 0x06, "Valve Open Close", "\040\045", 0x25, 0, 0 },
+					{ 0x07, "Irrigation Control", "\125\131\132\136\154\162\163\205\206\237", 0x00, 0, 0 },
+					{ 0x01, "Multilevel Power Switch", "\047", 0x00, 0, 0 },
+					{ 0x02, "Multilevel Tunable Color Light", "\047\063\162", 0x00, 0, 0 },
+					{ 0x03, "Multiposition Motor", "\162\206", 0x00, 0, 0 },
+					{ 0x04, "Multilevel Scene Switch", "\047\053\054\162", 0x00, 0, 0 },
+					{ 0x05, "Motor Control Class A", "\045\162\206", 0x00, 0, 0 },
+					{ 0x06, "Motor Control Class B", "\045\162\206", 0x00, 0, 0 },
+					{ 0x07, "Motor Control Class C", "\045\162\206", 0x00, 0, 0 },
+					{ 0x08, "Fan Switch", "\125\131\132\136\154\162\163\205\206\237", 0x00, 0, 0 },
+					{ 0x01, "Binary Remote Switch", "\357\045", 0x25, 0, 0 },
+					{ 0x02, "Multilevel Remote Switch", "\357\046", 0x26, 0, 0 },
+					{ 0x03, "Binary Toggle Remote Switch", "\357\050", 0x28, 0, 0 },
+					{ 0x04, "Multilevel Toggle Remote Switch", "\357\051", 0x29, 0, 0 },
+					{ 0x01, "Binary Toggle Switch", "\045\050", 0x28, 0, 0 },
+					{ 0x02, "Multilevel Toggle Switch", "\046\051", 0x29, 0, 0 },
+					{ 0x01, "Z/IP Tunneling Gateway", "\043\044\162\206", 0x00, 0, 0 },
+					{ 0x02, "Z/IP Advanced Gateway", "\043\044\057\063\162\206", 0x00, 0, 0 },
+					{ 0x01, "Z/IP Tunneling Node", "\043\056\162\206", 0x00, 0, 0 },
+					{ 0x02, "Z/IP Advanced Node", "\043\056\057\064\162\206", 0x00, 0, 0 },
+					{ 0x01, "Residential Heat Recovery Ventilation", "\067\071\162\206", 0x39, 0, 0 },
+					{ 0x01, "Zoned Security Panel", NULL, 0x00, 0, 0 },
+					{ 0x01, "Basic Wall Controller", NULL, 0x00, 0, 0 },
+					{ 0x01, "Routing Binary Sensor", NULL, 0x00, 0, 0 },
+					{ 0x01, "Routing Multilevel Sensor", NULL, 0x00, 0, 0 },
+					{ 0x02, "Chimney Fan", NULL, 0x00, 0, 0 },
+					{ 0x01, "Simple Meter", "\062\162\206", 0x32, 0, 0 },
+					{ 0x02, "Advanced Energy Control", "\074\075\162\206", 0x00, 0, 0 },
+					{ 0x03, "Whole Home Meter Simple", NULL, 0x00, 0, 0 },
+					{ 0x01, "Door Lock", "\142", 0x62, 0, 0 },
+					{ 0x02, "Advanced Door Lock", "\142\162\206", 0x62, 0, 0 },
+					{ 0x03, "Secure Keypad Door Lock", "\142\143\162\206\230", 0x62, 0, 0 },
+					{ 0x04, "Secure Keypad Door Lock DeadBolt", "\143\162\166\206\230", 0x76, 0, 0 },
+					{ 0x05, "Secure Door", NULL, 0x00, 0, 0 },
+					{ 0x06, "Secure Gate", NULL, 0x00, 0, 0 },
+					{ 0x07, "Secure Barrier AddOn", NULL, 0x00, 0, 0 },
+					{ 0x08, "Secure Barrier Open Only", NULL, 0x00, 0, 0 },
+					{ 0x09, "Secure Barrier Close Only", NULL, 0x00, 0, 0 },
+					{ 0x0a, "Secure LockBox", NULL, 0x00, 0, 0 },
+					{ 0x0b, "Secure Keypad", "\125\131\136\132\154\157\162\163\205\206\230\237", 0x00, 0, 0 },
+					{ 0x01, "Energy Production", "\220", 0x00, 0, 0 },
+					{ 0x01, "Basic Routing Alarm Sensor", "\161\162\205\206\357\161", 0x00, 0, 0 },
+					{ 0x02, "Routing Alarm Sensor", "\161\162\200\205\206\357\161", 0x00, 0, 0 },
+					{ 0x03, "Basic Zensor Alarm Sensor", "\161\162\206\357\161", 0x00, 0, 0 },
+					{ 0x04, "Zensor Alarm Sensor", "\161\162\200\206\357\161", 0x00, 0, 0 },
+					{ 0x05, "Advanced Zensor Alarm Sensor", "\161\162\200\205\206\357\161", 0x00, 0, 0 },
+					{ 0x06, "Basic Routing Smoke Sensor", "\161\162\205\206\357\161", 0x00, 0, 0 },
+					{ 0x07, "Routing Smoke Sensor", "\161\162\200\205\206\357\161", 0x00, 0, 0 },
+					{ 0x08, "Basic Zensor Smoke Sensor", "\161\162\206\357\161", 0x00, 0, 0 },
+					{ 0x09, "Zensor Smoke Sensor", "\161\162\200\206\357\161", 0x00, 0, 0 },
+					{ 0x0a, "Advanced Zensor Smoke Sensor", "\161\162\200\205\206\357\161", 0x00, 0, 0 },
+					{ 0x0b, "Alarm Sensor", "\161\162\205\206\357\161", 0x71, 0, 0 },
+				};
+
+				constexpr DeviceClass c_roleDeviceClasses[] =
+				{
+					{ 0x00, "Central Controller", "\132", 0x00, 0, 0 },
+					{ 0x01, "Sub Controller", "\132", 0x00, 0, 0 },
+					{ 0x02, "Portable Controller", "\132", 0x00, 0, 0 },
+					{ 0x03, "Portable Reporting Controller", "\132\204", 0x00, 0, 0 },
+					{ 0x04, "Portable Slave", "\132\204", 0x00, 0, 0 },
+					{ 0x05, "Always On Slave", "\132", 0x00, 0, 0 },
+					{ 0x06, "Reporting Sleeping Slave", "\132\204", 0x00, 0, 0 },
+					{ 0x07, "Listening Sleeping Slave", "\132", 0x00, 0, 0 },
+					{ 0x08, "Network Aware Slave", NULL, 0x00, 0, 0 },
+				};
+
+				constexpr DeviceClass c_deviceTypeClasses[] =
+				{
+					{ 0x00, "Unknown Type (0x0000)", NULL, 0x00, 0, 0 },
+					{ 0x100, "Central Controller", "\132\136\131\162\163\205\206\126\042", 0x00, 0, 0 },
+					{ 0x200, "Display Simple", "\132\136\131\162\163\205\206", 0x00, 0, 0 },
+					{ 0x300, "Door Lock Keypad", "\132\136\131\162\163\205\206\142\143\200", 0x00, 0, 0 },
+					{ 0x400, "Fan Switch", "\132\136\131\162\163\205\206\046", 0x00, 0, 0 },
+					{ 0x500, "Gateway", "\132\136\131\162\163\205\206\126\140\216\204\042", 0x00, 0, 0 },
+					{ 0x600, "Light Dimmer Switch", "\132\136\131\162\163\205\206\046", 0x00, 0, 0 },
+					{ 0x601, "Light Dimmer Switch Plugin", NULL, 0x00, 0, 0 },
+					{ 0x602, "Light Dimmer Switch Wall Outlet", NULL, 0x00, 0, 0 },
+					{ 0x603, "Light Dimmer Switch Ceiling Outlet", NULL, 0x00, 0, 0 },
+					{ 0x604, "Light Dimmer Switch Wall Lamp", NULL, 0x00, 0, 0 },
+					{ 0x605, "Light Dimmer Switch Lamp Post High", NULL, 0x00, 0, 0 },
+					{ 0x606, "Light Dimmer Switch Lamp Post Low", NULL, 0x00, 0, 0 },
+					{ 0x607, "Light Dimmer Switch Din Rail Module", NULL, 0x00, 0, 0 },
+					{ 0x700, "On/Off Power Switch", "\132\136\131\162\163\205\206\045", 0x00, 0, 0 },
+					{ 0x701, "On/Off Power Switch Plugin", NULL, 0x00, 0, 0 },
+					{ 0x702, "On/Off Power Switch Wall Outlet", NULL, 0x00, 0, 0 },
+					{ 0x703, "On/Off Power Switch Ceiling Outlet", NULL, 0x00, 0, 0 },
+					{ 0x704, "On/Off Power Switch Wall Lamp", NULL, 0x00, 0, 0 },
+					{ 0x705, "On/Off Power Switch Lamp Post High", NULL, 0x00, 0, 0 },
+					{ 0x706, "On/Off Power Switch Lamp Post Low", NULL, 0x00, 0, 0 },
+					{ 0x707, "On/Off Power Switch Din Rail Module", NULL, 0x00, 0, 0 },
+					{ 0x800, "Power Strip", "\132\136\131\162\163\205\206\140\216\045", 0x00, 0, 0 },
+					{ 0x8ff, "Power Strip Individual Outlet", NULL, 0x00, 0, 0 },
+					{ 0x900, "Remote Control AV", "\132\136\131\162\163\205\206", 0x00, 0, 0 },
+					{ 0xa00, "Remote Control Multi Purpose", "\132\136\131\162\163\205\206\204", 0x00, 0, 0 },
+					{ 0xb00, "Remote Control Simple", "\132\136\131\162\163\205\206\133", 0x00, 0, 0 },
+					{ 0xb01, "Key Fob", "\132\136\131\162\163\205\206\133", 0x00, 0, 0 },
+					{ 0xc00, "Sensor Notification", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc01, "Smoke Alarm Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc02, "CO Alarm Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc03, "CO2 Alarm Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc04, "Heat Alarm Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc05, "Water Alarm Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc06, "Access Control Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc07, "Home Security Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc08, "Power Management Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc09, "System Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc0a, "Emergency Alarm Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc0b, "Clock Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xc0c, "Sensor Notification Appliance", NULL, 0x00, 0, 0 },
+					{ 0xc0d, "Sensor Notification Home Health", NULL, 0x00, 0, 0 },
+					{ 0xc0e, "Sensor Notification Siren", NULL, 0x00, 0, 0 },
+					{ 0xc0f, "Sensor Notification Water Valve", NULL, 0x00, 0, 0 },
+					{ 0xc10, "Sensor Notification Weather Alarm", NULL, 0x00, 0, 0 },
+					{ 0xc11, "Sensor Notification Irrigation", NULL, 0x00, 0, 0 },
+					{ 0xc12, "Sensor Notification Gas Alarm", NULL, 0x00, 0, 0 },
+					{ 0xc13, "Sensor Notification Pest Control", NULL, 0x00, 0, 0 },
+					{ 0xc14, "Sensor Notification Light Sensor", NULL, 0x00, 0, 0 },
+					{ 0xcff, "MultiDevice Sensor", "\132\136\131\162\163\205\206\060", 0x00, 0, 0 },
+					{ 0xd00, "Multilevel Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd01, "Air Temperature Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd02, "General Purpose Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd03, "Luminance Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd04, "Power Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd05, "Humidity Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd06, "Velocity Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd07, "Direction Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd08, "Atmospheric Pressure Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd09, "Barometric Pressure Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd0a, "Solar Radiation Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd0b, "Dew Point Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd0c, "Rain Rate Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd0d, "Tide Level Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd0e, "Weight Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd0f, "Voltage Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd10, "Current Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd11, "CO2 Level Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd12, "Air Flow Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd13, "Tank Capacity Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd14, "Distance Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd15, "Angle Postition Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd16, "Rotation Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd17, "Water Temperature Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd18, "Soil Temperature Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd19, "Seismic Intensity Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd1a, "Seismic Magnitude Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd1b, "Ultraviolet Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd1c, "Electrical Resistivity Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd1d, "Electrical Conductivity Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd1e, "Loudness Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd1f, "Moisture Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd20, "Frequency Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd21, "Time Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd22, "Target Temperature Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xd23, "Multilevel Sensor: Particulate Matter 2.5", NULL, 0x00, 0, 0 },
+					{ 0xd24, "Multilevel Sensor: Formaldehyde CH2O-level", NULL, 0x00, 0, 0 },
+					{ 0xd25, "Multilevel Sensor: Radon Concentration", NULL, 0x00, 0, 0 },
+					{ 0xd26, "Multilevel Sensor: Methane (CH4) density", NULL, 0x00, 0, 0 },
+					{ 0xd27, "Multilevel Sensor: Volatile Organic Compound level", NULL, 0x00, 0, 0 },
+					{ 0xd28, "Multilevel Sensor: Carbon Monoxide level", NULL, 0x00, 0, 0 },
+					{ 0xd29, "Multilevel Sensor: Soil Humidity", NULL, 0x00, 0, 0 },
+					{ 0xd2a, "Multilevel Sensor: Soil Reactivity", NULL, 0x00, 0, 0 },
+					{ 0xd2b, "Multilevel Sensor: Soil Salinity", NULL, 0x00, 0, 0 },
+					{ 0xd2c, "Multilevel Sensor: Heart Rate", NULL, 0x00, 0, 0 },
+					{ 0xd2d, "Multilevel Sensor: Blood Pressure", NULL, 0x00, 0, 0 },
+					{ 0xd2e, "Multilevel Sensor: Muscle Mass", NULL, 0x00, 0, 0 },
+					{ 0xd2f, "Multilevel Sensor: Fat Mass", NULL, 0x00, 0, 0 },
+					{ 0xd30, "Multilevel Sensor: Bone Mass", NULL, 0x00, 0, 0 },
+					{ 0xd31, "Multilevel Sensor: Total Body Water", NULL, 0x00, 0, 0 },
+					{ 0xd32, "Multilevel Sensor: Basis Metabolic Rate", NULL, 0x00, 0, 0 },
+					{ 0xd33, "Multilevel Sensor: Body Mass Index", NULL, 0x00, 0, 0 },
+					{ 0xd34, "Multilevel Sensor: Acceleration X Axis", NULL, 0x00, 0, 0 },
+					{ 0xd35, "Multilevel Sensor: Acceleration Y Axis", NULL, 0x00, 0, 0 },
+					{ 0xd36, "Multilevel Sensor: Acceleration Z Axis", NULL, 0x00, 0, 0 },
+					{ 0xd37, "Multilevel Sensor: Smoke Density", NULL, 0x00, 0, 0 },
+					{ 0xd38, "Multilevel Sensor: Water Flow", NULL, 0x00, 0, 0 },
+					{ 0xd39, "Multilevel Sensor: Water Pressure", NULL, 0x00, 0, 0 },
+					{ 0xd3a, "Multilevel Sensor: Signal Strength", NULL, 0x00, 0, 0 },
+					{ 0xd3b, "Multilevel Sensor: particulate Matter 10", NULL, 0x00, 0, 0 },
+					{ 0xd3c, "Multilevel Sensor: Respiratory Rate", NULL, 0x00, 0, 0 },
+					{ 0xd3d, "Multilevel Sensor: Relative Modulation Level", NULL, 0x00, 0, 0 },
+					{ 0xd3e, "Multilevel Sensor: Boiler Water Temperature", NULL, 0x00, 0, 0 },
+					{ 0xd3f, "Multilevel Sensor: Domestic Hot Water temperature", NULL, 0x00, 0, 0 },
+					{ 0xd40, "Multilevel Sensor: Outside temperature", NULL, 0x00, 0, 0 },
+					{ 0xd41, "Multilevel Sensor: Exhaust temperature", NULL, 0x00, 0, 0 },
+					{ 0xd42, "Multilevel Sensor: Water Chlorine level", NULL, 0x00, 0, 0 },
+					{ 0xd43, "Multilevel Sensor: Water Acidity", NULL, 0x00, 0, 0 },
+					{ 0xd44, "Multilevel Sensor: Water Oxidation reduction potential", NULL, 0x00, 0, 0 },
+					{ 0xdff, "MultiDevice Sensor", "\132\136\131\162\163\205\206\060\061", 0x00, 0, 0 },
+					{ 0xe00, "Set Top Box", "\132\136\131\162\163\205\206\126\140\216\204\042", 0x00, 0, 0 },
+					{ 0xf00, "Siren", "\132\136\131\162\163\205\206", 0x00, 0, 0 },
+					{ 0x1000, "Sub Energy Meter", "\132\136\131\162\163\205\206\126\062", 0x00, 0, 0 },
+					{ 0x1100, "Sub System Controller", "\132\136\131\162\163\205\206\140\204\042", 0x00, 0, 0 },
+					{ 0x1200, "Thermostat HVAC", "\132\136\131\162\163\205\206\103\100", 0x00, 0, 0 },
+					{ 0x1201, "Thermostat, Line Voltage Switching", NULL, 0x00, 0, 0 },
+					{ 0x1202, "Thermostat, Setback Type", NULL, 0x00, 0, 0 },
+					{ 0x1300, "Thermostat Setback", "\132\136\131\162\163\205\206\103", 0x00, 0, 0 },
+					{ 0x1400, "TV", "\132\136\131\162\163\205\206\126\140\216\204\042", 0x00, 0, 0 },
+					{ 0x1500, "Valve open/close", "\132\136\131\162\163\205\206\046\045", 0x00, 0, 0 },
+					{ 0x1600, "Wall Controller", "\132\136\131\162\163\205\206\133", 0x00, 0, 0 },
+					{ 0x1700, "Whole Home Meter Simple", "\132\136\131\162\163\205\206\126\062", 0x00, 0, 0 },
+					{ 0x1800, "Window Covering No Position/Endpoint", "\132\136\131\162\163\205\206\046\045", 0x00, 0, 0 },
+					{ 0x1900, "Window Covering Endpoint Aware", "\132\136\131\162\163\205\206\046\045", 0x00, 0, 0 },
+					{ 0x1a00, "Window Covering Position/Endpoint Aware", "\132\136\131\162\163\205\206\046\045", 0x00, 0, 0 },
+					{ 0x1b00, "Generic Repeater", NULL, 0x00, 0, 0 },
+					{ 0x1b01, "Basic Repeater Slave", NULL, 0x00, 0, 0 },
+					{ 0x1b03, "IR Repeater", NULL, 0x00, 0, 0 },
+					{ 0x1c00, "Dimmer Wall Switch", NULL, 0x00, 0, 0 },
+					{ 0x1c01, "Dimmer Wall Switch, 1 button", NULL, 0x00, 0, 0 },
+					{ 0x1c02, "Dimmer Wall Switch, 2 buttons", NULL, 0x00, 0, 0 },
+					{ 0x1c03, "Dimmer Wall Switch, 3 buttons", NULL, 0x00, 0, 0 },
+					{ 0x1c04, "Dimmer Wall Switch, 4 buttons", NULL, 0x00, 0, 0 },
+					{ 0x1cf1, "Dimmer Wall Switch, 1 rotary knob", NULL, 0x00, 0, 0 },
+					{ 0x1d00, "On/Off Wall Switch", NULL, 0x00, 0, 0 },
+					{ 0x1d01, "On/Off Wall Switch, 1 button", NULL, 0x00, 0, 0 },
+					{ 0x1d02, "On/Off Wall Switch, 2 buttons", NULL, 0x00, 0, 0 },
+					{ 0x1d03, "On/Off Wall Switch, 3 buttons", NULL, 0x00, 0, 0 },
+					{ 0x1d04, "On/Off Wall Switch, 4 buttons", NULL, 0x00, 0, 0 },
+					{ 0x1de1, "On/Off Wall Switch, Door Bell", NULL, 0x00, 0, 0 },
+					{ 0x1df1, "On/Off Wall Switch, 1 rotary knob", NULL, 0x00, 0, 0 },
+					{ 0x1e00, "Barrier", NULL, 0x00, 0, 0 },
+					{ 0x1f00, "Irrigation", NULL, 0x00, 0, 0 },
+					{ 0x2000, "Entry Control", NULL, 0x00, 0, 0 },
+					{ 0x2001, "Entry Control, Keypad 0-9", NULL, 0x00, 0, 0 },
+					{ 0x2002, "Entry Control, RFID tag reader, no button", NULL, 0x00, 0, 0 },
+					{ 0x2003, "Entry control, keypad 0-9 with ok and cancel buttons", NULL, 0x00, 0, 0 },
+					{ 0x2004, "Entry control, keypad 0-9 with ok, cancel, home, stay and away buttons", NULL, 0x00, 0, 0 },
+					{ 0x2100, "Home Security Alarm", NULL, 0x00, 0, 0 },
+					{ 0x2101, "Home Security Alarm, Intrusion", NULL, 0x00, 0, 0 },
+					{ 0x2102, "Home Security Alarm, Glass Breakage", NULL, 0x00, 0, 0 },
+					{ 0x2200, "Sound Switch", NULL, 0x00, 0, 0 },
+					{ 0x2201, "Sound Switch, Doorbell", NULL, 0x00, 0, 0 },
+					{ 0x2202, "Sound Switch, Chime", NULL, 0x00, 0, 0 },
+					{ 0x2203, "Sound Switch, Alarm Clock", NULL, 0x00, 0, 0 },
+				};
+
+				constexpr DeviceClass c_nodeTypes[] =
+				{
+					{ 0x00, "Z-Wave+ node", NULL, 0x00, 0, 0 },
+					{ 0x01, "Z-Wave+ IP router", NULL, 0x00, 0, 0 },
+					{ 0x02, "Z-Wave+ IP gateway", NULL, 0x00, 0, 0 },
+					{ 0x03, "Z-Wave+ IP client and IP node", NULL, 0x00, 0, 0 },
+					{ 0x04, "Z-Wave+ IP client and Zwave node", NULL, 0x00, 0, 0 },
+				};
+
+				// NotificationCCTypes.xml
+				constexpr uint32 c_notificationRevision = 11;
+
+				constexpr NotificationType c_notificationTypes[] =
+				{
+					{ 1, "Smoke Alarm", 0, 10 },
+					{ 2, "Carbon Monoxide", 10, 9 },
+					{ 3, "Carbon Dioxide", 19, 9 },
+					{ 4, "Heat", 28, 15 },
+					{ 5, "Water", 43, 13 },
+					{ 6, "Access Control", 56, 41 },
+					{ 7, "Home Security", 97, 14 },
+					{ 8, "Power Management", 111, 19 },
+					{ 9, "System", 130, 12 },
+					{ 10, "Emergency", 142, 6 },
+					{ 11, "Clock", 148, 5 },
+					{ 12, "Appliance", 153, 23 },
+					{ 13, "Home Health", 176, 13 },
+					{ 14, "Siren", 189, 3 },
+					{ 15, "Water Valve", 192, 8 },
+					{ 16, "Weather", 200, 5 },
+					{ 17, "Irrigation", 205, 7 },
+					{ 18, "Gas", 212, 8 },
+					{ 19, "Pest Control", 220, 10 },
+					{ 20, "Light", 230, 4 },
+					{ 21, "Water Quality Monitoring", 234, 19 },
+					{ 22, "Home Monitoring", 253, 4 },
+				};
+
+				constexpr NotificationEvent c_notificationEvents[] =
+				{
+					{ 0, "Clear", 0, 1 },
+					{ 1, "Smoke Detected at Location", 1, 1 },
+					{ 2, "Smoke Detected at Unknown Location", 2, 0 },
+					{ 3, "Smoke Test", 2, 0 },
+					{ 4, "Replacement Required (Unspecified)", 2, 0 },
+					{ 5, "Replacement Required (End Of Life)", 2, 0 },
+					{ 6, "Silenced", 2, 0 },
+					{ 7, "Maintenance Required: Periodic Inspection", 2, 0 },
+					{ 8, "Maintenance Required: Dust In Device", 2, 0 },
+					{ 254, "Unknown Event", 2, 0 },
+					{ 0, "Clear", 2, 1 },
+					{ 1, "Carbon Monoxide Detected at Location", 3, 1 },
+					{ 2, "Carbon Monoxide Detected at Unknown Location", 4, 0 },
+					{ 3, "Test", 4, 1 },
+					{ 4, "Replacement Required (Unspecified)", 5, 0 },
+					{ 5, "Replacement Required (End Of Life)", 5, 0 },
+					{ 6, "Silenced", 5, 0 },
+					{ 7, "Maintenance Required: Periodic Inspection", 5, 0 },
+					{ 254, "Unknown Event", 5, 0 },
+					{ 0, "Clear", 5, 1 },
+					{ 1, "Carbon Dioxide Detected at Location", 6, 1 },
+					{ 2, "Carbon Dioxide Detected at Unknown Location", 7, 0 },
+					{ 3, "Test", 7, 1 },
+					{ 4, "Replacement Required (Unspecified)", 8, 0 },
+					{ 5, "Replacement Required (End Of Life)", 8, 0 },
+					{ 6, "Silenced", 8, 0 },
+					{ 7, "Maintenance Required: Periodic Inspection", 8, 0 },
+					{ 254, "Unknown Event", 8, 0 },
+					{ 0, "Clear", 8, 1 },
+					{ 1, "OverHeat at Location", 9, 1 },
+					{ 2, "OverHeat at Unknown at Location", 10, 0 },
+					{ 3, "Rapid Temperature Rise at Location", 10, 1 },
+					{ 4, "Rapid Temperature Rise at Unknown Location", 11, 0 },
+					{ 5, "UnderHeat at Location", 11, 1 },
+					{ 6, "UnderHeat at Unknown Location", 12, 0 },
+					{ 7, "Test", 12, 0 },
+					{ 8, "Replacement Required (End_Of_Life)", 12, 0 },
+					{ 9, "Silenced", 12, 0 },
+					{ 10, "Maintenance Required: Dust In Device", 12, 0 },
+					{ 11, "Maintenance_Required: Periodic Inspection", 12, 0 },
+					{ 12, "Rapid temperature fall at Location", 12, 1 },
+					{ 13, "Rapid temperature fall at Unknown Location", 13, 0 },
+					{ 254, "Unknown Event", 13, 0 },
+					{ 0, "Clear", 13, 1 },
+					{ 1, "Water Leak at Location", 14, 1 },
+					{ 2, "Water Leak at Unknown Location", 15, 0 },
+					{ 3, "Water Level Dropped at Location", 15, 1 },
+					{ 4, "Water Level Dropped at Unknown Location", 16, 0 },
+					{ 5, "Replace Filter", 16, 0 },
+					{ 6, "Water Flow", 16, 1 },
+					{ 7, "Water Pressure", 17, 1 },
+					{ 8, "Water Temperature", 18, 1 },
+					{ 9, "Water Level", 19, 1 },
+					{ 10, "Sump Pump Active", 20, 0 },
+					{ 11, "Sump Pump Failure", 20, 0 },
+					{ 254, "Unknown Event", 20, 0 },
+					{ 0, "Clear", 20, 1 },
+					{ 1, "Manual Lock Operation", 21, 0 },
+					{ 2, "Manual Unlock Operation", 21, 0 },
+					{ 3, "Wireless Lock Operation", 21, 0 },
+					{ 4, "Wireless Unlock Operation", 21, 0 },
+					{ 5, "Keypad Lock Operation", 21, 1 },
+					{ 6, "Keypad Unlock Operation", 22, 1 },
+					{ 7, "Manual Lock Not Fully Locked", 23, 0 },
+					{ 8, "Wireless Not Fully Locked", 23, 0 },
+					{ 9, "Auto Lock", 23, 0 },
+					{ 10, "Auto Lock Not Fully Locked", 23, 0 },
+					{ 11, "Lock Jammed", 23, 0 },
+					{ 12, "All User Codes Deleted", 23, 0 },
+					{ 13, "Single User Code Deleted", 23, 0 },
+					{ 14, "New User Code Added", 23, 0 },
+					{ 15, "Duplicate User Code Not Added", 23, 0 },
+					{ 16, "Keypad Disabled", 23, 0 },
+					{ 17, "Keypad Busy", 23, 0 },
+					{ 18, "New Program Code Entered", 23, 0 },
+					{ 19, "User Codes Attempt Exceeds Limit", 23, 0 },
+					{ 20, "Wireless Unlock Invalid UserCode Entered", 23, 0 },
+					{ 21, "Wireless Lock Invalid UserCode Entered", 23, 0 },
+					{ 22, "Door/Window Open", 23, 0 },
+					{ 23, "Door/Window Closed", 23, 0 },
+					{ 24, "Window/door handle is open", 23, 0 },
+					{ 25, "Window/door handle is closed", 23, 0 },
+					{ 26, "Messaging User Code entered via keypad", 23, 1 },
+					{ 64, "Barrier Initializing", 24, 1 },
+					{ 65, "Barrier Force Exceeded", 25, 0 },
+					{ 66, "Barrier Motor Time Exceeded", 25, 1 },
+					{ 67, "Barrier Physical Limits Exceeded", 26, 0 },
+					{ 68, "Barrier Failed Operation", 26, 0 },
+					{ 69, "Barrier Unattended Operation Disabled", 26, 0 },
+					{ 70, "Barrier Malfunction", 26, 0 },
+					{ 71, "Barrier Vacation Mode", 26, 1 },
+					{ 72, "Barrier Safety Beam Obstruction", 27, 1 },
+					{ 73, "Barrier Sensor Not Detected", 28, 1 },
+					{ 74, "Barrier Battery Low", 29, 1 },
+					{ 75, "Barrier Short in Wall Station Wires", 30, 0 },
+					{ 76, "Barrier Associated with Non ZWave Device", 30, 0 },
+					{ 254, "Unknown Event", 30, 0 },
+					{ 0, "Clear", 30, 1 },
+					{ 1, "Intrusion at Location", 31, 1 },
+					{ 2, "Intrusion at Unknown Location", 32, 0 },
+					{ 3, "Tampering -  Cover Removed", 32, 0 },
+					{ 4, "Tampering - Invalid Code", 32, 0 },
+					{ 5, "Glass Breakage at Location", 32, 1 },
+					{ 6, "Glass Breakage at UnknownLocation", 33, 0 },
+					{ 7, "Motion Detected at Location", 33, 1 },
+					{ 8, "Motion Detected at Unknown Location", 34, 0 },
+					{ 9, "Tampering - Product Moved", 34, 0 },
+					{ 10, "Impact detected", 34, 0 },
+					{ 11, "Magnetic field interference detected", 34, 0 },
+					{ 12, "RF Jamming detected", 34, 1 },
+					{ 254, "Unknown Event", 35, 0 },
+					{ 0, "Clear", 35, 1 },
+					{ 1, "Power Applied", 36, 0 },
+					{ 2, "AC Power Lost", 36, 0 },
+					{ 3, "AC Power Restored", 36, 0 },
+					{ 4, "Surge Detected", 36, 0 },
+					{ 5, "Brownout Detected", 36, 0 },
+					{ 6, "Over Current Detected", 36, 0 },
+					{ 7, "Over Voltage Detected", 36, 0 },
+					{ 8, "Over Load Detected", 36, 0 },
+					{ 9, "Load Error", 36, 0 },
+					{ 10, "Replace Battery Soon", 36, 0 },
+					{ 11, "Replace Battery Now", 36, 0 },
+					{ 12, "Battery Charging", 36, 0 },
+					{ 13, "Battery Charged", 36, 0 },
+					{ 14, "Battery Low", 36, 0 },
+					{ 15, "Battery Critical", 36, 0 },
+					{ 16, "Back-up battery is low", 36, 0 },
+					{ 18, "Back-up battery disconnected", 36, 0 },
+					{ 254, "Unknown Event", 36, 0 },
+					{ 0, "Clear", 36, 1 },
+					{ 1, "Hardware Failure", 37, 0 },
+					{ 2, "Software Failure", 37, 0 },
+					{ 3, "Hardware Failure Code", 37, 1 },
+					{ 4, "Software Failure Code", 38, 1 },
+					{ 5, "Heartbeat", 39, 0 },
+					{ 6, "Tampering Detected", 39, 0 },
+					{ 7, "Emergency Shutoff", 39, 0 },
+					{ 8, "Digital input high state", 39, 0 },
+					{ 9, "Digital input low state", 39, 0 },
+					{ 10, "Digital input open", 39, 0 },
+					{ 254, "Unknown_Event", 39, 0 },
+					{ 0, "Clear", 39, 1 },
+					{ 1, "Contact Police Department", 40, 0 },
+					{ 2, "Contact Fire Department", 40, 0 },
+					{ 3, "Contact Medical Service", 40, 0 },
+					{ 4, "Panic alert", 40, 0 },
+					{ 254, "Unknown Event", 40, 0 },
+					{ 0, "Clear", 40, 1 },
+					{ 1, "Wake Up Alert", 41, 0 },
+					{ 2, "Timer Ending", 41, 0 },
+					{ 3, "Time Remaining", 41, 1 },
+					{ 254, "Unknown Event", 42, 0 },
+					{ 0, "Clear", 42, 1 },
+					{ 1, "Program Started", 43, 0 },
+					{ 2, "Program In Progress", 43, 0 },
+					{ 3, "Program Completed", 43, 0 },
+					{ 4, "Replace Main Filter", 43, 0 },
+					{ 5, "Failure To Set Temperature", 43, 0 },
+					{ 6, "Supplying Water", 43, 0 },
+					{ 7, "Water Supply Failure", 43, 0 },
+					{ 8, "Boiling", 43, 0 },
+					{ 9, "Boiling Failure", 43, 0 },
+					{ 10, "Washing", 43, 0 },
+					{ 11, "Washing Failure", 43, 0 },
+					{ 12, "Rinsing", 43, 0 },
+					{ 13, "Rinsing Failure", 43, 0 },
+					{ 14, "Draining", 43, 0 },
+					{ 15, "Draining Failure", 43, 0 },
+					{ 16, "Spinning", 43, 0 },
+					{ 17, "Spinning Failure", 43, 0 },
+					{ 18, "Drying", 43, 0 },
+					{ 19, "Drying Failure", 43, 0 },
+					{ 20, "Fan Failure", 43, 0 },
+					{ 21, "Compressor Failure", 43, 0 },
+					{ 254, "Unknown Event", 43, 0 },
+					{ 0, "Clear", 43, 1 },
+					{ 1, "Leaving Bed", 44, 0 },
+					{ 2, "Sitting On Bed", 44, 0 },
+					{ 3, "Lying On Bed", 44, 0 },
+					{ 4, "Posture Changed", 44, 0 },
+					{ 5, "Sitting On Edge Of Bed", 44, 0 },
+					{ 6, "Volatile Organic Compound Level", 44, 1 },
+					{ 7, "Sleep apnea detected", 45, 1 },
+					{ 8, "Sleep stage 0 detected (Dreaming/REM)", 46, 0 },
+					{ 9, "Sleep stage 1 detected (Light sleep, non-REM 1)", 46, 0 },
+					{ 10, "Sleep stage 2 detected (Medium sleep, non-REM 2)", 46, 0 },
+					{ 11, "Sleep stage 3 detected (Deep sleep, non-REM 3)", 46, 0 },
+					{ 254, "Unknown Event", 46, 0 },
+					{ 0, "Clear", 46, 1 },
+					{ 1, "Active", 47, 0 },
+					{ 254, "Unknown Event", 47, 0 },
+					{ 0, "Clear", 47, 1 },
+					{ 1, "Valve Operation", 48, 1 },
+					{ 2, "Master Valve Operation", 49, 1 },
+					{ 3, "Valve Short Circuit", 50, 0 },
+					{ 4, "Master Valve Short Circuit", 50, 0 },
+					{ 5, "Valve Current Alarm", 50, 1 },
+					{ 6, "Master Valve Current Alarm", 51, 1 },
+					{ 254, "Unknown Event", 52, 0 },
+					{ 0, "Clear", 52, 1 },
+					{ 1, "Rain Detected", 53, 0 },
+					{ 2, "Moisture Detected", 53, 0 },
+					{ 3, "Freeze", 53, 0 },
+					{ 254, "Unknown Event", 53, 0 },
+					{ 0, "Clear", 53, 1 },
+					{ 1, "Schedule Started", 54, 1 },
+					{ 2, "Schedule Finished", 55, 1 },
+					{ 3, "Valve Table Run Started", 56, 1 },
+					{ 4, "Valve Table Run Finished", 57, 1 },
+					{ 5, "Device Not Configured", 58, 0 },
+					{ 254, "Unknown Event", 58, 0 },
+					{ 0, "Clear", 58, 1 },
+					{ 1, "Combustable Gas Detected at Location", 59, 1 },
+					{ 2, "Combustable Gas Detected at Unknown Location", 60, 0 },
+					{ 3, "Toxic Gas Detected at Location", 60, 1 },
+					{ 4, "Toxic Gas Detected Unknown Location", 61, 0 },
+					{ 5, "Alarm Test", 61, 0 },
+					{ 6, "Replacement Required", 61, 0 },
+					{ 254, "Unknown Event", 61, 0 },
+					{ 0, "Clear", 61, 1 },
+					{ 1, "Trap armed at Location", 62, 1 },
+					{ 2, "Trap armed", 63, 0 },
+					{ 3, "Trap re-arm required at Location", 63, 1 },
+					{ 4, "Trap re-arm required", 64, 0 },
+					{ 5, "Pest detected at Location", 64, 1 },
+					{ 6, "Pest detected", 65, 0 },
+					{ 7, "Pest exterminated at Location", 65, 1 },
+					{ 8, "Pest exterminated", 66, 0 },
+					{ 254, "Unknown Event", 66, 0 },
+					{ 0, "Clear", 66, 1 },
+					{ 1, "Light detected", 67, 0 },
+					{ 2, "Light color transition detected", 67, 0 },
+					{ 254, "Unknown Event", 67, 0 },
+					{ 0, "Clear", 67, 1 },
+					{ 1, "Chlorine", 68, 1 },
+					{ 2, "Acidity (pH)", 69, 1 },
+					{ 3, "Water Oxidation", 70, 1 },
+					{ 4, "Chlorine empty", 71, 0 },
+					{ 5, "Acidity (pH) empty", 71, 0 },
+					{ 6, "Waterflow measuring station shortage detected", 71, 0 },
+					{ 7, "Waterflow clear water shortage detected", 71, 0 },
+					{ 8, "Disinfection system error detected", 71, 1 },
+					{ 9, "Filter cleaning ongoing", 72, 1 },
+					{ 10, "Heating operation ongoing", 73, 0 },
+					{ 11, "Filter pump operation ongoing", 73, 0 },
+					{ 12, "Freshwater operation ongoing", 73, 0 },
+					{ 13, "Dry protection operation active", 73, 0 },
+					{ 14, "Water tank is empty", 73, 0 },
+					{ 15, "Water tank level is unknown", 73, 0 },
+					{ 16, "Water tank is full", 73, 0 },
+					{ 17, "Collective disorder", 73, 0 },
+					{ 254, "Unknown Event", 73, 0 },
+					{ 0, "Clear", 73, 1 },
+					{ 1, "Home occupied at Location", 74, 1 },
+					{ 2, "Home occupied", 75, 0 },
+					{ 254, "Unknown Event", 75, 0 },
+				};
+
+				constexpr NotificationEventParam c_notificationEventParams[] =
+				{
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 0, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 0, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 0, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 0, 0 },
+					{ 258, "Result", NotificationCCTypes::NEPT_List, 0, 2 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 2, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 2, 0 },
+					{ 258, "Result", NotificationCCTypes::NEPT_List, 2, 2 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 4, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 4, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 4, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 4, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 4, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 4, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 4, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 4, 0 },
+					{ 259, "Threshold", NotificationCCTypes::NEPT_List, 4, 4 },
+					{ 259, "Type", NotificationCCTypes::NEPT_List, 8, 4 },
+					{ 259, "Type", NotificationCCTypes::NEPT_List, 12, 3 },
+					{ 259, "Type", NotificationCCTypes::NEPT_List, 15, 3 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 18, 0 },
+					{ 260, "User Code", NotificationCCTypes::NEPT_UserCodeReport, 18, 0 },
+					{ 260, "User Code", NotificationCCTypes::NEPT_UserCodeReport, 18, 0 },
+					{ 260, "UserCode", NotificationCCTypes::NEPT_UserCodeReport, 18, 0 },
+					{ 262, "Progress", NotificationCCTypes::NEPT_List, 18, 2 },
+					{ 1, "Time Limit", NotificationCCTypes::NEPT_Byte, 20, 0 },
+					{ 263, "Mode", NotificationCCTypes::NEPT_List, 20, 2 },
+					{ 264, "Obstruction", NotificationCCTypes::NEPT_List, 22, 2 },
+					{ 265, "Sensor ID", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 265, "Sensor ID", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 24, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 24, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 24, 0 },
+					{ 272, "RSSI Level", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 266, "Error Code", NotificationCCTypes::NEPT_String, 24, 0 },
+					{ 266, "Error Code", NotificationCCTypes::NEPT_String, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 267, "Duration", NotificationCCTypes::NEPT_Time, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 24, 0 },
+					{ 268, "Pollution Level", NotificationCCTypes::NEPT_List, 24, 4 },
+					{ 268, "breath level", NotificationCCTypes::NEPT_List, 28, 2 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 30, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 30, 0 },
+					{ 269, "Status", NotificationCCTypes::NEPT_List, 30, 2 },
+					{ 269, "Status", NotificationCCTypes::NEPT_List, 32, 2 },
+					{ 259, "Type", NotificationCCTypes::NEPT_List, 34, 4 },
+					{ 259, "Type", NotificationCCTypes::NEPT_List, 38, 4 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 270, "Schedule ID", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 270, "Schedule ID", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 271, "Valve Table ID", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 271, "Valve Table ID", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 42, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 42, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 42, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 42, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 42, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 42, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 42, 0 },
+					{ 259, "Threshold", NotificationCCTypes::NEPT_List, 42, 2 },
+					{ 259, "Threshold", NotificationCCTypes::NEPT_List, 44, 4 },
+					{ 259, "Type", NotificationCCTypes::NEPT_List, 48, 2 },
+					{ 1, "Error", NotificationCCTypes::NEPT_Byte, 50, 0 },
+					{ 1, "Progress", NotificationCCTypes::NEPT_Byte, 50, 0 },
+					{ 256, "Previous Event Cleared", NotificationCCTypes::NEPT_Byte, 50, 0 },
+					{ 257, "Alert Location", NotificationCCTypes::NEPT_Location, 50, 0 },
+				};
+
+				constexpr NotificationListItem c_notificationListItems[] =
+				{
+					{ 1, "Passed" },
+					{ 2, "Failed" },
+					{ 1, "Passed" },
+					{ 2, "Failed" },
+					{ 1, "No Data" },
+					{ 2, "Below Low Threshold" },
+					{ 3, "Above High Threshold" },
+					{ 4, "Max" },
+					{ 1, "No Data" },
+					{ 2, "Below Low Threshold" },
+					{ 3, "Above High Threshold" },
+					{ 4, "Max" },
+					{ 1, "No Data" },
+					{ 2, "Below Low Threshold" },
+					{ 3, "Above High Threshold" },
+					{ 1, "No Data" },
+					{ 2, "Below Low Threshold" },
+					{ 3, "Above High Threshold" },
+					{ 0, "Process Complete" },
+					{ 255, "Performing Process" },
+					{ 0, "Disabled" },
+					{ 255, "Enabled" },
+					{ 0, "No Obstruction" },
+					{ 255, "Obstruction" },
+					{ 1, "Clean" },
+					{ 2, "Slightly Polluted" },
+					{ 3, "Moderately Polluted" },
+					{ 4, "Highly Polluted" },
+					{ 1, "Low Breath" },
+					{ 2, "No Breath" },
+					{ 0, "Off" },
+					{ 1, "On" },
+					{ 0, "Off" },
+					{ 1, "On" },
+					{ 1, "No Data" },
+					{ 2, "Below Low Threshold" },
+					{ 3, "Above High Threshold" },
+					{ 4, "Max" },
+					{ 1, "No Data" },
+					{ 2, "Below Low Threshold" },
+					{ 3, "Above High Threshold" },
+					{ 4, "Max" },
+					{ 1, "Below Low Threshold" },
+					{ 2, "Above High Threshold" },
+					{ 1, "Below Low Threshold" },
+					{ 2, "Above High Threshold" },
+					{ 3, "Decreasing pH" },
+					{ 4, "Increasing pH" },
+					{ 1, "Below Low Threshold" },
+					{ 2, "Above High Threshold" },
+				};
+
+				// SensorMultiLevelCCTypes.xml
+				constexpr uint32 c_sensorRevision = 4;
+
+				constexpr SensorType c_sensorTypes[] =
+				{
+					{ 1, "Air Temperature", 0, 2 },
+					{ 2, "General Purpose", 2, 2 },
+					{ 3, "Illuminance", 4, 2 },
+					{ 4, "Power", 6, 2 },
+					{ 5, "Humidity", 8, 2 },
+					{ 6, "Velocity", 10, 2 },
+					{ 7, "Direction", 12, 1 },
+					{ 8, "Atmospheric Pressure", 13, 2 },
+					{ 9, "Barometic Pressure", 15, 2 },
+					{ 10, "Solar Radiation", 17, 1 },
+					{ 11, "Dew Point", 18, 2 },
+					{ 12, "Rain Rate", 20, 2 },
+					{ 13, "Tide Level", 22, 2 },
+					{ 14, "Weight", 24, 2 },
+					{ 15, "Voltage", 26, 2 },
+					{ 16, "Current", 28, 2 },
+					{ 17, "Carbon Dioxide", 30, 1 },
+					{ 18, "Air Flow", 31, 2 },
+					{ 19, "Tank Capacity", 33, 3 },
+					{ 20, "Distance", 36, 3 },
+					{ 21, "Angle Position", 39, 3 },
+					{ 22, "Rotation", 42, 2 },
+					{ 23, "Water Temperature", 44, 2 },
+					{ 24, "Soil Temperature", 46, 2 },
+					{ 25, "Seismic Intensity", 48, 4 },
+					{ 26, "Seismic Magnitude", 52, 4 },
+					{ 27, "Ultraviolet", 56, 1 },
+					{ 28, "Electrical Resistivity", 57, 1 },
+					{ 29, "Electrical Conductivity", 58, 1 },
+					{ 30, "Loudness", 59, 2 },
+					{ 31, "Moisture", 61, 4 },
+					{ 32, "Frequency", 65, 2 },
+					{ 33, "Time", 67, 1 },
+					{ 34, "Target Temperature", 68, 2 },
+					{ 35, "Particulate Matter 2.5", 70, 2 },
+					{ 36, "Formaldehyde CH20 Level", 72, 1 },
+					{ 37, "Radon Concentration", 73, 2 },
+					{ 38, "Methane Density", 75, 1 },
+					{ 39, "Volatile Organic Compound", 76, 2 },
+					{ 40, "Carbon Monoxide", 78, 2 },
+					{ 41, "Soil Humidity", 80, 1 },
+					{ 42, "Soil Reactivity", 81, 1 },
+					{ 43, "Soil Salinity", 82, 1 },
+					{ 44, "Heart Rate", 83, 1 },
+					{ 45, "Blood Pressure", 84, 2 },
+					{ 46, "Muscle Mass", 86, 1 },
+					{ 47, "Fat Mass", 87, 1 },
+					{ 48, "Bone Mass", 88, 1 },
+					{ 49, "Total Body Water", 89, 1 },
+					{ 50, "Basic Metabolic Rate", 90, 1 },
+					{ 51, "Body Mass Index", 91, 1 },
+					{ 52, "X-Axis Acceleration", 92, 1 },
+					{ 53, "Y-Axis Acceleration", 93, 1 },
+					{ 54, "Z-Axis Acceleration", 94, 1 },
+					{ 55, "Smoke Density", 95, 1 },
+					{ 56, "Water Flow", 96, 1 },
+					{ 57, "Water Pressure", 97, 1 },
+					{ 58, "RF Signal Strength", 98, 2 },
+					{ 59, "Particulate Matter", 100, 2 },
+					{ 60, "Respiratory Rate", 102, 1 },
+					{ 61, "Relative Modulation", 103, 1 },
+					{ 62, "Boiler Water Temperature", 104, 2 },
+					{ 63, "Domestic Hot Water Temperature", 106, 2 },
+					{ 64, "Outside Temperature", 108, 2 },
+					{ 65, "Exhaust Temperature", 110, 2 },
+					{ 66, "Water Chlorine", 112, 1 },
+					{ 67, "Water Acidity", 113, 1 },
+					{ 68, "Water Oxidation Reduction Potential", 114, 1 },
+					{ 69, "Heart Rate LF/HF Ratio", 115, 1 },
+					{ 70, "Motion Direction", 116, 1 },
+					{ 71, "Applied Force", 117, 1 },
+					{ 72, "Return Air Temperature", 118, 2 },
+					{ 73, "Supply Air Temperature", 120, 2 },
+					{ 74, "Condenser Coil Temperature", 122, 2 },
+					{ 75, "Evaporator Coil Temperature", 124, 2 },
+					{ 76, "Liquid Line Temperature", 126, 2 },
+					{ 77, "Discharge Line Temperature", 128, 2 },
+					{ 78, "Suction", 130, 2 },
+					{ 79, "Discharge", 132, 2 },
+					{ 80, "Defrost Temperature", 134, 2 },
+					{ 81, "Ozone", 136, 1 },
+					{ 82, "Sulfur Dioxide", 137, 1 },
+					{ 83, "Nitrogen Dioxide", 138, 1 },
+					{ 84, "Ammonia", 139, 1 },
+					{ 85, "Lead", 140, 1 },
+					{ 86, "Particulate Matter", 141, 1 },
+				};
+
+				constexpr SensorScale c_sensorScales[] =
+				{
+					{ 0, "Celsius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Percent", "%" },
+					{ 1, "Dimensionless", "" },
+					{ 0, "Percent", "%" },
+					{ 1, "Lux", "Lux" },
+					{ 0, "Watt", "W" },
+					{ 1, "Btu/h", "Btu/h" },
+					{ 0, "Percent", "%" },
+					{ 1, "Absolute Humidity", "g/m3" },
+					{ 0, "Meter Per Second", "m/s" },
+					{ 1, "Miles Per Hour", "Mph" },
+					{ 0, "degrees", "\302\260" },
+					{ 0, "kilopascal", "kPa" },
+					{ 1, "Inches of Mercury", "inHg" },
+					{ 0, "kilopascal", "kPa" },
+					{ 1, "Inches of Mercury", "inHg" },
+					{ 0, "Watt Per Square Meter", "W/m2" },
+					{ 0, "Celsius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Millimeter Per Hour", "mm/h" },
+					{ 1, "Inches Per Hour", "in/h" },
+					{ 0, "Meter", "m" },
+					{ 1, "Feet", "ft" },
+					{ 0, "Kilograms", "Kg" },
+					{ 1, "Pounds", "lb" },
+					{ 0, "Volts", "V" },
+					{ 1, "MilliVolts", "mV" },
+					{ 0, "Amps", "A" },
+					{ 1, "MilliAmps", "mA" },
+					{ 0, "Parts Per Million", "Ppm" },
+					{ 0, "Cubic Meter Per Hour", "M3/h" },
+					{ 1, "Cubic Feed Per Minute", "cfm" },
+					{ 0, "Liter", "l" },
+					{ 1, "Cubic Meter", "M3" },
+					{ 2, "Gallons", "gal" },
+					{ 0, "Meter", "m" },
+					{ 1, "CentiMeter", "cm" },
+					{ 2, "Feet", "ft" },
+					{ 0, "Percent", "%" },
+					{ 1, "Degress Relative to North Poll", "" },
+					{ 2, "Degress Relative to South Poll", "" },
+					{ 0, "Revolutions Per Minute", "rpm" },
+					{ 1, "Hertz", "Hz" },
+					{ 0, "Celsius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celsius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Mercalli", "MM" },
+					{ 1, "European Macroseismic", "EMS" },
+					{ 2, "Liedu", "Liedu" },
+					{ 3, "Shindo", "Shindo" },
+					{ 0, "Local", "Ml" },
+					{ 1, "Moment", "Mw" },
+					{ 2, "Surface Wave", "Ms" },
+					{ 3, "Body Wave", "Mb" },
+					{ 0, "UV Index", "UV" },
+					{ 0, "Ohm Meter", "\316\251m" },
+					{ 0, "Siemens Per Meter", "S\342\213\205m-1" },
+					{ 0, "Absolute Loudness", "dB" },
+					{ 1, "A-Weighted Decibels", "dBA" },
+					{ 0, "Percent", "%" },
+					{ 1, "Volume Water Content", "M3/m3" },
+					{ 2, "Impedance", "k\316\251" },
+					{ 3, "Water Activity", "aw" },
+					{ 0, "Hertz", "Hz" },
+					{ 1, "KiloHertz", "kHz" },
+					{ 0, "Seconds", "s" },
+					{ 0, "Celsius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Mole Per Cubic Meter", "mol/m3" },
+					{ 1, "Microgram Per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Mole Per Cubic Meter", "mol/m3" },
+					{ 0, "Becquerel per Cubic Meter", "bq/m3" },
+					{ 1, "Picocuries per Liter", "pCi/L" },
+					{ 0, "Mole per Cubic Meter", "mol/m3" },
+					{ 0, "Mole per Cubic Meter", "mol/m3" },
+					{ 1, "Parts per Million", "Ppm" },
+					{ 0, "Mole per Cubic Meter", "mol/m3" },
+					{ 1, "Pars per Million", "Ppm" },
+					{ 0, "Percent", "%" },
+					{ 0, "Acidity", "pH" },
+					{ 0, "Mole per Cubic Meter", "mol/m3" },
+					{ 0, "Beats per Minute", "Bpm" },
+					{ 0, "Systolic mmHg", "mmHg" },
+					{ 1, "Diastolic mmHg", "mmHg" },
+					{ 0, "Kilogram", "Kg" },
+					{ 0, "Kilogram", "Kg" },
+					{ 0, "Kilogram", "Kg" },
+					{ 0, "Kilogram", "Kg" },
+					{ 0, "Joule", "J" },
+					{ 0, "BMI", "BMI" },
+					{ 0, "Meter per Second Squared", "m/s2" },
+					{ 0, "Meter per Second Squared", "m/s2" },
+					{ 0, "Meter per Second Squared", "m/s2" },
+					{ 0, "Percent", "%" },
+					{ 0, "Liter per Hour", "l/h" },
+					{ 0, "Kilopascal", "kPa" },
+					{ 0, "RSSI", "RSSI" },
+					{ 1, "dBm", "dBm" },
+					{ 0, "Mole per Cubic Meter", "mol/m3" },
+					{ 1, "Microgram per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Breaths per Minute", "Bpm" },
+					{ 0, "Percent", "%" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Milligram per Liter", "mg/l" },
+					{ 0, "Acidity", "pH" },
+					{ 0, "MilliVolt", "mV" },
+					{ 0, "Unitless", "" },
+					{ 0, "Direction", "degrees" },
+					{ 0, "Newton", "N" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "kilopascal", "kPa" },
+					{ 1, "Pound per square inch", "psi" },
+					{ 0, "kilopascal", "kPa" },
+					{ 1, "Pound per square inch", "psi" },
+					{ 0, "Celcius", "C" },
+					{ 1, "Fahrenheit", "F" },
+					{ 0, "Microgram per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Microgram per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Microgram per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Microgram per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Microgram per Cubic Meter", "\316\274g/m3" },
+					{ 0, "Microgram per Cubic Meter", "\316\274g/m3" },
+				};
+			}
+		} // namespace ConfigTables
+	} // namespace Internal
+} // namespace OpenZWave
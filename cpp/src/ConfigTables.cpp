@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigTables.cpp
+//
+//	Sorted tables of the device class, notification and sensor type data
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+
+#include "ConfigTables.h"
+#include "NotificationCCTypes.h"
+#include "Options.h"
+#include "XmlReader.h"
+#include "platform/Log.h"
+
+#include "ConfigTableData.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace ConfigTables
+		{
+			namespace
+			{
+				template<typename T, size_t N> constexpr Table<T> MakeTable(T const (&_array)[N])
+				{
+					return Table<T>(_array, N);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <ConfigTables::GetBuiltinDeviceClasses>
+// The device classes compiled into the library
+//-----------------------------------------------------------------------------
+			DeviceClassData const& GetBuiltinDeviceClasses()
+			{
+				static DeviceClassData const data =
+				{ MakeTable(c_basicDeviceClasses), MakeTable(c_genericDeviceClasses), MakeTable(c_specificDeviceClasses), MakeTable(c_roleDeviceClasses), MakeTable(c_deviceTypeClasses), MakeTable(c_nodeTypes) };
+				return data;
+			}
+
+//-----------------------------------------------------------------------------
+// <ConfigTables::GetBuiltinNotificationTypes>
+// The notification types compiled into the library
+//-----------------------------------------------------------------------------
+			NotificationData const& GetBuiltinNotificationTypes()
+			{
+				static NotificationData const data =
+				{ c_notificationRevision, MakeTable(c_notificationTypes), MakeTable(c_notificationEvents), MakeTable(c_notificationEventParams), MakeTable(c_notificationListItems) };
+				return data;
+			}
+
+//-----------------------------------------------------------------------------
+// <ConfigTables::GetBuiltinSensorTypes>
+// The multilevel sensor types compiled into the library
+//-----------------------------------------------------------------------------
+			SensorData const& GetBuiltinSensorTypes()
+			{
+				static SensorData const data =
+				{ c_sensorRevision, MakeTable(c_sensorTypes), MakeTable(c_sensorScales) };
+				return data;
+			}
+
+//-----------------------------------------------------------------------------
+// <ConfigTables::Trim>
+// Remove white space from both ends, keeping the bytes of UTF-8 characters
+// that isgraph() rejects
+//-----------------------------------------------------------------------------
+			string& Trim(string& _str)
+			{
+				auto visible = [](unsigned char c)
+				{	return isgraph(c) || c >= 0x80;};
+				_str.erase(std::find_if(_str.rbegin(), _str.rend(), visible).base(), _str.end());
+				_str.erase(_str.begin(), std::find_if(_str.begin(), _str.end(), visible));
+				return _str;
+			}
+
+//-----------------------------------------------------------------------------
+// <ConfigTables::CheckRevision>
+// Warn when a file in the config path does not match the compiled table
+//-----------------------------------------------------------------------------
+			void CheckRevision(string const& _filename, char const* _rootName, uint32 const _builtinRevision)
+			{
+				string configPath;
+				Options::Get()->GetOptionAsString("ConfigPath", &configPath);
+				string path = configPath + _filename;
+
+				XmlReader reader;
+				if (!reader.Open(path) || !reader.NextChild(0) || reader.GetName() != _rootName)
+				{
+					return;
+				}
+				int32 revision;
+				if (!reader.GetAttribute("Revision", &revision))
+				{
+					return;
+				}
+				if ((uint32) revision != _builtinRevision)
+				{
+					Log::Write(LogLevel_Warning, "%s has Revision %d, but the built in table with Revision %d is used.  Set the XMLConfigTables option to use the file", path.c_str(), revision, _builtinRevision);
+				}
+			}
+		} // namespace ConfigTables
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,301 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigTables.h
+//
+//	Sorted tables of the device class, notification and sensor type data
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ConfigTables_H
+#define _ConfigTables_H
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief The data of device_classes.xml, NotificationCCTypes.xml and
+		 * SensorMultiLevelCCTypes.xml as arrays sorted by id.
+		 * \ingroup Main
+		 *
+		 * The library carries a copy of each file compiled into constant arrays by
+		 * cpp/build/configtables.pl, so nothing is parsed or allocated to use them.
+		 * When the XMLConfigTables option is set the files are read from the config
+		 * path instead, into a Store that holds entries of the same layout.
+		 *
+		 * Entries that belong to another entry, like the events of a notification
+		 * type, are a run of consecutive entries in their own array, which the
+		 * parent refers to by the index of the first one and a count.
+		 */
+		namespace ConfigTables
+		{
+			struct BasicDeviceClass
+			{
+					uint16 m_id;
+					char const* m_label;
+			};
+
+			struct DeviceClass
+			{
+					uint16 m_id;
+					char const* m_label;
+					char const* m_commandClasses;				// Zero terminated list of mandatory command classes, or NULL
+					uint8 m_basicMapping;						// Command class that COMMAND_CLASS_BASIC maps on to, or zero
+					uint16 m_firstSpecific;						// Specific device classes of a generic device class
+					uint16 m_specificCount;
+
+					uint8 const* GetMandatoryCommandClasses() const
+					{
+						return (uint8 const*) m_commandClasses;
+					}
+			};
+
+			struct NotificationType
+			{
+					uint16 m_id;
+					char const* m_name;
+					uint16 m_firstEvent;
+					uint16 m_eventCount;
+			};
+
+			struct NotificationEvent
+			{
+					uint16 m_id;
+					char const* m_name;
+					uint16 m_firstParam;
+					uint16 m_paramCount;
+			};
+
+			struct NotificationEventParam
+			{
+					uint16 m_id;
+					char const* m_name;
+					uint8 m_type;								// NotificationCCTypes::NotificationEventParamTypes
+					uint16 m_firstItem;							// Items of a list parameter
+					uint16 m_itemCount;
+			};
+
+			struct NotificationListItem
+			{
+					uint16 m_id;
+					char const* m_label;
+			};
+
+			struct SensorType
+			{
+					uint16 m_id;
+					char const* m_name;
+					uint16 m_firstScale;
+					uint16 m_scaleCount;
+			};
+
+			struct SensorScale
+			{
+					uint16 m_id;
+					char const* m_name;
+					char const* m_unit;
+			};
+
+			/** \brief A run of entries sorted by id.
+			 */
+			template<typename T> class Table
+			{
+				public:
+					constexpr Table() :
+							m_begin(NULL), m_end(NULL)
+					{
+					}
+					constexpr Table(T const* _begin, uint32 const _count) :
+							m_begin(_begin), m_end(_begin + _count)
+					{
+					}
+					Table(vector<T> const& _entries) :
+							m_begin(_entries.empty() ? NULL : &_entries[0]), m_end(m_begin + _entries.size())
+					{
+					}
+
+					T const* begin() const
+					{
+						return m_begin;
+					}
+					T const* end() const
+					{
+						return m_end;
+					}
+					uint32 size() const
+					{
+						return (uint32) (m_end - m_begin);
+					}
+
+					/**
+					 * Binary search for an entry.
+					 * \return the entry with this id, or NULL if there is none.
+					 */
+					T const* Find(uint32 const _id) const
+					{
+						T const* first = m_begin;
+						T const* last = m_end;
+						while (first < last)
+						{
+							T const* middle = first + (last - first) / 2;
+							if (middle->m_id < _id)
+							{
+								first = middle + 1;
+							}
+							else if (_id < middle->m_id)
+							{
+								last = middle;
+							}
+							else
+							{
+								return middle;
+							}
+						}
+						return NULL;
+					}
+
+					/**
+					 * The entries that belong to a parent entry.
+					 */
+					Table Slice(uint32 const _first, uint32 const _count) const
+					{
+						if (_first + _count > size())
+						{
+							return Table();
+						}
+						return Table(m_begin + _first, _count);
+					}
+
+				private:
+					T const* m_begin;
+					T const* m_end;
+			};
+
+			struct DeviceClassData
+			{
+					Table<BasicDeviceClass> m_basic;
+					Table<DeviceClass> m_generic;
+					Table<DeviceClass> m_specific;
+					Table<DeviceClass> m_roles;
+					Table<DeviceClass> m_deviceTypes;
+					Table<DeviceClass> m_nodeTypes;
+
+					DeviceClass const* FindSpecific(DeviceClass const* _generic, uint8 const _specific) const
+					{
+						return m_specific.Slice(_generic->m_firstSpecific, _generic->m_specificCount).Find(_specific);
+					}
+			};
+
+			struct NotificationData
+			{
+					uint32 m_revision;
+					Table<NotificationType> m_types;
+					Table<NotificationEvent> m_events;
+					Table<NotificationEventParam> m_params;
+					Table<NotificationListItem> m_items;
+			};
+
+			struct SensorData
+			{
+					uint32 m_revision;
+					Table<SensorType> m_types;
+					Table<SensorScale> m_scales;
+			};
+
+			/**
+			 * The tables compiled into the library.
+			 */
+			DeviceClassData const& GetBuiltinDeviceClasses();
+			NotificationData const& GetBuiltinNotificationTypes();
+			SensorData const& GetBuiltinSensorTypes();
+
+			/**
+			 * Remove the white space around a name or unit read from one of the files.
+			 * Unlike Internal::trim, this keeps UTF-8 characters such as the degree
+			 * sign of a unit, as configtables.pl does for the compiled tables.
+			 */
+			string& Trim(string& _str);
+
+			/**
+			 * Log a warning if a file in the config path has a different Revision
+			 * from the table compiled into the library, which is then used instead
+			 * of the newer or older file.  Only the root element is read.
+			 */
+			void CheckRevision(string const& _filename, char const* _rootName, uint32 const _builtinRevision);
+
+			/** \brief Holds the entries and strings of tables read from XML at runtime.
+			 *
+			 * The entries of each array must be added in the order of their ids.
+			 */
+			class Store
+			{
+				public:
+					/**
+					 * Keep a copy of a string for as long as the store exists.
+					 */
+					char const* AddString(string const& _str)
+					{
+						m_strings.push_back(_str);
+						return m_strings.back().c_str();
+					}
+
+					void Clear()
+					{
+						m_basic.clear();
+						m_generic.clear();
+						m_specific.clear();
+						m_roles.clear();
+						m_deviceTypes.clear();
+						m_nodeTypes.clear();
+						m_notificationTypes.clear();
+						m_notificationEvents.clear();
+						m_notificationParams.clear();
+						m_notificationItems.clear();
+						m_sensorTypes.clear();
+						m_sensorScales.clear();
+						m_strings.clear();
+					}
+
+					vector<BasicDeviceClass> m_basic;
+					vector<DeviceClass> m_generic;
+					vector<DeviceClass> m_specific;
+					vector<DeviceClass> m_roles;
+					vector<DeviceClass> m_deviceTypes;
+					vector<DeviceClass> m_nodeTypes;
+					vector<NotificationType> m_notificationTypes;
+					vector<NotificationEvent> m_notificationEvents;
+					vector<NotificationEventParam> m_notificationParams;
+					vector<NotificationListItem> m_notificationItems;
+					vector<SensorType> m_sensorTypes;
+					vector<SensorScale> m_sensorScales;
+
+				private:
+					list<string> m_strings;
+			};
+		} // namespace ConfigTables
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_ConfigTables_H
@@ -37,10 +37,13 @@
 #include "TimerThread.h"
 #include "Http.h"
 #include "ManufacturerSpecificDB.h"
+#include "BinaryCache.h"
 
 #include "platform/Event.h"
+#include "platform/FileOps.h"
 #include "platform/Mutex.h"
 #include "platform/SerialController.h"
+#include "platform/VirtualController.h"
 #ifdef USE_HID
 #ifdef WINRT
 #include "platform/winRT/HidControllerWinRT.h"
@@ -54,16 +57,26 @@
 
 #include "command_classes/CommandClasses.h"
 #include "command_classes/ApplicationStatus.h"
+#include "command_classes/Basic.h"
 #include "command_classes/ControllerReplication.h"
 #include "command_classes/Security.h"
 #include "command_classes/WakeUp.h"
 #include "command_classes/SwitchAll.h"
+#include "command_classes/SwitchBinary.h"
+#include "command_classes/SwitchMultilevel.h"
+#include "command_classes/SwitchToggleBinary.h"
+#include "command_classes/SwitchToggleMultilevel.h"
+#include "command_classes/DoorLock.h"
+#include "command_classes/Lock.h"
+#include "command_classes/ThermostatMode.h"
+#include "command_classes/ThermostatFanMode.h"
 #include "command_classes/ManufacturerSpecific.h"
 #include "command_classes/NoOperation.h"
 
 #include "value_classes/ValueID.h"
 #include "value_classes/Value.h"
 #include "value_classes/ValueStore.h"
+#include "value_classes/ValueSnapshotTable.h"
 
 #include "tinyxml.h"
 
@@ -110,16 +123,49 @@ static char const* c_controllerCommandNames[] =
 static char const* c_sendQueueNames[] =
 { "Command", "NoOp", "Controller", "WakeUp", "Send", "Query", "Poll" };
 
+// How long the queries of a node the application has sent something to go ahead of the others
+static uint32 const c_queryBoostTime = 30000;
+
+//-----------------------------------------------------------------------------
+// <GetQueryStagePriority>
+// Order in which the query scheduler serves the stages, lower first.  The
+// stages that make a node usable come before the slow ones that only fill in
+// detail, and a node loaded from the cache needs little more than CacheLoad,
+// Session and Dynamic.
+//-----------------------------------------------------------------------------
+static uint8 GetQueryStagePriority(Node::QueryStage const _stage)
+{
+	switch (_stage)
+	{
+		case Node::QueryStage_Versions:
+		case Node::QueryStage_Instances:
+		case Node::QueryStage_Static:
+		{
+			return 2;
+		}
+		case Node::QueryStage_Associations:
+		case Node::QueryStage_Neighbors:
+		case Node::QueryStage_Configuration:
+		{
+			return 3;
+		}
+		default:
+		{
+			return 1;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::Driver>
 // Constructor
 //-----------------------------------------------------------------------------
 Driver::Driver(string const& _controllerPath, ControllerInterface const& _interface) :
-		m_driverThread(new Internal::Platform::Thread("driver")), m_dns(new Internal::DNSThread(this)), m_dnsThread(new Internal::Platform::Thread("dns")), m_initMutex(new Internal::Platform::Mutex()), m_exit(false), m_init(false), m_awakeNodesQueried(false), m_allNodesQueried(false), m_notifytransactions(false), m_timer(new Internal::TimerThread(this)), m_timerThread(new Internal::Platform::Thread("timer")), m_controllerInterfaceType(_interface), m_controllerPath(_controllerPath), m_controller(
-				NULL), m_homeId(0), m_libraryVersion(""), m_libraryTypeName(""), m_libraryType(0), m_manufacturerId(0), m_productType(0), m_productId(0), m_initVersion(0), m_initCaps(0), m_controllerCaps(0), m_Controller_nodeId(0), m_nodeMutex(new Internal::Platform::Mutex()), m_controllerReplication( NULL), m_transmitOptions( TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE), m_waitingForAck(false), m_expectedCallbackId(0), m_expectedReply(0), m_expectedCommandClassId(
-				0), m_expectedNodeId(0), m_pollThread(new Internal::Platform::Thread("poll")), m_pollMutex(new Internal::Platform::Mutex()), m_pollInterval(0), m_bIntervalBetweenPolls(false),				// if set to true (via SetPollInterval), the pollInterval will be interspersed between each poll (so a much smaller m_pollInterval like 100, 500, or 1,000 may be appropriate)
-		m_currentControllerCommand( NULL), m_SUCNodeId(0), m_controllerResetEvent( NULL), m_sendMutex(new Internal::Platform::Mutex()), m_currentMsg( NULL), m_virtualNeighborsReceived(false), m_notificationsEvent(new Internal::Platform::Event()), m_SOFCnt(0), m_ACKWaiting(0), m_readAborts(0), m_badChecksum(0), m_readCnt(0), m_writeCnt(0), m_CANCnt(0), m_NAKCnt(0), m_ACKCnt(0), m_OOFCnt(0), m_dropped(0), m_retries(0), m_callbacks(0), m_badroutes(0), m_noack(0), m_netbusy(0), m_notidle(0), m_txverified(
-				0), m_nondelivery(0), m_routedbusy(0), m_broadcastReadCnt(0), m_broadcastWriteCnt(0), AuthKey(0), EncryptKey(0), m_nonceReportSent(0), m_nonceReportSentAttempt(0), m_queueMsgEvent(new Internal::Platform::Event()), m_eventMutex(new Internal::Platform::Mutex())
+		m_driverThread(new Internal::Platform::Thread("driver")), m_dns(new Internal::DNSThread(this)), m_dnsThread(new Internal::Platform::Thread("dns")), m_initMutex(new Internal::Platform::Mutex()), m_exit(false), m_init(false), m_awakeNodesQueried(false), m_allNodesQueried(false), m_notifytransactions(false), m_cacheThread(new Internal::Platform::Thread("cache")), m_cacheEvent(new Internal::Platform::Event()), m_cacheDirtyMutex(new Internal::Platform::Mutex()), m_cacheMutex(new Internal::Platform::Mutex()), m_cacheDue(0), m_timer(new Internal::TimerThread(this)), m_timerThread(new Internal::Platform::Thread("timer")), m_controllerInterfaceType(_interface), m_controllerPath(_controllerPath), m_controller(
+				NULL), m_homeId(0), m_libraryVersion(""), m_libraryTypeName(""), m_libraryType(0), m_manufacturerId(0), m_productType(0), m_productId(0), m_initVersion(0), m_initCaps(0), m_controllerCaps(0), m_Controller_nodeId(0), m_nodeMutex(new Internal::Platform::SharedMutex()), m_valueSnapshots(new Internal::VC::ValueSnapshotTable()), m_controllerReplication( NULL), m_transmitOptions( TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE), m_waitingForAck(false), m_expectedCallbackId(0), m_expectedReply(0), m_expectedCommandClassId(
+				0), m_expectedNodeId(0), m_pollThread(new Internal::Platform::Thread("poll")), m_pollGeneration(0), m_lastPollTime(0), m_pollMutex(new Internal::Platform::Mutex()), m_pollEvent(new Internal::Platform::Event()), m_sendQueuesIdleEvent(new Internal::Platform::Event()), m_pollInterval(0), m_pollIntervalMs(0), m_bIntervalBetweenPolls(false),				// if set to true (via SetPollInterval), the pollInterval will be interspersed between each poll (so a much smaller m_pollInterval like 100, 500, or 1,000 may be appropriate)
+		m_currentControllerCommand( NULL), m_SUCNodeId(0), m_controllerResetEvent( NULL), m_sendMutex(new Internal::Platform::Mutex()), m_currentMsg( NULL), m_maxOutstandingRequests(0), m_lastQueryNode(0), m_maxQueryNodes(0), m_queryActiveNodes(0), m_queryPendingNodes(0), m_multicastMutex(new Internal::Platform::Mutex()), m_multicastDepth(0), m_virtualNeighborsReceived(false), m_notificationsMutex(new Internal::Platform::Mutex()), m_notificationsEvent(new Internal::Platform::Event()), m_coalesceValueNotifications(false), m_SOFCnt(0), m_ACKWaiting(0), m_readAborts(0), m_badChecksum(0), m_readCnt(0), m_writeCnt(0), m_CANCnt(0), m_NAKCnt(0), m_ACKCnt(0), m_OOFCnt(0), m_dropped(0), m_retries(0), m_callbacks(0), m_badroutes(0), m_noack(0), m_netbusy(0), m_notidle(0), m_txverified(
+				0), m_nondelivery(0), m_routedbusy(0), m_broadcastReadCnt(0), m_broadcastWriteCnt(0), m_coalescedSets(0), m_coalescedGets(0), m_coalescedNotifications(0), m_msgStatsTime(Internal::Platform::TimeStamp::GetMonotonicTime()), m_msgStatsAllocations(0), m_nonceReportSent(0), m_nonceReportSentAttempt(0), m_queueMsgEvent(new Internal::Platform::Event()), m_eventMutex(new Internal::Platform::Mutex())
 {
 	// set a timestamp to indicate when this driver started
 	Internal::Platform::TimeStamp m_startTime;
@@ -133,12 +179,15 @@ Driver::Driver(string const& _controllerPath, ControllerInterface const& _interf
 	// Clear the nodes array
 	memset(m_nodes, 0, sizeof(Node*) * 256);
 
+	// Nothing has been saved to the cache yet
+	memset(m_cacheDirty, 0, sizeof(m_cacheDirty));
+
 	// Clear the virtual neighbors array
 	memset(m_virtualNeighbors, 0, NUM_NODE_BITFIELD_BYTES);
 
 	// Initialize the Network Keys
 
-	initNetworkKeys(false);
+	initNetworkKeys();
 
 #ifdef USE_HID
 	if( ControllerInterface_Hid == _interface )
@@ -147,14 +196,30 @@ Driver::Driver(string const& _controllerPath, ControllerInterface const& _interf
 	}
 	else
 #endif
+	if (ControllerInterface_Virtual == _interface)
+	{
+		m_controller = new Internal::Platform::VirtualController();
+	}
+	else
 	{
 		m_controller = new Internal::Platform::SerialController();
 	}
 	m_controller->SetSignalThreshold(1);
 
 	Options::Get()->GetOptionAsBool("NotifyTransactions", &m_notifytransactions);
-	Options::Get()->GetOptionAsInt("PollInterval", &m_pollInterval);
-	Options::Get()->GetOptionAsBool("IntervalBetweenPolls", &m_bIntervalBetweenPolls);
+	int32 pollInterval = 0;
+	bool intervalBetweenPolls = false;
+	Options::Get()->GetOptionAsInt("PollInterval", &pollInterval);
+	Options::Get()->GetOptionAsBool("IntervalBetweenPolls", &intervalBetweenPolls);
+	SetPollInterval(pollInterval, intervalBetweenPolls);
+	Options::Get()->GetOptionAsBool("CoalesceValueNotifications", &m_coalesceValueNotifications);
+	int32 maxOutstandingRequests = Options::Get()->GetValues().m_MaxOutstandingRequests;
+	m_maxOutstandingRequests = maxOutstandingRequests > 0 ? (uint32) maxOutstandingRequests : 0;
+	int32 maxQueryNodes = Options::Get()->GetValues().m_MaxQueryNodes;
+	m_maxQueryNodes = maxQueryNodes > 0 ? (uint32) maxQueryNodes : 0;
+	memset(m_queryPriority, 0, sizeof(m_queryPriority));
+	memset(m_queryBoostUntil, 0, sizeof(m_queryBoostUntil));
+	memset(m_queryWork, 0, sizeof(m_queryWork));
 
 	m_httpClient = new Internal::HttpClient(this);
 
@@ -176,9 +241,15 @@ Driver::~Driver()
 	notification->SetHomeAndNodeIds(m_homeId, 0);
 	QueueNotification(notification);
 	NotifyWatchers();
+	Manager::Get()->FlushNotifications();
 
 	// append final driver stats output to the log file
 	LogDriverStatistics();
+
+	// Stop the background cache writer, so the final save below is the last one
+	m_cacheThread->Stop();
+	m_cacheThread->Release();
+
 	// Save the driver config before deleting anything else
 	bool save;
 	if (Options::Get()->GetOptionAsBool("SaveConfiguration", &save))
@@ -186,6 +257,7 @@ Driver::~Driver()
 		if (save)
 		{
 			WriteCache();
+			SaveCache();
 			Internal::Scene::WriteXML("zwscene.xml");
 		}
 	}
@@ -220,6 +292,11 @@ Driver::~Driver()
 	{
 		RemoveCurrentMsg();
 	}
+	while (!m_outstandingRequests.empty())
+	{
+		delete m_outstandingRequests.front().m_msg;
+		m_outstandingRequests.pop_front();
+	}
 
 	// Clear the node data
 	{
@@ -238,8 +315,14 @@ Driver::~Driver()
 	}
 	// Don't release until all nodes have removed their poll values
 	m_pollMutex->Release();
+	m_pollEvent->Release();
+	m_sendQueuesIdleEvent->Release();
 
-	// Clear the send Queue
+	// Clear the send Queue, including the queries that were never released to it
+	for (int32 i = 0; i < 256; ++i)
+	{
+		ReleaseQueryItems(i);
+	}
 	for (int32 i = 0; i < MsgQueue_Count; ++i)
 	{
 		while (!m_msgQueue[i].empty())
@@ -272,6 +355,7 @@ Driver::~Driver()
 		if (notify)
 		{
 			NotifyWatchers();
+			Manager::Get()->FlushNotifications();
 		}
 	}
 
@@ -283,16 +367,27 @@ Driver::~Driver()
 		delete notification;
 		nit = m_notifications.begin();
 	}
+	m_pendingValueNotifications.clear();
 
 	if (m_controllerReplication)
 		delete m_controllerReplication;
 
+	m_cacheEvent->Release();
+	m_cacheDirtyMutex->Release();
+	m_cacheMutex->Release();
+
+	for (list<pair<Internal::Msg*, bool> >::iterator it = m_multicastMsgs.begin(); it != m_multicastMsgs.end(); ++it)
+	{
+		delete it->first;
+	}
+	m_multicastMutex->Release();
+
 	m_notificationsEvent->Release();
-	m_nodeMutex->Release();
+	m_notificationsMutex->Release();
+	delete m_nodeMutex;
+	delete m_valueSnapshots;
 	m_queueMsgEvent->Release();
 	m_eventMutex->Release();
-	delete this->AuthKey;
-	delete this->EncryptKey;
 	delete this->m_httpClient;
 	delete this->m_timer;
 	delete this->m_dns;
@@ -310,6 +405,7 @@ void Driver::Start()
 	m_driverThread->Start(Driver::DriverThreadEntryPoint, this);
 	m_dnsThread->Start(Internal::DNSThread::DNSThreadEntryPoint, m_dns);
 	m_timerThread->Start(Internal::TimerThread::TimerThreadEntryPoint, m_timer);
+	m_cacheThread->Start(Driver::CacheThreadEntryPoint, this);
 }
 
 //-----------------------------------------------------------------------------
@@ -354,13 +450,23 @@ void Driver::DriverThreadProc(Internal::Platform::Event* _exitEvent)
 			waitObjects[9] = m_queueEvent[MsgQueue_Query];		// Node queries are pending.
 			waitObjects[10] = m_queueEvent[MsgQueue_Poll];		// Poll request is waiting.
 
+			// The watchers stay registered for as long as the driver is initialised,
+			// rather than being added and removed on every pass through the loop.
+			Internal::Platform::WaitSet waitSet(waitObjects, WAITOBJECTCOUNT);
+
 			Internal::Platform::TimeStamp retryTimeStamp;
-			int retryTimeout = RETRY_TIMEOUT;
-			Options::Get()->GetOptionAsInt("RetryTimeout", &retryTimeout);
+			int retryTimeout = Options::Get()->GetValues().m_RetryTimeout;
 			//retryTimeout = RETRY_TIMEOUT * 10;
 			while (true)
 			{
 				Log::Write(LogLevel_StreamDetail, "      Top of DriverThreadProc loop.");
+
+				// Let the poll thread know it may send its next poll
+				if (SendQueuesIdle())
+				{
+					m_sendQueuesIdleEvent->Set();
+				}
+
 				uint32 count = WAITOBJECTCOUNT;
 				int32 timeout = Internal::Platform::Wait::Timeout_Infinite;
 
@@ -385,18 +491,36 @@ void Driver::DriverThreadProc(Internal::Platform::Event* _exitEvent)
 				{
 					count = 7;
 				}
-				else
+				else if (m_outstandingRequests.empty())
 				{
 					Log::QueueClear();							// clear the log queue when starting a new message
 				}
 
+				// Requests waiting for their reply have deadlines of their own
+				bool outstandingTimeout = false;
+				if (!m_outstandingRequests.empty())
+				{
+					int32 remaining = GetOutstandingTimeout();
+					if (timeout == Internal::Platform::Wait::Timeout_Infinite || remaining < timeout)
+					{
+						timeout = remaining;
+						outstandingTimeout = true;
+					}
+				}
+
 				// Wait for something to do
-				int32 res = Internal::Platform::Wait::Multiple(waitObjects, count, timeout);
+				int32 res = waitSet.Multiple(count, timeout);
 
 				switch (res)
 				{
 					case -1:
 					{
+						if (outstandingTimeout)
+						{
+							ExpireOutstandingRequests();
+							break;
+						}
+
 						// Wait has timed out - time to resend
 						if (m_currentMsg != NULL && !m_currentMsg->isResendDuetoCANorNAK())
 						{
@@ -557,6 +681,8 @@ void Driver::RemoveQueues(uint8 const _nodeId)
 	{
 		RemoveCurrentMsg();
 	}
+	RemoveOutstandingRequests(_nodeId);
+	ReleaseQueryItems(_nodeId);
 
 	// Clear the send Queue
 	for (int32 i = 0; i < MsgQueue_Count; ++i)
@@ -586,6 +712,10 @@ void Driver::RemoveQueues(uint8 const _nodeId)
 			}
 			if (remove)
 			{
+				if (i == MsgQueue_Query)
+				{
+					RemoveQueryWork(_nodeId);
+				}
 				it = m_msgQueue[i].erase(it);
 			}
 			else
@@ -619,11 +749,25 @@ bool Driver::ReadCache()
 
 	snprintf(str, sizeof(str), "ozwcache_0x%08x.xml", m_homeId);
 	string filename = userPath + string(str);
+	snprintf(str, sizeof(str), "ozwcache_0x%08x.bin", m_homeId);
+	string binaryFilename = userPath + string(str);
 
+	// Prefer the file in the configured format, but read the other one if that
+	// is all there is, so changing CacheFormat does not lose the network
 	TiXmlDocument doc;
-	if (!doc.LoadFile(filename.c_str(), TIXML_ENCODING_UTF8))
+	bool loaded = false;
+	if (IsBinaryCacheFormat() && Internal::BinaryCache::Load(binaryFilename, &doc))
 	{
-		return false;
+		filename = binaryFilename;
+		loaded = true;
+	}
+	if (!loaded && !doc.LoadFile(filename.c_str(), TIXML_ENCODING_UTF8))
+	{
+		if (IsBinaryCacheFormat() || !Internal::BinaryCache::Load(binaryFilename, &doc))
+		{
+			return false;
+		}
+		filename = binaryFilename;
 	}
 	doc.SetUserData((void *) filename.c_str());
 	TiXmlElement const* driverElement = doc.RootElement();
@@ -694,17 +838,20 @@ bool Driver::ReadCache()
 	}
 
 	// Poll Interval
+	int32 pollInterval = m_pollInterval;
 	if (TIXML_SUCCESS == driverElement->QueryIntAttribute("poll_interval", &intVal))
 	{
-		m_pollInterval = intVal;
+		pollInterval = intVal;
 	}
 
 	// Poll Interval--between polls or period for polling the entire pollList?
+	bool intervalBetweenPolls = m_bIntervalBetweenPolls;
 	char const* cstr = driverElement->Attribute("poll_interval_between");
 	if (cstr)
 	{
-		m_bIntervalBetweenPolls = !strcmp(cstr, "true");
+		intervalBetweenPolls = !strcmp(cstr, "true");
 	}
+	SetPollInterval(pollInterval, intervalBetweenPolls);
 
 	// Read the nodes
 	Internal::LockGuard LG(m_nodeMutex);
@@ -755,9 +902,118 @@ bool Driver::ReadCache()
 
 //-----------------------------------------------------------------------------
 // <Driver::WriteCache>
-// Write ourselves to an XML document
+// Schedule a save of the configuration of every node
 //-----------------------------------------------------------------------------
 void Driver::WriteCache()
+{
+	{
+		Internal::LockGuard LG(m_cacheDirtyMutex);
+		for (int i = 0; i < 256; ++i)
+		{
+			m_cacheDirty[i] = true;
+		}
+	}
+	ScheduleCacheSave();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::WriteCache>
+// Schedule a save after the configuration of one node changed
+//-----------------------------------------------------------------------------
+void Driver::WriteCache(uint8 const _nodeId)
+{
+	MarkCacheDirty(_nodeId);
+	ScheduleCacheSave();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::MarkCacheDirty>
+// Note that the saved form of a node is out of date.  Nodes and values call
+// this whenever something they write to the cache changes, so a save that
+// was scheduled for another reason does not write a stale copy.
+//-----------------------------------------------------------------------------
+void Driver::MarkCacheDirty(uint8 const _nodeId)
+{
+	Internal::LockGuard LG(m_cacheDirtyMutex);
+	m_cacheDirty[_nodeId] = true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ScheduleCacheSave>
+// Wake the cache thread, unless a save is already pending.  Changes made
+// while a save is pending are written by that save.
+//-----------------------------------------------------------------------------
+void Driver::ScheduleCacheSave()
+{
+	int32 delay = Options::Get()->GetValues().m_CacheSaveDelay;
+
+	Internal::LockGuard LG(m_cacheDirtyMutex);
+	if (m_cacheDue == 0)
+	{
+		m_cacheDue = Internal::Platform::TimeStamp::GetMonotonicTime() + (delay > 0 ? delay : 0);
+		m_cacheEvent->Set();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CacheThreadEntryPoint>
+// Entry point of the thread that writes the cache file
+//-----------------------------------------------------------------------------
+void Driver::CacheThreadEntryPoint(Internal::Platform::Event* _exitEvent, void* _context)
+{
+	Driver* driver = (Driver*) _context;
+	if (driver)
+	{
+		driver->CacheThreadProc(_exitEvent);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CacheThreadProc>
+// Save the cache once the save delay has passed, so the threads that change
+// the configuration never wait for the disk
+//-----------------------------------------------------------------------------
+void Driver::CacheThreadProc(Internal::Platform::Event* _exitEvent)
+{
+	Internal::Platform::Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;
+	waitObjects[1] = m_cacheEvent;
+	Internal::Platform::WaitSet waitSet(waitObjects, 2);
+
+	while (true)
+	{
+		int32 timeout = -1;
+		{
+			Internal::LockGuard LG(m_cacheDirtyMutex);
+			m_cacheEvent->Reset();
+			if (m_cacheDue != 0)
+			{
+				uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+				timeout = m_cacheDue > now ? (int32) (m_cacheDue - now) : 0;
+			}
+		}
+
+		if (timeout == 0)
+		{
+			SaveCache();
+			continue;
+		}
+
+		if (waitSet.Multiple(2, timeout) == 0)
+		{
+			// Exit has been signalled
+			return;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SaveCache>
+// Write ourselves to an XML document.  Only the nodes that changed since the
+// last save are serialized under the node lock, and the file is replaced
+// atomically so a crash can never leave a truncated cache behind.
+//-----------------------------------------------------------------------------
+void Driver::SaveCache()
 {
 	char str[32];
 
@@ -771,7 +1027,64 @@ void Driver::WriteCache()
 		return;
 	}
 
+	Internal::LockGuard CLG(m_cacheMutex);
+
+	// Take the set of nodes that changed
+	bool dirty[256];
+	{
+		Internal::LockGuard LG(m_cacheDirtyMutex);
+		memcpy(dirty, m_cacheDirty, sizeof(dirty));
+		memset(m_cacheDirty, 0, sizeof(m_cacheDirty));
+		m_cacheDue = 0;
+	}
+
+	bool binary = IsBinaryCacheFormat();
 	Log::Write(LogLevel_Info, "Saving Cache");
+	{
+		Internal::LockGuard LG(m_nodeMutex);
+
+		for (int i = 0; i < 256; ++i)
+		{
+			Node* node = m_nodes[i];
+			if (!node || node->GetCurrentQueryStage() < Node::QueryStage_CacheLoad)
+			{
+				if (node)
+				{
+					Log::Write(LogLevel_Info, i, "Skipping Cache Save for Node %d as its not past QueryStage_CacheLoad", i);
+				}
+				m_cacheNodes[i].clear();
+				continue;
+			}
+			if (dirty[i] || m_cacheNodes[i].empty())
+			{
+				// Keep the node in the form it is saved in until it changes again
+				TiXmlElement holder("Driver");
+				node->WriteXML(&holder);
+				m_cacheNodes[i].clear();
+				if (TiXmlElement const* nodeElement = holder.FirstChildElement())
+				{
+					if (binary)
+					{
+						Internal::BinaryCache::Encode(nodeElement, &m_cacheNodes[i]);
+					}
+					else
+					{
+						// Print the Node element one level into the Driver element.  The
+						// printer indents each line after a line break, so the first line
+						// gets its indent here and the last line break goes without one.
+						TiXmlPrinter printer;
+						printer.SetIndent("\t");
+						printer.SetLineBreak("\n\t");
+						nodeElement->Accept(&printer);
+						m_cacheNodes[i].push_back('\t');
+						m_cacheNodes[i].insert(m_cacheNodes[i].end(), printer.CStr(), printer.CStr() + printer.Size() - 1);
+					}
+				}
+				Log::Write(LogLevel_Info, i, "Cache Save for Node %d as its QueryStage_CacheLoad", i);
+			}
+		}
+	}
+
 	// Create a new XML document to contain the driver configuration
 	TiXmlDocument doc;
 	TiXmlDeclaration* decl = new TiXmlDeclaration("1.0", "utf-8", "");
@@ -805,32 +1118,65 @@ void Driver::WriteCache()
 	snprintf(str, sizeof(str), "%s", m_bIntervalBetweenPolls ? "true" : "false");
 	driverElement->SetAttribute("poll_interval_between", str);
 
-	{
-		Internal::LockGuard LG(m_nodeMutex);
+	string userPath;
+	Options::Get()->GetOptionAsString("UserPath", &userPath);
+
+	snprintf(str, sizeof(str), "ozwcache_0x%08x.%s", m_homeId, binary ? "bin" : "xml");
+	string filename = userPath + string(str);
+	snprintf(str, sizeof(str), "ozwcache_0x%08x.%s", m_homeId, binary ? "xml" : "bin");
+	string otherFilename = userPath + string(str);
 
+	bool saved;
+	if (binary)
+	{
+		// The nodes are already encoded, so they are written as they are
+		vector<vector<uint8> const*> blocks;
 		for (int i = 0; i < 256; ++i)
 		{
-			if (m_nodes[i])
+			if (!m_cacheNodes[i].empty())
 			{
-				if (m_nodes[i]->GetCurrentQueryStage() >= Node::QueryStage_CacheLoad)
-				{
-					m_nodes[i]->WriteXML(driverElement);
-					Log::Write(LogLevel_Info, i, "Cache Save for Node %d as its QueryStage_CacheLoad", i);
-				}
-				else
-				{
-					Log::Write(LogLevel_Info, i, "Skipping Cache Save for Node %d as its not past QueryStage_CacheLoad", i);
-				}
+				blocks.push_back(&m_cacheNodes[i]);
 			}
 		}
+		saved = Internal::BinaryCache::Save(filename, driverElement, blocks);
+	}
+	else
+	{
+		// The nodes are already printed, so they are put between the start and
+		// the end tag of the Driver element, which is printed empty as <Driver ... />
+		TiXmlPrinter printer;
+		doc.Accept(&printer);
+		string text(printer.CStr(), printer.Size());
+		text.erase(text.rfind(" />"));
+		text += ">\n";
+		for (int i = 0; i < 256; ++i)
+		{
+			text.append(m_cacheNodes[i].begin(), m_cacheNodes[i].end());
+		}
+		text += "</Driver>\n";
+		saved = Internal::Platform::FileOps::Create()->FileWriteAtomic(filename, text);
 	}
-	string userPath;
-	Options::Get()->GetOptionAsString("UserPath", &userPath);
 
-	snprintf(str, sizeof(str), "ozwcache_0x%08x.xml", m_homeId);
-	string filename = userPath + string(str);
+	if (!saved)
+	{
+		Log::Write(LogLevel_Warning, "WARNING: Failed to save the cache to %s", filename.c_str());
+	}
+	else if (Internal::Platform::FileOps::Create()->FileExists(otherFilename))
+	{
+		// A cache in the other format is now out of date
+		remove(otherFilename.c_str());
+	}
+}
 
-	doc.SaveFile(filename.c_str());
+//-----------------------------------------------------------------------------
+// <Driver::IsBinaryCacheFormat>
+// Whether the cache is saved in the binary format rather than XML
+//-----------------------------------------------------------------------------
+bool Driver::IsBinaryCacheFormat()
+{
+	string format;
+	Options::Get()->GetOptionAsString("CacheFormat", &format);
+	return Internal::ToUpper(format) == "BINARY";
 }
 
 //-----------------------------------------------------------------------------
@@ -857,7 +1203,7 @@ Node* Driver::GetNodeUnsafe(uint8 _nodeId)
 //-----------------------------------------------------------------------------
 Node* Driver::GetNode(uint8 _nodeId)
 {
-	if (m_nodeMutex->IsSignalled())
+	if (!m_nodeMutex->IsLocked())
 	{
 		Log::Write(LogLevel_Error, _nodeId, "Driver Thread is Not Locked during Call to GetNode");
 		return NULL;
@@ -897,7 +1243,10 @@ void Driver::SendQueryStageComplete(uint8 const _nodeId, Node::QueryStage const
 				{
 					// If the message is for a sleeping node, we queue it in the node itself.
 					Log::Write(LogLevel_Info, "");
-					Log::Write(LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_WakeUp], node->GetQueryStageName(_stage).c_str());
+					if (Log::IsLevelEnabled(LogLevel_Detail))
+					{
+						Log::Write(LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_WakeUp], node->GetQueryStageName(_stage).c_str());
+					}
 					wakeUp->QueueMsg(item);
 					return;
 				}
@@ -905,10 +1254,12 @@ void Driver::SendQueryStageComplete(uint8 const _nodeId, Node::QueryStage const
 		}
 
 		// Non-sleeping node
-		Log::Write(LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_Query], node->GetQueryStageName(_stage).c_str());
+		if (Log::IsLevelEnabled(LogLevel_Detail))
+		{
+			Log::Write(LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_Query], node->GetQueryStageName(_stage).c_str());
+		}
 		m_sendMutex->Lock();
-		m_msgQueue[MsgQueue_Query].push_back(item);
-		m_queueEvent[MsgQueue_Query]->Set();
+		QueueQueryItem(item, _nodeId, GetQueryStagePriority(_stage));
 		m_sendMutex->Unlock();
 
 	}
@@ -935,6 +1286,14 @@ void Driver::RetryQueryStageComplete(uint8 const _nodeId, Node::QueryStage const
 			break;
 		}
 	}
+	for (list<MsgQueueItem>::iterator it = m_queryPending[_nodeId].begin(); it != m_queryPending[_nodeId].end(); ++it)
+	{
+		if (*it == item)
+		{
+			(*it).m_retry = true;
+			break;
+		}
+	}
 	m_sendMutex->Unlock();
 }
 
@@ -951,17 +1310,23 @@ void Driver::SendMsg(Internal::Msg* _msg, MsgQueue const _queue)
 	/* make sure the HomeId is Set on this message */
 	_msg->SetHomeId(m_homeId);
 	_msg->Finalize();
+	uint8 queryPriority = 1;
 	{
 		Internal::LockGuard LG(m_nodeMutex);
 		if (Node* node = GetNode(_msg->GetTargetNodeId()))
 		{
+			queryPriority = GetQueryStagePriority(node->GetCurrentQueryStage());
+
 			/* if the node Supports the Security Class - check if this message is meant to be encapsulated */
 			if (node->GetCommandClass(Internal::CC::Security::StaticGetCommandClassId()))
 			{
 				Internal::CC::CommandClass *cc = node->GetCommandClass(_msg->GetSendingCommandClass());
 				if ((cc) && (cc->IsSecured()))
 				{
-					Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Setting Encryption Flag on Message For Command Class %s", cc->GetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Detail))
+					{
+						Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Setting Encryption Flag on Message For Command Class %s", cc->GetCommandClassName().c_str());
+					}
 					item.m_msg->setEncrypted();
 				}
 			}
@@ -984,22 +1349,416 @@ void Driver::SendMsg(Internal::Msg* _msg, MsgQueue const _queue)
 							item.m_msg = NULL;
 							UpdateControllerState(ControllerState_Sleeping);
 						}
-						else
+						else if (Log::IsLevelEnabled(LogLevel_Detail))
 						{
-							Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Queuing (%s) %s", c_sendQueueNames[MsgQueue_WakeUp], _msg->GetAsString().c_str());
+							char msgStr[1024];
+							Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Queuing (%s) %s", c_sendQueueNames[MsgQueue_WakeUp], _msg->GetAsString(msgStr, sizeof(msgStr)));
 						}
 						wakeUp->QueueMsg(item);
 						return;
 					}
 				}
 			}
+
+			// Hold back everything this thread sends while it has a multicast batch open,
+			// so that the Gets that verify a Set go out after the multicast and its follow-ups.
+			// Only unencrypted sets for listening nodes can be part of a multicast frame.
+			if (_queue == MsgQueue_Send)
+			{
+				Internal::LockGuard MLG(m_multicastMutex);
+				if (m_multicastDepth > 0 && m_multicastThread == std::this_thread::get_id())
+				{
+					bool multicast = node->IsListeningDevice() && !_msg->isEncrypted() && _msg->GetExpectedReply() == FUNC_ID_ZW_SEND_DATA;
+					m_multicastMsgs.push_back(make_pair(_msg, multicast));
+					return;
+				}
+			}
+		}
+	}
+	m_sendMutex->Lock();
+	if (CoalesceMsg(_msg, _queue))
+	{
+		m_sendMutex->Unlock();
+		return;
+	}
+	if (Log::IsLevelEnabled(LogLevel_Detail))
+	{
+		char msgStr[1024];
+		Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Queuing (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString(msgStr, sizeof(msgStr)));
+	}
+	_msg->SetQueuedTime(Internal::Platform::TimeStamp::GetMonotonicTimeUs());
+	if (_queue == MsgQueue_Query)
+	{
+		QueueQueryItem(item, _msg->GetTargetNodeId(), queryPriority);
+	}
+	else
+	{
+		if (_queue == MsgQueue_Send)
+		{
+			// The application is using this node, so finish querying it first
+			m_queryBoostUntil[_msg->GetTargetNodeId()] = Internal::Platform::TimeStamp::GetMonotonicTime() + c_queryBoostTime;
+		}
+		m_msgQueue[_queue].push_back(item);
+		m_queueEvent[_queue]->Set();
+	}
+	m_sendMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::QueueQueryItem>
+// Put query work on MsgQueue_Query if its node is being served, otherwise
+// hold it until the scheduler picks the node
+//-----------------------------------------------------------------------------
+void Driver::QueueQueryItem(MsgQueueItem const& _item, uint8 const _nodeId, uint8 const _priority)
+{
+	if (m_maxQueryNodes == 0 || IsQueryNodeActive(_nodeId))
+	{
+		m_msgQueue[MsgQueue_Query].push_back(_item);
+		m_queueEvent[MsgQueue_Query]->Set();
+		AddQueryWork(_nodeId);
+		return;
+	}
+
+	if (m_queryPending[_nodeId].empty())
+	{
+		m_queryPriority[_nodeId] = _priority;
+		++m_queryPendingNodes;
+	}
+	else if (_priority < m_queryPriority[_nodeId])
+	{
+		m_queryPriority[_nodeId] = _priority;
+	}
+	m_queryPending[_nodeId].push_back(_item);
+	ScheduleQueries();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ReleaseQueryItems>
+// Move the query work held for a node onto MsgQueue_Query
+//-----------------------------------------------------------------------------
+void Driver::ReleaseQueryItems(uint8 const _nodeId)
+{
+	if (m_queryPending[_nodeId].empty())
+	{
+		return;
+	}
+	AddQueryWork(_nodeId, (uint32) m_queryPending[_nodeId].size());
+	m_msgQueue[MsgQueue_Query].splice(m_msgQueue[MsgQueue_Query].end(), m_queryPending[_nodeId]);
+	m_queueEvent[MsgQueue_Query]->Set();
+	--m_queryPendingNodes;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ScheduleQueries>
+// Release held query work while fewer than m_maxQueryNodes nodes are being
+// served, best priority first and in turn among nodes of equal priority
+//-----------------------------------------------------------------------------
+void Driver::ScheduleQueries()
+{
+	if (m_maxQueryNodes == 0 || m_queryActiveNodes >= m_maxQueryNodes || m_queryPendingNodes == 0)
+	{
+		return;
+	}
+
+	uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+	while (m_queryActiveNodes < m_maxQueryNodes && m_queryPendingNodes > 0)
+	{
+		int32 best = -1;
+		uint8 bestPriority = 0xff;
+		for (int32 i = 1; i <= 256; ++i)
+		{
+			uint8 nodeId = (uint8) (m_lastQueryNode + i);
+			if (m_queryPending[nodeId].empty() || m_queryWork[nodeId] > 0)
+			{
+				continue;
+			}
+			uint8 priority = (m_queryBoostUntil[nodeId] > now) ? 0 : m_queryPriority[nodeId];
+			if (priority < bestPriority)
+			{
+				best = nodeId;
+				bestPriority = priority;
+			}
+		}
+		if (best < 0)
+		{
+			break;
+		}
+
+		if (Log::IsLevelEnabled(LogLevel_Detail))
+		{
+			Log::Write(LogLevel_Detail, (uint8) best, "Releasing (%s) %d held queries, priority %d", c_sendQueueNames[MsgQueue_Query], (int) m_queryPending[best].size(), bestPriority);
+		}
+		ReleaseQueryItems((uint8) best);
+		m_lastQueryNode = (uint8) best;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::IsQueryNodeActive>
+// True if a node has work in MsgQueue_Query, or a query message being sent
+// or waiting for its reply
+//-----------------------------------------------------------------------------
+bool Driver::IsQueryNodeActive(uint8 const _nodeId) const
+{
+	return m_queryWork[_nodeId] > 0;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::AddQueryWork>
+// Count work that has gone onto MsgQueue_Query for a node
+//-----------------------------------------------------------------------------
+void Driver::AddQueryWork(uint8 const _nodeId, uint32 const _count)
+{
+	if (m_queryWork[_nodeId] == 0)
+	{
+		++m_queryActiveNodes;
+	}
+	m_queryWork[_nodeId] += _count;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::RemoveQueryWork>
+// Count query work that is finished with, and let another node in once a
+// node has none left
+//-----------------------------------------------------------------------------
+void Driver::RemoveQueryWork(uint8 const _nodeId)
+{
+	Internal::LockGuard LG(m_sendMutex);
+	if (m_queryWork[_nodeId] == 0)
+	{
+		return;
+	}
+	if (--m_queryWork[_nodeId] == 0)
+	{
+		--m_queryActiveNodes;
+		ScheduleQueries();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CoalesceMsg>
+// Replace a queued Set with a newer one, or drop a Get that is already queued.
+// Returns true if the message was absorbed, in which case it must not be queued.
+//-----------------------------------------------------------------------------
+bool Driver::CoalesceMsg(Internal::Msg* _msg, MsgQueue const _queue)
+{
+	if ((_queue != MsgQueue_Send && _queue != MsgQueue_Poll) || _msg->GetCommandClassId() == 0)
+	{
+		return false;
+	}
+
+	list<MsgQueueItem>& queue = m_msgQueue[_queue];
+	if (_msg->GetExpectedReply() == FUNC_ID_ZW_SEND_DATA)
+	{
+		// Only command classes whose Set carries the whole target state can be replaced
+		// without losing anything.  A Configuration Set for another parameter, for
+		// instance, is not superseded by this one.
+		uint8 ccId = _msg->GetCommandClassId();
+		if (ccId != Internal::CC::Basic::StaticGetCommandClassId() && ccId != Internal::CC::SwitchBinary::StaticGetCommandClassId() && ccId != Internal::CC::SwitchMultilevel::StaticGetCommandClassId() && ccId != Internal::CC::SwitchToggleBinary::StaticGetCommandClassId() && ccId != Internal::CC::SwitchToggleMultilevel::StaticGetCommandClassId() && ccId != Internal::CC::DoorLock::StaticGetCommandClassId() && ccId != Internal::CC::Lock::StaticGetCommandClassId()
+				&& ccId != Internal::CC::ThermostatMode::StaticGetCommandClassId() && ccId != Internal::CC::ThermostatFanMode::StaticGetCommandClassId())
+		{
+			return false;
+		}
+
+		// Find the newest queued Set for the same value.  Gets in between can be
+		// passed over, as they will now read back the newer state.
+		for (list<MsgQueueItem>::reverse_iterator rit = queue.rbegin(); rit != queue.rend(); ++rit)
+		{
+			if (rit->m_command != MsgQueueCmd_SendMsg)
+			{
+				continue;
+			}
+			Internal::Msg* queued = rit->m_msg;
+			if (queued->GetTargetNodeId() != _msg->GetTargetNodeId() || queued->GetCommandClassId() != ccId || queued->GetExpectedInstance() != _msg->GetExpectedInstance() || queued->GetExpectedReply() != FUNC_ID_ZW_SEND_DATA)
+			{
+				continue;
+			}
+			if (queued->GetCommand() != _msg->GetCommand() || queued->isEncrypted() != _msg->isEncrypted())
+			{
+				// A different command must keep its place in the sequence
+				return false;
+			}
+			if (Log::IsLevelEnabled(LogLevel_Detail))
+			{
+				char msgStr[1024];
+				Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Replacing queued (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString(msgStr, sizeof(msgStr)));
+			}
+			delete queued;
+			rit->m_msg = _msg;
+			m_coalescedSets++;
+			return true;
+		}
+	}
+	else if (_msg->GetExpectedReply() == FUNC_ID_APPLICATION_COMMAND_HANDLER)
+	{
+		// A Get is redundant if the same Get is already queued, unless a Set for the
+		// same value has been queued after it.
+		for (list<MsgQueueItem>::reverse_iterator rit = queue.rbegin(); rit != queue.rend(); ++rit)
+		{
+			if (rit->m_command != MsgQueueCmd_SendMsg)
+			{
+				continue;
+			}
+			Internal::Msg* queued = rit->m_msg;
+			if (queued->GetTargetNodeId() != _msg->GetTargetNodeId() || queued->GetCommandClassId() != _msg->GetCommandClassId() || queued->GetExpectedInstance() != _msg->GetExpectedInstance())
+			{
+				continue;
+			}
+			if (queued->GetExpectedReply() == FUNC_ID_ZW_SEND_DATA)
+			{
+				return false;
+			}
+			if (*queued == *_msg)
+			{
+				if (Log::IsLevelEnabled(LogLevel_Detail))
+				{
+					char msgStr[1024];
+					Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Dropping duplicate (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString(msgStr, sizeof(msgStr)));
+				}
+				delete _msg;
+				m_coalescedGets++;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::BeginMulticast>
+// Start holding back the messages sent by this thread
+//-----------------------------------------------------------------------------
+void Driver::BeginMulticast()
+{
+	Internal::LockGuard LG(m_multicastMutex);
+	if (m_multicastDepth == 0)
+	{
+		m_multicastThread = std::this_thread::get_id();
+	}
+	else if (m_multicastThread != std::this_thread::get_id())
+	{
+		// Another thread owns the batch, so this thread's messages are sent as usual
+		return;
+	}
+	m_multicastDepth++;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::EndMulticast>
+// Send the messages held back since BeginMulticast
+//-----------------------------------------------------------------------------
+void Driver::EndMulticast()
+{
+	list<pair<Internal::Msg*, bool> > msgs;
+	{
+		Internal::LockGuard LG(m_multicastMutex);
+		if (m_multicastDepth == 0 || m_multicastThread != std::this_thread::get_id())
+		{
+			return;
+		}
+		if (--m_multicastDepth > 0)
+		{
+			return;
+		}
+		msgs.swap(m_multicastMsgs);
+	}
+
+	if (!msgs.empty())
+	{
+		SendMulticast(msgs);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SendMulticast>
+// Queue one multicast frame for each payload that is sent to several nodes,
+// followed by the held messages in their original order
+//-----------------------------------------------------------------------------
+void Driver::SendMulticast(list<pair<Internal::Msg*, bool> > const& _msgs)
+{
+	// Keep each frame well inside the serial API limit
+	static uint32 const c_maxMulticastNodes = 64;
+
+	bool followUp = Options::Get()->GetValues().m_MulticastFollowUp;
+
+	// Group the sets by payload and transmit options, in the order the payloads were first seen
+	vector<vector<Internal::Msg*> > groups;
+	map<vector<uint8>, size_t> groupIndex;
+	for (list<pair<Internal::Msg*, bool> >::const_iterator it = _msgs.begin(); it != _msgs.end(); ++it)
+	{
+		uint8 length = 0;
+		uint8 txOptions = 0;
+		uint8 const* payload = it->second ? it->first->GetSendDataPayload(&length, &txOptions) : NULL;
+		if (!payload)
+		{
+			continue;
+		}
+		vector<uint8> key(payload, payload + length);
+		key.push_back(txOptions);
+
+		map<vector<uint8>, size_t>::iterator git = groupIndex.find(key);
+		if (git == groupIndex.end())
+		{
+			git = groupIndex.insert(make_pair(key, groups.size())).first;
+			groups.push_back(vector<Internal::Msg*>());
+		}
+		groups[git->second].push_back(it->first);
+	}
+
+	map<Internal::Msg*, bool> dropped;
+	for (size_t g = 0; g < groups.size(); ++g)
+	{
+		vector<Internal::Msg*> const& group = groups[g];
+		if (group.size() < 2)
+		{
+			continue;
+		}
+
+		uint8 length = 0;
+		uint8 txOptions = 0;
+		uint8 const* payload = group.front()->GetSendDataPayload(&length, &txOptions);
+		for (size_t start = 0; start < group.size(); start += c_maxMulticastNodes)
+		{
+			size_t count = group.size() - start;
+			if (count > c_maxMulticastNodes)
+			{
+				count = c_maxMulticastNodes;
+			}
+
+			Internal::Msg* msg = new Internal::Msg("ZW_SEND_DATA_MULTI (" + group.front()->GetLogText() + ")", 0xff, REQUEST, FUNC_ID_ZW_SEND_DATA_MULTI, true, false);
+			msg->Append((uint8) count);
+			for (size_t i = start; i < start + count; ++i)
+			{
+				msg->Append(group[i]->GetTargetNodeId());
+			}
+			msg->Append(length);
+			msg->AppendArray(payload, length);
+			msg->Append(txOptions);
+			Log::Write(LogLevel_Info, "Multicasting %s to %d nodes", group.front()->GetLogText().c_str(), (int) count);
+			SendMsg(msg, MsgQueue_Send);
+		}
+
+		if (!followUp)
+		{
+			for (size_t i = 0; i < group.size(); ++i)
+			{
+				dropped[group[i]] = true;
+			}
 		}
 	}
-	Log::Write(LogLevel_Detail, GetNodeNumber(_msg), "Queuing (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString().c_str());
-	m_sendMutex->Lock();
-	m_msgQueue[_queue].push_back(item);
-	m_queueEvent[_queue]->Set();
-	m_sendMutex->Unlock();
+
+	// Queue the singlecast sets and everything else that was held, such as the
+	// Gets that read the new state back, in their original order.  The batch is
+	// closed, so SendMsg queues them as usual.
+	for (list<pair<Internal::Msg*, bool> >::const_iterator it = _msgs.begin(); it != _msgs.end(); ++it)
+	{
+		if (dropped.find(it->first) != dropped.end())
+		{
+			delete it->first;
+			continue;
+		}
+		SendMsg(it->first, MsgQueue_Send);
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -1011,11 +1770,20 @@ bool Driver::WriteNextMsg(MsgQueue const _queue)
 
 	// There are messages to send, so get the one at the front of the queue
 	m_sendMutex->Lock();
+	if (!m_outstandingRequests.empty() && !SelectNextMsg(_queue))
+	{
+		// Everything in this queue is for nodes that still owe us a reply.
+		// The queue is signalled again when one of them arrives.
+		m_queueEvent[_queue]->Reset();
+		m_sendMutex->Unlock();
+		return false;
+	}
 	MsgQueueItem item = m_msgQueue[_queue].front();
 
 	if (MsgQueueCmd_SendMsg == item.m_command)
 	{
 		// Send a message
+		// A query message stays counted against its node until it is done with
 		m_currentMsg = item.m_msg;
 		m_currentMsgQueueSource = _queue;
 		m_msgQueue[_queue].pop_front();
@@ -1032,6 +1800,10 @@ bool Driver::WriteNextMsg(MsgQueue const _queue)
 			item_new.m_msg = new Internal::Msg(*item.m_msg);
 			m_msgQueue[_queue].push_front(item_new);
 			m_queueEvent[_queue]->Set();
+			if (_queue == MsgQueue_Query)
+			{
+				AddQueryWork(item_new.m_nodeId);
+			}
 		}
 		m_sendMutex->Unlock();
 		return WriteMsg("WriteNextMsg");
@@ -1046,12 +1818,19 @@ bool Driver::WriteNextMsg(MsgQueue const _queue)
 		{
 			m_queueEvent[_queue]->Reset();
 		}
+		if (_queue == MsgQueue_Query)
+		{
+			RemoveQueryWork(item.m_nodeId);
+		}
 		m_sendMutex->Unlock();
 
 		Node* node = GetNodeUnsafe(item.m_nodeId);
 		if (node != NULL)
 		{
-			Log::Write(LogLevel_Detail, node->GetNodeId(), "Query Stage Complete (%s)", node->GetQueryStageName(stage).c_str());
+			if (Log::IsLevelEnabled(LogLevel_Detail))
+			{
+				Log::Write(LogLevel_Detail, node->GetNodeId(), "Query Stage Complete (%s)", node->GetQueryStageName(stage).c_str());
+			}
 			if (!item.m_retry)
 			{
 				node->QueryStageComplete(stage);
@@ -1210,12 +1989,10 @@ bool Driver::WriteMsg(string const &msg)
 		m_expectedReply = m_currentMsg->GetExpectedReply();
 		m_waitingForAck = true;
 	}
-	string attemptsstr = "";
+	char attemptsstr[16] = "";
 	if (attempts > 1)
 	{
-		char buf[15];
-		snprintf(buf, sizeof(buf), "Attempt %d, ", attempts);
-		attemptsstr = buf;
+		snprintf(attemptsstr, sizeof(attemptsstr), "Attempt %d, ", attempts);
 		m_retries++;
 		if (node != NULL)
 		{
@@ -1234,18 +2011,26 @@ bool Driver::WriteMsg(string const &msg)
 	{
 		if (m_currentMsg->isNonceRecieved())
 		{
-			Log::Write(LogLevel_Info, nodeId, "Processing (%s) Encrypted message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str());
+			if (Log::IsLevelEnabled(LogLevel_Info))
+			{
+				char msgStr[1024];
+				Log::Write(LogLevel_Info, nodeId, "Processing (%s) Encrypted message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr, m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString(msgStr, sizeof(msgStr)));
+			}
 			SendEncryptedMessage();
 		}
 		else
 		{
-			Log::Write(LogLevel_Info, nodeId, "Processing (%s) Nonce Request message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x)", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply);
+			Log::Write(LogLevel_Info, nodeId, "Processing (%s) Nonce Request message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x)", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr, m_expectedCallbackId, m_expectedReply);
 			SendNonceRequest(m_currentMsg->GetLogText());
 		}
 	}
 	else
 	{
-		Log::Write(LogLevel_Info, nodeId, "Sending (%s) message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str());
+		if (Log::IsLevelEnabled(LogLevel_Info))
+		{
+			char msgStr[1024];
+			Log::Write(LogLevel_Info, nodeId, "Sending (%s) message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr, m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString(msgStr, sizeof(msgStr)));
+		}
 		uint32 bytesWritten = m_controller->Write(m_currentMsg->GetBuffer(), m_currentMsg->GetLength());
 
 		if (bytesWritten == 0)
@@ -1274,6 +2059,13 @@ bool Driver::WriteMsg(string const &msg)
 		{
 			node->m_sentCnt++;
 			node->m_sentTS.SetTime();
+			node->m_sentTime = Internal::Platform::TimeStamp::GetMonotonicTimeUs();
+			if (m_currentMsg->GetQueuedTime() != 0)
+			{
+				// Only the first attempt counts as waiting in the queue
+				node->RecordLatency(Node::Latency_QueueWait, (uint32) (node->m_sentTime - m_currentMsg->GetQueuedTime()));
+				m_currentMsg->SetQueuedTime(0);
+			}
 			if (m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER)
 			{
 				Internal::CC::CommandClass *cc = node->GetCommandClass(m_expectedCommandClassId);
@@ -1296,6 +2088,10 @@ void Driver::RemoveCurrentMsg()
 	Log::Write(LogLevel_Detail, GetNodeNumber(m_currentMsg), "Removing current message");
 	if (m_currentMsg != NULL)
 	{
+		if (m_currentMsgQueueSource == MsgQueue_Query)
+		{
+			RemoveQueryWork(m_currentMsg->GetTargetNodeId());
+		}
 		delete m_currentMsg;
 		m_currentMsg = NULL;
 	}
@@ -1309,6 +2105,236 @@ void Driver::RemoveCurrentMsg()
 	m_nonceReportSentAttempt = 0;
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::ParkCurrentMsg>
+// Stop blocking the queues on a request the node has acknowledged, and wait
+// for its reply alongside other traffic
+//-----------------------------------------------------------------------------
+bool Driver::ParkCurrentMsg()
+{
+	if (m_currentMsg == NULL || m_currentControllerCommand != NULL || m_outstandingRequests.size() >= m_maxOutstandingRequests)
+	{
+		return false;
+	}
+	if (m_expectedReply != FUNC_ID_APPLICATION_COMMAND_HANDLER || m_expectedCommandClassId == 0 || m_currentMsg->isEncrypted() || m_nonceReportSent != 0)
+	{
+		// The security handshake needs the message to stay current
+		return false;
+	}
+
+	// A sleeping node might be sent Wake Up No More Information before it has replied
+	uint8 nodeId = m_currentMsg->GetTargetNodeId();
+	Node* node = GetNodeUnsafe(nodeId);
+	if (node == NULL || !node->IsListeningDevice())
+	{
+		return false;
+	}
+
+	OutstandingRequest request;
+	request.m_msg = m_currentMsg;
+	request.m_queue = m_currentMsgQueueSource;
+	request.m_deadline = Internal::Platform::TimeStamp::GetMonotonicTime() + Options::Get()->GetValues().m_RetryTimeout;
+	m_outstandingRequests.push_back(request);
+	Log::Write(LogLevel_Detail, nodeId, "  Waiting for the reply while other messages are sent (%d outstanding)", (int) m_outstandingRequests.size());
+
+	m_currentMsg = NULL;
+	m_expectedCallbackId = 0;
+	m_expectedCommandClassId = 0;
+	m_expectedNodeId = 0;
+	m_expectedReply = 0;
+	m_waitingForAck = false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CompleteOutstandingRequest>
+// Match a report from a node against the requests waiting for a reply
+//-----------------------------------------------------------------------------
+bool Driver::CompleteOutstandingRequest(uint8 const _nodeId, uint8 const _commandClassId)
+{
+	for (list<OutstandingRequest>::iterator it = m_outstandingRequests.begin(); it != m_outstandingRequests.end(); ++it)
+	{
+		if (it->m_msg->GetTargetNodeId() == _nodeId && it->m_msg->GetExpectedCommandClassId() == _commandClassId)
+		{
+			Log::Write(LogLevel_Detail, _nodeId, "  Expected reply and command class was received");
+			Log::Write(LogLevel_Detail, _nodeId, "  Message transaction complete");
+			if (m_notifytransactions)
+			{
+				Notification* notification = new Notification(Notification::Type_Notification);
+				notification->SetHomeAndNodeIds(m_homeId, _nodeId);
+				notification->SetNotification(Notification::Code_MsgComplete);
+				QueueNotification(notification);
+			}
+			if (it->m_queue == MsgQueue_Query)
+			{
+				RemoveQueryWork(_nodeId);
+			}
+			delete it->m_msg;
+			m_outstandingRequests.erase(it);
+
+			// Anything held back for this node can go now
+			Internal::LockGuard LG(m_sendMutex);
+			for (int32 i = 0; i < MsgQueue_Count; ++i)
+			{
+				if (!m_msgQueue[i].empty())
+				{
+					m_queueEvent[i]->Set();
+				}
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ExpireOutstandingRequests>
+// Resend the requests whose reply is overdue
+//-----------------------------------------------------------------------------
+void Driver::ExpireOutstandingRequests()
+{
+	uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+	list<OutstandingRequest>::iterator it = m_outstandingRequests.begin();
+	while (it != m_outstandingRequests.end())
+	{
+		if (it->m_deadline > now)
+		{
+			++it;
+			continue;
+		}
+
+		uint8 nodeId = it->m_msg->GetTargetNodeId();
+		Log::Write(LogLevel_Warning, nodeId, "WARNING: No reply from node, sending the request again");
+		Notification* notification = new Notification(Notification::Type_Notification);
+		notification->SetHomeAndNodeIds(m_homeId, nodeId);
+		notification->SetNotification(Notification::Code_Timeout);
+		QueueNotification(notification);
+
+		// WriteMsg counts the attempt, and drops the message once they are used up
+		MsgQueueItem item;
+		item.m_command = MsgQueueCmd_SendMsg;
+		item.m_msg = it->m_msg;
+		{
+			Internal::LockGuard LG(m_sendMutex);
+			m_msgQueue[it->m_queue].push_front(item);
+			for (int32 i = 0; i < MsgQueue_Count; ++i)
+			{
+				if (!m_msgQueue[i].empty())
+				{
+					m_queueEvent[i]->Set();
+				}
+			}
+		}
+		it = m_outstandingRequests.erase(it);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::RemoveOutstandingRequests>
+// Forget the requests waiting for a reply from a node
+//-----------------------------------------------------------------------------
+void Driver::RemoveOutstandingRequests(uint8 const _nodeId)
+{
+	list<OutstandingRequest>::iterator it = m_outstandingRequests.begin();
+	while (it != m_outstandingRequests.end())
+	{
+		if (it->m_msg->GetTargetNodeId() == _nodeId)
+		{
+			if (it->m_queue == MsgQueue_Query)
+			{
+				RemoveQueryWork(_nodeId);
+			}
+			delete it->m_msg;
+			it = m_outstandingRequests.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::IsAwaitingReply>
+// True if a node has acknowledged a request that it has not yet replied to
+//-----------------------------------------------------------------------------
+bool Driver::IsAwaitingReply(uint8 const _nodeId) const
+{
+	for (list<OutstandingRequest>::const_iterator it = m_outstandingRequests.begin(); it != m_outstandingRequests.end(); ++it)
+	{
+		if (it->m_msg->GetTargetNodeId() == _nodeId)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetOutstandingTimeout>
+// Milliseconds until the first outstanding request times out
+//-----------------------------------------------------------------------------
+int32 Driver::GetOutstandingTimeout() const
+{
+	uint64 deadline = m_outstandingRequests.front().m_deadline;
+	for (list<OutstandingRequest>::const_iterator it = m_outstandingRequests.begin(); it != m_outstandingRequests.end(); ++it)
+	{
+		if (it->m_deadline < deadline)
+		{
+			deadline = it->m_deadline;
+		}
+	}
+	uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+	return deadline > now ? (int32) (deadline - now) : 0;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SelectNextMsg>
+// Skip over queue items for nodes that still owe a reply, so that one slow
+// node does not hold up the rest of the network
+//-----------------------------------------------------------------------------
+bool Driver::SelectNextMsg(MsgQueue const _queue)
+{
+	list<MsgQueueItem>& queue = m_msgQueue[_queue];
+	for (list<MsgQueueItem>::iterator it = queue.begin(); it != queue.end(); ++it)
+	{
+		bool ready;
+		switch (it->m_command)
+		{
+			case MsgQueueCmd_SendMsg:
+			{
+				ready = !IsAwaitingReply(it->m_msg->GetTargetNodeId());
+				break;
+			}
+			case MsgQueueCmd_QueryStageComplete:
+			case MsgQueueCmd_ReloadNode:
+			{
+				ready = !IsAwaitingReply(it->m_nodeId);
+				break;
+			}
+			default:
+			{
+				// Controller commands wait until the network is quiet
+				ready = false;
+				if (it == queue.begin() && it->m_cci)
+				{
+					Log::Write(LogLevel_Detail, "Holding (%s) %s until %d outstanding replies have arrived", c_sendQueueNames[_queue], c_controllerCommandNames[it->m_cci->m_controllerCommand], (int) m_outstandingRequests.size());
+				}
+				break;
+			}
+		}
+		if (ready)
+		{
+			if (it != queue.begin())
+			{
+				queue.splice(queue.begin(), queue, it);
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::MoveMessagesToWakeUpQueue>
 // Move messages for a sleeping device to its wake-up queue
@@ -1349,7 +2375,11 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 							// commands or NoOperations to the pending queue.
 							if (!m_currentMsg->IsWakeUpNoMoreInformationCommand() && !m_currentMsg->IsNoOperation())
 							{
-								Log::Write(LogLevel_Info, _targetNodeId, "Node not responding - moving message to Wake-Up queue: %s", m_currentMsg->GetAsString().c_str());
+								if (Log::IsLevelEnabled(LogLevel_Info))
+								{
+									char msgStr[1024];
+									Log::Write(LogLevel_Info, _targetNodeId, "Node not responding - moving message to Wake-Up queue: %s", m_currentMsg->GetAsString(msgStr, sizeof(msgStr)));
+								}
 								/* reset the sendAttempts */
 								m_currentMsg->SetSendAttempts(0);
 
@@ -1363,6 +2393,10 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 								delete m_currentMsg;
 							}
 
+							if (m_currentMsgQueueSource == MsgQueue_Query)
+							{
+								RemoveQueryWork(_targetNodeId);
+							}
 							m_currentMsg = NULL;
 							m_expectedCallbackId = 0;
 							m_expectedCommandClassId = 0;
@@ -1372,7 +2406,8 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 						}
 					}
 
-					// Now the message queues
+					// Now the message queues, including any queries still held back
+					ReleaseQueryItems(_targetNodeId);
 					for (int i = 0; i < MsgQueue_Count; ++i)
 					{
 						list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
@@ -1389,7 +2424,11 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 									// commands or NoOperations to the pending queue.
 									if (!item.m_msg->IsWakeUpNoMoreInformationCommand() && !item.m_msg->IsNoOperation())
 									{
-										Log::Write(LogLevel_Info, item.m_msg->GetTargetNodeId(), "Node not responding - moving message to Wake-Up queue: %s", item.m_msg->GetAsString().c_str());
+										if (Log::IsLevelEnabled(LogLevel_Info))
+										{
+											char msgStr[1024];
+											Log::Write(LogLevel_Info, item.m_msg->GetTargetNodeId(), "Node not responding - moving message to Wake-Up queue: %s", item.m_msg->GetAsString(msgStr, sizeof(msgStr)));
+										}
 										/* reset any SendAttempts */
 										item.m_msg->SetSendAttempts(0);
 										wakeUp->QueueMsg(item);
@@ -1424,6 +2463,10 @@ bool Driver::MoveMessagesToWakeUpQueue(uint8 const _targetNodeId, bool const _mo
 
 							if (remove)
 							{
+								if (i == MsgQueue_Query)
+								{
+									RemoveQueryWork(_targetNodeId);
+								}
 								it = m_msgQueue[i].erase(it);
 							}
 							else
@@ -1577,6 +2620,7 @@ void Driver::CheckCompletedNodeQueries()
 			}
 			m_awakeNodesQueried = true;
 			m_allNodesQueried = true;
+			m_pollEvent->Set();
 		}
 		else if (sleepingOnly)
 		{
@@ -1588,6 +2632,7 @@ void Driver::CheckCompletedNodeQueries()
 				notification->SetHomeAndNodeIds(m_homeId, 0xff);
 				QueueNotification(notification);
 				m_awakeNodesQueried = true;
+				m_pollEvent->Set();
 			}
 		}
 	}
@@ -1679,24 +2724,16 @@ bool Driver::ReadMsg()
 			uint32 length = buffer[1] + 2;
 
 			// Log the data
-			string str = "";
-			for (uint32 i = 0; i < length; ++i)
-			{
-				if (i)
-				{
-					str += ", ";
-				}
-
-				char byteStr[8];
-				snprintf(byteStr, sizeof(byteStr), "0x%.2x", buffer[i]);
-				str += byteStr;
-			}
 			uint8 nodeId = NodeFromMessage(buffer);
 			if (nodeId == 0)
 			{
 				nodeId = GetNodeNumber(m_currentMsg);
 			}
-			Log::Write(LogLevel_Detail, nodeId, "  Received: %s", str.c_str());
+			if (Log::IsLevelEnabled(LogLevel_Detail))
+			{
+				char str[1024];
+				Log::Write(LogLevel_Detail, nodeId, "  Received: %s", Internal::PktToString(buffer, length, str, sizeof(str)));
+			}
 
 			// Verify checksum
 			uint8 checksum = 0xff;
@@ -1771,6 +2808,10 @@ bool Driver::ReadMsg()
 			else
 			{
 				Log::Write(LogLevel_StreamDetail, GetNodeNumber(m_currentMsg), "  ACK received CallbackId 0x%.2x Reply 0x%.2x", m_expectedCallbackId, m_expectedReply);
+				if (Node* node = GetNodeUnsafe(m_currentMsg->GetTargetNodeId()))
+				{
+					node->RecordLatency(Node::Latency_Ack, (uint32) (Internal::Platform::TimeStamp::GetMonotonicTimeUs() - node->m_sentTime));
+				}
 				if ((0 == m_expectedCallbackId) && (0 == m_expectedReply))
 				{
 					// Remove the message from the queue, now that it has been acknowledged.
@@ -1973,6 +3014,20 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 				handleCallback = false;			// Skip the callback handling - a subsequent FUNC_ID_ZW_SEND_DATA request will deal with that
 				break;
 			}
+			case FUNC_ID_ZW_SEND_DATA_MULTI:
+			{
+				if (_data[2])
+				{
+					Log::Write(LogLevel_Detail, "  ZW_SEND_DATA_MULTI delivered to Z-Wave stack");
+				}
+				else
+				{
+					Log::Write(LogLevel_Error, "ERROR: ZW_SEND_DATA_MULTI could not be delivered to Z-Wave stack");
+					m_nondelivery++;
+				}
+				handleCallback = false;			// Skip the callback handling - a subsequent FUNC_ID_ZW_SEND_DATA_MULTI request will deal with that
+				break;
+			}
 			case FUNC_ID_ZW_GET_VERSION:
 			{
 				Log::Write(LogLevel_Detail, "");
@@ -2203,7 +3258,9 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 			case FUNC_ID_APPLICATION_COMMAND_HANDLER:
 			{
 				Log::Write(LogLevel_Detail, "");
-				HandleApplicationCommandHandlerRequest(_data, wasencrypted);
+				// A report only answers a request that is waiting for it if the command class matches too
+				bool reply = !m_outstandingRequests.empty() && CompleteOutstandingRequest(_data[3], _data[5]);
+				HandleApplicationCommandHandlerRequest(_data, wasencrypted, reply);
 				break;
 			}
 			case FUNC_ID_ZW_SEND_DATA:
@@ -2211,6 +3268,11 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 				HandleSendDataRequest(_data, _length, false);
 				break;
 			}
+			case FUNC_ID_ZW_SEND_DATA_MULTI:
+			{
+				Log::Write(LogLevel_Detail, "  ZW_SEND_DATA_MULTI Request with callback ID 0x%.2x received (expected 0x%.2x), transmit status %d", _data[2], m_expectedCallbackId, _data[3]);
+				break;
+			}
 			case FUNC_ID_ZW_REPLICATION_COMMAND_COMPLETE:
 			{
 				if (m_controllerReplication)
@@ -2375,6 +3437,12 @@ void Driver::ProcessMsg(uint8* _data, uint8 _length)
 				{
 					Log::Write(LogLevel_Detail, GetNodeNumber(m_currentMsg), "  Expected callbackId was received");
 					m_expectedCallbackId = 0;
+					if ((REQUEST == _data[0]) && (FUNC_ID_ZW_SEND_DATA == _data[1]) && (TRANSMIT_COMPLETE_OK == _data[3]) && ParkCurrentMsg())
+					{
+						// The node has the request.  Its reply is matched when it arrives,
+						// and other messages can be sent in the meantime.
+						return;
+					}
 				}
 				else if (_data[2] == 0x02 || _data[2] == 0x01)
 				{
@@ -3097,19 +4165,10 @@ void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replicatio
 			}
 			else
 			{
-				node->m_lastRequestRTT = -node->m_sentTS.TimeRemaining();
-
-				if (node->m_averageRequestRTT)
-				{
-					// if the average has been established, update by averaging the average and the last RTT
-					node->m_averageRequestRTT = (node->m_averageRequestRTT + node->m_lastRequestRTT) >> 1;
-				}
-				else
-				{
-					// if this is the first observed RTT, set the average to this value
-					node->m_averageRequestRTT = node->m_lastRequestRTT;
-				}
-				Log::Write(LogLevel_Info, nodeId, "Request RTT %d Average Request RTT %d", node->m_lastRequestRTT, node->m_averageRequestRTT);
+				uint32 rtt = (uint32) (Internal::Platform::TimeStamp::GetMonotonicTimeUs() - node->m_sentTime);
+				node->m_lastRequestRTT = rtt / 1000;
+				node->RecordLatency(Node::Latency_RequestRTT, rtt);
+				Log::Write(LogLevel_Info, nodeId, "Request RTT %d Average Request RTT %d", node->m_lastRequestRTT, node->GetMeanLatency(Node::Latency_RequestRTT) / 1000);
 			}
 			/* if the frame has txStatus message, then extract it */
 			// petergebruers, changed test (_length > 7) to >= 23 to avoid extracting non-existent data, highest is _data[22]
@@ -3140,11 +4199,14 @@ void Driver::HandleSendDataRequest(uint8* _data, uint8 _length, bool _replicatio
 				node->m_routeTries = _data[20];
 				node->m_lastFailedLinkFrom = _data[21];
 				node->m_lastFailedLinkTo = _data[22];
-				Node::NodeData nd;
-				node->GetNodeStatistics(&nd);
-				// petergebruers: changed "ChannelAck" to "AckChannel", to be consistent with docs and "TxChannel"
-				Log::Write(LogLevel_Detail, nodeId, "Extended TxStatus: Time: %d, Hops: %d, Rssi: %s %s %s %s %s, AckChannel: %d, TxChannel: %d, RouteScheme: %s, Route: %d %d %d %d, RouteSpeed: %s, RouteTries: %d, FailedLinkFrom: %d, FailedLinkTo: %d", nd.m_txTime, nd.m_hops, nd.m_rssi_1, nd.m_rssi_2, nd.m_rssi_3, nd.m_rssi_4, nd.m_rssi_4, nd.m_ackChannel, nd.m_lastTxChannel, Manager::GetNodeRouteScheme(&nd).c_str(), nd.m_routeUsed[0], nd.m_routeUsed[1], nd.m_routeUsed[2], nd.m_routeUsed[3],
-						Manager::GetNodeRouteSpeed(&nd).c_str(), nd.m_routeTries, nd.m_lastFailedLinkFrom, nd.m_lastFailedLinkTo);
+				if (Log::IsLevelEnabled(LogLevel_Detail))
+				{
+					Node::NodeData nd;
+					node->GetNodeStatistics(&nd);
+					// petergebruers: changed "ChannelAck" to "AckChannel", to be consistent with docs and "TxChannel"
+					Log::Write(LogLevel_Detail, nodeId, "Extended TxStatus: Time: %d, Hops: %d, Rssi: %s %s %s %s %s, AckChannel: %d, TxChannel: %d, RouteScheme: %s, Route: %d %d %d %d, RouteSpeed: %s, RouteTries: %d, FailedLinkFrom: %d, FailedLinkTo: %d", nd.m_txTime, nd.m_hops, nd.m_rssi_1, nd.m_rssi_2, nd.m_rssi_3, nd.m_rssi_4, nd.m_rssi_4, nd.m_ackChannel, nd.m_lastTxChannel, Manager::GetNodeRouteScheme(&nd).c_str(), nd.m_routeUsed[0], nd.m_routeUsed[1], nd.m_routeUsed[2], nd.m_routeUsed[3],
+							Manager::GetNodeRouteSpeed(&nd).c_str(), nd.m_routeTries, nd.m_lastFailedLinkFrom, nd.m_lastFailedLinkTo);
+				}
 			}
 
 		}
@@ -3339,7 +4401,7 @@ void Driver::HandleRemoveNodeFromNetworkRequest(uint8* _data)
 			{
 				m_currentControllerCommand->m_controllerCommandNode = _data[4];
 			}
-			WriteCache();
+			WriteCache(m_currentControllerCommand->m_controllerCommandNode);
 			Log::Write(LogLevel_Info, "Removing controller ID %d", m_currentControllerCommand->m_controllerCommandNode);
 			break;
 		}
@@ -3368,7 +4430,7 @@ void Driver::HandleRemoveNodeFromNetworkRequest(uint8* _data)
 						delete m_nodes[m_currentControllerCommand->m_controllerCommandNode];
 						m_nodes[m_currentControllerCommand->m_controllerCommandNode] = NULL;
 					}
-					WriteCache();
+					WriteCache(m_currentControllerCommand->m_controllerCommandNode);
 					Notification* notification = new Notification(Notification::Type_NodeRemoved);
 					notification->SetHomeAndNodeIds(m_homeId, m_currentControllerCommand->m_controllerCommandNode);
 					QueueNotification(notification);
@@ -3505,7 +4567,7 @@ void Driver::HandleRemoveFailedNodeRequest(uint8* _data)
 				delete m_nodes[m_currentControllerCommand->m_controllerCommandNode];
 				m_nodes[m_currentControllerCommand->m_controllerCommandNode] = NULL;
 			}
-			WriteCache();
+			WriteCache(m_currentControllerCommand->m_controllerCommandNode);
 			Notification* notification = new Notification(Notification::Type_NodeRemoved);
 			notification->SetHomeAndNodeIds(m_homeId, m_currentControllerCommand->m_controllerCommandNode);
 			QueueNotification(notification);
@@ -3554,8 +4616,8 @@ void Driver::HandleReplaceFailedNodeRequest(uint8* _data)
 			if (m_currentControllerCommand != NULL)
 			{
 				InitNode(m_currentControllerCommand->m_controllerCommandNode, true);
+				WriteCache(m_currentControllerCommand->m_controllerCommandNode);
 			}
-			WriteCache();
 			break;
 		}
 		case FAILED_NODE_REPLACE_FAILED:
@@ -3571,9 +4633,10 @@ void Driver::HandleReplaceFailedNodeRequest(uint8* _data)
 
 //-----------------------------------------------------------------------------
 // <Driver::HandleApplicationCommandHandlerRequest>
-// Process a request from the Z-Wave PC interface
+// Process a request from the Z-Wave PC interface.  _reply is true if the
+// message answered one of the outstanding requests.
 //-----------------------------------------------------------------------------
-void Driver::HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted)
+void Driver::HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted, bool _reply)
 {
 
 	uint8 status = _data[2];
@@ -3604,23 +4667,14 @@ void Driver::HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted
 			memcpy(node->m_lastReceivedMessage, _data, sizeof(node->m_lastReceivedMessage));
 		}
 		node->m_receivedTS.SetTime();
-		if (m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER && m_expectedNodeId == nodeId)
+		if ((m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER && m_expectedNodeId == nodeId) || _reply)
 		{
 			// Need to confirm this is the correct response to the last sent request.
 			// At least ignore any received messages prior to the send data request.
-			node->m_lastResponseRTT = -node->m_sentTS.TimeRemaining();
-
-			if (node->m_averageResponseRTT)
-			{
-				// if the average has been established, update by averaging the average and the last RTT
-				node->m_averageResponseRTT = (node->m_averageResponseRTT + node->m_lastResponseRTT) >> 1;
-			}
-			else
-			{
-				// if this is the first observed RTT, set the average to this value
-				node->m_averageResponseRTT = node->m_lastResponseRTT;
-			}
-			Log::Write(LogLevel_Info, nodeId, "Response RTT %d Average Response RTT %d", node->m_lastResponseRTT, node->m_averageResponseRTT);
+			uint32 rtt = (uint32) (Internal::Platform::TimeStamp::GetMonotonicTimeUs() - node->m_sentTime);
+			node->m_lastResponseRTT = rtt / 1000;
+			node->RecordLatency(Node::Latency_ResponseRTT, rtt);
+			Log::Write(LogLevel_Info, nodeId, "Response RTT %d Average Response RTT %d", node->m_lastResponseRTT, node->GetMeanLatency(Node::Latency_ResponseRTT) / 1000);
 		}
 		else
 		{
@@ -4043,6 +5097,53 @@ void Driver::CommonAddNodeStatusRequestHandler(uint8 _funcId, uint8* _data)
 //	Polling Z-Wave devices
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// <Driver::SetPollInterval>
+// Set the poll interval, and bring forward the polls that were scheduled
+// further ahead than the new interval allows
+//-----------------------------------------------------------------------------
+void Driver::SetPollInterval(int32 _milliseconds, bool _bIntervalBetweenPolls)
+{
+	m_pollMutex->Lock();
+	m_pollInterval = _milliseconds;
+	m_bIntervalBetweenPolls = _bIntervalBetweenPolls;
+	m_pollIntervalMs = (_milliseconds > 0) ? (uint32) _milliseconds : 0;
+	if (!_bIntervalBetweenPolls && (_milliseconds > 0) && (_milliseconds < 100))
+	{
+		Log::Write(LogLevel_Info, "The pollInterval setting is only %d, which appears to be a legacy setting.  Multiplying by 1000 to convert to ms.", _milliseconds);
+		m_pollIntervalMs *= 1000;
+	}
+
+	uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+	vector<pair<ValueID, uint64> > rescheduled;
+	{
+		Internal::ReadLockGuard LG(m_nodeMutex);
+		for (map<ValueID, PollEntry>::iterator it = m_pollEntries.begin(); it != m_pollEntries.end(); ++it)
+		{
+			uint8 intensity = 1;
+			if (Internal::VC::Value* value = GetValue(it->first))
+			{
+				intensity = value->GetPollIntensity() ? value->GetPollIntensity() : 1;
+				value->Release();
+			}
+			uint64 due = now + (uint64) intensity * GetPollSpacing() * m_pollEntries.size();
+			if (it->second.m_due > due)
+			{
+				rescheduled.push_back(make_pair(it->first, due));
+			}
+		}
+	}
+	for (vector<pair<ValueID, uint64> >::iterator it = rescheduled.begin(); it != rescheduled.end(); ++it)
+	{
+		SchedulePoll(it->first, it->second);
+	}
+	m_pollMutex->Unlock();
+
+	// The poll thread may be sleeping until a poll that is now due sooner, or
+	// spacing the polls that are already due by the old interval
+	m_pollEvent->Set();
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::EnablePoll>
 // Enable polling of a value
@@ -4064,35 +5165,29 @@ bool Driver::EnablePoll(ValueID const &_valueId, uint8 const _intensity)
 			// update the value's pollIntensity
 			value->SetPollIntensity(_intensity);
 
-			// Add the valueid to the polling list
-			// See if the node is already in the poll list.
-			for (list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it)
+			// See if the value is already in the poll list.
+			if (m_pollEntries.find(_valueId) != m_pollEntries.end())
 			{
-				if ((*it).m_id == _valueId)
-				{
-					// It is already in the poll list, so we have nothing to do.
-					Log::Write(LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)");
-					value->Release();
-					m_pollMutex->Unlock();
-					return true;
-				}
+				// It is already in the poll list, so we have nothing to do.
+				Log::Write(LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)");
+				value->Release();
+				m_pollMutex->Unlock();
+				return true;
 			}
 
-			// Not in the list, so we add it
-			PollEntry pe;
-			pe.m_id = _valueId;
-			pe.m_pollCounter = value->GetPollIntensity();
-			m_pollList.push_back(pe);
+			// Not in the list, so we add it.  It is due to be polled straight away.
+			SchedulePoll(_valueId, Internal::Platform::TimeStamp::GetMonotonicTime());
 			value->Release();
 			m_pollMutex->Unlock();
+			m_pollEvent->Set();
 
 			// send notification to indicate polling is enabled
 			Notification* notification = new Notification(Notification::Type_PollingEnabled);
 			notification->SetHomeAndNodeIds(m_homeId, _valueId.GetNodeId());
 			notification->SetValueId(_valueId);
 			QueueNotification(notification);
-			Log::Write(LogLevel_Info, nodeId, "EnablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items", _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size());
-			WriteCache();
+			Log::Write(LogLevel_Info, nodeId, "EnablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items", _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollEntries.size());
+			WriteCache(_valueId.GetNodeId());
 			return true;
 		}
 
@@ -4126,31 +5221,29 @@ bool Driver::DisablePoll(ValueID const &_valueId)
 	if (node != NULL)
 	{
 		// See if the value is already in the poll list.
-		for (list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it)
+		map<ValueID, PollEntry>::iterator it = m_pollEntries.find(_valueId);
+		if (it != m_pollEntries.end())
 		{
-			if ((*it).m_id == _valueId)
-			{
-				// Found it
-				// remove it from the poll list
-				m_pollList.erase(it);
+			// Found it
+			// remove it from the poll list.  Its item in the poll heap is discarded when it reaches the front.
+			m_pollEntries.erase(it);
 
-				// get the value object and reset pollIntensity to zero (indicating no polling)
-				Internal::VC::Value* value = GetValue(_valueId);
-				if (!value)
-					continue;
+			// get the value object and reset pollIntensity to zero (indicating no polling)
+			if (Internal::VC::Value* value = GetValue(_valueId))
+			{
 				value->SetPollIntensity(0);
 				value->Release();
-				m_pollMutex->Unlock();
-
-				// send notification to indicate polling is disabled
-				Notification* notification = new Notification(Notification::Type_PollingDisabled);
-				notification->SetHomeAndNodeIds(m_homeId, _valueId.GetNodeId());
-				notification->SetValueId(_valueId);
-				QueueNotification(notification);
-				Log::Write(LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items", _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size());
-				WriteCache();
-				return true;
 			}
+			m_pollMutex->Unlock();
+
+			// send notification to indicate polling is disabled
+			Notification* notification = new Notification(Notification::Type_PollingDisabled);
+			notification->SetHomeAndNodeIds(m_homeId, _valueId.GetNodeId());
+			notification->SetValueId(_valueId);
+			QueueNotification(notification);
+			Log::Write(LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items", _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollEntries.size());
+			WriteCache(_valueId.GetNodeId());
+			return true;
 		}
 
 		// Not in the list
@@ -4203,20 +5296,17 @@ bool Driver::isPolled(ValueID const &_valueId)
 	{
 
 		// See if the value is already in the poll list.
-		for (list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it)
+		if (m_pollEntries.find(_valueId) != m_pollEntries.end())
 		{
-			if ((*it).m_id == _valueId)
+			// Found it
+			if (bPolled)
 			{
-				// Found it
-				if (bPolled)
-				{
-					m_pollMutex->Unlock();
-					return true;
-				}
-				else
-				{
-					Log::Write(LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId());
-				}
+				m_pollMutex->Unlock();
+				return true;
+			}
+			else
+			{
+				Log::Write(LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId());
 			}
 		}
 
@@ -4251,12 +5341,74 @@ void Driver::SetPollIntensity(ValueID const &_valueId, uint8 const _intensity)
 
 	Internal::VC::Value* value = GetValue(_valueId);
 	if (!value)
+	{
+		m_pollMutex->Unlock();
 		return;
+	}
 	value->SetPollIntensity(_intensity);
 
 	value->Release();
 	m_pollMutex->Unlock();
-	WriteCache();
+	WriteCache(_valueId.GetNodeId());
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollStatistics>
+// Return the poll latency and jitter statistics of a value
+//-----------------------------------------------------------------------------
+bool Driver::GetPollStatistics(ValueID const& _valueId, PollStatistics* _data)
+{
+	Internal::LockGuard LG(m_pollMutex);
+	map<ValueID, PollEntry>::iterator it = m_pollEntries.find(_valueId);
+	if (it == m_pollEntries.end())
+	{
+		return false;
+	}
+	*_data = it->second.m_stats;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SchedulePoll>
+// Set the time a value is next due to be polled.  m_pollMutex must be held.
+//-----------------------------------------------------------------------------
+void Driver::SchedulePoll(ValueID const& _valueId, uint64 _due)
+{
+	PollEntry& pe = m_pollEntries[_valueId];
+	pe.m_due = _due;
+	pe.m_generation = ++m_pollGeneration;
+
+	PollHeapItem item;
+	item.m_due = _due;
+	item.m_generation = pe.m_generation;
+	item.m_id = _valueId;
+	m_pollHeap.push_back(item);
+	push_heap(m_pollHeap.begin(), m_pollHeap.end());
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollSpacing>
+// Minimum time in ms between two polls.  With IntervalBetweenPolls this is the
+// poll interval itself, otherwise the interval is shared out between all the
+// polled values.  m_pollMutex must be held.
+//-----------------------------------------------------------------------------
+uint32 Driver::GetPollSpacing()
+{
+	if (m_bIntervalBetweenPolls || m_pollEntries.empty())
+	{
+		return m_pollIntervalMs;
+	}
+	return m_pollIntervalMs / (uint32) m_pollEntries.size();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SendQueuesIdle>
+// True if nothing is waiting to be sent and no transaction is in progress
+//-----------------------------------------------------------------------------
+bool Driver::SendQueuesIdle()
+{
+	Internal::LockGuard LG(m_sendMutex);
+	return m_msgQueue[MsgQueue_Poll].empty() && m_msgQueue[MsgQueue_Send].empty() && m_msgQueue[MsgQueue_Command].empty() && m_msgQueue[MsgQueue_Query].empty() && (m_currentMsg == NULL);
 }
 
 //-----------------------------------------------------------------------------
@@ -4278,132 +5430,207 @@ void Driver::PollThreadEntryPoint(Internal::Platform::Event* _exitEvent, void* _
 //-----------------------------------------------------------------------------
 void Driver::PollThreadProc(Internal::Platform::Event* _exitEvent)
 {
+	Internal::Platform::Wait* scheduleObjects[2];
+	scheduleObjects[0] = _exitEvent;						// Thread must exit.
+	scheduleObjects[1] = m_pollEvent;						// The poll schedule has changed.
+	Internal::Platform::WaitSet scheduleWait(scheduleObjects, 2);
+
+	Internal::Platform::Wait* idleObjects[2];
+	idleObjects[0] = _exitEvent;							// Thread must exit.
+	idleObjects[1] = m_sendQueuesIdleEvent;					// The send queues have drained.
+	Internal::Platform::WaitSet idleWait(idleObjects, 2);
+
 	while (1)
 	{
-		int32 pollInterval = m_pollInterval;
+		// Everything that changes the schedule sets m_pollEvent, so clear it before looking at the schedule
+		m_pollEvent->Reset();
 
-		if (m_awakeNodesQueried && !m_pollList.empty())
+		int32 timeout = Internal::Platform::Wait::Timeout_Infinite;
+		bool polled = false;
+		if (m_awakeNodesQueried)
 		{
-			// We only bother getting the lock if the pollList is not empty
 			m_pollMutex->Lock();
 
-			// Get the next value to be polled
-			PollEntry pe = m_pollList.front();
-			m_pollList.pop_front();
-			ValueID valueId = pe.m_id;
-
-			// only execute this poll if pe.m_pollCounter == 1; otherwise decrement the counter and process the next polled value
-			if (pe.m_pollCounter != 1)
-			{
-				pe.m_pollCounter--;
-				m_pollList.push_back(pe);
-				m_pollMutex->Unlock();
-				continue;
-			}
-
-			// reset the poll counter to the full pollIntensity value and push it at the end of the list
-			// release the value object referenced; call GetNode to ensure the node objects are locked during this period
+			// Discard heap items of values that have been rescheduled or are no longer polled
+			while (!m_pollHeap.empty())
 			{
-				Internal::LockGuard LG(m_nodeMutex);
-				(void) GetNode(valueId.GetNodeId());
-				Internal::VC::Value* value = GetValue(valueId);
-				if (!value)
-					continue;
-				pe.m_pollCounter = value->GetPollIntensity();
-				m_pollList.push_back(pe);
-				value->Release();
-			}
-			// If the polling interval is for the whole poll list, calculate the time before the next poll,
-			// so that all polls can take place within the user-specified interval.
-			if (!m_bIntervalBetweenPolls)
-			{
-				if (pollInterval < 100)
+				PollHeapItem const& item = m_pollHeap.front();
+				map<ValueID, PollEntry>::iterator it = m_pollEntries.find(item.m_id);
+				if ((it != m_pollEntries.end()) && (it->second.m_generation == item.m_generation))
 				{
-					Log::Write(LogLevel_Info, "The pollInterval setting is only %d, which appears to be a legacy setting.  Multiplying by 1000 to convert to ms.", pollInterval);
-					pollInterval *= 1000;
+					break;
 				}
-				pollInterval /= (int32) m_pollList.size();
+				pop_heap(m_pollHeap.begin(), m_pollHeap.end());
+				m_pollHeap.pop_back();
 			}
 
+			if (!m_pollHeap.empty())
 			{
-				Internal::LockGuard LG(m_nodeMutex);
-				// Request the state of the value from the node to which it belongs
-				if (Node* node = GetNode(valueId.GetNodeId()))
-				{
-					bool requestState = true;
-					if (!node->IsListeningDevice())
-					{
-						// The device is not awake all the time.  If it is not awake, we mark it
-						// as requiring a poll.  The poll will be done next time the node wakes up.
-						if (Internal::CC::WakeUp* wakeUp = static_cast<Internal::CC::WakeUp*>(node->GetCommandClass(Internal::CC::WakeUp::StaticGetCommandClassId())))
-						{
-							if (!wakeUp->IsAwake())
-							{
-								wakeUp->SetPollRequired();
-								requestState = false;
-							}
-						}
-					}
+				uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+				uint64 due = m_pollHeap.front().m_due;
 
-					if (requestState)
-					{
-						// Request an update of the value
-						Internal::CC::CommandClass* cc = node->GetCommandClass(valueId.GetCommandClassId());
-						if (cc)
-						{
-							uint16_t index = valueId.GetIndex();
-							uint8_t instance = valueId.GetInstance();
-							Log::Write(LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size());
-							cc->RequestValue(0, index, instance, MsgQueue_Poll);
-						}
-					}
+				// Keep consecutive polls at least the poll spacing apart
+				uint64 spaced = m_lastPollTime + GetPollSpacing();
+				if (m_lastPollTime && (due < spaced))
+				{
+					due = spaced;
+				}
 
+				if (due <= now)
+				{
+					ValueID valueId = m_pollHeap.front().m_id;
+					pop_heap(m_pollHeap.begin(), m_pollHeap.end());
+					m_pollHeap.pop_back();
+					PollValue(valueId);
+					polled = true;
+				}
+				else
+				{
+					timeout = (due - now > 0x7fffffff) ? 0x7fffffff : (int32) (due - now);
 				}
 			}
 
 			m_pollMutex->Unlock();
+		}
 
+		if (polled)
+		{
 			// Polling messages are only sent when there are no other messages waiting to be sent
 			// While this makes the polls much more variable and uncertain if some other activity dominates
 			// a send queue, that may be appropriate
-			// TODO we can have a debate about whether to test all four queues or just the Poll queue
-			// Wait until the library isn't actively sending messages (or in the midst of a transaction)
-			int i32;
-			int loopCount = 0;
-			while (!m_msgQueue[MsgQueue_Poll].empty() || !m_msgQueue[MsgQueue_Send].empty() || !m_msgQueue[MsgQueue_Command].empty() || !m_msgQueue[MsgQueue_Query].empty() || m_currentMsg != NULL)
-			{
-				i32 = Internal::Platform::Wait::Single(_exitEvent, 10);		// test conditions every 10ms
-				if (i32 == 0)
+			// The driver thread sets m_sendQueuesIdleEvent each time it finds nothing left to send.  We
+			// still re-check once a second, in case the queues were emptied from another thread.
+			int32 waited = 0;
+			while (true)
+			{
+				m_sendQueuesIdleEvent->Reset();
+				if (SendQueuesIdle())
+				{
+					break;
+				}
+				int32 res = idleWait.Multiple(2, 1000);
+				if (res == 0)
 				{
 					// Exit has been called
 					return;
 				}
-				loopCount++;
-				if (loopCount == 3000 * 10)		// 300 seconds worth of delay?  Something unusual is going on
+				if ((res < 0) && (++waited == 300))		// 300 seconds worth of delay?  Something unusual is going on
 				{
 					Log::Write(LogLevel_Warning, "Poll queue hasn't been able to execute for 300 secs or more");
 					Log::QueueDump();
-					//					assert( 0 );
 				}
 			}
+			continue;
+		}
+
+		// Sleep until the next poll is due, or the schedule changes
+		if (scheduleWait.Multiple(2, timeout) == 0)
+		{
+			// Exit has been called
+			return;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::PollValue>
+// Update the statistics of a value that is due, schedule its next poll and
+// request its state from the node.  m_pollMutex must be held.
+//-----------------------------------------------------------------------------
+void Driver::PollValue(ValueID const& _valueId)
+{
+	map<ValueID, PollEntry>::iterator it = m_pollEntries.find(_valueId);
+	if (it == m_pollEntries.end())
+	{
+		return;
+	}
+
+	Internal::LockGuard LG(m_nodeMutex);
+	Node* node = GetNode(_valueId.GetNodeId());
+	Internal::VC::Value* value = GetValue(_valueId);
+	if (!value)
+	{
+		// The value has gone away, so there is nothing left to poll
+		m_pollEntries.erase(it);
+		return;
+	}
+	uint8 intensity = value->GetPollIntensity();
+	value->Release();
+
+	// A value with intensity n is polled once every n poll intervals
+	uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+	uint32 period = (intensity ? intensity : 1) * GetPollSpacing() * (uint32) m_pollEntries.size();
+	PollEntry& pe = it->second;
+
+	uint32 latency = (now > pe.m_due) ? (uint32) (now - pe.m_due) : 0;
+	pe.m_stats.m_polls++;
+	pe.m_stats.m_lastLatency = latency;
+	if (latency > pe.m_stats.m_maxLatency)
+	{
+		pe.m_stats.m_maxLatency = latency;
+	}
+	pe.m_totalLatency += latency;
+	pe.m_stats.m_averageLatency = (uint32) (pe.m_totalLatency / pe.m_stats.m_polls);
+
+	if (pe.m_lastPoll != 0)
+	{
+		uint32 interval = (uint32) (now - pe.m_lastPoll);
+		uint32 jitter = (interval > pe.m_stats.m_period) ? interval - pe.m_stats.m_period : pe.m_stats.m_period - interval;
+		pe.m_stats.m_lastInterval = interval;
+		if (jitter > pe.m_stats.m_maxJitter)
+		{
+			pe.m_stats.m_maxJitter = jitter;
+		}
+		pe.m_totalJitter += jitter;
+		pe.m_stats.m_averageJitter = (uint32) (pe.m_totalJitter / (pe.m_stats.m_polls - 1));
+	}
+	pe.m_lastPoll = now;
+	pe.m_stats.m_period = period;
+	m_lastPollTime = now;
+
+	// The next poll is due one period after this one was due, so a late poll does not delay
+	// the ones after it.  If we have fallen more than a period behind, start again from now.
+	uint64 next = pe.m_due + period;
+	if (next <= now)
+	{
+		next = now + period;
+	}
+	SchedulePoll(_valueId, next);
+
+	if ((intensity == 0) || (node == NULL))
+	{
+		return;
+	}
 
-			// ready for next poll...insert the pollInterval delay
-			i32 = Internal::Platform::Wait::Single(_exitEvent, pollInterval);
-			if (i32 == 0)
+	// Request the state of the value from the node to which it belongs
+	bool requestState = true;
+	if (!node->IsListeningDevice())
+	{
+		// The device is not awake all the time.  If it is not awake, we mark it
+		// as requiring a poll.  The poll will be done next time the node wakes up.
+		if (Internal::CC::WakeUp* wakeUp = static_cast<Internal::CC::WakeUp*>(node->GetCommandClass(Internal::CC::WakeUp::StaticGetCommandClassId())))
+		{
+			if (!wakeUp->IsAwake())
 			{
-				// Exit has been called
-				return;
+				wakeUp->SetPollRequired();
+				requestState = false;
 			}
 		}
-		else		// poll list is empty or awake nodes haven't been fully queried yet
+	}
+
+	if (requestState)
+	{
+		// Request an update of the value
+		Internal::CC::CommandClass* cc = node->GetCommandClass(_valueId.GetCommandClassId());
+		if (cc)
 		{
-			// don't poll just yet, wait for the pollInterval or exit before re-checking to see if the pollList has elements
-			int32 i32 = Internal::Platform::Wait::Single(_exitEvent, 500);
-			if (i32 == 0)
+			uint16_t index = _valueId.GetIndex();
+			uint8_t instance = _valueId.GetInstance();
+			if (Log::IsLevelEnabled(LogLevel_Detail))
 			{
-				// Exit has been called
-				return;
+				Log::Write(LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size());
 			}
+			cc->RequestValue(0, index, instance, MsgQueue_Poll);
 		}
 	}
 }
@@ -4448,7 +5675,7 @@ void Driver::InitNode(uint8 const _nodeId, bool newNode, bool secure, uint8 cons
 			// Remove the original node
 			delete m_nodes[_nodeId];
 			m_nodes[_nodeId] = NULL;
-			WriteCache();
+			WriteCache(_nodeId);
 			Notification* notification = new Notification(Notification::Type_NodeRemoved);
 			notification->SetHomeAndNodeIds(m_homeId, _nodeId);
 			QueueNotification(notification);
@@ -4487,7 +5714,7 @@ void Driver::InitNode(uint8 const _nodeId, bool newNode, bool secure, uint8 cons
 bool Driver::IsNodeListeningDevice(uint8 const _nodeId)
 {
 	bool res = false;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		res = node->IsListeningDevice();
@@ -4503,7 +5730,7 @@ bool Driver::IsNodeListeningDevice(uint8 const _nodeId)
 bool Driver::IsNodeFrequentListeningDevice(uint8 const _nodeId)
 {
 	bool res = false;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		res = node->IsFrequentListeningDevice();
@@ -4519,7 +5746,7 @@ bool Driver::IsNodeFrequentListeningDevice(uint8 const _nodeId)
 bool Driver::IsNodeBeamingDevice(uint8 const _nodeId)
 {
 	bool res = false;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		res = node->IsBeamingDevice();
@@ -4535,7 +5762,7 @@ bool Driver::IsNodeBeamingDevice(uint8 const _nodeId)
 bool Driver::IsNodeRoutingDevice(uint8 const _nodeId)
 {
 	bool res = false;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		res = node->IsRoutingDevice();
@@ -4551,7 +5778,7 @@ bool Driver::IsNodeRoutingDevice(uint8 const _nodeId)
 bool Driver::IsNodeSecurityDevice(uint8 const _nodeId)
 {
 	bool security = false;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		security = node->IsSecurityDevice();
@@ -4567,7 +5794,7 @@ bool Driver::IsNodeSecurityDevice(uint8 const _nodeId)
 uint32 Driver::GetNodeMaxBaudRate(uint8 const _nodeId)
 {
 	uint32 baud = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		baud = node->GetMaxBaudRate();
@@ -4583,7 +5810,7 @@ uint32 Driver::GetNodeMaxBaudRate(uint8 const _nodeId)
 uint8 Driver::GetNodeVersion(uint8 const _nodeId)
 {
 	uint8 version = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		version = node->GetVersion();
@@ -4599,7 +5826,7 @@ uint8 Driver::GetNodeVersion(uint8 const _nodeId)
 uint8 Driver::GetNodeSecurity(uint8 const _nodeId)
 {
 	uint8 security = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		security = node->GetSecurity();
@@ -4615,7 +5842,7 @@ uint8 Driver::GetNodeSecurity(uint8 const _nodeId)
 uint8 Driver::GetNodeBasic(uint8 const _nodeId)
 {
 	uint8 basic = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		basic = node->GetBasic();
@@ -4630,7 +5857,7 @@ uint8 Driver::GetNodeBasic(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeBasicString(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetBasicString();
@@ -4649,7 +5876,7 @@ string Driver::GetNodeBasicString(uint8 const _nodeId)
 uint8 Driver::GetNodeGeneric(uint8 const _nodeId, uint8 const _instance)
 {
 	uint8 genericType = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		genericType = node->GetGeneric(_instance);
@@ -4664,7 +5891,7 @@ uint8 Driver::GetNodeGeneric(uint8 const _nodeId, uint8 const _instance)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeGenericString(uint8 const _nodeId, uint8 const _instance)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetGenericString(_instance);
@@ -4681,7 +5908,7 @@ string Driver::GetNodeGenericString(uint8 const _nodeId, uint8 const _instance)
 uint8 Driver::GetNodeSpecific(uint8 const _nodeId, uint8 const _instance)
 {
 	uint8 specific = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		specific = node->GetSpecific(_instance);
@@ -4696,7 +5923,7 @@ uint8 Driver::GetNodeSpecific(uint8 const _nodeId, uint8 const _instance)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeSpecificString(uint8 const _nodeId, uint8 const _instance)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetSpecificString(_instance);
@@ -4712,7 +5939,7 @@ string Driver::GetNodeSpecificString(uint8 const _nodeId, uint8 const _instance)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeType(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetType();
@@ -4723,7 +5950,7 @@ string Driver::GetNodeType(uint8 const _nodeId)
 
 bool Driver::IsNodeZWavePlus(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->IsNodeZWavePlus();
@@ -4738,7 +5965,7 @@ bool Driver::IsNodeZWavePlus(uint8 const _nodeId)
 uint32 Driver::GetNodeNeighbors(uint8 const _nodeId, uint8** o_neighbors)
 {
 	uint32 numNeighbors = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		numNeighbors = node->GetNeighbors(o_neighbors);
@@ -4754,7 +5981,7 @@ uint32 Driver::GetNodeNeighbors(uint8 const _nodeId, uint8** o_neighbors)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeManufacturerName(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetManufacturerName();
@@ -4770,7 +5997,7 @@ string Driver::GetNodeManufacturerName(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeProductName(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetProductName();
@@ -4786,7 +6013,7 @@ string Driver::GetNodeProductName(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeName(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetNodeName();
@@ -4802,7 +6029,7 @@ string Driver::GetNodeName(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeLocation(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetLocation();
@@ -4818,7 +6045,7 @@ string Driver::GetNodeLocation(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 uint16 Driver::GetNodeManufacturerId(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetManufacturerId();
@@ -4834,7 +6061,7 @@ uint16 Driver::GetNodeManufacturerId(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 uint16 Driver::GetNodeProductType(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetProductType();
@@ -4850,7 +6077,7 @@ uint16 Driver::GetNodeProductType(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 uint16 Driver::GetNodeProductId(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetProductId();
@@ -4865,7 +6092,7 @@ uint16 Driver::GetNodeProductId(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 uint16 Driver::GetNodeDeviceType(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetDeviceType();
@@ -4882,7 +6109,7 @@ uint16 Driver::GetNodeDeviceType(uint8 const _nodeId)
 string Driver::GetNodeDeviceTypeString(uint8 const _nodeId)
 {
 
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetDeviceTypeString();
@@ -4897,7 +6124,7 @@ string Driver::GetNodeDeviceTypeString(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 uint8 Driver::GetNodeRole(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetRoleType();
@@ -4912,7 +6139,7 @@ uint8 Driver::GetNodeRole(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 string Driver::GetNodeRoleString(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetRoleTypeString();
@@ -4927,7 +6154,7 @@ string Driver::GetNodeRoleString(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 uint8 Driver::GetNodePlusType(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetNodeType();
@@ -4941,7 +6168,7 @@ uint8 Driver::GetNodePlusType(uint8 const _nodeId)
 //-----------------------------------------------------------------------------
 string Driver::GetNodePlusTypeString(uint8 const _nodeId)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		return node->GetNodeTypeString();
@@ -4960,7 +6187,7 @@ void Driver::SetNodeManufacturerName(uint8 const _nodeId, string const& _manufac
 	{
 		node->SetManufacturerName(_manufacturerName);
 	}
-	WriteCache();
+	WriteCache(_nodeId);
 }
 
 //-----------------------------------------------------------------------------
@@ -4974,7 +6201,7 @@ void Driver::SetNodeProductName(uint8 const _nodeId, string const& _productName)
 	{
 		node->SetProductName(_productName);
 	}
-	WriteCache();
+	WriteCache(_nodeId);
 }
 
 //-----------------------------------------------------------------------------
@@ -4988,7 +6215,7 @@ void Driver::SetNodeName(uint8 const _nodeId, string const& _nodeName)
 	{
 		node->SetNodeName(_nodeName);
 	}
-	WriteCache();
+	WriteCache(_nodeId);
 }
 
 //-----------------------------------------------------------------------------
@@ -5002,7 +6229,7 @@ void Driver::SetNodeLocation(uint8 const _nodeId, string const& _location)
 	{
 		node->SetLocation(_location);
 	}
-	WriteCache();
+	WriteCache(_nodeId);
 }
 
 //-----------------------------------------------------------------------------
@@ -5697,6 +6924,7 @@ void Driver::SwitchAllOn()
 	Internal::CC::SwitchAll::On(this, 0xff);
 
 	Internal::LockGuard LG(m_nodeMutex);
+	BeginMulticast();
 	for (int i = 0; i < 256; ++i)
 	{
 		if (GetNodeUnsafe(i))
@@ -5707,6 +6935,7 @@ void Driver::SwitchAllOn()
 			}
 		}
 	}
+	EndMulticast();
 }
 
 //-----------------------------------------------------------------------------
@@ -5718,6 +6947,7 @@ void Driver::SwitchAllOff()
 	Internal::CC::SwitchAll::Off(this, 0xff);
 
 	Internal::LockGuard LG(m_nodeMutex);
+	BeginMulticast();
 	for (int i = 0; i < 256; ++i)
 	{
 		if (GetNodeUnsafe(i))
@@ -5728,6 +6958,7 @@ void Driver::SwitchAllOff()
 			}
 		}
 	}
+	EndMulticast();
 }
 
 //-----------------------------------------------------------------------------
@@ -5765,7 +6996,7 @@ void Driver::RequestConfigParam(uint8 const _nodeId, uint8 const _param)
 uint8 Driver::GetNumGroups(uint8 const _nodeId)
 {
 	uint8 numGroups = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		numGroups = node->GetNumGroups();
@@ -5781,7 +7012,7 @@ uint8 Driver::GetNumGroups(uint8 const _nodeId)
 uint32 Driver::GetAssociations(uint8 const _nodeId, uint8 const _groupIdx, uint8** o_associations)
 {
 	uint32 numAssociations = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		numAssociations = node->GetAssociations(_groupIdx, o_associations);
@@ -5797,7 +7028,7 @@ uint32 Driver::GetAssociations(uint8 const _nodeId, uint8 const _groupIdx, uint8
 uint32 Driver::GetAssociations(uint8 const _nodeId, uint8 const _groupIdx, InstanceAssociation** o_associations)
 {
 	uint32 numAssociations = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		numAssociations = node->GetAssociations(_groupIdx, o_associations);
@@ -5813,7 +7044,7 @@ uint32 Driver::GetAssociations(uint8 const _nodeId, uint8 const _groupIdx, Insta
 uint8 Driver::GetMaxAssociations(uint8 const _nodeId, uint8 const _groupIdx)
 {
 	uint8 maxAssociations = 0;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		maxAssociations = node->GetMaxAssociations(_groupIdx);
@@ -5829,7 +7060,7 @@ uint8 Driver::GetMaxAssociations(uint8 const _nodeId, uint8 const _groupIdx)
 bool Driver::IsMultiInstance(uint8 const _nodeId, uint8 const _groupIdx)
 {
 	bool multiInstance = false;
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		multiInstance = node->IsMultiInstance(_groupIdx);
@@ -5844,7 +7075,7 @@ bool Driver::IsMultiInstance(uint8 const _nodeId, uint8 const _groupIdx)
 string Driver::GetGroupLabel(uint8 const _nodeId, uint8 const _groupIdx)
 {
 	string label = "";
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	if (Node* node = GetNode(_nodeId))
 	{
 		label = node->GetGroupLabel(_groupIdx);
@@ -5885,6 +7116,24 @@ void Driver::RemoveAssociation(uint8 const _nodeId, uint8 const _groupIdx, uint8
 //-----------------------------------------------------------------------------
 void Driver::QueueNotification(Notification* _notification)
 {
+	Internal::LockGuard LG(m_notificationsMutex);
+	if (m_coalesceValueNotifications && ((_notification->GetType() == Notification::Type_ValueChanged) || (_notification->GetType() == Notification::Type_ValueRefreshed)))
+	{
+		map<ValueID, Notification*>::iterator it = m_pendingValueNotifications.find(_notification->GetValueID());
+		if (it != m_pendingValueNotifications.end())
+		{
+			// The watchers read the value itself, so one notification is enough.
+			// Remember whether any of the merged ones reported a change.
+			if (_notification->GetType() == Notification::Type_ValueChanged)
+			{
+				it->second->m_type = Notification::Type_ValueChanged;
+			}
+			delete _notification;
+			m_coalescedNotifications++;
+			return;
+		}
+		m_pendingValueNotifications[_notification->GetValueID()] = _notification;
+	}
 	m_notifications.push_back(_notification);
 	m_notificationsEvent->Set();
 }
@@ -5895,11 +7144,18 @@ void Driver::QueueNotification(Notification* _notification)
 //-----------------------------------------------------------------------------
 void Driver::NotifyWatchers()
 {
-	list<Notification*>::iterator nit = m_notifications.begin();
-	while (nit != m_notifications.end())
+	list<Notification*> notifications;
 	{
-		Notification* notification = m_notifications.front();
-		m_notifications.pop_front();
+		Internal::LockGuard LG(m_notificationsMutex);
+		notifications.swap(m_notifications);
+		m_pendingValueNotifications.clear();
+		m_notificationsEvent->Reset();
+	}
+
+	while (!notifications.empty())
+	{
+		Notification* notification = notifications.front();
+		notifications.pop_front();
 
 		/* check the any ValueID's sent as part of the Notification are still valid */
 		switch (notification->GetType())
@@ -5912,7 +7168,6 @@ void Driver::NotifyWatchers()
 				if (!val)
 				{
 					Log::Write(LogLevel_Info, notification->GetNodeId(), "Dropping Notification as ValueID does not exist");
-					nit = m_notifications.begin();
 					delete notification;
 					continue;
 				}
@@ -5922,14 +7177,14 @@ void Driver::NotifyWatchers()
 			default:
 				break;
 		}
-		Log::Write(LogLevel_Detail, notification->GetNodeId(), "Notification: %s", notification->GetAsString().c_str());
-
-		Manager::Get()->NotifyWatchers(notification);
+		if (Log::IsLevelEnabled(LogLevel_Detail))
+		{
+			Log::Write(LogLevel_Detail, notification->GetNodeId(), "Notification: %s", notification->GetAsString().c_str());
+		}
 
-		delete notification;
-		nit = m_notifications.begin();
+		// The Manager owns the notification from here on
+		Manager::Get()->PostNotification(notification);
 	}
-	m_notificationsEvent->Reset();
 }
 
 //-----------------------------------------------------------------------------
@@ -6072,7 +7327,7 @@ void Driver::SendVirtualNodeInfo(uint8 const _FromNodeId, uint8 const _ToNodeId)
 	char str[80];
 
 	snprintf(str, sizeof(str), "Send Virtual Node Info from %d to %d", _FromNodeId, _ToNodeId);
-	Internal::Msg* msg = new Internal::Msg(str, 0xff, REQUEST, FUNC_ID_ZW_SEND_SLAVE_NODE_INFO, true);
+	Internal::Msg* msg = new Internal::Msg(string(str), 0xff, REQUEST, FUNC_ID_ZW_SEND_SLAVE_NODE_INFO, true);
 	msg->Append(_FromNodeId);		// from the virtual node
 	msg->Append(_ToNodeId);		// to the handheld controller
 	msg->Append( TRANSMIT_OPTION_ACK);
@@ -6553,6 +7808,16 @@ void Driver::GetDriverStatistics(DriverData* _data)
 	_data->m_routedbusy = m_routedbusy;
 	_data->m_broadcastReadCnt = m_broadcastReadCnt;
 	_data->m_broadcastWriteCnt = m_broadcastWriteCnt;
+	_data->m_coalescedSets = m_coalescedSets;
+	_data->m_coalescedGets = m_coalescedGets;
+	_data->m_coalescedNotifications = m_coalescedNotifications;
+
+	Internal::Msg::GetPoolStatistics(&_data->m_msgAllocations, &_data->m_msgHeapAllocations, &_data->m_msgsInUse);
+	uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+	uint64 elapsed = now - m_msgStatsTime;
+	_data->m_msgAllocationsPerSec = elapsed ? (uint32) ((uint64) (_data->m_msgAllocations - m_msgStatsAllocations) * 1000 / elapsed) : 0;
+	m_msgStatsTime = now;
+	m_msgStatsAllocations = _data->m_msgAllocations;
 }
 
 //-----------------------------------------------------------------------------
@@ -6561,7 +7826,7 @@ void Driver::GetDriverStatistics(DriverData* _data)
 //-----------------------------------------------------------------------------
 void Driver::GetNodeStatistics(uint8 const _nodeId, Node::NodeData* _data)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	Node* node = GetNode(_nodeId);
 	if (node != NULL)
 	{
@@ -6569,6 +7834,34 @@ void Driver::GetNodeStatistics(uint8 const _nodeId, Node::NodeData* _data)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::GetNodeLatencyStats>
+// Return the latency percentiles of a node
+//-----------------------------------------------------------------------------
+void Driver::GetNodeLatencyStats(uint8 const _nodeId, Node::NodeLatencyStats* _data)
+{
+	Internal::ReadLockGuard LG(m_nodeMutex);
+	Node* node = GetNode(_nodeId);
+	if (node != NULL)
+	{
+		node->GetNodeLatencyStats(_data);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ResetNodeLatencyStats>
+// Empty the latency histograms of a node
+//-----------------------------------------------------------------------------
+void Driver::ResetNodeLatencyStats(uint8 const _nodeId)
+{
+	Internal::ReadLockGuard LG(m_nodeMutex);
+	Node* node = GetNode(_nodeId);
+	if (node != NULL)
+	{
+		node->ResetNodeLatencyStats();
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::LogDriverStatistics>
 // Report driver statistics to the driver's log
@@ -6595,6 +7888,12 @@ void Driver::LogDriverStatistics()
 	Log::Write(LogLevel_Always, "Total messages successfully received: . . . . . . . . . . %ld", data.m_readCnt);
 	Log::Write(LogLevel_Always, "Total Messages successfully sent: . . . . . . . . . . . . %ld", data.m_writeCnt);
 	Log::Write(LogLevel_Always, "ACKs received from controller:  . . . . . . . . . . . . . %ld", data.m_ACKCnt);
+	Log::Write(LogLevel_Always, "Queued Sets replaced by a newer Set:  . . . . . . . . . . %ld", data.m_coalescedSets);
+	Log::Write(LogLevel_Always, "Duplicate Gets dropped: . . . . . . . . . . . . . . . . . %ld", data.m_coalescedGets);
+	Log::Write(LogLevel_Always, "Value notifications merged: . . . . . . . . . . . . . . . %ld", data.m_coalescedNotifications);
+	Log::Write(LogLevel_Always, "Messages allocated (all drivers): . . . . . . . . . . . . %ld", data.m_msgAllocations);
+	Log::Write(LogLevel_Always, "Message pool heap allocations:  . . . . . . . . . . . . . %ld", data.m_msgHeapAllocations);
+	Log::Write(LogLevel_Always, "Messages allocated per second:  . . . . . . . . . . . . . %ld", data.m_msgAllocationsPerSec);
 	// Consider tracking and adding:
 	//		Initialization messages
 	//		Ad-hoc command messages
@@ -6668,7 +7967,11 @@ bool Driver::SendEncryptedMessage()
 	uint8 *buffer = m_currentMsg->GetBuffer();
 	uint8 length = m_currentMsg->GetLength();
 	m_expectedCallbackId = m_currentMsg->GetCallbackId();
-	Log::Write(LogLevel_Info, m_currentMsg->GetTargetNodeId(), "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str());
+	if (Log::IsLevelEnabled(LogLevel_Info))
+	{
+		char msgStr[1024];
+		Log::Write(LogLevel_Info, m_currentMsg->GetTargetNodeId(), "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString(msgStr, sizeof(msgStr)));
+	}
 
 	m_controller->Write(buffer, length);
 	m_currentMsg->clearNonce();
@@ -6676,7 +7979,7 @@ bool Driver::SendEncryptedMessage()
 	return true;
 }
 
-bool Driver::SendNonceRequest(string logmsg)
+bool Driver::SendNonceRequest(string const& logmsg)
 {
 
 	uint8 m_buffer[11];
@@ -6701,14 +8004,18 @@ bool Driver::SendNonceRequest(string logmsg)
 	{
 		m_buffer[10] ^= m_buffer[i];
 	}
-	Log::Write(LogLevel_Info, m_currentMsg->GetTargetNodeId(), "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - Nonce_Get(%s) - %s:", c_sendQueueNames[m_currentMsgQueueSource], 2, m_expectedReply, logmsg.c_str(), Internal::PktToString(m_buffer, 10).c_str());
+	if (Log::IsLevelEnabled(LogLevel_Info))
+	{
+		char pktStr[128];
+		Log::Write(LogLevel_Info, m_currentMsg->GetTargetNodeId(), "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - Nonce_Get(%s) - %s:", c_sendQueueNames[m_currentMsgQueueSource], 2, m_expectedReply, logmsg.c_str(), Internal::PktToString(m_buffer, 10, pktStr, sizeof(pktStr)));
+	}
 
 	m_controller->Write(m_buffer, 11);
 
 	return true;
 }
 
-bool Driver::initNetworkKeys(bool newnode)
+bool Driver::initNetworkKeys()
 {
 
 	uint8_t EncryptPassword[16] =
@@ -6719,11 +8026,8 @@ bool Driver::initNetworkKeys(bool newnode)
 	uint8_t SecuritySchemes[1][16] =
 	{
 	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } };
-	this->m_inclusionkeySet = newnode;
-	this->AuthKey = new aes_encrypt_ctx;
-	this->EncryptKey = new aes_encrypt_ctx;
 
-	Log::Write(LogLevel_Info, GetControllerNodeId(), "Setting Up %s Network Key for Secure Communications", newnode == true ? "Inclusion" : "Provided");
+	Log::Write(LogLevel_Info, GetControllerNodeId(), "Setting Up Provided and Inclusion Network Keys for Secure Communications");
 
 	if (!isNetworkKeySet())
 	{
@@ -6731,54 +8035,22 @@ bool Driver::initNetworkKeys(bool newnode)
 		return false;
 	}
 
-	if (aes_init() == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Init AES Engine");
-		return false;
-	}
-
-	if (aes_encrypt_key128(newnode == false ? this->GetNetworkKey() : SecuritySchemes[0], this->EncryptKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Set Initial Network Key for Encryption");
-		return false;
-	}
-
-	if (aes_encrypt_key128(newnode == false ? this->GetNetworkKey() : SecuritySchemes[0], this->AuthKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Set Initial Network Key for Authentication");
-		return false;
-	}
-
-	uint8 tmpEncKey[32];
-	uint8 tmpAuthKey[32];
-	aes_mode_reset(this->EncryptKey);
-	aes_mode_reset(this->AuthKey);
+	/* The encryption and authentication keys are the passwords encrypted with the network key */
+	uint8 tmpEncKey[16];
+	uint8 tmpAuthKey[16];
+	Internal::AesKey networkKey(this->GetNetworkKey());
+	networkKey.Encrypt(EncryptPassword, tmpEncKey);
+	networkKey.Encrypt(AuthPassword, tmpAuthKey);
+	m_encKey.SetKey(tmpEncKey);
+	m_authKey.SetKey(tmpAuthKey);
 
-	if (aes_ecb_encrypt(EncryptPassword, tmpEncKey, 16, this->EncryptKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Generate Encrypted Network Key for Encryption");
-		return false;
-	}
-	if (aes_ecb_encrypt(AuthPassword, tmpAuthKey, 16, this->AuthKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to Generate Encrypted Network Key for Authentication");
-		return false;
-	}
+	Internal::AesKey inclusionKey(SecuritySchemes[0]);
+	inclusionKey.Encrypt(EncryptPassword, tmpEncKey);
+	inclusionKey.Encrypt(AuthPassword, tmpAuthKey);
+	m_inclusionEncKey.SetKey(tmpEncKey);
+	m_inclusionAuthKey.SetKey(tmpAuthKey);
 
-	aes_mode_reset(this->EncryptKey);
-	aes_mode_reset(this->AuthKey);
-	if (aes_encrypt_key128(tmpEncKey, this->EncryptKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to set Encrypted Network Key for Encryption");
-		return false;
-	}
-	if (aes_encrypt_key128(tmpAuthKey, this->AuthKey) == EXIT_FAILURE)
-	{
-		Log::Write(LogLevel_Warning, GetControllerNodeId(), "Failed to set Encrypted Network Key for Authentication");
-		return false;
-	}
-	aes_mode_reset(this->EncryptKey);
-	aes_mode_reset(this->AuthKey);
+	Log::Write(LogLevel_Info, GetControllerNodeId(), "Using %s AES", Internal::AesKey::GetBackendName(Internal::AesKey::GetBackend()));
 	return true;
 }
 
@@ -6808,42 +8080,32 @@ void Driver::SendNonceKey(uint8 nodeId, uint8 *nonce)
 	{
 		m_buffer[18] ^= m_buffer[i];
 	}
-	Log::Write(LogLevel_Info, nodeId, "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - Nonce_Report - %s:", c_sendQueueNames[m_currentMsgQueueSource], m_buffer[17], m_expectedReply, Internal::PktToString(m_buffer, 19).c_str());
+	if (Log::IsLevelEnabled(LogLevel_Info))
+	{
+		char pktStr[192];
+		Log::Write(LogLevel_Info, nodeId, "Sending (%s) message (Callback ID=0x%.2x, Expected Reply=0x%.2x) - Nonce_Report - %s:", c_sendQueueNames[m_currentMsgQueueSource], m_buffer[17], m_expectedReply, Internal::PktToString(m_buffer, 19, pktStr, sizeof(pktStr)));
+	}
 
 	m_controller->Write(m_buffer, 19);
 
 	m_nonceReportSent = nodeId;
 }
 
-aes_encrypt_ctx *Driver::GetAuthKey()
+bool Driver::UseInclusionKeys()
 {
-	if (m_currentControllerCommand != NULL && m_currentControllerCommand->m_controllerCommand == ControllerCommand_AddDevice && m_currentControllerCommand->m_controllerState == ControllerState_Completed)
-	{
-		/* we are adding a Node, so our AuthKey is different from normal comms */
-		initNetworkKeys(true);
-	}
-	else if (m_inclusionkeySet)
-	{
-		initNetworkKeys(false);
-	}
-	return this->AuthKey;
+	/* we are adding a Node, so our keys are different from normal comms */
+	return m_currentControllerCommand != NULL && m_currentControllerCommand->m_controllerCommand == ControllerCommand_AddDevice && m_currentControllerCommand->m_controllerState == ControllerState_Completed;
 }
-;
-aes_encrypt_ctx *Driver::GetEncKey()
+
+Internal::AesKey const& Driver::GetAuthKey()
 {
-	if (m_currentControllerCommand != NULL && m_currentControllerCommand->m_controllerCommand == ControllerCommand_AddDevice && m_currentControllerCommand->m_controllerState == ControllerState_Completed)
-	{
-		/* we are adding a Node, so our EncryptKey is different from normal comms */
-		initNetworkKeys(true);
-	}
-	else if (m_inclusionkeySet)
-	{
-		initNetworkKeys(false);
-	}
+	return UseInclusionKeys() ? m_inclusionAuthKey : m_authKey;
+}
 
-	return this->EncryptKey;
+Internal::AesKey const& Driver::GetEncKey()
+{
+	return UseInclusionKeys() ? m_inclusionEncKey : m_encKey;
 }
-;
 
 bool Driver::isNetworkKeySet()
 {
@@ -7246,7 +8508,7 @@ void Driver::ProcessEventMsg()
 //-----------------------------------------------------------------------------
 string const Driver::GetMetaData(uint8 const _nodeId, Node::MetaDataFields _metadata)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	Node* node = GetNode(_nodeId);
 	if (node != NULL)
 	{
@@ -7261,7 +8523,7 @@ string const Driver::GetMetaData(uint8 const _nodeId, Node::MetaDataFields _meta
 //-----------------------------------------------------------------------------
 Node::ChangeLogEntry const Driver::GetChangeLog(uint8 const _nodeId, uint32_t revision)
 {
-	Internal::LockGuard LG(m_nodeMutex);
+	Internal::ReadLockGuard LG(m_nodeMutex);
 	Node* node = GetNode(_nodeId);
 	if (node != NULL)
 	{
@@ -31,6 +31,8 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
+#include <thread>
 
 #include "Defs.h"
 #include "Group.h"
@@ -38,9 +40,10 @@
 #include "Node.h"
 #include "platform/Event.h"
 #include "platform/Mutex.h"
+#include "platform/SharedMutex.h"
 #include "platform/Thread.h"
 #include "platform/TimeStamp.h"
-#include "aes/aescpp.h"
+#include "AesKey.h"
 
 namespace OpenZWave
 {
@@ -64,6 +67,7 @@ namespace OpenZWave
 		{
 			class Value;
 			class ValueStore;
+			class ValueSnapshotTable;
 		}
 		namespace Platform
 		{
@@ -112,7 +116,8 @@ namespace OpenZWave
 			{
 				ControllerInterface_Unknown = 0,
 				ControllerInterface_Serial,
-				ControllerInterface_Hid
+				ControllerInterface_Hid,
+				ControllerInterface_Virtual /**< A simulated network in this process.  The path describes the network, see Internal::Platform::VirtualNetwork. */
 			};
 
 			//-----------------------------------------------------------------------------
@@ -194,7 +199,23 @@ namespace OpenZWave
 		private:
 			void RequestConfig();							// Get the network configuration from the Z-Wave network
 			bool ReadCache();								// Read the configuration from a file
-			void WriteCache();								// Save the configuration to a file
+			void WriteCache();								// Schedule a save of the configuration of every node
+			void WriteCache(uint8 const _nodeId);			// Schedule a save after the configuration of one node changed
+			void MarkCacheDirty(uint8 const _nodeId);		// Have the next save serialize a node again, without scheduling one
+			void SaveCache();								// Save the configuration to a file now
+			bool IsBinaryCacheFormat();						// Whether the CacheFormat option selects the binary cache
+
+			static void CacheThreadEntryPoint(Internal::Platform::Event* _exitEvent, void* _context);
+			void CacheThreadProc(Internal::Platform::Event* _exitEvent);
+			void ScheduleCacheSave();
+
+			Internal::Platform::Thread* m_cacheThread;						// Thread that writes the cache file to disk
+			Internal::Platform::Event* m_cacheEvent;						// Signalled when a cache save has been scheduled
+			Internal::Platform::Mutex* m_cacheDirtyMutex;					// Serializes access to m_cacheDirty and m_cacheDue
+			Internal::Platform::Mutex* m_cacheMutex;						// Serializes cache saves and access to m_cacheNodes
+			bool m_cacheDirty[256];											// Nodes whose configuration changed since the last save
+			uint64 m_cacheDue;												// Monotonic time the next save is due, or zero when none is pending
+			vector<uint8> m_cacheNodes[256];								// Each node as written by the last save, encoded by BinaryCache or printed as XML
 
 			//-----------------------------------------------------------------------------
 			//	Timer
@@ -344,7 +365,8 @@ namespace OpenZWave
 			bool m_hasExtendedTxStatus;						// True if the controller accepted SERIAL_API_SETUP_CMD_TX_STATUS_REPORT
 			uint8 m_Controller_nodeId;						// Z-Wave Controller's own node ID.
 			Node* m_nodes[256];								// Array containing all the node objects.
-			Internal::Platform::Mutex* m_nodeMutex;								// Serializes access to node data
+			Internal::Platform::SharedMutex* m_nodeMutex;						// Guards the node data.  Readers take it shared, anything that changes a node takes it exclusively
+			Internal::VC::ValueSnapshotTable* m_valueSnapshots;					// Copies of every value, for readers that do not take m_nodeMutex
 
 			Internal::CC::ControllerReplication* m_controllerReplication;					// Controller replication is handled separately from the other command classes, due to older hand-held controllers using invalid node IDs.
 
@@ -399,7 +421,7 @@ namespace OpenZWave
 			void HandleRemoveFailedNodeRequest(uint8* _data);
 			void HandleReplaceFailedNodeRequest(uint8* _data);
 			void HandleRemoveNodeFromNetworkRequest(uint8* _data);
-			void HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted);
+			void HandleApplicationCommandHandlerRequest(uint8* _data, bool encrypted, bool _reply);
 			void HandlePromiscuousApplicationCommandHandlerRequest(uint8* _data);
 			void HandleAssignReturnRouteRequest(uint8* _data);
 			void HandleDeleteReturnRouteRequest(uint8* _data);
@@ -434,27 +456,64 @@ namespace OpenZWave
 			{
 				return m_pollInterval;
 			}
-			void SetPollInterval(int32 _milliseconds, bool _bIntervalBetweenPolls)
-			{
-				m_pollInterval = _milliseconds;
-				m_bIntervalBetweenPolls = _bIntervalBetweenPolls;
-			}
+			void SetPollInterval(int32 _milliseconds, bool _bIntervalBetweenPolls);
 			bool EnablePoll(const ValueID &_valueId, uint8 _intensity = 1);
 			bool DisablePoll(const ValueID &_valueId);
 			bool isPolled(const ValueID &_valueId);
 			void SetPollIntensity(const ValueID &_valueId, uint8 _intensity);
 			static void PollThreadEntryPoint(Internal::Platform::Event* _exitEvent, void* _context);
 			void PollThreadProc(Internal::Platform::Event* _exitEvent);
+			void PollValue(ValueID const& _valueId);
+			bool SendQueuesIdle();
+			uint32 GetPollSpacing();
+			void SchedulePoll(ValueID const& _valueId, uint64 _due);
+
+		public:
+			struct PollStatistics
+			{
+					uint32 m_polls;				// Number of times the value has been polled
+					uint32 m_period;			// Interval the value is scheduled to be polled at (ms)
+					uint32 m_lastLatency;		// How long after its due time the last poll was sent (ms)
+					uint32 m_averageLatency;	// Average poll latency (ms)
+					uint32 m_maxLatency;		// Largest poll latency (ms)
+					uint32 m_lastInterval;		// Time between the last two polls (ms)
+					uint32 m_averageJitter;		// Average difference between the time between polls and m_period (ms)
+					uint32 m_maxJitter;			// Largest difference between the time between polls and m_period (ms)
+			};
+
+		private:
+			bool GetPollStatistics(ValueID const& _valueId, PollStatistics* _data);
 
 			Internal::Platform::Thread* m_pollThread;								// Thread for polling devices on the Z-Wave network
 			struct PollEntry
 			{
+					uint64 m_due;				// Monotonic time (ms) at which the value is next due to be polled
+					uint32 m_generation;		// Matches the heap item that is currently valid for this value
+					uint64 m_lastPoll;			// Monotonic time of the previous poll, zero if not polled yet
+					uint64 m_totalLatency;
+					uint64 m_totalJitter;
+					PollStatistics m_stats;
+			};
+			struct PollHeapItem
+			{
+					uint64 m_due;
+					uint32 m_generation;
 					ValueID m_id;
-					uint8 m_pollCounter;
+					// std heaps keep the largest item at the front, so order by reverse due time
+					bool operator <(PollHeapItem const& _other) const
+					{
+						return m_due > _other.m_due;
+					}
 			};
-			list<PollEntry> m_pollList;									// List of nodes that need to be polled
+			map<ValueID, PollEntry> m_pollEntries;						// Values that need to be polled
+			vector<PollHeapItem> m_pollHeap;							// Min-heap of pending polls.  Items for disabled or rescheduled values are skipped when they reach the front
+			uint32 m_pollGeneration;									// Source of PollEntry::m_generation
+			uint64 m_lastPollTime;										// Monotonic time of the last poll sent
 			Internal::Platform::Mutex* m_pollMutex;								// Serialize access to the polling list
+			Internal::Platform::Event* m_pollEvent;								// Signalled when the poll schedule changes
+			Internal::Platform::Event* m_sendQueuesIdleEvent;					// Signalled by the driver thread when there are no messages waiting to be sent
 			int32 m_pollInterval;								// Time interval during which all nodes must be polled
+			uint32 m_pollIntervalMs;							// m_pollInterval in ms, once a legacy setting in seconds has been converted
 			bool m_bIntervalBetweenPolls;					// if true, the library intersperses m_pollInterval between polls; if false, the library attempts to complete all polls within m_pollInterval
 
 			//-----------------------------------------------------------------------------
@@ -670,6 +729,19 @@ namespace OpenZWave
 
 			void SendMsg(Internal::Msg* _msg, MsgQueue const _queue);
 
+			/**
+			 * Start collecting the messages the calling thread sends on MsgQueue_Send.  When the
+			 * matching EndMulticast is called, sets with the same payload for several nodes
+			 * are sent as one FUNC_ID_ZW_SEND_DATA_MULTI frame, and then everything collected
+			 * is queued in its original order.  Calls may be nested.
+			 */
+			void BeginMulticast();
+
+			/**
+			 * Send the messages collected since BeginMulticast.  Only the outermost call sends anything.
+			 */
+			void EndMulticast();
+
 			/**
 			 * Fetch the transmit options
 			 */
@@ -797,6 +869,52 @@ namespace OpenZWave
 			MsgQueue m_currentMsgQueueSource;			// identifies which queue held m_currentMsg
 			Internal::Platform::TimeStamp m_resendTimeStamp;
 
+			// A request that a node has acknowledged, but not yet replied to.  While
+			// it waits here, messages to other nodes can be sent.
+			struct OutstandingRequest
+			{
+					Internal::Msg* m_msg;
+					MsgQueue m_queue;				// Queue the message came from, and goes back to if the reply times out
+					uint64 m_deadline;				// Monotonic time in ms at which the reply is given up on
+			};
+			list<OutstandingRequest> m_outstandingRequests;		// Only used by the driver thread
+			uint32 m_maxOutstandingRequests;
+
+			bool ParkCurrentMsg();
+			bool CompleteOutstandingRequest(uint8 const _nodeId, uint8 const _commandClassId);
+			void ExpireOutstandingRequests();
+			void RemoveOutstandingRequests(uint8 const _nodeId);
+			bool IsAwaitingReply(uint8 const _nodeId) const;
+			int32 GetOutstandingTimeout() const;
+			bool SelectNextMsg(MsgQueue const _queue);				// Move the first item that may be sent now to the front of the queue.  Call with m_sendMutex held.
+
+			// Query work is held back per node and released into MsgQueue_Query for a few
+			// nodes at a time, choosing the nodes whose current stage matters most to the
+			// application first and taking turns between nodes of the same priority.
+			list<MsgQueueItem> m_queryPending[256];
+			uint8 m_queryPriority[256];				// Priority of the work held for each node, lower goes first
+			uint64 m_queryBoostUntil[256];			// Monotonic time in ms until which a node the application has used goes first
+			uint8 m_lastQueryNode;					// Node released most recently, where the round robin carries on from
+			uint32 m_maxQueryNodes;					// Nodes that may be served at once, or zero for no limit
+			uint32 m_queryWork[256];				// Items in MsgQueue_Query for each node, counting a message of it that is being sent or is waiting for its reply
+			uint32 m_queryActiveNodes;				// Nodes with query work
+			uint32 m_queryPendingNodes;				// Nodes with work in m_queryPending
+
+			void QueueQueryItem(MsgQueueItem const& _item, uint8 const _nodeId, uint8 const _priority);		// Call with m_sendMutex held
+			void ReleaseQueryItems(uint8 const _nodeId);		// Call with m_sendMutex held
+			void ScheduleQueries();								// Call with m_sendMutex held
+			bool IsQueryNodeActive(uint8 const _nodeId) const;	// Call with m_sendMutex held
+			void AddQueryWork(uint8 const _nodeId, uint32 const _count = 1);	// Call with m_sendMutex held
+			void RemoveQueryWork(uint8 const _nodeId);
+
+			bool CoalesceMsg(Internal::Msg* _msg, MsgQueue const _queue);		// Merge a message with a queued one that it supersedes or duplicates.  Call with m_sendMutex held.
+			void SendMulticast(list<pair<Internal::Msg*, bool> > const& _msgs);	// Group the messages collected by a multicast batch and queue them
+
+			Internal::Platform::Mutex* m_multicastMutex;					// Serializes access to the multicast batch
+			std::thread::id m_multicastThread;								// Thread that owns the current multicast batch
+			uint32 m_multicastDepth;										// Nesting depth of BeginMulticast calls, zero when no batch is open
+			list<pair<Internal::Msg*, bool> > m_multicastMsgs;				// Messages held back by the current batch, and whether each may be multicast
+
 			//-----------------------------------------------------------------------------
 			// Network functions
 			//-----------------------------------------------------------------------------
@@ -861,9 +979,12 @@ namespace OpenZWave
 			//-----------------------------------------------------------------------------
 		private:
 			void QueueNotification(Notification* _notification);				// Adds a notification to the list.  Notifications are queued until a point in the thread where we know we do not have any nodes locked.
-			void NotifyWatchers();												// Passes the notifications to all the registered watcher callbacks in turn.
+			void NotifyWatchers();												// Hands the queued notifications to the Manager, which delivers them to the watchers.
 			list<Notification*> m_notifications;
+			Internal::Platform::Mutex* m_notificationsMutex;					// Guards m_notifications, as notifications are queued from several threads
 			Internal::Platform::Event* m_notificationsEvent;
+			bool m_coalesceValueNotifications;									// Merge queued ValueChanged and ValueRefreshed notifications for the same value (CoalesceValueNotifications option)
+			map<ValueID, Notification*> m_pendingValueNotifications;			// The queued ValueChanged or ValueRefreshed notification of each value, when coalescing
 
 			//-----------------------------------------------------------------------------
 			//	Statistics
@@ -893,12 +1014,21 @@ namespace OpenZWave
 					uint32 m_routedbusy;		// Number of messages received with routed busy status
 					uint32 m_broadcastReadCnt;	// Number of broadcasts read
 					uint32 m_broadcastWriteCnt;	// Number of broadcasts sent
+					uint32 m_coalescedSets;		// Number of queued Set messages replaced by a newer Set
+					uint32 m_coalescedGets;		// Number of Get messages dropped as duplicates of a queued Get
+					uint32 m_coalescedNotifications;	// Number of value notifications merged into one already queued for the same value
+					uint32 m_msgAllocations;	// Number of messages allocated by all drivers since startup
+					uint32 m_msgHeapAllocations;	// Number of times the message pool had to get memory from the heap
+					uint32 m_msgsInUse;			// Number of messages that currently exist
+					uint32 m_msgAllocationsPerSec;	// Messages allocated per second since the previous call to GetDriverStatistics
 			};
 			void LogDriverStatistics();
 
 		private:
 			void GetDriverStatistics(DriverData* _data);
 			void GetNodeStatistics(uint8 const _nodeId, Node::NodeData* _data);
+			void GetNodeLatencyStats(uint8 const _nodeId, Node::NodeLatencyStats* _data);
+			void ResetNodeLatencyStats(uint8 const _nodeId);
 
 			uint32 m_SOFCnt;			// Number of SOF bytes received
 			uint32 m_ACKWaiting;		// Number of unsolicited messages while waiting for an ACK
@@ -922,6 +1052,11 @@ namespace OpenZWave
 			uint32 m_routedbusy;		// Number of messages received with routed busy status
 			uint32 m_broadcastReadCnt;	// Number of broadcasts read
 			uint32 m_broadcastWriteCnt;	// Number of broadcasts sent
+			uint32 m_coalescedSets;		// Number of queued Set messages replaced by a newer Set
+			uint32 m_coalescedGets;		// Number of Get messages dropped as duplicates of a queued Get
+			uint32 m_coalescedNotifications;	// Number of value notifications merged into one already queued for the same value
+			uint64 m_msgStatsTime;		// When GetDriverStatistics last sampled the message pool
+			uint32 m_msgStatsAllocations;	// Message allocations at that time
 			//time_t m_commandStart;	// Start time of last command
 			//time_t m_timeoutLost;		// Cumulative time lost to timeouts
 
@@ -929,21 +1064,24 @@ namespace OpenZWave
 			//	Security Command Class Related (Version 1.1)
 			//-----------------------------------------------------------------------------
 		public:
-			aes_encrypt_ctx *GetAuthKey();
-			aes_encrypt_ctx *GetEncKey();
+			Internal::AesKey const& GetAuthKey();
+			Internal::AesKey const& GetEncKey();
 			bool isNetworkKeySet();
 
 		private:
-			bool initNetworkKeys(bool newnode);
+			bool initNetworkKeys();
+			bool UseInclusionKeys();
 			uint8 *GetNetworkKey();
 			bool SendEncryptedMessage();
-			bool SendNonceRequest(string logmsg);
+			bool SendNonceRequest(string const& logmsg);
 			void SendNonceKey(uint8 nodeId, uint8 *nonce);
-			aes_encrypt_ctx *AuthKey;
-			aes_encrypt_ctx *EncryptKey;
+			// Both pairs of keys are expanded once, when the driver starts
+			Internal::AesKey m_authKey;
+			Internal::AesKey m_encKey;
+			Internal::AesKey m_inclusionAuthKey;	// Used while a node is being added, with a key of all zeros
+			Internal::AesKey m_inclusionEncKey;
 			uint8 m_nonceReportSent;
 			uint8 m_nonceReportSentAttempt;
-			bool m_inclusionkeySet;
 
 			//-----------------------------------------------------------------------------
 			//	Event Signaling for DNS and HTTP Threads
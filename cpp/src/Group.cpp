@@ -383,9 +383,7 @@ void Group::OnGroupChanged(vector<InstanceAssociation> const& _associations)
 		notification->SetGroupIdx(m_groupIdx);
 		Manager::Get()->GetDriver(m_homeId)->QueueNotification(notification);
 		// Update routes on remote node if necessary
-		bool update = false;
-		Options::Get()->GetOptionAsBool("PerformReturnRoutes", &update);
-		if (update)
+		if (Options::Get()->GetValues().m_PerformReturnRoutes)
 		{
 			Driver *drv = Manager::Get()->GetDriver(m_homeId);
 			if (drv)
@@ -0,0 +1,159 @@
+//-----------------------------------------------------------------------------
+//
+//	LatencyHistogram.cpp
+//
+//	Fixed size histogram of latencies with logarithmic buckets
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <cstring>
+
+#include "LatencyHistogram.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::LatencyHistogram>
+// Constructor
+//-----------------------------------------------------------------------------
+		LatencyHistogram::LatencyHistogram()
+		{
+			Reset();
+		}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::Record>
+// Count one latency
+//-----------------------------------------------------------------------------
+		void LatencyHistogram::Record(uint32 const _us)
+		{
+			++m_buckets[GetBucket(_us)];
+			++m_count;
+			m_sum += _us;
+			if (_us > m_max)
+			{
+				m_max = _us;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::Reset>
+// Forget everything recorded so far
+//-----------------------------------------------------------------------------
+		void LatencyHistogram::Reset()
+		{
+			memset(m_buckets, 0, sizeof(m_buckets));
+			m_count = 0;
+			m_max = 0;
+			m_sum = 0;
+		}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetMean>
+// Average of the recorded values
+//-----------------------------------------------------------------------------
+		uint32 LatencyHistogram::GetMean() const
+		{
+			return m_count ? (uint32) (m_sum / m_count) : 0;
+		}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetPercentile>
+// Walk the buckets until the requested share of the values has been seen
+//-----------------------------------------------------------------------------
+		uint32 LatencyHistogram::GetPercentile(double const _percentile) const
+		{
+			if (!m_count)
+			{
+				return 0;
+			}
+
+			// Rank of the value we want, counting from one
+			uint64 rank = (uint64) (_percentile * m_count / 100.0 + 0.999999);
+			if (rank < 1)
+			{
+				rank = 1;
+			}
+
+			uint64 seen = 0;
+			for (uint32 i = 0; i < c_bucketCount; ++i)
+			{
+				seen += m_buckets[i];
+				if (seen >= rank)
+				{
+					uint32 limit = GetBucketLimit(i);
+					return limit < m_max ? limit : m_max;
+				}
+			}
+			return m_max;
+		}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetBucket>
+// Index of the bucket a value is counted in
+//-----------------------------------------------------------------------------
+		uint32 LatencyHistogram::GetBucket(uint32 const _us)
+		{
+			uint32 const subBuckets = 1 << c_subBucketBits;
+			if (_us < subBuckets)
+			{
+				return _us;
+			}
+
+			// Position of the highest set bit
+			uint32 exponent = c_subBucketBits;
+			while (exponent < 31 && (_us >> (exponent + 1)))
+			{
+				++exponent;
+			}
+			if (exponent > c_maxExponent)
+			{
+				return c_bucketCount - 1;
+			}
+
+			// The bits just below the highest one pick the bucket within this power of two
+			uint32 sub = (_us >> (exponent - c_subBucketBits)) & (subBuckets - 1);
+			return subBuckets + (exponent - c_subBucketBits) * subBuckets + sub;
+		}
+
+//-----------------------------------------------------------------------------
+// <LatencyHistogram::GetBucketLimit>
+// Largest value counted in a bucket
+//-----------------------------------------------------------------------------
+		uint32 LatencyHistogram::GetBucketLimit(uint32 const _bucket)
+		{
+			uint32 const subBuckets = 1 << c_subBucketBits;
+			if (_bucket < subBuckets)
+			{
+				return _bucket;
+			}
+			if (_bucket == c_bucketCount - 1)
+			{
+				return 0xffffffff;
+			}
+
+			uint32 shift = (_bucket - subBuckets) / subBuckets;
+			uint32 sub = (_bucket - subBuckets) % subBuckets;
+			return ((subBuckets + sub + 1) << shift) - 1;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+//
+//	LatencyHistogram.h
+//
+//	Fixed size histogram of latencies with logarithmic buckets
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _LatencyHistogram_H
+#define _LatencyHistogram_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief Counts latencies in buckets whose width grows with the value.
+		 *
+		 * Values are in microseconds.  Below 8 each value has its own bucket,
+		 * and every power of two above that is split into 8 buckets, so a
+		 * percentile is reported to within 12.5% no matter how large the value
+		 * is.  Values above 2^26 microseconds (about 67 seconds) go in the last
+		 * bucket, though the maximum is kept exactly.  The histogram never
+		 * allocates, which makes it cheap enough to keep several per node.
+		 * Not thread safe.
+		 * \ingroup Main
+		 */
+		class LatencyHistogram
+		{
+			public:
+				LatencyHistogram();
+
+				void Record(uint32 const _us);
+				void Reset();
+
+				uint32 GetCount() const
+				{
+					return m_count;
+				}
+
+				uint32 GetMax() const
+				{
+					return m_max;
+				}
+
+				/**
+				 * \return the mean of the recorded values, or 0 if there are none.
+				 */
+				uint32 GetMean() const;
+
+				/**
+				 * \param _percentile percentage of the recorded values, from 0 to 100.
+				 * \return the upper bound of the bucket holding the value at that
+				 * percentile, but no more than the maximum.  0 if nothing was recorded.
+				 */
+				uint32 GetPercentile(double const _percentile) const;
+
+			private:
+				static uint32 const c_subBucketBits = 3;
+				static uint32 const c_maxExponent = 26;
+				static uint32 const c_bucketCount = (1 << c_subBucketBits) * (c_maxExponent - c_subBucketBits + 2);
+
+				static uint32 GetBucket(uint32 const _us);
+				static uint32 GetBucketLimit(uint32 const _bucket);
+
+				uint32 m_buckets[c_bucketCount];
+				uint32 m_count;
+				uint32 m_max;
+				uint64 m_sum;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_LatencyHistogram_H
@@ -29,6 +29,7 @@
 
 #include "Localization.h"
 #include "tinyxml.h"
+#include "XmlReader.h"
 #include "Options.h"
 #include "platform/Log.h"
 #include "value_classes/ValueBitSet.h"
@@ -246,122 +247,107 @@ namespace OpenZWave
 			Options::Get()->GetOptionAsString("ConfigPath", &configPath);
 
 			string path = configPath + "Localization.xml";
-			TiXmlDocument* pDoc = new TiXmlDocument();
-			if (!pDoc->LoadFile(path.c_str(), TIXML_ENCODING_UTF8))
+			XmlReader reader;
+			if (!reader.Open(path) || !reader.NextChild(0))
 			{
-				Log::Write(LogLevel_Warning, "Unable to load Localization file %s: %s", path.c_str(), pDoc->ErrorDesc());
-				delete pDoc;
+				Log::Write(LogLevel_Warning, "Unable to load Localization file %s: %s", path.c_str(), reader.GetError().c_str());
 				return false;
 			}
-			pDoc->SetUserData((void*) path.c_str());
 			Log::Write(LogLevel_Info, "Loading Localization File %s", path.c_str());
 
-			TiXmlElement const* root = pDoc->RootElement();
-			char const *str = root->Value();
-			if (str && !strcmp(str, "Localization"))
+			if (reader.GetName() == "Localization")
 			{
 				// Read in the revision attributes
-				str = root->Attribute("Revision");
-				if (!str)
+				int32 revision;
+				if (!reader.GetAttribute("Revision", &revision))
 				{
-					Log::Write(LogLevel_Info, "Error in Product Config file at line %d - missing Revision  attribute", root->Row());
-					delete pDoc;
+					Log::Write(LogLevel_Info, "Error in Product Config file at line %d - missing Revision  attribute", reader.GetLine());
 					return false;
 				}
-				m_revision = atol(str);
+				m_revision = revision;
 			}
 
-			TiXmlElement const* CCElement = root->FirstChildElement();
-			while (CCElement)
+			uint32 depth = reader.GetDepth();
+			while (reader.NextChild(depth))
 			{
-				char const* str = CCElement->Value();
-				char* pStopChar;
-				if (str && !strcmp(str, "CommandClass"))
+				if (reader.GetName() == "CommandClass")
 				{
-					str = CCElement->Attribute("id");
-					if (!str)
+					int32 id;
+					if (!reader.GetAttribute("id", &id))
 					{
-						Log::Write(LogLevel_Warning, "Localization::ReadXML: Error in %s at line %d - missing commandclass ID attribute", CCElement->GetDocument()->GetUserData(), CCElement->Row());
-						CCElement = CCElement->NextSiblingElement();
+						Log::Write(LogLevel_Warning, "Localization::ReadXML: Error in %s at line %d - missing commandclass ID attribute", path.c_str(), reader.GetLine());
 						continue;
 					}
-					uint8 ccID = (uint8) strtol(str, &pStopChar, 10);
-					TiXmlElement const* nextElement = CCElement->FirstChildElement();
-					while (nextElement)
+					uint8 ccID = (uint8) id;
+					uint32 ccDepth = reader.GetDepth();
+					while (reader.NextChild(ccDepth))
 					{
-						str = nextElement->Value();
-						if (str && !strcmp(str, "Label"))
+						if (reader.GetName() == "Label")
 						{
-							ReadCCXMLLabel(ccID, nextElement);
+							ReadCCXMLLabel(ccID, reader);
 						}
-						if (str && !strcmp(str, "Value"))
+						else if (reader.GetName() == "Value")
 						{
 							/* when node = 0, its a Localization that applies to all nodes. */
-							ReadXMLValue(0, ccID, nextElement);
+							ReadXMLValue(0, ccID, reader);
 						}
-						nextElement = nextElement->NextSiblingElement();
 					}
 				}
-				else if (str && !strcmp(str, "GlobalText"))
+				else if (reader.GetName() == "GlobalText")
 				{
-					TiXmlElement const* nextElement = CCElement->FirstChildElement();
-					while (nextElement)
+					uint32 globalDepth = reader.GetDepth();
+					while (reader.NextChild(globalDepth))
 					{
-						str = nextElement->Value();
-						if (str && !strcmp(str, "Label"))
+						if (reader.GetName() == "Label")
 						{
-							ReadGlobalXMLLabel(nextElement);
+							ReadGlobalXMLLabel(reader);
 						}
-						nextElement = nextElement->NextSiblingElement();
 					}
 				}
-
-				CCElement = CCElement->NextSiblingElement();
 			}
-			Log::Write(LogLevel_Info, "Loaded %s With Revision %d", pDoc->GetUserData(), m_revision);
-			delete pDoc;
+			if (reader.HasError())
+			{
+				Log::Write(LogLevel_Warning, "Unable to load Localization file %s: %s", path.c_str(), reader.GetError().c_str());
+				return false;
+			}
+			Log::Write(LogLevel_Info, "Loaded %s With Revision %d", path.c_str(), m_revision);
 			return true;
 		}
 
-		void Localization::ReadGlobalXMLLabel(const TiXmlElement *labelElement)
+		void Localization::ReadGlobalXMLLabel(XmlReader& _reader)
 		{
 
-			string Language;
-			char const *str = labelElement->Attribute("name");
-			if (!str)
+			string name;
+			if (!_reader.GetAttribute("name", &name))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadGlobalXMLLabel: Error in %s at line %d - missing GlobalText name attribute", labelElement->GetDocument()->GetUserData(), labelElement->Row());
+				Log::Write(LogLevel_Warning, "Localization::ReadGlobalXMLLabel: Error in %s at line %d - missing GlobalText name attribute", _reader.GetFilename().c_str(), _reader.GetLine());
 				return;
 			}
-			if (labelElement->Attribute("lang"))
-				Language = labelElement->Attribute("lang");
-			if (m_globalLabelLocalizationMap.find(str) == m_globalLabelLocalizationMap.end())
+			string Language;
+			_reader.GetAttribute("lang", &Language);
+			uint32 line = _reader.GetLine();
+			string text;
+			_reader.ReadText(&text);
+			if (m_globalLabelLocalizationMap.find(name) == m_globalLabelLocalizationMap.end())
 			{
-				m_globalLabelLocalizationMap[str] = std::shared_ptr<LabelLocalizationEntry>(new LabelLocalizationEntry(0));
+				m_globalLabelLocalizationMap[name] = std::shared_ptr<LabelLocalizationEntry>(new LabelLocalizationEntry(0));
 			}
-			else if (m_globalLabelLocalizationMap[str]->HasLabel(Language))
+			else if (m_globalLabelLocalizationMap[name]->HasLabel(Language))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadGlobalXMLLabel: Error in %s at line %d - Duplicate Entry for GlobalText %s: %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), str, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadGlobalXMLLabel: Error in %s at line %d - Duplicate Entry for GlobalText %s: %s (Lang: %s)", _reader.GetFilename().c_str(), line, name.c_str(), text.c_str(), Language.c_str());
 				return;
 			}
-			if (Language.empty())
-			{
-				m_globalLabelLocalizationMap[str]->AddLabel(labelElement->GetText());
-
-			}
-			else
-			{
-				m_globalLabelLocalizationMap[str]->AddLabel(labelElement->GetText(), Language);
-
-			}
+			m_globalLabelLocalizationMap[name]->AddLabel(text, Language);
 		}
 
-		void Localization::ReadCCXMLLabel(uint8 ccID, const TiXmlElement *labelElement)
+		void Localization::ReadCCXMLLabel(uint8 ccID, XmlReader& _reader)
 		{
 
 			string Language;
-			if (labelElement->Attribute("lang"))
-				Language = labelElement->Attribute("lang");
+			_reader.GetAttribute("lang", &Language);
+			uint32 line = _reader.GetLine();
+			string text;
+			_reader.ReadText(&text);
 
 			if (m_commandClassLocalizationMap.find(ccID) == m_commandClassLocalizationMap.end())
 			{
@@ -369,69 +355,72 @@ namespace OpenZWave
 			}
 			else if (m_commandClassLocalizationMap[ccID]->HasLabel(Language))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLLabel: Error in %s at line %d - Duplicate Entry for CommandClass %d: %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLLabel: Error in %s at line %d - Duplicate Entry for CommandClass %d: %s (Lang: %s)", _reader.GetFilename().c_str(), line, ccID, text.c_str(), Language.c_str());
 				return;
 			}
-			if (Language.empty())
-			{
-				m_commandClassLocalizationMap[ccID]->AddLabel(labelElement->GetText());
-			}
-			else
-			{
-				m_commandClassLocalizationMap[ccID]->AddLabel(labelElement->GetText(), Language);
-			}
+			m_commandClassLocalizationMap[ccID]->AddLabel(text, Language);
 		}
 
-		void Localization::ReadXMLValue(uint8 node, uint8 ccID, const TiXmlElement *valueElement)
+		void Localization::ReadXMLValue(uint8 node, uint8 ccID, XmlReader& _reader)
 		{
 
-			char const* str = valueElement->Attribute("index");
-			if (!str)
+			int32 intVal;
+			if (!_reader.GetAttribute("index", &intVal))
 			{
-				Log::Write(LogLevel_Info, "Localization::ReadXMLValue: Error in %s at line %d - missing Index  attribute", valueElement->GetDocument()->GetUserData(), valueElement->Row());
+				Log::Write(LogLevel_Info, "Localization::ReadXMLValue: Error in %s at line %d - missing Index  attribute", _reader.GetFilename().c_str(), _reader.GetLine());
 				return;
 			}
-			char* pStopChar;
-			uint16 indexId = (uint16) strtol(str, &pStopChar, 10);
+			uint16 indexId = (uint16) intVal;
 
 			uint32 pos = -1;
-			str = valueElement->Attribute("pos");
-			if (str)
+			if (_reader.GetAttribute("pos", &intVal))
 			{
-				pos = (uint32) strtol(str, &pStopChar, 10);
+				pos = (uint32) intVal;
 			}
 
-			TiXmlElement const* valueIDElement = valueElement->FirstChildElement();
-			while (valueIDElement)
+			uint32 depth = _reader.GetDepth();
+			while (_reader.NextChild(depth))
 			{
-				str = valueIDElement->Value();
-				if (str && !strcmp(str, "Label"))
+				if (_reader.GetName() == "Label")
 				{
-					ReadXMLVIDLabel(node, ccID, indexId, pos, valueIDElement);
+					ReadXMLVIDLabel(node, ccID, indexId, pos, _reader);
 				}
-				if (str && !strcmp(str, "Help"))
+				else if (_reader.GetName() == "Help")
 				{
-					ReadXMLVIDHelp(node, ccID, indexId, pos, valueIDElement);
+					ReadXMLVIDHelp(node, ccID, indexId, pos, _reader);
 				}
-				if (str && !strcmp(str, "ItemLabel"))
+				else if (_reader.GetName() == "ItemLabel")
 				{
-					ReadXMLVIDItemLabel(node, ccID, indexId, pos, valueIDElement);
+					ReadXMLVIDItemLabel(node, ccID, indexId, pos, _reader);
 				}
-
-				valueIDElement = valueIDElement->NextSiblingElement();
 			}
 		}
 
 		void Localization::ReadXMLVIDLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement)
 		{
-
-			uint64 key = GetValueKey(node, ccID, indexId, pos);
 			string Language;
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
-			if (!labelElement->GetText())
+			AddXMLVIDLabel(node, ccID, indexId, pos, Language, labelElement->GetText(), (char const*) labelElement->GetDocument()->GetUserData(), labelElement->Row());
+		}
+
+		void Localization::ReadXMLVIDLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, XmlReader& _reader)
+		{
+			string Language;
+			_reader.GetAttribute("lang", &Language);
+			uint32 line = _reader.GetLine();
+			string text;
+			bool hasText = _reader.ReadText(&text);
+			AddXMLVIDLabel(node, ccID, indexId, pos, Language, hasText ? text.c_str() : NULL, _reader.GetFilename().c_str(), line);
+		}
+
+		void Localization::AddXMLVIDLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, string const& Language, char const* text, char const* file, uint32 line)
+		{
+
+			uint64 key = GetValueKey(node, ccID, indexId, pos);
+			if (!text)
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDLabel: Error in %s at line %d - No Label Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDLabel: Error in %s at line %d - No Label Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", file, line, ccID, indexId, pos, "", Language.c_str());
 				return;
 			}
 
@@ -441,32 +430,40 @@ namespace OpenZWave
 			}
 			else if (m_valueLocalizationMap[key]->HasLabel(Language))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDLabel: Error in %s at line %d - Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDLabel: Error in %s at line %d - Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", file, line, ccID, indexId, pos, text, Language.c_str());
 				return;
 			}
 
-			if (Language.empty())
-			{
-				m_valueLocalizationMap[key]->AddLabel(labelElement->GetText());
-			}
-			else
-			{
-				m_valueLocalizationMap[key]->AddLabel(labelElement->GetText(), Language);
-			}
+			m_valueLocalizationMap[key]->AddLabel(text, Language);
 		}
 
 		void Localization::ReadXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement)
 		{
-
 			string Language;
 			if (labelElement->Attribute("lang"))
 				Language = labelElement->Attribute("lang");
-			if (!labelElement->GetText())
+			AddXMLVIDHelp(node, ccID, indexId, pos, Language, labelElement->GetText(), (char const*) labelElement->GetDocument()->GetUserData(), labelElement->Row());
+		}
+
+		void Localization::ReadXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, XmlReader& _reader)
+		{
+			string Language;
+			_reader.GetAttribute("lang", &Language);
+			uint32 line = _reader.GetLine();
+			string text;
+			bool hasText = _reader.ReadText(&text);
+			AddXMLVIDHelp(node, ccID, indexId, pos, Language, hasText ? text.c_str() : NULL, _reader.GetFilename().c_str(), line);
+		}
+
+		void Localization::AddXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, string const& Language, char const* text, char const* file, uint32 line)
+		{
+
+			if (!text)
 			{
 				if (ccID != 112)
 				{
 					/* Dont Log About the Configuration CC */
-					Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDHelp: Error in %s at line %d - No Help Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+					Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDHelp: Error in %s at line %d - No Help Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", file, line, ccID, indexId, pos, "", Language.c_str());
 				}
 				return;
 
@@ -479,58 +476,46 @@ namespace OpenZWave
 			}
 			else if (m_valueLocalizationMap[key]->HasLabel(Language))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDHelp: Error in %s at line %d - Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDHelp: Error in %s at line %d - Duplicate Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", file, line, ccID, indexId, pos, text, Language.c_str());
 				return;
 			}
-			if (Language.empty())
-			{
-				m_valueLocalizationMap[key]->AddHelp(labelElement->GetText());
-			}
-			else
-			{
-				m_valueLocalizationMap[key]->AddHelp(labelElement->GetText(), Language);
-			}
+			m_valueLocalizationMap[key]->AddHelp(text, Language);
 		}
 
-		void Localization::ReadXMLVIDItemLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement)
+		void Localization::ReadXMLVIDItemLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, XmlReader& _reader)
 		{
 
 			uint64 key = GetValueKey(node, ccID, indexId, pos);
 			string Language;
+			_reader.GetAttribute("lang", &Language);
 			int32 itemIndex;
-			if (labelElement->Attribute("lang"))
-				Language = labelElement->Attribute("lang");
-			if (!labelElement->GetText())
+			bool hasItemIndex = _reader.GetAttribute("itemIndex", &itemIndex);
+			uint32 line = _reader.GetLine();
+			string text;
+			if (!_reader.ReadText(&text))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No ItemIndex Label Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No ItemIndex Label Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", _reader.GetFilename().c_str(), line, ccID, indexId, pos, "", Language.c_str());
 				return;
 			}
 
-			if (TIXML_SUCCESS != labelElement->QueryIntAttribute("itemIndex", &itemIndex))
+			if (!hasItemIndex)
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No itemIndex Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No itemIndex Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", _reader.GetFilename().c_str(), line, ccID, indexId, pos, text.c_str(), Language.c_str());
 				return;
 			}
 
 			if (m_valueLocalizationMap.find(key) == m_valueLocalizationMap.end())
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No Value Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - No Value Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", _reader.GetFilename().c_str(), line, ccID, indexId, pos, text.c_str(), Language.c_str());
 				return;
 			}
 			else if (m_valueLocalizationMap[key]->HasItemLabel(itemIndex, Language))
 			{
-				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - Duplicate ItemLabel Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", labelElement->GetDocument()->GetUserData(), labelElement->Row(), ccID, indexId, pos, labelElement->GetText(), Language.c_str());
+				Log::Write(LogLevel_Warning, "Localization::ReadXMLVIDItemLabel: Error in %s at line %d - Duplicate ItemLabel Entry for CommandClass %d, ValueID: %d (%d):  %s (Lang: %s)", _reader.GetFilename().c_str(), line, ccID, indexId, pos, text.c_str(), Language.c_str());
 				return;
 			}
 
-			if (Language.empty())
-			{
-				m_valueLocalizationMap[key]->AddItemLabel(labelElement->GetText(), itemIndex);
-			}
-			else
-			{
-				m_valueLocalizationMap[key]->AddItemLabel(labelElement->GetText(), itemIndex, Language);
-			}
+			m_valueLocalizationMap[key]->AddItemLabel(text, itemIndex, Language);
 		}
 
 		uint64 Localization::GetValueKey(uint8 _node, uint8 _commandClass, uint16 _index, uint32 _pos, bool unique)
@@ -39,6 +39,7 @@ namespace OpenZWave
 {
 	namespace Internal
 	{
+		class XmlReader;
 
 		class LabelLocalizationEntry: public Internal::Platform::Ref
 		{
@@ -105,10 +106,15 @@ namespace OpenZWave
 				~Localization();
 
 				static bool ReadXML();
-				static void ReadCCXMLLabel(uint8 ccID, const TiXmlElement *labelElement);
-				static void ReadXMLValue(uint8 node, uint8 ccID, const TiXmlElement *valueElement);
-				static void ReadXMLVIDItemLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, const TiXmlElement *labelElement);
-				static void ReadGlobalXMLLabel(const TiXmlElement *labelElement);
+				static void ReadCCXMLLabel(uint8 ccID, XmlReader& _reader);
+				static void ReadXMLValue(uint8 node, uint8 ccID, XmlReader& _reader);
+				static void ReadXMLVIDLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, XmlReader& _reader);
+				static void ReadXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, XmlReader& _reader);
+				static void ReadXMLVIDItemLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, XmlReader& _reader);
+				static void ReadGlobalXMLLabel(XmlReader& _reader);
+				// Shared by the XmlReader and TiXmlElement versions.  _text is NULL if the element has none.
+				static void AddXMLVIDLabel(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, string const& _lang, char const* _text, char const* _file, uint32 _line);
+				static void AddXMLVIDHelp(uint8 node, uint8 ccID, uint16 indexId, uint32 pos, string const& _lang, char const* _text, char const* _file, uint32 _line);
 				static uint64 GetValueKey(uint8 _node, uint8 _commandClass, uint16 _index, uint32 _pos, bool unique = false);
 			public:
 				static Localization* Get();
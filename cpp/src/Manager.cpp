@@ -26,17 +26,20 @@
 //-----------------------------------------------------------------------------
 
 #include <algorithm>
+#include <chrono>
 #include <string>
 #include <sstream>
 #include <iomanip>
 
 #include "Defs.h"
+#include "BinaryCache.h"
 #include "CompatOptionManager.h"
 #include "Manager.h"
 #include "Driver.h"
 #include "Localization.h"
 #include "Node.h"
 #include "Notification.h"
+#include "NotificationDispatcher.h"
 #include "NotificationCCTypes.h"
 #include "Options.h"
 #include "Scene.h"
@@ -62,11 +65,22 @@
 #include "value_classes/ValueSchedule.h"
 #include "value_classes/ValueShort.h"
 #include "value_classes/ValueString.h"
+#include "value_classes/ValueSnapshotTable.h"
 #include "value_classes/ValueBitSet.h"
 
 using namespace OpenZWave;
 
 Manager* Manager::s_instance = NULL;
+
+namespace
+{
+	// Time spent in a watcher callback, in microseconds
+	uint64 ElapsedUs(std::chrono::steady_clock::time_point const& _start)
+	{
+		return (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count();
+	}
+}
+
 extern uint16_t ozw_vers_major;
 extern uint16_t ozw_vers_minor;
 extern uint16_t ozw_vers_revision;
@@ -143,7 +157,7 @@ ozwversion Manager::getVersion()
 // Constructor
 //-----------------------------------------------------------------------------
 Manager::Manager() :
-		m_notificationMutex(new Internal::Platform::Mutex())
+		m_notificationMutex(new Internal::Platform::Mutex()), m_notificationDispatcher(NULL)
 {
 	// Ensure the singleton instance is set
 	s_instance = this;
@@ -188,6 +202,13 @@ Manager::Manager() :
 	Log::Create(logFilename, bAppend, bConsoleOutput, (LogLevel) nSaveLogLevel, (LogLevel) nQueueLogLevel, (LogLevel) nDumpTrigger);
 	Log::SetLoggingState(logging);
 
+	bool bAsyncLogging = false;
+	Options::Get()->GetOptionAsBool("AsyncLogging", &bAsyncLogging);
+	if (bAsyncLogging && !Log::SetAsyncLogging(true))
+	{
+		Log::Write(LogLevel_Warning, "mgr,     Asynchronous logging is not supported on this platform");
+	}
+
 	Internal::CC::CommandClasses::RegisterCommandClasses();
 	Internal::Scene::ReadScenes();
 	// petergebruers replace getVersionAsString() with getVersionLongAsString() because
@@ -202,6 +223,17 @@ Manager::Manager() :
 		Log::Write(LogLevel_Error, "mgr,     Cannot Create SensorMultiLevelCCTypes!");
 	}
 
+	bool notificationThread = true;
+	Options::Get()->GetOptionAsBool("NotificationThread", &notificationThread);
+	if (notificationThread)
+	{
+		int32 queueSize = 1024;
+		Options::Get()->GetOptionAsInt("NotificationQueueSize", &queueSize);
+		string overflow = "Block";
+		Options::Get()->GetOptionAsString("NotificationOverflow", &overflow);
+		m_notificationDispatcher = new Internal::NotificationDispatcher(queueSize > 0 ? (uint32) queueSize : 1, Internal::NotificationDispatcher::GetOverflowFromName(overflow));
+	}
+
 }
 
 //-----------------------------------------------------------------------------
@@ -228,6 +260,10 @@ Manager::~Manager()
 	}
 	m_readyDrivers.clear();
 
+	// Deliver whatever the drivers left behind before the watchers go away
+	delete m_notificationDispatcher;
+	m_notificationDispatcher = NULL;
+
 	m_notificationMutex->Release();
 
 	// Clear the watchers list
@@ -239,46 +275,9 @@ Manager::~Manager()
 	}
 	m_watchers.clear();
 
-	// Clear the generic device class list
-	while (!Node::s_genericDeviceClasses.empty())
-	{
-		map<uint8, Node::GenericDeviceClass*>::iterator git = Node::s_genericDeviceClasses.begin();
-		delete git->second;
-		Node::s_genericDeviceClasses.erase(git);
-	}
-	Node::s_genericDeviceClasses.clear();
-
-	while (!Node::s_basicDeviceClasses.empty())
-	{
-		map<uint8, string>::iterator git = Node::s_basicDeviceClasses.begin();
-		Node::s_basicDeviceClasses.erase(git);
-	}
-	Node::s_basicDeviceClasses.clear();
-
-	while (!Node::s_roleDeviceClasses.empty())
-	{
-		map<uint8, Node::DeviceClass*>::iterator git = Node::s_roleDeviceClasses.begin();
-		delete git->second;
-		Node::s_roleDeviceClasses.erase(git);
-	}
-	Node::s_roleDeviceClasses.clear();
-
-	while (!Node::s_deviceTypeClasses.empty())
-	{
-		map<uint16, Node::DeviceClass*>::iterator git = Node::s_deviceTypeClasses.begin();
-		delete git->second;
-		Node::s_deviceTypeClasses.erase(git);
-	}
-	Node::s_deviceTypeClasses.clear();
-
-	while (!Node::s_nodeTypes.empty())
-	{
-		map<uint8, Node::DeviceClass*>::iterator git = Node::s_nodeTypes.begin();
-		delete git->second;
-		Node::s_nodeTypes.erase(git);
-	}
-	Node::s_nodeTypes.clear();
-
+	// Clear the device classes read from device_classes.xml
+	Node::s_deviceClasses = Internal::ConfigTables::DeviceClassData();
+	Node::s_deviceClassStore.Clear();
 	Node::s_deviceClassesLoaded = false;
 	
 	Log::Destroy();
@@ -297,6 +296,7 @@ void Manager::WriteConfig(uint32 const _homeId)
 	if (Driver* driver = GetDriver(_homeId))
 	{
 		driver->WriteCache();
+		driver->SaveCache();
 		Log::Write(LogLevel_Info, "mgr,     Manager::WriteConfig completed for driver with home ID of 0x%.8x", _homeId);
 	}
 	else
@@ -306,6 +306,18 @@ void Manager::WriteConfig(uint32 const _homeId)
 	Internal::Scene::WriteXML("zwscene.xml");
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::ConvertCache>
+// Convert a cache file between the XML and the binary format
+//-----------------------------------------------------------------------------
+bool Manager::ConvertCache(string const& _source, string const& _destination)
+{
+	bool binary = (_source.size() > 4) && (Internal::ToLower(_source.substr(_source.size() - 4)) == ".bin");
+	bool converted = binary ? Internal::BinaryCache::ConvertToXml(_source, _destination) : Internal::BinaryCache::ConvertToBinary(_source, _destination);
+	Log::Write(LogLevel_Info, "mgr,     Manager::ConvertCache %s %s to %s", converted ? "converted" : "failed to convert", _source.c_str(), _destination.c_str());
+	return converted;
+}
+
 //-----------------------------------------------------------------------------
 //	Drivers
 //-----------------------------------------------------------------------------
@@ -412,6 +424,20 @@ Driver* Manager::GetDriver(uint32 const _homeId)
 	return NULL;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::FindDriver>
+// Get a pointer to the driver for a Home ID, or NULL if it has been removed
+//-----------------------------------------------------------------------------
+Driver* Manager::FindDriver(uint32 const _homeId)
+{
+	map<uint32, Driver*>::iterator it = m_readyDrivers.find(_homeId);
+	if (it != m_readyDrivers.end())
+	{
+		return it->second;
+	}
+	return NULL;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetDriverReady>
 // Move a driver from pending to ready, and notify any watchers
@@ -726,6 +752,21 @@ void Manager::SetPollIntensity(ValueID const &_valueId, uint8 const _intensity)
 	Log::Write(LogLevel_Error, "mgr,     SetPollIntensity failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId());
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::GetPollStatistics>
+// Retrieve the poll latency and jitter of a value
+//-----------------------------------------------------------------------------
+bool Manager::GetPollStatistics(ValueID const &_valueId, Driver::PollStatistics* _data)
+{
+	if (Driver* driver = GetDriver(_valueId.GetHomeId()))
+	{
+		return driver->GetPollStatistics(_valueId, _data);
+	}
+
+	Log::Write(LogLevel_Info, "mgr,     GetPollStatistics failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId());
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::GetPollIntensity>
 // Change the intensity with which this value is polled
@@ -735,7 +776,7 @@ uint8 Manager::GetPollIntensity(ValueID const &_valueId)
 	uint8 intensity = 0;
 	if (Driver* driver = GetDriver(_valueId.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_valueId))
 		{
 			intensity = value->GetPollIntensity();
@@ -1353,7 +1394,7 @@ bool Manager::IsNodeInfoReceived(uint32 const _homeId, uint8 const _nodeId)
 		Node *node;
 
 		// Need to lock and unlock nodes to check this information
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 
 		if ((node = driver->GetNode(_nodeId)) != NULL)
 		{
@@ -1377,7 +1418,7 @@ bool Manager::GetNodeClassInformation(uint32 const _homeId, uint8 const _nodeId,
 		Node *node;
 
 		// Need to lock and unlock nodes to check this information
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 
 		if ((node = driver->GetNode(_nodeId)) != NULL)
 		{
@@ -1424,7 +1465,7 @@ bool Manager::IsNodeAwake(uint32 const _homeId, uint8 const _nodeId)
 	if (Driver* driver = GetDriver(_homeId))
 	{
 		// Need to lock and unlock nodes to check this information
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 
 		if (Node* node = driver->GetNode(_nodeId))
 		{
@@ -1446,7 +1487,7 @@ bool Manager::IsNodeFailed(uint32 const _homeId, uint8 const _nodeId)
 	bool result = false;
 	if (Driver* driver = GetDriver(_homeId))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Node* node = driver->GetNode(_nodeId))
 		{
 			result = !node->IsNodeAlive();
@@ -1464,7 +1505,7 @@ string Manager::GetNodeQueryStage(uint32 const _homeId, uint8 const _nodeId)
 	string result = "Unknown";
 	if (Driver* driver = GetDriver(_homeId))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Node* node = driver->GetNode(_nodeId))
 		{
 			result = node->GetQueryStageName(node->GetCurrentQueryStage());
@@ -1506,7 +1547,7 @@ string Manager::GetInstanceLabel(uint32 const _homeId, uint8 const _node, uint8
 	string label;
 	if (Driver* driver = GetDriver(_homeId))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Node* node = driver->GetNode(_node))
 		{
 			label = node->GetInstanceLabel(_cc, _instance);
@@ -1534,7 +1575,7 @@ string Manager::GetValueLabel(ValueID const& _id, int32 _pos)
 	string label;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (_pos != -1)
 		{
 			if (_id.GetType() != ValueID::ValueType_BitSet)
@@ -1549,8 +1590,7 @@ string Manager::GetValueLabel(ValueID const& _id, int32 _pos)
 		}
 		else
 		{
-			bool useinstancelabels = true;
-			Options::Get()->GetOptionAsBool("IncludeInstanceLabel", &useinstancelabels);
+			bool useinstancelabels = Options::Get()->GetValues().m_IncludeInstanceLabel;
 			Node* node = driver->GetNode(_id.GetNodeId());
 			if ((useinstancelabels) && (node))
 			{
@@ -1615,7 +1655,7 @@ string Manager::GetValueUnits(ValueID const& _id)
 	string units;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			units = value->GetUnits();
@@ -1660,7 +1700,7 @@ string Manager::GetValueHelp(ValueID const& _id, int32 _pos)
 	string help;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (_pos != -1)
 		{
 			if (_id.GetType() != ValueID::ValueType_BitSet)
@@ -1730,7 +1770,7 @@ int32 Manager::GetValueMin(ValueID const& _id)
 	int32 limit = 0;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			limit = value->GetMin();
@@ -1754,7 +1794,7 @@ int32 Manager::GetValueMax(ValueID const& _id)
 	int32 limit = 0;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			limit = value->GetMax();
@@ -1778,7 +1818,7 @@ bool Manager::IsValueReadOnly(ValueID const& _id)
 	bool res = false;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			res = value->IsReadOnly();
@@ -1802,7 +1842,7 @@ bool Manager::IsValueWriteOnly(ValueID const& _id)
 	bool res = false;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			res = value->IsWriteOnly();
@@ -1826,7 +1866,7 @@ bool Manager::IsValueSet(ValueID const& _id)
 	bool res = false;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			res = value->IsSet();
@@ -1850,7 +1890,7 @@ bool Manager::IsValuePolled(ValueID const& _id)
 	bool res = false;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			res = value->IsPolled();
@@ -1871,9 +1911,9 @@ bool Manager::IsValuePolled(ValueID const& _id)
 //-----------------------------------------------------------------------------
 bool Manager::IsValueValid(ValueID const& _id)
 {
-	if (Driver* driver = GetDriver(_id.GetHomeId()))
+	if (Driver* driver = FindDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			value->Release();
@@ -1897,7 +1937,7 @@ bool Manager::GetValueAsBitSet(ValueID const& _id, uint8 _pos, bool* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueBitSet* value = static_cast<Internal::VC::ValueBitSet*>(driver->GetValue(_id)))
 				{
 					*o_value = value->GetBit(_pos);
@@ -1932,7 +1972,7 @@ bool Manager::GetValueAsBool(ValueID const& _id, bool* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueBool* value = static_cast<Internal::VC::ValueBool*>(driver->GetValue(_id)))
 				{
 					*o_value = value->GetValue();
@@ -1949,7 +1989,7 @@ bool Manager::GetValueAsBool(ValueID const& _id, bool* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueButton* value = static_cast<Internal::VC::ValueButton*>(driver->GetValue(_id)))
 				{
 					*o_value = value->IsPressed();
@@ -1985,7 +2025,7 @@ bool Manager::GetValueAsByte(ValueID const& _id, uint8* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueByte* value = static_cast<Internal::VC::ValueByte*>(driver->GetValue(_id)))
 				{
 					*o_value = value->GetValue();
@@ -2021,7 +2061,7 @@ bool Manager::GetValueAsFloat(ValueID const& _id, float* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueDecimal* value = static_cast<Internal::VC::ValueDecimal*>(driver->GetValue(_id)))
 				{
 					string str = value->GetValue();
@@ -2056,7 +2096,7 @@ bool Manager::GetValueAsInt(ValueID const& _id, int32* o_value)
 	{
 		if (Driver* driver = GetDriver(_id.GetHomeId()))
 		{
-			Internal::LockGuard LG(driver->m_nodeMutex);
+			Internal::ReadLockGuard LG(driver->m_nodeMutex);
 
 			if (ValueID::ValueType_Int == _id.GetType())
 			{
@@ -2108,7 +2148,7 @@ bool Manager::GetValueAsRaw(ValueID const& _id, uint8** o_value, uint8* o_length
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueRaw* value = static_cast<Internal::VC::ValueRaw*>(driver->GetValue(_id)))
 				{
 					*o_length = value->GetLength();
@@ -2146,7 +2186,7 @@ bool Manager::GetValueAsShort(ValueID const& _id, int16* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueShort* value = static_cast<Internal::VC::ValueShort*>(driver->GetValue(_id)))
 				{
 					*o_value = value->GetValue();
@@ -2182,7 +2222,7 @@ bool Manager::GetValueAsString(ValueID const& _id, string* o_value)
 	{
 		if (Driver* driver = GetDriver(_id.GetHomeId()))
 		{
-			Internal::LockGuard LG(driver->m_nodeMutex);
+			Internal::ReadLockGuard LG(driver->m_nodeMutex);
 
 			switch (_id.GetType())
 			{
@@ -2375,7 +2415,7 @@ bool Manager::GetValueListSelection(ValueID const& _id, string* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueList* value = static_cast<Internal::VC::ValueList*>(driver->GetValue(_id)))
 				{
 					Internal::VC::ValueList::Item const *item = value->GetItem();
@@ -2420,7 +2460,7 @@ bool Manager::GetValueListSelection(ValueID const& _id, int32* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueList* value = static_cast<Internal::VC::ValueList*>(driver->GetValue(_id)))
 				{
 					Internal::VC::ValueList::Item const *item = value->GetItem();
@@ -2465,7 +2505,7 @@ bool Manager::GetValueListItems(ValueID const& _id, vector<string>* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueList* value = static_cast<Internal::VC::ValueList*>(driver->GetValue(_id)))
 				{
 					o_value->clear();
@@ -2501,7 +2541,7 @@ bool Manager::GetValueListValues(ValueID const& _id, vector<int32>* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueList* value = static_cast<Internal::VC::ValueList*>(driver->GetValue(_id)))
 				{
 					o_value->clear();
@@ -2537,7 +2577,7 @@ bool Manager::GetValueFloatPrecision(ValueID const& _id, uint8* o_value)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueDecimal* value = static_cast<Internal::VC::ValueDecimal*>(driver->GetValue(_id)))
 				{
 					*o_value = value->GetPrecision();
@@ -2559,6 +2599,38 @@ bool Manager::GetValueFloatPrecision(ValueID const& _id, uint8* o_value)
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::GetValueSnapshot>
+// Gets a copy of a value without locking the nodes
+//-----------------------------------------------------------------------------
+bool Manager::GetValueSnapshot(ValueID const& _id, ValueSnapshot* o_snapshot)
+{
+	if (o_snapshot)
+	{
+		if (Driver* driver = GetDriver(_id.GetHomeId()))
+		{
+			return driver->m_valueSnapshots->Get(_id, o_snapshot);
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetNodeValuesSnapshot>
+// Gets copies of a node's values without locking the nodes
+//-----------------------------------------------------------------------------
+uint32 Manager::GetNodeValuesSnapshot(uint32 const _homeId, uint8 const _nodeId, vector<ValueSnapshot>* o_snapshots, uint64 const _sinceVersion)
+{
+	if (o_snapshots)
+	{
+		if (Driver* driver = GetDriver(_homeId))
+		{
+			return driver->m_valueSnapshots->GetNode(_nodeId, _sinceVersion, o_snapshots);
+		}
+	}
+	return 0;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetValue>
 // Sets a bit in a BitSet Value
@@ -3169,7 +3241,7 @@ bool Manager::GetChangeVerified(ValueID const& _id)
 	bool res = false;
 	if (Driver* driver = GetDriver(_id.GetHomeId()))
 	{
-		Internal::LockGuard LG(driver->m_nodeMutex);
+		Internal::ReadLockGuard LG(driver->m_nodeMutex);
 		if (Internal::VC::Value* value = driver->GetValue(_id))
 		{
 			res = value->GetChangeVerified();
@@ -3294,7 +3366,7 @@ bool Manager::GetBitMask(ValueID const& _id, int32* o_mask)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueBitSet* value = static_cast<Internal::VC::ValueBitSet*>(driver->GetValue(_id)))
 				{
 					*o_mask = value->GetBitMask();
@@ -3330,7 +3402,7 @@ bool Manager::GetBitSetSize(ValueID const& _id, uint8* o_size)
 		{
 			if (Driver* driver = GetDriver(_id.GetHomeId()))
 			{
-				Internal::LockGuard LG(driver->m_nodeMutex);
+				Internal::ReadLockGuard LG(driver->m_nodeMutex);
 				if (Internal::VC::ValueBitSet* value = static_cast<Internal::VC::ValueBitSet*>(driver->GetValue(_id)))
 				{
 					*o_size = value->GetSize();
@@ -3369,7 +3441,7 @@ uint8 Manager::GetNumSwitchPoints(ValueID const& _id)
 	{
 		if (Driver* driver = GetDriver(_id.GetHomeId()))
 		{
-			Internal::LockGuard LG(driver->m_nodeMutex);
+			Internal::ReadLockGuard LG(driver->m_nodeMutex);
 			if (Internal::VC::ValueSchedule* value = static_cast<Internal::VC::ValueSchedule*>(driver->GetValue(_id)))
 			{
 				numSwitchPoints = value->GetNumSwitchPoints();
@@ -3499,7 +3571,7 @@ bool Manager::GetSwitchPoint(ValueID const& _id, uint8 const _idx, uint8* o_hour
 	{
 		if (Driver* driver = GetDriver(_id.GetHomeId()))
 		{
-			Internal::LockGuard LG(driver->m_nodeMutex);
+			Internal::ReadLockGuard LG(driver->m_nodeMutex);
 			if (Internal::VC::ValueSchedule* value = static_cast<Internal::VC::ValueSchedule*>(driver->GetValue(_id)))
 			{
 				res = value->GetSwitchPoint(_idx, o_hours, o_minutes, o_setback);
@@ -3547,6 +3619,30 @@ void Manager::SwitchAllOff(uint32 const _homeId)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::BeginMulticast>
+// Start collecting the commands sent by this thread into a multicast batch
+//-----------------------------------------------------------------------------
+void Manager::BeginMulticast(uint32 const _homeId)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		driver->BeginMulticast();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::EndMulticast>
+// Send the commands collected since BeginMulticast
+//-----------------------------------------------------------------------------
+void Manager::EndMulticast(uint32 const _homeId)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		driver->EndMulticast();
+	}
+}
+
 //-----------------------------------------------------------------------------
 //	Configuration Parameters
 //-----------------------------------------------------------------------------
@@ -3729,7 +3825,7 @@ bool Manager::AddWatcher(pfnOnNotification_t _watcher, void* _context)
 		}
 	}
 
-	m_watchers.push_back(new Watcher(_watcher, _context));
+	m_watchers.push_back(new Watcher(_watcher, NULL, _context));
 	m_notificationMutex->Unlock();
 	return true;
 }
@@ -3765,11 +3861,129 @@ bool Manager::RemoveWatcher(pfnOnNotification_t _watcher, void* _context)
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::AddBatchWatcher>
+// Add a batch watcher to the list
+//-----------------------------------------------------------------------------
+bool Manager::AddBatchWatcher(pfnOnNotificationBatch_t _watcher, void* _context)
+{
+	// Ensure this watcher is not already on the list
+	m_notificationMutex->Lock();
+	for (list<Watcher*>::iterator it = m_watchers.begin(); it != m_watchers.end(); ++it)
+	{
+		if (((*it)->m_batchCallback == _watcher) && ((*it)->m_context == _context))
+		{
+			// Already in the list
+			m_notificationMutex->Unlock();
+			return false;
+		}
+	}
+
+	m_watchers.push_back(new Watcher(NULL, _watcher, _context));
+	m_notificationMutex->Unlock();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::RemoveBatchWatcher>
+// Remove a batch watcher from the list
+//-----------------------------------------------------------------------------
+bool Manager::RemoveBatchWatcher(pfnOnNotificationBatch_t _watcher, void* _context)
+{
+	m_notificationMutex->Lock();
+	list<Watcher*>::iterator it = m_watchers.begin();
+	while (it != m_watchers.end())
+	{
+		if (((*it)->m_batchCallback == _watcher) && ((*it)->m_context == _context))
+		{
+			delete (*it);
+			list<Watcher*>::iterator next = m_watchers.erase(it);
+			for (list<list<Watcher*>::iterator*>::iterator extIt = m_watcherIterators.begin(); extIt != m_watcherIterators.end(); ++extIt)
+			{
+				if ((**extIt) == it)
+				{
+					(**extIt) = next;
+				}
+			}
+			m_notificationMutex->Unlock();
+			return true;
+		}
+		++it;
+	}
+
+	m_notificationMutex->Unlock();
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetNotificationStatistics>
+// Get the statistics of the notification queue and the watchers
+//-----------------------------------------------------------------------------
+void Manager::GetNotificationStatistics(NotificationData* _data)
+{
+	_data->m_queued = 0;
+	_data->m_delivered = 0;
+	_data->m_batches = 0;
+	_data->m_dropped = 0;
+	_data->m_coalesced = 0;
+	_data->m_blocked = 0;
+	_data->m_overflowed = 0;
+	_data->m_averageDelayUs = 0;
+	_data->m_maxDelayUs = 0;
+	if (m_notificationDispatcher)
+	{
+		m_notificationDispatcher->GetStatistics(_data);
+	}
+
+	_data->m_watchers.clear();
+	Internal::LockGuard LG(m_notificationMutex);
+	for (list<Watcher*>::iterator it = m_watchers.begin(); it != m_watchers.end(); ++it)
+	{
+		WatcherData data;
+		data.m_callback = (*it)->m_callback;
+		data.m_batchCallback = (*it)->m_batchCallback;
+		data.m_context = (*it)->m_context;
+		data.m_calls = (*it)->m_calls;
+		data.m_notifications = (*it)->m_notifications;
+		data.m_averageUs = (*it)->m_calls ? (uint32) ((*it)->m_totalUs / (*it)->m_calls) : 0;
+		data.m_maxUs = (*it)->m_maxUs;
+		_data->m_watchers.push_back(data);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::PostNotification>
+// Hand a notification to the notification thread, or deliver it now
+//-----------------------------------------------------------------------------
+void Manager::PostNotification(Notification* _notification)
+{
+	if (m_notificationDispatcher)
+	{
+		m_notificationDispatcher->Post(_notification);
+		return;
+	}
+
+	NotifyWatchers(&_notification, 1);
+	delete _notification;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::FlushNotifications>
+// Wait until every notification posted so far has been delivered
+//-----------------------------------------------------------------------------
+void Manager::FlushNotifications()
+{
+	if (m_notificationDispatcher)
+	{
+		m_notificationDispatcher->Flush();
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::NotifyWatchers>
 // Notify any watching objects of a value change
 //-----------------------------------------------------------------------------
-void Manager::NotifyWatchers(Notification* _notification)
+void Manager::NotifyWatchers(Notification* const * _notifications, uint32 const _count)
 {
 	m_notificationMutex->Lock();
 	list<Watcher*>::iterator it = m_watchers.begin();
@@ -3777,7 +3991,28 @@ void Manager::NotifyWatchers(Notification* _notification)
 	while (it != m_watchers.end())
 	{
 		Watcher* pWatcher = *(it++);
-		pWatcher->m_callback(_notification, pWatcher->m_context);
+		if (pWatcher->m_batchCallback)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			pWatcher->m_batchCallback(_notifications, _count, pWatcher->m_context);
+			// The watcher may have removed itself
+			if (std::find(m_watchers.begin(), m_watchers.end(), pWatcher) != m_watchers.end())
+			{
+				pWatcher->Record(_count, ElapsedUs(start));
+			}
+			continue;
+		}
+
+		for (uint32 i = 0; i < _count; ++i)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			pWatcher->m_callback(_notifications[i], pWatcher->m_context);
+			if (std::find(m_watchers.begin(), m_watchers.end(), pWatcher) == m_watchers.end())
+			{
+				break;
+			}
+			pWatcher->Record(1, ElapsedUs(start));
+		}
 	}
 	m_watcherIterators.pop_back();
 	m_notificationMutex->Unlock();
@@ -4765,6 +5000,30 @@ if (Driver* driver = GetDriver(_homeId))
 
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::GetNodeLatencyStats>
+// Retrieve the latency percentiles of a node
+//-----------------------------------------------------------------------------
+void Manager::GetNodeLatencyStats(uint32 const _homeId, uint8 const _nodeId, Node::NodeLatencyStats* _data)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		driver->GetNodeLatencyStats(_nodeId, _data);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::ResetNodeLatencyStats>
+// Empty the latency histograms of a node
+//-----------------------------------------------------------------------------
+void Manager::ResetNodeLatencyStats(uint32 const _homeId, uint8 const _nodeId)
+{
+	if (Driver* driver = GetDriver(_homeId))
+	{
+		driver->ResetNodeLatencyStats(_nodeId);
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::GetNodeRouteScheme>
 // Convert the RouteScheme to a String
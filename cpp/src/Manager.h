@@ -39,6 +39,7 @@
 #include "Driver.h"
 #include "Group.h"
 #include "value_classes/ValueID.h"
+#include "value_classes/ValueSnapshot.h"
 
 namespace OpenZWave
 {
@@ -54,6 +55,7 @@ namespace OpenZWave
 			class ValueStore;
 		}
 		class Msg;
+		class NotificationDispatcher;
 	}
 	class Options;
 	class Node;
@@ -114,9 +116,11 @@ namespace OpenZWave
 			friend class Internal::VC::Value;
 			friend class Internal::VC::ValueStore;
 			friend class Internal::Msg;
+			friend class Internal::NotificationDispatcher;
 
 		public:
 			typedef void (*pfnOnNotification_t)(Notification const* _pNotification, void* _context);
+			typedef void (*pfnOnNotificationBatch_t)(Notification const* const * _notifications, uint32 _count, void* _context);
 
 			//-----------------------------------------------------------------------------
 			// Construction
@@ -204,6 +208,17 @@ namespace OpenZWave
 			 */
 			DEPRECATED void WriteConfig(uint32 const _homeId);
 
+			/**
+			 * \brief Convert a saved network cache between the XML and the binary format.
+			 * The CacheFormat option decides which format the driver saves, and either is read at
+			 * startup.  This converts a file without a driver, for instance to read a binary cache
+			 * or to move a network to an installation that uses the other format.
+			 * \param _source The cache file to read.  A name ending in .bin is read as a binary cache, anything else as XML.
+			 * \param _destination The file to write, in the other format.  It is replaced if it exists.
+			 * \return True if the file was converted.
+			 */
+			static bool ConvertCache(string const& _source, string const& _destination);
+
 			/**
 			 * \brief Gets a pointer to the locked Options object.
 			 * \return pointer to the Options object.
@@ -234,7 +249,9 @@ namespace OpenZWave
 			 * has been received, a DriverReady notification callback is sent, containing the Home ID of the controller.  This Home ID is
 			 * required by most of the OpenZWave Manager class methods.
 			 * @param _controllerPath The string used to open the controller.  On Windows this might be something like
-			 * "\\.\COM3", or on Linux "/dev/ttyUSB0".
+			 * "\\.\COM3", or on Linux "/dev/ttyUSB0".  For Driver::ControllerInterface_Virtual it describes a simulated
+			 * network instead, such as "virtual:nodes=20,latency=10".
+			 * @param _interface the kind of controller.
 			 * \return True if a new driver was created, false if a driver for the controller already exists.
 			 * \see Create, Get, RemoveDriver
 			 */
@@ -365,6 +382,7 @@ namespace OpenZWave
 
 		private:
 			Driver* GetDriver(uint32 const _homeId); /**< Get a pointer to a Driver object from the HomeID.  Only to be used by OpenZWave. */
+			Driver* FindDriver(uint32 const _homeId); /**< As GetDriver, but returns NULL rather than throwing if the driver has been removed. */
 			void SetDriverReady(Driver* _driver, bool success); /**< Indicate that the Driver is ready to be used, and send the notification callback. */
 			list<Driver*> m_pendingDrivers; /**< Drivers that are in the process of reading saved data and querying their Z-Wave network for basic information. */
 			map<uint32, Driver*> m_readyDrivers; /**< Drivers that are ready to be used by the application. */
@@ -434,6 +452,16 @@ namespace OpenZWave
 			 */
 			uint8 GetPollIntensity(ValueID const &_valueId);
 
+			/**
+			 * \brief Get the poll timing statistics of a value.
+			 * Latency is how long after its due time each poll was sent (polls wait for the send queues
+			 * to drain), and jitter is how far the time between two polls strayed from the scheduled period.
+			 * \param _valueId The ID of the polled value.
+			 * \param _data Pointer to structure PollStatistics to return values
+			 * \return True if the value is being polled and the statistics were returned.
+			 */
+			bool GetPollStatistics(ValueID const &_valueId, Driver::PollStatistics* _data);
+
 			/*@}*/
 
 			//-----------------------------------------------------------------------------
@@ -1108,6 +1136,7 @@ namespace OpenZWave
 			 * \brief Test whether the ValueID is valid.
 			 * \param _id The unique identifier of the value.
 			 * \return true if the valueID is valid, otherwise false.
+			 * Unlike the other value methods, this does not throw if the value or its driver has been removed.
 			 * \see ValueID
 			 */
 			bool IsValueValid(ValueID const& _id);
@@ -1272,6 +1301,29 @@ namespace OpenZWave
 			 */
 			bool GetValueFloatPrecision(ValueID const& _id, uint8* o_value);
 
+			/**
+			 * \brief Gets a copy of a value without taking the driver's node lock.
+			 * Snapshots are updated whenever the value is refreshed, so this is meant for pollers and
+			 * exporters that read many values at a high rate.  Long strings are truncated, see ValueSnapshot.
+			 * \param _id The unique identifier of the value.
+			 * \param o_snapshot Pointer to a ValueSnapshot that will be filled in.
+			 * \return true if the snapshot was obtained.  Returns false if the value does not exist.
+			 * \see GetNodeValuesSnapshot, ValueSnapshot
+			 */
+			bool GetValueSnapshot(ValueID const& _id, ValueSnapshot* o_snapshot);
+
+			/**
+			 * \brief Gets copies of a node's values without taking the driver's node lock.
+			 * \param _homeId The Home ID of the Z-Wave controller that manages the node.
+			 * \param _nodeId The ID of the node.
+			 * \param o_snapshots The snapshots are appended to this vector.
+			 * \param _sinceVersion Only values whose ValueSnapshot::m_version is greater than this are returned.
+			 * Pass the highest version seen so far to get just the values that have changed since, or zero for all of them.
+			 * \return The number of snapshots appended to o_snapshots.
+			 * \see GetValueSnapshot, ValueSnapshot
+			 */
+			uint32 GetNodeValuesSnapshot(uint32 const _homeId, uint8 const _nodeId, vector<ValueSnapshot>* o_snapshots, uint64 const _sinceVersion = 0);
+
 			/**
 			 * \brief Sets the state of a bit in a BitSet ValueID.
 			 * Due to the possibility of a device being asleep, the command is assumed to succeed, and the value
@@ -1620,6 +1672,38 @@ namespace OpenZWave
 
 			/*@}*/
 
+			//-----------------------------------------------------------------------------
+			// Multicast
+			//-----------------------------------------------------------------------------
+			/** \name Multicast
+			 *  Methods for sending the same command to a group of devices together.  Between
+			 *	BeginMulticast and EndMulticast, the commands that the calling thread sends to
+			 *	listening devices are held back.  When EndMulticast is called, commands with the
+			 *	same payload for several devices are sent as a single multicast frame, so the
+			 *	devices react at the same time.  Unless the MulticastFollowUp option is false,
+			 *	each device is then also sent its command individually, because multicast frames
+			 *	are not acknowledged.  The requests that read the new values back are sent after
+			 *	that.  Scene activation and SwitchAll use this automatically.
+			 */
+			/*@{*/
+
+			/**
+			 * \brief Start collecting commands into a multicast batch.
+			 * Calls may be nested, and only the outermost EndMulticast sends the batch.
+			 * \param _homeId The Home ID of the Z-Wave controller.
+			 * \see EndMulticast
+			 */
+			void BeginMulticast(uint32 const _homeId);
+
+			/**
+			 * \brief Send the commands collected since BeginMulticast.
+			 * \param _homeId The Home ID of the Z-Wave controller.
+			 * \see BeginMulticast
+			 */
+			void EndMulticast(uint32 const _homeId);
+
+			/*@}*/
+
 			//-----------------------------------------------------------------------------
 			// Configuration Parameters
 			//-----------------------------------------------------------------------------
@@ -1797,6 +1881,18 @@ namespace OpenZWave
 			 * In OpenZWave, all feedback from the Z-Wave network is sent to the application via callbacks.
 			 * This method allows the application to add a notification callback handler, known as a "watcher" to OpenZWave.
 			 * An application needs only add a single watcher - all notifications will be reported to it.
+			 *
+			 * Unless the NotificationThread option is false, the watchers are called on a dedicated
+			 * notification thread, some time after the event they report:
+			 * - Notifications are delivered in the order they were posted, one watcher call at a time.
+			 *   A notification posted while a watcher runs, for instance because it removes a driver,
+			 *   is queued behind the others rather than delivered from inside the watcher.
+			 * - By the time a notification arrives, its value, node or driver may already be gone, and
+			 *   the value getters then throw OZWException. Watchers should call IsValueValid first,
+			 *   which never throws, and still catch OZWException if another thread may remove the
+			 *   driver in the meantime.
+			 * - A watcher must not wait for another thread that is itself waiting for notifications
+			 *   to be delivered.
 			 * \param _watcher pointer to a function that will be called by the notification system.
 			 * \param _context pointer to user defined data that will be passed to the watcher function with each notification.
 			 * \return true if the watcher was successfully added.
@@ -1812,25 +1908,106 @@ namespace OpenZWave
 			 * \see AddWatcher, Notification
 			 */
 			bool RemoveWatcher(pfnOnNotification_t _watcher, void* _context);
+
+			/**
+			 * \brief Add a watcher that receives notifications in batches.
+			 * Unless the NotificationThread option is false, notifications are delivered on a dedicated
+			 * thread.  Each time that thread wakes up, a batch watcher is called once with every
+			 * notification that was waiting, instead of once per notification.
+			 * The notifications are only valid until the watcher returns.
+			 * \param _watcher pointer to a function that will be called by the notification system.
+			 * \param _context pointer to user defined data that will be passed to the watcher function with each batch.
+			 * \return true if the watcher was successfully added.
+			 * \see RemoveBatchWatcher, AddWatcher, Notification
+			 */
+			bool AddBatchWatcher(pfnOnNotificationBatch_t _watcher, void* _context);
+
+			/**
+			 * \brief Remove a batch notification watcher.
+			 * \param _watcher pointer to a function that must match that passed to a previous call to AddBatchWatcher
+			 * \param _context pointer to user defined data that must match the one passed in that same previous call to AddBatchWatcher.
+			 * \return true if the watcher was successfully removed.
+			 * \see AddBatchWatcher
+			 */
+			bool RemoveBatchWatcher(pfnOnNotificationBatch_t _watcher, void* _context);
+
+			/**
+			 * \brief Time spent in one watcher's callback.
+			 * \see NotificationData
+			 */
+			struct WatcherData
+			{
+					pfnOnNotification_t m_callback;			/**< The watcher passed to AddWatcher, or NULL for a batch watcher */
+					pfnOnNotificationBatch_t m_batchCallback;	/**< The watcher passed to AddBatchWatcher, or NULL */
+					void* m_context;						/**< The context passed with the watcher */
+					uint32 m_calls;							/**< Number of times the watcher has been called */
+					uint32 m_notifications;					/**< Number of notifications passed to the watcher */
+					uint32 m_averageUs;						/**< Average time spent in one call, in microseconds */
+					uint32 m_maxUs;							/**< Longest time spent in one call, in microseconds */
+			};
+
+			/**
+			 * \brief Statistics of the notification queue and of each watcher.
+			 * \see GetNotificationStatistics
+			 */
+			struct NotificationData
+			{
+					uint32 m_queued;						/**< Notifications waiting to be delivered */
+					uint32 m_delivered;						/**< Notifications delivered to the watchers */
+					uint32 m_batches;						/**< Number of times the notification thread woke up to deliver notifications */
+					uint32 m_dropped;						/**< Notifications dropped because the queue was full (NotificationOverflow is DropOldest) */
+					uint32 m_coalesced;						/**< Notifications merged into one already queued for the same value (NotificationOverflow is Coalesce) */
+					uint32 m_blocked;						/**< Number of times a driver waited for room in the queue */
+					uint32 m_overflowed;					/**< Notifications posted by a watcher while the queue was full at four times its configured size.  Value notifications among them were merged or dropped */
+					uint32 m_averageDelayUs;				/**< Average time between queueing and delivering a notification, in microseconds */
+					uint32 m_maxDelayUs;					/**< Longest time between queueing and delivering a notification, in microseconds */
+					vector<WatcherData> m_watchers;			/**< One entry per registered watcher */
+			};
+
+			/**
+			 * \brief Get the statistics of the notification queue and the watchers.
+			 * Use this to find a watcher that is slow to return.
+			 * \param _data Pointer to a structure that will be filled in.
+			 */
+			void GetNotificationStatistics(NotificationData* _data);
 			/*@}*/
 
 		private:
-			void NotifyWatchers(Notification* _notification);					// Passes the notifications to all the registered watcher callbacks in turn.
+			void PostNotification(Notification* _notification);					// Hands a notification to the notification thread, or delivers it now if there is none.  Takes ownership.
+			void FlushNotifications();											// Waits until every notification posted so far has been delivered.
+			void NotifyWatchers(Notification* const * _notifications, uint32 const _count);	// Passes the notifications to all the registered watcher callbacks in turn.
 
 			struct Watcher
 			{
 					pfnOnNotification_t m_callback;
+					pfnOnNotificationBatch_t m_batchCallback;
 					void* m_context;
+					uint32 m_calls;
+					uint32 m_notifications;
+					uint64 m_totalUs;
+					uint32 m_maxUs;
+
+					Watcher(pfnOnNotification_t _callback, pfnOnNotificationBatch_t _batchCallback, void* _context) :
+							m_callback(_callback), m_batchCallback(_batchCallback), m_context(_context), m_calls(0), m_notifications(0), m_totalUs(0), m_maxUs(0)
+					{
+					}
 
-					Watcher(pfnOnNotification_t _callback, void* _context) :
-							m_callback(_callback), m_context(_context)
+					void Record(uint32 const _notifications, uint64 const _us)
 					{
+						++m_calls;
+						m_notifications += _notifications;
+						m_totalUs += _us;
+						if (_us > m_maxUs)
+						{
+							m_maxUs = (uint32) _us;
+						}
 					}
 			};
 
 			list<Watcher*> m_watchers;							// List of all the registered watchers.
 			list<list<Watcher*>::iterator*> m_watcherIterators;					// Iterators currently operating on the list of watchers
 			Internal::Platform::Mutex* m_notificationMutex;
+			Internal::NotificationDispatcher* m_notificationDispatcher;		// NULL if the NotificationThread option is false
 
 			//-----------------------------------------------------------------------------
 			// Controller commands
@@ -2613,6 +2790,25 @@ namespace OpenZWave
 			 */
 			void GetNodeStatistics(uint32 const _homeId, uint8 const _nodeId, Node::NodeData* _data);
 
+			/**
+			 * \brief Retrieve the latency distribution of a node
+			 * Round trip, acknowledgement and queue wait times are each kept in a
+			 * histogram, so the tail is visible and not just the average.
+			 * \param _homeId The Home ID of the driver for the node
+			 * \param _nodeId The node number
+			 * \param _data Pointer to structure NodeLatencyStats to return values, in microseconds
+			 * \see ResetNodeLatencyStats
+			 */
+			void GetNodeLatencyStats(uint32 const _homeId, uint8 const _nodeId, Node::NodeLatencyStats* _data);
+
+			/**
+			 * \brief Empty the latency histograms of a node, to start measuring afresh
+			 * \param _homeId The Home ID of the driver for the node
+			 * \param _nodeId The node number
+			 * \see GetNodeLatencyStats
+			 */
+			void ResetNodeLatencyStats(uint32 const _homeId, uint8 const _nodeId);
+
 			/**
 			 * \brief Get a Human Readable String for the RouteScheme in the Extended TX Status Frame
 			 * \param _data Pointer to the structure Node::NodeData return from GetNodeStatistics
@@ -27,6 +27,7 @@
 
 #include "ManufacturerSpecificDB.h"
 #include "tinyxml.h"
+#include "XmlReader.h"
 
 #include "Options.h"
 #include "Driver.h"
@@ -64,7 +65,7 @@ namespace OpenZWave
 		}
 
 		ManufacturerSpecificDB::ManufacturerSpecificDB() :
-				m_MfsMutex(new Internal::Platform::Mutex()), m_revision(0), m_latestRevision(0), m_initializing(true)
+				m_MfsMutex(new Internal::Platform::Mutex()), m_revision(0), m_latestRevision(0), m_initializing(true), m_configIndexLoaded(false), m_configIndexDirty(false)
 		{
 			// Ensure the singleton instance is set
 			s_instance = this;
@@ -87,50 +88,259 @@ namespace OpenZWave
 
 //-----------------------------------------------------------------------------
 // <ManufacturerSpecificDB::LoadConfigFileRevision>
-// Load the Config File Revision from each config file specified in our 
-// ManufacturerSpecific.xml file
+// Load the Config File Revision of a product from the config file index
 //-----------------------------------------------------------------------------
 		void ManufacturerSpecificDB::LoadConfigFileRevision(ProductDescriptor *product)
 		{
-			// Parse the Z-Wave manufacturer and product XML file.
+			if (product->GetConfigPath().size() > 0)
+			{
+				if (ConfigFileInfo const* info = GetConfigFileInfo(product->GetConfigPath()))
+				{
+					product->SetConfigRevision(info->m_revision);
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecificDB::GetConfigFileInfo>
+// Get the details of a config file from the index, only parsing the file if
+// it is new or has changed since it was indexed
+//-----------------------------------------------------------------------------
+		ManufacturerSpecificDB::ConfigFileInfo const* ManufacturerSpecificDB::GetConfigFileInfo(string const& _configPath)
+		{
+			LockGuard LG(m_MfsMutex);
+			LoadConfigIndex();
+
 			string configPath;
 			Options::Get()->GetOptionAsString("ConfigPath", &configPath);
+			string path = configPath + _configPath;
 
-			if (product->GetConfigPath().size() > 0)
+			map<string, ConfigFileInfo>::iterator it = m_configIndex.find(_configPath);
+			uint64 modified;
+			uint64 size;
+			if (!Internal::Platform::FileOps::Create()->FileStatus(path, &modified, &size))
+			{
+				if (it != m_configIndex.end())
+				{
+					m_configIndex.erase(it);
+					m_configIndexDirty = true;
+				}
+				return NULL;
+			}
+			if (it != m_configIndex.end() && it->second.m_modified == modified && it->second.m_size == size)
+			{
+				return &it->second;
+			}
+
+			ConfigFileInfo info;
+			info.m_modified = modified;
+			info.m_size = size;
+			info.m_revision = 0;
+			if (!ReadConfigFileInfo(path, &info))
 			{
-				string path = configPath + product->GetConfigPath();
+				return NULL;
+			}
+			m_configIndex[_configPath] = info;
+			m_configIndexDirty = true;
+			return &m_configIndex[_configPath];
+		}
 
-				TiXmlDocument* pDoc = new TiXmlDocument();
-				if (!pDoc->LoadFile(path.c_str(), TIXML_ENCODING_UTF8))
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecificDB::ReadConfigFileInfo>
+// Parse a config file for the details we keep in the index
+//-----------------------------------------------------------------------------
+		bool ManufacturerSpecificDB::ReadConfigFileInfo(string const& _path, ConfigFileInfo* _info)
+		{
+			// Only the root element and the metadata are needed, so stop reading there
+			XmlReader reader;
+			if (!reader.Open(_path) || !reader.NextChild(0))
+			{
+				Log::Write(LogLevel_Info, "Unable to load config file %s: %s", _path.c_str(), reader.GetError().c_str());
+				return false;
+			}
+			if (reader.GetName() == "Product")
+			{
+				XmlString str = reader.GetAttribute("xmlns");
+				if (str.Exists() && str != "https://github.com/OpenZWave/open-zwave")
 				{
-					delete pDoc;
-					Log::Write(LogLevel_Info, "Unable to load config file %s", path.c_str());
-					return;
+					Log::Write(LogLevel_Info, "Product Config File %s has incorrect xml Namespace", _path.c_str());
 				}
-				pDoc->SetUserData((void *) path.c_str());
-				TiXmlElement const* root = pDoc->RootElement();
-				char const *str = root->Value();
-				if (str && !strcmp(str, "Product"))
+				else
 				{
-					str = root->Attribute("xmlns");
-					if (str && strcmp(str, "https://github.com/OpenZWave/open-zwave"))
+					// Read in the revision attributes
+					int32 revision;
+					if (!reader.GetAttribute("Revision", &revision))
 					{
-						Log::Write(LogLevel_Info, "Product Config File % has incorrect xml Namespace", path.c_str());
-						delete pDoc;
-						return;
+						Log::Write(LogLevel_Info, "Error in Product Config file at line %d - missing Revision  attribute", reader.GetLine());
 					}
-					// Read in the revision attributes
-					str = root->Attribute("Revision");
-					if (!str)
+					else
+					{
+						_info->m_revision = revision;
+					}
+				}
+			}
+
+			uint32 depth = reader.GetDepth();
+			while (reader.NextChild(depth))
+			{
+				if (reader.GetName() == "MetaData")
+				{
+					uint32 metaDataDepth = reader.GetDepth();
+					while (reader.NextChild(metaDataDepth))
+					{
+						string pic;
+						if (reader.GetName() == "MetaDataItem" && reader.GetAttribute("name") == "ProductPic" && reader.ReadText(&pic))
+						{
+							_info->m_productPics.push_back(pic);
+						}
+					}
+					break;
+				}
+			}
+			if (reader.HasError())
+			{
+				Log::Write(LogLevel_Info, "Unable to load config file %s: %s", _path.c_str(), reader.GetError().c_str());
+				return false;
+			}
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecificDB::LoadConfigIndex>
+// Read the index of config files saved by an earlier run
+//-----------------------------------------------------------------------------
+		void ManufacturerSpecificDB::LoadConfigIndex()
+		{
+			if (m_configIndexLoaded)
+			{
+				return;
+			}
+			m_configIndexLoaded = true;
+
+			string configPath;
+			Options::Get()->GetOptionAsString("ConfigPath", &configPath);
+			string userPath;
+			Options::Get()->GetOptionAsString("UserPath", &userPath);
+			string filename = userPath + "ozwconfigindex.xml";
+
+			XmlReader reader;
+			if (!reader.Open(filename) || !reader.NextChild(0))
+			{
+				return;
+			}
+			int32 intVal;
+			string str;
+			if (!reader.GetAttribute("version", &intVal) || intVal != 1 || !reader.GetAttribute("config_path", &str) || configPath != str)
+			{
+				// Built by another version, or for another config folder
+				Log::Write(LogLevel_Info, "Ignoring config file index %s", filename.c_str());
+				return;
+			}
+
+			uint32 depth = reader.GetDepth();
+			while (reader.NextChild(depth))
+			{
+				if (reader.GetName() != "File")
+				{
+					continue;
+				}
+				string path;
+				uint64 modified;
+				uint64 size;
+				if (reader.GetAttribute("path", &path) && reader.GetAttribute("modified").ToUInt64(&modified) && reader.GetAttribute("size").ToUInt64(&size) && reader.GetAttribute("revision", &intVal))
+				{
+					ConfigFileInfo& info = m_configIndex[path];
+					info.m_modified = modified;
+					info.m_size = size;
+					info.m_revision = (uint32) intVal;
+					uint32 fileDepth = reader.GetDepth();
+					while (reader.NextChild(fileDepth))
 					{
-						Log::Write(LogLevel_Info, "Error in Product Config file at line %d - missing Revision  attribute", root->Row());
-						delete pDoc;
-						return;
+						string pic;
+						if (reader.GetName() == "ProductPic" && reader.ReadText(&pic))
+						{
+							info.m_productPics.push_back(pic);
+						}
 					}
-					product->SetConfigRevision(atol(str));
 				}
-				delete pDoc;
 			}
+			if (reader.HasError())
+			{
+				// Rather than trust part of it
+				Log::Write(LogLevel_Info, "Ignoring config file index %s: %s", filename.c_str(), reader.GetError().c_str());
+				m_configIndex.clear();
+				return;
+			}
+			Log::Write(LogLevel_Info, "Loaded %d entries from config file index %s", m_configIndex.size(), filename.c_str());
+		}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecificDB::SaveConfigIndex>
+// Save the index of config files, if it has changed
+//-----------------------------------------------------------------------------
+		void ManufacturerSpecificDB::SaveConfigIndex()
+		{
+			if (!m_configIndexDirty)
+			{
+				return;
+			}
+			m_configIndexDirty = false;
+
+			string configPath;
+			Options::Get()->GetOptionAsString("ConfigPath", &configPath);
+			string userPath;
+			Options::Get()->GetOptionAsString("UserPath", &userPath);
+			string filename = userPath + "ozwconfigindex.xml";
+
+			char str[32];
+			TiXmlDocument doc;
+			TiXmlElement* root = new TiXmlElement("ConfigIndex");
+			doc.LinkEndChild(new TiXmlDeclaration("1.0", "utf-8", ""));
+			doc.LinkEndChild(root);
+			root->SetAttribute("xmlns", "https://github.com/OpenZWave/open-zwave");
+			root->SetAttribute("version", 1);
+			root->SetAttribute("config_path", configPath.c_str());
+
+			for (map<string, ConfigFileInfo>::iterator it = m_configIndex.begin(); it != m_configIndex.end(); ++it)
+			{
+				TiXmlElement* fileElement = new TiXmlElement("File");
+				root->LinkEndChild(fileElement);
+				fileElement->SetAttribute("path", it->first.c_str());
+				snprintf(str, sizeof(str), "%llu", (unsigned long long) it->second.m_modified);
+				fileElement->SetAttribute("modified", str);
+				snprintf(str, sizeof(str), "%llu", (unsigned long long) it->second.m_size);
+				fileElement->SetAttribute("size", str);
+				fileElement->SetAttribute("revision", it->second.m_revision);
+				for (list<string>::iterator pit = it->second.m_productPics.begin(); pit != it->second.m_productPics.end(); ++pit)
+				{
+					TiXmlElement* picElement = new TiXmlElement("ProductPic");
+					fileElement->LinkEndChild(picElement);
+					picElement->LinkEndChild(new TiXmlText(pit->c_str()));
+				}
+			}
+
+			TiXmlPrinter printer;
+			doc.Accept(&printer);
+			if (!Internal::Platform::FileOps::Create()->FileWriteAtomic(filename, string(printer.CStr(), printer.Size())))
+			{
+				Log::Write(LogLevel_Info, "Unable to save config file index %s", filename.c_str());
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecificDB::RefreshConfigIndex>
+// Bring the index up to date with every config file we know of.  Only the
+// files that changed since the last run are parsed.
+//-----------------------------------------------------------------------------
+		void ManufacturerSpecificDB::RefreshConfigIndex()
+		{
+			LockGuard LG(m_MfsMutex);
+			map<int64, std::shared_ptr<ProductDescriptor> >::iterator pit;
+			for (pit = s_productMap.begin(); pit != s_productMap.end(); pit++)
+			{
+				LoadConfigFileRevision(pit->second.get());
+			}
+			SaveConfigIndex();
 		}
 
 //-----------------------------------------------------------------------------
@@ -147,24 +357,20 @@ namespace OpenZWave
 
 			string filename = configPath + "manufacturer_specific.xml";
 
-			TiXmlDocument* pDoc = new TiXmlDocument();
-			if (!pDoc->LoadFile(filename.c_str(), TIXML_ENCODING_UTF8))
+			XmlReader reader;
+			if (!reader.Open(filename) || !reader.NextChild(0))
 			{
-				delete pDoc;
-				Log::Write(LogLevel_Info, "Unable to load %s", filename.c_str());
+				Log::Write(LogLevel_Info, "Unable to load %s: %s", filename.c_str(), reader.GetError().c_str());
 				return false;
 			}
-			pDoc->SetUserData((void *) filename.c_str());
-			TiXmlElement const* root = pDoc->RootElement();
 
-			char const* str;
-			char* pStopChar;
+			string str;
+			int32 intVal;
 
-			str = root->Attribute("Revision");
-			if (str)
+			if (reader.GetAttribute("Revision", &str))
 			{
-				Log::Write(LogLevel_Info, "Manufacturer_Specific.xml file Revision is %s", str);
-				m_revision = atoi(str);
+				Log::Write(LogLevel_Info, "Manufacturer_Specific.xml file Revision is %s", str.c_str());
+				m_revision = atoi(str.c_str());
 			}
 			else
 			{
@@ -172,77 +378,62 @@ namespace OpenZWave
 				m_revision = 0;
 			}
 
-			TiXmlElement const* manufacturerElement = root->FirstChildElement();
-			while (manufacturerElement)
+			uint32 depth = reader.GetDepth();
+			while (reader.NextChild(depth))
 			{
-				str = manufacturerElement->Value();
-				if (str && !strcmp(str, "Manufacturer"))
+				if (reader.GetName() == "Manufacturer")
 				{
 					// Read in the manufacturer attributes
-					str = manufacturerElement->Attribute("id");
-					if (!str)
+					if (!reader.GetAttribute("id", &intVal, 16))
 					{
-						Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing manufacturer id attribute", manufacturerElement->Row());
-						delete pDoc;
+						Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing manufacturer id attribute", reader.GetLine());
 						return false;
 					}
-					uint16 manufacturerId = (uint16) strtol(str, &pStopChar, 16);
+					uint16 manufacturerId = (uint16) intVal;
 
-					str = manufacturerElement->Attribute("name");
-					if (!str)
+					if (!reader.GetAttribute("name", &str))
 					{
-						Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing manufacturer name attribute", manufacturerElement->Row());
-						delete pDoc;
+						Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing manufacturer name attribute", reader.GetLine());
 						return false;
 					}
 
 					// Add this manufacturer to the map
-					s_manufacturerMap[manufacturerId] = str;
+					string& manufacturerName = s_manufacturerMap[manufacturerId];
+					manufacturerName = str;
 
 					// Parse all the products for this manufacturer
-					TiXmlElement const* productElement = manufacturerElement->FirstChildElement();
-					while (productElement)
+					uint32 manufacturerDepth = reader.GetDepth();
+					while (reader.NextChild(manufacturerDepth))
 					{
-						str = productElement->Value();
-						if (str && !strcmp(str, "Product"))
+						if (reader.GetName() == "Product")
 						{
-							str = productElement->Attribute("type");
-							if (!str)
+							if (!reader.GetAttribute("type", &intVal, 16))
 							{
-								Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing product type attribute", productElement->Row());
-								delete pDoc;
+								Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing product type attribute", reader.GetLine());
 								return false;
 							}
-							uint16 productType = (uint16) strtol(str, &pStopChar, 16);
+							uint16 productType = (uint16) intVal;
 
-							str = productElement->Attribute("id");
-							if (!str)
+							if (!reader.GetAttribute("id", &intVal, 16))
 							{
-								Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing product id attribute", productElement->Row());
-								delete pDoc;
+								Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing product id attribute", reader.GetLine());
 								return false;
 							}
-							uint16 productId = (uint16) strtol(str, &pStopChar, 16);
+							uint16 productId = (uint16) intVal;
 
-							str = productElement->Attribute("name");
-							if (!str)
+							string productName;
+							if (!reader.GetAttribute("name", &productName))
 							{
-								Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing product name attribute", productElement->Row());
-								delete pDoc;
+								Log::Write(LogLevel_Info, "Error in manufacturer_specific.xml at line %d - missing product name attribute", reader.GetLine());
 								return false;
 							}
-							string productName = str;
 
 							// Optional config path
 							string dconfigPath;
-							str = productElement->Attribute("config");
-							if (str)
-							{
-								dconfigPath = str;
-							}
+							reader.GetAttribute("config", &dconfigPath);
 
 							// Add the product to the map
-							ProductDescriptor* product = new ProductDescriptor(manufacturerId, productType, productId, productName, s_manufacturerMap[manufacturerId], dconfigPath);
+							ProductDescriptor* product = new ProductDescriptor(manufacturerId, productType, productId, productName, manufacturerName, dconfigPath);
 							if (s_productMap[product->GetKey()] != NULL)
 							{
 								std::shared_ptr<ProductDescriptor> c = s_productMap[product->GetKey()];
@@ -251,22 +442,19 @@ namespace OpenZWave
 							}
 							else
 							{
-								LoadConfigFileRevision(product);
+								// The config file revision is read from the index when the product is requested
 								s_productMap[product->GetKey()] = std::shared_ptr<ProductDescriptor>(product);
 							}
 						}
-
-						// Move on to the next product.
-						productElement = productElement->NextSiblingElement();
 					}
 				}
-
-				// Move on to the next manufacturer.
-				manufacturerElement = manufacturerElement->NextSiblingElement();
+			}
+			if (reader.HasError())
+			{
+				Log::Write(LogLevel_Info, "Unable to load %s: %s", filename.c_str(), reader.GetError().c_str());
+				return false;
 			}
 			s_bXmlLoaded = true;
-
-			delete pDoc;
 			return true;
 		}
 
@@ -309,6 +497,9 @@ namespace OpenZWave
 			string configPath;
 			Options::Get()->GetOptionAsString("ConfigPath", &configPath);
 
+			// Only the config files that changed since the last run are parsed
+			RefreshConfigIndex();
+
 			map<int64, std::shared_ptr<ProductDescriptor> >::iterator pit;
 			for (pit = s_productMap.begin(); pit != s_productMap.end(); pit++)
 			{
@@ -316,7 +507,8 @@ namespace OpenZWave
 				if (c->GetConfigPath().size() > 0)
 				{
 					string path = configPath + c->GetConfigPath();
-					if (!Internal::Platform::FileOps::Create()->FileExists(path)) { 
+					map<string, ConfigFileInfo>::iterator iit = m_configIndex.find(c->GetConfigPath());
+					if (iit == m_configIndex.end() && !Internal::Platform::FileOps::Create()->FileExists(path)) { 
 						/* check if we are downloading already */
 						std::list<string>::iterator iter = std::find(m_downloading.begin(), m_downloading.end(), path);
 						/* check if the file exists */
@@ -341,9 +533,9 @@ namespace OpenZWave
 							Log::Write(LogLevel_Debug, "Config file for %s already queued", c->GetProductName().c_str());
 						}
 					}
-					else 
+					else if (iit != m_configIndex.end())
 					{
-						checkConfigFileContents(driver, path);	
+						checkConfigFileContents(driver, iit->second);
 					}
 				}
 			}
@@ -373,48 +565,26 @@ namespace OpenZWave
 			}
 		}
 
-		void ManufacturerSpecificDB::checkConfigFileContents(Driver *driver, string file) 
+		void ManufacturerSpecificDB::checkConfigFileContents(Driver *driver, ConfigFileInfo const& info)
 		{
 			string configPath;
 			Options::Get()->GetOptionAsString("ConfigPath", &configPath);
-			TiXmlDocument* pDoc = new TiXmlDocument();
-			if (!pDoc->LoadFile(file.c_str(), TIXML_ENCODING_UTF8))
+			for (list<string>::const_iterator it = info.m_productPics.begin(); it != info.m_productPics.end(); ++it)
 			{
-				delete pDoc;
-				Log::Write(LogLevel_Info, "Unable to load %s", file.c_str());
-				return;
-			}
-			pDoc->SetUserData((void *) file.c_str());
-			TiXmlElement const* root = pDoc->RootElement();
-
-			TiXmlElement const* metaDataElement = root->FirstChildElement("MetaData");
-			if (metaDataElement) {
-				TiXmlElement const* metaDataItem = metaDataElement->FirstChildElement("MetaDataItem");
-				while (metaDataItem) {
-					char const *str = metaDataItem->Attribute("name");
-					if (str && !strcmp(str, "ProductPic"))
+				string imagefile = configPath + *it;
+				if (!Internal::Platform::FileOps::Create()->FileExists(imagefile)) 
+				{ 
+					/* check if we are downloading already */
+					std::list<string>::iterator iter = std::find(m_downloading.begin(), m_downloading.end(), imagefile);
+					/* check if the file exists */
+					if (iter == m_downloading.end())
 					{
-						str = metaDataItem->GetText();
-						if (str) 
-						{ 
-							string imagefile = configPath + str;
-							if (!Internal::Platform::FileOps::Create()->FileExists(imagefile)) 
-							{ 
-								/* check if we are downloading already */
-								std::list<string>::iterator iter = std::find(m_downloading.begin(), m_downloading.end(), imagefile);
-								/* check if the file exists */
-								if (iter == m_downloading.end())
-								{
-									if (driver->startDownload(imagefile, metaDataItem->GetText())) {
-										Log::Write(LogLevel_Info, "Missing Picture %s - Starting Download", imagefile.c_str());
-										m_downloading.push_back(imagefile);
-									}
-								}
-							}
+						if (driver->startDownload(imagefile, *it)) {
+							Log::Write(LogLevel_Info, "Missing Picture %s - Starting Download", imagefile.c_str());
+							m_downloading.push_back(imagefile);
 						}
 					}
-					metaDataItem = metaDataItem->NextSiblingElement("MetaDataItem");
-				}				
+				}
 			}
 		}
 
@@ -490,6 +660,10 @@ namespace OpenZWave
 				map<int64, std::shared_ptr<ProductDescriptor> >::iterator pit = s_productMap.find(ProductDescriptor::GetKey(_manufacturerId, _productType, _productId));
 				if (pit != s_productMap.end())
 				{
+					// A node with this product is present, so make sure we know its config file revision
+					LockGuard LG(m_MfsMutex);
+					LoadConfigFileRevision(pit->second.get());
+					SaveConfigIndex();
 					return pit->second;
 				}
 			}
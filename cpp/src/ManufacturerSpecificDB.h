@@ -147,12 +147,26 @@ namespace OpenZWave
 				bool updateConfigFile(Driver *, Node *);
 				bool updateMFSConfigFile(Driver *);
 				void checkInitialized();
+				void RefreshConfigIndex();
 
 			private:
+				/** What we remember about a device config file, so it is only parsed again when it changes */
+				struct ConfigFileInfo
+				{
+						uint64 m_modified;
+						uint64 m_size;
+						uint32 m_revision;
+						list<string> m_productPics;
+				};
+
 				void LoadConfigFileRevision(ProductDescriptor *product);
 				ManufacturerSpecificDB();
 				~ManufacturerSpecificDB();
-				void checkConfigFileContents(Driver *driver, string file);
+				void checkConfigFileContents(Driver *driver, ConfigFileInfo const& info);
+				ConfigFileInfo const* GetConfigFileInfo(string const& _configPath);
+				bool ReadConfigFileInfo(string const& _path, ConfigFileInfo* _info);
+				void LoadConfigIndex();
+				void SaveConfigIndex();
 
 				Internal::Platform::Mutex* m_MfsMutex; /**< Mutex to ensure its accessed by a single thread at a time */
 
@@ -170,6 +184,10 @@ namespace OpenZWave
 				uint32 m_latestRevision;
 				bool m_initializing;
 
+				map<string, ConfigFileInfo> m_configIndex;		// Config files by their path relative to ConfigPath
+				bool m_configIndexLoaded;
+				bool m_configIndexDirty;
+
 		};
 
 	} // namespace Internal
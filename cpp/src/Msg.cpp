@@ -27,6 +27,7 @@
 
 #include "Defs.h"
 #include "Msg.h"
+#include "BlockPool.h"
 #include "Node.h"
 #include "Manager.h"
 #include "Utils.h"
@@ -41,18 +42,73 @@ namespace OpenZWave
 	namespace Internal
 	{
 
+		namespace
+		{
+			// Messages are carved out of slabs of this many blocks
+			uint32 const c_msgsPerSlab = 32;
+
+			BlockPool& GetMsgPool()
+			{
+				// Never destroyed, so messages can still be freed during static destruction
+				static BlockPool* pool = new BlockPool(sizeof(Msg), c_msgsPerSlab);
+				return *pool;
+			}
+		}
+
 		/* Callback for normal messages start at 10. Special Messages using a Callback prior to 10 */
 		uint8 Msg::s_nextCallbackId = 10;
 
 //-----------------------------------------------------------------------------
 // <Msg::Msg>
 // Constructor
+//-----------------------------------------------------------------------------
+		Msg::Msg(char const* _logText, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired,			// = true
+				uint8 const _expectedReply,			// = 0
+				uint8 const _expectedCommandClassId	// = 0
+				) :
+				m_logText(_logText), m_bFinal(false), m_bCallbackRequired(_bCallbackRequired), m_callbackId(0), m_expectedReply(0), m_expectedCommandClassId(_expectedCommandClassId), m_length(4), m_commandClassId(0), m_command(0), e_buffer(NULL), m_targetNodeId(_targetNodeId), m_sendAttempts(0), m_maxSendAttempts( MAX_TRIES), m_instance(1), m_endPoint(0), m_flags(0), m_encapsulated(false), m_encrypted(false), m_noncerecvd(false), m_homeId(0), m_queuedTime(0), m_resendDuetoCANorNAK(false)
+		{
+			Init(_msgType, _function, _bReplyRequired, _expectedReply);
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::Msg>
+// Constructor, for formatted log text
 //-----------------------------------------------------------------------------
 		Msg::Msg(string const& _logText, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired,			// = true
 				uint8 const _expectedReply,			// = 0
 				uint8 const _expectedCommandClassId	// = 0
 				) :
-				m_logText(_logText), m_bFinal(false), m_bCallbackRequired(_bCallbackRequired), m_callbackId(0), m_expectedReply(0), m_expectedCommandClassId(_expectedCommandClassId), m_length(4), m_targetNodeId(_targetNodeId), m_sendAttempts(0), m_maxSendAttempts( MAX_TRIES), m_instance(1), m_endPoint(0), m_flags(0), m_encrypted(false), m_noncerecvd(false), m_homeId(0), m_resendDuetoCANorNAK(false)
+				m_logText(NULL), m_logTextCopy(_logText), m_bFinal(false), m_bCallbackRequired(_bCallbackRequired), m_callbackId(0), m_expectedReply(0), m_expectedCommandClassId(_expectedCommandClassId), m_length(4), m_commandClassId(0), m_command(0), e_buffer(NULL), m_targetNodeId(_targetNodeId), m_sendAttempts(0), m_maxSendAttempts( MAX_TRIES), m_instance(1), m_endPoint(0), m_flags(0), m_encapsulated(false), m_encrypted(false), m_noncerecvd(false), m_homeId(0), m_queuedTime(0), m_resendDuetoCANorNAK(false)
+		{
+			Init(_msgType, _function, _bReplyRequired, _expectedReply);
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::Msg>
+// Copy constructor.  The encryption buffer is scratch space, so it is not copied.
+//-----------------------------------------------------------------------------
+		Msg::Msg(Msg const& _other) :
+				m_logText(_other.m_logText), m_logTextCopy(_other.m_logTextCopy), m_bFinal(_other.m_bFinal), m_bCallbackRequired(_other.m_bCallbackRequired), m_callbackId(_other.m_callbackId), m_expectedReply(_other.m_expectedReply), m_expectedCommandClassId(_other.m_expectedCommandClassId), m_length(_other.m_length), m_commandClassId(_other.m_commandClassId), m_command(_other.m_command), e_buffer(NULL), m_targetNodeId(_other.m_targetNodeId), m_sendAttempts(_other.m_sendAttempts), m_maxSendAttempts(_other.m_maxSendAttempts), m_instance(_other.m_instance), m_endPoint(_other.m_endPoint), m_flags(_other.m_flags), m_encapsulated(_other.m_encapsulated), m_encrypted(_other.m_encrypted), m_noncerecvd(_other.m_noncerecvd), m_homeId(_other.m_homeId), m_queuedTime(_other.m_queuedTime), m_resendDuetoCANorNAK(_other.m_resendDuetoCANorNAK)
+		{
+			memcpy(m_buffer, _other.m_buffer, sizeof(m_buffer));
+			memcpy(m_nonce, _other.m_nonce, sizeof(m_nonce));
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::~Msg>
+// Destructor
+//-----------------------------------------------------------------------------
+		Msg::~Msg()
+		{
+			delete[] e_buffer;
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::Init>
+// Set up the frame header
+//-----------------------------------------------------------------------------
+		void Msg::Init(uint8 const _msgType, uint8 const _function, bool const _bReplyRequired, uint8 const _expectedReply)
 		{
 			if (_bReplyRequired)
 			{
@@ -61,7 +117,7 @@ namespace OpenZWave
 			}
 
 			memset(m_buffer, 0x00, 256);
-			memset(e_buffer, 0x00, 256);
+			memset(m_nonce, 0x00, 8);
 
 			m_buffer[0] = SOF;
 			m_buffer[1] = 0;					// Length of the following data, filled in during Finalize.
@@ -69,6 +125,48 @@ namespace OpenZWave
 			m_buffer[3] = _function;
 		}
 
+//-----------------------------------------------------------------------------
+// <Msg::operator new>
+// Take a block from the message pool
+//-----------------------------------------------------------------------------
+		void* Msg::operator new(size_t _size)
+		{
+			if (_size != sizeof(Msg))
+			{
+				return ::operator new(_size);
+			}
+
+			return GetMsgPool().Allocate();
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::operator delete>
+// Return a block to the message pool.  Slabs are kept for the next burst.
+//-----------------------------------------------------------------------------
+		void Msg::operator delete(void* _ptr, size_t _size)
+		{
+			if (!_ptr)
+			{
+				return;
+			}
+			if (_size != sizeof(Msg))
+			{
+				::operator delete(_ptr);
+				return;
+			}
+
+			GetMsgPool().Free(_ptr);
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::GetPoolStatistics>
+// Get the statistics of the message pool
+//-----------------------------------------------------------------------------
+		void Msg::GetPoolStatistics(uint32* o_allocations, uint32* o_heapAllocations, uint32* o_inUse)
+		{
+			GetMsgPool().GetStatistics(o_allocations, o_heapAllocations, o_inUse);
+		}
+
 //-----------------------------------------------------------------------------
 // <Msg::SetInstance>
 // Used to enable wrapping with MultiInstance/MultiChannel during finalize.
@@ -135,6 +233,13 @@ namespace OpenZWave
 				return;
 			}
 
+			// Remember what is being sent, so the driver can recognise superseded messages
+			if (m_buffer[3] == FUNC_ID_ZW_SEND_DATA && m_length >= 8)
+			{
+				m_commandClassId = m_buffer[6];
+				m_command = m_buffer[7];
+			}
+
 			// Deal with Multi-Channel/Instance encapsulation
 			if ((m_flags & (m_MultiChannel | m_MultiInstance)) != 0)
 			{
@@ -199,13 +304,46 @@ namespace OpenZWave
 			}
 		}
 
+//-----------------------------------------------------------------------------
+// <Msg::GetLogText>
+// Get the log text, including the encapsulation added by Finalize
+//-----------------------------------------------------------------------------
+		string Msg::GetLogText() const
+		{
+			if (!m_encapsulated)
+			{
+				return GetLogTextBase();
+			}
+			char str[256];
+			FormatLogText(str, sizeof(str));
+			return str;
+		}
+
+//-----------------------------------------------------------------------------
+// <Msg::FormatLogText>
+// Write the log text into a buffer.  The encapsulation prefix is only
+// formatted here, when the text is actually logged.
+//-----------------------------------------------------------------------------
+		int Msg::FormatLogText(char* _buf, size_t _size) const
+		{
+			if (!m_encapsulated)
+			{
+				return snprintf(_buf, _size, "%s", GetLogTextBase());
+			}
+			if ((m_flags & m_MultiChannel) != 0)
+			{
+				return snprintf(_buf, _size, "MultiChannel Encapsulated (instance=%d): %s", m_instance, GetLogTextBase());
+			}
+			return snprintf(_buf, _size, "MultiInstance Encapsulated (instance=%d): %s", m_instance, GetLogTextBase());
+		}
+
 //-----------------------------------------------------------------------------
 // <Msg::GetAsString>
 // Create a string containing the raw data
 //-----------------------------------------------------------------------------
 		std::string Msg::GetAsString()
 		{
-			string str = m_logText;
+			string str = GetLogText();
 
 			char byteStr[16];
 			if (m_targetNodeId != 0xff)
@@ -230,17 +368,47 @@ namespace OpenZWave
 			return str;
 		}
 
+//-----------------------------------------------------------------------------
+// <Msg::GetAsString>
+// Same as above, but without allocating (for the send and receive hot paths)
+//-----------------------------------------------------------------------------
+		char const* Msg::GetAsString(char* _buf, size_t _size) const
+		{
+			int len = FormatLogText(_buf, _size);
+			if ((len >= 0) && ((size_t) len < _size))
+			{
+				int more;
+				if (m_targetNodeId != 0xff)
+				{
+					more = snprintf(_buf + len, _size - len, " (Node=%d): ", m_targetNodeId);
+				}
+				else
+				{
+					more = snprintf(_buf + len, _size - len, ": ");
+				}
+				if (more >= 0)
+				{
+					len += more;
+				}
+			}
+			if ((len >= 0) && ((size_t) len < _size))
+			{
+				PktToString(m_buffer, m_length, _buf + len, _size - len);
+			}
+			return _buf;
+		}
+
 //-----------------------------------------------------------------------------
 // <Msg::MultiEncap>
 // Encapsulate the data inside a MultiInstance/Multicommand message
 //-----------------------------------------------------------------------------
 		void Msg::MultiEncap()
 		{
-			char str[256];
 			if (m_buffer[3] != FUNC_ID_ZW_SEND_DATA)
 			{
 				return;
 			}
+			m_encapsulated = true;
 
 			// Insert the encap header
 			if ((m_flags & m_MultiChannel) != 0)
@@ -258,8 +426,6 @@ namespace OpenZWave
 				m_buffer[9] = m_endPoint;
 				m_length += 4;
 
-				snprintf(str, sizeof(str), "MultiChannel Encapsulated (instance=%d): %s", m_instance, m_logText.c_str());
-				m_logText = str;
 			}
 			else
 			{
@@ -275,8 +441,6 @@ namespace OpenZWave
 				m_buffer[8] = m_instance;
 				m_length += 3;
 
-				snprintf(str, sizeof(str), "MultiInstance Encapsulated (instance=%d): %s", m_instance, m_logText.c_str());
-				m_logText = str;
 			}
 		}
 
@@ -294,7 +458,12 @@ namespace OpenZWave
 			Log::Write(LogLevel_Info, m_targetNodeId, "Encrypted Flag is %d", m_encrypted);
 			if (m_encrypted == false)
 				return m_buffer;
-			else if (EncryptBuffer(m_buffer, m_length, GetDriver(), GetDriver()->GetControllerNodeId(), m_targetNodeId, m_nonce, e_buffer))
+			if (!e_buffer)
+			{
+				e_buffer = new uint8[256];
+				memset(e_buffer, 0x00, 256);
+			}
+			if (EncryptBuffer(m_buffer, m_length, GetDriver(), GetDriver()->GetControllerNodeId(), m_targetNodeId, m_nonce, e_buffer))
 			{
 				return e_buffer;
 			}
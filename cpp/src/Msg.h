@@ -56,10 +56,29 @@ namespace OpenZWave
 					m_MultiInstance = 0x02,		// Indicate MultiInstance encapsulation
 				};
 
+				/**
+				 * \brief Create a message whose log text is a string literal.  The text is not copied,
+				 * so it must outlive the message.  Use the string constructor for formatted text.
+				 */
+				Msg(char const* _logtext, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0);
 				Msg(string const& _logtext, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0);
-				~Msg()
-				{
-				}
+				Msg(Msg const& _other);
+				~Msg();
+
+				/**
+				 * \brief Messages are allocated from a pool of fixed size blocks, as thousands of them are created
+				 * and freed while nodes are queried.
+				 */
+				static void* operator new(size_t _size);
+				static void operator delete(void* _ptr, size_t _size);
+
+				/**
+				 * \brief Get the statistics of the message pool, which is shared by all drivers.
+				 * \param o_allocations receives the number of messages allocated since startup.
+				 * \param o_heapAllocations receives the number of those that needed memory from the heap, because the pool was empty.
+				 * \param o_inUse receives the number of messages that currently exist.
+				 */
+				static void GetPoolStatistics(uint32* o_allocations, uint32* o_heapAllocations, uint32* o_inUse);
 
 				void SetInstance(OpenZWave::Internal::CC::CommandClass * _cc, uint8 const _instance);	// Used to enable wrapping with MultiInstance/MultiChannel during finalize.
 
@@ -129,10 +148,7 @@ namespace OpenZWave
 				 * \brief get the LogText Associated with this message
 				 * \return the LogText used during the constructor
 				 */
-				string GetLogText() const
-				{
-					return m_logText;
-				}
+				string GetLogText() const;
 
 				uint32 GetLength() const
 				{
@@ -141,6 +157,14 @@ namespace OpenZWave
 				uint8* GetBuffer();
 				string GetAsString();
 
+				/**
+				 * \brief Format the log text and raw bytes of the message into a caller supplied buffer
+				 * \param _buf buffer that receives the text (truncated if too small)
+				 * \param _size size of _buf in bytes
+				 * \return _buf, so the call can be used directly as a Log::Write argument
+				 */
+				char const* GetAsString(char* _buf, size_t _size) const;
+
 				uint8 GetSendAttempts() const
 				{
 					return m_sendAttempts;
@@ -150,6 +174,18 @@ namespace OpenZWave
 					m_sendAttempts = _count;
 				}
 
+				/**
+				 * \brief Monotonic time in microseconds at which the message was put on a send queue, or zero
+				 */
+				uint64 GetQueuedTime() const
+				{
+					return m_queuedTime;
+				}
+				void SetQueuedTime(uint64 _time)
+				{
+					m_queuedTime = _time;
+				}
+
 				uint8 GetMaxSendAttempts() const
 				{
 					return m_maxSendAttempts;
@@ -180,6 +216,23 @@ namespace OpenZWave
 
 					return false;
 				}
+				/**
+				 * \brief Identifies the command class of a FUNC_ID_ZW_SEND_DATA message, before any MultiInstance/MultiChannel encapsulation.
+				 * \return the command class ID, or zero if this is not a finalized send data message.
+				 */
+				uint8 GetCommandClassId() const
+				{
+					return m_commandClassId;
+				}
+
+				/**
+				 * \brief Identifies the command of a FUNC_ID_ZW_SEND_DATA message, before any MultiInstance/MultiChannel encapsulation.
+				 * \return the command, or zero if this is not a finalized send data message.
+				 */
+				uint8 GetCommand() const
+				{
+					return m_command;
+				}
 				uint8 GetSendingCommandClass()
 				{
 					if (m_buffer[3] == 0x13)
@@ -188,6 +241,22 @@ namespace OpenZWave
 					}
 					return 0;
 				}
+				/**
+				 * \brief Get the command class payload of a finalized FUNC_ID_ZW_SEND_DATA message.
+				 * \param _length receives the number of payload bytes.
+				 * \param _txOptions receives the transmit options.
+				 * \return pointer to the payload, or NULL if this is not a finalized send data message.
+				 */
+				uint8 const* GetSendDataPayload(uint8* _length, uint8* _txOptions) const
+				{
+					if (!m_bFinal || m_buffer[3] != 0x13 || m_buffer[5] == 0)
+					{
+						return NULL;
+					}
+					*_length = m_buffer[5];
+					*_txOptions = m_buffer[6 + m_buffer[5]];
+					return &m_buffer[6];
+				}
 				bool isEncrypted()
 				{
 					return m_encrypted;
@@ -230,8 +299,18 @@ namespace OpenZWave
 				Driver* GetDriver() const;
 			private:
 
+				void Init(uint8 const _msgType, uint8 const _function, bool const _bReplyRequired, uint8 const _expectedReply);
 				void MultiEncap();						// Encapsulate the data inside a MultiInstance/Multicommand message
-				string m_logText;
+				char const* GetLogTextBase() const
+				{
+					return m_logText ? m_logText : m_logTextCopy.c_str();
+				}
+				int FormatLogText(char* _buf, size_t _size) const;
+
+				Msg& operator =(Msg const&);			// prevent assignment
+
+				char const* m_logText;					// The log text when it is a literal, otherwise NULL
+				string m_logTextCopy;					// The log text when it had to be copied
 				bool m_bFinal;
 				bool m_bCallbackRequired;
 
@@ -239,8 +318,10 @@ namespace OpenZWave
 				uint8 m_expectedReply;
 				uint8 m_expectedCommandClassId;
 				uint8 m_length;
+				uint8 m_commandClassId;			// Command class and command of a send data message, recorded before encapsulation
+				uint8 m_command;
 				uint8 m_buffer[256];
-				uint8 e_buffer[256];
+				uint8* e_buffer;				// Only allocated once the message is encrypted
 
 				uint8 m_targetNodeId;
 				uint8 m_sendAttempts;
@@ -249,11 +330,13 @@ namespace OpenZWave
 				uint8 m_instance;
 				uint8 m_endPoint;				// Endpoint to use if the message must be wrapped in a multiInstance or multiChannel command class
 				uint8 m_flags;
+				bool m_encapsulated;			// MultiEncap has wrapped the message, so the log text gets a prefix
 
 				bool m_encrypted;
 				bool m_noncerecvd;
 				uint8 m_nonce[8];
 				uint32 m_homeId;
+				uint64 m_queuedTime;
 				static uint8 s_nextCallbackId;		// counter to get a unique callback id
 				/* we are resending this message due to CAN or NAK messages */
 				bool m_resendDuetoCANorNAK;
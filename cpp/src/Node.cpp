@@ -35,6 +35,7 @@
 #include "Driver.h"
 #include "Localization.h"
 #include "ManufacturerSpecificDB.h"
+#include "BinaryCache.h"
 #include "Notification.h"
 #include "Msg.h"
 #include "ZWSecurity.h"
@@ -85,11 +86,8 @@ using namespace OpenZWave;
 // Statics
 //-----------------------------------------------------------------------------
 bool Node::s_deviceClassesLoaded = false;
-map<uint8, string> Node::s_basicDeviceClasses;
-map<uint8, Node::GenericDeviceClass*> Node::s_genericDeviceClasses;
-map<uint8, Node::DeviceClass*> Node::s_roleDeviceClasses;
-map<uint16, Node::DeviceClass*> Node::s_deviceTypeClasses;
-map<uint8, Node::DeviceClass*> Node::s_nodeTypes;
+Internal::ConfigTables::DeviceClassData Node::s_deviceClasses;
+Internal::ConfigTables::Store Node::s_deviceClassStore;
 
 static char const* c_queryStageNames[] =
 { "None", "ProtocolInfo", "Probe", "WakeUp", "NodeInfo", "NodePlusInfo", "SecurityReport", "Versions", "ManufacturerSpecific1", "Instances", "ManufacturerSpecific2", "Static", "CacheLoad", "Associations", "Neighbors", "Session", "Dynamic", "Configuration", "Complete" };
@@ -101,9 +99,9 @@ static char const* c_queryStageNames[] =
 Node::Node(uint32 const _homeId, uint8 const _nodeId) :
 		m_queryStage(QueryStage_None), m_queryPending(false), m_queryConfiguration(false), m_queryRetries(0), m_protocolInfoReceived(false), m_basicprotocolInfoReceived(false), m_nodeInfoReceived(false), m_nodePlusInfoReceived(false), m_manufacturerSpecificClassReceived(false), m_nodeInfoSupported(true), m_refreshonNodeInfoFrame(true), m_nodeAlive(true),	// assome live node
 		m_listening(true),	// assume we start out listening
-		m_frequentListening(false), m_beaming(false), m_routing(false), m_maxBaudRate(0), m_version(0), m_security(false), m_homeId(_homeId), m_nodeId(_nodeId), m_basic(0), m_generic(0), m_specific(0), m_type(""), m_addingNode(false), m_manufacturerName(""), m_productName(""), m_nodeName(""), m_location(""), m_manufacturerId(0), m_productType(0), m_productId(0), m_deviceType(0), m_role(0), m_nodeType(0), m_secured(false), m_nodeCache( NULL), m_Product( NULL), m_fileConfigRevision(0), m_loadedConfigRevision(
-				0), m_latestConfigRevision(0), m_values(new Internal::VC::ValueStore()), m_sentCnt(0), m_sentFailed(0), m_retries(0), m_receivedCnt(0), m_receivedDups(0), m_receivedUnsolicited(0), m_lastRequestRTT(0), m_lastResponseRTT(0), m_averageRequestRTT(0), m_averageResponseRTT(0), m_quality(0), m_lastReceivedMessage(), m_errors(0), m_txStatusReportSupported(false), m_txTime(0), m_hops(0), m_ackChannel(0), m_lastTxChannel(0), m_routeScheme((TXSTATUS_ROUTING_SCHEME) 0), m_routeUsed
-		{ }, m_routeSpeed((TXSTATUS_ROUTE_SPEED) 0), m_routeTries(0), m_lastFailedLinkFrom(0), m_lastFailedLinkTo(0), m_lastnonce(0)
+		m_frequentListening(false), m_beaming(false), m_routing(false), m_maxBaudRate(0), m_version(0), m_security(false), m_homeId(_homeId), m_nodeId(_nodeId), m_basic(0), m_generic(0), m_specific(0), m_type(""), m_addingNode(false), m_manufacturerName(""), m_productName(""), m_nodeName(""), m_location(""), m_manufacturerId(0), m_productType(0), m_productId(0), m_deviceType(0), m_role(0), m_nodeType(0), m_secured(false), m_Product( NULL), m_fileConfigRevision(0), m_loadedConfigRevision(
+				0), m_latestConfigRevision(0), m_values(new Internal::VC::ValueStore()), m_sentCnt(0), m_sentFailed(0), m_retries(0), m_receivedCnt(0), m_receivedDups(0), m_receivedUnsolicited(0), m_lastRequestRTT(0), m_lastResponseRTT(0), m_sentTime(0), m_latencyMutex(new Internal::Platform::Mutex()), m_quality(0), m_lastReceivedMessage(), m_errors(0), m_txStatusReportSupported(false), m_txTime(0), m_hops(0), m_ackChannel(0), m_lastTxChannel(0), m_routeScheme((TXSTATUS_ROUTING_SCHEME) 0), m_routeUsed
+		{ }, m_routeSpeed((TXSTATUS_ROUTE_SPEED) 0), m_routeTries(0), m_lastFailedLinkFrom(0), m_lastFailedLinkTo(0), m_addedTime(Internal::Platform::TimeStamp::GetMonotonicTime()), m_timeToInteractive(0), m_lastnonce(0)
 {
 	memset(m_neighbors, 0, sizeof(m_neighbors));
 	memset(m_nonces, 0, sizeof(m_nonces));
@@ -163,7 +161,8 @@ Node::~Node()
 		map<uint8, uint8>::iterator it = m_buttonMap.begin();
 		m_buttonMap.erase(it);
 	}
-	delete m_nodeCache;
+
+	m_latencyMutex->Release();
 }
 
 //-----------------------------------------------------------------------------
@@ -189,6 +188,16 @@ void Node::AdvanceQueries()
 	bool addQSC = false;			// We only want to add a query stage complete if we did some work.
 	while (!m_queryPending && m_nodeAlive)
 	{
+		if (m_queryStage > QueryStage_Dynamic && m_timeToInteractive == 0)
+		{
+			// The node's current state is known, so the application can use it
+			m_timeToInteractive = (uint32) (Internal::Platform::TimeStamp::GetMonotonicTime() - m_addedTime);
+			if (m_timeToInteractive == 0)
+			{
+				m_timeToInteractive = 1;
+			}
+			Log::Write(LogLevel_Info, m_nodeId, "Node interactive %d ms after it was added", m_timeToInteractive);
+		}
 		switch (m_queryStage)
 		{
 			case QueryStage_None:
@@ -362,7 +371,10 @@ void Node::AdvanceQueries()
 				for (map<uint8, Internal::CC::CommandClass*>::const_iterator it = m_commandClassMap.begin(); it != m_commandClassMap.end(); ++it)
 				{
 					Internal::CC::CommandClass* cc = it->second;
-					Log::Write(LogLevel_Info, m_nodeId, "Requesting Versions for %s - Max: %d - Current %d", cc->GetCommandClassName().c_str(), cc->GetMaxVersion(), cc->GetVersion());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "Requesting Versions for %s - Max: %d - Current %d", cc->GetCommandClassName().c_str(), cc->GetMaxVersion(), cc->GetVersion());
+					}
 
 					if (cc->GetMaxVersion() > 1 && cc->GetVersion() == 0)
 					{
@@ -525,7 +537,10 @@ void Node::AdvanceQueries()
 			case QueryStage_CacheLoad:
 			{
 				Log::Write(LogLevel_Detail, m_nodeId, "QueryStage_CacheLoad");
-				Log::Write(LogLevel_Info, GetNodeId(), "Loading Cache for node %d: Manufacturer=%s, Product=%s", GetNodeId(), GetManufacturerName().c_str(), GetProductName().c_str());
+				if (Log::IsLevelEnabled(LogLevel_Info))
+				{
+					Log::Write(LogLevel_Info, GetNodeId(), "Loading Cache for node %d: Manufacturer=%s, Product=%s", GetNodeId(), GetManufacturerName().c_str(), GetProductName().c_str());
+				}
 				Log::Write(LogLevel_Info, GetNodeId(), "Node Identity Codes: %.4x:%.4x:%.4x", GetManufacturerId(), GetProductType(), GetProductId());
 				/* Don't do this if its to the Controller */
 				if (GetDriver()->GetControllerNodeId() != m_nodeId)
@@ -657,6 +672,7 @@ void Node::AdvanceQueries()
 					cc->SendPending();
 				}
 				// Check whether all nodes are now complete
+				GetDriver()->MarkCacheDirty(m_nodeId);
 				GetDriver()->CheckCompletedNodeQueries();
 				return;
 			}
@@ -667,6 +683,9 @@ void Node::AdvanceQueries()
 		}
 	}
 
+	// The stage is saved with the node
+	GetDriver()->MarkCacheDirty(m_nodeId);
+
 	if (addQSC && m_nodeAlive)
 	{
 		// Add a marker to the query queue so this advance method
@@ -697,6 +716,7 @@ void Node::QueryStageComplete(QueryStage const _stage)
 			m_queryStage = (QueryStage) ((uint32) m_queryStage + 1);
 		}
 		m_queryRetries = 0;
+		GetDriver()->MarkCacheDirty(m_nodeId);
 	}
 }
 
@@ -746,6 +766,7 @@ void Node::SetQueryStage(QueryStage const _stage, bool const _advance	// = true
 		{
 			m_queryConfiguration = true;
 		}
+		GetDriver()->MarkCacheDirty(m_nodeId);
 	}
 	if (_advance)
 	{
@@ -870,7 +891,8 @@ void Node::ReadXML(TiXmlElement const* _node)
 		}
 		if (m_queryStage > QueryStage_CacheLoad)
 		{
-			m_nodeCache = _node->Clone();
+			m_nodeCache.clear();
+			Internal::BinaryCache::Encode(_node, &m_nodeCache);
 		}
 	}
 
@@ -1227,7 +1249,13 @@ void Node::WriteXML(TiXmlElement* _driverElement)
 	if (m_queryStage <= QueryStage_CacheLoad)
 	{
 		/* Just return our cached copy of the "Cache" as nothing new should be here */
-		_driverElement->LinkEndChild(m_nodeCache->Clone());
+		if (!m_nodeCache.empty())
+		{
+			if (TiXmlElement* nodeElement = Internal::BinaryCache::Decode(&m_nodeCache[0], m_nodeCache.size()))
+			{
+				_driverElement->LinkEndChild(nodeElement);
+			}
+		}
 		return;
 	}
 
@@ -1486,7 +1514,10 @@ void Node::UpdateProtocolInfo(uint8 const* _data)
 				CommandClass *cc = AddCommandClass(*it, true);
 				if ( cc )
 				{
-					Log::Write(LogLevel_Info, m_nodeId, "    %s", cc->GetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s", cc->GetCommandClassName().c_str());
+					}
 				}
 			}
 		}
@@ -1595,7 +1626,7 @@ void Node::SetInstanceLabel(uint8 const _instance, char *label)
 	m_globalInstanceLabel[_instance] = string(label);
 	Driver *driver = GetDriver();
 	if (driver)
-		driver->WriteCache();
+		driver->WriteCache(m_nodeId);
 }
 
 string Node::GetInstanceLabel(uint8 const _ccid, uint8 const _instance)
@@ -1651,8 +1682,8 @@ string Node::GetBasicString()
 	{
 		ReadDeviceClasses();
 	}
-	if (s_basicDeviceClasses.find(_basic) != s_basicDeviceClasses.end()) {
-		return s_basicDeviceClasses.at(_basic);
+	if (Internal::ConfigTables::BasicDeviceClass const* basicDeviceClass = s_deviceClasses.m_basic.Find(_basic)) {
+		return basicDeviceClass->m_label;
 	}
 	return "Unknown";
 }
@@ -1683,10 +1714,9 @@ string Node::GetGenericString(uint8 const _instance)
 	}
 
 	// Get the Generic device class label
-	if (s_genericDeviceClasses.find(_generic) != s_genericDeviceClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* genericDeviceClass = s_deviceClasses.m_generic.Find(_generic))
 	{
-		GenericDeviceClass* genericDeviceClass = s_genericDeviceClasses.at(_generic);
-		label = genericDeviceClass->GetLabel();
+		label = genericDeviceClass->m_label;
 	}
 	return label;
 }
@@ -1720,14 +1750,13 @@ string Node::GetSpecificString(uint8 const _instance)
 	}
 
 	// Get the Generic device class label
-	if (s_genericDeviceClasses.find(_generic) != s_genericDeviceClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* genericDeviceClass = s_deviceClasses.m_generic.Find(_generic))
 	{
-		GenericDeviceClass* genericDeviceClass = s_genericDeviceClasses.at(_generic);
-		label = genericDeviceClass->GetLabel();
+		label = genericDeviceClass->m_label;
 				// Override with any specific device class label
-		if (DeviceClass* specificDeviceClass = genericDeviceClass->GetSpecificDeviceClass(_specific))
+		if (Internal::ConfigTables::DeviceClass const* specificDeviceClass = s_deviceClasses.FindSpecific(genericDeviceClass, _specific))
 		{
-			label = specificDeviceClass->GetLabel();
+			label = specificDeviceClass->m_label;
 		}
 
 	}
@@ -1771,7 +1800,10 @@ void Node::SetSecuredClasses(uint8 const* _data, uint8 const _length, uint32 con
 				if (pCommandClass->IsSecureSupported() && (Internal::ShouldSecureCommandClass(_data[i]) == Internal::SecurityStrategy_Supported))
 				{
 					pCommandClass->SetSecured();
-					Log::Write(LogLevel_Info, m_nodeId, "    %s (Secured) - %s", pCommandClass->GetCommandClassName().c_str(), pCommandClass->IsInNIF() ? "InNIF" : "NotInNIF");
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s (Secured) - %s", pCommandClass->GetCommandClassName().c_str(), pCommandClass->IsInNIF() ? "InNIF" : "NotInNIF");
+					}
 				}
 				/* if it wasn't in the NIF frame, then it will only support Secured Comms. */
 			}
@@ -1780,7 +1812,10 @@ void Node::SetSecuredClasses(uint8 const* _data, uint8 const _length, uint32 con
 				if (pCommandClass->IsSecureSupported())
 				{
 					pCommandClass->SetSecured();
-					Log::Write(LogLevel_Info, m_nodeId, "    %s (Secured) - %s", pCommandClass->GetCommandClassName().c_str(), pCommandClass->IsInNIF() ? "InNIF" : "NotInNIF");
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s (Secured) - %s", pCommandClass->GetCommandClassName().c_str(), pCommandClass->IsInNIF() ? "InNIF" : "NotInNIF");
+					}
 				}
 			}
 			if (_instance > 1)
@@ -1809,7 +1844,10 @@ void Node::SetSecuredClasses(uint8 const* _data, uint8 const _length, uint32 con
 				if (pCommandClass->IsSecureSupported())
 				{
 					pCommandClass->SetSecured();
-					Log::Write(LogLevel_Info, m_nodeId, "    %s (Secured) - %s", pCommandClass->GetCommandClassName().c_str(), pCommandClass->IsInNIF() ? "InNIF" : "NotInNIF");
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s (Secured) - %s", pCommandClass->GetCommandClassName().c_str(), pCommandClass->IsInNIF() ? "InNIF" : "NotInNIF");
+					}
 				}
 				// Start with an instance count of one.  If the device supports COMMMAND_CLASS_MULTI_INSTANCE
 				// then some command class instance counts will increase once the responses to the RequestState
@@ -1828,7 +1866,7 @@ void Node::SetSecuredClasses(uint8 const* _data, uint8 const _length, uint32 con
 	Log::Write(LogLevel_Info, m_nodeId, "  UnSecured command classes for node %d (instance %d):", m_nodeId, _instance);
 	for (map<uint8, Internal::CC::CommandClass*>::const_iterator it = m_commandClassMap.begin(); it != m_commandClassMap.end(); ++it)
 	{
-		if (!it->second->IsSecured())
+		if (!it->second->IsSecured() && Log::IsLevelEnabled(LogLevel_Info))
 			Log::Write(LogLevel_Info, m_nodeId, "    %s (Unsecured) - %s", it->second->GetCommandClassName().c_str(), it->second->IsInNIF() ? "InNIF" : "NotInNIF");
 	}
 
@@ -1872,7 +1910,10 @@ void Node::UpdateNodeInfo(uint8 const* _data, uint8 const _length)
 			{
 				if (Internal::CC::Security::StaticGetCommandClassId() == _data[i] && !GetDriver()->isNetworkKeySet())
 				{
-					Log::Write(LogLevel_Info, m_nodeId, "    %s (Disabled - Network Key Not Set)", Internal::CC::Security::StaticGetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s (Disabled - Network Key Not Set)", Internal::CC::Security::StaticGetCommandClassName().c_str());
+					}
 					continue;
 				}
 				if (Internal::CC::CommandClass* pCommandClass = AddCommandClass(_data[i]))
@@ -1890,13 +1931,19 @@ void Node::UpdateNodeInfo(uint8 const* _data, uint8 const _length)
 					// call at the end of this method have been processed.
 					pCommandClass->SetInstance(1);
 					newCommandClasses = true;
-					Log::Write(LogLevel_Info, m_nodeId, "    %s", pCommandClass->GetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s", pCommandClass->GetCommandClassName().c_str());
+					}
 				}
 				else if (Internal::CC::CommandClass *pCommandClass = GetCommandClass(_data[i]))
 				{
 					/* this CC was in the NIF frame */
 					pCommandClass->SetInNIF();
-					Log::Write(LogLevel_Info, m_nodeId, "    %s (Existing)", pCommandClass->GetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s (Existing)", pCommandClass->GetCommandClassName().c_str());
+					}
 				}
 			}
 			else
@@ -2048,9 +2095,7 @@ void Node::ApplicationCommandHandler(uint8 const* _data, bool encrypted
 		if (pCommandClass->IsSecured() && !encrypted)
 		{
 			Log::Write(LogLevel_Warning, m_nodeId, "Received a Clear Text Message for the CommandClass %s which is Secured", pCommandClass->GetCommandClassName().c_str());
-			bool drop = true;
-			Options::Get()->GetOptionAsBool("EnforceSecureReception", &drop);
-			if (drop)
+			if (Options::Get()->GetValues().m_EnforceSecureReception)
 			{
 				Log::Write(LogLevel_Warning, m_nodeId, "   Dropping Message");
 				return;
@@ -2168,7 +2213,10 @@ Internal::CC::CommandClass* Node::AddCommandClass(uint8 const _commandClassId)
 			{
 				if (pCommandClass->GetMaxVersion() > 1 && pCommandClass->GetVersion() == 0)
 				{
-					Log::Write(LogLevel_Info, m_nodeId, "\t\tRequesting Versions for %s", pCommandClass->GetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "\t\tRequesting Versions for %s", pCommandClass->GetCommandClassName().c_str());
+					}
 					// Get the version for each supported command class that
 					// we have implemented at greater than version one.
 					vcc->RequestCommandClassVersion(pCommandClass);
@@ -2210,7 +2258,10 @@ void Node::RemoveCommandClass(uint8 const _commandClassId)
 	}
 
 	// Destroy the command class object and remove it from our map
-	Log::Write(LogLevel_Info, m_nodeId, "RemoveCommandClass - Removed support for %s", it->second->GetCommandClassName().c_str());
+	if (Log::IsLevelEnabled(LogLevel_Info))
+	{
+		Log::Write(LogLevel_Info, m_nodeId, "RemoveCommandClass - Removed support for %s", it->second->GetCommandClassName().c_str());
+	}
 
 	delete it->second;
 	m_commandClassMap.erase(it);
@@ -2961,9 +3012,7 @@ void Node::RemoveAssociation(uint8 const _groupIdx, uint8 const _targetNodeId, u
 //-----------------------------------------------------------------------------
 void Node::AutoAssociate()
 {
-	bool autoAssociate = false;
-	Options::Get()->GetOptionAsBool("Associate", &autoAssociate);
-	if (autoAssociate)
+	if (Options::Get()->GetValues().m_Associate)
 	{
 		// Try to automatically associate with any groups that have been flagged.
 		uint8 controllerNodeId = GetDriver()->GetControllerNodeId();
@@ -2974,7 +3023,10 @@ void Node::AutoAssociate()
 			if (group->IsAuto() && !group->Contains(controllerNodeId))
 			{
 				// Associate the controller into the group
-				Log::Write(LogLevel_Info, m_nodeId, "Adding the controller to group %d (%s) of node %d", group->GetIdx(), group->GetLabel().c_str(), GetNodeId());
+				if (Log::IsLevelEnabled(LogLevel_Info))
+				{
+					Log::Write(LogLevel_Info, m_nodeId, "Adding the controller to group %d (%s) of node %d", group->GetIdx(), group->GetLabel().c_str(), GetNodeId());
+				}
 				group->AddAssociation(controllerNodeId);
 			}
 		}
@@ -3013,16 +3065,14 @@ string Node::GetEndPointDeviceClassLabel(uint8 const _generic, uint8 const _spec
 	}
 
 	// Get the Generic device class label
-	map<uint8, GenericDeviceClass*>::iterator git = s_genericDeviceClasses.find(_generic);
-	if (git != s_genericDeviceClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* genericDeviceClass = s_deviceClasses.m_generic.Find(_generic))
 	{
-		GenericDeviceClass* genericDeviceClass = git->second;
-		label = genericDeviceClass->GetLabel();
+		label = genericDeviceClass->m_label;
 
 		// Override with any specific device class label
-		if (DeviceClass* specificDeviceClass = genericDeviceClass->GetSpecificDeviceClass(_specific))
+		if (Internal::ConfigTables::DeviceClass const* specificDeviceClass = s_deviceClasses.FindSpecific(genericDeviceClass, _specific))
 		{
-			label = specificDeviceClass->GetLabel();
+			label = specificDeviceClass->m_label;
 		}
 	}
 
@@ -3046,10 +3096,9 @@ bool Node::SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 cons
 	}
 
 	// Get the basic device class label
-	map<uint8, string>::iterator bit = s_basicDeviceClasses.find(_basic);
-	if (bit != s_basicDeviceClasses.end())
+	if (Internal::ConfigTables::BasicDeviceClass const* basicDeviceClass = s_deviceClasses.m_basic.Find(_basic))
 	{
-		m_type = bit->second;
+		m_type = basicDeviceClass->m_label;
 		Log::Write(LogLevel_Info, m_nodeId, "  Basic device class    (0x%.2x) - %s", m_basic, m_type.c_str());
 	}
 	else
@@ -3059,11 +3108,9 @@ bool Node::SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 cons
 
 	// Apply any Generic device class data
 	uint8 basicMapping = 0;
-	map<uint8, GenericDeviceClass*>::iterator git = s_genericDeviceClasses.find(_generic);
-	if (git != s_genericDeviceClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* genericDeviceClass = s_deviceClasses.m_generic.Find(_generic))
 	{
-		GenericDeviceClass* genericDeviceClass = git->second;
-		m_type = genericDeviceClass->GetLabel();
+		m_type = genericDeviceClass->m_label;
 
 		Log::Write(LogLevel_Info, m_nodeId, "  Generic device Class  (0x%.2x) - %s", m_generic, m_type.c_str());
 
@@ -3071,22 +3118,22 @@ bool Node::SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 cons
 		AddMandatoryCommandClasses(genericDeviceClass->GetMandatoryCommandClasses());
 
 		// Get the command class that COMMAND_CLASS_BASIC maps to.
-		basicMapping = genericDeviceClass->GetBasicMapping();
+		basicMapping = genericDeviceClass->m_basicMapping;
 
 		// Apply any Specific device class data
-		if (DeviceClass* specificDeviceClass = genericDeviceClass->GetSpecificDeviceClass(_specific))
+		if (Internal::ConfigTables::DeviceClass const* specificDeviceClass = s_deviceClasses.FindSpecific(genericDeviceClass, _specific))
 		{
-			m_type = specificDeviceClass->GetLabel();
+			m_type = specificDeviceClass->m_label;
 
 			Log::Write(LogLevel_Info, m_nodeId, "  Specific device class (0x%.2x) - %s", m_specific, m_type.c_str());
 
 			// Add the mandatory command classes for this specific class type
 			AddMandatoryCommandClasses(specificDeviceClass->GetMandatoryCommandClasses());
 
-			if (specificDeviceClass->GetBasicMapping())
+			if (specificDeviceClass->m_basicMapping)
 			{
 				// Override the generic device class basic mapping with the specific device class one.
-				basicMapping = specificDeviceClass->GetBasicMapping();
+				basicMapping = specificDeviceClass->m_basicMapping;
 			}
 		}
 		else
@@ -3128,7 +3175,10 @@ bool Node::SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 cons
 		{
 			if (!cit->second->IsAfterMark() && cit->second->GetCommandClassId() != Internal::CC::NoOperation::StaticGetCommandClassId())
 			{
-				Log::Write(LogLevel_Info, m_nodeId, "    %s", cit->second->GetCommandClassName().c_str());
+				if (Log::IsLevelEnabled(LogLevel_Info))
+				{
+					Log::Write(LogLevel_Info, m_nodeId, "    %s", cit->second->GetCommandClassName().c_str());
+				}
 				reportedClasses = true;
 			}
 		}
@@ -3143,7 +3193,10 @@ bool Node::SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 cons
 		{
 			if (cit->second->IsAfterMark())
 			{
-				Log::Write(LogLevel_Info, m_nodeId, "    %s", cit->second->GetCommandClassName().c_str());
+				if (Log::IsLevelEnabled(LogLevel_Info))
+				{
+					Log::Write(LogLevel_Info, m_nodeId, "    %s", cit->second->GetCommandClassName().c_str());
+				}
 				reportedClasses = true;
 			}
 		}
@@ -3178,12 +3231,9 @@ bool Node::SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16
 	m_nodeType = _nodeType;
 
 	Log::Write(LogLevel_Info, m_nodeId, "ZWave+ Info Received from Node %d", m_nodeId);
-	map<uint8, DeviceClass*>::iterator nit = s_nodeTypes.find(m_nodeType);
-	if (nit != s_nodeTypes.end())
+	if (Internal::ConfigTables::DeviceClass const* deviceClass = s_deviceClasses.m_nodeTypes.Find(m_nodeType))
 	{
-		DeviceClass* deviceClass = nit->second;
-
-		Log::Write(LogLevel_Info, m_nodeId, "  Zwave+ Node Type  (0x%02x) - %s. Mandatory Command Classes:", m_nodeType, deviceClass->GetLabel().c_str());
+		Log::Write(LogLevel_Info, m_nodeId, "  Zwave+ Node Type  (0x%02x) - %s. Mandatory Command Classes:", m_nodeType, deviceClass->m_label);
 		uint8 const *_commandClasses = deviceClass->GetMandatoryCommandClasses();
 
 		/* no CommandClasses to add */
@@ -3194,7 +3244,10 @@ bool Node::SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16
 			{
 				if (Internal::CC::CommandClasses::IsSupported(ccid))
 				{
-					Log::Write(LogLevel_Info, m_nodeId, "    %s", Internal::CC::CommandClasses::GetName(ccid).c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s", Internal::CC::CommandClasses::GetName(ccid).c_str());
+					}
 				}
 				else
 				{
@@ -3216,13 +3269,11 @@ bool Node::SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16
 	}
 
 	// Apply any Zwave+ device class data
-	map<uint16, DeviceClass*>::iterator dit = s_deviceTypeClasses.find(_deviceType);
-	if (dit != s_deviceTypeClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* deviceClass = s_deviceClasses.m_deviceTypes.Find(_deviceType))
 	{
-		DeviceClass* deviceClass = dit->second;
-		// m_type = deviceClass->GetLabel(); // do we what to update the type with the zwave+ info??
+		// m_type = deviceClass->m_label; // do we what to update the type with the zwave+ info??
 
-		Log::Write(LogLevel_Info, m_nodeId, "  Zwave+ Device Type  (0x%04x) - %s. Mandatory Command Classes:", _deviceType, deviceClass->GetLabel().c_str());
+		Log::Write(LogLevel_Info, m_nodeId, "  Zwave+ Device Type  (0x%04x) - %s. Mandatory Command Classes:", _deviceType, deviceClass->m_label);
 		uint8 const *_commandClasses = deviceClass->GetMandatoryCommandClasses();
 
 		/* no CommandClasses to add */
@@ -3233,7 +3284,10 @@ bool Node::SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16
 			{
 				if (Internal::CC::CommandClasses::IsSupported(ccid))
 				{
-					Log::Write(LogLevel_Info, m_nodeId, "    %s", Internal::CC::CommandClasses::GetName(ccid).c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s", Internal::CC::CommandClasses::GetName(ccid).c_str());
+					}
 				}
 				else
 				{
@@ -3255,12 +3309,9 @@ bool Node::SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16
 	}
 
 	// Apply any Role device class data
-	map<uint8, DeviceClass*>::iterator rit = s_roleDeviceClasses.find(_role);
-	if (rit != s_roleDeviceClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* roleDeviceClass = s_deviceClasses.m_roles.Find(_role))
 	{
-		DeviceClass* roleDeviceClass = rit->second;
-
-		Log::Write(LogLevel_Info, m_nodeId, "  ZWave+ Role Type  (0x%02x) - %s", _role, roleDeviceClass->GetLabel().c_str());
+		Log::Write(LogLevel_Info, m_nodeId, "  ZWave+ Role Type  (0x%02x) - %s", _role, roleDeviceClass->m_label);
 
 		uint8 const *_commandClasses = roleDeviceClass->GetMandatoryCommandClasses();
 
@@ -3272,7 +3323,10 @@ bool Node::SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16
 			{
 				if (Internal::CC::CommandClasses::IsSupported(ccid))
 				{
-					Log::Write(LogLevel_Info, m_nodeId, "    %s", Internal::CC::CommandClasses::GetName(ccid).c_str());
+					if (Log::IsLevelEnabled(LogLevel_Info))
+					{
+						Log::Write(LogLevel_Info, m_nodeId, "    %s", Internal::CC::CommandClasses::GetName(ccid).c_str());
+					}
 				}
 				else
 				{
@@ -3348,12 +3402,94 @@ bool Node::AddMandatoryCommandClasses(uint8 const* _commandClasses)
 	return true;
 }
 
+namespace
+{
+	// A device class read from device_classes.xml, before it is added to the store
+	struct DeviceClassXML
+	{
+		string m_label;
+		bool m_hasCommandClasses;
+		string m_commandClasses;
+		uint8 m_basicMapping;
+
+		DeviceClassXML() :
+				m_hasCommandClasses(false), m_basicMapping(0)
+		{
+		}
+	};
+
+	struct GenericDeviceClassXML: public DeviceClassXML
+	{
+		map<uint8, DeviceClassXML> m_specific;
+	};
+
+	void ReadDeviceClassXML(TiXmlElement const* _el, DeviceClassXML* o_deviceClass)
+	{
+		char const* str = _el->Attribute("label");
+		if (str)
+		{
+			o_deviceClass->m_label = str;
+		}
+
+		str = _el->Attribute("command_classes");
+		if (str)
+		{
+			// Parse the comma delimted command class list
+			o_deviceClass->m_hasCommandClasses = true;
+			char* pos = const_cast<char*>(str);
+			while (*pos)
+			{
+				o_deviceClass->m_commandClasses.push_back((char) strtol(pos, &pos, 16));
+				if ((*pos) == ',')
+				{
+					++pos;
+				}
+			}
+		}
+
+		str = _el->Attribute("basic");
+		if (str)
+		{
+			char* pStop;
+			o_deviceClass->m_basicMapping = (uint8) strtol(str, &pStop, 16);
+		}
+	}
+
+	void AddDeviceClass(Internal::ConfigTables::Store& _store, vector<Internal::ConfigTables::DeviceClass>& _table, uint16 const _id, DeviceClassXML const& _xml)
+	{
+		Internal::ConfigTables::DeviceClass entry;
+		entry.m_id = _id;
+		entry.m_label = _store.AddString(_xml.m_label);
+		entry.m_commandClasses = _xml.m_hasCommandClasses ? _store.AddString(_xml.m_commandClasses) : NULL;
+		entry.m_basicMapping = _xml.m_basicMapping;
+		entry.m_firstSpecific = 0;
+		entry.m_specificCount = 0;
+		_table.push_back(entry);
+	}
+
+	void AddDeviceClasses(Internal::ConfigTables::Store& _store, vector<Internal::ConfigTables::DeviceClass>& _table, map<uint16, DeviceClassXML> const& _xml)
+	{
+		for (map<uint16, DeviceClassXML>::const_iterator it = _xml.begin(); it != _xml.end(); ++it)
+		{
+			AddDeviceClass(_store, _table, it->first, it->second);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Node::ReadDeviceClasses>
-// Read the static device class data from the device_classes.xml file
+// Read the static device class data from the device_classes.xml file, or
+// use the copy built into the library
 //-----------------------------------------------------------------------------
 bool Node::ReadDeviceClasses()
 {
+	if (!Options::Get()->GetValues().m_XMLConfigTables)
+	{
+		s_deviceClasses = Internal::ConfigTables::GetBuiltinDeviceClasses();
+		s_deviceClassesLoaded = true;
+		return true;
+	}
+
 	// Load the XML document that contains the device class information
 	string configPath;
 	Options::Get()->GetOptionAsString("ConfigPath", &configPath);
@@ -3373,6 +3509,12 @@ bool Node::ReadDeviceClasses()
 	TiXmlElement const* deviceClassesElement = doc.RootElement();
 
 	// Read the basic and generic device classes
+	map<uint8, string> basicDeviceClasses;
+	map<uint8, GenericDeviceClassXML> genericDeviceClasses;
+	map<uint16, DeviceClassXML> roleDeviceClasses;
+	map<uint16, DeviceClassXML> deviceTypeClasses;
+	map<uint16, DeviceClassXML> nodeTypes;
+
 	TiXmlElement const* child = deviceClassesElement->FirstChildElement();
 	while (child)
 	{
@@ -3388,19 +3530,36 @@ bool Node::ReadDeviceClasses()
 
 				if (!strcmp(str, "Generic"))
 				{
-					if (s_genericDeviceClasses.find((uint8_t)(key & 0xFF)) == s_genericDeviceClasses.end()) {
-						s_genericDeviceClasses[(uint8_t) (key & 0xFF)] = new GenericDeviceClass(child);
+					if (genericDeviceClasses.find((uint8_t)(key & 0xFF)) == genericDeviceClasses.end()) {
+						GenericDeviceClassXML& generic = genericDeviceClasses[(uint8_t) (key & 0xFF)];
+						ReadDeviceClassXML(child, &generic);
+
+						// Add any specific device classes
+						TiXmlElement const* specificElement = child->FirstChildElement();
+						while (specificElement)
+						{
+							char const* specificStr = specificElement->Value();
+							char const* specificKeyStr = specificElement->Attribute("key");
+							if (specificStr && !strcmp(specificStr, "Specific") && specificKeyStr)
+							{
+								uint8 specificKey = (uint8) strtol(specificKeyStr, &pStop, 16);
+								DeviceClassXML& specific = generic.m_specific[specificKey];
+								specific = DeviceClassXML();
+								ReadDeviceClassXML(specificElement, &specific);
+							}
+							specificElement = specificElement->NextSiblingElement();
+						}
 					} else {
 						Log::Write(LogLevel_Warning, "Duplicate Entry for Generic Device Class %d", key);
 					}
 				}
 				else if (!strcmp(str, "Basic"))
 				{
-					if (s_basicDeviceClasses.find((uint8_t)(key & 0xFF)) == s_basicDeviceClasses.end()) { 
+					if (basicDeviceClasses.find((uint8_t)(key & 0xFF)) == basicDeviceClasses.end()) { 
 						char const* label = child->Attribute("label");
 						if (label)
 						{
-							s_basicDeviceClasses[(uint8_t) (key & 0xFF)] = label;
+							basicDeviceClasses[(uint8_t) (key & 0xFF)] = label;
 						}
 					} else {
 						Log::Write(LogLevel_Warning, "Duplicate Entry for Basic Device Class %d", key);
@@ -3408,24 +3567,24 @@ bool Node::ReadDeviceClasses()
 				}
 				else if (!strcmp(str, "Role"))
 				{
-					if (s_roleDeviceClasses.find((uint8_t)(key & 0xFF)) == s_roleDeviceClasses.end()) { 
-						s_roleDeviceClasses[(uint8_t) (key & 0xFF)] = new DeviceClass(child);
+					if (roleDeviceClasses.find((uint8_t)(key & 0xFF)) == roleDeviceClasses.end()) { 
+						ReadDeviceClassXML(child, &roleDeviceClasses[(uint8_t) (key & 0xFF)]);
 					} else {
 						Log::Write(LogLevel_Warning, "Duplicate Entry for Role Device Classes %d", key);
 					}
 				}
 				else if (!strcmp(str, "DeviceType"))
 				{
-					if (s_deviceTypeClasses.find(key) == s_deviceTypeClasses.end()) { 
-						s_deviceTypeClasses[key] = new DeviceClass(child);
+					if (deviceTypeClasses.find(key) == deviceTypeClasses.end()) { 
+						ReadDeviceClassXML(child, &deviceTypeClasses[key]);
 					} else {
 						Log::Write(LogLevel_Warning, "Duplicate Entry for Device Type Class %d", key);
 					}
 				}
 				else if (!strcmp(str, "NodeType"))
 				{
-					if (s_nodeTypes.find((uint8_t)(key & 0xFF)) == s_nodeTypes.end()) {
-						s_nodeTypes[(uint8_t) (key & 0xFF)] = new DeviceClass(child);
+					if (nodeTypes.find((uint8_t)(key & 0xFF)) == nodeTypes.end()) {
+						ReadDeviceClassXML(child, &nodeTypes[(uint8_t) (key & 0xFF)]);
 					} else {
 						Log::Write(LogLevel_Warning, "Duplicate Entry for Node Type %d", key);
 					}
@@ -3436,6 +3595,38 @@ bool Node::ReadDeviceClasses()
 		child = child->NextSiblingElement();
 	}
 
+	// Copy the classes into the store.  The specific device classes of each
+	// generic device class follow each other, in the order of their keys.
+	Internal::ConfigTables::Store& store = s_deviceClassStore;
+	store.Clear();
+	for (map<uint8, string>::iterator it = basicDeviceClasses.begin(); it != basicDeviceClasses.end(); ++it)
+	{
+		Internal::ConfigTables::BasicDeviceClass entry;
+		entry.m_id = it->first;
+		entry.m_label = store.AddString(it->second);
+		store.m_basic.push_back(entry);
+	}
+	for (map<uint8, GenericDeviceClassXML>::iterator it = genericDeviceClasses.begin(); it != genericDeviceClasses.end(); ++it)
+	{
+		AddDeviceClass(store, store.m_generic, it->first, it->second);
+		store.m_generic.back().m_firstSpecific = (uint16) store.m_specific.size();
+		store.m_generic.back().m_specificCount = (uint16) it->second.m_specific.size();
+		for (map<uint8, DeviceClassXML>::iterator sit = it->second.m_specific.begin(); sit != it->second.m_specific.end(); ++sit)
+		{
+			AddDeviceClass(store, store.m_specific, sit->first, sit->second);
+		}
+	}
+	AddDeviceClasses(store, store.m_roles, roleDeviceClasses);
+	AddDeviceClasses(store, store.m_deviceTypes, deviceTypeClasses);
+	AddDeviceClasses(store, store.m_nodeTypes, nodeTypes);
+
+	s_deviceClasses.m_basic = store.m_basic;
+	s_deviceClasses.m_generic = store.m_generic;
+	s_deviceClasses.m_specific = store.m_specific;
+	s_deviceClasses.m_roles = store.m_roles;
+	s_deviceClasses.m_deviceTypes = store.m_deviceTypes;
+	s_deviceClasses.m_nodeTypes = store.m_nodeTypes;
+
 	s_deviceClassesLoaded = true;
 	return true;
 }
@@ -3456,8 +3647,8 @@ void Node::GetNodeStatistics(NodeData* _data)
 	_data->m_lastResponseRTT = m_lastResponseRTT;
 	_data->m_sentTS = m_sentTS.GetAsString();
 	_data->m_receivedTS = m_receivedTS.GetAsString();
-	_data->m_averageRequestRTT = m_averageRequestRTT;
-	_data->m_averageResponseRTT = m_averageResponseRTT;
+	_data->m_averageRequestRTT = GetMeanLatency(Latency_RequestRTT) / 1000;
+	_data->m_averageResponseRTT = GetMeanLatency(Latency_ResponseRTT) / 1000;
 	_data->m_txStatusReportSupported = m_txStatusReportSupported;
 	_data->m_txTime = m_txTime;
 	_data->m_hops = m_hops;
@@ -3481,6 +3672,7 @@ void Node::GetNodeStatistics(NodeData* _data)
 	_data->m_routeTries = m_routeTries;
 	_data->m_lastFailedLinkFrom = m_lastFailedLinkFrom;
 	_data->m_lastFailedLinkTo = m_lastFailedLinkTo;
+	_data->m_timeToInteractive = m_timeToInteractive;
 
 	_data->m_quality = m_quality;
 	memcpy(_data->m_lastReceivedMessage, m_lastReceivedMessage, sizeof(m_lastReceivedMessage));
@@ -3495,108 +3687,58 @@ void Node::GetNodeStatistics(NodeData* _data)
 }
 
 //-----------------------------------------------------------------------------
-// <DeviceClass::DeviceClass>
-// Constructor
+// <Node::GetNodeLatencyStats>
+// Return the percentiles of each latency histogram
 //-----------------------------------------------------------------------------
-Node::DeviceClass::DeviceClass(TiXmlElement const* _el) :
-		m_mandatoryCommandClasses(NULL), m_basicMapping(0)
+void Node::GetNodeLatencyStats(NodeLatencyStats* _data)
 {
-	char const* str = _el->Attribute("label");
-	if (str)
-	{
-		m_label = str;
-	}
+	LatencyData* data[Latency_Count] =
+	{ &_data->m_requestRTT, &_data->m_responseRTT, &_data->m_ack, &_data->m_queueWait };
 
-	str = _el->Attribute("command_classes");
-	if (str)
+	Internal::LockGuard LG(m_latencyMutex);
+	for (int i = 0; i < Latency_Count; ++i)
 	{
-		// Parse the comma delimted command class
-		// list into a temporary vector.
-		vector<uint8> ccs;
-		char* pos = const_cast<char*>(str);
-		while (*pos)
-		{
-			ccs.push_back((uint8) strtol(pos, &pos, 16));
-			if ((*pos) == ',')
-			{
-				++pos;
-			}
-		}
-
-		// Copy the vector contents into an array.
-		size_t numCCs = ccs.size();
-		m_mandatoryCommandClasses = new uint8[numCCs + 1];
-		m_mandatoryCommandClasses[numCCs] = 0;	// Zero terminator
-
-		for (uint32 i = 0; i < numCCs; ++i)
-		{
-			m_mandatoryCommandClasses[i] = ccs[i];
-		}
-	}
-
-	str = _el->Attribute("basic");
-	if (str)
-	{
-		char* pStop;
-		m_basicMapping = (uint8) strtol(str, &pStop, 16);
+		Internal::LatencyHistogram const& histogram = m_latency[i];
+		data[i]->m_count = histogram.GetCount();
+		data[i]->m_mean = histogram.GetMean();
+		data[i]->m_p50 = histogram.GetPercentile(50);
+		data[i]->m_p90 = histogram.GetPercentile(90);
+		data[i]->m_p99 = histogram.GetPercentile(99);
+		data[i]->m_max = histogram.GetMax();
 	}
 }
 
 //-----------------------------------------------------------------------------
-// <Node::GenericDeviceClass::GenericDeviceClass>
-// Constructor
+// <Node::ResetNodeLatencyStats>
+// Empty the latency histograms
 //-----------------------------------------------------------------------------
-Node::GenericDeviceClass::GenericDeviceClass(TiXmlElement const* _el) :
-		DeviceClass(_el)
+void Node::ResetNodeLatencyStats()
 {
-	// Add any specific device classes
-	TiXmlElement const* child = _el->FirstChildElement();
-	while (child)
+	Internal::LockGuard LG(m_latencyMutex);
+	for (int i = 0; i < Latency_Count; ++i)
 	{
-		char const* str = child->Value();
-		if (str && !strcmp(str, "Specific"))
-		{
-			char const* keyStr = child->Attribute("key");
-			if (keyStr)
-			{
-				char* pStop;
-				uint8 key = (uint8) strtol(keyStr, &pStop, 16);
-
-				m_specificDeviceClasses[key] = new DeviceClass(child);
-			}
-		}
-
-		child = child->NextSiblingElement();
+		m_latency[i].Reset();
 	}
 }
 
 //-----------------------------------------------------------------------------
-// <Node::GenericDeviceClass::~GenericDeviceClass>
-// Destructor
+// <Node::RecordLatency>
+// Add a sample to one of the latency histograms
 //-----------------------------------------------------------------------------
-Node::GenericDeviceClass::~GenericDeviceClass()
+void Node::RecordLatency(LatencyKind const _kind, uint32 const _us)
 {
-	while (!m_specificDeviceClasses.empty())
-	{
-		map<uint8, DeviceClass*>::iterator it = m_specificDeviceClasses.begin();
-		delete it->second;
-		m_specificDeviceClasses.erase(it);
-	}
+	Internal::LockGuard LG(m_latencyMutex);
+	m_latency[_kind].Record(_us);
 }
 
 //-----------------------------------------------------------------------------
-// <Node::GenericDeviceClass::GetSpecificDeviceClass>
-// Get a specific device class object
+// <Node::GetMeanLatency>
+// Mean of one of the latency histograms, in microseconds
 //-----------------------------------------------------------------------------
-Node::DeviceClass* Node::GenericDeviceClass::GetSpecificDeviceClass(uint8 const& _specific)
+uint32 Node::GetMeanLatency(LatencyKind const _kind)
 {
-	map<uint8, DeviceClass*>::iterator it = m_specificDeviceClasses.find(_specific);
-	if (it != m_specificDeviceClasses.end())
-	{
-		return it->second;
-	}
-
-	return NULL;
+	Internal::LockGuard LG(m_latencyMutex);
+	return m_latency[_kind].GetMean();
 }
 
 //-----------------------------------------------------------------------------
@@ -3679,11 +3821,9 @@ string Node::GetDeviceTypeString()
 	{
 		ReadDeviceClasses();
 	}
-	map<uint16, DeviceClass*>::iterator nit = s_deviceTypeClasses.find(m_deviceType);
-	if (nit != s_deviceTypeClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* deviceClass = s_deviceClasses.m_deviceTypes.Find(m_deviceType))
 	{
-		DeviceClass* deviceClass = nit->second;
-		return deviceClass->GetLabel();
+		return deviceClass->m_label;
 	}
 	return "";
 }
@@ -3697,11 +3837,9 @@ string Node::GetRoleTypeString()
 	{
 		ReadDeviceClasses();
 	}
-	map<uint8, DeviceClass*>::iterator nit = s_roleDeviceClasses.find(m_role);
-	if (nit != s_roleDeviceClasses.end())
+	if (Internal::ConfigTables::DeviceClass const* deviceClass = s_deviceClasses.m_roles.Find(m_role))
 	{
-		DeviceClass* deviceClass = nit->second;
-		return deviceClass->GetLabel();
+		return deviceClass->m_label;
 	}
 	return "";
 }
@@ -3715,11 +3853,9 @@ string Node::GetNodeTypeString()
 	{
 		ReadDeviceClasses();
 	}
-	map<uint8, DeviceClass*>::iterator nit = s_nodeTypes.find(m_nodeType);
-	if (nit != s_nodeTypes.end())
+	if (Internal::ConfigTables::DeviceClass const* deviceClass = s_deviceClasses.m_nodeTypes.Find(m_nodeType))
 	{
-		DeviceClass* deviceClass = nit->second;
-		return deviceClass->GetLabel();
+		return deviceClass->m_label;
 	}
 	return "";
 }
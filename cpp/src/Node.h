@@ -38,6 +38,8 @@
 #include "Msg.h"
 #include "platform/TimeStamp.h"
 #include "Group.h"
+#include "LatencyHistogram.h"
+#include "ConfigTables.h"
 
 class TiXmlElement;
 class TiXmlNode;
@@ -558,7 +560,7 @@ namespace OpenZWave
 			bool m_secured; /**< Is this Node added Securely */
 			map<uint8, string> m_globalInstanceLabel; /** < The Global Labels for Instances for CC that dont define their own labels */
 
-			TiXmlNode *m_nodeCache;
+			vector<uint8> m_nodeCache;		// The node element loaded from the cache, encoded by BinaryCache
 			//-----------------------------------------------------------------------------
 			// Configuration Revision Related Classes
 			//-----------------------------------------------------------------------------
@@ -717,59 +719,14 @@ namespace OpenZWave
 			// Device Classes (static data read from the device_classes.xml file)
 			//-----------------------------------------------------------------------------
 		private:
-			// Container for device class info
-			class DeviceClass
-			{
-				public:
-					DeviceClass(TiXmlElement const* _el);
-					~DeviceClass()
-					{
-						delete[] m_mandatoryCommandClasses;
-					}
-
-					uint8 const* GetMandatoryCommandClasses()
-					{
-						return m_mandatoryCommandClasses;
-					}
-					uint8 GetBasicMapping()
-					{
-						return m_basicMapping;
-					}
-					string const& GetLabel()
-					{
-						return m_label;
-					}
-
-				private:
-					uint8* m_mandatoryCommandClasses;						// Zero terminated array of mandatory command classes for this device type.
-					uint8 m_basicMapping;									// Command class that COMMAND_CLASS_BASIC maps on to, or zero if there is no mapping.
-					string m_label;										// Descriptive label for the device.
-			};
-
-			// Container for generic device class info
-			class GenericDeviceClass: public DeviceClass
-			{
-				public:
-					GenericDeviceClass(TiXmlElement const* _el);
-					~GenericDeviceClass();
-
-					DeviceClass* GetSpecificDeviceClass(uint8 const& _specific);
-
-				private:
-					map<uint8, DeviceClass*> m_specificDeviceClasses;
-			};
-
 			bool SetDeviceClasses(uint8 const _basic, uint8 const _generic, uint8 const _specific);	// Set the device class data for the node
 			bool SetPlusDeviceClasses(uint8 const _role, uint8 const _nodeType, uint16 const _deviceType);	// Set the device class data for the node based on the Zwave+ info report
 			bool AddMandatoryCommandClasses(uint8 const* _commandClasses);							// Add mandatory command classes as specified in the device_classes.xml to the node.
 			bool ReadDeviceClasses();																	// Read the static device class data from the device_classes.xml file
 
-			static bool s_deviceClassesLoaded;		// True if the xml file has already been loaded
-			static map<uint8, string> s_basicDeviceClasses;		// Map of basic device classes.
-			static map<uint8, GenericDeviceClass*> s_genericDeviceClasses;		// Map of generic device classes.
-			static map<uint8, DeviceClass*> s_roleDeviceClasses;		// Map of Zwave+ role device classes.
-			static map<uint16, DeviceClass*> s_deviceTypeClasses;		// Map of Zwave+ device type device classes.
-			static map<uint8, DeviceClass*> s_nodeTypes;				// Map of ZWave+ Node Types
+			static bool s_deviceClassesLoaded;		// True if the device classes have been set up
+			static Internal::ConfigTables::DeviceClassData s_deviceClasses;		// The built in device classes, or those read from the xml file
+			static Internal::ConfigTables::Store s_deviceClassStore;			// Device classes read from the xml file
 
 			//-----------------------------------------------------------------------------
 			//	Statistics
@@ -793,7 +750,7 @@ namespace OpenZWave
 					string m_sentTS;
 					string m_receivedTS;
 					uint32 m_lastRequestRTT;
-					uint32 m_averageRequestRTT;				// ms
+					uint32 m_averageRequestRTT;				// ms, mean since the latency statistics were last reset
 					uint32 m_lastResponseRTT;
 					uint32 m_averageResponseRTT;
 					uint8 m_quality;					// Node quality measure
@@ -815,10 +772,46 @@ namespace OpenZWave
 					uint8 m_routeTries;
 					uint8 m_lastFailedLinkFrom;
 					uint8 m_lastFailedLinkTo;
+					uint32 m_timeToInteractive;			// ms from the node being added until its dynamic values had been read, or 0 if they have not been yet
+			};
+
+			/**
+			 * Distribution of one kind of latency, in microseconds.  Percentiles are
+			 * accurate to within 12.5%.
+			 */
+			struct LatencyData
+			{
+					uint32 m_count;						// Number of samples
+					uint32 m_mean;
+					uint32 m_p50;
+					uint32 m_p90;
+					uint32 m_p99;
+					uint32 m_max;
+			};
+
+			struct NodeLatencyStats
+			{
+					LatencyData m_requestRTT;			// From sending a message to the controller reporting it delivered
+					LatencyData m_responseRTT;			// From sending a message to the reply from the node
+					LatencyData m_ack;					// From sending a message to the controller acknowledging it
+					LatencyData m_queueWait;			// From queuing a message to sending it the first time
 			};
 
 		private:
 			void GetNodeStatistics(NodeData* _data);
+			void GetNodeLatencyStats(NodeLatencyStats* _data);
+			void ResetNodeLatencyStats();
+
+			enum LatencyKind
+			{
+				Latency_RequestRTT = 0,
+				Latency_ResponseRTT,
+				Latency_Ack,
+				Latency_QueueWait,
+				Latency_Count
+			};
+			void RecordLatency(LatencyKind const _kind, uint32 const _us);
+			uint32 GetMeanLatency(LatencyKind const _kind);
 
 			uint32 m_sentCnt;					// Number of messages sent from this node.
 			uint32 m_sentFailed;				// Number of sent messages failed
@@ -830,8 +823,9 @@ namespace OpenZWave
 			uint32 m_lastResponseRTT;			// Last message response RTT
 			Internal::Platform::TimeStamp m_sentTS;					// Last message sent time
 			Internal::Platform::TimeStamp m_receivedTS;				// Last message received time
-			uint32 m_averageRequestRTT;			// Average Request round trip time.
-			uint32 m_averageResponseRTT;		// Average Response round trip time.
+			uint64 m_sentTime;					// Last message sent time on the monotonic clock, in microseconds
+			Internal::LatencyHistogram m_latency[Latency_Count];
+			Internal::Platform::Mutex* m_latencyMutex;			// Guards m_latency, which the driver thread writes while an application reads it
 			uint8 m_quality;					// Node quality measure
 			uint8 m_lastReceivedMessage[254];	// Place to hold last received message
 			uint8 m_errors;
@@ -851,6 +845,8 @@ namespace OpenZWave
 			uint8 m_routeTries;					// The number of attempts to route the last frame
 			uint8 m_lastFailedLinkFrom;			// The last failed link from
 			uint8 m_lastFailedLinkTo;			// The last failed link to
+			uint64 m_addedTime;					// Monotonic time in ms at which the node was added
+			uint32 m_timeToInteractive;			// ms from m_addedTime until the Dynamic stage was complete
 
 			//-----------------------------------------------------------------------------
 			//	Encryption Related
@@ -39,8 +39,30 @@ namespace OpenZWave
 	{
 
 		NotificationCCTypes *NotificationCCTypes::m_instance = NULL;
-		std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationTypes> > NotificationCCTypes::Notifications;
-		uint32 NotificationCCTypes::m_revision(0);
+		ConfigTables::NotificationData NotificationCCTypes::m_data;
+		ConfigTables::Store NotificationCCTypes::m_store;
+
+		namespace
+		{
+			// The contents of NotificationCCTypes.xml while it is read, before the
+			// entries are laid out in the store
+			struct EventParamXML
+			{
+					string name;
+					NotificationCCTypes::NotificationEventParamTypes type;
+					std::map<uint32, string> items;
+			};
+			struct EventXML
+			{
+					string name;
+					std::map<uint32, EventParamXML> params;
+			};
+			struct TypeXML
+			{
+					string name;
+					std::map<uint32, EventXML> events;
+			};
+		}
 
 		NotificationCCTypes::NotificationCCTypes()
 		{
@@ -75,8 +97,9 @@ namespace OpenZWave
 					delete pDoc;
 					return false;
 				}
-				m_revision = atol(str);
+				m_data.m_revision = atol(str);
 			}
+			std::map<uint32, TypeXML> types;
 			TiXmlElement const* AlarmTypeElement = root->FirstChildElement();
 			while (AlarmTypeElement)
 			{
@@ -84,88 +107,82 @@ namespace OpenZWave
 				char* pStopChar;
 				if (str && !strcmp(str, "AlarmType"))
 				{
-					NotificationTypes *nt = new NotificationTypes;
+					TypeXML nt;
 
 					str = AlarmTypeElement->Attribute("id");
 					if (!str)
 					{
 						Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s at line %d - missing AlarmType ID attribute", AlarmTypeElement->GetDocument()->GetUserData(), AlarmTypeElement->Row());
 						AlarmTypeElement = AlarmTypeElement->NextSiblingElement();
-						delete nt;
 						continue;
 					}
-					nt->id = (uint32) strtol(str, &pStopChar, 10);
+					uint32 typeId = (uint32) strtol(str, &pStopChar, 10);
 					str = AlarmTypeElement->Attribute("name");
 					if (!str)
 					{
 						Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s at line %d - missing AlarmType name attribute", AlarmTypeElement->GetDocument()->GetUserData(), AlarmTypeElement->Row());
 						AlarmTypeElement = AlarmTypeElement->NextSiblingElement();
-						delete nt;
 						continue;
 					}
-					nt->name = str;
-					trim(nt->name);
+					nt.name = str;
+					ConfigTables::Trim(nt.name);
 					TiXmlElement const* AlarmEventElement = AlarmTypeElement->FirstChildElement();
 					while (AlarmEventElement)
 					{
 						str = AlarmEventElement->Value();
 						if (str && !strcmp(str, "AlarmEvent"))
 						{
-							NotificationEvents *ne = new NotificationEvents;
+							EventXML ne;
 							str = AlarmEventElement->Attribute("id");
 							if (!str)
 							{
 								Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s at line %d - missing AlarmEventParam id attribute", AlarmEventElement->GetDocument()->GetUserData(), AlarmEventElement->Row());
 								AlarmEventElement = AlarmEventElement->NextSiblingElement();
-								delete ne;
 								continue;
 							}
 
-							ne->id = (uint32) strtol(str, &pStopChar, 10);
+							uint32 eventId = (uint32) strtol(str, &pStopChar, 10);
 
 							str = AlarmEventElement->Attribute("name");
 							if (!str)
 							{
 								Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s at line %d - missing AlarmEventParam name attribute", AlarmEventElement->GetDocument()->GetUserData(), AlarmEventElement->Row());
 								AlarmEventElement = AlarmEventElement->NextSiblingElement();
-								delete ne;
 								continue;
 							}
-							ne->name = str;
-							trim(ne->name);
+							ne.name = str;
+							ConfigTables::Trim(ne.name);
 							TiXmlElement const* nextElement = AlarmEventElement->FirstChildElement();
 							while (nextElement)
 							{
 								str = nextElement->Value();
 								if (str && !strcmp(str, "AlarmEventParam"))
 								{
-									NotificationEventParams *aep = new NotificationEventParams;
+									EventParamXML aep;
 									str = nextElement->Attribute("id");
 									if (!str)
 									{
 										Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s at line %d - missing AlarmEventParam id attribute", nextElement->GetDocument()->GetUserData(), nextElement->Row());
 										nextElement = nextElement->NextSiblingElement();
-										delete aep;
 										continue;
 									}
-									aep->id = (uint32) strtol(str, &pStopChar, 10);
+									uint32 paramId = (uint32) strtol(str, &pStopChar, 10);
 
 									str = nextElement->Attribute("type");
 									if (!str)
 									{
 										Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s at line %d - missing AlarmEventParam id attribute", nextElement->GetDocument()->GetUserData(), nextElement->Row());
 										nextElement = nextElement->NextSiblingElement();
-										delete aep;
 										continue;
 									}
 
 									if (!strcasecmp(str, "location"))
 									{
-										aep->type = NotificationCCTypes::NEPT_Location;
+										aep.type = NotificationCCTypes::NEPT_Location;
 									}
 									else if (!strcasecmp(str, "list"))
 									{
-										aep->type = NotificationCCTypes::NEPT_List;
+										aep.type = NotificationCCTypes::NEPT_List;
 										TiXmlElement const* listElement = nextElement->FirstChildElement();
 										while (listElement)
 										{
@@ -187,13 +204,13 @@ namespace OpenZWave
 													listElement = listElement->NextSiblingElement();
 													continue;
 												}
-												if (aep->ListItems.find(listID) == aep->ListItems.end())
+												if (aep.items.find(listID) == aep.items.end())
 												{
-													aep->ListItems.insert(std::pair<int32, string>(listID, str));
+													aep.items.insert(std::pair<int32, string>(listID, str));
 												}
 												else
 												{
-													Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmEventElement with id %d already exists. Skipping ", listElement->GetDocument()->GetUserData(), ne->id);
+													Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmEventElement with id %d already exists. Skipping ", listElement->GetDocument()->GetUserData(), eventId);
 												}
 											}
 											listElement = listElement->NextSiblingElement();
@@ -201,19 +218,19 @@ namespace OpenZWave
 									}
 									else if (!strcasecmp(str, "usercodereport"))
 									{
-										aep->type = NotificationCCTypes::NEPT_UserCodeReport;
+										aep.type = NotificationCCTypes::NEPT_UserCodeReport;
 									}
 									else if (!strcasecmp(str, "byte"))
 									{
-										aep->type = NotificationCCTypes::NEPT_Byte;
+										aep.type = NotificationCCTypes::NEPT_Byte;
 									}
 									else if (!strcasecmp(str, "string"))
 									{
-										aep->type = NotificationCCTypes::NEPT_String;
+										aep.type = NotificationCCTypes::NEPT_String;
 									}
 									else if (!strcasecmp(str, "duration"))
 									{
-										aep->type = NotificationCCTypes::NEPT_Time;
+										aep.type = NotificationCCTypes::NEPT_Time;
 									}
 									else
 									{
@@ -229,59 +246,67 @@ namespace OpenZWave
 										nextElement = nextElement->NextSiblingElement();
 										continue;
 									}
-									aep->name = str;
-									trim(aep->name);
-									if (ne->EventParams.find(aep->id) == ne->EventParams.end())
-										ne->EventParams[aep->id] = std::shared_ptr<NotificationEventParams>(aep);
+									aep.name = str;
+									ConfigTables::Trim(aep.name);
+									if (ne.params.find(paramId) == ne.params.end())
+										ne.params[paramId] = aep;
 									else
 									{
-										Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmEventParam with id %d already exists. Skipping ", nextElement->GetDocument()->GetUserData(), aep->id);
-										delete aep;
+										Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmEventParam with id %d already exists. Skipping ", nextElement->GetDocument()->GetUserData(), paramId);
 									}
 								}
 								nextElement = nextElement->NextSiblingElement();
 							}
-							if (nt->Events.find(ne->id) == nt->Events.end())
-								nt->Events[ne->id] = std::shared_ptr<NotificationEvents>(ne);
+							if (nt.events.find(eventId) == nt.events.end())
+								nt.events[eventId] = ne;
 							else
 							{
-								Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmEventElement with id %d already exists. Skipping ", AlarmEventElement->GetDocument()->GetUserData(), ne->id);
-								delete ne;
+								Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmEventElement with id %d already exists. Skipping ", AlarmEventElement->GetDocument()->GetUserData(), eventId);
 							}
 						}
 						AlarmEventElement = AlarmEventElement->NextSiblingElement();
 					}
-					if (Notifications.find(nt->id) == Notifications.end())
-						Notifications[nt->id] = std::shared_ptr<NotificationTypes>(nt);
+					if (types.find(typeId) == types.end())
+						types[typeId] = nt;
 					else
 					{
-						Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmTypeElement with id %d already exists. Skipping ", AlarmTypeElement->GetDocument()->GetUserData(), nt->id);
-						delete nt;
+						Log::Write(LogLevel_Warning, "NotificationCCTypes::ReadXML: Error in %s - A AlarmTypeElement with id %d already exists. Skipping ", AlarmTypeElement->GetDocument()->GetUserData(), typeId);
 					}
 				}
 				AlarmTypeElement = AlarmTypeElement->NextSiblingElement();
 			}
-			Log::Write(LogLevel_Info, "Loaded %s With Revision %d", pDoc->GetUserData(), m_revision);
-#if 0
-			std::cout << "NotificationCCTypes" << std::endl;
-			for (std::map<uint32, NotificationCCTypes::NotificationTypes *>::iterator it = Notifications.begin(); it != Notifications.end(); it++)
+
+			// Lay the entries out like the built in tables, each run sorted by id
+			m_store.Clear();
+			for (std::map<uint32, TypeXML>::const_iterator it = types.begin(); it != types.end(); ++it)
 			{
-				std::cout << "\tAlarmType:" << it->first << " Name: " << it->second->name << std::endl;
-				for (std::map<uint32, NotificationCCTypes::NotificationEvents *>::iterator it2 = it->second->Events.begin(); it2 != it->second->Events.end(); it2++)
+				ConfigTables::NotificationType type =
+				{ (uint16) it->first, m_store.AddString(it->second.name), (uint16) m_store.m_notificationEvents.size(), (uint16) it->second.events.size() };
+				for (std::map<uint32, EventXML>::const_iterator it2 = it->second.events.begin(); it2 != it->second.events.end(); ++it2)
 				{
-					std::cout << "\t\tAlarmEvents: " << it2->first << " Name: " << it2->second->name << std::endl;
-					for (std::map<uint32, NotificationCCTypes::NotificationEventParams* >::iterator it3 = it2->second->EventParams.begin(); it3 != it2->second->EventParams.end(); it3++)
+					ConfigTables::NotificationEvent event =
+					{ (uint16) it2->first, m_store.AddString(it2->second.name), (uint16) m_store.m_notificationParams.size(), (uint16) it2->second.params.size() };
+					for (std::map<uint32, EventParamXML>::const_iterator it3 = it2->second.params.begin(); it3 != it2->second.params.end(); ++it3)
 					{
-						std::cout << "\t\t\tEventParams: " << it3->first << " Name: " << it3->second->name << " Type: " << GetEventParamNames(it3->second->type) << std::endl;
-						for (std::map<uint32, string>::iterator it4 = it3->second->ListItems.begin(); it4 != it3->second->ListItems.end(); it4++)
+						ConfigTables::NotificationEventParam param =
+						{ (uint16) it3->first, m_store.AddString(it3->second.name), (uint8) it3->second.type, (uint16) m_store.m_notificationItems.size(), (uint16) it3->second.items.size() };
+						for (std::map<uint32, string>::const_iterator it4 = it3->second.items.begin(); it4 != it3->second.items.end(); ++it4)
 						{
-							std::cout << "\t\t\t\tEventParamsList: " << it4->first << " Name: " << it4->second << std::endl;
+							ConfigTables::NotificationListItem item =
+							{ (uint16) it4->first, m_store.AddString(it4->second) };
+							m_store.m_notificationItems.push_back(item);
 						}
+						m_store.m_notificationParams.push_back(param);
 					}
+					m_store.m_notificationEvents.push_back(event);
 				}
+				m_store.m_notificationTypes.push_back(type);
 			}
-			exit(0);
-#endif
+			m_data.m_types = ConfigTables::Table<NotificationTypes>(m_store.m_notificationTypes);
+			m_data.m_events = ConfigTables::Table<NotificationEvents>(m_store.m_notificationEvents);
+			m_data.m_params = ConfigTables::Table<NotificationEventParams>(m_store.m_notificationParams);
+			m_data.m_items = ConfigTables::Table<NotificationListItems>(m_store.m_notificationItems);
+			Log::Write(LogLevel_Info, "Loaded %s With Revision %d", pDoc->GetUserData(), m_data.m_revision);
 			delete pDoc;
 			return true;
 		}
@@ -312,63 +337,87 @@ namespace OpenZWave
 			return "Unknown";
 		}
 
-		std::string NotificationCCTypes::GetAlarmType(uint32 type)
+		char const* NotificationCCTypes::GetAlarmType(uint32 type)
 		{
-			if (Notifications.find(type) != Notifications.end())
+			if (NotificationTypes const* nt = m_data.m_types.Find(type))
 			{
-				return Notifications.at(type)->name;
+				return nt->m_name;
 			}
 			Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmType - Unknown AlarmType %d", type);
 			return "Unknown";
 		}
 
-		std::string NotificationCCTypes::GetEventForAlarmType(uint32 type, uint32 event)
+		char const* NotificationCCTypes::GetEventForAlarmType(uint32 type, uint32 event)
 		{
-			if (const std::shared_ptr<NotificationCCTypes::NotificationEvents> ne = NotificationCCTypes::GetAlarmNotificationEvents(type, event))
+			if (NotificationEvents const* ne = GetAlarmNotificationEvents(type, event))
 			{
-				return ne->name;
+				return ne->m_name;
 			}
 			Log::Write(LogLevel_Warning, "NotificationCCTypes::GetEventForAlarmType - Unknown AlarmType/Event %d/d", type, event);
 			return "Unknown";
 		}
 
-		const std::shared_ptr<NotificationCCTypes::NotificationTypes> NotificationCCTypes::GetAlarmNotificationTypes(uint32 type)
+		NotificationCCTypes::NotificationTypes const* NotificationCCTypes::GetAlarmNotificationTypes(uint32 type)
 		{
-			if (Notifications.find(type) != Notifications.end())
+			if (NotificationTypes const* nt = m_data.m_types.Find(type))
 			{
-				return Notifications.at(type);
-			}
-			else
-			{
-				Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmNotificationTypes - Unknown Alarm Type %d", type);
+				return nt;
 			}
+			Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmNotificationTypes - Unknown Alarm Type %d", type);
 			return NULL;
 		}
 
-		const std::shared_ptr<NotificationCCTypes::NotificationEvents> NotificationCCTypes::GetAlarmNotificationEvents(uint32 type, uint32 event)
+		NotificationCCTypes::NotificationEvents const* NotificationCCTypes::GetAlarmNotificationEvents(uint32 type, uint32 event)
 		{
-			if (const std::shared_ptr<NotificationCCTypes::NotificationTypes> nt = GetAlarmNotificationTypes(type))
+			if (NotificationTypes const* nt = GetAlarmNotificationTypes(type))
 			{
-				if (nt->Events.find(event) != nt->Events.end())
+				if (NotificationEvents const* ne = GetEvents(nt).Find(event))
 				{
-					return nt->Events.at(event);
+					return ne;
 				}
-				Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmNotificationEvents - Unknown Alarm Event %d for Alarm Type %s (%d)", event, GetAlarmType(type).c_str(), type);
+				Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmNotificationEvents - Unknown Alarm Event %d for Alarm Type %s (%d)", event, nt->m_name, type);
 			}
 			return NULL;
 		}
 
-		const std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams> > NotificationCCTypes::GetAlarmNotificationEventParams(uint32 type, uint32 event)
+		ConfigTables::Table<NotificationCCTypes::NotificationEventParams> NotificationCCTypes::GetAlarmNotificationEventParams(uint32 type, uint32 event)
 		{
-			if (const std::shared_ptr<NotificationCCTypes::NotificationTypes> nt = GetAlarmNotificationTypes(type))
+			if (NotificationTypes const* nt = GetAlarmNotificationTypes(type))
 			{
-				if (nt->Events.find(event) != nt->Events.end())
+				if (NotificationEvents const* ne = GetEvents(nt).Find(event))
 				{
-					return nt->Events.at(event)->EventParams;
+					return GetEventParams(ne);
 				}
-				Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmNotificationEventParams - Unknown Alarm Event %d for Alarm Type %s (%d)", event, GetAlarmType(type).c_str(), type);
+				Log::Write(LogLevel_Warning, "NotificationCCTypes::GetAlarmNotificationEventParams - Unknown Alarm Event %d for Alarm Type %s (%d)", event, nt->m_name, type);
 			}
-			return std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams> >();
+			return ConfigTables::Table<NotificationEventParams>();
+		}
+
+		ConfigTables::Table<NotificationCCTypes::NotificationEvents> NotificationCCTypes::GetEvents(NotificationTypes const* nt)
+		{
+			return m_data.m_events.Slice(nt->m_firstEvent, nt->m_eventCount);
+		}
+
+		ConfigTables::Table<NotificationCCTypes::NotificationEventParams> NotificationCCTypes::GetEventParams(NotificationEvents const* ne)
+		{
+			return m_data.m_params.Slice(ne->m_firstParam, ne->m_paramCount);
+		}
+
+		ConfigTables::Table<NotificationCCTypes::NotificationListItems> NotificationCCTypes::GetListItems(NotificationEventParams const* nep)
+		{
+			return m_data.m_items.Slice(nep->m_firstItem, nep->m_itemCount);
+		}
+
+		bool NotificationCCTypes::Load()
+		{
+			if (Options::Get()->GetValues().m_XMLConfigTables)
+			{
+				return ReadXML();
+			}
+			m_data = ConfigTables::GetBuiltinNotificationTypes();
+			Log::Write(LogLevel_Info, "Using the built in NotificationCCTypes With Revision %d", m_data.m_revision);
+			ConfigTables::CheckRevision("NotificationCCTypes.xml", "NotificationTypes", m_data.m_revision);
+			return true;
 		}
 
 		bool NotificationCCTypes::Create()
@@ -378,7 +427,7 @@ namespace OpenZWave
 				return true;
 			}
 			m_instance = new NotificationCCTypes();			
-			if (!ReadXML()) {
+			if (!Load()) {
 				OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Create NotificationCCTypes Class! - Missing/Invalid Config File?");
 				return false;
 			}
@@ -392,7 +441,7 @@ namespace OpenZWave
 				return m_instance;
 			}
 			m_instance = new NotificationCCTypes();
-			if (!ReadXML()) {
+			if (!Load()) {
 				OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Get NotificationCCTypes Class! - Missing/Invalid Config File?");
 				return m_instance;
 			}
@@ -32,6 +32,7 @@
 #include <string>
 #include <map>
 #include "Defs.h"
+#include "ConfigTables.h"
 #include "Driver.h"
 #include "command_classes/CommandClass.h"
 
@@ -53,28 +54,10 @@ namespace OpenZWave
 					NEPT_Time
 				};
 
-				class NotificationEventParams
-				{
-					public:
-						uint32 id;
-						string name;
-						NotificationEventParamTypes type;
-						std::map<uint32, string> ListItems;
-				};
-				class NotificationEvents
-				{
-					public:
-						uint32 id;
-						string name;
-						std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams> > EventParams;
-				};
-				class NotificationTypes
-				{
-					public:
-						uint32 id;
-						string name;
-						std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEvents> > Events;
-				};
+				typedef ConfigTables::NotificationType NotificationTypes;
+				typedef ConfigTables::NotificationEvent NotificationEvents;
+				typedef ConfigTables::NotificationEventParam NotificationEventParams;
+				typedef ConfigTables::NotificationListItem NotificationListItems;
 
 				//-----------------------------------------------------------------------------
 				// Construction
@@ -83,23 +66,27 @@ namespace OpenZWave
 				NotificationCCTypes();
 				~NotificationCCTypes();
 				static bool ReadXML();
+				static bool Load();
 			public:
 				static NotificationCCTypes* Get();
 				static bool Create();
 				static string GetEventParamNames(NotificationEventParamTypes);
-				string GetAlarmType(uint32);
-				string GetEventForAlarmType(uint32, uint32);
-				const std::shared_ptr<NotificationCCTypes::NotificationTypes> GetAlarmNotificationTypes(uint32);
-				const std::shared_ptr<NotificationEvents> GetAlarmNotificationEvents(uint32, uint32);
-				const std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams>> GetAlarmNotificationEventParams(uint32, uint32);
+				char const* GetAlarmType(uint32);
+				char const* GetEventForAlarmType(uint32, uint32);
+				NotificationTypes const* GetAlarmNotificationTypes(uint32);
+				NotificationEvents const* GetAlarmNotificationEvents(uint32, uint32);
+				ConfigTables::Table<NotificationEventParams> GetAlarmNotificationEventParams(uint32, uint32);
+				ConfigTables::Table<NotificationEvents> GetEvents(NotificationTypes const*);
+				ConfigTables::Table<NotificationEventParams> GetEventParams(NotificationEvents const*);
+				ConfigTables::Table<NotificationListItems> GetListItems(NotificationEventParams const*);
 
 				//-----------------------------------------------------------------------------
 				// Instance Functions
 				//-----------------------------------------------------------------------------
 			private:
 				static NotificationCCTypes* m_instance;
-				static std::map<uint32,std::shared_ptr<NotificationCCTypes::NotificationTypes> > Notifications;
-				static uint32 m_revision;
+				static ConfigTables::NotificationData m_data;		// The built in tables, or those read from the XML file
+				static ConfigTables::Store m_store;					// Entries read from the XML file
 		};
 	} // namespace Internal
 } // namespace OpenZWave
@@ -0,0 +1,412 @@
+//-----------------------------------------------------------------------------
+//
+//	NotificationDispatcher.cpp
+//
+//	Delivers notifications to the watchers on a dedicated thread
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+
+#include "NotificationDispatcher.h"
+#include "Notification.h"
+#include "Utils.h"
+#include "platform/Event.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace
+		{
+			// How far the ring may grow for notifications posted by the watchers
+			uint32 const c_maxGrowth = 4;
+
+			// Only value updates can be dropped or merged.  Anything else changes
+			// what the application knows about the network.
+			bool IsValueUpdate(Notification const* _notification)
+			{
+				return (_notification->GetType() == Notification::Type_ValueChanged) || (_notification->GetType() == Notification::Type_ValueRefreshed);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::NotificationDispatcher>
+// Constructor
+//-----------------------------------------------------------------------------
+		NotificationDispatcher::NotificationDispatcher(uint32 const _capacity, Overflow const _overflow) :
+				m_thread(new Platform::Thread("notification")), m_mutex(new Platform::Mutex()), m_queueEvent(new Platform::Event()), m_spaceEvent(new Platform::Event()), m_deliveredEvent(new Platform::Event()), m_overflow(_overflow), m_ring(_capacity ? _capacity : 1), m_maxSize((_capacity ? _capacity : 1) * c_maxGrowth), m_head(0), m_count(0), m_posted(0), m_done(0), m_delivered(0), m_batches(0), m_dropped(0), m_coalesced(0), m_blocked(0), m_overflowed(0), m_totalDelayUs(0), m_maxDelayUs(0)
+		{
+			m_spaceEvent->Set();
+			m_thread->Start(NotificationDispatcher::ThreadEntryPoint, this);
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::~NotificationDispatcher>
+// Destructor
+//-----------------------------------------------------------------------------
+		NotificationDispatcher::~NotificationDispatcher()
+		{
+			Flush();
+			m_thread->Stop();
+			m_thread->Release();
+
+			for (uint32 i = 0; i < m_count; ++i)
+			{
+				delete m_ring[(m_head + i) % m_ring.size()].m_notification;
+			}
+
+			m_deliveredEvent->Release();
+			m_spaceEvent->Release();
+			m_queueEvent->Release();
+			m_mutex->Release();
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::Post>
+// Queue a notification for the watchers
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::Post(Notification* _notification)
+		{
+			Entry entry;
+			entry.m_notification = _notification;
+			entry.m_postedUs = GetTimeUs();
+
+			m_mutex->Lock();
+			++m_posted;
+			while (m_count == m_ring.size())
+			{
+				if ((m_overflow == Overflow_Coalesce) && Merge(_notification))
+				{
+					++m_coalesced;
+					++m_done;
+					m_mutex->Unlock();
+					return;
+				}
+				if ((m_overflow == Overflow_DropOldest) && DropOldest())
+				{
+					break;
+				}
+				if (std::this_thread::get_id() == m_threadId)
+				{
+					// A watcher, such as one removing a driver, is posting from the
+					// notification thread.  We cannot wait for ourselves to make room,
+					// and the notification must still follow those already queued.
+					if (m_ring.size() < m_maxSize)
+					{
+						Grow();
+						break;
+					}
+
+					// The ring is as large as we let it get.  Whatever the policy, make
+					// room by merging or dropping a value update.  Only notifications
+					// that cannot be lost, such as those of a driver being removed,
+					// still grow it.
+					++m_overflowed;
+					if (Merge(_notification))
+					{
+						++m_coalesced;
+						++m_done;
+						m_mutex->Unlock();
+						return;
+					}
+					if (DropOldest())
+					{
+						break;
+					}
+					if (IsValueUpdate(_notification))
+					{
+						delete _notification;
+						++m_dropped;
+						++m_done;
+						m_mutex->Unlock();
+						return;
+					}
+					Grow();
+					break;
+				}
+
+				// Nothing can be dropped or merged, so wait for the notification thread
+				++m_blocked;
+				m_spaceEvent->Reset();
+				m_mutex->Unlock();
+				Platform::Wait::Single(m_spaceEvent);
+				m_mutex->Lock();
+			}
+
+			m_ring[(m_head + m_count) % m_ring.size()] = entry;
+			++m_count;
+			m_queueEvent->Set();
+			m_mutex->Unlock();
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::Flush>
+// Wait until every notification posted so far has been delivered
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::Flush()
+		{
+			m_mutex->Lock();
+			if (std::this_thread::get_id() != m_threadId)
+			{
+				uint64 target = m_posted;
+				while (m_done < target)
+				{
+					m_deliveredEvent->Reset();
+					m_mutex->Unlock();
+					Platform::Wait::Single(m_deliveredEvent);
+					m_mutex->Lock();
+				}
+			}
+			m_mutex->Unlock();
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::GetStatistics>
+// Fill in the queue part of the notification statistics
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::GetStatistics(Manager::NotificationData* _data)
+		{
+			LockGuard LG(m_mutex);
+			_data->m_queued = m_count;
+			_data->m_delivered = m_delivered;
+			_data->m_batches = m_batches;
+			_data->m_dropped = m_dropped;
+			_data->m_coalesced = m_coalesced;
+			_data->m_blocked = m_blocked;
+			_data->m_overflowed = m_overflowed;
+			_data->m_averageDelayUs = m_delivered ? (uint32) (m_totalDelayUs / m_delivered) : 0;
+			_data->m_maxDelayUs = m_maxDelayUs;
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::GetOverflowFromName>
+// Convert the NotificationOverflow option to an Overflow policy
+//-----------------------------------------------------------------------------
+		NotificationDispatcher::Overflow NotificationDispatcher::GetOverflowFromName(string const& _name)
+		{
+			string name = ToUpper(_name);
+			if (name == "DROPOLDEST")
+			{
+				return Overflow_DropOldest;
+			}
+			if (name == "COALESCE")
+			{
+				return Overflow_Coalesce;
+			}
+			return Overflow_Block;
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::ThreadEntryPoint>
+// Entry point of the notification thread
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::ThreadEntryPoint(Platform::Event* _exitEvent, void* _context)
+		{
+			NotificationDispatcher* dispatcher = (NotificationDispatcher*) _context;
+			if (dispatcher)
+			{
+				dispatcher->ThreadProc(_exitEvent);
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::ThreadProc>
+// Take everything in the ring each time we wake up and deliver it as one batch
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::ThreadProc(Platform::Event* _exitEvent)
+		{
+			{
+				LockGuard LG(m_mutex);
+				m_threadId = std::this_thread::get_id();
+			}
+
+			Platform::Wait* waitObjects[2];
+			waitObjects[0] = _exitEvent;
+			waitObjects[1] = m_queueEvent;
+			Platform::WaitSet waitSet(waitObjects, 2);
+
+			vector<Entry> batch;
+			while (true)
+			{
+				if (waitSet.Multiple(2) == 0)
+				{
+					// Exit has been signalled
+					return;
+				}
+
+				batch.clear();
+				{
+					LockGuard LG(m_mutex);
+					for (uint32 i = 0; i < m_count; ++i)
+					{
+						batch.push_back(m_ring[(m_head + i) % m_ring.size()]);
+					}
+					m_head = (m_head + m_count) % m_ring.size();
+					m_count = 0;
+					m_queueEvent->Reset();
+					m_spaceEvent->Set();
+				}
+
+				if (!batch.empty())
+				{
+					Deliver(batch);
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::Deliver>
+// Pass a batch of notifications to the watchers and free them
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::Deliver(vector<Entry> const& _batch)
+		{
+			uint64 now = GetTimeUs();
+			uint64 totalDelayUs = 0;
+			uint32 maxDelayUs = 0;
+			vector<Notification*> notifications;
+			notifications.reserve(_batch.size());
+			for (vector<Entry>::const_iterator it = _batch.begin(); it != _batch.end(); ++it)
+			{
+				uint32 delayUs = (uint32) (now - it->m_postedUs);
+				totalDelayUs += delayUs;
+				if (delayUs > maxDelayUs)
+				{
+					maxDelayUs = delayUs;
+				}
+				notifications.push_back(it->m_notification);
+			}
+
+			Manager::Get()->NotifyWatchers(&notifications[0], (uint32) notifications.size());
+
+			for (vector<Notification*>::iterator it = notifications.begin(); it != notifications.end(); ++it)
+			{
+				delete *it;
+			}
+
+			LockGuard LG(m_mutex);
+			m_delivered += (uint32) _batch.size();
+			m_done += _batch.size();
+			++m_batches;
+			m_totalDelayUs += totalDelayUs;
+			if (maxDelayUs > m_maxDelayUs)
+			{
+				m_maxDelayUs = maxDelayUs;
+			}
+			m_deliveredEvent->Set();
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::Merge>
+// Fold a value notification into one already queued for the same value.
+// Call with m_mutex held.
+//-----------------------------------------------------------------------------
+		bool NotificationDispatcher::Merge(Notification* _notification)
+		{
+			if (!IsValueUpdate(_notification))
+			{
+				return false;
+			}
+
+			for (uint32 i = m_count; i > 0; --i)
+			{
+				Entry& queued = m_ring[(m_head + i - 1) % m_ring.size()];
+				if (IsValueUpdate(queued.m_notification) && (queued.m_notification->GetValueID() == _notification->GetValueID()))
+				{
+					// The watchers read the value when they are notified, so one notification
+					// is enough.  Keep the queued one unless this one reports a change.
+					if ((queued.m_notification->GetType() == Notification::Type_ValueRefreshed) && (_notification->GetType() == Notification::Type_ValueChanged))
+					{
+						delete queued.m_notification;
+						queued.m_notification = _notification;
+					}
+					else
+					{
+						delete _notification;
+					}
+					return true;
+				}
+			}
+			return false;
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::DropOldest>
+// Drop the oldest value notification in the ring.  Call with m_mutex held.
+//-----------------------------------------------------------------------------
+		bool NotificationDispatcher::DropOldest()
+		{
+			for (uint32 i = 0; i < m_count; ++i)
+			{
+				Notification* notification = m_ring[(m_head + i) % m_ring.size()].m_notification;
+				if (IsValueUpdate(notification))
+				{
+					delete notification;
+					RemoveAt(i);
+					++m_dropped;
+					++m_done;
+					return true;
+				}
+			}
+			return false;
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::RemoveAt>
+// Close the gap left by a notification removed from the ring
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::RemoveAt(uint32 const _position)
+		{
+			for (uint32 i = _position; i > 0; --i)
+			{
+				m_ring[(m_head + i) % m_ring.size()] = m_ring[(m_head + i - 1) % m_ring.size()];
+			}
+			m_head = (m_head + 1) % m_ring.size();
+			--m_count;
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::Grow>
+// Double the size of the ring, keeping the notifications in order.  Call with
+// m_mutex held.
+//-----------------------------------------------------------------------------
+		void NotificationDispatcher::Grow()
+		{
+			vector<Entry> ring(m_ring.size() * 2);
+			for (uint32 i = 0; i < m_count; ++i)
+			{
+				ring[i] = m_ring[(m_head + i) % m_ring.size()];
+			}
+			m_ring.swap(ring);
+			m_head = 0;
+		}
+
+//-----------------------------------------------------------------------------
+// <NotificationDispatcher::GetTimeUs>
+// Monotonic time in microseconds
+//-----------------------------------------------------------------------------
+		uint64 NotificationDispatcher::GetTimeUs()
+		{
+			return (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,143 @@
+//-----------------------------------------------------------------------------
+//
+//	NotificationDispatcher.h
+//
+//	Delivers notifications to the watchers on a dedicated thread
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _NotificationDispatcher_H
+#define _NotificationDispatcher_H
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Defs.h"
+#include "Manager.h"
+
+namespace OpenZWave
+{
+	class Notification;
+
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Event;
+			class Mutex;
+			class Thread;
+		}
+
+		/** \brief Delivers notifications to the watchers on a dedicated thread.
+		 *
+		 * The driver threads post notifications into a bounded ring, so a slow
+		 * watcher no longer holds up the serial port.  Each time the notification
+		 * thread wakes up it takes everything in the ring and hands it to the
+		 * watchers as one batch.  When the ring is full, the Overflow policy decides
+		 * whether the driver waits, an old value notification is dropped, or the new
+		 * notification is merged into one already queued for the same value.
+		 * \ingroup Main
+		 */
+		class NotificationDispatcher
+		{
+			public:
+				enum Overflow
+				{
+					Overflow_Block = 0,		// Wait for the notification thread to make room
+					Overflow_DropOldest,	// Drop the oldest ValueChanged or ValueRefreshed notification
+					Overflow_Coalesce		// Merge into a queued ValueChanged or ValueRefreshed notification for the same value
+				};
+
+				NotificationDispatcher(uint32 const _capacity, Overflow const _overflow);
+				~NotificationDispatcher();
+
+				/**
+				 * Queue a notification for the watchers.  The dispatcher takes ownership of it.
+				 * If there is no room, what happens depends on the Overflow policy.  When called
+				 * from the notification thread itself, by a watcher, the notification is queued
+				 * behind the others like any other, and the ring grows rather than wait.  Past
+				 * four times its configured size, value updates are merged or dropped instead.
+				 */
+				void Post(Notification* _notification);
+
+				/**
+				 * Wait until every notification posted so far has been delivered.
+				 * Returns immediately when called from the notification thread.
+				 */
+				void Flush();
+
+				/**
+				 * Fill in the queue part of the notification statistics.
+				 */
+				void GetStatistics(Manager::NotificationData* _data);
+
+				/**
+				 * Convert the NotificationOverflow option to an Overflow policy.
+				 */
+				static Overflow GetOverflowFromName(string const& _name);
+
+			private:
+				struct Entry
+				{
+						Notification* m_notification;
+						uint64 m_postedUs;					// When the notification was posted
+				};
+
+				static void ThreadEntryPoint(Platform::Event* _exitEvent, void* _context);
+				void ThreadProc(Platform::Event* _exitEvent);
+				void Deliver(vector<Entry> const& _batch);
+				bool Merge(Notification* _notification);
+				bool DropOldest();
+				void Grow();
+				void RemoveAt(uint32 const _position);
+				static uint64 GetTimeUs();
+
+				NotificationDispatcher(NotificationDispatcher const&);					// prevent copy
+				NotificationDispatcher& operator =(NotificationDispatcher const&);		// prevent assignment
+
+				Platform::Thread* m_thread;
+				Platform::Mutex* m_mutex;					// Guards everything below
+				std::thread::id m_threadId;					// The notification thread, once it is running
+				Platform::Event* m_queueEvent;				// Set while the ring holds notifications
+				Platform::Event* m_spaceEvent;				// Set while the ring has room
+				Platform::Event* m_deliveredEvent;			// Set whenever a batch has been delivered
+				Overflow m_overflow;
+				vector<Entry> m_ring;
+				uint32 m_maxSize;							// The ring only grows this far for notifications posted by the watchers
+				uint32 m_head;								// Oldest notification in the ring
+				uint32 m_count;
+				uint64 m_posted;							// Notifications posted, including dropped and coalesced ones
+				uint64 m_done;								// Notifications delivered, dropped or coalesced
+
+				// Statistics
+				uint32 m_delivered;
+				uint32 m_batches;
+				uint32 m_dropped;
+				uint32 m_coalesced;
+				uint32 m_blocked;
+				uint32 m_overflowed;
+				uint64 m_totalDelayUs;
+				uint32 m_maxDelayUs;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_NotificationDispatcher_H
@@ -0,0 +1,87 @@
+//-----------------------------------------------------------------------------
+//
+//	OptionList.h
+//
+//	The options known to the library
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+
+/* No include guard.  This file is included once for every place that needs
+ * the list of options, with the OZW_OPTION_BOOL, OZW_OPTION_INT and
+ * OZW_OPTION_STRING macros defined to generate what that place needs:
+ * the fields of Options::Values, the defaults, and the code that fills the
+ * fields in when the options are locked.
+ *
+ * OZW_OPTION_BOOL( name, default )
+ * OZW_OPTION_INT( name, default )
+ * OZW_OPTION_STRING( name, default, append )
+ *
+ * To add an option, add it here and document it in config/options.xml.
+ */
+
+OZW_OPTION_STRING(ConfigPath, "", false)						// Path to the OpenZWave config folder.  Set by Options::Create.
+OZW_OPTION_STRING(UserPath, "", false)							// Path to the user's data folder.  Set by Options::Create.
+OZW_OPTION_BOOL(XMLConfigTables, false)						// Read device_classes.xml, NotificationCCTypes.xml and SensorMultiLevelCCTypes.xml from the ConfigPath instead of using the copies built into the library
+
+OZW_OPTION_BOOL(Logging, true)									// Enable logging of library activity.
+OZW_OPTION_STRING(LogFileName, "OZW_Log.txt", false)			// Name of the log file (can be changed via Log::SetLogFileName)
+OZW_OPTION_BOOL(AppendLogFile, false)							// Append new session logs to existing log file (false = overwrite)
+OZW_OPTION_BOOL(ConsoleOutput, true)							// Display log information on console (as well as save to disk)
+OZW_OPTION_INT(SaveLogLevel, LogLevel_Detail)					// Save (to file) log messages equal to or above LogLevel_Detail
+OZW_OPTION_INT(QueueLogLevel, LogLevel_Debug)					// Save (in RAM) log messages equal to or above LogLevel_Debug
+OZW_OPTION_INT(DumpTriggerLevel, LogLevel_None)					// Default is to never dump RAM-stored log messages
+OZW_OPTION_BOOL(AsyncLogging, false)							// Format and write log messages on a background thread instead of the calling thread
+
+OZW_OPTION_BOOL(Associate, true)								// Enable automatic association of the controller with group one of every device.
+OZW_OPTION_STRING(Exclude, "", true)							// Remove support for the listed command classes.
+OZW_OPTION_STRING(Include, "", true)							// Only handle the specified command classes.  The Exclude option is ignored if anything is listed here.
+OZW_OPTION_BOOL(NotifyTransactions, false)						// Notifications when transaction complete is reported.
+OZW_OPTION_BOOL(NotificationThread, true)						// Deliver notifications to the watchers on a dedicated thread instead of the driver thread
+OZW_OPTION_INT(NotificationQueueSize, 1024)						// Number of notifications that can wait for the notification thread
+OZW_OPTION_STRING(NotificationOverflow, "Block", false)			// What to do when the notification queue is full: Block, DropOldest or Coalesce
+OZW_OPTION_STRING(Interface, "", true)							// Identify the serial port to be accessed (TODO: change the code so more than one serial port can be specified and HID)
+OZW_OPTION_BOOL(SaveConfiguration, true)						// Save the XML configuration upon driver close.
+OZW_OPTION_INT(CacheSaveDelay, 1000)							// Gather configuration changes for 1 second before saving the cache file
+OZW_OPTION_STRING(CacheFormat, "XML", false)					// Save the cache as XML (ozwcache_*.xml) or BINARY (ozwcache_*.bin)
+OZW_OPTION_INT(DriverMaxAttempts, 0)
+
+OZW_OPTION_INT(PollInterval, 30000)								// 30 seconds (can easily poll 30 values in this time; ~120 values is the effective limit for 30 seconds)
+OZW_OPTION_BOOL(IntervalBetweenPolls, false)					// if false, try to execute the entire poll list within the PollInterval time frame
+																// if true, wait for PollInterval milliseconds between polls
+OZW_OPTION_BOOL(SuppressValueRefresh, false)					// if true, notifications for refreshed (but unchanged) values will not be sent
+OZW_OPTION_BOOL(CoalesceValueNotifications, false)				// if true, ValueChanged and ValueRefreshed notifications for a value that is already waiting to be sent are merged into it
+OZW_OPTION_BOOL(PerformReturnRoutes, false)						// if true, return routes will be updated
+OZW_OPTION_STRING(NetworkKey, "", false)
+OZW_OPTION_BOOL(RefreshAllUserCodes, false)						// if true, during startup, we refresh all the UserCodes the device reports it supports. If False, we stop after we get the first "Available" slot (Some devices have 250+ usercode slots! - That makes our Session Stage Very Long )
+OZW_OPTION_INT(RetryTimeout, RETRY_TIMEOUT)						// How long do we wait to timeout messages sent
+OZW_OPTION_INT(MaxOutstandingRequests, 8)						// Requests to listening nodes that may wait for their reply at once while other messages are sent.  0 waits for each reply before sending anything else
+OZW_OPTION_INT(MaxQueryNodes, 8)								// Nodes that may be queried at once, counting a node whose query is being sent or waits for its reply.  The others wait their turn, the stages that make a node usable first.  0 queues every query straight away
+OZW_OPTION_BOOL(MulticastFollowUp, true)						// Follow each multicast frame with singlecast messages to each node, as multicast is not acknowledged
+OZW_OPTION_BOOL(EnableSIS, true)								// Automatically become a SUC if there is no SUC on the network.
+OZW_OPTION_BOOL(AssumeAwake, true)								// Assume Devices that Support the Wakeup CC are awake when we first query them....
+OZW_OPTION_BOOL(NotifyOnDriverUnload, false)					// Should we send the Node/Value Notifications on Driver Unloading - Read comments in Driver::~Driver() method about possible race conditions
+OZW_OPTION_STRING(SecurityStrategy, "SUPPORTED", false)			// Should we encrypt CC's that are available via both clear text and Security CC?
+OZW_OPTION_STRING(CustomSecuredCC, "0x62,0x4c,0x63", false)		// What List of Custom CC should we always encrypt if SecurityStrategy is CUSTOM
+OZW_OPTION_BOOL(EnforceSecureReception, true)					// if we recieve a clear text message for a CC that is Secured, should we drop the message
+OZW_OPTION_BOOL(AutoUpdateConfigFile, true)						// if we should automatically update config files for devices if they are out of date
+OZW_OPTION_STRING(ReloadAfterUpdate, "AWAKE", false)			// Should we automatically Reload Nodes after a update
+OZW_OPTION_STRING(Language, "", false)							// Language we should use
+OZW_OPTION_BOOL(IncludeInstanceLabel, true)						// Should we include the Instance Label in Value Labels on MultiInstance Devices
+#if defined WINRT
+OZW_OPTION_INT(ThreadTerminateTimeout, -1)						// Since threads cannot be terminated in WinRT, Thread::Terminate will simply wait for them to exit on there own
+#endif
@@ -95,46 +95,17 @@ Options* Options::Create(string const& _configPath, string const& _userPath, str
 		s_instance = new Options(configPath, userPath, _commandLine);
 
 		// Add the default options
-		s_instance->AddOptionString("ConfigPath", configPath, false);	// Path to the OpenZWave config folder.
-		s_instance->AddOptionString("UserPath", userPath, false);	// Path to the user's data folder.
-
-		s_instance->AddOptionBool("Logging", true);						// Enable logging of library activity.
-		s_instance->AddOptionString("LogFileName", "OZW_Log.txt", false);	// Name of the log file (can be changed via Log::SetLogFileName)
-		s_instance->AddOptionBool("AppendLogFile", false);					// Append new session logs to existing log file (false = overwrite)
-		s_instance->AddOptionBool("ConsoleOutput", true);						// Display log information on console (as well as save to disk)
-		s_instance->AddOptionInt("SaveLogLevel", LogLevel_Detail);			// Save (to file) log messages equal to or above LogLevel_Detail
-		s_instance->AddOptionInt("QueueLogLevel", LogLevel_Debug);			// Save (in RAM) log messages equal to or above LogLevel_Debug
-		s_instance->AddOptionInt("DumpTriggerLevel", LogLevel_None);			// Default is to never dump RAM-stored log messages
-
-		s_instance->AddOptionBool("Associate", true);						// Enable automatic association of the controller with group one of every device.
-		s_instance->AddOptionString("Exclude", string(""), true);		// Remove support for the listed command classes.
-		s_instance->AddOptionString("Include", string(""), true);		// Only handle the specified command classes.  The Exclude option is ignored if anything is listed here.
-		s_instance->AddOptionBool("NotifyTransactions", false);					// Notifications when transaction complete is reported.
-		s_instance->AddOptionString("Interface", string(""), true);		// Identify the serial port to be accessed (TODO: change the code so more than one serial port can be specified and HID)
-		s_instance->AddOptionBool("SaveConfiguration", true);						// Save the XML configuration upon driver close.
-		s_instance->AddOptionInt("DriverMaxAttempts", 0);
-
-		s_instance->AddOptionInt("PollInterval", 30000);						// 30 seconds (can easily poll 30 values in this time; ~120 values is the effective limit for 30 seconds)
-		s_instance->AddOptionBool("IntervalBetweenPolls", false);					// if false, try to execute the entire poll list within the PollInterval time frame
-																					// if true, wait for PollInterval milliseconds between polls
-		s_instance->AddOptionBool("SuppressValueRefresh", false);					// if true, notifications for refreshed (but unchanged) values will not be sent
-		s_instance->AddOptionBool("PerformReturnRoutes", false);					// if true, return routes will be updated
-		s_instance->AddOptionString("NetworkKey", string(""), false);
-		s_instance->AddOptionBool("RefreshAllUserCodes", false); 					// if true, during startup, we refresh all the UserCodes the device reports it supports. If False, we stop after we get the first "Available" slot (Some devices have 250+ usercode slots! - That makes our Session Stage Very Long )
-		s_instance->AddOptionInt("RetryTimeout", RETRY_TIMEOUT);				// How long do we wait to timeout messages sent
-		s_instance->AddOptionBool("EnableSIS", true);						// Automatically become a SUC if there is no SUC on the network.
-		s_instance->AddOptionBool("AssumeAwake", true);						// Assume Devices that Support the Wakeup CC are awake when we first query them....
-		s_instance->AddOptionBool("NotifyOnDriverUnload", false);						// Should we send the Node/Value Notifications on Driver Unloading - Read comments in Driver::~Driver() method about possible race conditions
-		s_instance->AddOptionString("SecurityStrategy", "SUPPORTED", false);		// Should we encrypt CC's that are available via both clear text and Security CC?
-		s_instance->AddOptionString("CustomSecuredCC", "0x62,0x4c,0x63", false);	// What List of Custom CC should we always encrypt if SecurityStrategy is CUSTOM
-		s_instance->AddOptionBool("EnforceSecureReception", true);						// if we recieve a clear text message for a CC that is Secured, should we drop the message
-		s_instance->AddOptionBool("AutoUpdateConfigFile", true);						// if we should automatically update config files for devices if they are out of date
-		s_instance->AddOptionString("ReloadAfterUpdate", "AWAKE", false);			// Should we automatically Reload Nodes after a update
-		s_instance->AddOptionString("Language", "", false);			// Language we should use
-		s_instance->AddOptionBool("IncludeInstanceLabel", true);						// Should we include the Instance Label in Value Labels on MultiInstance Devices
-#if defined WINRT
-				s_instance->AddOptionInt( "ThreadTerminateTimeout", -1);						// Since threads cannot be terminated in WinRT, Thread::Terminate will simply wait for them to exit on there own
-#endif
+#define OZW_OPTION_BOOL(_name, _default) s_instance->AddOptionBool(#_name, _default);
+#define OZW_OPTION_INT(_name, _default) s_instance->AddOptionInt(#_name, _default);
+#define OZW_OPTION_STRING(_name, _default, _append) s_instance->AddOptionString(#_name, _default, _append);
+#include "OptionList.h"
+#undef OZW_OPTION_BOOL
+#undef OZW_OPTION_INT
+#undef OZW_OPTION_STRING
+
+		// The paths were checked above
+		s_instance->AddOptionString("ConfigPath", configPath, false);
+		s_instance->AddOptionString("UserPath", userPath, false);
 	}
 
 	return s_instance;
@@ -176,6 +147,13 @@ Options* Options::Get()
 Options::Options(string const& _configPath, string const& _userPath, string const& _commandLine) :
 		m_xml("options.xml"), m_commandLine(_commandLine), m_SystemPath(_configPath), m_LocalPath(_userPath), m_locked(false)
 {
+#define OZW_OPTION_BOOL(_name, _default) m_values.m_##_name = _default;
+#define OZW_OPTION_INT(_name, _default) m_values.m_##_name = _default;
+#define OZW_OPTION_STRING(_name, _default, _append) m_values.m_##_name = _default;
+#include "OptionList.h"
+#undef OZW_OPTION_BOOL
+#undef OZW_OPTION_INT
+#undef OZW_OPTION_STRING
 }
 
 //-----------------------------------------------------------------------------
@@ -345,6 +323,15 @@ bool Options::Lock()
 	ParseOptionsString(m_commandLine);
 	m_locked = true;
 
+	/* Freeze the known options into m_values */
+#define OZW_OPTION_BOOL(_name, _default) GetOptionAsBool(#_name, &m_values.m_##_name);
+#define OZW_OPTION_INT(_name, _default) GetOptionAsInt(#_name, &m_values.m_##_name);
+#define OZW_OPTION_STRING(_name, _default, _append) GetOptionAsString(#_name, &m_values.m_##_name);
+#include "OptionList.h"
+#undef OZW_OPTION_BOOL
+#undef OZW_OPTION_INT
+#undef OZW_OPTION_STRING
+
 	/* Log our Configured Options */
 	map<string, Option*>::iterator it;
 	Log::Write(LogLevel_Info, "Options:");
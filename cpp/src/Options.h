@@ -74,6 +74,24 @@ namespace OpenZWave
 				OptionType_String
 			};
 
+			/**
+			 * The values of the options known to the library, one field per option in
+			 * OptionList.h, named after the option with an m_ prefix.  Filled in when
+			 * the options are locked, so reading a field is a plain memory access rather
+			 * than a lookup by name.  Options added by the application are only available
+			 * through the GetOptionAs methods.
+			 */
+			struct Values
+			{
+#define OZW_OPTION_BOOL(_name, _default) bool m_##_name;
+#define OZW_OPTION_INT(_name, _default) int32 m_##_name;
+#define OZW_OPTION_STRING(_name, _default, _append) string m_##_name;
+#include "OptionList.h"
+#undef OZW_OPTION_BOOL
+#undef OZW_OPTION_INT
+#undef OZW_OPTION_STRING
+			};
+
 			/**
 			 * Creates an object to manage the program options.
 			 * \param _configPath a string containing the path to the OpenZWave library config
@@ -216,6 +234,18 @@ namespace OpenZWave
 				return m_locked;
 			}
 
+			/**
+			 * Get the values of the options known to the library.
+			 * Until the options are locked, the fields hold the defaults.  If the application
+			 * re-registered a known option with a different type, its field keeps the default.
+			 * \return a reference to the values, which do not change once the options are locked.
+			 * \see Values, Lock
+			 */
+			Values const& GetValues() const
+			{
+				return m_values;
+			}
+
 		private:
 			class Option
 			{
@@ -245,6 +275,7 @@ namespace OpenZWave
 			Option* Find(string const& _name);
 
 			map<string, Option*> m_options;										// Map of option names to values.
+			Values m_values;										// The known options, filled in by Lock
 			string m_xml;											// Path to XML options file.
 			string m_commandLine;									// String containing command line options.
 			string m_SystemPath;
@@ -26,6 +26,7 @@
 //-----------------------------------------------------------------------------
 
 #include <cstring>
+#include <set>
 #include "Manager.h"
 #include "platform/Log.h"
 #include "value_classes/Value.h"
@@ -429,13 +430,40 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 		bool Scene::Activate()
 		{
-			bool res = true;
+			// Batch the sets for each network, so that nodes given the same value are switched by one multicast frame
+			set<uint32> homeIds;
 			for (vector<SceneStorage*>::iterator it = m_values.begin(); it != m_values.end(); ++it)
 			{
-				if (!Manager::Get()->SetValue((*it)->m_id, (*it)->m_value))
+				homeIds.insert((*it)->m_id.GetHomeId());
+			}
+			for (set<uint32>::iterator hit = homeIds.begin(); hit != homeIds.end(); ++hit)
+			{
+				Manager::Get()->BeginMulticast(*hit);
+			}
+
+			bool res = true;
+			try
+			{
+				for (vector<SceneStorage*>::iterator it = m_values.begin(); it != m_values.end(); ++it)
 				{
-					res = false;
+					if (!Manager::Get()->SetValue((*it)->m_id, (*it)->m_value))
+					{
+						res = false;
+					}
+				}
+			}
+			catch (...)
+			{
+				for (set<uint32>::iterator hit = homeIds.begin(); hit != homeIds.end(); ++hit)
+				{
+					Manager::Get()->EndMulticast(*hit);
 				}
+				throw;
+			}
+
+			for (set<uint32>::iterator hit = homeIds.begin(); hit != homeIds.end(); ++hit)
+			{
+				Manager::Get()->EndMulticast(*hit);
 			}
 			return res;
 		}
@@ -39,8 +39,24 @@ namespace OpenZWave
 	{
 
 		SensorMultiLevelCCTypes *SensorMultiLevelCCTypes::m_instance = NULL;
-		std::map<uint32, std::shared_ptr<SensorMultiLevelCCTypes::SensorMultiLevelTypes> > SensorMultiLevelCCTypes::SensorTypes;
-		uint32 SensorMultiLevelCCTypes::m_revision(0);
+		ConfigTables::SensorData SensorMultiLevelCCTypes::m_data;
+		ConfigTables::Store SensorMultiLevelCCTypes::m_store;
+
+		namespace
+		{
+			// The contents of SensorMultiLevelCCTypes.xml while it is read, before
+			// the entries are laid out in the store
+			struct SensorScaleXML
+			{
+					string name;
+					string unit;
+			};
+			struct SensorTypeXML
+			{
+					string name;
+					std::map<uint32, SensorScaleXML> scales;
+			};
+		}
 
 		SensorMultiLevelCCTypes::SensorMultiLevelCCTypes()
 		{
@@ -75,8 +91,9 @@ namespace OpenZWave
 					delete pDoc;
 					return false;
 				}
-				m_revision = atol(str);
+				m_data.m_revision = atol(str);
 			}
+			std::map<uint32, SensorTypeXML> types;
 			TiXmlElement const* SensorTypeElement = root->FirstChildElement();
 			while (SensorTypeElement)
 			{
@@ -84,154 +101,157 @@ namespace OpenZWave
 				char* pStopChar;
 				if (str && !strcmp(str, "SensorType"))
 				{
-					SensorMultiLevelTypes *st = new SensorMultiLevelTypes;
-
 					str = SensorTypeElement->Attribute("id");
 					if (!str)
 					{
 						Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - missing SensorType ID attribute", SensorTypeElement->GetDocument()->GetUserData(), SensorTypeElement->Row());
 						SensorTypeElement = SensorTypeElement->NextSiblingElement();
-						delete st;
 						continue;
 					}
-					st->id = (uint32) strtol(str, &pStopChar, 10);
+					uint32 typeId = (uint32) strtol(str, &pStopChar, 10);
 					str = SensorTypeElement->Attribute("name");
 					if (!str)
 					{
 						Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - missing SensorType name attribute", SensorTypeElement->GetDocument()->GetUserData(), SensorTypeElement->Row());
 						SensorTypeElement = SensorTypeElement->NextSiblingElement();
-						delete st;
 						continue;
 					}
-					st->name = str;
-					trim(st->name);
+					SensorTypeXML st;
+					st.name = str;
+					ConfigTables::Trim(st.name);
 					TiXmlElement const* SensorScaleElement = SensorTypeElement->FirstChildElement();
 					while (SensorScaleElement)
 					{
 						str = SensorScaleElement->Value();
 						if (str && !strcmp(str, "SensorScale"))
 						{
-							SensorMultiLevelScales *ss = new SensorMultiLevelScales;
 							str = SensorScaleElement->Attribute("id");
 							if (!str)
 							{
 								Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - missing SensorScale id attribute", SensorScaleElement->GetDocument()->GetUserData(), SensorScaleElement->Row());
 								SensorScaleElement = SensorScaleElement->NextSiblingElement();
-								delete ss;
 								continue;
 							}
 
-							ss->id = (uint32) strtol(str, &pStopChar, 10);
+							uint32 scaleId = (uint32) strtol(str, &pStopChar, 10);
 
 							str = SensorScaleElement->Attribute("name");
 							if (!str)
 							{
 								Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - missing SensorScale name attribute", SensorScaleElement->GetDocument()->GetUserData(), SensorScaleElement->Row());
 								SensorScaleElement = SensorScaleElement->NextSiblingElement();
-								delete ss;
 								continue;
 							}
-							ss->name = str;
-							trim(ss->name);
+							SensorScaleXML ss;
+							ss.name = str;
+							ConfigTables::Trim(ss.name);
 
 							str = SensorScaleElement->GetText();
 							if (str) {
-								ss->unit = str;
-								trim(ss->unit);
+								ss.unit = str;
+								ConfigTables::Trim(ss.unit);
 							}
 
-							if (st->allSensorScales.find(ss->id) == st->allSensorScales.end())
-								st->allSensorScales[ss->id] = std::shared_ptr<SensorMultiLevelCCTypes::SensorMultiLevelScales>(ss);
+							if (st.scales.find(scaleId) == st.scales.end())
+								st.scales[scaleId] = ss;
 							else
 							{
-								Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - A SensorScale with id %d already exists. Skipping ", SensorScaleElement->GetDocument()->GetUserData(), SensorScaleElement->Row(), ss->id);
-								delete ss;
+								Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - A SensorScale with id %d already exists. Skipping ", SensorScaleElement->GetDocument()->GetUserData(), SensorScaleElement->Row(), scaleId);
 							}
 						}
 						SensorScaleElement = SensorScaleElement->NextSiblingElement();
 					}
-					if (SensorTypes.find(st->id) == SensorTypes.end())
-						SensorTypes[st->id] = std::shared_ptr<SensorMultiLevelCCTypes::SensorMultiLevelTypes>(st);
+					if (types.find(typeId) == types.end())
+						types[typeId] = st;
 					else
 					{
-						Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - A SensorTypeElement with id %d already exists. Skipping ", SensorTypeElement->GetDocument()->GetUserData(), SensorTypeElement->Row(), st->id);
-						delete st;
+						Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::ReadXML: Error in %s at line %d - A SensorTypeElement with id %d already exists. Skipping ", SensorTypeElement->GetDocument()->GetUserData(), SensorTypeElement->Row(), typeId);
 					}
 				}
 				SensorTypeElement = SensorTypeElement->NextSiblingElement();
 			}
-			Log::Write(LogLevel_Info, "Loaded %s With Revision %d", pDoc->GetUserData(), m_revision);
-#if 0
-			std::cout << "SensorMultiLevelCCTypes" << std::endl;
-			for (std::map<uint32, SensorMultiLevelCCTypes::SensorMultiLevelTypes *>::iterator it = SensorTypes.begin(); it != SensorTypes.end(); it++)
+
+			// Lay the entries out like the built in tables, each run sorted by id
+			m_store.Clear();
+			for (std::map<uint32, SensorTypeXML>::const_iterator it = types.begin(); it != types.end(); ++it)
 			{
-				std::cout << "\tSensorTypes:" << (uint32)it->first << " Name: " << it->second->name << std::endl;
-				for (std::map<uint8, SensorMultiLevelCCTypes::SensorMultiLevelScales *>::iterator it2 = it->second->allSensorScales.begin(); it2 != it->second->allSensorScales.end(); it2++)
+				SensorMultiLevelTypes type =
+				{ (uint16) it->first, m_store.AddString(it->second.name), (uint16) m_store.m_sensorScales.size(), (uint16) it->second.scales.size() };
+				for (std::map<uint32, SensorScaleXML>::const_iterator it2 = it->second.scales.begin(); it2 != it->second.scales.end(); ++it2)
 				{
-					std::cout << "\t\tSensorScales: " << (uint32)it2->first << " Name: " << it2->second->name << std::endl;
+					SensorMultiLevelScales scale =
+					{ (uint16) it2->first, m_store.AddString(it2->second.name), m_store.AddString(it2->second.unit) };
+					m_store.m_sensorScales.push_back(scale);
 				}
+				m_store.m_sensorTypes.push_back(type);
 			}
-			exit(0);
-#endif
+			m_data.m_types = ConfigTables::Table<SensorMultiLevelTypes>(m_store.m_sensorTypes);
+			m_data.m_scales = ConfigTables::Table<SensorMultiLevelScales>(m_store.m_sensorScales);
+			Log::Write(LogLevel_Info, "Loaded %s With Revision %d", pDoc->GetUserData(), m_data.m_revision);
 			delete pDoc;
 			return true;
 		}
 
-		std::string SensorMultiLevelCCTypes::GetSensorName(uint32 type)
-		{
-			if (SensorTypes.find(type) != SensorTypes.end())
-			{
-				return SensorTypes.at(type)->name;
-			}
-			Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorName - Unknown SensorType %d", type);
-			return "Unknown";
-		}
-
-		std::string SensorMultiLevelCCTypes::GetSensorUnit(uint32 type, uint8 scale)
+		SensorMultiLevelCCTypes::SensorMultiLevelScales const* SensorMultiLevelCCTypes::GetSensorScale(uint32 type, uint8 scale)
 		{
-			if (SensorTypes.find(type) == SensorTypes.end())
+			SensorMultiLevelTypes const* st = m_data.m_types.Find(type);
+			if (!st)
 			{
 				Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorUnit - Unknown SensorType %d", type);
-				return "";
+				return NULL;
 			}
-			SensorScales ss = SensorTypes.at(type)->allSensorScales;
-			if (ss.find(scale) == ss.end())
+			SensorMultiLevelScales const* ss = m_data.m_scales.Slice(st->m_firstScale, st->m_scaleCount).Find(scale);
+			if (!ss)
 			{
 				Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorUnit - Unknown SensorScale %d", scale);
-				return "";
-
 			}
-			return ss.at(scale)->unit;
+			return ss;
 		}
 
-		std::string SensorMultiLevelCCTypes::GetSensorUnitName(uint32 type, uint8 scale) {
-			if (SensorTypes.find(type) == SensorTypes.end())
-			{
-				Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorUnit - Unknown SensorType %d", type);
-				return "";
-			}
-			SensorScales ss = SensorTypes.at(type)->allSensorScales;
-			if (ss.find(scale) == ss.end())
+		char const* SensorMultiLevelCCTypes::GetSensorName(uint32 type)
+		{
+			if (SensorMultiLevelTypes const* st = m_data.m_types.Find(type))
 			{
-				Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorUnit - Unknown SensorScale %d", scale);
-				return "";
-
+				return st->m_name;
 			}
-			return ss.at(scale)->name;
+			Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorName - Unknown SensorType %d", type);
+			return "Unknown";
+		}
 
+		char const* SensorMultiLevelCCTypes::GetSensorUnit(uint32 type, uint8 scale)
+		{
+			SensorMultiLevelScales const* ss = GetSensorScale(type, scale);
+			return ss ? ss->m_unit : "";
 		}
 
+		char const* SensorMultiLevelCCTypes::GetSensorUnitName(uint32 type, uint8 scale)
+		{
+			SensorMultiLevelScales const* ss = GetSensorScale(type, scale);
+			return ss ? ss->m_name : "";
+		}
 
-		const SensorMultiLevelCCTypes::SensorScales SensorMultiLevelCCTypes::GetSensorScales(uint32 type)
+		SensorMultiLevelCCTypes::SensorScales SensorMultiLevelCCTypes::GetSensorScales(uint32 type)
 		{
-			if (SensorTypes.find(type) == SensorTypes.end())
+			SensorMultiLevelTypes const* st = m_data.m_types.Find(type);
+			if (!st)
 			{
 				Log::Write(LogLevel_Warning, "SensorMultiLevelCCTypes::GetSensorUnit - Unknown SensorType %d", type);
 				return SensorScales();
 			}
-			return SensorTypes.at(type)->allSensorScales;
+			return m_data.m_scales.Slice(st->m_firstScale, st->m_scaleCount);
 		}
 
+		bool SensorMultiLevelCCTypes::Load()
+		{
+			if (Options::Get()->GetValues().m_XMLConfigTables)
+			{
+				return ReadXML();
+			}
+			m_data = ConfigTables::GetBuiltinSensorTypes();
+			Log::Write(LogLevel_Info, "Using the built in SensorMultiLevelCCTypes With Revision %d", m_data.m_revision);
+			ConfigTables::CheckRevision("SensorMultiLevelCCTypes.xml", "SensorTypes", m_data.m_revision);
+			return true;
+		}
 
 		bool SensorMultiLevelCCTypes::Create()
 		{
@@ -240,7 +260,7 @@ namespace OpenZWave
 				return true;
 			}
 			m_instance = new SensorMultiLevelCCTypes();
-			if (!ReadXML()) {
+			if (!Load()) {
 				OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Create SensorMultiLevelCCTypes Class! - Missing/Invalid Config File?");
 				return false;
 			}
@@ -254,7 +274,7 @@ namespace OpenZWave
 				return m_instance;
 			}
 			m_instance = new SensorMultiLevelCCTypes();
-			if (!ReadXML()) {
+			if (!Load()) {
 				OZW_ERROR(OZWException::OZWEXCEPTION_CONFIG, "Cannot Get SensorMultiLevelCCTypes Class! - Missing/Invalid Config File?");
 			}
 			return m_instance;
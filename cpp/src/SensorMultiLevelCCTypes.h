@@ -32,6 +32,7 @@
 #include <string>
 #include <map>
 #include "Defs.h"
+#include "ConfigTables.h"
 #include "Driver.h"
 #include "command_classes/CommandClass.h"
 
@@ -43,21 +44,9 @@ namespace OpenZWave
 		class SensorMultiLevelCCTypes
 		{
 			public:
-				class SensorMultiLevelScales
-				{
-					public:
-						uint8 id;
-						string name;
-						string unit;
-				};
-				typedef std::map<uint8, std::shared_ptr<SensorMultiLevelCCTypes::SensorMultiLevelScales> > SensorScales;
-				class SensorMultiLevelTypes
-				{
-					public:
-						uint32 id;
-						string name;
-						SensorScales allSensorScales;
-				};
+				typedef ConfigTables::SensorScale SensorMultiLevelScales;
+				typedef ConfigTables::SensorType SensorMultiLevelTypes;
+				typedef ConfigTables::Table<SensorMultiLevelScales> SensorScales;
 
 				//-----------------------------------------------------------------------------
 				// Construction
@@ -66,21 +55,23 @@ namespace OpenZWave
 				SensorMultiLevelCCTypes();
 				~SensorMultiLevelCCTypes();
 				static bool ReadXML();
+				static bool Load();
+				SensorMultiLevelScales const* GetSensorScale(uint32, uint8);
 			public:
 				static SensorMultiLevelCCTypes* Get();
 				static bool Create();
-				string GetSensorName(uint32);
-				string GetSensorUnit(uint32, uint8);
-				string GetSensorUnitName(uint32, uint8);
-				const SensorScales GetSensorScales(uint32);
+				char const* GetSensorName(uint32);
+				char const* GetSensorUnit(uint32, uint8);
+				char const* GetSensorUnitName(uint32, uint8);
+				SensorScales GetSensorScales(uint32);
 
 				//-----------------------------------------------------------------------------
 				// Instance Functions
 				//-----------------------------------------------------------------------------
 			private:
 				static SensorMultiLevelCCTypes* m_instance;
-				static std::map<uint32, std::shared_ptr<SensorMultiLevelCCTypes::SensorMultiLevelTypes> > SensorTypes;
-				static uint32 m_revision;
+				static ConfigTables::SensorData m_data;			// The built in tables, or those read from the XML file
+				static ConfigTables::Store m_store;				// Entries read from the XML file
 		};
 	} // namespace Internal
 } // namespace OpenZWave
@@ -54,7 +54,7 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 		TimerThread::TimerThread(Driver *_driver) :
 //m_driver( _driver ),
-				m_timerEvent(new Internal::Platform::Event()), m_timerMutex(new Internal::Platform::Mutex()), m_timerTimeout(Internal::Platform::Wait::Timeout_Infinite)
+				m_firingInstance(NULL), m_timerEvent(new Internal::Platform::Event()), m_timerMutex(new Internal::Platform::Mutex()), m_fireMutex(new Internal::Platform::Mutex()), m_timerTimeout(Internal::Platform::Wait::Timeout_Infinite)
 		{
 		}
 
@@ -66,11 +66,24 @@ namespace OpenZWave
 		{
 			{
 				LockGuard LG(m_timerMutex);
-				for (list<TimerEventEntry *>::iterator it = m_timerEventList.begin(); it != m_timerEventList.end(); ++it)
+				for (vector<TimerEventEntry *>::iterator it = m_timerHeap.begin(); it != m_timerHeap.end(); ++it)
+				{
+					// Detach the entries from their Timer instances, which may outlive us
+					TimerEventEntry *te = *it;
+					if (te->instance->m_timerEvents == te)
+					{
+						te->instance->m_timerEvents = NULL;
+					}
+					delete te;
+				}
+				m_timerHeap.clear();
+				for (vector<TimerEventEntry *>::iterator it = m_freeEntries.begin(); it != m_freeEntries.end(); ++it)
 				{
 					delete (*it);
 				}
+				m_freeEntries.clear();
 			}
+			m_fireMutex->Release();
 			m_timerMutex->Release();
 			m_timerEvent->Release();
 		}
@@ -87,6 +100,7 @@ namespace OpenZWave
 			waitObjects[0] = _exitEvent;
 			waitObjects[1] = m_timerEvent;
 			uint32 count = 2;
+			Internal::Platform::WaitSet waitSet(waitObjects, count);
 
 			// Initially no timer events so infinite timeout.
 			m_timerTimeout = Internal::Platform::Wait::Timeout_Infinite;
@@ -94,7 +108,7 @@ namespace OpenZWave
 			while (1)
 			{
 				Log::Write(LogLevel_Detail, "Timer: waiting with timeout %d ms", m_timerTimeout);
-				int32 res = Internal::Platform::Wait::Multiple(waitObjects, count, m_timerTimeout);
+				int32 res = waitSet.Multiple(count, m_timerTimeout);
 
 				if (res == 0)
 				{
@@ -102,52 +116,94 @@ namespace OpenZWave
 					return;
 
 				}
-				else
-				{
-					// Timeout or new entry to timer list.
-					m_timerTimeout = Internal::Platform::Wait::Timeout_Infinite;
 
-					// Go through all waiting actions, and see if any need to be performed.
-					LockGuard LG(m_timerMutex);
-					list<TimerEventEntry *>::iterator it = m_timerEventList.begin();
-					while (it != m_timerEventList.end())
+				// Timeout or new entry at the front of the heap.
+				m_timerTimeout = Internal::Platform::Wait::Timeout_Infinite;
+
+				// Run the events that are due, one at a time.  The callback is called
+				// without m_timerMutex held, so it (and other threads) can set and delete
+				// events while it runs.  m_fireMutex lets Timer::TimerDelEvents wait for
+				// a callback of the instance it is removing.
+				m_timerMutex->Lock();
+				m_timerEvent->Reset();
+				while (!m_timerHeap.empty())
+				{
+					TimerEventEntry *te = m_timerHeap.front();
+					uint64 now = Internal::Platform::TimeStamp::GetMonotonicTime();
+					if (te->due > now)
 					{
-						int32 tr = (*it)->timestamp.TimeRemaining();
-						if (tr <= 0)
-						{
-							// Expired so perform action and remove from list.
-							Log::Write(LogLevel_Info, "Timer: delayed event");
-							TimerEventEntry *te = *(it++);
-							te->instance->TimerFireEvent(te);
-						}
-						else
-						{
-							// Time remaining.
-							m_timerTimeout = (m_timerTimeout == Internal::Platform::Wait::Timeout_Infinite) ? tr : std::min(m_timerTimeout, tr);
-							++it;
-						}
+						uint64 tr = te->due - now;
+						m_timerTimeout = (tr > 0x7fffffff) ? 0x7fffffff : (int32) tr;
+						break;
 					}
-					m_timerEvent->Reset();
+
+					// Expired so remove it and perform the action.
+					Log::Write(LogLevel_Info, "Timer: delayed event");
+					HeapRemove(te);
+					UnlinkEntry(te);
+					// Stale the event's handles before the callback runs, so that deleting
+					// the event from the callback (or anywhere else) is a no-op
+					++te->generation;
+					m_firingInstance = te->instance;
+					m_fireMutex->Lock();
+					m_timerMutex->Unlock();
+
+					te->instance->TimerFireEvent(te);
+
+					m_timerMutex->Lock();
+					m_firingInstance = NULL;
+					m_fireMutex->Unlock();
+					// The instance may be gone by now, so only the entry itself can be touched
+					RecycleEntry(te);
 				}
+				m_timerMutex->Unlock();
 			} // while( 1 )
 		}
 
 //-----------------------------------------------------------------------------
 // <TimerThread::TimerSetEvent>
 //-----------------------------------------------------------------------------
-		TimerThread::TimerEventEntry* TimerThread::TimerSetEvent(int32 _milliseconds, TimerCallback _callback, Timer *_instance, uint32 id)
+		TimerThread::TimerHandle TimerThread::TimerSetEvent(int32 _milliseconds, TimerCallback _callback, Timer *_instance, uint32 id)
 		{
 			Log::Write(LogLevel_Info, "Timer: adding event in %d ms", _milliseconds);
-			TimerEventEntry *te = new TimerEventEntry();
-			te->timestamp.SetTime(_milliseconds);
-			te->callback = _callback;
+			uint64 due = Internal::Platform::TimeStamp::GetMonotonicTime() + (_milliseconds > 0 ? _milliseconds : 0);
+
+			// Don't want driver thread and timer thread accessing the heap at the same time.
+			LockGuard LG(m_timerMutex);
+			TimerEventEntry *te;
+			if (!m_freeEntries.empty())
+			{
+				te = m_freeEntries.back();
+				m_freeEntries.pop_back();
+			}
+			else
+			{
+				te = new TimerEventEntry();
+			}
+			te->due = due;
+			te->callback.swap(_callback);
 			te->instance = _instance;
 			te->id = id;
-			// Don't want driver thread and timer thread accessing list at the same time.
-			LockGuard LG(m_timerMutex);
-			m_timerEventList.push_back(te);
-			m_timerEvent->Set();
-			return te;
+
+			// Link it into the instance's list of pending events
+			te->instancePrev = NULL;
+			te->instanceNext = _instance->m_timerEvents;
+			if (te->instanceNext)
+			{
+				te->instanceNext->instancePrev = te;
+			}
+			_instance->m_timerEvents = te;
+
+			// Only wake the thread if this is now the first event to fire
+			HeapPush(te);
+			if (m_timerHeap.front() == te)
+			{
+				m_timerEvent->Set();
+			}
+			TimerHandle handle;
+			handle.entry = te;
+			handle.generation = te->generation;
+			return handle;
 		}
 
 //-----------------------------------------------------------------------------
@@ -155,19 +211,191 @@ namespace OpenZWave
 // Delete the Specific Timer
 //-----------------------------------------------------------------------------
 
-		void TimerThread::TimerDelEvent(TimerEventEntry *te)
+		bool TimerThread::TimerDelEvent(Timer *_instance, TimerHandle const &_handle)
 		{
 			LockGuard LG(m_timerMutex);
-			list<TimerEventEntry *>::iterator it = find(m_timerEventList.begin(), m_timerEventList.end(), te);
-			if (it != m_timerEventList.end())
+			// Entries are only freed with the TimerThread, so the handle can be checked
+			// even if its event is long gone.  Once the entry has been recycled its
+			// generation no longer matches, whichever event it now belongs to.
+			TimerEventEntry *te = _handle.entry;
+			if (te == NULL || te->generation != _handle.generation || te->instance != _instance || te->heapIndex == TimerEventEntry::NotInHeap)
 			{
-				delete ((*it));
-				m_timerEventList.erase(it);
+				return false;
 			}
-			else
+			HeapRemove(te);
+			UnlinkEntry(te);
+			RecycleEntry(te);
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::TimerDelEvent>
+// Delete the Timer with the given id
+//-----------------------------------------------------------------------------
+
+		bool TimerThread::TimerDelEvent(Timer *_instance, uint32 id)
+		{
+			LockGuard LG(m_timerMutex);
+			for (TimerEventEntry *te = _instance->m_timerEvents; te != NULL; te = te->instanceNext)
 			{
-				Log::Write(LogLevel_Warning, "Cant Find TimerEvent to Delete in TimerDelEvent");
+				if (te->id == id)
+				{
+					HeapRemove(te);
+					UnlinkEntry(te);
+					RecycleEntry(te);
+					return true;
+				}
 			}
+			return false;
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::TimerDelEvents>
+// Delete all the Timers of an instance
+//-----------------------------------------------------------------------------
+
+		void TimerThread::TimerDelEvents(Timer *_instance)
+		{
+			{
+				LockGuard LG(m_timerMutex);
+				while (TimerEventEntry *te = _instance->m_timerEvents)
+				{
+					HeapRemove(te);
+					UnlinkEntry(te);
+					RecycleEntry(te);
+				}
+				if (m_firingInstance != _instance)
+				{
+					return;
+				}
+			}
+
+			// One of the instance's callbacks is running.  Wait for it to return, so the
+			// instance is not destroyed under it.  (The mutex is recursive, so this does
+			// not block if we are being called from that callback.)
+			LockGuard LG(m_fireMutex);
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::HeapPush>
+// Add an entry to the heap
+//-----------------------------------------------------------------------------
+		void TimerThread::HeapPush(TimerEventEntry *te)
+		{
+			m_timerHeap.push_back(te);
+			te->heapIndex = m_timerHeap.size() - 1;
+			HeapSiftUp(te->heapIndex);
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::HeapRemove>
+// Remove an entry from anywhere in the heap
+//-----------------------------------------------------------------------------
+		void TimerThread::HeapRemove(TimerEventEntry *te)
+		{
+			size_t index = te->heapIndex;
+			TimerEventEntry *last = m_timerHeap.back();
+			m_timerHeap.pop_back();
+			if (last != te)
+			{
+				HeapSet(index, last);
+				HeapSiftUp(index);
+				HeapSiftDown(last->heapIndex);
+			}
+			te->heapIndex = TimerEventEntry::NotInHeap;
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::HeapSiftUp>
+// Move an entry towards the front until its parent is due earlier
+//-----------------------------------------------------------------------------
+		void TimerThread::HeapSiftUp(size_t _index)
+		{
+			TimerEventEntry *te = m_timerHeap[_index];
+			while (_index > 0)
+			{
+				size_t parent = (_index - 1) / 2;
+				if (m_timerHeap[parent]->due <= te->due)
+				{
+					break;
+				}
+				HeapSet(_index, m_timerHeap[parent]);
+				_index = parent;
+			}
+			HeapSet(_index, te);
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::HeapSiftDown>
+// Move an entry towards the back until its children are due later
+//-----------------------------------------------------------------------------
+		void TimerThread::HeapSiftDown(size_t _index)
+		{
+			size_t size = m_timerHeap.size();
+			TimerEventEntry *te = m_timerHeap[_index];
+			while (true)
+			{
+				size_t child = (2 * _index) + 1;
+				if (child >= size)
+				{
+					break;
+				}
+				if ((child + 1 < size) && (m_timerHeap[child + 1]->due < m_timerHeap[child]->due))
+				{
+					++child;
+				}
+				if (te->due <= m_timerHeap[child]->due)
+				{
+					break;
+				}
+				HeapSet(_index, m_timerHeap[child]);
+				_index = child;
+			}
+			HeapSet(_index, te);
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::HeapSet>
+// Store an entry in the heap and remember where it is
+//-----------------------------------------------------------------------------
+		void TimerThread::HeapSet(size_t _index, TimerEventEntry *te)
+		{
+			m_timerHeap[_index] = te;
+			te->heapIndex = _index;
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::UnlinkEntry>
+// Remove an entry from its instance's list of pending events
+//-----------------------------------------------------------------------------
+		void TimerThread::UnlinkEntry(TimerEventEntry *te)
+		{
+			if (te->instancePrev)
+			{
+				te->instancePrev->instanceNext = te->instanceNext;
+			}
+			else if (te->instance->m_timerEvents == te)
+			{
+				te->instance->m_timerEvents = te->instanceNext;
+			}
+			if (te->instanceNext)
+			{
+				te->instanceNext->instancePrev = te->instancePrev;
+			}
+			te->instanceNext = NULL;
+			te->instancePrev = NULL;
+		}
+
+//-----------------------------------------------------------------------------
+// <TimerThread::RecycleEntry>
+// Return an unlinked entry to the pool
+//-----------------------------------------------------------------------------
+		void TimerThread::RecycleEntry(TimerEventEntry *te)
+		{
+			te->instance = NULL;
+			te->callback = TimerCallback();
+			++te->generation;
+			m_freeEntries.push_back(te);
 		}
 
 //-----------------------------------------------------------------------------
@@ -175,7 +403,16 @@ namespace OpenZWave
 // Constuctor for Timer SubClass with Driver passed in
 //-----------------------------------------------------------------------------
 		Timer::Timer(Driver *_driver) :
-				m_driver(_driver)
+				m_driver(_driver), m_timerThread(NULL), m_timerEvents(NULL)
+		{
+		}
+		;
+//-----------------------------------------------------------------------------
+// <Timer::Timer>
+// Constuctor for Timer SubClass with a TimerThread passed in
+//-----------------------------------------------------------------------------
+		Timer::Timer(TimerThread *_timerThread) :
+				m_driver(NULL), m_timerThread(_timerThread), m_timerEvents(NULL)
 		{
 		}
 		;
@@ -185,7 +422,7 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 
 		Timer::Timer() :
-				m_driver(NULL)
+				m_driver(NULL), m_timerThread(NULL), m_timerEvents(NULL)
 		{
 
 		}
@@ -200,27 +437,37 @@ namespace OpenZWave
 			TimerDelEvents();
 		}
 
+//-----------------------------------------------------------------------------
+// <Timer::GetTimerThread>
+// The TimerThread that runs our callbacks
+//-----------------------------------------------------------------------------
+		TimerThread* Timer::GetTimerThread()
+		{
+			if (m_timerThread)
+			{
+				return m_timerThread;
+			}
+			if (m_driver)
+			{
+				return m_driver->GetTimer();
+			}
+			return NULL;
+		}
+
 //-----------------------------------------------------------------------------
 // <Timer::TimerSetEvent>
 // Create a new TimerCallback
 //-----------------------------------------------------------------------------
-		TimerThread::TimerEventEntry* Timer::TimerSetEvent(int32 _milliseconds, TimerThread::TimerCallback _callback, uint32 id)
+		TimerThread::TimerHandle Timer::TimerSetEvent(int32 _milliseconds, TimerThread::TimerCallback _callback, uint32 id)
 		{
-			if (m_driver)
+			if (TimerThread* timerThread = GetTimerThread())
 			{
-				TimerThread::TimerEventEntry *te = m_driver->GetTimer()->TimerSetEvent(_milliseconds, _callback, this, id);
-				if (te)
-				{
-					m_timerEventList.push_back(te);
-					return te;
-				}
-				Log::Write(LogLevel_Warning, "Could Not Register Timer Callback");
-				return NULL;
+				return timerThread->TimerSetEvent(_milliseconds, _callback, this, id);
 			}
 			else
 			{
 				Log::Write(LogLevel_Warning, "Driver Not Set for TimerThread");
-				return NULL;
+				return TimerThread::TimerHandle();
 			}
 		}
 
@@ -230,14 +477,9 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 		void Timer::TimerDelEvents()
 		{
-			if (m_driver)
+			if (TimerThread* timerThread = GetTimerThread())
 			{
-				list<TimerThread::TimerEventEntry *>::iterator it = m_timerEventList.begin();
-				while (it != m_timerEventList.end())
-				{
-					m_driver->GetTimer()->TimerDelEvent((*it));
-					it = m_timerEventList.erase(it);
-				}
+				timerThread->TimerDelEvents(this);
 			}
 			else
 			{
@@ -257,17 +499,11 @@ namespace OpenZWave
 // <Timer::TimerDelEvent>
 // Delete a specific TimerEvent
 //-----------------------------------------------------------------------------
-		void Timer::TimerDelEvent(TimerThread::TimerEventEntry *te)
+		void Timer::TimerDelEvent(TimerThread::TimerHandle const &_handle)
 		{
-			if (m_driver)
+			if (TimerThread* timerThread = GetTimerThread())
 			{
-				list<TimerThread::TimerEventEntry *>::iterator it = find(m_timerEventList.begin(), m_timerEventList.end(), te);
-				if (it != m_timerEventList.end())
-				{
-					m_driver->GetTimer()->TimerDelEvent((*it));
-					m_timerEventList.erase(it);
-				}
-				else
+				if (!timerThread->TimerDelEvent(this, _handle))
 				{
 					Log::Write(LogLevel_Warning, "Cant Find TimerEvent to Delete in TimerDelEvent");
 				}
@@ -286,18 +522,12 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 		void Timer::TimerDelEvent(uint32 id)
 		{
-			if (m_driver)
+			if (TimerThread* timerThread = GetTimerThread())
 			{
-				for (list<TimerThread::TimerEventEntry *>::iterator it = m_timerEventList.begin(); it != m_timerEventList.end(); it++)
+				if (!timerThread->TimerDelEvent(this, id))
 				{
-					if ((*it)->id == id)
-					{
-						m_driver->GetTimer()->TimerDelEvent((*it));
-						m_timerEventList.erase(it);
-						return;
-					}
+					Log::Write(LogLevel_Warning, "Cant Find TimerEvent %d to Delete in TimerDelEvent", id);
 				}
-				Log::Write(LogLevel_Warning, "Cant Find TimerEvent %d to Delete in TimerDelEvent", id);
 				return;
 			}
 			else
@@ -310,12 +540,11 @@ namespace OpenZWave
 
 //-----------------------------------------------------------------------------
 // <Timer::TimerFireEvent>
-// Execute a Callback
+// Execute a Callback.  The TimerThread has already removed the event.
 //-----------------------------------------------------------------------------
 		void Timer::TimerFireEvent(TimerThread::TimerEventEntry *te)
 		{
 			te->callback(te->id);
-			TimerDelEvent(te);
 		}
 	} // namespace Internal
 } // namespace OpenZWave
@@ -38,6 +38,7 @@ using std::tr1::bind;
 using std::tr1::function;
 #endif
 
+#include <vector>
 #include "Defs.h"
 #include "platform/Event.h"
 #include "platform/Mutex.h"
@@ -51,6 +52,11 @@ namespace OpenZWave
 		class Timer;
 		/** \brief The TimerThread class makes it possible to schedule events to happen
 		 *  at a certain time in the future.
+		 *
+		 *  Pending events are kept in a binary min-heap ordered by due time, so arming
+		 *  and cancelling an event is O(log n) and the thread only looks at the events
+		 *  that are due.  Entries are recycled rather than freed, and callbacks run
+		 *  without the timer lock held.
 		 */
 		class OPENZWAVE_EXPORT TimerThread
 		{
@@ -74,10 +80,29 @@ namespace OpenZWave
 
 				struct TimerEventEntry
 				{
+						static const size_t NotInHeap = (size_t) -1;	// heapIndex of an entry that is firing or free
+
 						Timer *instance;
-						Internal::Platform::TimeStamp timestamp;
+						uint64 due;						// Monotonic time (ms) at which the event fires
 						TimerCallback callback;
 						uint32 id;
+						size_t heapIndex;				// Position in TimerThread::m_timerHeap
+						TimerEventEntry* instanceNext;	// Other pending events of the same Timer
+						TimerEventEntry* instancePrev;
+						uint32 generation;				// Incremented each time the entry is recycled
+				};
+
+				/** Identifies one scheduled event.  The entry is recycled once the event has
+				 * fired or been deleted, so the handle also carries the entry's generation,
+				 * which no longer matches once the entry is reused for another event. */
+				struct TimerHandle
+				{
+						TimerHandle() :
+								entry(NULL), generation(0)
+						{
+						}
+						TimerEventEntry* entry;
+						uint32 generation;
 				};
 
 				/**
@@ -96,13 +121,23 @@ namespace OpenZWave
 				 * \param _callback The function to be called when the time is reached
 				 * \param _instance The Timer SubClass where this Event should be executed from
 				 */
-				TimerEventEntry* TimerSetEvent(int32 _milliseconds, TimerCallback _callback, Timer *_instance, uint32 id);
+				TimerHandle TimerSetEvent(int32 _milliseconds, TimerCallback _callback, Timer *_instance, uint32 id);
+
+				/**
+				 * Remove an Event, if it is still pending for _instance
+				 */
+				bool TimerDelEvent(Timer *_instance, TimerHandle const &_handle);
 
 				/**
-				 * Remove a Event
-				 *
+				 * Remove the pending Event of _instance with the given id
 				 */
-				void TimerDelEvent(TimerEventEntry *);
+				bool TimerDelEvent(Timer *_instance, uint32 id);
+
+				/**
+				 * Remove all the pending Events of _instance.  If the timer thread is running
+				 * one of its callbacks, wait for the callback to return.
+				 */
+				void TimerDelEvents(Timer *_instance);
 
 				/**
 				 * Main class entry point for the timer thread. Contains the main timer loop.
@@ -110,11 +145,25 @@ namespace OpenZWave
 				 */
 				void TimerThreadProc(Internal::Platform::Event* _exitEvent);
 
-				/** A list of upcoming timer events */
-				list<TimerEventEntry *> m_timerEventList;
+				// Heap and pool maintenance.  m_timerMutex must be held.
+				void HeapPush(TimerEventEntry *te);
+				void HeapRemove(TimerEventEntry *te);
+				void HeapSiftUp(size_t _index);
+				void HeapSiftDown(size_t _index);
+				void HeapSet(size_t _index, TimerEventEntry *te);
+				void UnlinkEntry(TimerEventEntry *te);
+				void RecycleEntry(TimerEventEntry *te);
+
+				/** Upcoming timer events, earliest first */
+				vector<TimerEventEntry *> m_timerHeap;
 
+				/** Entries ready to be reused */
+				vector<TimerEventEntry *> m_freeEntries;
+
+				Timer* m_firingInstance;					// The Timer whose callback is running, if any
 				Internal::Platform::Event* m_timerEvent;   // Event to signal new timed action requested
 				Internal::Platform::Mutex* m_timerMutex;   // Serialize access to class members
+				Internal::Platform::Mutex* m_fireMutex;    // Held by the timer thread while a callback runs
 				int32 m_timerTimeout; // Time in milliseconds to wait until next event
 		};
 
@@ -126,12 +175,18 @@ namespace OpenZWave
 
 		class OPENZWAVE_EXPORT Timer
 		{
+				friend class TimerThread;
 			public:
 				/**
 				 * \brief Constructor with the _driver this instance is associated with
 				 * \param _driver The Driver that this instance is associated with
 				 */
 				Timer(Driver *_driver);
+				/**
+				 * \brief Constructor for an instance that uses a TimerThread directly, without a Driver
+				 * \param _timerThread The TimerThread that runs the callbacks
+				 */
+				Timer(TimerThread *_timerThread);
 				/**
 				 * \brief Default Constructor
 				 */
@@ -146,17 +201,18 @@ namespace OpenZWave
 				 * \param _milliseconds The number of milliseconds before the event should happen
 				 * \param _callback The function to be called when the time is reached
 				 * \param _id The ID of the Timer
+				 * \return a handle for the event, for TimerDelEvent.  It stays safe to use after the event has fired or been deleted.
 				 */
-				TimerThread::TimerEventEntry* TimerSetEvent(int32 _milliseconds, TimerThread::TimerCallback _callback, uint32 id);
+				TimerThread::TimerHandle TimerSetEvent(int32 _milliseconds, TimerThread::TimerCallback _callback, uint32 id);
 				/**
 				 *  \brief Delete All Events registered to this instance
 				 */
 				void TimerDelEvents();
 				/**
 				 * \brief Delete a Specific Event Registered to this instance
-				 * \param te The TimerEventEntry Struct that was returned when Setting a Event
+				 * \param _handle The TimerHandle that was returned when Setting a Event
 				 */
-				void TimerDelEvent(TimerThread::TimerEventEntry *te);
+				void TimerDelEvent(TimerThread::TimerHandle const &_handle);
 				/**
 				 * \brief Delete a Specific Event Registered to this instance
 				 * \param id The ID of the Timer To Delete
@@ -174,8 +230,11 @@ namespace OpenZWave
 				 */
 				void TimerFireEvent(TimerThread::TimerEventEntry *te);
 			private:
+				TimerThread* GetTimerThread();
+
 				Driver* m_driver;
-				list<TimerThread::TimerEventEntry *> m_timerEventList;
+				TimerThread* m_timerThread;
+				TimerThread::TimerEventEntry* m_timerEvents;	// Pending events of this instance, linked through instanceNext/instancePrev.  Protected by the TimerThread's m_timerMutex
 
 		};
 	} // namespace Internal
@@ -144,6 +144,35 @@ namespace OpenZWave
 
 		}
 
+		char const* PktToString(uint8 const *data, uint32 const length, char* _buf, size_t _size)
+		{
+			static char const hexDigits[] = "0123456789abcdef";
+			size_t pos = 0;
+			if (_size == 0)
+			{
+				return _buf;
+			}
+			for (uint32 i = 0; i < length; ++i)
+			{
+				// room for ", 0x00" and the terminator
+				if (pos + 7 > _size)
+				{
+					break;
+				}
+				if (i)
+				{
+					_buf[pos++] = ',';
+					_buf[pos++] = ' ';
+				}
+				_buf[pos++] = '0';
+				_buf[pos++] = 'x';
+				_buf[pos++] = hexDigits[data[i] >> 4];
+				_buf[pos++] = hexDigits[data[i] & 0x0f];
+			}
+			_buf[pos] = 0;
+			return _buf;
+		}
+
 		static const char* separators()
 		{
 #if __unix__
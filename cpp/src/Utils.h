@@ -29,6 +29,7 @@
 #define _Utils_H
 
 #include "platform/Mutex.h"
+#include "platform/SharedMutex.h"
 #include "platform/Log.h"
 
 #include <string>
@@ -117,18 +118,42 @@ namespace OpenZWave
 		void PrintHex(std::string prefix, uint8_t const *data, uint32 const length);
 		string PktToString(uint8 const *data, uint32 const length);
 
+		/**
+		 * Format a packet as "0x01, 0x02, ..." into a caller supplied buffer, without allocating.
+		 * The output is truncated (and always NUL terminated) if the buffer is too small.
+		 * \param data the packet bytes
+		 * \param length number of bytes in the packet
+		 * \param _buf buffer that receives the text
+		 * \param _size size of _buf in bytes
+		 * \return _buf, so the call can be used directly as a Log::Write argument
+		 */
+		char const* PktToString(uint8 const *data, uint32 const length, char* _buf, size_t _size);
+
 		struct LockGuard
 		{
 				LockGuard(Internal::Platform::Mutex* mutex) :
-						_ref(mutex)
+						_ref(mutex), _shared(NULL), _sharedLocked(false)
 				{
 					//std::cout << "Locking" << std::endl;
 					_ref->Lock();
 				}
 				;
 
+				/* Takes a reader/writer lock exclusively */
+				LockGuard(Internal::Platform::SharedMutex* mutex) :
+						_ref(NULL), _shared(mutex), _sharedLocked(true)
+				{
+					_shared->Lock();
+				}
+
 				~LockGuard()
 				{
+					if (_shared)
+					{
+						if (_sharedLocked)
+							_shared->Unlock();
+						return;
+					}
 #if 0
 					if (_ref->IsSignalled())
 					std::cout << "Already Unlocked" << std::endl;
@@ -141,6 +166,13 @@ namespace OpenZWave
 				void Unlock()
 				{
 //				std::cout << "Unlocking" << std::endl;
+					if (_shared)
+					{
+						if (_sharedLocked)
+							_shared->Unlock();
+						_sharedLocked = false;
+						return;
+					}
 					_ref->Unlock();
 				}
 			private:
@@ -148,6 +180,28 @@ namespace OpenZWave
 				LockGuard& operator =(LockGuard const&);
 
 				Internal::Platform::Mutex* _ref;
+				Internal::Platform::SharedMutex* _shared;
+				bool _sharedLocked;
+		};
+
+		/* Takes a reader/writer lock shared, for code that only reads the data it guards */
+		struct ReadLockGuard
+		{
+				ReadLockGuard(Internal::Platform::SharedMutex* mutex) :
+						_ref(mutex)
+				{
+					_ref->LockShared();
+				}
+
+				~ReadLockGuard()
+				{
+					_ref->UnlockShared();
+				}
+			private:
+				ReadLockGuard(const ReadLockGuard&);
+				ReadLockGuard& operator =(ReadLockGuard const&);
+
+				Internal::Platform::SharedMutex* _ref;
 		};
 
 		string ozwdirname(string);
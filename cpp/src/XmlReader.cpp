@@ -0,0 +1,837 @@
+//-----------------------------------------------------------------------------
+//
+//	XmlReader.cpp
+//
+//	Reads XML files one token at a time, in place
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+#include "XmlReader.h"
+#include "platform/FileOps.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace
+		{
+			bool IsWhiteSpace(char const _c)
+			{
+				return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\r';
+			}
+
+			void AppendUtf8(uint32 _code, string* o_str)
+			{
+				if (_code < 0x80)
+				{
+					o_str->push_back((char) _code);
+				}
+				else if (_code < 0x800)
+				{
+					o_str->push_back((char) (0xc0 | (_code >> 6)));
+					o_str->push_back((char) (0x80 | (_code & 0x3f)));
+				}
+				else if (_code < 0x10000)
+				{
+					o_str->push_back((char) (0xe0 | (_code >> 12)));
+					o_str->push_back((char) (0x80 | ((_code >> 6) & 0x3f)));
+					o_str->push_back((char) (0x80 | (_code & 0x3f)));
+				}
+				else
+				{
+					o_str->push_back((char) (0xf0 | (_code >> 18)));
+					o_str->push_back((char) (0x80 | ((_code >> 12) & 0x3f)));
+					o_str->push_back((char) (0x80 | ((_code >> 6) & 0x3f)));
+					o_str->push_back((char) (0x80 | (_code & 0x3f)));
+				}
+			}
+
+			// Line ends are read as a single '\n', as XML requires
+			void NormalizeLineEnds(string* o_str)
+			{
+				size_t out = o_str->find('\r');
+				if (out == string::npos)
+				{
+					return;
+				}
+				for (size_t i = out; i < o_str->size(); ++i)
+				{
+					char c = (*o_str)[i];
+					if (c == '\r')
+					{
+						c = '\n';
+						if (i + 1 < o_str->size() && (*o_str)[i + 1] == '\n')
+						{
+							++i;
+						}
+					}
+					(*o_str)[out++] = c;
+				}
+				o_str->resize(out);
+			}
+
+			// Copy a number into a terminated buffer for the strto functions
+			bool CopyNumber(char const* _data, size_t _length, char* o_buffer, size_t _size)
+			{
+				if (_data == NULL || _length == 0 || _length >= _size)
+				{
+					return false;
+				}
+				memcpy(o_buffer, _data, _length);
+				o_buffer[_length] = 0;
+				return true;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlString::operator ==>
+// Compare with a terminated string
+//-----------------------------------------------------------------------------
+		bool XmlString::operator ==(char const* _str) const
+		{
+			return m_data != NULL && strncmp(m_data, _str, m_length) == 0 && _str[m_length] == 0;
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlString::ToString>
+// Copy the string out, replacing entities and character references
+//-----------------------------------------------------------------------------
+		string XmlString::ToString() const
+		{
+			string str;
+			ToString(&str);
+			return str;
+		}
+
+		void XmlString::ToString(string* o_str) const
+		{
+			char const* pos = m_data;
+			char const* end = m_data + m_length;
+			char const* amp = (char const*) memchr(pos, '&', m_length);
+			if (amp == NULL)
+			{
+				o_str->assign(m_data, m_length);
+				NormalizeLineEnds(o_str);
+				return;
+			}
+
+			o_str->clear();
+			o_str->reserve(m_length);
+			while (amp != NULL)
+			{
+				o_str->append(pos, amp - pos);
+				pos = amp + 1;
+				char const* semicolon = (char const*) memchr(pos, ';', end - pos);
+				size_t length = semicolon ? semicolon - pos : 0;
+				if (length == 0 || length > 10)
+				{
+					// Not an entity, keep the '&'
+					o_str->push_back('&');
+				}
+				else if (length == 3 && !strncmp(pos, "amp", 3))
+				{
+					o_str->push_back('&');
+					pos = semicolon + 1;
+				}
+				else if (length == 2 && !strncmp(pos, "lt", 2))
+				{
+					o_str->push_back('<');
+					pos = semicolon + 1;
+				}
+				else if (length == 2 && !strncmp(pos, "gt", 2))
+				{
+					o_str->push_back('>');
+					pos = semicolon + 1;
+				}
+				else if (length == 4 && !strncmp(pos, "quot", 4))
+				{
+					o_str->push_back('"');
+					pos = semicolon + 1;
+				}
+				else if (length == 4 && !strncmp(pos, "apos", 4))
+				{
+					o_str->push_back('\'');
+					pos = semicolon + 1;
+				}
+				else if (pos[0] == '#')
+				{
+					char buffer[16];
+					bool hex = (pos[1] == 'x' || pos[1] == 'X');
+					char* stop;
+					if (CopyNumber(pos + (hex ? 2 : 1), length - (hex ? 2 : 1), buffer, sizeof(buffer)))
+					{
+						AppendUtf8((uint32) strtoul(buffer, &stop, hex ? 16 : 10), o_str);
+						pos = semicolon + 1;
+					}
+					else
+					{
+						o_str->push_back('&');
+					}
+				}
+				else
+				{
+					// Unknown entity, keep it as it is
+					o_str->push_back('&');
+				}
+				amp = (char const*) memchr(pos, '&', end - pos);
+			}
+			o_str->append(pos, end - pos);
+			NormalizeLineEnds(o_str);
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlString::ToInt>
+// Parse the string as a number
+//-----------------------------------------------------------------------------
+		bool XmlString::ToInt(int32* o_value, int _base) const
+		{
+			char buffer[32];
+			if (!CopyNumber(m_data, m_length, buffer, sizeof(buffer)))
+			{
+				return false;
+			}
+			char* stop;
+			long value = strtol(buffer, &stop, _base);
+			if (stop == buffer)
+			{
+				return false;
+			}
+			*o_value = (int32) value;
+			return true;
+		}
+
+		bool XmlString::ToUInt64(uint64* o_value) const
+		{
+			char buffer[32];
+			if (!CopyNumber(m_data, m_length, buffer, sizeof(buffer)))
+			{
+				return false;
+			}
+			char* stop;
+			unsigned long long value = strtoull(buffer, &stop, 10);
+			if (stop == buffer)
+			{
+				return false;
+			}
+			*o_value = (uint64) value;
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::XmlReader>
+// Constructor
+//-----------------------------------------------------------------------------
+		XmlReader::XmlReader() :
+				m_begin(NULL), m_end(NULL), m_pos(NULL), m_mapped(NULL), m_mappedSize(0), m_lineCounted(NULL), m_line(1), m_tokenStart(NULL), m_token(Token_None), m_textIsCData(false), m_emptyElement(false), m_rootSeen(false), m_depth(0)
+		{
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::~XmlReader>
+// Destructor
+//-----------------------------------------------------------------------------
+		XmlReader::~XmlReader()
+		{
+			Close();
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::Open>
+// Map a file for reading
+//-----------------------------------------------------------------------------
+		bool XmlReader::Open(string const& _filename)
+		{
+			Close();
+			char const* data;
+			uint64 size;
+			if (!Platform::FileOps::Create()->FileMap(_filename, &data, &size))
+			{
+				m_filename = _filename;
+				m_token = Token_Error;
+				m_error = "Cannot read the file";
+				return false;
+			}
+			m_mapped = data;
+			m_mappedSize = size;
+			Start(data, (size_t) size, _filename);
+			return true;
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::Open>
+// Read a document in memory
+//-----------------------------------------------------------------------------
+		void XmlReader::Open(char const* _data, size_t _length, string const& _name)
+		{
+			Close();
+			Start(_data, _length, _name);
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::Start>
+// Set up to read a document from the start
+//-----------------------------------------------------------------------------
+		void XmlReader::Start(char const* _data, size_t _length, string const& _name)
+		{
+			m_filename = _name;
+			m_begin = _data;
+			m_end = _data + _length;
+			m_pos = m_begin;
+			if (_length >= 3 && !memcmp(m_pos, "\xef\xbb\xbf", 3))
+			{
+				// Skip the UTF-8 byte order mark
+				m_pos += 3;
+			}
+			m_lineCounted = m_begin;
+			m_line = 1;
+			m_tokenStart = m_pos;
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::Close>
+// Release the document
+//-----------------------------------------------------------------------------
+		void XmlReader::Close()
+		{
+			if (m_mapped != NULL)
+			{
+				Platform::FileOps::FileUnmap(m_mapped, m_mappedSize);
+			}
+			m_mapped = NULL;
+			m_mappedSize = 0;
+			m_begin = m_end = m_pos = m_lineCounted = m_tokenStart = NULL;
+			m_line = 1;
+			m_token = Token_None;
+			m_name = XmlString();
+			m_text = XmlString();
+			m_textIsCData = false;
+			m_emptyElement = false;
+			m_rootSeen = false;
+			m_depth = 0;
+			m_open.clear();
+			m_attributes.clear();
+			m_error.clear();
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::Next>
+// Move to the next token
+//-----------------------------------------------------------------------------
+		XmlReader::Token XmlReader::Next()
+		{
+			if (m_token == Token_Error || m_token == Token_EndOfDocument)
+			{
+				return m_token;
+			}
+			m_attributes.clear();
+			m_text = XmlString();
+
+			if (m_emptyElement)
+			{
+				// The end of <name/>
+				m_emptyElement = false;
+				m_name = m_open.back();
+				m_depth = (uint32) m_open.size();
+				m_open.pop_back();
+				return m_token = Token_EndElement;
+			}
+
+			while (true)
+			{
+				m_tokenStart = m_pos;
+				if (m_pos >= m_end)
+				{
+					if (!m_open.empty())
+					{
+						return SetError("The document ends inside an element");
+					}
+					if (!m_rootSeen)
+					{
+						return SetError("The document has no root element");
+					}
+					m_depth = 0;
+					return m_token = Token_EndOfDocument;
+				}
+
+				size_t left = m_end - m_pos;
+				if (*m_pos != '<')
+				{
+					char const* start = m_pos;
+					char const* lt = (char const*) memchr(m_pos, '<', left);
+					m_pos = lt ? lt : m_end;
+					char const* pos = start;
+					while (pos < m_pos && IsWhiteSpace(*pos))
+					{
+						++pos;
+					}
+					if (pos == m_pos)
+					{
+						continue;
+					}
+					if (m_open.empty())
+					{
+						return SetError("Text outside of the root element");
+					}
+					m_text = XmlString(start, m_pos - start);
+					m_textIsCData = false;
+					m_depth = (uint32) m_open.size();
+					return m_token = Token_Text;
+				}
+
+				if (left >= 4 && !memcmp(m_pos, "<!--", 4))
+				{
+					if (!Skip("-->"))
+					{
+						return SetError("Unterminated comment");
+					}
+					continue;
+				}
+
+				if (left >= 9 && !memcmp(m_pos, "<![CDATA[", 9))
+				{
+					char const* start = m_pos + 9;
+					if (!Skip("]]>"))
+					{
+						return SetError("Unterminated CDATA section");
+					}
+					if (m_open.empty())
+					{
+						return SetError("CDATA outside of the root element");
+					}
+					m_text = XmlString(start, m_pos - 3 - start);
+					m_textIsCData = true;
+					m_depth = (uint32) m_open.size();
+					return m_token = Token_Text;
+				}
+
+				if (left >= 2 && m_pos[1] == '?')
+				{
+					if (!Skip("?>"))
+					{
+						return SetError("Unterminated processing instruction");
+					}
+					continue;
+				}
+
+				if (left >= 2 && m_pos[1] == '!')
+				{
+					// A DOCTYPE, which may hold declarations in brackets
+					int brackets = 0;
+					for (++m_pos; m_pos < m_end; ++m_pos)
+					{
+						if (*m_pos == '[')
+						{
+							++brackets;
+						}
+						else if (*m_pos == ']')
+						{
+							--brackets;
+						}
+						else if (*m_pos == '>' && brackets <= 0)
+						{
+							break;
+						}
+					}
+					if (m_pos >= m_end)
+					{
+						return SetError("Unterminated declaration");
+					}
+					++m_pos;
+					continue;
+				}
+
+				if (left >= 2 && m_pos[1] == '/')
+				{
+					m_pos += 2;
+					if (!ParseName(&m_name))
+					{
+						return SetError("Bad end tag");
+					}
+					SkipWhiteSpace();
+					if (m_pos >= m_end || *m_pos != '>')
+					{
+						return SetError("Bad end tag");
+					}
+					++m_pos;
+					if (m_open.empty() || m_open.back().GetLength() != m_name.GetLength() || memcmp(m_open.back().GetData(), m_name.GetData(), m_name.GetLength()))
+					{
+						return SetError("The end tag does not match the start tag");
+					}
+					m_depth = (uint32) m_open.size();
+					m_open.pop_back();
+					return m_token = Token_EndElement;
+				}
+
+				if (m_open.empty() && m_rootSeen)
+				{
+					return SetError("More than one root element");
+				}
+				++m_pos;
+				if (!ParseStartTag())
+				{
+					return m_token;
+				}
+				m_open.push_back(m_name);
+				m_depth = (uint32) m_open.size();
+				m_rootSeen = true;
+				return m_token = Token_StartElement;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::ParseStartTag>
+// Read the name and attributes of an element
+//-----------------------------------------------------------------------------
+		bool XmlReader::ParseStartTag()
+		{
+			if (!ParseName(&m_name))
+			{
+				SetError("Bad element name");
+				return false;
+			}
+			while (true)
+			{
+				SkipWhiteSpace();
+				if (m_pos >= m_end)
+				{
+					SetError("Unterminated start tag");
+					return false;
+				}
+				if (*m_pos == '>')
+				{
+					++m_pos;
+					return true;
+				}
+				if (*m_pos == '/')
+				{
+					if (m_pos + 1 < m_end && m_pos[1] == '>')
+					{
+						m_pos += 2;
+						m_emptyElement = true;
+						return true;
+					}
+					SetError("Bad start tag");
+					return false;
+				}
+
+				Attribute attribute;
+				if (!ParseName(&attribute.m_name))
+				{
+					SetError("Bad attribute name");
+					return false;
+				}
+				SkipWhiteSpace();
+				if (m_pos >= m_end || *m_pos != '=')
+				{
+					SetError("Attribute without a value");
+					return false;
+				}
+				++m_pos;
+				SkipWhiteSpace();
+				if (m_pos >= m_end || (*m_pos != '"' && *m_pos != '\''))
+				{
+					SetError("Attribute value without quotes");
+					return false;
+				}
+				char const quote = *m_pos++;
+				char const* end = (char const*) memchr(m_pos, quote, m_end - m_pos);
+				if (end == NULL)
+				{
+					SetError("Unterminated attribute value");
+					return false;
+				}
+				attribute.m_value = XmlString(m_pos, end - m_pos);
+				m_attributes.push_back(attribute);
+				m_pos = end + 1;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::ParseName>
+// Read an element or attribute name
+//-----------------------------------------------------------------------------
+		bool XmlReader::ParseName(XmlString* o_name)
+		{
+			char const* start = m_pos;
+			while (m_pos < m_end && !IsWhiteSpace(*m_pos) && *m_pos != '/' && *m_pos != '>' && *m_pos != '=' && *m_pos != '<')
+			{
+				++m_pos;
+			}
+			*o_name = XmlString(start, m_pos - start);
+			return m_pos > start;
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::Skip>
+// Move past the next occurrence of _terminator
+//-----------------------------------------------------------------------------
+		bool XmlReader::Skip(char const* _terminator)
+		{
+			size_t length = strlen(_terminator);
+			char const* pos = m_pos;
+			while ((pos = (char const*) memchr(pos, _terminator[0], m_end - pos)) != NULL)
+			{
+				if ((size_t) (m_end - pos) < length)
+				{
+					break;
+				}
+				if (!memcmp(pos, _terminator, length))
+				{
+					m_pos = pos + length;
+					return true;
+				}
+				++pos;
+			}
+			m_pos = m_end;
+			return false;
+		}
+
+		void XmlReader::SkipWhiteSpace()
+		{
+			while (m_pos < m_end && IsWhiteSpace(*m_pos))
+			{
+				++m_pos;
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::NextChild>
+// Move to the next child of the element at _depth
+//-----------------------------------------------------------------------------
+		bool XmlReader::NextChild(uint32 _depth)
+		{
+			while (true)
+			{
+				switch (Next())
+				{
+					case Token_StartElement:
+					{
+						if (m_depth == _depth + 1)
+						{
+							return true;
+						}
+						// Inside a child the caller did not read to its end
+						if (!SkipElement())
+						{
+							return false;
+						}
+						break;
+					}
+					case Token_EndElement:
+					{
+						if (m_depth <= _depth)
+						{
+							return false;
+						}
+						break;
+					}
+					case Token_Text:
+					{
+						break;
+					}
+					default:
+					{
+						return false;
+					}
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::SkipElement>
+// Move past the end of the element that has just started
+//-----------------------------------------------------------------------------
+		bool XmlReader::SkipElement()
+		{
+			if (m_token != Token_StartElement)
+			{
+				return !HasError();
+			}
+			uint32 depth = m_depth;
+			while (true)
+			{
+				Token token = Next();
+				if (token == Token_EndElement && m_depth == depth)
+				{
+					return true;
+				}
+				if (token == Token_Error || token == Token_EndOfDocument)
+				{
+					return false;
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::ReadText>
+// Read the text of the element that has just started.  Like TinyXML's
+// GetText, only the first piece of text counts.
+//-----------------------------------------------------------------------------
+		bool XmlReader::ReadText(string* o_text)
+		{
+			if (m_token != Token_StartElement)
+			{
+				return false;
+			}
+			uint32 depth = m_depth;
+			bool found = false;
+			while (true)
+			{
+				switch (Next())
+				{
+					case Token_Text:
+					{
+						if (!found)
+						{
+							GetText(o_text);
+							found = true;
+						}
+						break;
+					}
+					case Token_StartElement:
+					{
+						if (!SkipElement())
+						{
+							return false;
+						}
+						break;
+					}
+					case Token_EndElement:
+					{
+						if (m_depth == depth)
+						{
+							return found;
+						}
+						break;
+					}
+					default:
+					{
+						return false;
+					}
+				}
+			}
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::GetAttribute>
+// Find an attribute of the element that has just started
+//-----------------------------------------------------------------------------
+		XmlString XmlReader::GetAttribute(char const* _name) const
+		{
+			for (vector<Attribute>::const_iterator it = m_attributes.begin(); it != m_attributes.end(); ++it)
+			{
+				if (it->m_name == _name)
+				{
+					return it->m_value;
+				}
+			}
+			return XmlString();
+		}
+
+		bool XmlReader::GetAttribute(char const* _name, string* o_value) const
+		{
+			XmlString value = GetAttribute(_name);
+			if (!value.Exists())
+			{
+				return false;
+			}
+			value.ToString(o_value);
+			return true;
+		}
+
+		bool XmlReader::GetAttribute(char const* _name, int32* o_value, int _base) const
+		{
+			return GetAttribute(_name).ToInt(o_value, _base);
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::GetText>
+// The text of a Text token, with white space condensed like TinyXML does
+//-----------------------------------------------------------------------------
+		void XmlReader::GetText(string* o_text) const
+		{
+			m_text.ToString(o_text);
+			if (m_textIsCData)
+			{
+				return;
+			}
+
+			size_t out = 0;
+			bool space = false;
+			for (size_t i = 0; i < o_text->size(); ++i)
+			{
+				char c = (*o_text)[i];
+				if (IsWhiteSpace(c))
+				{
+					space = (out > 0);
+					continue;
+				}
+				if (space)
+				{
+					(*o_text)[out++] = ' ';
+					space = false;
+				}
+				(*o_text)[out++] = c;
+			}
+			o_text->resize(out);
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::GetLine>
+// The line the current token starts on
+//-----------------------------------------------------------------------------
+		uint32 XmlReader::GetLine()
+		{
+			if (m_tokenStart == NULL)
+			{
+				return 0;
+			}
+			if (m_tokenStart < m_lineCounted)
+			{
+				m_lineCounted = m_begin;
+				m_line = 1;
+			}
+			char const* pos = m_lineCounted;
+			while ((pos = (char const*) memchr(pos, '\n', m_tokenStart - pos)) != NULL)
+			{
+				++m_line;
+				++pos;
+			}
+			m_lineCounted = m_tokenStart;
+			return m_line;
+		}
+
+//-----------------------------------------------------------------------------
+// <XmlReader::SetError>
+// Stop reading, and say where and why
+//-----------------------------------------------------------------------------
+		XmlReader::Token XmlReader::SetError(char const* _error)
+		{
+			char line[32];
+			snprintf(line, sizeof(line), " at line %u", GetLine());
+			m_error = string(_error) + line;
+			return m_token = Token_Error;
+		}
+	} // namespace Internal
+} // namespace OpenZWave
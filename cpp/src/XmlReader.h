@@ -0,0 +1,273 @@
+//-----------------------------------------------------------------------------
+//
+//	XmlReader.h
+//
+//	Reads XML files one token at a time, in place
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _XmlReader_H
+#define _XmlReader_H
+
+#include <string>
+#include <vector>
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		/** \brief A name, attribute value or text in the document being read.
+		 * \ingroup Main
+		 *
+		 * Points into the document, so it is only valid until the reader is
+		 * closed.  Entities are left as they are until the string is copied
+		 * out with ToString.
+		 */
+		class XmlString
+		{
+			public:
+				XmlString() :
+						m_data(NULL), m_length(0)
+				{
+				}
+				XmlString(char const* _data, size_t _length) :
+						m_data(_data), m_length(_length)
+				{
+				}
+
+				/**
+				 * \return false if the attribute this was asked for does not exist.
+				 */
+				bool Exists() const
+				{
+					return m_data != NULL;
+				}
+				char const* GetData() const
+				{
+					return m_data;
+				}
+				size_t GetLength() const
+				{
+					return m_length;
+				}
+
+				/**
+				 * Compare the undecoded string, which is enough for names.
+				 */
+				bool operator ==(char const* _str) const;
+				bool operator !=(char const* _str) const
+				{
+					return !(*this == _str);
+				}
+
+				/**
+				 * Copy the string out, with entities and character references replaced
+				 * and line ends read as a single newline.
+				 */
+				string ToString() const;
+				void ToString(string* o_str) const;
+
+				/**
+				 * Parse the string as a number, like strtol.
+				 * \return false if it is not a number.
+				 */
+				bool ToInt(int32* o_value, int _base = 10) const;
+				bool ToUInt64(uint64* o_value) const;
+
+			private:
+				char const* m_data;
+				size_t m_length;
+		};
+
+		/** \brief Reads an XML file one token at a time, like a SAX parser the
+		 * caller pulls from.
+		 * \ingroup Main
+		 *
+		 * The file is mapped into memory and parsed where it is, so names,
+		 * attributes and text are handed out as XmlStrings pointing into it.
+		 * Only what the caller copies out is allocated.  This makes reading the
+		 * large config files much cheaper than building a TiXmlDocument, which
+		 * copies the file and allocates every element, attribute and text.
+		 *
+		 * Comments, processing instructions and the DOCTYPE are skipped.  Text is
+		 * returned with its white space condensed, the way TinyXML does by default.
+		 *
+		 * The usual way to read an element is to loop over its children:
+		 * \code
+		 * uint32 depth = reader.GetDepth();
+		 * while (reader.NextChild(depth))
+		 * {
+		 *     if (reader.GetName() == "Product") ...
+		 * }
+		 * if (reader.HasError()) ...
+		 * \endcode
+		 */
+		class XmlReader
+		{
+			public:
+				enum Token
+				{
+					Token_None = 0,			// Nothing has been read yet
+					Token_Error,
+					Token_EndOfDocument,
+					Token_StartElement,		// <name attributes> or <name attributes/>
+					Token_EndElement,		// </name>, also returned after an empty element
+					Token_Text				// Text or a CDATA section
+				};
+
+				XmlReader();
+				~XmlReader();
+
+				/**
+				 * Map a file for reading.  The reader is positioned before the root element.
+				 * \return false if the file cannot be read.  GetError says why.
+				 */
+				bool Open(string const& _filename);
+
+				/**
+				 * Read a document that is already in memory.  It must stay there until the reader is closed.
+				 */
+				void Open(char const* _data, size_t _length, string const& _name);
+
+				void Close();
+
+				/**
+				 * Move to the next token.
+				 */
+				Token Next();
+
+				/**
+				 * Move to the next child element of the element at _depth, skipping
+				 * anything inside the previous child that the caller did not read.
+				 * Use a depth of 0 to move to the root element.
+				 * \return true on the start of a child, false at the end of the element or on an error.
+				 */
+				bool NextChild(uint32 _depth);
+
+				/**
+				 * Move past the end of the element that has just started.
+				 * \return false on an error.
+				 */
+				bool SkipElement();
+
+				/**
+				 * Read the text inside the element that has just started, and move past
+				 * its end.  Text inside child elements is ignored.
+				 * \return false if the element has no text.
+				 */
+				bool ReadText(string* o_text);
+
+				Token GetToken() const
+				{
+					return m_token;
+				}
+
+				/**
+				 * The name of the element that started or ended.
+				 */
+				XmlString const& GetName() const
+				{
+					return m_name;
+				}
+
+				/**
+				 * The number of elements the current token is in, counting the one
+				 * that starts or ends.  The root element is at depth 1.
+				 */
+				uint32 GetDepth() const
+				{
+					return m_depth;
+				}
+
+				/**
+				 * An attribute of the element that has just started.
+				 * \return a string that does not exist if the element has no such attribute.
+				 */
+				XmlString GetAttribute(char const* _name) const;
+				bool GetAttribute(char const* _name, string* o_value) const;
+				bool GetAttribute(char const* _name, int32* o_value, int _base = 10) const;
+
+				/**
+				 * The text of a Text token, decoded and condensed.
+				 */
+				void GetText(string* o_text) const;
+
+				/**
+				 * The line the current token starts on, for error messages.
+				 */
+				uint32 GetLine();
+
+				bool HasError() const
+				{
+					return m_token == Token_Error;
+				}
+				string const& GetError() const
+				{
+					return m_error;
+				}
+				string const& GetFilename() const
+				{
+					return m_filename;
+				}
+
+			private:
+				XmlReader(XmlReader const&);					// prevent copy
+				XmlReader& operator =(XmlReader const&);		// prevent assignment
+
+				struct Attribute
+				{
+					XmlString m_name;
+					XmlString m_value;
+				};
+
+				void Start(char const* _data, size_t _length, string const& _name);
+				Token SetError(char const* _error);
+				bool ParseStartTag();
+				bool ParseName(XmlString* o_name);
+				bool Skip(char const* _terminator);
+				void SkipWhiteSpace();
+
+				string m_filename;
+				char const* m_begin;
+				char const* m_end;
+				char const* m_pos;
+				char const* m_mapped;					// What FileMap returned, if the document is a mapped file
+				uint64 m_mappedSize;
+				char const* m_lineCounted;				// Lines have been counted up to here
+				uint32 m_line;
+				char const* m_tokenStart;
+
+				Token m_token;
+				XmlString m_name;
+				XmlString m_text;
+				bool m_textIsCData;
+				bool m_emptyElement;					// The element that just started has no end tag
+				bool m_rootSeen;
+				uint32 m_depth;
+				vector<XmlString> m_open;				// Names of the elements the reader is in
+				vector<Attribute> m_attributes;
+				string m_error;
+		};
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_XmlReader_H
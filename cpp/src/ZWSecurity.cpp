@@ -35,7 +35,7 @@
 #include "platform/Log.h"
 #include "command_classes/MultiInstance.h"
 #include "command_classes/Security.h"
-#include "aes/aescpp.h"
+#include "AesKey.h"
 
 namespace OpenZWave
 {
@@ -69,61 +69,8 @@ namespace OpenZWave
 			Log::Write(LogLevel_Debug, _receivingNode, "Raw Auth (Minus IV) Size: %d (%d)", bufsize, bufsize+16);
 #endif
 
-			aes_mode_reset(driver->GetAuthKey());
-			/* encrypt the IV with ecb */
-			if (aes_ecb_encrypt(iv, tmpauth, 16, driver->GetAuthKey()) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, _receivingNode, "Failed Initial ECB Encrypt of Auth Packet");
-				return false;
-			}
-
-			/* our temporary holding var */
-			uint8 encpck[16];
-
-			int block = 0;
-			/* reset our encpck temp var */
-			memset(encpck, 0, 16);
-			/* now xor the buffer with our encrypted IV */
-			for (int i = 0; i < bufsize; i++)
-			{
-				encpck[block] = buffer[i];
-				block++;
-				/* if we hit a blocksize, then encrypt */
-				if (block == 16)
-				{
-					for (int j = 0; j < 16; j++)
-					{
-						/* here we do our xor */
-						tmpauth[j] = encpck[j] ^ tmpauth[j];
-						/* and reset encpck for good measure */
-						encpck[j] = 0;
-					}
-					/* reset our block counter back to 0 */
-					block = 0;
-					aes_mode_reset(driver->GetAuthKey());
-					if (aes_ecb_encrypt(tmpauth, tmpauth, 16, driver->GetAuthKey()) == EXIT_FAILURE)
-					{
-						Log::Write(LogLevel_Warning, _receivingNode, "Failed Subsequent (%d) ECB Encrypt of Auth Packet", i);
-						return false;
-					}
-				}
-			}
-			/* any left over data that isn't a full block size*/
-			if (block > 0)
-			{
-				for (int i = 0; i < 16; i++)
-				{
-					/* encpck from block to 16 is already guaranteed to be 0
-					 * so its safe to xor it with out tmpmac */
-					tmpauth[i] = encpck[i] ^ tmpauth[i];
-				}
-				aes_mode_reset(driver->GetAuthKey());
-				if (aes_ecb_encrypt(tmpauth, tmpauth, 16, driver->GetAuthKey()) == EXIT_FAILURE)
-				{
-					Log::Write(LogLevel_Warning, _receivingNode, "Failed Final ECB Encrypt of Auth Packet");
-					return false;
-				}
-			}
+			/* CBC-MAC of the buffer, starting from the encrypted IV */
+			driver->GetAuthKey().CbcMac(iv, buffer, bufsize, tmpauth);
 			/* we only care about the first 8 bytes of tmpauth as the mac */
 #ifdef DEBUG
 			Internal::PrintHex("Computed Auth", tmpauth, 8);
@@ -172,13 +119,6 @@ namespace OpenZWave
 				initializationVector[8 + i] = m_nonce[i];
 			}
 
-			/* we need a copy b/c aes_ofb_encrypt will overwrite it */
-			uint8 iv_dup[16];
-			for (int i = 0; i < 16; i++)
-			{
-				iv_dup[i] = initializationVector[i];
-			}
-
 			uint8 plaintextmsg[32];
 			/* add the Sequence Flag
 			 * - Since we don't currently handle multipacket encryption
@@ -189,32 +129,30 @@ namespace OpenZWave
 			for (int i = 0; i < m_length - 6 - 3; i++)
 				plaintextmsg[i + 1] = m_buffer[6 + i];
 
-			/* now encrypt */
-			uint8 encryptedpayload[30];
-			aes_mode_reset(driver->GetEncKey());
+			/* the MAC covers the command, the node ids and the length ahead of the encrypted payload */
+			uint8 const encryptedLength = m_length - 5 - 3;
+			uint8 header[4];
+			header[0] = Internal::CC::SecurityCmd_MessageEncap;
+			header[1] = _sendingNode;
+			header[2] = _receivingNode;
+			header[3] = encryptedLength;
+
+			/* now encrypt, straight into the packet, and calculate the MAC with it */
 #ifdef DEBUG
-			Internal::PrintHex("Plain Text Packet:", plaintextmsg, m_length-5-3);
+			Internal::PrintHex("Plain Text Packet:", plaintextmsg, encryptedLength);
 #endif
-			if (aes_ofb_encrypt(plaintextmsg, encryptedpayload, m_length - 5 - 3, initializationVector, driver->GetEncKey()) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, _receivingNode, "Failed to Encrypt Packet");
-				return false;
-			}
+			uint8 mac[16];
+			Internal::AesKey::EncryptAndMac(driver->GetEncKey(), driver->GetAuthKey(), initializationVector, header, 4, plaintextmsg, &e_buffer[len], encryptedLength, mac);
 #ifdef DEBUG
-			Internal::PrintHex("Encrypted Packet", encryptedpayload, m_length-5-3);
+			Internal::PrintHex("Encrypted Packet", &e_buffer[len], encryptedLength);
+			Internal::PrintHex("Computed Auth", mac, 8);
 #endif
-			/* now add the Encrypted output to the packet */
-			for (int i = 0; i < m_length - 5 - 3; i++)
-			{
-				e_buffer[len++] = encryptedpayload[i];
-			}
+			len += encryptedLength;
 
 			// Append the nonce identifier :)
 			e_buffer[len++] = m_nonce[0];
 
-			/* now calculate the MAC and append it */
-			uint8 mac[8];
-			GenerateAuthentication(&e_buffer[7], e_buffer[5], driver, _sendingNode, _receivingNode, iv_dup, mac);
+			/* and append the first 8 bytes of the MAC */
 			for (int i = 0; i < 8; ++i)
 			{
 				e_buffer[len++] = mac[i];
@@ -292,53 +230,25 @@ namespace OpenZWave
 				return false;
 			}
 
-			uint8 encyptedpacket[32];
-
-			for (uint32 i = 0; i < 32; i++)
-			{
-				if (i >= encryptedpacketsize)
-				{
-					/* pad the remaining fields */
-					encyptedpacket[i] = 0;
-				}
-				else
-				{
-					encyptedpacket[i] = e_buffer[10 + i];
-				}
-			}
-
 #ifdef DEBUG
 			Log::Write(LogLevel_Debug, _sendingNode, "Encrypted Packet Sizes: %u (Total) %u (Payload)", e_length, encryptedpacketsize);
 			Internal::PrintHex("IV", iv, 16);
-			Internal::PrintHex("Encrypted", encyptedpacket, 32);
+			Internal::PrintHex("Encrypted", &e_buffer[10], encryptedpacketsize);
 			/* Mac Starts after Encrypted Packet. */
 			Internal::PrintHex("Auth", &e_buffer[11+encryptedpacketsize], 8);
 #endif
-			aes_mode_reset(driver->GetEncKey());
-#if 0
-			uint8_t iv[16] =
-			{	0x81, 0x42, 0xd1, 0x51, 0xf1, 0x59, 0x3d, 0x70, 0xd5, 0xe3, 0x6c, 0xcb, 0x02, 0xd0, 0x3f, 0x5c, /* */};
-			uint8_t pck[] =
-			{	0x25, 0x68, 0x06, 0xc5, 0xb3, 0xee, 0x2c, 0x17, 0x26, 0x7e, 0xf0, 0x84, 0xd4, 0xc3, 0xba, 0xed, 0xe5, 0xb9, 0x55};
-			if (aes_ofb_decrypt(pck, decryptpacket, 19, iv, this->EncryptKey) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, GetNodeId(), "Failed to Decrypt Packet");
-				return false;
-			}
-			Internal::PrintHex("Pck", decryptpacket, 19);
-#else
-			if (aes_ofb_decrypt(encyptedpacket, m_buffer, encryptedpacketsize, iv, driver->GetEncKey()) == EXIT_FAILURE)
-			{
-				Log::Write(LogLevel_Warning, _sendingNode, "Failed to Decrypt Packet");
-				return false;
-			}
+			/* the MAC covers the command, the node ids and the length ahead of the encrypted payload */
+			uint8 header[4];
+			header[0] = e_buffer[1];
+			header[1] = _sendingNode;
+			header[2] = _receivingNode;
+			header[3] = (uint8) encryptedpacketsize;
+
+			/* decrypt and calculate the MAC in one go, which leaves the IV as it is */
+			uint8 mac[16];
+			Internal::AesKey::DecryptAndMac(driver->GetEncKey(), driver->GetAuthKey(), iv, header, 4, &e_buffer[10], m_buffer, encryptedpacketsize, mac);
 			Log::Write(LogLevel_Detail, _sendingNode, "Decrypted Packet: %s", Internal::PktToString(m_buffer, encryptedpacketsize).c_str());
-#endif
-			uint8 mac[32];
-			/* we have to regenerate the IV as the ofb decryption routine will alter it. */
-			createIVFromPacket_inbound(&e_buffer[2], m_nonce, iv);
 
-			GenerateAuthentication(&e_buffer[1], e_length - 1, driver, _sendingNode, _receivingNode, iv, mac);
 			if (memcmp(&e_buffer[11 + encryptedpacketsize], mac, 8) != 0)
 			{
 				Log::Write(LogLevel_Warning, _sendingNode, "MAC Authentication of Packet Failed. Dropping");
@@ -359,21 +269,19 @@ namespace OpenZWave
 
 		SecurityStrategy ShouldSecureCommandClass(uint8 CommandClass)
 		{
-			string securestrategy;
-			Options::Get()->GetOptionAsString("SecurityStrategy", &securestrategy);
+			string securestrategy = Internal::ToUpper(Options::Get()->GetValues().m_SecurityStrategy);
 
-			if (Internal::ToUpper(securestrategy) == "ESSENTIAL")
+			if (securestrategy == "ESSENTIAL")
 			{
 				return SecurityStrategy_Essential;
 			}
-			else if (Internal::ToUpper(securestrategy) == "SUPPORTED")
+			else if (securestrategy == "SUPPORTED")
 			{
 				return SecurityStrategy_Supported;
 			}
-			else if (Internal::ToUpper(securestrategy) == "CUSTOM")
+			else if (securestrategy == "CUSTOM")
 			{
-				string customsecurecc;
-				Options::Get()->GetOptionAsString("CustomSecuredCC", &customsecurecc);
+				string customsecurecc = Options::Get()->GetValues().m_CustomSecuredCC;
 
 				char* pos = const_cast<char*>(customsecurecc.c_str());
 				while (*pos)
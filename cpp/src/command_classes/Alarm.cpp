@@ -247,7 +247,7 @@ namespace OpenZWave
 						{
 							NotificationSequence = _data[7 + EventParamLength];
 						}
-						Log::Write(LogLevel_Info, GetNodeId(), "Received Notification report (>v1): Type: %s (%d) Event: %s (%d) Status: %s, Param Length: %d", NotificationCCTypes::Get()->GetAlarmType(NotificationType).c_str(), NotificationType, NotificationCCTypes::Get()->GetEventForAlarmType(NotificationType, NotificationEvent).c_str(), NotificationEvent, NotificationStatus ? "true" : "false", EventParamLength);
+						Log::Write(LogLevel_Info, GetNodeId(), "Received Notification report (>v1): Type: %s (%d) Event: %s (%d) Status: %s, Param Length: %d", NotificationCCTypes::Get()->GetAlarmType(NotificationType), NotificationType, NotificationCCTypes::Get()->GetEventForAlarmType(NotificationType, NotificationEvent), NotificationEvent, NotificationStatus ? "true" : "false", EventParamLength);
 						if (NotificationSequencePresent)
 							Log::Write(LogLevel_Info, GetNodeId(), "\t Sequence Number: %d", NotificationSequence);
 
@@ -257,12 +257,12 @@ namespace OpenZWave
 						/* do any Event Params that are sent over */
 						if (EventParamLength > 0)
 						{
-							const std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams> > nep = NotificationCCTypes::Get()->GetAlarmNotificationEventParams(NotificationType, NotificationEvent);
+							const ConfigTables::Table<NotificationCCTypes::NotificationEventParams> nep = NotificationCCTypes::Get()->GetAlarmNotificationEventParams(NotificationType, NotificationEvent);
 							if (nep.size() > 0)
 							{
-								for (std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams> >::const_iterator it = nep.begin(); it != nep.end(); it++)
+								for (NotificationCCTypes::NotificationEventParams const* it = nep.begin(); it != nep.end(); it++)
 								{
-									switch (it->second->type)
+									switch (it->m_type)
 									{
 										case NotificationCCTypes::NEPT_Location:
 										{
@@ -271,11 +271,11 @@ namespace OpenZWave
 											 */
 											if ((_data[8] == NodeNaming::StaticGetCommandClassId()) && (_data[9] == 0x03) && EventParamLength > 2)
 											{
-												if (Internal::VC::ValueString *value = static_cast<Internal::VC::ValueString *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueString *value = static_cast<Internal::VC::ValueString *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(ExtractString(&_data[10], EventParamLength - 2));
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
@@ -292,11 +292,11 @@ namespace OpenZWave
 										{
 											if (EventParamLength == 1)
 											{
-												if (Internal::VC::ValueList *value = static_cast<Internal::VC::ValueList *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueList *value = static_cast<Internal::VC::ValueList *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(_data[8]);
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
@@ -319,21 +319,21 @@ namespace OpenZWave
 											 */
 											if ((EventParamLength >= 8) && (_data[8] == UserCode::StaticGetCommandClassId()) && (_data[9] == 0x03))
 											{
-												if (Internal::VC::ValueByte *value = static_cast<Internal::VC::ValueByte *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueByte *value = static_cast<Internal::VC::ValueByte *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(_data[11]);
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
 													Log::Write(LogLevel_Warning, GetNodeId(), "Couldn't Find ValueID_Index_Alarm::Type_ParamUserCodeid");
 												}
-												if (Internal::VC::ValueString *value = static_cast<Internal::VC::ValueString *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueString *value = static_cast<Internal::VC::ValueString *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(ExtractString(&_data[12], EventParamLength - 4));
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
@@ -343,11 +343,11 @@ namespace OpenZWave
 											else if (EventParamLength == 1)
 											{
 												/* some devices (Like BeNext TagReader) don't send a Proper UserCodeCmd_Report Message, Just the Index of the Code that Triggered */
-												if (Internal::VC::ValueByte *value = static_cast<Internal::VC::ValueByte *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueByte *value = static_cast<Internal::VC::ValueByte *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(_data[8]);
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
@@ -364,11 +364,11 @@ namespace OpenZWave
 										{
 											if (EventParamLength == 1)
 											{
-												if (Internal::VC::ValueByte *value = static_cast<Internal::VC::ValueByte *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueByte *value = static_cast<Internal::VC::ValueByte *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(_data[8]);
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
@@ -383,11 +383,11 @@ namespace OpenZWave
 										}
 										case NotificationCCTypes::NEPT_String:
 										{
-											if (Internal::VC::ValueString *value = static_cast<Internal::VC::ValueString *>(GetValue(_instance, it->first)))
+											if (Internal::VC::ValueString *value = static_cast<Internal::VC::ValueString *>(GetValue(_instance, it->m_id)))
 											{
 												value->OnValueRefreshed(ExtractString(&_data[10], EventParamLength - 2));
 												value->Release();
-												m_ParamsSet.push_back(it->first);
+												m_ParamsSet.push_back(it->m_id);
 											}
 											else
 											{
@@ -401,11 +401,11 @@ namespace OpenZWave
 											if (EventParamLength == 3)
 											{
 												uint32 duration = (_data[10] * 3600) + (_data[11] * 60) + (_data[12]);
-												if (Internal::VC::ValueInt *value = static_cast<Internal::VC::ValueInt *>(GetValue(_instance, it->first)))
+												if (Internal::VC::ValueInt *value = static_cast<Internal::VC::ValueInt *>(GetValue(_instance, it->m_id)))
 												{
 													value->OnValueRefreshed(duration);
 													value->Release();
-													m_ParamsSet.push_back(it->first);
+													m_ParamsSet.push_back(it->m_id);
 												}
 												else
 												{
@@ -475,22 +475,23 @@ namespace OpenZWave
 								if ((_data[i + 2] & (1 << bit)) != 0)
 								{
 									int32 index = (int32) (i << 3) + bit;
-									Log::Write(LogLevel_Info, GetNodeId(), "\tAlarmType: %s", NotificationCCTypes::Get()->GetAlarmType(index).c_str());
+									Log::Write(LogLevel_Info, GetNodeId(), "\tAlarmType: %s", NotificationCCTypes::Get()->GetAlarmType(index));
 									if (GetVersion() == 2)
 									{
 										/* EventSupported is only compatible in Version 3 and above */
 										vector<Internal::VC::ValueList::Item> _items;
-										if (const std::shared_ptr<NotificationCCTypes::NotificationTypes> nt = NotificationCCTypes::Get()->GetAlarmNotificationTypes(index))
+										if (NotificationCCTypes::NotificationTypes const* nt = NotificationCCTypes::Get()->GetAlarmNotificationTypes(index))
 										{
-											for (std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEvents> >::const_iterator it = nt->Events.begin(); it != nt->Events.end(); it++)
+											ConfigTables::Table<NotificationCCTypes::NotificationEvents> const events = NotificationCCTypes::Get()->GetEvents(nt);
+											for (NotificationCCTypes::NotificationEvents const* it = events.begin(); it != events.end(); it++)
 											{
 												/* Create it */
-												SetupEvents(index, it->first, &_items, _instance);
+												SetupEvents(index, it->m_id, &_items, _instance);
 #if 0
-												Log::Write ( LogLevel_Info, GetNodeId(), "\t\tAll Events - Alarm CC Version 2 - %s", it->second->name);
+												Log::Write ( LogLevel_Info, GetNodeId(), "\t\tAll Events - Alarm CC Version 2 - %s", it->m_name);
 												ValueList::Item item;
-												item.m_value = it->first;
-												item.m_label = it->second->name;
+												item.m_value = it->m_id;
+												item.m_label = it->m_name;
 												_items.push_back( item );
 #endif
 											}
@@ -523,7 +524,7 @@ namespace OpenZWave
 					{
 						uint32 type = _data[1];
 						// We have received the supported alarm Event types from the Z-Wave device
-						Log::Write(LogLevel_Info, GetNodeId(), "Received supported alarm Event types for AlarmType %s (%d)", NotificationCCTypes::Get()->GetAlarmType(type).c_str(), type);
+						Log::Write(LogLevel_Info, GetNodeId(), "Received supported alarm Event types for AlarmType %s (%d)", NotificationCCTypes::Get()->GetAlarmType(type), type);
 						// Parse the data for the supported Alarm Event types
 						uint8 numBytes = (_data[2] & 0x1F);
 						vector<Internal::VC::ValueList::Item> _items;
@@ -554,57 +555,59 @@ namespace OpenZWave
 			}
 			void Alarm::SetupEvents(uint32 type, uint32 index, vector<Internal::VC::ValueList::Item> *_items, uint32 const _instance)
 			{
-				if (const std::shared_ptr<NotificationCCTypes::NotificationEvents> ne = NotificationCCTypes::Get()->GetAlarmNotificationEvents(type, index))
+				if (NotificationCCTypes::NotificationEvents const* ne = NotificationCCTypes::Get()->GetAlarmNotificationEvents(type, index))
 				{
-					Log::Write(LogLevel_Info, GetNodeId(), "\tEvent Type %d: %s ", ne->id, ne->name.c_str());
+					Log::Write(LogLevel_Info, GetNodeId(), "\tEvent Type %d: %s ", ne->m_id, ne->m_name);
 					Internal::VC::ValueList::Item item;
-					item.m_value = ne->id;
-					item.m_label = ne->name;
+					item.m_value = ne->m_id;
+					item.m_label = ne->m_name;
 					_items->push_back(item);
 					/* If there are Params - Lets create the correct types now */
 					if (Node* node = GetNodeUnsafe())
 					{
-						for (std::map<uint32, std::shared_ptr<NotificationCCTypes::NotificationEventParams> >::const_iterator it = ne->EventParams.begin(); it != ne->EventParams.end(); it++)
+						ConfigTables::Table<NotificationCCTypes::NotificationEventParams> const params = NotificationCCTypes::Get()->GetEventParams(ne);
+						for (NotificationCCTypes::NotificationEventParams const* it = params.begin(); it != params.end(); it++)
 						{
-							switch (it->second->type)
+							switch (it->m_type)
 							{
 								case NotificationCCTypes::NEPT_Location:
 								{
-									node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first, it->second->name, "", true, false, "", 0);
+									node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id, it->m_name, "", true, false, "", 0);
 									break;
 								}
 								case NotificationCCTypes::NEPT_List:
 								{
 									vector<Internal::VC::ValueList::Item> _Paramitems;
-									for (std::map<uint32, string>::iterator it2 = it->second->ListItems.begin(); it2 != it->second->ListItems.end(); it2++)
+									ConfigTables::Table<NotificationCCTypes::NotificationListItems> const listItems = NotificationCCTypes::Get()->GetListItems(it);
+									for (NotificationCCTypes::NotificationListItems const* it2 = listItems.begin(); it2 != listItems.end(); it2++)
 									{
 										Internal::VC::ValueList::Item Paramitem;
-										Paramitem.m_value = ne->id;
-										Paramitem.m_label = ne->name;
+										Paramitem.m_value = ne->m_id;
+										Paramitem.m_label = ne->m_name;
 										_Paramitems.push_back(Paramitem);
 									}
-									node->CreateValueList(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first, it->second->name, "", true, false, (uint8_t) (_Paramitems.size() & 0xFF), _Paramitems, 0, 0);
+									node->CreateValueList(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id, it->m_name, "", true, false, (uint8_t) (_Paramitems.size() & 0xFF), _Paramitems, 0, 0);
 									break;
 								}
 								case NotificationCCTypes::NEPT_UserCodeReport:
 								{
-									node->CreateValueByte(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first, it->second->name, "", true, false, 0, 0);
-									node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first + 1, it->second->name, "", true, false, "", 0);
+									node->CreateValueByte(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id, it->m_name, "", true, false, 0, 0);
+									node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id + 1, it->m_name, "", true, false, "", 0);
 									break;
 								}
 								case NotificationCCTypes::NEPT_Byte:
 								{
-									node->CreateValueByte(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first, it->second->name, "", true, false, 0, 0);
+									node->CreateValueByte(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id, it->m_name, "", true, false, 0, 0);
 									break;
 								}
 								case NotificationCCTypes::NEPT_String:
 								{
-									node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first, it->second->name, "", true, false, "", 0);
+									node->CreateValueString(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id, it->m_name, "", true, false, "", 0);
 									break;
 								}
 								case NotificationCCTypes::NEPT_Time:
 								{
-									node->CreateValueInt(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->first, it->second->name, "", true, false, 0, 0);
+									node->CreateValueInt(ValueID::ValueGenre_User, GetCommandClassId(), _instance, it->m_id, it->m_name, "", true, false, 0, 0);
 									break;
 								}
 							}
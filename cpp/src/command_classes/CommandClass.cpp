@@ -378,7 +378,10 @@ namespace OpenZWave
 						/* just to be sure we have the right index */
 						if (it->first != _value->GetID().GetIndex())
 							return false;
-						Log::Write(LogLevel_Debug, GetNodeId(), "Requesting Refresh of Value: CommandClass: %s Instance %d, Index %d", CommandClasses::GetName(rcc->cc).c_str(), _value->GetID().GetInstance(), rcc->index);
+						if (Log::IsLevelEnabled(LogLevel_Debug))
+						{
+							Log::Write(LogLevel_Debug, GetNodeId(), "Requesting Refresh of Value: CommandClass: %s Instance %d, Index %d", CommandClasses::GetName(rcc->cc).c_str(), _value->GetID().GetInstance(), rcc->index);
+						}
 						if (CommandClass* cc = node->GetCommandClass(rcc->cc))
 						{
 							cc->RequestValue(rcc->requestflags, rcc->index, _value->GetID().GetInstance(), Driver::MsgQueue_Send);
@@ -820,7 +823,10 @@ namespace OpenZWave
 			{
 				if (m_com.GetFlagBool(COMPAT_FLAG_REFRESHONWAKEUP))
 				{
-					Log::Write(LogLevel_Debug, GetNodeId(), "Refreshing Dynamic Values on Wakeup for CommandClass %s", GetCommandClassName().c_str());
+					if (Log::IsLevelEnabled(LogLevel_Debug))
+					{
+						Log::Write(LogLevel_Debug, GetNodeId(), "Refreshing Dynamic Values on Wakeup for CommandClass %s", GetCommandClassName().c_str());
+					}
 					RequestStateForAllInstances(CommandClass::RequestFlag_Dynamic, Driver::MsgQueue_Send);
 				}
 			}
@@ -234,7 +234,10 @@ namespace OpenZWave
 
 					if (CommandClass* pCommandClass = node->GetCommandClass(commandClassId))
 					{
-						Log::Write(LogLevel_Info, GetNodeId(), "Received a MultiInstanceEncap from node %d, instance %d, for Command Class %s", GetNodeId(), instance, pCommandClass->GetCommandClassName().c_str());
+						if (Log::IsLevelEnabled(LogLevel_Info))
+						{
+							Log::Write(LogLevel_Info, GetNodeId(), "Received a MultiInstanceEncap from node %d, instance %d, for Command Class %s", GetNodeId(), instance, pCommandClass->GetCommandClassName().c_str());
+						}
 						pCommandClass->ReceivedCntIncr();
 						pCommandClass->HandleMsg(&_data[3], _length - 3, instance);
 					}
@@ -618,7 +621,10 @@ namespace OpenZWave
 						/* we can never have a 0 Instance */
 						if (instance == 0)
 							instance = 1;
-						Log::Write(LogLevel_Info, GetNodeId(), "Received a MultiChannelEncap from node %d, endpoint %d for Command Class %s", GetNodeId(), endPoint, pCommandClass->GetCommandClassName().c_str());
+						if (Log::IsLevelEnabled(LogLevel_Info))
+						{
+							Log::Write(LogLevel_Info, GetNodeId(), "Received a MultiChannelEncap from node %d, endpoint %d for Command Class %s", GetNodeId(), endPoint, pCommandClass->GetCommandClassName().c_str());
+						}
 						if (!pCommandClass->IsAfterMark()) 
 						{
 							if (!pCommandClass->HandleMsg(&_data[4], _length - 4, instance)) 
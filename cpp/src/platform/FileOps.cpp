@@ -96,6 +96,20 @@ namespace OpenZWave
 				return false;
 			}
 
+			/**
+			 * FileStatus. Get the modification time and size of a file.
+			 * \param string. file name.
+			 * \return Bool value indicating the file exists.
+			 */
+			bool FileOps::FileStatus(const string &_fileName, uint64 *_modified, uint64 *_size)
+			{
+				if (s_instance != NULL)
+				{
+					return s_instance->m_pImpl->FileStatus(_fileName, _modified, _size);
+				}
+				return false;
+			}
+
 			/**
 			 * FileWriteable. Check if we can write to a file.
 			 * \param string. file name.
@@ -140,6 +154,47 @@ namespace OpenZWave
 				return false;
 			}
 
+			/**
+			 * FileWriteAtomic. Replace the contents of a file atomically
+			 * \param string. file name.
+			 * \param string. new contents of the file
+			 * \return Bool value indicating success.
+			 */
+			bool FileOps::FileWriteAtomic(const string &_fileName, const string &_contents)
+			{
+
+				if (s_instance != NULL)
+				{
+					return s_instance->m_pImpl->FileWriteAtomic(_fileName, _contents);
+				}
+				return false;
+			}
+
+			/**
+			 * FileMap. Map a file into memory for reading
+			 * \param string. file name.
+			 * \return Bool value indicating success.
+			 */
+			bool FileOps::FileMap(const string &_fileName, char const **_data, uint64 *_size)
+			{
+				if (s_instance != NULL)
+				{
+					return s_instance->m_pImpl->FileMap(_fileName, _data, _size);
+				}
+				return false;
+			}
+
+			/**
+			 * FileUnmap. Release a file mapped by FileMap
+			 */
+			void FileOps::FileUnmap(char const *_data, uint64 _size)
+			{
+				if (s_instance != NULL && _data != NULL)
+				{
+					s_instance->m_pImpl->FileUnmap(_data, _size);
+				}
+			}
+
 			/**
 			 * FolderCreate. Create a Folder
 			 * \param string. folder name
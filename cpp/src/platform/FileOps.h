@@ -73,6 +73,15 @@ namespace OpenZWave
 					 */
 					static bool FileExists(const string &_fileName);
 
+					/**
+					 * FileStatus. Get the modification time and size of a file.
+					 * \param string. file name.
+					 * \param _modified. Set to the modification time, in a platform specific unit.
+					 * \param _size. Set to the size of the file in bytes.
+					 * \return Bool value indicating the file exists.
+					 */
+					static bool FileStatus(const string &_fileName, uint64 *_modified, uint64 *_size);
+
 					/**
 					 * FileWriteable. Check if we can write to a file.
 					 * \param string. file name.
@@ -95,6 +104,34 @@ namespace OpenZWave
 					 */
 					static bool FileCopy(const string &_fileName, const string &_destinationfile);
 
+					/**
+					 * FileWriteAtomic. Replace the contents of a file so that readers, and
+					 * the file after a crash, see either the old or the new contents.
+					 * Each call writes through its own temporary file, so concurrent
+					 * writers of the same file do not corrupt each other.
+					 * \param string. file name.
+					 * \param string. new contents of the file.
+					 * \return Bool value indicating success.
+					 */
+					static bool FileWriteAtomic(const string &_fileName, const string &_contents);
+
+					/**
+					 * FileMap. Map a file into memory, to read it without a copy.
+					 * \param string. file name.
+					 * \param _data. Set to the contents of the file, or NULL if it is empty.
+					 * \param _size. Set to the size of the file in bytes.
+					 * \return Bool value indicating success.
+					 * \see FileUnmap.
+					 */
+					static bool FileMap(const string &_fileName, char const **_data, uint64 *_size);
+
+					/**
+					 * FileUnmap. Release a file mapped by FileMap.
+					 * \param _data. The contents returned by FileMap.
+					 * \param _size. The size returned by FileMap.
+					 */
+					static void FileUnmap(char const *_data, uint64 _size);
+
 					/**
 					 * FolderCreate. Create a Folder
 					 * \param string. folder name
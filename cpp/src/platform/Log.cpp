@@ -26,6 +26,7 @@
 //
 //-----------------------------------------------------------------------------
 #include <stdarg.h>
+#include <thread>
 
 #include "Defs.h"
 #include "platform/Mutex.h"
@@ -59,7 +60,22 @@ char const *OpenZWave::LogLevelString[] =
 
 Log* Log::s_instance = NULL;
 std::vector<i_LogImpl*> Log::m_pImpls;
-static bool s_dologging;
+bool Log::s_dologging = false;
+LogLevel Log::s_maxLevel = LogLevel_Internal;
+
+//-----------------------------------------------------------------------------
+//	<MaxLogLevel>
+//	The least severe of the levels that cause a message to be saved, queued or dumped
+//-----------------------------------------------------------------------------
+static LogLevel MaxLogLevel(LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger)
+{
+	LogLevel level = _saveLevel;
+	if (_queueLevel > level)
+		level = _queueLevel;
+	if (_dumpTrigger > level)
+		level = _dumpTrigger;
+	return level;
+}
 
 //-----------------------------------------------------------------------------
 //	<Log::Create>
@@ -78,6 +94,7 @@ Log* Log::Create(string const& _filename, bool const _bAppend, bool const _bCons
 		s_instance = new Log(_filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger);
 		s_dologging = true; // default logging to true so no change to what people experience now
 	}
+	s_maxLevel = MaxLogLevel(_saveLevel, _queueLevel, _dumpTrigger);
 
 	return s_instance;
 }
@@ -119,6 +136,10 @@ void Log::Destroy()
 //-----------------------------------------------------------------------------
 bool Log::SetLoggingClass(i_LogImpl *LogClass, bool Append)
 {
+	// Custom logging classes are not lock-free, so Write must serialize access again.
+	// The old loggers can only be deleted once no writer is still using them.
+	s_instance->m_logMutex->Lock();
+	s_instance->StopLockFree();
 	if (!Append) {
 		for (std::vector<i_LogImpl*>::iterator it = s_instance->m_pImpls.begin(); it != s_instance->m_pImpls.end();) {
 			i_LogImpl *lc = *it;
@@ -127,9 +148,42 @@ bool Log::SetLoggingClass(i_LogImpl *LogClass, bool Append)
 		}
 	}
 	s_instance->m_pImpls.push_back(LogClass);
+	s_instance->m_logMutex->Unlock();
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::StopLockFree>
+//	Send every new Write through m_logMutex and wait for the lock-free ones
+//	still in progress.  The caller holds m_logMutex.
+//-----------------------------------------------------------------------------
+void Log::StopLockFree()
+{
+	// Write counts itself in before it looks at m_lockFree, so once the flag
+	// is clear and the count has reached zero no writer can be left behind
+	m_lockFree = false;
+	while (m_lockFreeWriters != 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::ResumeLockFree>
+//	Let Write skip m_logMutex again if the only logger is the asynchronous
+//	built-in one.  The caller holds m_logMutex.
+//-----------------------------------------------------------------------------
+void Log::ResumeLockFree()
+{
+#if !defined WIN32 && !defined WINRT
+	if (m_pImpls.size() == 1)
+	{
+		Internal::Platform::LogImpl* impl = dynamic_cast<Internal::Platform::LogImpl*>(m_pImpls[0]);
+		m_lockFree = (impl != NULL) && impl->IsAsync();
+	}
+#endif
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::SetLoggingState>
 //	Set flag to actually write to log or skip it (legacy version)
@@ -164,6 +218,7 @@ void Log::SetLoggingState(LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _d
 		Log::Write(LogLevel_Warning, "The trigger for dumping queued messages must be a higher-priority message than the level that is queued.");
 
 	bool prevLogging = s_dologging;
+	s_maxLevel = MaxLogLevel(_saveLevel, _queueLevel, _dumpTrigger);
 	// s_dologging is true if any messages are to be saved in file or queue
 	if ((_saveLevel > LogLevel_Always) || (_queueLevel > LogLevel_Always))
 	{
@@ -174,11 +229,14 @@ void Log::SetLoggingState(LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _d
 		s_dologging = false;
 	}
 
-	if (s_instance && s_dologging && (s_instance->m_pImpls.size() > 0))
+	if (s_instance && s_dologging)
 	{
+		// Lock-free writers read the levels without m_logMutex
 		s_instance->m_logMutex->Lock();
+		s_instance->StopLockFree();
 		for (std::vector<i_LogImpl*>::iterator it = s_instance->m_pImpls.begin(); it != s_instance->m_pImpls.end(); it++)
 			(*it)->SetLoggingState(_saveLevel, _queueLevel, _dumpTrigger);
+		s_instance->ResumeLockFree();
 		s_instance->m_logMutex->Unlock();
 	}
 
@@ -201,8 +259,19 @@ bool Log::GetLoggingState()
 //-----------------------------------------------------------------------------
 void Log::Write(LogLevel _level, char const* _format, ...)
 {
-	if (s_instance && s_dologging && (s_instance->m_pImpls.size() > 0))
+	if (IsLevelEnabled(_level))
 	{
+		++s_instance->m_lockFreeWriters;
+		if (s_instance->m_lockFree)
+		{
+			va_list args;
+			va_start(args, _format);
+			s_instance->m_pImpls[0]->Write(_level, 0, _format, args);
+			va_end(args);
+			--s_instance->m_lockFreeWriters;
+			return;
+		}
+		--s_instance->m_lockFreeWriters;
 		s_instance->m_logMutex->Lock(); // double locks if recursive
 		va_list args;
 		va_start(args, _format);
@@ -219,8 +288,19 @@ void Log::Write(LogLevel _level, char const* _format, ...)
 //-----------------------------------------------------------------------------
 void Log::Write(LogLevel _level, uint8 const _nodeId, char const* _format, ...)
 {
-	if (s_instance && s_dologging && (s_instance->m_pImpls.size() > 0))
+	if (IsLevelEnabled(_level))
 	{
+		++s_instance->m_lockFreeWriters;
+		if (s_instance->m_lockFree)
+		{
+			va_list args;
+			va_start(args, _format);
+			s_instance->m_pImpls[0]->Write(_level, _nodeId, _format, args);
+			va_end(args);
+			--s_instance->m_lockFreeWriters;
+			return;
+		}
+		--s_instance->m_lockFreeWriters;
 		if (_level != LogLevel_Internal)
 			s_instance->m_logMutex->Lock();
 		va_list args;
@@ -263,6 +343,52 @@ void Log::QueueClear()
 	}
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::SetAsyncLogging>
+//	Move formatting and file output of the built-in logger onto a writer thread
+//-----------------------------------------------------------------------------
+bool Log::SetAsyncLogging(bool _async)
+{
+#if defined WIN32 || defined WINRT
+	return !_async;
+#else
+	if (!s_instance || (s_instance->m_pImpls.size() != 1))
+		return false;
+
+	Internal::Platform::LogImpl* impl = dynamic_cast<Internal::Platform::LogImpl*>(s_instance->m_pImpls[0]);
+	if (!impl)
+		return false;
+
+	s_instance->m_logMutex->Lock();
+	s_instance->StopLockFree();
+	bool res = impl->SetAsync(_async);
+	s_instance->ResumeLockFree();
+	s_instance->m_logMutex->Unlock();
+	return res;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::GetAsyncStatistics>
+//	Report the dropped-record and queue-depth counters of the async logger
+//-----------------------------------------------------------------------------
+bool Log::GetAsyncStatistics(AsyncStatistics* _data)
+{
+#if defined WIN32 || defined WINRT
+	return false;
+#else
+	if (!s_instance || !_data || (s_instance->m_pImpls.size() == 0))
+		return false;
+
+	Internal::Platform::LogImpl* impl = dynamic_cast<Internal::Platform::LogImpl*>(s_instance->m_pImpls[0]);
+	if (!impl || !impl->IsAsync())
+		return false;
+
+	impl->GetAsyncStatistics(_data);
+	return true;
+#endif
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::SetLogFileName>
 //	Change the name of the log file (will start writing a new file)
@@ -283,7 +409,7 @@ void Log::SetLogFileName(const string &_filename)
 //	Constructor
 //-----------------------------------------------------------------------------
 Log::Log(string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger) :
-		m_logMutex(new Internal::Platform::Mutex())
+		m_logMutex(new Internal::Platform::Mutex()), m_lockFree(false), m_lockFreeWriters(0)
 {
 	if (m_pImpls.size() == 0)
 	{
@@ -297,6 +423,9 @@ Log::Log(string const& _filename, bool const _bAppend, bool const _bConsoleOutpu
 //-----------------------------------------------------------------------------
 Log::~Log()
 {
+	m_logMutex->Lock();
+	StopLockFree();
+	m_logMutex->Unlock();
 	m_logMutex->Release();
 	for (std::vector<i_LogImpl*>::iterator it = s_instance->m_pImpls.begin(); it != s_instance->m_pImpls.end();) {
 		i_LogImpl *lc = *it;
@@ -29,6 +29,7 @@
 #define _Log_H
 
 #include <stdarg.h>
+#include <atomic>
 #include <string>
 #include <vector>
 #include "Defs.h"
@@ -96,6 +97,19 @@ namespace OpenZWave
 	class OPENZWAVE_EXPORT Log
 	{
 		public:
+			/** \brief Counters for the asynchronous logging pipeline
+			 *
+			 * \see GetAsyncStatistics, SetAsyncLogging
+			 */
+			struct AsyncStatistics
+			{
+					uint64 m_records;		/**< Number of records handed to the writer thread */
+					uint64 m_dropped;		/**< Number of records dropped because a thread's queue was full */
+					uint32 m_queueDepth;	/**< Number of records currently waiting to be written */
+					uint32 m_queueDepthMax;	/**< Highest queue depth seen by the writer thread */
+					uint32 m_producers;		/**< Number of threads with a log queue */
+			};
+
 			/** \brief Create a log.
 			 *
 			 * Creates the cross-platform logging singleton.
@@ -194,10 +208,46 @@ namespace OpenZWave
 			 */
 			static void Write(LogLevel _level, uint8 const _nodeId, char const* _format, ...);
 
+			/**\brief Test whether a message of the given level would be logged at all.
+			 *
+			 * Write already discards messages that are above the save, queue and dump trigger levels,
+			 * but only after its arguments have been evaluated.  Wrap calls whose arguments are
+			 * expensive to build (hex dumps, GetAsString() and the like) in this check so that
+			 * disabled levels cost nothing.
+			 * \param _level	The level the message would be written at
+			 * \return true if Write would pass the message on to the logging class
+			 * \see Write, SetLoggingState
+			 */
+			static bool IsLevelEnabled(LogLevel _level)
+			{
+				return (s_instance != NULL) && s_dologging && ((_level <= s_maxLevel) || (_level == LogLevel_Internal));
+			}
+
 			/** \brief Send the queued log messages to the log output.
 			 */
 			static void QueueDump();
 
+			/**\brief Enable or disable asynchronous logging.
+			 *
+			 * In asynchronous mode Write does not take the log mutex or touch the disk. Each calling
+			 * thread formats its message into a private lock-free queue and a dedicated writer thread
+			 * adds the timestamp and level prefixes and writes the output in large batches. Messages
+			 * are dropped (and counted) rather than blocking the caller if a queue is full.
+			 * Only the built-in file/console logger supports this mode, and only on Unix platforms.
+			 * \param _async true to start the writer thread, false to go back to writing on the caller's thread
+			 * \return true if the requested mode is now active
+			 * \see GetAsyncStatistics
+			 */
+			static bool SetAsyncLogging(bool _async);
+
+			/**\brief Retrieve the asynchronous logging counters.
+			 *
+			 * \param _data Pointer to a structure that receives the counters
+			 * \return false if asynchronous logging is not active
+			 * \see SetAsyncLogging
+			 */
+			static bool GetAsyncStatistics(AsyncStatistics* _data);
+
 			/**
 			 * Clear the log message queue
 			 */
@@ -209,7 +259,14 @@ namespace OpenZWave
 
 			static std::vector<i_LogImpl*> m_pImpls; /**< Pointer to an object that encapsulates the platform-specific logging implementation. */
 			static Log* s_instance;
+			static bool s_dologging; /**< true if any messages are to be saved in file or queue */
+			static LogLevel s_maxLevel; /**< least severe level any of the save, queue or dump trigger levels act on */
+			void StopLockFree();
+			void ResumeLockFree();
+
 			Internal::Platform::Mutex* m_logMutex;
+			std::atomic<bool> m_lockFree; /**< true when the only logger is the built-in one running asynchronously */
+			std::atomic<uint32> m_lockFreeWriters; /**< calls to Write currently inside the lock-free path */
 	};
 } // namespace OpenZWave
 
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "Defs.h"
 
 namespace OpenZWave
@@ -60,6 +62,20 @@ namespace OpenZWave
 						m_refs = 1;
 					}
 
+					/**
+					 * Copies the RefCount along with the object, as a plain integer member would be copied.
+					 */
+					Ref(Ref const& _other) :
+							m_refs(_other.m_refs.load())
+					{
+					}
+
+					Ref& operator =(Ref const& _other)
+					{
+						m_refs = _other.m_refs.load();
+						return *this;
+					}
+
 					/**
 					 * Increases the reference count of the object.
 					 * Every call to AddRef requires a matching call
@@ -79,12 +95,13 @@ namespace OpenZWave
 					 */
 					int32 Release()
 					{
-						if (0 >= (--m_refs))
+						int32 refs = --m_refs;
+						if (0 >= refs)
 						{
 							delete this;
 							return 0;
 						}
-						return m_refs;
+						return refs;
 					}
 
 				protected:
@@ -93,8 +110,8 @@ namespace OpenZWave
 					}
 
 				private:
-					// Reference counting
-					int32 m_refs;
+					// Reference counting.  Atomic, as readers sharing the node lock take references concurrently
+					std::atomic<int32> m_refs;
 
 			};
 		// class Ref
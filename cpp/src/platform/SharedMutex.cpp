@@ -0,0 +1,257 @@
+//-----------------------------------------------------------------------------
+//
+//	SharedMutex.cpp
+//
+//	Cross-platform reader/writer lock
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include "Defs.h"
+#include "platform/SharedMutex.h"
+#include "platform/Log.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			// Shared locks held by the current thread, per lock.  Kept per thread so that
+			// readers do not have to touch any shared state to find out if they are nesting.
+			static thread_local std::vector<std::pair<SharedMutex const*, uint32> > t_readLocks;
+
+			static std::pair<SharedMutex const*, uint32>* FindReadLock(SharedMutex const* _mutex)
+			{
+				for (std::vector<std::pair<SharedMutex const*, uint32> >::iterator it = t_readLocks.begin(); it != t_readLocks.end(); ++it)
+				{
+					if (it->first == _mutex)
+					{
+						return &(*it);
+					}
+				}
+				return NULL;
+			}
+
+			struct SharedMutex::State
+			{
+					State() :
+							m_writerActive(false), m_readers(0), m_writeDepth(0), m_writerQueued(false)
+					{
+					}
+
+					// Readers only take m_mutex when a writer is active or waiting
+					std::mutex m_mutex;
+					std::condition_variable m_cond;
+					std::atomic<bool> m_writerActive;			// Set while a writer holds the lock or is waiting for the readers to leave
+					std::atomic<uint32> m_readers;				// Total number of shared locks held
+					std::atomic<std::thread::id> m_writer;		// Thread holding the exclusive lock
+					uint32 m_writeDepth;						// Nesting depth of the exclusive lock.  Only used by the writer.
+					bool m_writerQueued;						// A thread without shared locks is waiting for, or holds, the exclusive lock
+					std::thread::id m_upgrader;					// A thread with shared locks is waiting for, or holds, the exclusive lock
+			};
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::SharedMutex>
+//	Constructor
+//-----------------------------------------------------------------------------
+			SharedMutex::SharedMutex() :
+					m_state(new State())
+			{
+			}
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::~SharedMutex>
+//	Destructor
+//-----------------------------------------------------------------------------
+			SharedMutex::~SharedMutex()
+			{
+				delete m_state;
+			}
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::Lock>
+//	Take the lock exclusively
+//-----------------------------------------------------------------------------
+			void SharedMutex::Lock()
+			{
+				std::thread::id self = std::this_thread::get_id();
+				if (m_state->m_writer.load() == self)
+				{
+					m_state->m_writeDepth++;
+					return;
+				}
+
+				// Our own shared locks do not keep us out
+				std::pair<SharedMutex const*, uint32>* own = FindReadLock(this);
+				uint32 ownReaders = own ? own->second : 0;
+
+				std::unique_lock<std::mutex> lock(m_state->m_mutex);
+				if (ownReaders && (m_state->m_upgrader != std::thread::id()))
+				{
+					// Another reader is upgrading too, and each would wait for the other's shared
+					// locks forever.  Give ours up until we have the lock, so the other can finish.
+					Log::Write(LogLevel_Error, "SharedMutex: two threads are upgrading a shared lock at the same time, so one of them has to give up its shared lock while it waits");
+					m_state->m_readers -= ownReaders;
+					m_state->m_cond.notify_all();
+				}
+				else if (ownReaders)
+				{
+					// We are upgrading.  Any writer that is already waiting also waits for our shared
+					// locks to go, so we go first and only wait for the other readers to leave.
+					m_state->m_upgrader = self;
+					m_state->m_writerActive.store(true);
+					while (m_state->m_readers.load() != ownReaders)
+					{
+						m_state->m_cond.wait(lock);
+					}
+					m_state->m_writer.store(self);
+					m_state->m_writeDepth = 1;
+					return;
+				}
+
+				while (m_state->m_writerQueued)
+				{
+					m_state->m_cond.wait(lock);
+				}
+				// Stop new readers, then wait for the current ones, and an upgrader that got in
+				// ahead of us, to leave
+				m_state->m_writerQueued = true;
+				m_state->m_writerActive.store(true);
+				while ((m_state->m_readers.load() != 0) || (m_state->m_writer.load() != std::thread::id()))
+				{
+					m_state->m_cond.wait(lock);
+				}
+				m_state->m_readers += ownReaders;
+				m_state->m_writer.store(self);
+				m_state->m_writeDepth = 1;
+			}
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::Unlock>
+//	Release an exclusive lock
+//-----------------------------------------------------------------------------
+			void SharedMutex::Unlock()
+			{
+				if (m_state->m_writer.load() != std::this_thread::get_id())
+				{
+					return;
+				}
+				if (--m_state->m_writeDepth == 0)
+				{
+					std::lock_guard<std::mutex> lock(m_state->m_mutex);
+					m_state->m_writer.store(std::thread::id());
+					if (m_state->m_upgrader == std::this_thread::get_id())
+					{
+						m_state->m_upgrader = std::thread::id();
+					}
+					else
+					{
+						m_state->m_writerQueued = false;
+					}
+					// A writer may still be waiting behind an upgrader
+					m_state->m_writerActive.store(m_state->m_writerQueued || (m_state->m_upgrader != std::thread::id()));
+					m_state->m_cond.notify_all();
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::LockShared>
+//	Take the lock shared
+//-----------------------------------------------------------------------------
+			void SharedMutex::LockShared()
+			{
+				if (m_state->m_writer.load() == std::this_thread::get_id())
+				{
+					// Already exclusive, so just nest
+					m_state->m_writeDepth++;
+					return;
+				}
+
+				if (std::pair<SharedMutex const*, uint32>* own = FindReadLock(this))
+				{
+					// A nested shared lock must not wait for writers, or it would deadlock with them
+					own->second++;
+					m_state->m_readers++;
+					return;
+				}
+
+				// Fast path: announce ourselves, then make sure no writer got in first
+				m_state->m_readers++;
+				if (m_state->m_writerActive.load())
+				{
+					std::unique_lock<std::mutex> lock(m_state->m_mutex);
+					m_state->m_readers--;
+					m_state->m_cond.notify_all();
+					while (m_state->m_writerActive.load())
+					{
+						m_state->m_cond.wait(lock);
+					}
+					m_state->m_readers++;
+				}
+				t_readLocks.push_back(std::make_pair((SharedMutex const*) this, (uint32) 1));
+			}
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::UnlockShared>
+//	Release a shared lock
+//-----------------------------------------------------------------------------
+			void SharedMutex::UnlockShared()
+			{
+				if (m_state->m_writer.load() == std::this_thread::get_id())
+				{
+					Unlock();
+					return;
+				}
+
+				std::pair<SharedMutex const*, uint32>* own = FindReadLock(this);
+				if (!own)
+				{
+					return;
+				}
+				if (--own->second == 0)
+				{
+					*own = t_readLocks.back();
+					t_readLocks.pop_back();
+				}
+				m_state->m_readers--;
+				if (m_state->m_writerActive.load())
+				{
+					// A writer is waiting for the readers to leave
+					std::lock_guard<std::mutex> lock(m_state->m_mutex);
+					m_state->m_cond.notify_all();
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<SharedMutex::IsLocked>
+//	Test whether any thread holds the lock
+//-----------------------------------------------------------------------------
+			bool SharedMutex::IsLocked() const
+			{
+				return m_state->m_readers.load() > 0 || m_state->m_writer.load() != std::thread::id();
+			}
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,103 @@
+//-----------------------------------------------------------------------------
+//
+//	SharedMutex.h
+//
+//	Cross-platform reader/writer lock
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _SharedMutex_H
+#define _SharedMutex_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			/** \brief Implements a platform-independent reader/writer lock.
+			 *
+			 * Any number of threads can hold the lock shared, as long as no thread holds it
+			 * exclusively.  Both modes are recursive, and a thread holding the lock
+			 * exclusively can also take it shared.  A thread that holds the lock shared can
+			 * take it exclusively once the other readers have left, ahead of any writer that
+			 * is already waiting.  If two threads upgrade at the same time, the second gives
+			 * up its shared lock until it has the exclusive one, so what it read may have
+			 * changed; read paths should not call code that needs the exclusive lock.
+			 * Waiting writers are preferred over new readers.
+			 * \ingroup Platform
+			 */
+			class SharedMutex
+			{
+				public:
+					/**
+					 * Constructor.
+					 */
+					SharedMutex();
+
+					/**
+					 * Destructor.
+					 */
+					~SharedMutex();
+
+					/**
+					 * Take the lock exclusively.
+					 * There must be a matching call to Unlock for every call to Lock.
+					 * \see Unlock
+					 */
+					void Lock();
+
+					/**
+					 * Release an exclusive lock.
+					 * \see Lock
+					 */
+					void Unlock();
+
+					/**
+					 * Take the lock shared.
+					 * There must be a matching call to UnlockShared for every call to LockShared.
+					 * \see UnlockShared
+					 */
+					void LockShared();
+
+					/**
+					 * Release a shared lock.
+					 * \see LockShared
+					 */
+					void UnlockShared();
+
+					/**
+					 * Test whether any thread holds the lock, in either mode.
+					 */
+					bool IsLocked() const;
+
+				private:
+					SharedMutex(SharedMutex const&);					// prevent copy
+					SharedMutex& operator =(SharedMutex const&);		// prevent assignment
+
+					struct State;
+					State* m_state;
+			};
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_SharedMutex_H
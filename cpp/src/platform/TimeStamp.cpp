@@ -26,6 +26,7 @@
 //
 //-----------------------------------------------------------------------------
 #include <string>
+#include <chrono>
 #include "Defs.h"
 #include "platform/TimeStamp.h"
 
@@ -98,6 +99,24 @@ namespace OpenZWave
 			{
 				return (int32) (m_pImpl - _other.m_pImpl);
 			}
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::GetMonotonicTime>
+//	Milliseconds on a clock that never jumps
+//-----------------------------------------------------------------------------
+			uint64 TimeStamp::GetMonotonicTime()
+			{
+				return (uint64) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::GetMonotonicTimeUs>
+//	Microseconds on a clock that never jumps
+//-----------------------------------------------------------------------------
+			uint64 TimeStamp::GetMonotonicTimeUs()
+			{
+				return (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
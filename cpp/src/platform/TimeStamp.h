@@ -83,6 +83,20 @@ namespace OpenZWave
 					 */
 					int32 operator-(TimeStamp const& _other);
 
+					/**
+					 * Milliseconds on a monotonic clock.  Unlike the wall clock used by
+					 * TimeStamp objects this never jumps, so it is safe for scheduling and
+					 * for measuring intervals.  The starting point is unspecified.
+					 * \return the current monotonic time in milliseconds
+					 */
+					static uint64 GetMonotonicTime();
+
+					/**
+					 * The monotonic clock of GetMonotonicTime, in microseconds.
+					 * \return the current monotonic time in microseconds
+					 */
+					static uint64 GetMonotonicTimeUs();
+
 				private:
 					TimeStamp(TimeStamp const&);				// prevent copy
 					TimeStamp& operator =(TimeStamp const&);	// prevent assignment
@@ -0,0 +1,116 @@
+//-----------------------------------------------------------------------------
+//
+//	VirtualController.cpp
+//
+//	Controller backed by a simulated Z-Wave network
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "Defs.h"
+#include "platform/Log.h"
+#include "platform/VirtualController.h"
+#include "platform/VirtualNetwork.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+
+//-----------------------------------------------------------------------------
+//	<VirtualController::VirtualController>
+//	Constructor
+//-----------------------------------------------------------------------------
+			VirtualController::VirtualController() :
+					m_network(NULL)
+			{
+			}
+
+//-----------------------------------------------------------------------------
+//	<VirtualController::~VirtualController>
+//	Destructor
+//-----------------------------------------------------------------------------
+			VirtualController::~VirtualController()
+			{
+				Close();
+			}
+
+//-----------------------------------------------------------------------------
+//	<VirtualController::Open>
+//	Create the simulated network
+//-----------------------------------------------------------------------------
+			bool VirtualController::Open(string const& _controllerName)
+			{
+				if (m_network)
+				{
+					Log::Write(LogLevel_Error, "ERROR: Virtual controller %s is already open", _controllerName.c_str());
+					return false;
+				}
+
+				m_network = new VirtualNetwork(_controllerName, VirtualController::Output, this);
+				Log::Write(LogLevel_Info, "Opened virtual controller %s", _controllerName.c_str());
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+//	<VirtualController::Close>
+//	Destroy the simulated network
+//-----------------------------------------------------------------------------
+			bool VirtualController::Close()
+			{
+				if (!m_network)
+				{
+					return false;
+				}
+
+				delete m_network;
+				m_network = NULL;
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+//	<VirtualController::Write>
+//	Pass data to the simulated controller
+//-----------------------------------------------------------------------------
+			uint32 VirtualController::Write(uint8* _buffer, uint32 _length)
+			{
+				if (!m_network)
+				{
+					Log::Write(LogLevel_Error, "ERROR: Virtual controller must be opened before writing");
+					return 0;
+				}
+
+				m_network->Receive(_buffer, _length);
+				return _length;
+			}
+
+//-----------------------------------------------------------------------------
+//	<VirtualController::Output>
+//	Data from the simulated controller goes into the input stream
+//-----------------------------------------------------------------------------
+			void VirtualController::Output(uint8 const* _data, uint32 _length, void* _context)
+			{
+				VirtualController* controller = (VirtualController*) _context;
+				controller->Put(const_cast<uint8*>(_data), _length);
+			}
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
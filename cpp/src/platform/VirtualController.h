@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+//
+//	VirtualController.h
+//
+//	Controller backed by a simulated Z-Wave network
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _VirtualController_H
+#define _VirtualController_H
+
+#include <string>
+#include "Defs.h"
+#include "platform/Controller.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class VirtualNetwork;
+
+			/** \brief Controller that talks to a VirtualNetwork in the same process instead of a device.
+			 * \ingroup Platform
+			 *
+			 * Useful for testing and benchmarking without hardware.  The controller path
+			 * describes the network, for example "virtual:nodes=50,latency=20".
+			 * \see VirtualNetwork
+			 */
+			class VirtualController: public Controller
+			{
+				public:
+					VirtualController();
+					virtual ~VirtualController();
+
+					/**
+					 * Create the simulated network.
+					 * @param _controllerName description of the network.  See VirtualNetwork.
+					 * @return True if the network was created.
+					 */
+					bool Open(string const& _controllerName);
+
+					/**
+					 * Destroy the simulated network.
+					 * @return True if the network was open.
+					 */
+					bool Close();
+
+					/**
+					 * Pass data to the simulated controller.
+					 * @return The number of bytes written.
+					 */
+					uint32 Write(uint8* _buffer, uint32 _length);
+
+				private:
+					static void Output(uint8 const* _data, uint32 _length, void* _context);
+
+					VirtualNetwork* m_network;
+			};
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_VirtualController_H
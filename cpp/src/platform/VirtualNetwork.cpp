@@ -0,0 +1,1009 @@
+//-----------------------------------------------------------------------------
+//
+//	VirtualNetwork.cpp
+//
+//	Simulated Z-Wave controller and nodes, speaking the Serial API
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined WIN32 && !defined WINRT
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#include "Utils.h"
+#include "platform/Event.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+#include "platform/VirtualNetwork.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			namespace
+			{
+				// Command classes the simulated nodes answer
+				enum
+				{
+					Class_NoOperation = 0x00,
+					Class_Basic = 0x20,
+					Class_SwitchBinary = 0x25,
+					Class_SwitchMultilevel = 0x26,
+					Class_SwitchAll = 0x27,
+					Class_SensorMultilevel = 0x31,
+					Class_ManufacturerSpecific = 0x72,
+					Class_Association = 0x85,
+					Class_Version = 0x86
+				};
+
+				// Generic device classes of the simulated nodes
+				uint8 const c_genericStaticController = 0x02;
+				uint8 const c_genericSwitchBinary = 0x10;
+				uint8 const c_genericSwitchMultilevel = 0x11;
+				uint8 const c_genericSensorMultilevel = 0x21;
+
+				uint8 const c_maxNodeId = NUM_NODE_BITFIELD_BYTES * 8;
+				uint8 const c_controllerNodeId = 1;
+				uint8 const c_maxAssociations = 5;
+
+				// The controller is the SIS and a static update controller
+				uint8 const c_controllerCaps = 0x04 | 0x10;
+				uint8 const c_initCaps = 0x08;
+
+				// Functions the simulated controller implements, advertised in SERIAL_API_GET_CAPABILITIES
+				uint8 const c_functions[] =
+				{ FUNC_ID_SERIAL_API_GET_INIT_DATA, FUNC_ID_SERIAL_API_APPL_NODE_INFORMATION, FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES, FUNC_ID_SERIAL_API_SET_TIMEOUTS, FUNC_ID_SERIAL_API_GET_CAPABILITIES, FUNC_ID_ZW_SEND_DATA, FUNC_ID_ZW_SEND_DATA_MULTI, FUNC_ID_ZW_GET_VERSION, FUNC_ID_ZW_MEMORY_GET_ID, FUNC_ID_ZW_GET_NODE_PROTOCOL_INFO, FUNC_ID_ZW_GET_SUC_NODE_ID, FUNC_ID_ZW_REQUEST_NODE_INFO, FUNC_ID_ZW_GET_ROUTING_INFO };
+
+				void BuildFrame(uint8 const _type, uint8 const _function, uint8 const* _data, uint32 const _length, vector<uint8>* o_frame)
+				{
+					o_frame->clear();
+					o_frame->push_back(SOF);
+					o_frame->push_back((uint8) (_length + 3));
+					o_frame->push_back(_type);
+					o_frame->push_back(_function);
+					o_frame->insert(o_frame->end(), _data, _data + _length);
+
+					uint8 checksum = 0xff;
+					for (uint32 i = 1; i < o_frame->size(); ++i)
+					{
+						checksum ^= (*o_frame)[i];
+					}
+					o_frame->push_back(checksum);
+				}
+
+				bool SupportsClass(uint8 const _generic, uint8 const _class)
+				{
+					switch (_class)
+					{
+						case Class_Basic:
+						case Class_ManufacturerSpecific:
+						case Class_Association:
+						case Class_Version:
+							return true;
+						case Class_SwitchBinary:
+							return _generic == c_genericSwitchBinary;
+						case Class_SwitchMultilevel:
+							return _generic == c_genericSwitchMultilevel;
+						case Class_SwitchAll:
+							return (_generic == c_genericSwitchBinary) || (_generic == c_genericSwitchMultilevel);
+						case Class_SensorMultilevel:
+							return _generic == c_genericSensorMultilevel;
+					}
+					return false;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::VirtualNetwork>
+// Constructor
+//-----------------------------------------------------------------------------
+			VirtualNetwork::VirtualNetwork(string const& _parameters, pfnOutput_t _output, void* _context) :
+					m_output(_output), m_context(_context), m_thread(new Thread("virtualnetwork")), m_ptyThread(NULL), m_mutex(new Mutex()), m_queueEvent(new Event()), m_pty(-1), m_homeId(0xc0ffee00), m_jitter(0), m_nak(0), m_can(0), m_random(1), m_received(0), m_sent(0), m_trace(false), m_nodes(256)
+			{
+				ParseParameters(_parameters);
+				m_thread->Start(VirtualNetwork::ThreadEntryPoint, this);
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::~VirtualNetwork>
+// Destructor
+//-----------------------------------------------------------------------------
+			VirtualNetwork::~VirtualNetwork()
+			{
+				if (m_ptyThread)
+				{
+					m_ptyThread->Stop();
+					m_ptyThread->Release();
+				}
+				m_thread->Stop();
+				m_thread->Release();
+
+#if !defined WIN32 && !defined WINRT
+				if (m_pty >= 0)
+				{
+					close(m_pty);
+				}
+#endif
+				m_queueEvent->Release();
+				m_mutex->Release();
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::ParseParameters>
+// Build the network from its description
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::ParseParameters(string const& _parameters)
+			{
+				uint32 nodes = 10;
+				uint32 latency = 0;
+				uint32 loss = 0;
+				uint32 reply = 0;
+				map<uint32, uint32> nodeLatency;
+				map<uint32, uint32> nodeLoss;
+				map<uint32, uint32> nodeReply;
+
+				size_t pos = _parameters.find(':');
+				pos = (pos == string::npos) ? 0 : pos + 1;
+				while (pos < _parameters.size())
+				{
+					size_t end = _parameters.find_first_of(",; ", pos);
+					if (end == string::npos)
+					{
+						end = _parameters.size();
+					}
+					string item = _parameters.substr(pos, end - pos);
+					pos = end + 1;
+
+					size_t equals = item.find('=');
+					if (equals == string::npos)
+					{
+						continue;
+					}
+					string key = ToLower(item.substr(0, equals));
+					uint32 value = (uint32) strtoul(item.c_str() + equals + 1, NULL, (key == "homeid") ? 16 : 10);
+
+					uint32 nodeId = 0;
+					size_t dot = key.find('.');
+					if (dot != string::npos)
+					{
+						nodeId = (uint32) strtoul(key.c_str() + dot + 1, NULL, 10);
+						key = key.substr(0, dot);
+					}
+
+					if (nodeId != 0 && key == "latency")
+						nodeLatency[nodeId] = value;
+					else if (nodeId != 0 && key == "loss")
+						nodeLoss[nodeId] = value;
+					else if (nodeId != 0 && key == "reply")
+						nodeReply[nodeId] = value;
+					else if (key == "nodes")
+						nodes = value;
+					else if (key == "latency")
+						latency = value;
+					else if (key == "loss")
+						loss = value;
+					else if (key == "reply")
+						reply = value;
+					else if (key == "jitter")
+						m_jitter = value;
+					else if (key == "nak")
+						m_nak = value;
+					else if (key == "can")
+						m_can = value;
+					else if (key == "homeid")
+						m_homeId = value;
+					else if (key == "seed")
+						m_random = value ? value : 1;
+					else if (key == "trace")
+						m_trace = (value != 0);
+					else
+						Log::Write(LogLevel_Warning, "Virtual network: ignoring unknown parameter %s", item.c_str());
+				}
+
+				if (nodes > (uint32) (c_maxNodeId - 1))
+				{
+					nodes = c_maxNodeId - 1;
+				}
+
+				static uint8 const generics[] =
+				{ c_genericSwitchBinary, c_genericSwitchMultilevel, c_genericSensorMultilevel };
+				for (uint32 nodeId = c_controllerNodeId; nodeId <= nodes + 1; ++nodeId)
+				{
+					SimulatedNode& node = m_nodes[nodeId];
+					node.m_generic = (nodeId == c_controllerNodeId) ? c_genericStaticController : generics[(nodeId - 2) % 3];
+					node.m_level = 0;
+					node.m_sensorStep = 0;
+					node.m_latency = nodeLatency.count(nodeId) ? nodeLatency[nodeId] : latency;
+					node.m_loss = nodeLoss.count(nodeId) ? nodeLoss[nodeId] : loss;
+					node.m_reply = nodeReply.count(nodeId) ? nodeReply[nodeId] : reply;
+				}
+				Log::Write(LogLevel_Info, "Virtual network 0x%.8x: %d nodes, latency %dms, jitter %dms, loss %d%%", m_homeId, nodes, latency, m_jitter, loss);
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::Receive>
+// Split the bytes from the host into frames and handle each of them
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::Receive(uint8 const* _data, uint32 _length)
+			{
+				LockGuard LG(m_mutex);
+				m_input.insert(m_input.end(), _data, _data + _length);
+
+				size_t used = 0;
+				while (used < m_input.size())
+				{
+					if (m_input[used] != SOF)
+					{
+						// ACK, NAK and CAN from the host need no answer.  Anything else is noise.
+						++used;
+						continue;
+					}
+					if ((used + 2 > m_input.size()) || (used + m_input[used + 1] + 2 > m_input.size()))
+					{
+						// Wait for the rest of the frame
+						break;
+					}
+					uint32 length = m_input[used + 1] + 2;
+					HandleFrame(&m_input[used], length);
+					used += length;
+				}
+				m_input.erase(m_input.begin(), m_input.begin() + used);
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::HandleFrame>
+// Check a frame from the host and acknowledge it
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::HandleFrame(uint8 const* _frame, uint32 _length)
+			{
+				uint8 checksum = 0xff;
+				for (uint32 i = 1; i < _length - 1; ++i)
+				{
+					checksum ^= _frame[i];
+				}
+
+				uint8 handshake = ACK;
+				uint32 chance = Random(100);
+				if ((_length < 5) || (_frame[_length - 1] != checksum) || (chance < m_nak))
+				{
+					handshake = NAK;
+				}
+				else if (chance < m_nak + m_can)
+				{
+					// As if the frame collided with one from the network
+					handshake = CAN;
+				}
+				Send(&handshake, 1);
+
+				if ((handshake == ACK) && (_frame[2] == REQUEST))
+				{
+					++m_received;
+					HandleRequest(_frame[3], &_frame[4], _length - 5);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::HandleRequest>
+// Answer a request from the host
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::HandleRequest(uint8 const _function, uint8 const* _data, uint32 _length)
+			{
+				uint8 buffer[64];
+				memset(buffer, 0, sizeof(buffer));
+
+				switch (_function)
+				{
+					case FUNC_ID_ZW_GET_VERSION:
+					{
+						static char const version[] = "Z-Wave 4.61";
+						memcpy(buffer, version, sizeof(version));
+						buffer[sizeof(version)] = ZW_LIB_CONTROLLER_STATIC;
+						Respond(_function, buffer, sizeof(version) + 1);
+						break;
+					}
+					case FUNC_ID_ZW_MEMORY_GET_ID:
+					{
+						buffer[0] = (uint8) (m_homeId >> 24);
+						buffer[1] = (uint8) (m_homeId >> 16);
+						buffer[2] = (uint8) (m_homeId >> 8);
+						buffer[3] = (uint8) m_homeId;
+						buffer[4] = c_controllerNodeId;
+						Respond(_function, buffer, 5);
+						break;
+					}
+					case FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES:
+					{
+						buffer[0] = c_controllerCaps;
+						Respond(_function, buffer, 1);
+						break;
+					}
+					case FUNC_ID_ZW_GET_SUC_NODE_ID:
+					{
+						buffer[0] = c_controllerNodeId;
+						Respond(_function, buffer, 1);
+						break;
+					}
+					case FUNC_ID_SERIAL_API_GET_CAPABILITIES:
+					{
+						buffer[0] = 5;		// Serial API version
+						buffer[1] = 0;
+						buffer[2] = 0x7f;	// Manufacturer, product type and product id
+						buffer[3] = 0xff;
+						buffer[4] = 0x00;
+						buffer[5] = 0x01;
+						buffer[6] = 0x00;
+						buffer[7] = 0x01;
+						for (uint32 i = 0; i < sizeof(c_functions); ++i)
+						{
+							buffer[8 + ((c_functions[i] - 1) >> 3)] |= (uint8) (1 << ((c_functions[i] - 1) & 7));
+						}
+						Respond(_function, buffer, 8 + 32);
+						break;
+					}
+					case FUNC_ID_SERIAL_API_GET_INIT_DATA:
+					{
+						buffer[0] = 5;		// Serial API version
+						buffer[1] = c_initCaps;
+						buffer[2] = NUM_NODE_BITFIELD_BYTES;
+						for (uint32 nodeId = 1; nodeId <= c_maxNodeId; ++nodeId)
+						{
+							if (m_nodes[nodeId].m_generic)
+							{
+								buffer[3 + ((nodeId - 1) >> 3)] |= (uint8) (1 << ((nodeId - 1) & 7));
+							}
+						}
+						buffer[3 + NUM_NODE_BITFIELD_BYTES] = 5;		// Chip type and version
+						buffer[4 + NUM_NODE_BITFIELD_BYTES] = 0;
+						Respond(_function, buffer, 5 + NUM_NODE_BITFIELD_BYTES);
+						break;
+					}
+					case FUNC_ID_SERIAL_API_SET_TIMEOUTS:
+					{
+						buffer[0] = ACK_TIMEOUT / 10;		// The previous timeouts
+						buffer[1] = BYTE_TIMEOUT / 10;
+						Respond(_function, buffer, 2);
+						break;
+					}
+					case FUNC_ID_ZW_GET_NODE_PROTOCOL_INFO:
+					{
+						// Listening, routing, 40kbps.  Generic class zero means there is no such node.
+						uint8 nodeId = _length ? _data[0] : 0;
+						if (uint8 generic = m_nodes[nodeId].m_generic)
+						{
+							bool controller = (nodeId == c_controllerNodeId);
+							buffer[0] = 0xd3;
+							buffer[1] = controller ? 0x86 : 0x8c;
+							buffer[3] = controller ? 0x02 : 0x04;
+							buffer[4] = generic;
+							buffer[5] = 0x01;
+						}
+						Respond(_function, buffer, 6);
+						break;
+					}
+					case FUNC_ID_ZW_REQUEST_NODE_INFO:
+					{
+						uint8 nodeId = _length ? _data[0] : 0;
+						buffer[0] = 1;
+						Respond(_function, buffer, 1);
+
+						uint64 time = GetTimeUs() + GetLatencyUs(nodeId);
+						if (m_nodes[nodeId].m_generic && (Random(100) >= m_nodes[nodeId].m_loss))
+						{
+							vector<uint8> info;
+							GetNodeInfo(nodeId, &info);
+							buffer[0] = UPDATE_STATE_NODE_INFO_RECEIVED;
+							buffer[1] = nodeId;
+							buffer[2] = (uint8) info.size();
+							memcpy(&buffer[3], &info[0], info.size());
+							Schedule(time, FUNC_ID_ZW_APPLICATION_UPDATE, buffer, 3 + (uint32) info.size());
+						}
+						else
+						{
+							buffer[0] = UPDATE_STATE_NODE_INFO_REQ_FAILED;
+							Schedule(time, FUNC_ID_ZW_APPLICATION_UPDATE, buffer, 3);
+						}
+						break;
+					}
+					case FUNC_ID_ZW_GET_ROUTING_INFO:
+					{
+						// Every node hears the controller and the nodes next to it
+						uint8 nodeId = _length ? _data[0] : 0;
+						for (uint32 neighbor = 1; neighbor <= c_maxNodeId; ++neighbor)
+						{
+							if ((neighbor != nodeId) && m_nodes[neighbor].m_generic && ((neighbor == c_controllerNodeId) || (nodeId == c_controllerNodeId) || (neighbor + 2 >= nodeId && neighbor <= nodeId + 2u)))
+							{
+								buffer[(neighbor - 1) >> 3] |= (uint8) (1 << ((neighbor - 1) & 7));
+							}
+						}
+						Respond(_function, buffer, NUM_NODE_BITFIELD_BYTES);
+						break;
+					}
+					case FUNC_ID_ZW_SEND_DATA:
+					{
+						HandleSendData(_data, _length);
+						break;
+					}
+					case FUNC_ID_ZW_SEND_DATA_MULTI:
+					{
+						HandleSendDataMulti(_data, _length);
+						break;
+					}
+					default:
+					{
+						// Includes FUNC_ID_SERIAL_API_APPL_NODE_INFORMATION, which has no response.
+						// Like a real controller, anything else is acknowledged and ignored.
+						break;
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::HandleSendData>
+// Transmit a command to a node, reporting the outcome in a callback
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::HandleSendData(uint8 const* _data, uint32 _length)
+			{
+				// nodeId, length, command, transmit options, callback id
+				uint8 accepted = ((_length >= 4) && (_data[1] + 4u <= _length)) ? 1 : 0;
+				Respond(FUNC_ID_ZW_SEND_DATA, &accepted, 1);
+				if (!accepted)
+				{
+					return;
+				}
+
+				uint8 nodeId = _data[0];
+				uint8 length = _data[1];
+				uint8 callbackId = _data[length + 3];
+				if (m_trace)
+				{
+					Command command;
+					command.m_nodes.push_back(nodeId);
+					command.m_data.assign(&_data[2], &_data[2] + length);
+					m_commands.push_back(command);
+				}
+
+				// Broadcasts are not acknowledged by anyone, so they always complete
+				uint64 now = GetTimeUs();
+				uint64 acked = now + GetLatencyUs(nodeId);
+				bool delivered = m_nodes[nodeId].m_generic && (Random(100) >= m_nodes[nodeId].m_loss);
+
+				if (callbackId)
+				{
+					uint32 ticks = (uint32) ((acked - now) / 10000);	// Transmit time, in 10ms units
+					uint8 callback[4] =
+					{ callbackId, (uint8) ((delivered || nodeId == 0xff) ? TRANSMIT_COMPLETE_OK : TRANSMIT_COMPLETE_NO_ACK), (uint8) (ticks >> 8), (uint8) ticks };
+					Schedule(acked, FUNC_ID_ZW_SEND_DATA, callback, sizeof(callback));
+				}
+				if (delivered && length)
+				{
+					HandleCommand(nodeId, &_data[2], length, acked);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::HandleSendDataMulti>
+// Transmit a command to several nodes at once.  Nobody acknowledges it.
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::HandleSendDataMulti(uint8 const* _data, uint32 _length)
+			{
+				// count, nodeIds, length, command, transmit options, callback id
+				uint8 count = _length ? _data[0] : 0;
+				uint8 accepted = ((_length >= 4u + count) && (_data[count + 1] + count + 4u <= _length)) ? 1 : 0;
+				Respond(FUNC_ID_ZW_SEND_DATA_MULTI, &accepted, 1);
+				if (!accepted)
+				{
+					return;
+				}
+
+				uint8 const* nodes = &_data[1];
+				uint8 length = _data[count + 1];
+				uint8 const* command = &_data[count + 2];
+				uint8 callbackId = _data[count + length + 3];
+				if (m_trace)
+				{
+					Command traced;
+					traced.m_nodes.assign(nodes, nodes + count);
+					traced.m_data.assign(command, command + length);
+					m_commands.push_back(traced);
+				}
+
+				uint64 now = GetTimeUs();
+				if (callbackId)
+				{
+					uint8 callback[2] =
+					{ callbackId, TRANSMIT_COMPLETE_OK };
+					Schedule(now, FUNC_ID_ZW_SEND_DATA_MULTI, callback, sizeof(callback));
+				}
+				for (uint32 i = 0; i < count; ++i)
+				{
+					uint8 nodeId = nodes[i];
+					if (m_nodes[nodeId].m_generic && length && (Random(100) >= m_nodes[nodeId].m_loss))
+					{
+						HandleCommand(nodeId, command, length, now + GetLatencyUs(nodeId));
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::HandleCommand>
+// Apply a command to a simulated node and queue its reply
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::HandleCommand(uint8 const _nodeId, uint8 const* _command, uint32 _length, uint64 const _time)
+			{
+				SimulatedNode& node = m_nodes[_nodeId];
+				uint8 const commandClass = _command[0];
+				uint8 const command = (_length > 1) ? _command[1] : 0;
+				uint8 const value = (_length > 2) ? _command[2] : 0;
+				if (!SupportsClass(node.m_generic, commandClass))
+				{
+					// Real nodes ignore commands they do not support
+					return;
+				}
+
+				uint64 time = _time + node.m_reply * 1000 + GetLatencyUs(_nodeId);
+				uint8 reply[16];
+				switch (commandClass)
+				{
+					case Class_Basic:
+					case Class_SwitchBinary:
+					case Class_SwitchMultilevel:
+					{
+						if (command == 0x01)		// Set
+						{
+							if (node.m_generic == c_genericSwitchBinary)
+								node.m_level = value ? 0xff : 0;
+							else if (node.m_generic == c_genericSwitchMultilevel)
+								node.m_level = (value == 0xff) ? 99 : ((value > 99) ? 99 : value);
+						}
+						else if (command == 0x02)	// Get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x03;
+							reply[2] = node.m_level;
+							Report(_nodeId, time, reply, 3);
+						}
+						break;
+					}
+					case Class_SwitchAll:
+					{
+						if (command == 0x02)		// Get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x03;
+							reply[2] = 0xff;		// Included in all on and all off
+							Report(_nodeId, time, reply, 3);
+						}
+						break;
+					}
+					case Class_SensorMultilevel:
+					{
+						if (command == 0x04)		// Get
+						{
+							// An air temperature that drifts, so that each report is a change
+							int16 temperature = (int16) (200 + _nodeId + (node.m_sensorStep++ % 10));
+							reply[0] = commandClass;
+							reply[1] = 0x05;
+							reply[2] = 0x01;		// Air temperature
+							reply[3] = 0x22;		// One decimal, Celsius, two bytes
+							reply[4] = (uint8) (temperature >> 8);
+							reply[5] = (uint8) temperature;
+							Report(_nodeId, time, reply, 6);
+						}
+						break;
+					}
+					case Class_ManufacturerSpecific:
+					{
+						if (command == 0x04)		// Get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x05;
+							reply[2] = 0x7f;		// Manufacturer
+							reply[3] = 0xff;
+							reply[4] = 0x00;		// Product type
+							reply[5] = node.m_generic;
+							reply[6] = 0x00;		// Product id
+							reply[7] = _nodeId;
+							Report(_nodeId, time, reply, 8);
+						}
+						break;
+					}
+					case Class_Version:
+					{
+						if (command == 0x11)		// Get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x12;
+							reply[2] = 0x03;		// Library type
+							reply[3] = 4;			// Protocol version
+							reply[4] = 61;
+							reply[5] = 1;			// Application version
+							reply[6] = 0;
+							Report(_nodeId, time, reply, 7);
+						}
+						else if (command == 0x13)	// Command class get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x14;
+							reply[2] = value;
+							reply[3] = SupportsClass(node.m_generic, value) ? 1 : 0;
+							Report(_nodeId, time, reply, 4);
+						}
+						break;
+					}
+					case Class_Association:
+					{
+						if (command == 0x01 && value == 1)				// Set
+						{
+							for (uint32 i = 3; i < _length && node.m_associations.size() < c_maxAssociations; ++i)
+							{
+								if (find(node.m_associations.begin(), node.m_associations.end(), _command[i]) == node.m_associations.end())
+								{
+									node.m_associations.push_back(_command[i]);
+								}
+							}
+						}
+						else if (command == 0x04 && value == 1)			// Remove
+						{
+							for (uint32 i = 3; i < _length; ++i)
+							{
+								node.m_associations.erase(remove(node.m_associations.begin(), node.m_associations.end(), _command[i]), node.m_associations.end());
+							}
+						}
+						else if (command == 0x02)						// Get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x03;
+							reply[2] = value;
+							reply[3] = c_maxAssociations;
+							reply[4] = 0;			// Reports to follow
+							uint32 count = 0;
+							if (value == 1)
+							{
+								for (; count < node.m_associations.size(); ++count)
+								{
+									reply[5 + count] = node.m_associations[count];
+								}
+							}
+							Report(_nodeId, time, reply, 5 + count);
+						}
+						else if (command == 0x05)						// Groupings get
+						{
+							reply[0] = commandClass;
+							reply[1] = 0x06;
+							reply[2] = 1;
+							Report(_nodeId, time, reply, 3);
+						}
+						break;
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::GetNodeInfo>
+// The node information frame: basic, generic and specific class, then the command classes
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::GetNodeInfo(uint8 const _nodeId, vector<uint8>* o_info)
+			{
+				uint8 const generic = m_nodes[_nodeId].m_generic;
+				o_info->clear();
+				o_info->push_back((_nodeId == c_controllerNodeId) ? 0x02 : 0x04);
+				o_info->push_back(generic);
+				o_info->push_back(0x01);
+
+				static uint8 const classes[] =
+				{ Class_SwitchBinary, Class_SwitchMultilevel, Class_SwitchAll, Class_SensorMultilevel, Class_ManufacturerSpecific, Class_Association, Class_Version };
+				for (uint32 i = 0; i < sizeof(classes); ++i)
+				{
+					if ((_nodeId != c_controllerNodeId) && SupportsClass(generic, classes[i]))
+					{
+						o_info->push_back(classes[i]);
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::Respond>
+// Send a response frame straight away
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::Respond(uint8 const _function, uint8 const* _data, uint32 _length)
+			{
+				vector<uint8> frame;
+				BuildFrame(RESPONSE, _function, _data, _length, &frame);
+				Send(&frame[0], (uint32) frame.size());
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::Schedule>
+// Queue a request frame to be sent at a later time
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::Schedule(uint64 const _time, uint8 const _function, uint8 const* _data, uint32 _length)
+			{
+				vector<uint8> frame;
+				BuildFrame(REQUEST, _function, _data, _length, &frame);
+				m_pending.insert(make_pair(_time, frame));
+				m_queueEvent->Set();
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::Report>
+// Queue a command from a node to the controller
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::Report(uint8 const _nodeId, uint64 const _time, uint8 const* _command, uint32 _length)
+			{
+				uint8 buffer[32];
+				buffer[0] = 0;				// Receive status
+				buffer[1] = _nodeId;
+				buffer[2] = (uint8) _length;
+				memcpy(&buffer[3], _command, _length);
+				Schedule(_time, FUNC_ID_APPLICATION_COMMAND_HANDLER, buffer, _length + 3);
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::Send>
+// Pass bytes to the host.  Call with m_mutex held.
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::Send(uint8 const* _data, uint32 _length)
+			{
+				if (_data[0] == SOF)
+				{
+					++m_sent;
+				}
+
+				if (m_output)
+				{
+					m_output(_data, _length, m_context);
+				}
+#if !defined WIN32 && !defined WINRT
+				else if (m_pty >= 0)
+				{
+					while (_length)
+					{
+						ssize_t written = write(m_pty, _data, _length);
+						if (written <= 0)
+						{
+							break;
+						}
+						_data += written;
+						_length -= (uint32) written;
+					}
+				}
+#endif
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::GetLatencyUs>
+// How long a frame to or from a node takes, including the jitter
+//-----------------------------------------------------------------------------
+			uint32 VirtualNetwork::GetLatencyUs(uint8 const _nodeId)
+			{
+				return (m_nodes[_nodeId].m_latency + Random(m_jitter + 1)) * 1000;
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::Random>
+// A repeatable random number below _range
+//-----------------------------------------------------------------------------
+			uint32 VirtualNetwork::Random(uint32 const _range)
+			{
+				// xorshift32
+				m_random ^= m_random << 13;
+				m_random ^= m_random >> 17;
+				m_random ^= m_random << 5;
+				return _range ? (m_random % _range) : 0;
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::GetStatistics>
+// Report how many frames have been exchanged with the host
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::GetStatistics(uint32* o_received, uint32* o_sent)
+			{
+				LockGuard LG(m_mutex);
+				*o_received = m_received;
+				*o_sent = m_sent;
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::GetCommands>
+// Hand over the commands traced since the last call
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::GetCommands(vector<Command>* o_commands)
+			{
+				LockGuard LG(m_mutex);
+				o_commands->clear();
+				o_commands->swap(m_commands);
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::SetReply>
+// Change how long a node takes to prepare its reports
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::SetReply(uint8 const _nodeId, uint32 const _ms)
+			{
+				LockGuard LG(m_mutex);
+				m_nodes[_nodeId].m_reply = _ms;
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::GetTimeUs>
+// Monotonic time in microseconds
+//-----------------------------------------------------------------------------
+			uint64 VirtualNetwork::GetTimeUs()
+			{
+				return (uint64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::ThreadEntryPoint>
+// Entry point of the thread that sends the queued frames
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::ThreadEntryPoint(Event* _exitEvent, void* _context)
+			{
+				VirtualNetwork* network = (VirtualNetwork*) _context;
+				if (network)
+				{
+					network->ThreadProc(_exitEvent);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::ThreadProc>
+// Send each queued frame when it is due
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::ThreadProc(Event* _exitEvent)
+			{
+				Wait* waitObjects[2];
+				waitObjects[0] = _exitEvent;
+				waitObjects[1] = m_queueEvent;
+
+				while (true)
+				{
+					int32 timeout = -1;
+					{
+						LockGuard LG(m_mutex);
+						uint64 now = GetTimeUs();
+						while (!m_pending.empty() && (m_pending.begin()->first <= now))
+						{
+							Send(&m_pending.begin()->second[0], (uint32) m_pending.begin()->second.size());
+							m_pending.erase(m_pending.begin());
+						}
+						if (!m_pending.empty())
+						{
+							timeout = (int32) ((m_pending.begin()->first - now + 999) / 1000);
+						}
+						m_queueEvent->Reset();
+					}
+
+					if (Wait::Multiple(waitObjects, 2, timeout) == 0)
+					{
+						// Exit has been signalled
+						return;
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::OpenPty>
+// Create a pseudo terminal and serve the network on it
+//-----------------------------------------------------------------------------
+			bool VirtualNetwork::OpenPty(string* o_path)
+			{
+#if defined WIN32 || defined WINRT
+				return false;
+#else
+				if (m_pty >= 0)
+				{
+					return false;
+				}
+
+				int pty = posix_openpt(O_RDWR | O_NOCTTY);
+				if (pty < 0)
+				{
+					Log::Write(LogLevel_Error, "Virtual network: cannot create a pseudo terminal. Error code %d", errno);
+					return false;
+				}
+				char const* name = NULL;
+				if ((grantpt(pty) != 0) || (unlockpt(pty) != 0) || ((name = ptsname(pty)) == NULL))
+				{
+					Log::Write(LogLevel_Error, "Virtual network: cannot unlock the pseudo terminal. Error code %d", errno);
+					close(pty);
+					return false;
+				}
+
+				// Pass the bytes through untouched until the host sets up the terminal
+				struct termios tios;
+				if (tcgetattr(pty, &tios) == 0)
+				{
+					cfmakeraw(&tios);
+					tcsetattr(pty, TCSANOW, &tios);
+				}
+
+				*o_path = name;
+				{
+					LockGuard LG(m_mutex);
+					m_pty = pty;
+				}
+				m_ptyThread = new Thread("virtualpty");
+				m_ptyThread->Start(VirtualNetwork::PtyThreadEntryPoint, this);
+				Log::Write(LogLevel_Info, "Virtual network 0x%.8x is served on %s", m_homeId, o_path->c_str());
+				return true;
+#endif
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::PtyThreadEntryPoint>
+// Entry point of the thread that reads from the pseudo terminal
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::PtyThreadEntryPoint(Event* _exitEvent, void* _context)
+			{
+				VirtualNetwork* network = (VirtualNetwork*) _context;
+				if (network)
+				{
+					network->PtyThreadProc(_exitEvent);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <VirtualNetwork::PtyThreadProc>
+// Pass whatever the host writes to the pseudo terminal to Receive
+//-----------------------------------------------------------------------------
+			void VirtualNetwork::PtyThreadProc(Event* _exitEvent)
+			{
+#if !defined WIN32 && !defined WINRT
+				uint8 buffer[256];
+				while (Wait::Single(_exitEvent, 0) != 0)
+				{
+					struct pollfd pfd;
+					pfd.fd = m_pty;
+					pfd.events = POLLIN;
+					pfd.revents = 0;
+					if (poll(&pfd, 1, 50) <= 0)
+					{
+						continue;
+					}
+
+					ssize_t count = (pfd.revents & POLLIN) ? read(m_pty, buffer, sizeof(buffer)) : 0;
+					if (count > 0)
+					{
+						Receive(buffer, (uint32) count);
+					}
+					else if (Wait::Single(_exitEvent, 50) == 0)
+					{
+						// Nobody has the terminal open.  Check again later.
+						return;
+					}
+				}
+#endif
+			}
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+//
+//	VirtualNetwork.h
+//
+//	Simulated Z-Wave controller and nodes, speaking the Serial API
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _VirtualNetwork_H
+#define _VirtualNetwork_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace Platform
+		{
+			class Event;
+			class Mutex;
+			class Thread;
+
+			/** \brief Simulates a static controller and the nodes in its network.
+			 * \ingroup Platform
+			 *
+			 * Bytes written by the host are parsed as Serial API frames and answered
+			 * the way a controller would: ACK, NAK or CAN for each frame, a response,
+			 * and for SEND_DATA a callback once the node has acknowledged, followed
+			 * by the node's reply.  SEND_DATA_MULTI frames are not acknowledged, so
+			 * they complete at once, whether or not each node heard them.  Replies are scripted for Basic, Switch Binary,
+			 * Switch Multilevel, Switch All, Sensor Multilevel, Association, Version
+			 * and Manufacturer Specific.
+			 *
+			 * The network is described by a list of key=value pairs, for example
+			 * "nodes=50,latency=20,loss=5,latency.7=200".  Anything before a ':' is
+			 * ignored, so a controller path such as "virtual:nodes=10" can be used.
+			 * - nodes: number of nodes besides the controller, which is node 1 (default 10, at most 231)
+			 * - latency: ms until a node acknowledges a frame, and again until it replies (default 0)
+			 * - jitter: up to this many ms are added at random to each latency (default 0)
+			 * - loss: percentage of frames a node does not acknowledge (default 0)
+			 * - reply: ms a node takes to prepare a report, on top of the latency (default 0)
+			 * - nak, can: percentage of host frames answered with a NAK or a CAN (default 0)
+			 * - homeid: home id, in hex (default 0xc0ffee00)
+			 * - seed: seed for the random numbers (default 1)
+			 * - latency.N, loss.N, reply.N: override latency, loss and reply for node N
+			 * - trace: 1 to keep the commands the host sends to nodes, for GetCommands (default 0)
+			 *
+			 * The nodes are listening devices that take turns being a binary switch,
+			 * a multilevel switch and a multilevel sensor.
+			 */
+			class VirtualNetwork
+			{
+				public:
+					/**
+					 * A command the host sent to one node, or to several in a multicast frame.
+					 */
+					struct Command
+					{
+						vector<uint8> m_nodes;
+						vector<uint8> m_data;					// Command class, command and parameters
+					};
+
+					/**
+					 * Receives the bytes the simulated controller sends to the host.
+					 */
+					typedef void (*pfnOutput_t)(uint8 const* _data, uint32 _length, void* _context);
+
+					/**
+					 * \param _parameters description of the network.  See the class description.
+					 * \param _output called with the bytes for the host.  May be NULL if the network is served with OpenPty.
+					 * \param _context passed to _output.
+					 */
+					VirtualNetwork(string const& _parameters, pfnOutput_t _output, void* _context);
+					~VirtualNetwork();
+
+					/**
+					 * Process bytes sent by the host.  Frames may be split across calls.
+					 */
+					void Receive(uint8 const* _data, uint32 _length);
+
+					/**
+					 * Serve the network on a new pseudo terminal, so that any Serial API
+					 * host can open it like the serial port of a real controller.
+					 * Not available on Windows.
+					 * \param o_path receives the path of the terminal for the host to open.
+					 * \return true if the terminal was created.
+					 */
+					bool OpenPty(string* o_path);
+
+					uint32 GetHomeId() const
+					{
+						return m_homeId;
+					}
+
+					/**
+					 * \param o_received receives the number of frames accepted from the host.
+					 * \param o_sent receives the number of frames sent to the host.
+					 */
+					void GetStatistics(uint32* o_received, uint32* o_sent);
+
+					/**
+					 * Take the commands sent to nodes since the last call, in the order the
+					 * controller was asked to transmit them.  Only kept with trace=1.
+					 */
+					void GetCommands(vector<Command>* o_commands);
+
+					/**
+					 * Change the reply setting of a node while the network runs, as reply.N does.
+					 */
+					void SetReply(uint8 const _nodeId, uint32 const _ms);
+
+				private:
+					VirtualNetwork(VirtualNetwork const&);					// prevent copy
+					VirtualNetwork& operator =(VirtualNetwork const&);		// prevent assignment
+
+					struct SimulatedNode
+					{
+						uint8 m_generic;						// Zero if there is no node with this id
+						uint8 m_level;
+						uint8 m_sensorStep;
+						uint32 m_latency;
+						uint32 m_loss;
+						uint32 m_reply;
+						vector<uint8> m_associations;			// Members of group 1
+					};
+
+					void ParseParameters(string const& _parameters);
+					void HandleFrame(uint8 const* _frame, uint32 _length);
+					void HandleRequest(uint8 const _function, uint8 const* _data, uint32 _length);
+					void HandleSendData(uint8 const* _data, uint32 _length);
+					void HandleSendDataMulti(uint8 const* _data, uint32 _length);
+					void HandleCommand(uint8 const _nodeId, uint8 const* _command, uint32 _length, uint64 const _time);
+					void Respond(uint8 const _function, uint8 const* _data, uint32 _length);
+					void Schedule(uint64 const _time, uint8 const _function, uint8 const* _data, uint32 _length);
+					void Report(uint8 const _nodeId, uint64 const _time, uint8 const* _command, uint32 _length);
+					void Send(uint8 const* _data, uint32 _length);
+					uint32 GetLatencyUs(uint8 const _nodeId);
+					uint32 Random(uint32 const _range);
+					void GetNodeInfo(uint8 const _nodeId, vector<uint8>* o_info);
+
+					static uint64 GetTimeUs();
+					static void ThreadEntryPoint(Event* _exitEvent, void* _context);
+					void ThreadProc(Event* _exitEvent);
+					static void PtyThreadEntryPoint(Event* _exitEvent, void* _context);
+					void PtyThreadProc(Event* _exitEvent);
+
+					pfnOutput_t m_output;
+					void* m_context;
+					Thread* m_thread;
+					Thread* m_ptyThread;
+					Mutex* m_mutex;							// Guards everything below.  Held while output is sent so frames stay in order.
+					Event* m_queueEvent;
+					int m_pty;								// Master side of the pseudo terminal, or -1
+					uint32 m_homeId;
+					uint32 m_jitter;
+					uint32 m_nak;
+					uint32 m_can;
+					uint32 m_random;
+					uint32 m_received;
+					uint32 m_sent;
+					bool m_trace;
+					vector<Command> m_commands;				// Kept if m_trace is set
+					vector<uint8> m_input;
+					vector<SimulatedNode> m_nodes;			// Indexed by node id, for every value of a byte
+					multimap<uint64, vector<uint8> > m_pending;	// Frames to send, by the time they are due
+			};
+		} // namespace Platform
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif //_VirtualNetwork_H
@@ -29,6 +29,7 @@
 #include "Defs.h"
 #include "platform/Wait.h"
 #include "platform/Event.h"
+#include "platform/TimeStamp.h"
 #include "platform/Log.h"
 
 #ifdef WIN32
@@ -165,6 +166,94 @@ namespace OpenZWave
 				Event* waitEvent = (Event*) _context;
 				waitEvent->Set();
 			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::WaitSet>
+//	Constructor
+//-----------------------------------------------------------------------------
+			WaitSet::WaitSet(Wait** _objects, uint32 _numObjects) :
+					m_objects(new Wait*[_numObjects]), m_numObjects(_numObjects), m_deadline(new TimeStamp()), m_pImpl(new WaitSetImpl())
+			{
+				for (uint32 i = 0; i < m_numObjects; ++i)
+				{
+					m_objects[i] = _objects[i];
+					m_objects[i]->AddWatcher(WaitSetCallback, this);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::~WaitSet>
+//	Destructor
+//-----------------------------------------------------------------------------
+			WaitSet::~WaitSet()
+			{
+				for (uint32 i = 0; i < m_numObjects; ++i)
+				{
+					m_objects[i]->RemoveWatcher(WaitSetCallback, this);
+				}
+				delete m_pImpl;
+				delete m_deadline;
+				delete[] m_objects;
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::Multiple>
+//	Wait for one of the first _numObjects objects in the set to become signalled.
+//-----------------------------------------------------------------------------
+			int32 WaitSet::Multiple(uint32 _numObjects, int32 _timeout // = -1
+					)
+			{
+				if (_numObjects > m_numObjects)
+				{
+					_numObjects = m_numObjects;
+				}
+				if (_timeout > 0)
+				{
+					m_deadline->SetTime(_timeout);
+				}
+
+				int32 remaining = _timeout;
+				while (true)
+				{
+					for (uint32 i = 0; i < _numObjects; ++i)
+					{
+						if (m_objects[i]->IsSignalled())
+						{
+							return (int32) i;
+						}
+					}
+					if (remaining == 0)
+					{
+						return -1;
+					}
+
+					// Any object in the set wakes us up, including ones the caller is
+					// not interested in right now, so re-check and wait again for the
+					// rest of the timeout.
+					if (!m_pImpl->Wait(remaining))
+					{
+						remaining = 0;
+					}
+					else if (_timeout > 0)
+					{
+						remaining = m_deadline->TimeRemaining();
+						if (remaining < 0)
+						{
+							remaining = 0;
+						}
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::WaitSetCallback>
+//	Callback handler for the watchers added by a WaitSet
+//-----------------------------------------------------------------------------
+			void WaitSet::WaitSetCallback(void* _context)
+			{
+				WaitSet* waitSet = (WaitSet*) _context;
+				waitSet->m_pImpl->Signal();
+			}
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
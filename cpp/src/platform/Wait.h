@@ -46,6 +46,7 @@ namespace OpenZWave
 			class Wait: public Ref
 			{
 					friend class WaitImpl;
+					friend class WaitSet;
 					friend class ThreadImpl;
 
 				public:
@@ -114,6 +115,55 @@ namespace OpenZWave
 
 					WaitImpl* m_pImpl;					// Pointer to an object that encapsulates the platform-specific implementation of a Wait object.
 			};
+
+			class WaitSetImpl;
+			class TimeStamp;
+
+			/** \brief A fixed set of Wait objects that a thread waits on over and over again.
+			 * \ingroup Platform
+			 *
+			 * Wait::Multiple creates an Event and adds and removes a watcher on every object
+			 * each time it is called.  A WaitSet registers its watchers once, when it is
+			 * constructed, and blocks on a single platform wake-up object (an eventfd in a
+			 * persistent epoll set on Linux), so a wait does not allocate or touch the
+			 * objects' watcher lists.
+			 */
+			class WaitSet
+			{
+				public:
+					/**
+					 * Constructor.
+					 * \param _objects array of pointers to the objects in the set.  The array is copied.
+					 * \param _numObjects number of objects in the array.
+					 */
+					WaitSet(Wait** _objects, uint32 _numObjects);
+
+					/**
+					 * Destructor.  Removes the watchers from all the objects in the set.
+					 */
+					~WaitSet();
+
+					/**
+					 * Wait for one of the first _numObjects objects in the set to become signalled.
+					 * If more than one object is in a signalled state, the lowest index is returned.
+					 * \param _numObjects number of objects (from the start of the set) to consider.
+					 * \param _timeout optional maximum time to wait.  Defaults to -1, which means wait forever.
+					 * \return index of the object that was signalled, -1 if the wait timed out.
+					 * \see Wait::Multiple
+					 */
+					int32 Multiple(uint32 _numObjects, int32 _timeout = -1);
+
+				private:
+					WaitSet(WaitSet const&);				// prevent copy
+					WaitSet& operator =(WaitSet const&);	// prevent assignment
+
+					static void WaitSetCallback(void* _context);
+
+					Wait** m_objects;
+					uint32 m_numObjects;
+					TimeStamp* m_deadline;
+					WaitSetImpl* m_pImpl;				// Pointer to an object that encapsulates the platform-specific wake-up mechanism.
+			};
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
@@ -27,7 +27,9 @@
 //-----------------------------------------------------------------------------
 
 #include <dirent.h>
+#include <atomic>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <libgen.h>
@@ -85,6 +87,18 @@ namespace OpenZWave
 				return (stat(_filename.c_str(), &buffer) == 0);
 			}
 
+			bool FileOpsImpl::FileStatus(const string _filename, uint64 *_modified, uint64 *_size)
+			{
+				struct stat buffer;
+				if (stat(_filename.c_str(), &buffer) != 0)
+				{
+					return false;
+				}
+				*_modified = (uint64) buffer.st_mtime;
+				*_size = (uint64) buffer.st_size;
+				return true;
+			}
+
 			bool FileOpsImpl::FileWriteable(const string _filename)
 			{
 				if (!FileExists(_filename))
@@ -161,6 +175,96 @@ namespace OpenZWave
 				return true;
 			}
 
+			bool FileOpsImpl::FileWriteAtomic(const string _filename, const string& _contents)
+			{
+				/* write everything to a temporary file next to the target first.  The name is
+				 * unique to this process and call, so two writers never share a temporary file */
+				static std::atomic<uint32> s_tmpCount(0);
+				char suffix[32];
+				snprintf(suffix, sizeof(suffix), ".%d.%u.tmp", (int) getpid(), (unsigned) ++s_tmpCount);
+				string tmpFile = _filename + suffix;
+				int fd = open(tmpFile.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+				if (fd < 0)
+				{
+					Log::Write(LogLevel_Warning, "Can't create %s - %s", tmpFile.c_str(), strerror(errno));
+					return false;
+				}
+				size_t written = 0;
+				while (written < _contents.size())
+				{
+					ssize_t ret = write(fd, _contents.data() + written, _contents.size() - written);
+					if (ret < 0)
+					{
+						if (errno == EINTR)
+							continue;
+						Log::Write(LogLevel_Warning, "Write to %s failed - %s", tmpFile.c_str(), strerror(errno));
+						close(fd);
+						remove(tmpFile.c_str());
+						return false;
+					}
+					written += (size_t) ret;
+				}
+				/* the data must be on disk before the rename makes it visible */
+				if (fsync(fd) < 0 || close(fd) < 0)
+				{
+					Log::Write(LogLevel_Warning, "Sync of %s failed - %s", tmpFile.c_str(), strerror(errno));
+					remove(tmpFile.c_str());
+					return false;
+				}
+				if (rename(tmpFile.c_str(), _filename.c_str()) < 0)
+				{
+					Log::Write(LogLevel_Warning, "Rename %s -> %s failed - %s", tmpFile.c_str(), _filename.c_str(), strerror(errno));
+					remove(tmpFile.c_str());
+					return false;
+				}
+				/* and persist the directory entry too */
+				int dirfd = open(ozwdirname(_filename).c_str(), O_RDONLY);
+				if (dirfd >= 0)
+				{
+					fsync(dirfd);
+					close(dirfd);
+				}
+				return true;
+			}
+
+			bool FileOpsImpl::FileMap(const string _filename, char const **_data, uint64 *_size)
+			{
+				int fd = open(_filename.c_str(), O_RDONLY);
+				if (fd < 0)
+				{
+					return false;
+				}
+				struct stat buffer;
+				if (fstat(fd, &buffer) < 0)
+				{
+					close(fd);
+					return false;
+				}
+				*_data = NULL;
+				*_size = (uint64) buffer.st_size;
+				if (*_size > 0)
+				{
+					void* data = mmap(NULL, (size_t) *_size, PROT_READ, MAP_PRIVATE, fd, 0);
+					if (data == MAP_FAILED)
+					{
+						Log::Write(LogLevel_Warning, "Can't map %s - %s", _filename.c_str(), strerror(errno));
+						close(fd);
+						return false;
+					}
+					/* the readers go through the file once, from start to end */
+					madvise(data, (size_t) *_size, MADV_SEQUENTIAL);
+					*_data = (char const*) data;
+				}
+				/* the mapping stays valid after the file is closed */
+				close(fd);
+				return true;
+			}
+
+			void FileOpsImpl::FileUnmap(char const *_data, uint64 _size)
+			{
+				munmap((void*) _data, (size_t) _size);
+			}
+
 			bool FileOpsImpl::FolderCreate(const string _dirname)
 			{
 				if (FolderExists(_dirname))
@@ -27,7 +27,9 @@
 //-----------------------------------------------------------------------------
 #include <string>
 #include <cstring>
+#include <cerrno>
 #include <pthread.h>
+#include <unistd.h>
 #include <iostream>
 #include "Defs.h"
 #include "LogImpl.h"
@@ -38,6 +40,47 @@ namespace OpenZWave
 	{
 		namespace Platform
 		{
+			// The writer thread flushes its batch buffers once they reach this size
+			static size_t const c_asyncFlushSize = 64 * 1024;
+			// How long the idle writer thread sleeps before rechecking the queues
+			static long const c_asyncIdleNs = 100 * 1000 * 1000;
+
+//-----------------------------------------------------------------------------
+//	<FormatTimeStamp>
+//	Format a timestamp in the style used as a prefix on every log line
+//-----------------------------------------------------------------------------
+			static void FormatTimeStamp(struct timeval const& _tv, char* _buf, size_t _size)
+			{
+				// use threadsafe verion of localtime. Reported by nihilus, 2019-04
+				// https://www.gnu.org/software/libc/manual/html_node/Broken_002ddown-Time.html#Broken_002ddown-Time
+				struct tm *tm, xtm;
+				memset(&xtm, 0, sizeof(xtm));
+				tm = localtime_r(&_tv.tv_sec, &xtm);
+				snprintf(_buf, _size, "%04d-%02d-%02d %02d:%02d:%02d.%03d ", tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec, (int) _tv.tv_usec / 1000);
+			}
+
+//-----------------------------------------------------------------------------
+//	<WriteAll>
+//	Write a whole buffer to a file descriptor and empty the buffer
+//-----------------------------------------------------------------------------
+			static void WriteAll(int _fd, string& _buf)
+			{
+				char const* data = _buf.data();
+				size_t left = _buf.size();
+				while (left > 0)
+				{
+					ssize_t res = write(_fd, data, left);
+					if (res < 0)
+					{
+						if (errno == EINTR)
+							continue;
+						break;
+					}
+					data += res;
+					left -= res;
+				}
+				_buf.clear();
+			}
 
 //-----------------------------------------------------------------------------
 //	<LogImpl::LogImpl>
@@ -50,8 +93,12 @@ namespace OpenZWave
 					m_saveLevel(_saveLevel),					// level of messages to log to file
 					m_queueLevel(_queueLevel),				// level of messages to log to queue
 					m_dumpTrigger(_dumpTrigger),				// dump queued messages when this level is seen
-					pFile( NULL)
+					pFile( NULL), m_async(false), m_rings( NULL), m_seq(0), m_writerIdle(false), m_writerStop(false), m_asyncRecords(0), m_asyncDropped(0), m_asyncDepthMax(0)
 			{
+				pthread_mutex_init(&m_writerMutex, NULL);
+				pthread_cond_init(&m_writerCond, NULL);
+				pthread_key_create(&m_ringKey, AsyncRingRelease);
+
 				if (!m_filename.empty())
 				{
 					if (!m_bAppendLog)
@@ -80,6 +127,18 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			LogImpl::~LogImpl()
 			{
+				SetAsync(false);
+				pthread_key_delete(m_ringKey);
+				AsyncRing* ring = m_rings.load();
+				while (ring)
+				{
+					AsyncRing* next = ring->m_next;
+					delete ring;
+					ring = next;
+				}
+				pthread_cond_destroy(&m_writerCond);
+				pthread_mutex_destroy(&m_writerMutex);
+
 				if (this->pFile)
 					fclose(this->pFile);
 			}
@@ -133,14 +192,25 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void LogImpl::Write(LogLevel _logLevel, uint8 const _nodeId, char const* _format, va_list _args)
 			{
-				// create a timestamp string
-				string timeStr = GetTimeStampString();
-				string nodeStr = GetNodeString(_nodeId);
-				string loglevelStr = GetLogLevelString(_logLevel);
+				if (m_async)
+				{
+					// Only capture messages the writer thread will do something with
+					if ((_logLevel <= m_queueLevel) || (_logLevel <= m_dumpTrigger) || (_logLevel == LogLevel_Internal))
+					{
+						va_list args;
+						va_copy(args, _args);
+						PushAsync(AsyncRecord::Type_Line, _logLevel, _nodeId, _format, &args);
+						va_end(args);
+					}
+					return;
+				}
 
 				// handle this message
 				if ((_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal))	// we're going to do something with this message...
 				{
+					// create a timestamp string
+					string timeStr = GetTimeStampString();
+
 					char lineBuf[1024] =
 					{ 0 };
 					//int lineLen = 0;
@@ -163,8 +233,8 @@ namespace OpenZWave
 							if (_logLevel != LogLevel_Internal)						// don't add a second timestamp to display of queued messages
 							{
 								outBuf.append(timeStr);
-								outBuf.append(loglevelStr);
-								outBuf.append(nodeStr);
+								outBuf.append(GetLogLevelString(_logLevel));
+								outBuf.append(GetNodeString(_nodeId));
 								outBuf.append(lineBuf);
 								outBuf.append("\n");
 
@@ -222,6 +292,12 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void LogImpl::QueueDump()
 			{
+				if (m_async)
+				{
+					// Keep the dump in order with the messages already queued by this thread
+					PushAsync(AsyncRecord::Type_QueueDump, LogLevel_Always, 0, NULL, NULL);
+					return;
+				}
 				Log::Write(LogLevel_Always, "");
 				Log::Write(LogLevel_Always, "Dumping queued log messages");
 				Log::Write(LogLevel_Always, "");
@@ -244,6 +320,11 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void LogImpl::QueueClear()
 			{
+				if (m_async)
+				{
+					PushAsync(AsyncRecord::Type_QueueClear, LogLevel_Always, 0, NULL, NULL);
+					return;
+				}
 				m_logQueue.clear();
 			}
 
@@ -267,15 +348,10 @@ namespace OpenZWave
 				// Get a timestamp
 				struct timeval tv;
 				gettimeofday(&tv, NULL);
-				// use threadsafe verion of localtime. Reported by nihilus, 2019-04
-				// https://www.gnu.org/software/libc/manual/html_node/Broken_002ddown-Time.html#Broken_002ddown-Time
-				struct tm *tm, xtm;
-				memset(&xtm, 0, sizeof(xtm));
-				tm = localtime_r(&tv.tv_sec, &xtm);
 
 				// create a time stamp string for the log message
 				char buf[100];
-				snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%03d ", tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec, (int) tv.tv_usec / 1000);
+				FormatTimeStamp(tv, buf, sizeof(buf));
 				string str = buf;
 				return str;
 			}
@@ -338,6 +414,385 @@ namespace OpenZWave
 				else
 					return "Unknown, ";
 			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::SetAsync>
+//	Start or stop the background writer thread
+//-----------------------------------------------------------------------------
+			bool LogImpl::SetAsync(bool _async)
+			{
+				if (_async == m_async)
+				{
+					return true;
+				}
+
+				if (_async)
+				{
+					// Anything already buffered by stdio must reach the file before the writer's output
+					if (this->pFile != NULL)
+						fflush(this->pFile);
+					fflush(stdout);
+
+					m_writerStop = false;
+					m_writerIdle = false;
+					if (pthread_create(&m_writerThread, NULL, AsyncWriterProc, this) != 0)
+					{
+						std::cerr << "Could Not Start OZW Log Writer Thread." << std::endl;
+						return false;
+					}
+#if !defined(__APPLE_CC__) && !defined(__FreeBSD__) && !defined(__NetBSD__)
+					pthread_setname_np(m_writerThread, "OZW-LogWriter");
+#endif
+					m_async = true;
+				}
+				else
+				{
+					m_async = false;
+					pthread_mutex_lock(&m_writerMutex);
+					m_writerStop = true;
+					pthread_cond_signal(&m_writerCond);
+					pthread_mutex_unlock(&m_writerMutex);
+					pthread_join(m_writerThread, NULL);
+				}
+				return true;
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::GetAsyncStatistics>
+//	Report the counters of the asynchronous pipeline
+//-----------------------------------------------------------------------------
+			void LogImpl::GetAsyncStatistics(Log::AsyncStatistics* _data)
+			{
+				_data->m_records = m_asyncRecords.load();
+				_data->m_dropped = m_asyncDropped.load();
+				_data->m_queueDepthMax = m_asyncDepthMax.load();
+				_data->m_queueDepth = 0;
+				_data->m_producers = 0;
+				for (AsyncRing* ring = m_rings.load(); ring != NULL; ring = ring->m_next)
+				{
+					_data->m_queueDepth += ring->m_head.load() - ring->m_tail.load();
+					if (ring->m_inUse.load())
+						_data->m_producers++;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::GetThreadRing>
+//	Find (or create) the queue owned by the calling thread
+//-----------------------------------------------------------------------------
+			LogImpl::AsyncRing* LogImpl::GetThreadRing()
+			{
+				AsyncRing* ring = (AsyncRing*) pthread_getspecific(m_ringKey);
+				if (ring != NULL)
+				{
+					return ring;
+				}
+
+				// Adopt a queue left behind by a thread that has exited...
+				for (AsyncRing* r = m_rings.load(); r != NULL; r = r->m_next)
+				{
+					bool inUse = false;
+					if (r->m_inUse.compare_exchange_strong(inUse, true))
+					{
+						ring = r;
+						break;
+					}
+				}
+
+				// ...or add a new one to the list the writer thread walks
+				if (ring == NULL)
+				{
+					ring = new AsyncRing();
+					ring->m_head = 0;
+					ring->m_tail = 0;
+					ring->m_inUse = true;
+					ring->m_next = m_rings.load();
+					while (!m_rings.compare_exchange_weak(ring->m_next, ring))
+						;
+				}
+
+				pthread_setspecific(m_ringKey, ring);
+				return ring;
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::AsyncRingRelease>
+//	Called on thread exit to make the thread's queue available for reuse
+//-----------------------------------------------------------------------------
+			void LogImpl::AsyncRingRelease(void* _ring)
+			{
+				((AsyncRing*) _ring)->m_inUse = false;
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::PushAsync>
+//	Capture a message on the calling thread without locking or blocking
+//-----------------------------------------------------------------------------
+			void LogImpl::PushAsync(AsyncRecord::Type _type, LogLevel _level, uint8 const _nodeId, char const* _format, va_list* _args)
+			{
+				AsyncRing* ring = GetThreadRing();
+				uint32 head = ring->m_head.load(std::memory_order_relaxed);
+				if (head - ring->m_tail.load(std::memory_order_acquire) >= AsyncRing::Size)
+				{
+					// The writer thread is behind.  Never stall the caller.
+					m_asyncDropped++;
+					return;
+				}
+
+				AsyncRecord& record = ring->m_records[head & (AsyncRing::Size - 1)];
+				record.m_seq = m_seq++;
+				gettimeofday(&record.m_time, NULL);
+				record.m_threadId = (unsigned long) pthread_self();
+				record.m_level = _level;
+				record.m_nodeId = _nodeId;
+				record.m_type = (uint8) _type;
+				record.m_text[0] = 0;
+				if (_format != NULL && _format[0] != '\0' && _args != NULL)
+				{
+					// The arguments may point into the caller's stack, so the message text
+					// has to be rendered here.  Everything else is left to the writer thread.
+					vsnprintf(record.m_text, sizeof(record.m_text), _format, *_args);
+				}
+				ring->m_head.store(head + 1);
+				m_asyncRecords++;
+
+				// Only wake the writer thread if it has gone to sleep
+				if (m_writerIdle.load() && m_writerIdle.exchange(false))
+				{
+					pthread_mutex_lock(&m_writerMutex);
+					pthread_cond_signal(&m_writerCond);
+					pthread_mutex_unlock(&m_writerMutex);
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::AsyncWriterProc>
+//	Writer thread: drain the producer queues and sleep when they are empty
+//-----------------------------------------------------------------------------
+			void* LogImpl::AsyncWriterProc(void* _context)
+			{
+				LogImpl* impl = (LogImpl*) _context;
+				while (1)
+				{
+					if (impl->DrainAsync())
+					{
+						continue;
+					}
+					if (impl->m_writerStop)
+					{
+						break;
+					}
+
+					impl->m_writerIdle = true;
+					// Recheck after publishing the idle flag so a producer cannot slip in unseen
+					if (!impl->DrainAsync())
+					{
+						pthread_mutex_lock(&impl->m_writerMutex);
+						if (impl->m_writerIdle && !impl->m_writerStop)
+						{
+							struct timespec ts;
+							clock_gettime(CLOCK_REALTIME, &ts);
+							ts.tv_nsec += c_asyncIdleNs;
+							if (ts.tv_nsec >= 1000000000)
+							{
+								ts.tv_sec++;
+								ts.tv_nsec -= 1000000000;
+							}
+							pthread_cond_timedwait(&impl->m_writerCond, &impl->m_writerMutex, &ts);
+						}
+						pthread_mutex_unlock(&impl->m_writerMutex);
+					}
+					impl->m_writerIdle = false;
+				}
+
+				// Pick up anything queued while we were shutting down
+				impl->DrainAsync();
+				return NULL;
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::DrainAsync>
+//	Write out every queued record, oldest first across all producer threads
+//-----------------------------------------------------------------------------
+			bool LogImpl::DrainAsync()
+			{
+				uint32 depth = 0;
+				for (AsyncRing* ring = m_rings.load(); ring != NULL; ring = ring->m_next)
+				{
+					depth += ring->m_head.load() - ring->m_tail.load(std::memory_order_relaxed);
+				}
+				if (depth > m_asyncDepthMax.load(std::memory_order_relaxed))
+				{
+					m_asyncDepthMax = depth;
+				}
+
+				bool processed = false;
+				while (1)
+				{
+					AsyncRing* oldest = NULL;
+					uint64 oldestSeq = 0;
+					for (AsyncRing* ring = m_rings.load(); ring != NULL; ring = ring->m_next)
+					{
+						uint32 tail = ring->m_tail.load(std::memory_order_relaxed);
+						if (tail == ring->m_head.load(std::memory_order_acquire))
+						{
+							continue;
+						}
+						AsyncRecord const& record = ring->m_records[tail & (AsyncRing::Size - 1)];
+						if ((oldest == NULL) || (record.m_seq < oldestSeq))
+						{
+							oldest = ring;
+							oldestSeq = record.m_seq;
+						}
+					}
+					if (oldest == NULL)
+					{
+						break;
+					}
+
+					uint32 tail = oldest->m_tail.load(std::memory_order_relaxed);
+					WriteAsyncRecord(oldest->m_records[tail & (AsyncRing::Size - 1)]);
+					oldest->m_tail.store(tail + 1, std::memory_order_release);
+					processed = true;
+				}
+
+				FlushAsync();
+				return processed;
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteAsyncRecord>
+//	Writer thread equivalent of Write, QueueDump and QueueClear
+//-----------------------------------------------------------------------------
+			void LogImpl::WriteAsyncRecord(AsyncRecord const& _record)
+			{
+				switch (_record.m_type)
+				{
+					case AsyncRecord::Type_QueueDump:
+					{
+						DumpQueueAsync(_record.m_time);
+						return;
+					}
+					case AsyncRecord::Type_QueueClear:
+					{
+						m_logQueue.clear();
+						return;
+					}
+					default:
+						break;
+				}
+
+				LogLevel level = _record.m_level;
+				if ((level <= m_queueLevel) || (level == LogLevel_Internal))
+				{
+					if ((level <= m_saveLevel) || (level == LogLevel_Internal))
+					{
+						WriteAsyncLine(level, _record.m_time, _record.m_nodeId, _record.m_text);
+					}
+
+					if (level != LogLevel_Internal)
+					{
+						char timeBuf[100];
+						char threadBuf[20];
+						FormatTimeStamp(_record.m_time, timeBuf, sizeof(timeBuf));
+						snprintf(threadBuf, sizeof(threadBuf), "%08lx ", _record.m_threadId);
+						string queueStr = timeBuf;
+						queueStr.append(threadBuf);
+						queueStr.append(_record.m_text);
+						Queue(queueStr.c_str());
+					}
+				}
+
+				// now check to see if the _dumpTrigger has been hit
+				if ((level <= m_dumpTrigger) && (level != LogLevel_Internal) && (level != LogLevel_Always))
+					DumpQueueAsync(_record.m_time);
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::DumpQueueAsync>
+//	Writer thread equivalent of QueueDump
+//-----------------------------------------------------------------------------
+			void LogImpl::DumpQueueAsync(struct timeval const& _time)
+			{
+				WriteAsyncLine(LogLevel_Always, _time, 0, "");
+				WriteAsyncLine(LogLevel_Always, _time, 0, "Dumping queued log messages");
+				WriteAsyncLine(LogLevel_Always, _time, 0, "");
+				for (list<string>::iterator it = m_logQueue.begin(); it != m_logQueue.end(); ++it)
+				{
+					WriteAsyncLine(LogLevel_Internal, _time, 0, it->c_str());
+				}
+				m_logQueue.clear();
+				WriteAsyncLine(LogLevel_Always, _time, 0, "");
+				WriteAsyncLine(LogLevel_Always, _time, 0, "End of queued log message dump");
+				WriteAsyncLine(LogLevel_Always, _time, 0, "");
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteAsyncLine>
+//	Append one formatted line to the writer thread's output batches
+//-----------------------------------------------------------------------------
+			void LogImpl::WriteAsyncLine(LogLevel _level, struct timeval const& _time, uint8 const _nodeId, char const* _text)
+			{
+				if (this->pFile == NULL && !m_bConsoleOutput)
+				{
+					return;
+				}
+
+				char prefix[160] =
+				{ 0 };
+				if (_level != LogLevel_Internal)	// queued messages already carry their own timestamp
+				{
+					char timeBuf[100];
+					FormatTimeStamp(_time, timeBuf, sizeof(timeBuf));
+					char const* levelStr = ((_level >= LogLevel_None) && (_level <= LogLevel_Internal)) ? LogLevelString[_level] : "Unknown";
+					if (_nodeId == 0)
+						snprintf(prefix, sizeof(prefix), "%s%s, ", timeBuf, levelStr);
+					else if (_nodeId == 255)
+						snprintf(prefix, sizeof(prefix), "%s%s, contrlr, ", timeBuf, levelStr);
+					else
+						snprintf(prefix, sizeof(prefix), "%s%s, Node%03d, ", timeBuf, levelStr, _nodeId);
+				}
+
+				if (this->pFile != NULL)
+				{
+					m_fileBuf.append(prefix);
+					m_fileBuf.append(_text);
+					m_fileBuf.append("\n");
+				}
+				if (m_bConsoleOutput)
+				{
+					char escape[16];
+					snprintf(escape, sizeof(escape), "\x1B[%02um", toEscapeCode(_level));
+					m_consoleBuf.append(escape);
+					m_consoleBuf.append(prefix);
+					m_consoleBuf.append(_text);
+					m_consoleBuf.append("\n");
+					/* always return to normal */
+					snprintf(escape, sizeof(escape), "\x1b[39m\x1B[%02um", toEscapeCode(LogLevel_Info));
+					m_consoleBuf.append(escape);
+				}
+
+				if ((m_fileBuf.size() >= c_asyncFlushSize) || (m_consoleBuf.size() >= c_asyncFlushSize))
+				{
+					FlushAsync();
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::FlushAsync>
+//	Hand the batched output to the kernel with as few write() calls as possible
+//-----------------------------------------------------------------------------
+			void LogImpl::FlushAsync()
+			{
+				if (!m_fileBuf.empty())
+				{
+					WriteAll(fileno(this->pFile), m_fileBuf);
+				}
+				if (!m_consoleBuf.empty())
+				{
+					WriteAll(fileno(stdout), m_consoleBuf);
+				}
+			}
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
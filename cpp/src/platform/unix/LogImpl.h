@@ -32,7 +32,9 @@
 #include <stdarg.h>
 #include <time.h>
 #include <sys/time.h>
+#include <pthread.h>
 #include <list>
+#include <atomic>
 #include "platform/Log.h"
 
 namespace OpenZWave
@@ -63,14 +65,81 @@ namespace OpenZWave
 					string GetLogLevelString(LogLevel _level);
 					unsigned int toEscapeCode(LogLevel _level);
 
+					//-----------------------------------------------------------------------------
+					// Asynchronous logging
+					//-----------------------------------------------------------------------------
+					/** A single log line (or queue command) captured by a producer thread */
+					struct AsyncRecord
+					{
+							enum Type
+							{
+								Type_Line,
+								Type_QueueDump,
+								Type_QueueClear
+							};
+							uint64 m_seq;
+							struct timeval m_time;
+							unsigned long m_threadId;
+							LogLevel m_level;
+							uint8 m_nodeId;
+							uint8 m_type;
+							char m_text[1024];
+					};
+
+					/** Single producer/single consumer ring owned by one producer thread */
+					struct AsyncRing
+					{
+							enum
+							{
+								Size = 128 /**< must be a power of two */
+							};
+							AsyncRecord m_records[Size];
+							std::atomic<uint32> m_head;	/**< next slot the producer will fill */
+							std::atomic<uint32> m_tail;	/**< next slot the writer will read */
+							std::atomic<bool> m_inUse;	/**< false once the owning thread has exited */
+							AsyncRing* m_next;
+					};
+
+					bool SetAsync(bool _async);
+					bool IsAsync() const
+					{
+						return m_async;
+					}
+					void GetAsyncStatistics(Log::AsyncStatistics* _data);
+
+					AsyncRing* GetThreadRing();
+					void PushAsync(AsyncRecord::Type _type, LogLevel _level, uint8 const _nodeId, char const* _format, va_list* _args);
+					bool DrainAsync();
+					void WriteAsyncRecord(AsyncRecord const& _record);
+					void DumpQueueAsync(struct timeval const& _time);
+					void WriteAsyncLine(LogLevel _level, struct timeval const& _time, uint8 const _nodeId, char const* _text);
+					void FlushAsync();
+					static void* AsyncWriterProc(void* _context);
+					static void AsyncRingRelease(void* _ring);
+
 					string m_filename; /**< filename specified by user (default is ozw_log.txt) */
 					bool m_bConsoleOutput; /**< if true, send log output to console as well as to the file */
 					bool m_bAppendLog; /**< if true, the log file should be appended to any with the same name */
 					list<string> m_logQueue; /**< list of queued log messages */
-					LogLevel m_saveLevel;
-					LogLevel m_queueLevel;
-					LogLevel m_dumpTrigger;
+					std::atomic<LogLevel> m_saveLevel; /**< read by the writer thread while SetLoggingState changes them */
+					std::atomic<LogLevel> m_queueLevel;
+					std::atomic<LogLevel> m_dumpTrigger;
 					FILE* pFile;
+
+					bool m_async; /**< true while the background writer thread owns the output */
+					pthread_t m_writerThread;
+					pthread_mutex_t m_writerMutex;
+					pthread_cond_t m_writerCond;
+					pthread_key_t m_ringKey; /**< maps each producer thread to its AsyncRing */
+					std::atomic<AsyncRing*> m_rings; /**< lock-free list of every ring ever handed out */
+					std::atomic<uint64> m_seq;
+					std::atomic<bool> m_writerIdle;
+					std::atomic<bool> m_writerStop;
+					std::atomic<uint64> m_asyncRecords;
+					std::atomic<uint64> m_asyncDropped;
+					std::atomic<uint32> m_asyncDepthMax;
+					string m_fileBuf; /**< batched output, only touched by the writer thread */
+					string m_consoleBuf;
 			};
 		} // namespace Platform
 	} // namespace Internal
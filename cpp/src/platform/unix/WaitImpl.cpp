@@ -33,6 +33,14 @@
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#else
+#include <poll.h>
+#endif
 
 namespace OpenZWave
 {
@@ -150,6 +158,119 @@ namespace OpenZWave
 					assert(0);
 				}
 			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::WaitSetImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+			WaitSetImpl::WaitSetImpl()
+			{
+#ifdef __linux__
+				m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+				m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+				if ((m_eventFd < 0) || (m_epollFd < 0))
+				{
+					fprintf(stderr, "WaitSetImpl::WaitSetImpl eventfd/epoll error %s\n", strerror(errno));
+					assert(0);
+				}
+				struct epoll_event ev;
+				memset(&ev, 0, sizeof(ev));
+				ev.events = EPOLLIN;
+				ev.data.fd = m_eventFd;
+				if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_eventFd, &ev) != 0)
+				{
+					fprintf(stderr, "WaitSetImpl::WaitSetImpl epoll_ctl error %s\n", strerror(errno));
+					assert(0);
+				}
+#else
+				if (pipe(m_pipe) != 0)
+				{
+					fprintf(stderr, "WaitSetImpl::WaitSetImpl pipe error %s\n", strerror(errno));
+					assert(0);
+				}
+				for (int i = 0; i < 2; ++i)
+				{
+					fcntl(m_pipe[i], F_SETFL, fcntl(m_pipe[i], F_GETFL) | O_NONBLOCK);
+					fcntl(m_pipe[i], F_SETFD, FD_CLOEXEC);
+				}
+#endif
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::~WaitSetImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+			WaitSetImpl::~WaitSetImpl()
+			{
+#ifdef __linux__
+				close(m_epollFd);
+				close(m_eventFd);
+#else
+				close(m_pipe[0]);
+				close(m_pipe[1]);
+#endif
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Signal>
+//	Wake up the thread waiting on the set.  Called from the watcher callbacks,
+//	so it must not block or take any locks.
+//-----------------------------------------------------------------------------
+			void WaitSetImpl::Signal()
+			{
+#ifdef __linux__
+				uint64_t one = 1;
+				ssize_t res = write(m_eventFd, &one, sizeof(one));
+#else
+				char one = 1;
+				ssize_t res = write(m_pipe[1], &one, sizeof(one));
+#endif
+				// EAGAIN means a wake-up is already pending, which is all we need
+				if ((res < 0) && (errno != EAGAIN) && (errno != EINTR))
+				{
+					fprintf(stderr, "WaitSetImpl::Signal write error %s\n", strerror(errno));
+				}
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Wait>
+//	Wait for a wake-up and consume it.  Returns false if the wait timed out.
+//	An interrupted wait is reported as a wake-up, the caller re-checks anyway.
+//-----------------------------------------------------------------------------
+			bool WaitSetImpl::Wait(int32 _timeout)
+			{
+#ifdef __linux__
+				struct epoll_event ev;
+				int res = epoll_wait(m_epollFd, &ev, 1, _timeout);
+				if (res > 0)
+				{
+					uint64_t count;
+					if (read(m_eventFd, &count, sizeof(count)) < 0)
+					{
+						// Another reader may have consumed it, or we were interrupted.  Nothing lost.
+					}
+				}
+#else
+				struct pollfd pfd;
+				pfd.fd = m_pipe[0];
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+				int res = poll(&pfd, 1, _timeout);
+				if (res > 0)
+				{
+					char buf[64];
+					while (read(m_pipe[0], buf, sizeof(buf)) > 0)
+					{
+					}
+				}
+#endif
+				if ((res < 0) && (errno != EINTR))
+				{
+					fprintf(stderr, "WaitSetImpl::Wait error %s\n", strerror(errno));
+					assert(0);
+				}
+				return (res != 0);
+			}
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
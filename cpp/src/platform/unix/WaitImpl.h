@@ -71,6 +71,33 @@ namespace OpenZWave
 					Wait* m_owner;
 					pthread_mutex_t m_criticalSection;
 			};
+
+			/** \brief POSIX specific implementation of the WaitSet wake-up object.
+			 *
+			 * On Linux this is an eventfd registered once in an epoll set.  Other
+			 * systems use a non-blocking pipe and poll().
+			 */
+			class WaitSetImpl
+			{
+				private:
+					friend class WaitSet;
+
+					WaitSetImpl();
+					~WaitSetImpl();
+
+					void Signal();
+					bool Wait(int32 _timeout);
+
+					WaitSetImpl(WaitSetImpl const&);				// prevent copy
+					WaitSetImpl& operator =(WaitSetImpl const&);	// prevent assignment
+
+#ifdef __linux__
+					int m_epollFd;
+					int m_eventFd;
+#else
+					int m_pipe[2];
+#endif
+			};
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------
 
 #include <windows.h>
+#include <atomic>
 #include "FileOpsImpl.h"
 #include "Utils.h"
 
@@ -81,6 +82,21 @@ namespace OpenZWave
 				return (fad.dwFileAttributes != INVALID_FILE_ATTRIBUTES && !(fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY));
 			}
 
+			bool FileOpsImpl::FileStatus(const string _filename, uint64 *_modified, uint64 *_size)
+			{
+				WIN32_FILE_ATTRIBUTE_DATA fad =
+				{ 0 };
+				wstring wFileName(_filename.begin(), _filename.end());
+
+				if (0 == GetFileAttributesEx(wFileName.c_str(), GetFileExInfoStandard, &fad))
+				{
+					return false;
+				}
+				*_modified = ((uint64) fad.ftLastWriteTime.dwHighDateTime << 32) | fad.ftLastWriteTime.dwLowDateTime;
+				*_size = ((uint64) fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+				return true;
+			}
+
 			bool FileOpsImpl::FileWriteable(const string _filename)
 			{
 				WIN32_FILE_ATTRIBUTE_DATA fad =
@@ -165,6 +181,83 @@ namespace OpenZWave
 				return true;
 			}
 
+			bool FileOpsImpl::FileWriteAtomic(const string _filename, const string& _contents)
+			{
+				/* write everything to a temporary file next to the target first.  The name is
+				 * unique to this process and call, so two writers never share a temporary file */
+				static std::atomic<uint32> s_tmpCount(0);
+				char suffix[32];
+				snprintf(suffix, sizeof(suffix), ".%lu.%u.tmp", (unsigned long) GetCurrentProcessId(), (unsigned) ++s_tmpCount);
+				string tmpFile = _filename + suffix;
+				wstring wTmpFileName(tmpFile.begin(), tmpFile.end());
+				wstring wFileName(_filename.begin(), _filename.end());
+				HANDLE hFile = CreateFile2(wTmpFileName.c_str(), GENERIC_WRITE, 0, CREATE_ALWAYS, NULL);
+				if (hFile == INVALID_HANDLE_VALUE)
+				{
+					Log::Write(LogLevel_Warning, "Can't create %s", tmpFile.c_str());
+					return false;
+				}
+				DWORD written = 0;
+				BOOL ok = WriteFile(hFile, _contents.data(), (DWORD) _contents.size(), &written, NULL) && (written == _contents.size());
+				/* the data must be on disk before the move makes it visible */
+				ok = ok && FlushFileBuffers(hFile);
+				CloseHandle(hFile);
+				if (!ok)
+				{
+					Log::Write(LogLevel_Warning, "Write to %s failed", tmpFile.c_str());
+					DeleteFileW(wTmpFileName.c_str());
+					return false;
+				}
+				if (MoveFileExW(wTmpFileName.c_str(), wFileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0)
+				{
+					Log::Write(LogLevel_Warning, "MoveFile Failed %s - %s", tmpFile.c_str(), _filename.c_str());
+					DeleteFileW(wTmpFileName.c_str());
+					return false;
+				}
+				return true;
+			}
+
+			bool FileOpsImpl::FileMap(const string _filename, char const **_data, uint64 *_size)
+			{
+				wstring wFileName(_filename.begin(), _filename.end());
+				HANDLE hFile = CreateFile2(wFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL);
+				if (hFile == INVALID_HANDLE_VALUE)
+				{
+					return false;
+				}
+				FILE_STANDARD_INFO info;
+				if (!GetFileInformationByHandleEx(hFile, FileStandardInfo, &info, sizeof(info)))
+				{
+					CloseHandle(hFile);
+					return false;
+				}
+				*_data = NULL;
+				*_size = (uint64) info.EndOfFile.QuadPart;
+				if (*_size > 0)
+				{
+					HANDLE hMapping = CreateFileMappingFromApp(hFile, NULL, PAGE_READONLY, 0, NULL);
+					if (hMapping != NULL)
+					{
+						*_data = (char const*) MapViewOfFileFromApp(hMapping, FILE_MAP_READ, 0, 0);
+						/* the view keeps the mapping open */
+						CloseHandle(hMapping);
+					}
+					if (*_data == NULL)
+					{
+						Log::Write(LogLevel_Warning, "Can't map %s", _filename.c_str());
+						CloseHandle(hFile);
+						return false;
+					}
+				}
+				CloseHandle(hFile);
+				return true;
+			}
+
+			void FileOpsImpl::FileUnmap(char const *_data, uint64 _size)
+			{
+				UnmapViewOfFile(_data);
+			}
+
 			bool FileOpsImpl::FolderCreate(const string _dirname)
 			{
 				if (FolderExists(_dirname))
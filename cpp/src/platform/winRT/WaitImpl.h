@@ -71,6 +71,25 @@ namespace OpenZWave
 					Wait* m_owner;
 					CRITICAL_SECTION m_criticalSection;
 			};
+
+			/** \brief WinRT specific implementation of the WaitSet wake-up object (an auto-reset event).
+			 */
+			class WaitSetImpl
+			{
+				private:
+					friend class WaitSet;
+
+					WaitSetImpl();
+					~WaitSetImpl();
+
+					void Signal();
+					bool Wait(int32 _timeout);
+
+					WaitSetImpl(WaitSetImpl const&);				// prevent copy
+					WaitSetImpl& operator =(WaitSetImpl const&);	// prevent assignment
+
+					HANDLE m_hEvent;
+			};
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
@@ -27,6 +27,7 @@
 //-----------------------------------------------------------------------------
 
 #include <windows.h>
+#include <atomic>
 #include "FileOpsImpl.h"
 #include "Utils.h"
 
@@ -75,6 +76,19 @@ namespace OpenZWave
 				return (dwAttrib != INVALID_FILE_ATTRIBUTES && !(dwAttrib & FILE_ATTRIBUTE_DIRECTORY));
 			}
 
+			bool FileOpsImpl::FileStatus(const string _filename, uint64 *_modified, uint64 *_size)
+			{
+				WIN32_FILE_ATTRIBUTE_DATA fad =
+				{ 0 };
+				if (0 == GetFileAttributesExA(_filename.c_str(), GetFileExInfoStandard, &fad))
+				{
+					return false;
+				}
+				*_modified = ((uint64) fad.ftLastWriteTime.dwHighDateTime << 32) | fad.ftLastWriteTime.dwLowDateTime;
+				*_size = ((uint64) fad.nFileSizeHigh << 32) | fad.nFileSizeLow;
+				return true;
+			}
+
 			bool FileOpsImpl::FileWriteable(const string _filename)
 			{
 				DWORD dwAttrib;
@@ -149,6 +163,80 @@ namespace OpenZWave
 				return true;
 			}
 
+			bool FileOpsImpl::FileWriteAtomic(const string _filename, const string& _contents)
+			{
+				/* write everything to a temporary file next to the target first.  The name is
+				 * unique to this process and call, so two writers never share a temporary file */
+				static std::atomic<uint32> s_tmpCount(0);
+				char suffix[32];
+				snprintf(suffix, sizeof(suffix), ".%lu.%u.tmp", (unsigned long) GetCurrentProcessId(), (unsigned) ++s_tmpCount);
+				string tmpFile = _filename + suffix;
+				HANDLE hFile = CreateFileA(tmpFile.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+				if (hFile == INVALID_HANDLE_VALUE)
+				{
+					Log::Write(LogLevel_Warning, "Can't create %s", tmpFile.c_str());
+					return false;
+				}
+				DWORD written = 0;
+				BOOL ok = WriteFile(hFile, _contents.data(), (DWORD) _contents.size(), &written, NULL) && (written == _contents.size());
+				/* the data must be on disk before the move makes it visible */
+				ok = ok && FlushFileBuffers(hFile);
+				CloseHandle(hFile);
+				if (!ok)
+				{
+					Log::Write(LogLevel_Warning, "Write to %s failed", tmpFile.c_str());
+					DeleteFileA(tmpFile.c_str());
+					return false;
+				}
+				if (MoveFileExA(tmpFile.c_str(), _filename.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0)
+				{
+					Log::Write(LogLevel_Warning, "MoveFile Failed %s - %s", tmpFile.c_str(), _filename.c_str());
+					DeleteFileA(tmpFile.c_str());
+					return false;
+				}
+				return true;
+			}
+
+			bool FileOpsImpl::FileMap(const string _filename, char const **_data, uint64 *_size)
+			{
+				HANDLE hFile = CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+				if (hFile == INVALID_HANDLE_VALUE)
+				{
+					return false;
+				}
+				LARGE_INTEGER size;
+				if (!GetFileSizeEx(hFile, &size))
+				{
+					CloseHandle(hFile);
+					return false;
+				}
+				*_data = NULL;
+				*_size = (uint64) size.QuadPart;
+				if (*_size > 0)
+				{
+					HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+					if (hMapping != NULL)
+					{
+						*_data = (char const*) MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+						/* the view keeps the mapping open */
+						CloseHandle(hMapping);
+					}
+					if (*_data == NULL)
+					{
+						Log::Write(LogLevel_Warning, "Can't map %s", _filename.c_str());
+						CloseHandle(hFile);
+						return false;
+					}
+				}
+				CloseHandle(hFile);
+				return true;
+			}
+
+			void FileOpsImpl::FileUnmap(char const *_data, uint64 _size)
+			{
+				UnmapViewOfFile(_data);
+			}
+
 			bool FileOpsImpl::FolderCreate(const string _dirname)
 			{
 				if (FolderExists(_dirname))
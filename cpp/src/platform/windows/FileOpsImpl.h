@@ -50,9 +50,13 @@ namespace OpenZWave
 
 					bool FolderExists(const string &_filename);
 					bool FileExists(const string _filename);
+					bool FileStatus(const string _filename, uint64 *_modified, uint64 *_size);
 					bool FileWriteable(const string _filename);
 					bool FileRotate(const string _filename);
 					bool FileCopy(const string, const string);
+					bool FileWriteAtomic(const string _filename, const string& _contents);
+					bool FileMap(const string _filename, char const **_data, uint64 *_size);
+					void FileUnmap(char const *_data, uint64 _size);
 					bool FolderCreate(const string _dirname);
 
 			};
@@ -122,6 +122,42 @@ namespace OpenZWave
 
 				LeaveCriticalSection(&m_criticalSection);
 			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::WaitSetImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+			WaitSetImpl::WaitSetImpl()
+			{
+				m_hEvent = ::CreateEvent( NULL, FALSE, FALSE, NULL);
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::~WaitSetImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+			WaitSetImpl::~WaitSetImpl()
+			{
+				::CloseHandle(m_hEvent);
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Signal>
+//	Wake up the thread waiting on the set
+//-----------------------------------------------------------------------------
+			void WaitSetImpl::Signal()
+			{
+				::SetEvent(m_hEvent);
+			}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Wait>
+//	Wait for a wake-up and consume it.  Returns false if the wait timed out.
+//-----------------------------------------------------------------------------
+			bool WaitSetImpl::Wait(int32 _timeout)
+			{
+				return (WAIT_OBJECT_0 == ::WaitForSingleObject(m_hEvent, (_timeout < 0) ? INFINITE : (DWORD) _timeout));
+			}
 		} // namespace Platform
 	} // namespace Internal
 } // namespace OpenZWave
@@ -33,10 +33,13 @@
 #include "Notification.h"
 #include "Msg.h"
 #include "Bitfield.h"
+#include "BlockPool.h"
 #include "value_classes/Value.h"
+#include "value_classes/ValueSnapshotTable.h"
 #include "platform/Log.h"
 #include "command_classes/CommandClass.h"
 #include <ctime>
+#include <mutex>
 #include "Options.h"
 
 namespace OpenZWave
@@ -52,6 +55,53 @@ namespace OpenZWave
 			static char const* c_typeName[] =
 			{ "bool", "byte", "decimal", "int", "list", "schedule", "short", "string", "button", "raw", "bitset", "invalid type" };
 
+			namespace
+			{
+				// Values are pooled in size classes this many bytes apart.  Anything
+				// larger than the biggest class comes straight from the heap.
+				size_t const c_valueSizeStep = 16;
+				uint32 const c_valueSizeClasses = 32;
+				uint32 const c_valuesPerSlab = 64;
+
+				struct ValuePools
+				{
+						ValuePools()
+						{
+							for (uint32 i = 0; i < c_valueSizeClasses; ++i)
+							{
+								m_pools[i] = NULL;
+							}
+						}
+						std::mutex m_mutex;
+						BlockPool* m_pools[c_valueSizeClasses];		// Created on first use
+				};
+
+				ValuePools& GetValuePools()
+				{
+					// Never destroyed, so values can still be freed during static destruction
+					static ValuePools* pools = new ValuePools();
+					return *pools;
+				}
+
+				BlockPool* GetValuePool(size_t const _size)
+				{
+					uint32 sizeClass = (uint32) ((_size + c_valueSizeStep - 1) / c_valueSizeStep);
+					if ((sizeClass == 0) || (sizeClass > c_valueSizeClasses))
+					{
+						return NULL;
+					}
+
+					ValuePools& pools = GetValuePools();
+					std::lock_guard<std::mutex> lock(pools.m_mutex);
+					BlockPool*& pool = pools.m_pools[sizeClass - 1];
+					if (!pool)
+					{
+						pool = new BlockPool(sizeClass * c_valueSizeStep, c_valuesPerSlab);
+					}
+					return pool;
+				}
+			}
+
 //-----------------------------------------------------------------------------
 // <Value::Value>
 // Constructor
@@ -87,6 +137,63 @@ namespace OpenZWave
 				}
 			}
 
+//-----------------------------------------------------------------------------
+// <Value::operator new>
+// Take a block from the pool for this size of value
+//-----------------------------------------------------------------------------
+			void* Value::operator new(size_t _size)
+			{
+				if (BlockPool* pool = GetValuePool(_size))
+				{
+					return pool->Allocate();
+				}
+				return ::operator new(_size);
+			}
+
+//-----------------------------------------------------------------------------
+// <Value::operator delete>
+// Return a block to its pool.  The destructor is virtual, so _size is the
+// size of the derived class that was allocated.
+//-----------------------------------------------------------------------------
+			void Value::operator delete(void* _ptr, size_t _size)
+			{
+				if (!_ptr)
+				{
+					return;
+				}
+				if (BlockPool* pool = GetValuePool(_size))
+				{
+					pool->Free(_ptr);
+					return;
+				}
+				::operator delete(_ptr);
+			}
+
+//-----------------------------------------------------------------------------
+// <Value::GetPoolStatistics>
+// Add up the statistics of the value pools
+//-----------------------------------------------------------------------------
+			void Value::GetPoolStatistics(uint32* o_allocations, uint32* o_slabs, uint32* o_inUse)
+			{
+				*o_allocations = 0;
+				*o_slabs = 0;
+				*o_inUse = 0;
+
+				ValuePools& pools = GetValuePools();
+				std::lock_guard<std::mutex> lock(pools.m_mutex);
+				for (uint32 i = 0; i < c_valueSizeClasses; ++i)
+				{
+					if (BlockPool* pool = pools.m_pools[i])
+					{
+						uint32 allocations, slabs, inUse;
+						pool->GetStatistics(&allocations, &slabs, &inUse);
+						*o_allocations += allocations;
+						*o_slabs += slabs;
+						*o_inUse += inUse;
+					}
+				}
+			}
+
 //-----------------------------------------------------------------------------
 // <Value::ReadXML>
 // Apply settings from XML
@@ -358,10 +465,9 @@ namespace OpenZWave
 				if (Driver* driver = Manager::Get()->GetDriver(m_id.GetHomeId()))
 				{
 					m_isSet = true;
+					driver->m_valueSnapshots->Publish(this);
 
-					bool bSuppress;
-					Options::Get()->GetOptionAsBool("SuppressValueRefresh", &bSuppress);
-					if (!bSuppress)
+					if (!Options::Get()->GetValues().m_SuppressValueRefresh)
 					{
 						// Notify the watchers
 						Notification* notification = new Notification(Notification::Type_ValueRefreshed);
@@ -385,6 +491,8 @@ namespace OpenZWave
 				if (Driver* driver = Manager::Get()->GetDriver(m_id.GetHomeId()))
 				{
 					m_isSet = true;
+					driver->m_valueSnapshots->Publish(this);
+					driver->MarkCacheDirty(m_id.GetNodeId());
 
 					// Notify the watchers
 					Notification* notification = new Notification(Notification::Type_ValueChanged);
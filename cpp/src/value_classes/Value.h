@@ -60,6 +60,21 @@ namespace OpenZWave
 					Value(uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint16 const _index, ValueID::ValueType const _type, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, bool const _isset, uint8 const _pollIntensity);
 					Value();
 
+					/**
+					 * \brief Values are allocated from pools of fixed size blocks, one pool per size class,
+					 * so the values of a node sit close together instead of being scattered over the heap.
+					 */
+					static void* operator new(size_t _size);
+					static void operator delete(void* _ptr, size_t _size);
+
+					/**
+					 * \brief Get the statistics of the value pools, which are shared by all drivers.
+					 * \param o_allocations receives the number of values allocated since startup.
+					 * \param o_slabs receives the number of slabs taken from the heap for them.
+					 * \param o_inUse receives the number of values that currently exist.
+					 */
+					static void GetPoolStatistics(uint32* o_allocations, uint32* o_slabs, uint32* o_inUse);
+
 					virtual void ReadXML(uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement);
 					virtual void WriteXML(TiXmlElement* _valueElement);
 
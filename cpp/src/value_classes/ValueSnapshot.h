@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueSnapshot.h
+//
+//	A copy of a value that can be read without locking
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ValueSnapshot_H
+#define _ValueSnapshot_H
+
+#include "Defs.h"
+#include "value_classes/ValueID.h"
+
+namespace OpenZWave
+{
+	/** \brief A copy of a value, as returned by Manager::GetValueSnapshot.
+	 *
+	 * Snapshots are published whenever a value is added, refreshed or changed, and can be
+	 * read without taking any lock.  m_version comes from a counter shared by all the values
+	 * of a network, so a reader can remember the highest version it has seen and later ask
+	 * only for what has changed since.
+	 * \ingroup ValueID
+	 */
+	struct ValueSnapshot
+	{
+			enum
+			{
+				TextSize = 64		/**< Size of m_text, including the terminating NUL */
+			};
+
+			ValueID m_id;			/**< The value this is a snapshot of */
+			uint64 m_version;		/**< Increases every time the value is published.  Never zero for a published value. */
+			bool m_isSet;			/**< True once the value has been read from the device or the cache */
+			int32 m_intValue;		/**< The value of a Bool, Byte, Short, Int or BitSet, the selected value of a List, or 1 if a Button is pressed */
+			char m_text[TextSize];	/**< The value as returned by Manager::GetValueAsString, NUL terminated */
+			bool m_textTruncated;	/**< True if m_text was too short for the whole string.  Use Manager::GetValueAsString to get it. */
+	};
+} // namespace OpenZWave
+
+#endif
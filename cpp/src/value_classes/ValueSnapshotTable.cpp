@@ -0,0 +1,355 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueSnapshotTable.cpp
+//
+//	Lock free table of value snapshots
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "value_classes/ValueSnapshotTable.h"
+#include "value_classes/Value.h"
+#include "value_classes/ValueBitSet.h"
+#include "value_classes/ValueBool.h"
+#include "value_classes/ValueButton.h"
+#include "value_classes/ValueByte.h"
+#include "value_classes/ValueInt.h"
+#include "value_classes/ValueList.h"
+#include "value_classes/ValueShort.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace VC
+		{
+			namespace
+			{
+				// Fill in a snapshot from a value
+				void TakeSnapshot(Value const* _value, ValueSnapshot* _snapshot)
+				{
+					_snapshot->m_id = _value->GetID();
+					_snapshot->m_isSet = _value->IsSet();
+					_snapshot->m_intValue = 0;
+
+					string text;
+					switch (_value->GetID().GetType())
+					{
+						case ValueID::ValueType_Bool:
+						{
+							_snapshot->m_intValue = static_cast<ValueBool const*>(_value)->GetValue() ? 1 : 0;
+							text = _value->GetAsString();
+							break;
+						}
+						case ValueID::ValueType_Byte:
+						{
+							_snapshot->m_intValue = static_cast<ValueByte const*>(_value)->GetValue();
+							text = _value->GetAsString();
+							break;
+						}
+						case ValueID::ValueType_Short:
+						{
+							_snapshot->m_intValue = static_cast<ValueShort const*>(_value)->GetValue();
+							text = _value->GetAsString();
+							break;
+						}
+						case ValueID::ValueType_Int:
+						{
+							_snapshot->m_intValue = static_cast<ValueInt const*>(_value)->GetValue();
+							text = _value->GetAsString();
+							break;
+						}
+						case ValueID::ValueType_BitSet:
+						{
+							_snapshot->m_intValue = (int32) static_cast<ValueBitSet const*>(_value)->GetValue();
+							text = _value->GetAsString();
+							break;
+						}
+						case ValueID::ValueType_Button:
+						{
+							_snapshot->m_intValue = static_cast<ValueButton const*>(_value)->IsPressed() ? 1 : 0;
+							text = _value->GetAsString();
+							break;
+						}
+						case ValueID::ValueType_List:
+						{
+							// The selection can be out of range before the list has been read
+							if (ValueList::Item const* item = static_cast<ValueList const*>(_value)->GetItem())
+							{
+								_snapshot->m_intValue = item->m_value;
+								text = item->m_label;
+							}
+							break;
+						}
+						default:
+						{
+							text = _value->GetAsString();
+							break;
+						}
+					}
+
+					size_t length = text.size();
+					_snapshot->m_textTruncated = length >= ValueSnapshot::TextSize;
+					if (_snapshot->m_textTruncated)
+					{
+						length = ValueSnapshot::TextSize - 1;
+					}
+					memcpy(_snapshot->m_text, text.c_str(), length);
+					_snapshot->m_text[length] = 0;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::ValueSnapshotTable>
+// Constructor
+//-----------------------------------------------------------------------------
+			ValueSnapshotTable::ValueSnapshotTable() :
+					m_readers(0), m_version(0)
+			{
+				for (int i = 0; i < 256; ++i)
+				{
+					m_nodes[i] = NULL;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::~ValueSnapshotTable>
+// Destructor
+//-----------------------------------------------------------------------------
+			ValueSnapshotTable::~ValueSnapshotTable()
+			{
+				for (int i = 0; i < 256; ++i)
+				{
+					if (Index* index = m_nodes[i].load())
+					{
+						for (Index::iterator it = index->begin(); it != index->end(); ++it)
+						{
+							delete it->second;
+						}
+						delete index;
+					}
+				}
+				for (vector<Index*>::iterator it = m_retiredIndexes.begin(); it != m_retiredIndexes.end(); ++it)
+				{
+					delete *it;
+				}
+				for (vector<Slot*>::iterator it = m_retiredSlots.begin(); it != m_retiredSlots.end(); ++it)
+				{
+					delete *it;
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::Publish>
+// Add a value to the table, or refresh its snapshot
+//-----------------------------------------------------------------------------
+			void ValueSnapshotTable::Publish(Value const* _value)
+			{
+				ValueSnapshot snapshot;
+				TakeSnapshot(_value, &snapshot);
+
+				uint8 nodeId = snapshot.m_id.GetNodeId();
+				uint32 key = snapshot.m_id.GetValueStoreKey();
+
+				std::lock_guard<std::mutex> lock(m_writeMutex);
+				snapshot.m_version = ++m_version;
+
+				Index* index = m_nodes[nodeId].load();
+				if (Slot* slot = const_cast<Slot*>(Find(index, key)))
+				{
+					// Readers that see an odd or changed sequence will retry
+					uint32 seq = slot->m_seq.load(std::memory_order_relaxed);
+					slot->m_seq.store(seq + 1, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+					slot->m_snapshot = snapshot;
+					slot->m_seq.store(seq + 2, std::memory_order_release);
+					return;
+				}
+
+				// A new value.  The slot is filled in before anyone can see it.
+				Slot* slot = new Slot();
+				slot->m_snapshot = snapshot;
+				Index* newIndex = index ? new Index(*index) : new Index();
+				Index::iterator it = std::lower_bound(newIndex->begin(), newIndex->end(), key, KeyLess);
+				newIndex->insert(it, make_pair(key, slot));
+				m_nodes[nodeId].store(newIndex);
+				Retire(index, NULL);
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::Remove>
+// Remove a value from the table
+//-----------------------------------------------------------------------------
+			void ValueSnapshotTable::Remove(ValueID const& _id)
+			{
+				uint8 nodeId = _id.GetNodeId();
+				uint32 key = _id.GetValueStoreKey();
+
+				std::lock_guard<std::mutex> lock(m_writeMutex);
+				Index* index = m_nodes[nodeId].load();
+				Slot* slot = const_cast<Slot*>(Find(index, key));
+				if (!slot)
+				{
+					return;
+				}
+
+				Index* newIndex = new Index();
+				newIndex->reserve(index->size() - 1);
+				for (Index::const_iterator it = index->begin(); it != index->end(); ++it)
+				{
+					if (it->second != slot)
+					{
+						newIndex->push_back(*it);
+					}
+				}
+				m_nodes[nodeId].store(newIndex);
+				Retire(index, slot);
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::Get>
+// Copy the snapshot of one value
+//-----------------------------------------------------------------------------
+			bool ValueSnapshotTable::Get(ValueID const& _id, ValueSnapshot* o_snapshot) const
+			{
+				bool res = false;
+				m_readers++;
+				if (Slot const* slot = Find(m_nodes[_id.GetNodeId()].load(), _id.GetValueStoreKey()))
+				{
+					Read(slot, o_snapshot);
+					res = (o_snapshot->m_id == _id);
+				}
+				m_readers--;
+				return res;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::GetNode>
+// Copy the snapshots of a node's values that changed after _sinceVersion
+//-----------------------------------------------------------------------------
+			uint32 ValueSnapshotTable::GetNode(uint8 const _nodeId, uint64 const _sinceVersion, vector<ValueSnapshot>* o_snapshots) const
+			{
+				uint32 count = 0;
+				m_readers++;
+				if (Index const* index = m_nodes[_nodeId].load())
+				{
+					ValueSnapshot snapshot;
+					for (Index::const_iterator it = index->begin(); it != index->end(); ++it)
+					{
+						Read(it->second, &snapshot);
+						if (snapshot.m_version > _sinceVersion)
+						{
+							o_snapshots->push_back(snapshot);
+							++count;
+						}
+					}
+				}
+				m_readers--;
+				return count;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::KeyLess>
+// Orders index entries by value store key
+//-----------------------------------------------------------------------------
+			bool ValueSnapshotTable::KeyLess(pair<uint32, Slot*> const& _entry, uint32 const _key)
+			{
+				return _entry.first < _key;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::Find>
+// Look up a value's slot in a node index
+//-----------------------------------------------------------------------------
+			ValueSnapshotTable::Slot const* ValueSnapshotTable::Find(Index const* _index, uint32 const _key)
+			{
+				if (!_index)
+				{
+					return NULL;
+				}
+				Index::const_iterator it = std::lower_bound(_index->begin(), _index->end(), _key, KeyLess);
+				if (it != _index->end() && it->first == _key)
+				{
+					return it->second;
+				}
+				return NULL;
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::Read>
+// Copy a slot, retrying while a writer is updating it
+//-----------------------------------------------------------------------------
+			void ValueSnapshotTable::Read(Slot const* _slot, ValueSnapshot* o_snapshot)
+			{
+				while (true)
+				{
+					uint32 seq = _slot->m_seq.load(std::memory_order_acquire);
+					if (seq & 1)
+					{
+						std::this_thread::yield();
+						continue;
+					}
+					*o_snapshot = _slot->m_snapshot;
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (_slot->m_seq.load(std::memory_order_relaxed) == seq)
+					{
+						return;
+					}
+				}
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueSnapshotTable::Retire>
+// Queue an index and slot that readers may still be using, and free
+// everything queued once there are no readers.  Call with m_writeMutex held,
+// after the replacement has been stored.
+//-----------------------------------------------------------------------------
+			void ValueSnapshotTable::Retire(Index* _index, Slot* _slot)
+			{
+				if (_index)
+				{
+					m_retiredIndexes.push_back(_index);
+				}
+				if (_slot)
+				{
+					m_retiredSlots.push_back(_slot);
+				}
+
+				// A reader that arrives after this check loads the new index
+				if (m_readers.load() == 0)
+				{
+					for (vector<Index*>::iterator it = m_retiredIndexes.begin(); it != m_retiredIndexes.end(); ++it)
+					{
+						delete *it;
+					}
+					m_retiredIndexes.clear();
+					for (vector<Slot*>::iterator it = m_retiredSlots.begin(); it != m_retiredSlots.end(); ++it)
+					{
+						delete *it;
+					}
+					m_retiredSlots.clear();
+				}
+			}
+		} // namespace VC
+	} // namespace Internal
+} // namespace OpenZWave
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueSnapshotTable.h
+//
+//	Lock free table of value snapshots
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ValueSnapshotTable_H
+#define _ValueSnapshotTable_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Defs.h"
+#include "value_classes/ValueSnapshot.h"
+
+namespace OpenZWave
+{
+	namespace Internal
+	{
+		namespace VC
+		{
+			class Value;
+
+			/** \brief Holds a snapshot of every value of a network, for readers that must not take the node lock.
+			 *
+			 * Each value has a slot guarded by a sequence lock.  A writer makes the sequence
+			 * odd, updates the slot and makes it even again, and a reader retries its copy if the
+			 * sequence was odd or moved while it read.  The slots of each node are found through
+			 * an immutable sorted index that is replaced whenever a value is added or removed.
+			 * Replaced indexes and removed slots are only freed when no reader is inside the
+			 * table, so a reader never follows a dangling pointer.
+			 * \ingroup ValueID
+			 */
+			class ValueSnapshotTable
+			{
+				public:
+					ValueSnapshotTable();
+					~ValueSnapshotTable();
+
+					/**
+					 * Add a value to the table, or refresh its snapshot if it is already there.
+					 */
+					void Publish(Value const* _value);
+
+					/**
+					 * Remove a value from the table.
+					 */
+					void Remove(ValueID const& _id);
+
+					/**
+					 * Copy the snapshot of one value.
+					 * \return false if the value is not in the table.
+					 */
+					bool Get(ValueID const& _id, ValueSnapshot* o_snapshot) const;
+
+					/**
+					 * Copy the snapshots of a node's values whose version is greater than _sinceVersion.
+					 * \return the number of snapshots appended to o_snapshots.
+					 */
+					uint32 GetNode(uint8 const _nodeId, uint64 const _sinceVersion, vector<ValueSnapshot>* o_snapshots) const;
+
+				private:
+					struct Slot
+					{
+							Slot() :
+									m_seq(0)
+							{
+							}
+							std::atomic<uint32> m_seq;			// Odd while the snapshot is being written
+							ValueSnapshot m_snapshot;
+					};
+					typedef vector<pair<uint32, Slot*> > Index;	// Slots of one node, sorted by value store key
+
+					static bool KeyLess(pair<uint32, Slot*> const& _entry, uint32 const _key);
+					static Slot const* Find(Index const* _index, uint32 const _key);
+					static void Read(Slot const* _slot, ValueSnapshot* o_snapshot);
+					void Retire(Index* _index, Slot* _slot);
+
+					ValueSnapshotTable(ValueSnapshotTable const&);					// prevent copy
+					ValueSnapshotTable& operator =(ValueSnapshotTable const&);		// prevent assignment
+
+					std::atomic<Index*> m_nodes[256];
+					mutable std::atomic<uint32> m_readers;					// Readers currently inside the table
+					std::mutex m_writeMutex;								// Serializes the writers
+					uint64 m_version;										// Last version handed out
+					vector<Index*> m_retiredIndexes;						// Waiting for the readers to leave
+					vector<Slot*> m_retiredSlots;
+			};
+		} // namespace VC
+	} // namespace Internal
+} // namespace OpenZWave
+
+#endif
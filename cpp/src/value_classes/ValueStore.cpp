@@ -25,8 +25,11 @@
 //
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
+
 #include "value_classes/ValueStore.h"
 #include "value_classes/Value.h"
+#include "value_classes/ValueSnapshotTable.h"
 #include "Manager.h"
 #include "Notification.h"
 #include "Localization.h"
@@ -45,12 +48,10 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			ValueStore::~ValueStore()
 			{
-				map<uint32, Value*>::iterator it = m_values.begin();
+				// Remove from the back, so nothing has to be moved down
 				while (!m_values.empty())
 				{
-					ValueID const& valueId = it->second->GetID();
-					RemoveValue(valueId.GetValueStoreKey());
-					it = m_values.begin();
+					RemoveValue(m_values.back().first);
 				}
 			}
 
@@ -66,14 +67,14 @@ namespace OpenZWave
 				}
 
 				uint32 key = _value->GetID().GetValueStoreKey();
-				map<uint32, Value*>::iterator it = m_values.find(key);
-				if (it != m_values.end())
+				vector<Entry>::iterator it = std::lower_bound(m_values.begin(), m_values.end(), key, CompareKey);
+				if ((it != m_values.end()) && (it->first == key))
 				{
 					// There is already a value in the store with this key, so we give up.
 					return false;
 				}
 
-				m_values[key] = _value;
+				m_values.insert(it, Entry(key, _value));
 				_value->AddRef();
 
 				// Notify the watchers of the new value and Check our GetChangeVerified Flag
@@ -93,6 +94,8 @@ namespace OpenZWave
 							}
 						}
 					}
+					driver->m_valueSnapshots->Publish(_value);
+
 					Notification* notification = new Notification(Notification::Type_ValueAdded);
 					notification->SetValueId(_value->GetID());
 					driver->QueueNotification(notification);
@@ -107,7 +110,7 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			bool ValueStore::RemoveValue(uint32 const& _key)
 			{
-				map<uint32, Value*>::iterator it = m_values.find(_key);
+				vector<Entry>::iterator it = Find(_key);
 				if (it != m_values.end())
 				{
 					Value* value = it->second;
@@ -116,6 +119,7 @@ namespace OpenZWave
 					// First notify the watchers
 					if (Driver* driver = Manager::Get()->GetDriver(valueId.GetHomeId()))
 					{
+						driver->m_valueSnapshots->Remove(valueId);
 						Notification* notification = new Notification(Notification::Type_ValueRemoved);
 						notification->SetValueId(valueId);
 						driver->QueueNotification(notification);
@@ -151,8 +155,10 @@ namespace OpenZWave
 //-----------------------------------------------------------------------------
 			void ValueStore::RemoveCommandClassValues(uint8 const _commandClassId)
 			{
-				map<uint32, Value*>::iterator it = m_values.begin();
-				while (it != m_values.end())
+				// The command class is not part of the store key, so every value has to be checked.
+				// Survivors are moved down in one pass rather than erasing one at a time.
+				vector<Entry>::iterator out = m_values.begin();
+				for (vector<Entry>::iterator it = m_values.begin(); it != m_values.end(); ++it)
 				{
 					Value* value = it->second;
 					ValueID const& valueId = value->GetID();
@@ -163,6 +169,7 @@ namespace OpenZWave
 						// First notify the watchers
 						if (Driver* driver = Manager::Get()->GetDriver(valueId.GetHomeId()))
 						{
+							driver->m_valueSnapshots->Remove(valueId);
 							Notification* notification = new Notification(Notification::Type_ValueRemoved);
 							notification->SetValueId(valueId);
 							driver->QueueNotification(notification);
@@ -170,13 +177,13 @@ namespace OpenZWave
 
 						// Now release and remove the value from the store
 						value->Release();
-						it = m_values.erase(it);
 					}
 					else
 					{
-						++it;
+						*out++ = *it;
 					}
 				}
+				m_values.erase(out, m_values.end());
 			}
 
 //-----------------------------------------------------------------------------
@@ -187,7 +194,7 @@ namespace OpenZWave
 			{
 				Value* value = NULL;
 
-				map<uint32, Value*>::const_iterator it = m_values.find(_key);
+				vector<Entry>::const_iterator it = Find(_key);
 				if (it != m_values.end())
 				{
 					value = it->second;
@@ -202,6 +209,34 @@ namespace OpenZWave
 				return value;
 			}
 
+//-----------------------------------------------------------------------------
+// <ValueStore::Find>
+// Binary search for the entry with a key
+//-----------------------------------------------------------------------------
+			vector<ValueStore::Entry>::iterator ValueStore::Find(uint32 const _key)
+			{
+				vector<Entry>::iterator it = std::lower_bound(m_values.begin(), m_values.end(), _key, CompareKey);
+				if ((it != m_values.end()) && (it->first == _key))
+				{
+					return it;
+				}
+				return m_values.end();
+			}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::Find>
+// Binary search for the entry with a key
+//-----------------------------------------------------------------------------
+			vector<ValueStore::Entry>::const_iterator ValueStore::Find(uint32 const _key) const
+			{
+				vector<Entry>::const_iterator it = std::lower_bound(m_values.begin(), m_values.end(), _key, CompareKey);
+				if ((it != m_values.end()) && (it->first == _key))
+				{
+					return it;
+				}
+				return m_values.end();
+			}
+
 		} // namespace VC
 	} // namespace Internal
 } // namespace OpenZWave
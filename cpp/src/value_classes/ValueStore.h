@@ -28,7 +28,8 @@
 #ifndef _ValueStore_H
 #define _ValueStore_H
 
-#include <map>
+#include <utility>
+#include <vector>
 #include "Defs.h"
 #include "value_classes/ValueID.h"
 
@@ -44,13 +45,18 @@ namespace OpenZWave
 			class Value;
 
 			/** \brief Container that holds all of the values associated with a given node.
+			 *
+			 * The values are kept in a vector sorted on their store key, so a lookup is a
+			 * binary search over contiguous memory and iterating a node's values does not
+			 * chase tree pointers.  Adding or removing a value invalidates the iterators.
 			 * \ingroup ValueID
 			 */
 			class ValueStore
 			{
 				public:
 
-					typedef map<uint32, Value*>::const_iterator Iterator;
+					typedef pair<uint32, Value*> Entry;
+					typedef vector<Entry>::const_iterator Iterator;
 
 					Iterator Begin()
 					{
@@ -72,8 +78,21 @@ namespace OpenZWave
 
 					void RemoveCommandClassValues(uint8 const _commandClassId);		// Remove all the values associated with a command class
 
+					size_t GetSize() const
+					{
+						return m_values.size();
+					}
+
 				private:
-					map<uint32, Value*> m_values;
+					static bool CompareKey(Entry const& _entry, uint32 const _key)
+					{
+						return _entry.first < _key;
+					}
+
+					vector<Entry>::iterator Find(uint32 const _key);
+					vector<Entry>::const_iterator Find(uint32 const _key) const;
+
+					vector<Entry> m_values;						// Sorted on the store key
 			};
 		} // namespace VC
 	} // namespace Internal
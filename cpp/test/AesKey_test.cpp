@@ -0,0 +1,216 @@
+//-----------------------------------------------------------------------------
+//
+//	AesKey_test.cpp
+//
+//	Known answer tests for the AES backends
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "AesKey.h"
+#include "aes/aes.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+// FIPS-197 appendix C.1
+static uint8 const c_fipsKey[16] =
+{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+static uint8 const c_fipsPlaintext[16] =
+{ 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+static uint8 const c_fipsCiphertext[16] =
+{ 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+// SP 800-38A F.4.1, OFB-AES128
+static uint8 const c_ofbKey[16] =
+{ 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+static uint8 const c_ofbIv[16] =
+{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+static uint8 const c_ofbPlaintext[64] =
+{ 0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a, 0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10 };
+static uint8 const c_ofbCiphertext[64] =
+{ 0x3b, 0x3f, 0xd9, 0x2e, 0xb7, 0x2d, 0xad, 0x20, 0x33, 0x34, 0x49, 0xf8, 0xe8, 0x3c, 0xfb, 0x4a, 0x77, 0x89, 0x50, 0x8d, 0x16, 0x91, 0x8f, 0x03, 0xf5, 0x3c, 0x52, 0xda, 0xc5, 0x4e, 0xd8, 0x25, 0x97, 0x40, 0x05, 0x1e, 0x9c, 0x5f, 0xec, 0xf6, 0x43, 0x44, 0xf7, 0xa8, 0x22, 0x60, 0xed, 0xcc, 0x30, 0x4c, 0x65, 0x28, 0xf6, 0x59, 0xc7, 0x78, 0x66, 0xa5, 0x10, 0xd9, 0xc1, 0xd6, 0xae, 0x5e };
+
+// Runs a test once for each backend this machine has, and puts the
+// original backend back afterwards
+class AesKeyTest: public ::testing::TestWithParam<Internal::AesKey::Backend>
+{
+	protected:
+		void SetUp()
+		{
+			m_previous = Internal::AesKey::GetBackend();
+			if (!Internal::AesKey::SetBackend(GetParam()))
+			{
+				GTEST_SKIP() << Internal::AesKey::GetBackendName(GetParam()) << " AES is not available here";
+			}
+		}
+		void TearDown()
+		{
+			Internal::AesKey::SetBackend(m_previous);
+		}
+
+		Internal::AesKey::Backend m_previous = Internal::AesKey::Backend_Portable;
+};
+
+// The same numbers every run
+static uint8 NextByte(uint32* _state)
+{
+	*_state = *_state * 1103515245 + 12345;
+	return (uint8) (*_state >> 16);
+}
+
+static void FillBytes(uint32* _state, uint8* _data, uint32 _length)
+{
+	for (uint32 i = 0; i < _length; ++i)
+	{
+		_data[i] = NextByte(_state);
+	}
+}
+
+// OFB the way the security code did it before AesKey, with the aes_* mode functions
+static void ReferenceOfb(uint8 const _key[16], uint8 const _iv[16], uint8 const* _in, uint8* _out, uint32 _length)
+{
+	aes_encrypt_ctx ctx;
+	uint8 iv[16];
+	memcpy(iv, _iv, 16);
+	aes_encrypt_key128(_key, &ctx);
+	aes_mode_reset(&ctx);
+	aes_ofb_encrypt(_in, _out, _length, iv, &ctx);
+}
+
+// And the MAC, one aes_ecb_encrypt per block
+static void ReferenceCbcMac(uint8 const _key[16], uint8 const _iv[16], uint8 const* _data, uint32 _length, uint8 _mac[16])
+{
+	aes_encrypt_ctx ctx;
+	aes_encrypt_key128(_key, &ctx);
+	aes_ecb_encrypt(_iv, _mac, 16, &ctx);
+	for (uint32 offset = 0; offset < _length; offset += 16)
+	{
+		for (uint32 i = 0; i < 16 && offset + i < _length; ++i)
+		{
+			_mac[i] ^= _data[offset + i];
+		}
+		aes_ecb_encrypt(_mac, _mac, 16, &ctx);
+	}
+}
+
+TEST_P(AesKeyTest, Fips197Block)
+{
+	Internal::AesKey key(c_fipsKey);
+	uint8 out[16];
+	key.Encrypt(c_fipsPlaintext, out);
+	EXPECT_EQ(0, memcmp(out, c_fipsCiphertext, 16));
+
+	// In place
+	memcpy(out, c_fipsPlaintext, 16);
+	key.Encrypt(out, out);
+	EXPECT_EQ(0, memcmp(out, c_fipsCiphertext, 16));
+}
+
+TEST_P(AesKeyTest, Sp80038aOfb)
+{
+	Internal::AesKey key(c_ofbKey);
+	uint8 out[64];
+	key.Ofb(c_ofbIv, c_ofbPlaintext, out, 64);
+	EXPECT_EQ(0, memcmp(out, c_ofbCiphertext, 64));
+	key.Ofb(c_ofbIv, out, out, 64);
+	EXPECT_EQ(0, memcmp(out, c_ofbPlaintext, 64));
+
+	// A length that is not whole blocks
+	key.Ofb(c_ofbIv, c_ofbPlaintext, out, 19);
+	EXPECT_EQ(0, memcmp(out, c_ofbCiphertext, 19));
+}
+
+TEST_P(AesKeyTest, MatchesModeFunctions)
+{
+	uint32 state = 1;
+	for (uint32 length = 0; length <= 64; ++length)
+	{
+		uint8 key[16];
+		uint8 iv[16];
+		uint8 data[64];
+		FillBytes(&state, key, 16);
+		FillBytes(&state, iv, 16);
+		FillBytes(&state, data, length);
+
+		uint8 expected[64];
+		uint8 out[64];
+		ReferenceOfb(key, iv, data, expected, length);
+		Internal::AesKey aesKey(key);
+		aesKey.Ofb(iv, data, out, length);
+		EXPECT_EQ(0, memcmp(out, expected, length)) << "OFB of " << length << " bytes";
+
+		uint8 expectedMac[16];
+		uint8 mac[16];
+		ReferenceCbcMac(key, iv, data, length, expectedMac);
+		aesKey.CbcMac(iv, data, length, mac);
+		EXPECT_EQ(0, memcmp(mac, expectedMac, 16)) << "CBC-MAC of " << length << " bytes";
+	}
+}
+
+// The fused path against the two modes done one after the other, with the
+// header S0 puts ahead of the ciphertext
+TEST_P(AesKeyTest, EncryptAndMac)
+{
+	uint32 state = 2;
+	for (uint32 length = 0; length <= 48; ++length)
+	{
+		uint8 encKey[16];
+		uint8 authKey[16];
+		uint8 iv[16];
+		uint8 header[4];
+		uint8 plaintext[48];
+		FillBytes(&state, encKey, 16);
+		FillBytes(&state, authKey, 16);
+		FillBytes(&state, iv, 16);
+		FillBytes(&state, header, 4);
+		FillBytes(&state, plaintext, length);
+
+		uint8 expected[52];
+		uint8 expectedMac[16];
+		memcpy(expected, header, 4);
+		ReferenceOfb(encKey, iv, plaintext, &expected[4], length);
+		ReferenceCbcMac(authKey, iv, expected, length + 4, expectedMac);
+
+		Internal::AesKey enc(encKey);
+		Internal::AesKey auth(authKey);
+		uint8 ciphertext[48];
+		uint8 mac[16];
+		Internal::AesKey::EncryptAndMac(enc, auth, iv, header, 4, plaintext, ciphertext, length, mac);
+		EXPECT_EQ(0, memcmp(ciphertext, &expected[4], length)) << "ciphertext of " << length << " bytes";
+		EXPECT_EQ(0, memcmp(mac, expectedMac, 16)) << "MAC of " << length << " bytes";
+
+		uint8 decrypted[48];
+		memset(mac, 0, 16);
+		Internal::AesKey::DecryptAndMac(enc, auth, iv, header, 4, ciphertext, decrypted, length, mac);
+		EXPECT_EQ(0, memcmp(decrypted, plaintext, length)) << "plaintext of " << length << " bytes";
+		EXPECT_EQ(0, memcmp(mac, expectedMac, 16)) << "MAC of " << length << " bytes";
+	}
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, AesKeyTest, ::testing::Values(Internal::AesKey::Backend_Portable, Internal::AesKey::Backend_AesNi, Internal::AesKey::Backend_ArmCrypto));
+
+} // namespace Testing
+} // namespace OpenZWave
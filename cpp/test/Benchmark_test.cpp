@@ -0,0 +1,1396 @@
+//-----------------------------------------------------------------------------
+//
+//	Benchmark_test.cpp
+//
+//	Micro benchmarks for performance sensitive parts of the library
+//
+//	These are disabled by default. Run them with
+//	gtest-main --gtest_also_run_disabled_tests --gtest_filter='Benchmark.*'
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <map>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
+#include "gtest/gtest.h"
+#include "platform/Log.h"
+#include "platform/Event.h"
+#include "platform/Wait.h"
+#include "platform/Thread.h"
+#include "platform/Mutex.h"
+#include "platform/SharedMutex.h"
+#include "platform/FileOps.h"
+#include "TimerThread.h"
+#include "BinaryCache.h"
+#include "ManufacturerSpecificDB.h"
+#include "Utils.h"
+#include "Msg.h"
+#include "Options.h"
+#include "tinyxml.h"
+#include "value_classes/ValueInt.h"
+#include "value_classes/ValueSnapshotTable.h"
+#include "value_classes/ValueStore.h"
+#include "CompatOptionManager.h"
+#include "ConfigTables.h"
+#include "XmlReader.h"
+#include "AesKey.h"
+#include "aes/aes.h"
+#include "SensorMultiLevelCCTypes.h"
+#include "Manager.h"
+#include "Notification.h"
+#include "platform/VirtualNetwork.h"
+#include "VirtualNetworkRun.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+// Nanoseconds elapsed since _start
+static double ElapsedNs(std::chrono::steady_clock::time_point const& _start)
+{
+	return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+}
+
+// Log the lines the driver thread writes for one received frame, and return the
+// time spent in Log::Write per frame.  Frames arrive every 100us, which is still
+// far faster than a real Z-Wave network can deliver them.
+static double LogFrames(uint32 _frames)
+{
+	double total = 0;
+	for (uint32 i = 0; i < _frames; ++i)
+	{
+		uint8 nodeId = (uint8) (1 + (i % 232));
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		Log::Write(LogLevel_Detail, nodeId, "  Received: 0x01, 0x09, 0x00, 0x04, 0x00, 0x%.2x, 0x03, 0x25, 0x03, 0xff, 0x%.2x", nodeId, i & 0xff);
+		Log::Write(LogLevel_Info, nodeId, "Received SwitchBinary report from node %d: level=%s", nodeId, "On");
+		Log::Write(LogLevel_Detail, nodeId, "  Expected reply and command class was received");
+		total += ElapsedNs(start);
+		usleep(100);
+	}
+	return total / _frames;
+}
+
+TEST(Benchmark, DISABLED_LogWritePerFrame)
+{
+	uint32 const frames = 5000;
+	char filename[] = "/tmp/ozw_log_benchXXXXXX";
+	int fd = mkstemp(filename);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	Log::Create(filename, false, false, LogLevel_Detail, LogLevel_Debug, LogLevel_None);
+	double syncNs = LogFrames(frames);
+
+	ASSERT_TRUE(Log::SetAsyncLogging(true));
+	double asyncNs = LogFrames(frames);
+	Log::AsyncStatistics stats;
+	ASSERT_TRUE(Log::GetAsyncStatistics(&stats));
+	Log::SetAsyncLogging(false);
+	Log::Destroy();
+	unlink(filename);
+
+	printf("Log::Write per frame: synchronous %.0f ns, asynchronous %.0f ns\n", syncNs, asyncNs);
+	printf("Async log records %llu, dropped %llu, max queue depth %u\n", (unsigned long long) stats.m_records, (unsigned long long) stats.m_dropped, stats.m_queueDepthMax);
+	EXPECT_EQ(stats.m_records + stats.m_dropped, (uint64) frames * 3);
+}
+
+// The driver thread waits on 11 objects.  Only the last one is signalled,
+// so every object is checked on every pass.
+static uint32 const c_waitObjects = 11;
+
+static void CreateEvents(Internal::Platform::Wait** _objects)
+{
+	for (uint32 i = 0; i < c_waitObjects; ++i)
+	{
+		_objects[i] = new Internal::Platform::Event();
+	}
+}
+
+static void ReleaseEvents(Internal::Platform::Wait** _objects)
+{
+	for (uint32 i = 0; i < c_waitObjects; ++i)
+	{
+		_objects[i]->Release();
+	}
+}
+
+TEST(Benchmark, DISABLED_WaitLoopIterations)
+{
+	uint32 const iterations = 200000;
+	Internal::Platform::Wait* objects[c_waitObjects];
+	CreateEvents(objects);
+	((Internal::Platform::Event*) objects[c_waitObjects - 1])->Set();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < iterations; ++i)
+	{
+		ASSERT_EQ(Internal::Platform::Wait::Multiple(objects, c_waitObjects, 1000), (int32) c_waitObjects - 1);
+	}
+	double multipleNs = ElapsedNs(start) / iterations;
+
+	{
+		Internal::Platform::WaitSet waitSet(objects, c_waitObjects);
+		start = std::chrono::steady_clock::now();
+		for (uint32 i = 0; i < iterations; ++i)
+		{
+			ASSERT_EQ(waitSet.Multiple(c_waitObjects, 1000), (int32) c_waitObjects - 1);
+		}
+	}
+	double waitSetNs = ElapsedNs(start) / iterations;
+	ReleaseEvents(objects);
+
+	printf("Wait::Multiple %.0f ns/iteration (%.0f/s), WaitSet %.0f ns/iteration (%.0f/s)\n", multipleNs, 1e9 / multipleNs, waitSetNs, 1e9 / waitSetNs);
+}
+
+// Time from Event::Set on another thread until the waiting thread returns
+static double WakeupLatency(Internal::Platform::Wait** _objects, Internal::Platform::WaitSet* _waitSet, uint32 _rounds)
+{
+	Internal::Platform::Event* event = (Internal::Platform::Event*) _objects[c_waitObjects - 1];
+	std::atomic<int64_t> setAt(0);
+	std::atomic<uint32> round(0);
+
+	std::thread signaller([&]()
+	{
+		for (uint32 r = 0; r < _rounds; ++r)
+		{
+			// wait until the main thread has reset the event for this round
+			while (round.load() != r)
+			{
+				usleep(10);
+			}
+			usleep(200);
+			setAt = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			event->Set();
+		}
+	});
+
+	double total = 0;
+	for (uint32 r = 0; r < _rounds; ++r)
+	{
+		int32 res = _waitSet ? _waitSet->Multiple(c_waitObjects, 5000) : Internal::Platform::Wait::Multiple(_objects, c_waitObjects, 5000);
+		int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		EXPECT_EQ(res, (int32) c_waitObjects - 1);
+		total += (double) (now - setAt.load());
+		event->Reset();
+		round = r + 1;
+	}
+	signaller.join();
+	return total / _rounds;
+}
+
+TEST(Benchmark, DISABLED_WaitWakeupLatency)
+{
+	uint32 const rounds = 2000;
+	Internal::Platform::Wait* objects[c_waitObjects];
+	CreateEvents(objects);
+
+	double multipleNs = WakeupLatency(objects, NULL, rounds);
+	double waitSetNs;
+	{
+		Internal::Platform::WaitSet waitSet(objects, c_waitObjects);
+		waitSetNs = WakeupLatency(objects, &waitSet, rounds);
+	}
+	ReleaseEvents(objects);
+
+	printf("Wake-up latency: Wait::Multiple %.0f ns, WaitSet %.0f ns\n", multipleNs, waitSetNs);
+}
+
+class BenchmarkTimer: public Internal::Timer
+{
+	public:
+		BenchmarkTimer(Internal::TimerThread* _timerThread) :
+				Internal::Timer(_timerThread), m_fired(0), m_lateness(0)
+		{
+		}
+		void Fired(uint32 _due)
+		{
+			// the id carries the time the event was due
+			m_lateness += Internal::Platform::TimeStamp::GetMonotonicTime() - _due;
+			++m_fired;
+		}
+		std::atomic<uint32> m_fired;
+		std::atomic<uint64> m_lateness;
+};
+
+TEST(Benchmark, DISABLED_TimerThread10kArmed)
+{
+	uint32 const armed = 10000;
+	uint32 const fired = 1000;
+	Internal::TimerThread timerThread(NULL);
+	Internal::Platform::Thread* thread = new Internal::Platform::Thread("timer");
+	thread->Start(Internal::TimerThread::TimerThreadEntryPoint, &timerThread);
+
+	// 10k long running timers, such as pending value refreshes
+	std::vector<BenchmarkTimer*> timers;
+	for (uint32 i = 0; i < armed; ++i)
+	{
+		timers.push_back(new BenchmarkTimer(&timerThread));
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < armed; ++i)
+	{
+		timers[i]->TimerSetEvent(60000 + (int32) i, bind(&BenchmarkTimer::Fired, timers[i], std::placeholders::_1), i);
+	}
+	double armNs = ElapsedNs(start) / armed;
+
+	// Short timers that fire while the others are armed
+	BenchmarkTimer shortTimer(&timerThread);
+	for (uint32 i = 0; i < fired; ++i)
+	{
+		int32 delay = 1 + (int32) (i % 500);
+		shortTimer.TimerSetEvent(delay, bind(&BenchmarkTimer::Fired, &shortTimer, std::placeholders::_1), (uint32) (Internal::Platform::TimeStamp::GetMonotonicTime() + delay));
+	}
+	for (uint32 wait = 0; (shortTimer.m_fired < fired) && (wait < 5000); ++wait)
+	{
+		usleep(1000);
+	}
+	EXPECT_EQ(shortTimer.m_fired.load(), fired);
+
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < armed; ++i)
+	{
+		timers[i]->TimerDelEvent(i);
+	}
+	double cancelNs = ElapsedNs(start) / armed;
+
+	thread->Stop();
+	thread->Release();
+	for (uint32 i = 0; i < armed; ++i)
+	{
+		EXPECT_EQ(timers[i]->m_fired.load(), 0u);
+		delete timers[i];
+	}
+
+	printf("TimerThread with %u armed: arm %.0f ns, cancel by id %.0f ns, %u short timers fired %.2f ms late on average\n", armed, armNs, cancelNs, fired, (double) shortTimer.m_lateness.load() / fired);
+}
+
+// A cache that looks like a 232 node network: every node with a dozen
+// command classes of five values each.
+static void BuildSyntheticCache(TiXmlDocument* _doc)
+{
+	char str[64];
+	_doc->LinkEndChild(new TiXmlDeclaration("1.0", "utf-8", ""));
+	TiXmlElement* driverElement = new TiXmlElement("Driver");
+	_doc->LinkEndChild(driverElement);
+	driverElement->SetAttribute("xmlns", "https://github.com/OpenZWave/open-zwave");
+	driverElement->SetAttribute("version", "4");
+	driverElement->SetAttribute("home_id", "0x01020304");
+	driverElement->SetAttribute("node_id", "1");
+	for (int n = 1; n <= 232; ++n)
+	{
+		TiXmlElement* nodeElement = new TiXmlElement("Node");
+		driverElement->LinkEndChild(nodeElement);
+		nodeElement->SetAttribute("id", n);
+		snprintf(str, sizeof(str), "Node %d", n);
+		nodeElement->SetAttribute("name", str);
+		nodeElement->SetAttribute("location", "Living Room");
+		nodeElement->SetAttribute("basic", "4");
+		nodeElement->SetAttribute("generic", "16");
+		nodeElement->SetAttribute("specific", "1");
+		nodeElement->SetAttribute("type", "Binary Power Switch");
+		nodeElement->SetAttribute("listening", "true");
+		nodeElement->SetAttribute("frequentListening", "false");
+		nodeElement->SetAttribute("beaming", "true");
+		nodeElement->SetAttribute("routing", "true");
+		nodeElement->SetAttribute("max_baud_rate", "40000");
+		nodeElement->SetAttribute("version", "4");
+		nodeElement->SetAttribute("query_stage", "Complete");
+
+		TiXmlElement* manufacturerElement = new TiXmlElement("Manufacturer");
+		nodeElement->LinkEndChild(manufacturerElement);
+		manufacturerElement->SetAttribute("id", "0x86");
+		manufacturerElement->SetAttribute("name", "AEON Labs");
+		TiXmlElement* productElement = new TiXmlElement("Product");
+		manufacturerElement->LinkEndChild(productElement);
+		productElement->SetAttribute("type", "0x3");
+		productElement->SetAttribute("id", "0x60");
+		productElement->SetAttribute("name", "ZW096 Smart Switch 6");
+
+		TiXmlElement* ccsElement = new TiXmlElement("CommandClasses");
+		nodeElement->LinkEndChild(ccsElement);
+		for (int c = 0; c < 12; ++c)
+		{
+			TiXmlElement* ccElement = new TiXmlElement("CommandClass");
+			ccsElement->LinkEndChild(ccElement);
+			ccElement->SetAttribute("id", 0x20 + c * 4);
+			snprintf(str, sizeof(str), "COMMAND_CLASS_%d", c);
+			ccElement->SetAttribute("name", str);
+			ccElement->SetAttribute("version", "2");
+			ccElement->SetAttribute("request_flags", "4");
+			ccElement->SetAttribute("innif", "true");
+			for (int v = 0; v < 5; ++v)
+			{
+				TiXmlElement* valueElement = new TiXmlElement("Value");
+				ccElement->LinkEndChild(valueElement);
+				valueElement->SetAttribute("type", "decimal");
+				valueElement->SetAttribute("genre", "user");
+				valueElement->SetAttribute("instance", "1");
+				valueElement->SetAttribute("index", v);
+				snprintf(str, sizeof(str), "Label %d", v);
+				valueElement->SetAttribute("label", str);
+				valueElement->SetAttribute("units", "W");
+				valueElement->SetAttribute("read_only", "true");
+				valueElement->SetAttribute("write_only", "false");
+				valueElement->SetAttribute("verify_changes", "false");
+				valueElement->SetAttribute("poll_intensity", "0");
+				valueElement->SetAttribute("min", "0");
+				valueElement->SetAttribute("max", "0");
+				snprintf(str, sizeof(str), "%d.%03d", n * 7 + v, (n * 13 + c) % 1000);
+				valueElement->SetAttribute("value", str);
+				TiXmlElement* helpElement = new TiXmlElement("Help");
+				valueElement->LinkEndChild(helpElement);
+				helpElement->LinkEndChild(new TiXmlText("The power drawn by the device, as reported by the last meter report"));
+			}
+		}
+	}
+}
+
+static long FileSize(char const* _filename)
+{
+	FILE* file = fopen(_filename, "rb");
+	if (!file)
+	{
+		return 0;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+TEST(Benchmark, DISABLED_CacheLoad232Nodes)
+{
+	uint32 const rounds = 10;
+	char xmlFilename[] = "/tmp/ozw_cache_benchXXXXXX";
+	int fd = mkstemp(xmlFilename);
+	ASSERT_GE(fd, 0);
+	close(fd);
+	string binaryFilename = string(xmlFilename) + ".bin";
+
+	{
+		TiXmlDocument doc;
+		BuildSyntheticCache(&doc);
+		ASSERT_TRUE(doc.SaveFile(xmlFilename));
+	}
+	Internal::Platform::FileOps::Create();
+	ASSERT_TRUE(Internal::BinaryCache::ConvertToBinary(xmlFilename, binaryFilename));
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < rounds; ++i)
+	{
+		TiXmlDocument doc;
+		ASSERT_TRUE(doc.LoadFile(xmlFilename, TIXML_ENCODING_UTF8));
+	}
+	double xmlMs = ElapsedNs(start) / rounds / 1e6;
+
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < rounds; ++i)
+	{
+		TiXmlDocument doc;
+		ASSERT_TRUE(Internal::BinaryCache::Load(binaryFilename, &doc));
+	}
+	double binaryMs = ElapsedNs(start) / rounds / 1e6;
+
+	// Both formats must hold the same tree
+	TiXmlDocument xmlDoc, binaryDoc;
+	ASSERT_TRUE(xmlDoc.LoadFile(xmlFilename, TIXML_ENCODING_UTF8));
+	ASSERT_TRUE(Internal::BinaryCache::Load(binaryFilename, &binaryDoc));
+	TiXmlPrinter xmlPrinter, binaryPrinter;
+	xmlDoc.Accept(&xmlPrinter);
+	binaryDoc.Accept(&binaryPrinter);
+	EXPECT_EQ(string(xmlPrinter.CStr()), string(binaryPrinter.CStr()));
+
+	// What each node keeps of the cache once it is loaded
+	vector<uint8> block;
+	Internal::BinaryCache::Encode(xmlDoc.RootElement()->FirstChildElement("Node"), &block);
+
+	printf("Cache load for 232 nodes: XML %.1f ms (%ld bytes), binary %.1f ms (%ld bytes); %lu bytes kept per node\n", xmlMs, FileSize(xmlFilename), binaryMs, FileSize(binaryFilename.c_str()), (unsigned long) block.size());
+	unlink(xmlFilename);
+	unlink(binaryFilename.c_str());
+}
+
+// Start the config database against the real config folder of the source tree
+static double StartManufacturerSpecificDB(bool _refreshIndex)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Internal::ManufacturerSpecificDB* mfs = Internal::ManufacturerSpecificDB::Create();
+	if (_refreshIndex)
+	{
+		mfs->RefreshConfigIndex();
+	}
+	double ms = ElapsedNs(start) / 1e6;
+	mfs->UnloadProductXML();
+	Internal::ManufacturerSpecificDB::Destroy();
+	return ms;
+}
+
+TEST(Benchmark, DISABLED_ConfigIndexStartup)
+{
+	string configPath = FindConfigPath();
+	ASSERT_FALSE(configPath.empty());
+	char userPath[] = "/tmp/ozw_config_benchXXXXXX";
+	ASSERT_TRUE(mkdtemp(userPath) != NULL);
+	Options::Create(configPath, string(userPath) + "/", "");
+
+	double loadMs = StartManufacturerSpecificDB(false);
+	double coldMs = StartManufacturerSpecificDB(true);
+	double warmMs = StartManufacturerSpecificDB(true);
+
+	string index = string(userPath) + "/ozwconfigindex.xml";
+	EXPECT_TRUE(Internal::Platform::FileOps::Create()->FileExists(index));
+	unlink(index.c_str());
+	rmdir(userPath);
+	Options::Destroy();
+
+	printf("Config database startup: manufacturer_specific.xml only %.1f ms, with config file index cold %.1f ms, warm %.1f ms\n", loadMs, coldMs, warmMs);
+}
+
+// A node table the size of a full network: 232 nodes with 9 values each, about
+// what a dashboard reads on every refresh.
+static uint32 const c_tableNodes = 232;
+static uint32 const c_valuesPerNode = 9;
+
+struct NodeTable
+{
+		NodeTable()
+		{
+			for (uint32 n = 0; n < c_tableNodes; ++n)
+			{
+				for (uint32 v = 0; v < c_valuesPerNode; ++v)
+				{
+					m_nodes[n][v << 4] = (int32) (n * v);
+				}
+			}
+		}
+		map<uint32, int32> m_nodes[c_tableNodes];
+};
+
+// Run _readers threads that each read every value in the table _passes times, while
+// a writer standing in for the driver thread updates a value under the exclusive lock
+// every 200us and holds it for 20us.  Returns the reads per second across all readers.
+template<typename MutexT, typename ReadGuardT>
+static double ConcurrentReads(MutexT* _mutex, uint32 _readers, uint32 _passes)
+{
+	NodeTable table;
+	std::atomic<bool> done(false);
+	std::atomic<uint64> checksum(0);
+
+	std::thread writer([&]()
+	{
+		uint32 i = 0;
+		while (!done)
+		{
+			{
+				Internal::LockGuard LG(_mutex);
+				table.m_nodes[i % c_tableNodes][0] = (int32) i;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				while (ElapsedNs(start) < 20000)
+				{
+				}
+			}
+			++i;
+			usleep(200);
+		}
+	});
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	vector<std::thread> readers;
+	for (uint32 r = 0; r < _readers; ++r)
+	{
+		readers.push_back(std::thread([&]()
+		{
+			uint64 sum = 0;
+			for (uint32 pass = 0; pass < _passes; ++pass)
+			{
+				for (uint32 n = 0; n < c_tableNodes; ++n)
+				{
+					for (uint32 v = 0; v < c_valuesPerNode; ++v)
+					{
+						ReadGuardT LG(_mutex);
+						map<uint32, int32>::const_iterator it = table.m_nodes[n].find(v << 4);
+						if (it != table.m_nodes[n].end())
+						{
+							sum += (uint32) it->second;
+						}
+					}
+				}
+			}
+			checksum += sum;
+		}));
+	}
+	for (uint32 r = 0; r < _readers; ++r)
+	{
+		readers[r].join();
+	}
+	double seconds = ElapsedNs(start) / 1e9;
+	done = true;
+	writer.join();
+
+	return (double) _readers * _passes * c_tableNodes * c_valuesPerNode / seconds;
+}
+
+TEST(Benchmark, DISABLED_NodeLockConcurrentReads)
+{
+	uint32 const readers = 4;
+	uint32 const passes = 200;
+
+	Internal::Platform::Mutex* mutex = new Internal::Platform::Mutex();
+	double mutexReads = ConcurrentReads<Internal::Platform::Mutex, Internal::LockGuard>(mutex, readers, passes);
+	mutex->Release();
+
+	Internal::Platform::SharedMutex shared;
+	double sharedReads = ConcurrentReads<Internal::Platform::SharedMutex, Internal::ReadLockGuard>(&shared, readers, passes);
+
+	printf("%u readers, %u values: exclusive mutex %.0f reads/s, shared lock %.0f reads/s\n", readers, c_tableNodes * c_valuesPerNode, mutexReads, sharedReads);
+	EXPECT_FALSE(shared.IsLocked());
+}
+
+// The value constructors look up their driver, so the benchmark values only set their ID
+class SnapshotValue: public Internal::VC::ValueInt
+{
+	public:
+		SnapshotValue(ValueID const& _id)
+		{
+			m_id = _id;
+		}
+};
+
+// Read every value of the table from _readers threads through the snapshot table,
+// while a writer republishes a value every 200us.  Returns the reads per second.
+static double SnapshotReads(Internal::VC::ValueSnapshotTable* _table, vector<SnapshotValue*> const& _values, uint32 _readers, uint32 _passes)
+{
+	std::atomic<bool> done(false);
+	std::atomic<uint64> checksum(0);
+
+	std::thread writer([&]()
+	{
+		uint32 i = 0;
+		while (!done)
+		{
+			_table->Publish(_values[(i * c_valuesPerNode) % _values.size()]);
+			++i;
+			usleep(200);
+		}
+	});
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	vector<std::thread> readers;
+	for (uint32 r = 0; r < _readers; ++r)
+	{
+		readers.push_back(std::thread([&]()
+		{
+			uint64 sum = 0;
+			ValueSnapshot snapshot;
+			for (uint32 pass = 0; pass < _passes; ++pass)
+			{
+				for (vector<SnapshotValue*>::const_iterator it = _values.begin(); it != _values.end(); ++it)
+				{
+					if (_table->Get((*it)->GetID(), &snapshot))
+					{
+						sum += (uint32) snapshot.m_intValue;
+					}
+				}
+			}
+			checksum += sum;
+		}));
+	}
+	for (uint32 r = 0; r < _readers; ++r)
+	{
+		readers[r].join();
+	}
+	double seconds = ElapsedNs(start) / 1e9;
+	done = true;
+	writer.join();
+
+	return (double) _readers * _passes * _values.size() / seconds;
+}
+
+TEST(Benchmark, DISABLED_ValueSnapshotReads)
+{
+	uint32 const readers = 4;
+	uint32 const passes = 200;
+
+	Internal::VC::ValueSnapshotTable table;
+	vector<SnapshotValue*> values;
+	for (uint32 n = 0; n < c_tableNodes; ++n)
+	{
+		for (uint32 v = 0; v < c_valuesPerNode; ++v)
+		{
+			SnapshotValue* value = new SnapshotValue(ValueID(0x01020304, (uint8) (n + 1), ValueID::ValueGenre_User, 0x26, 1, (uint16) v, ValueID::ValueType_Int));
+			table.Publish(value);
+			values.push_back(value);
+		}
+	}
+
+	Internal::Platform::SharedMutex shared;
+	double sharedReads = ConcurrentReads<Internal::Platform::SharedMutex, Internal::ReadLockGuard>(&shared, readers, passes);
+	double snapshotReads = SnapshotReads(&table, values, readers, passes);
+
+	vector<ValueSnapshot> snapshots;
+	EXPECT_EQ(c_valuesPerNode, table.GetNode(1, 0, &snapshots));
+
+	for (vector<SnapshotValue*>::iterator it = values.begin(); it != values.end(); ++it)
+	{
+		(*it)->Release();
+	}
+
+	printf("%u readers, %u values: shared lock %.0f reads/s, snapshot table %.0f reads/s\n", readers, c_tableNodes * c_valuesPerNode, sharedReads, snapshotReads);
+}
+
+// Create, finalize and free the Get messages of a query stage in bursts of 64, the
+// way the send queue holds them.  Returns the nanoseconds per message.
+static double MsgChurn(uint32 _bursts)
+{
+	Internal::Msg* msgs[64];
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 b = 0; b < _bursts; ++b)
+	{
+		for (uint32 i = 0; i < 64; ++i)
+		{
+			msgs[i] = new Internal::Msg("ConfigurationCmd_Get", (uint8) (i + 1), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, 0x70);
+			msgs[i]->Append((uint8) (i + 1));
+			msgs[i]->Append(3);
+			msgs[i]->Append(0x70);
+			msgs[i]->Append(0x05);
+			msgs[i]->Append((uint8) i);
+			msgs[i]->Append(TRANSMIT_OPTION_ACK);
+			msgs[i]->Finalize();
+		}
+		for (uint32 i = 0; i < 64; ++i)
+		{
+			delete msgs[i];
+		}
+	}
+	return ElapsedNs(start) / (_bursts * 64.0);
+}
+
+TEST(Benchmark, DISABLED_MsgAllocation)
+{
+	uint32 allocationsBefore, heapBefore, inUse;
+	Internal::Msg::GetPoolStatistics(&allocationsBefore, &heapBefore, &inUse);
+
+	double ns = MsgChurn(20000);
+
+	uint32 allocations, heap;
+	Internal::Msg::GetPoolStatistics(&allocations, &heap, &inUse);
+	EXPECT_EQ(allocationsBefore + 20000 * 64, allocations);
+	EXPECT_LE(heap - heapBefore, 2u);
+	EXPECT_EQ(0u, inUse);
+
+	printf("%u messages of %u bytes: %.0f ns per message, %u pool heap allocations\n", allocations - allocationsBefore, (uint32) sizeof(Internal::Msg), ns, heap - heapBefore);
+}
+
+// Bytes currently allocated from the heap, or 0 where the C library cannot tell us
+static size_t HeapInUse()
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 33))
+	return mallinfo2().uordblks;
+#else
+	return 0;
+#endif
+}
+
+static bool CompareStoreKey(Internal::VC::ValueStore::Entry const& _entry, uint32 _key)
+{
+	return _entry.first < _key;
+}
+
+// Compare the map the value store used to keep with the sorted vector it keeps now,
+// for a network of nodes with 32 values each.  AddValue needs a running driver, so
+// the two layouts are built directly from the same ValueStore::Entry pairs.
+TEST(Benchmark, DISABLED_ValueStoreLayout)
+{
+	uint32 const nodes = 232;
+	uint32 const valuesPerNode = 32;
+	uint32 const passes = 50;
+
+	// The values themselves, from the heap and from the value pool
+	size_t heapBefore = HeapInUse();
+	vector<void*> heapValues;
+	for (uint32 i = 0; i < nodes * valuesPerNode; ++i)
+	{
+		heapValues.push_back(::operator new(sizeof(SnapshotValue)));
+	}
+	size_t heapValueBytes = HeapInUse() - heapBefore;
+	for (vector<void*>::iterator it = heapValues.begin(); it != heapValues.end(); ++it)
+	{
+		::operator delete(*it);
+	}
+
+	heapBefore = HeapInUse();
+	vector<vector<SnapshotValue*> > values(nodes);
+	for (uint32 n = 0; n < nodes; ++n)
+	{
+		for (uint32 v = 0; v < valuesPerNode; ++v)
+		{
+			values[n].push_back(new SnapshotValue(ValueID(0x01020304, (uint8) (n + 1), ValueID::ValueGenre_User, (uint8) (0x20 + v % 8), 1, (uint16) v, ValueID::ValueType_Int)));
+		}
+	}
+	size_t pooledValueBytes = HeapInUse() - heapBefore;
+
+	// The containers
+	heapBefore = HeapInUse();
+	vector<map<uint32, Internal::VC::Value*> > maps(nodes);
+	for (uint32 n = 0; n < nodes; ++n)
+	{
+		for (vector<SnapshotValue*>::iterator it = values[n].begin(); it != values[n].end(); ++it)
+		{
+			maps[n][(*it)->GetID().GetValueStoreKey()] = *it;
+		}
+	}
+	size_t mapBytes = HeapInUse() - heapBefore;
+
+	heapBefore = HeapInUse();
+	vector<vector<Internal::VC::ValueStore::Entry> > flats(nodes);
+	for (uint32 n = 0; n < nodes; ++n)
+	{
+		for (vector<SnapshotValue*>::iterator it = values[n].begin(); it != values[n].end(); ++it)
+		{
+			uint32 key = (*it)->GetID().GetValueStoreKey();
+			vector<Internal::VC::ValueStore::Entry>::iterator pos = std::lower_bound(flats[n].begin(), flats[n].end(), key, CompareStoreKey);
+			flats[n].insert(pos, Internal::VC::ValueStore::Entry(key, *it));
+		}
+		flats[n].shrink_to_fit();
+	}
+	size_t flatBytes = HeapInUse() - heapBefore;
+
+	// Look up every value by its key
+	uint64 mapSum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		for (uint32 n = 0; n < nodes; ++n)
+		{
+			for (vector<SnapshotValue*>::iterator it = values[n].begin(); it != values[n].end(); ++it)
+			{
+				mapSum += (uintptr_t) maps[n].find((*it)->GetID().GetValueStoreKey())->second;
+			}
+		}
+	}
+	double mapLookupNs = ElapsedNs(start) / (passes * nodes * valuesPerNode);
+
+	uint64 flatSum = 0;
+	start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		for (uint32 n = 0; n < nodes; ++n)
+		{
+			for (vector<SnapshotValue*>::iterator it = values[n].begin(); it != values[n].end(); ++it)
+			{
+				flatSum += (uintptr_t) std::lower_bound(flats[n].begin(), flats[n].end(), (*it)->GetID().GetValueStoreKey(), CompareStoreKey)->second;
+			}
+		}
+	}
+	double flatLookupNs = ElapsedNs(start) / (passes * nodes * valuesPerNode);
+	EXPECT_EQ(mapSum, flatSum);
+
+	// Walk every value of every node, the way the config writer and the poll restore do
+	mapSum = 0;
+	start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		for (uint32 n = 0; n < nodes; ++n)
+		{
+			for (map<uint32, Internal::VC::Value*>::const_iterator it = maps[n].begin(); it != maps[n].end(); ++it)
+			{
+				mapSum += it->second->GetID().GetCommandClassId();
+			}
+		}
+	}
+	double mapIterateNs = ElapsedNs(start) / (passes * nodes * valuesPerNode);
+
+	flatSum = 0;
+	start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		for (uint32 n = 0; n < nodes; ++n)
+		{
+			for (Internal::VC::ValueStore::Iterator it = flats[n].begin(); it != flats[n].end(); ++it)
+			{
+				flatSum += it->second->GetID().GetCommandClassId();
+			}
+		}
+	}
+	double flatIterateNs = ElapsedNs(start) / (passes * nodes * valuesPerNode);
+	EXPECT_EQ(mapSum, flatSum);
+
+	for (uint32 n = 0; n < nodes; ++n)
+	{
+		for (vector<SnapshotValue*>::iterator it = values[n].begin(); it != values[n].end(); ++it)
+		{
+			(*it)->Release();
+		}
+	}
+
+	uint32 allocations, slabs, inUse;
+	Internal::VC::Value::GetPoolStatistics(&allocations, &slabs, &inUse);
+	EXPECT_EQ(0u, inUse);
+
+	double count = nodes * valuesPerNode;
+	printf("%u values of %u bytes\n", nodes * valuesPerNode, (uint32) sizeof(SnapshotValue));
+	printf("  lookup:    map %.1f ns, flat %.1f ns\n", mapLookupNs, flatLookupNs);
+	printf("  iteration: map %.1f ns, flat %.1f ns per value\n", mapIterateNs, flatIterateNs);
+	printf("  memory:    map %.1f + heap value %.1f bytes, flat %.1f + pooled value %.1f bytes per value\n", mapBytes / count, heapValueBytes / count, flatBytes / count, pooledValueBytes / count);
+}
+
+// Read the flags a command class checks while handling a report, from the flags
+// every command class enables.  The owner is only used to log warnings, and the
+// benchmark does not trigger any.
+TEST(Benchmark, DISABLED_CompatFlagLookup)
+{
+	uint32 const managers = 232 * 8;
+	uint32 const passes = 200;
+
+	size_t heapBefore = HeapInUse();
+	vector<Internal::CompatOptionManager*> coms;
+	for (uint32 i = 0; i < managers; ++i)
+	{
+		Internal::CompatOptionManager* com = new Internal::CompatOptionManager(Internal::CompatOptionType_Compatibility, NULL);
+		com->EnableFlag(Internal::COMPAT_FLAG_GETSUPPORTED, true);
+		com->EnableFlag(Internal::COMPAT_FLAG_OVERRIDEPRECISION, 0);
+		com->EnableFlag(Internal::COMPAT_FLAG_FORCEVERSION, 0);
+		com->EnableFlag(Internal::COMPAT_FLAG_CREATEVARS, true);
+		com->EnableFlag(Internal::COMPAT_FLAG_REFRESHONWAKEUP, false);
+		com->EnableFlag(Internal::COMPAT_FLAG_VERIFYCHANGED, false);
+		com->EnableFlag(Internal::COMPAT_FLAG_NO_REFRESH_AFTER_SET, false);
+		com->SetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, true, 1);
+		coms.push_back(com);
+	}
+	double bytesPerManager = (double) (HeapInUse() - heapBefore) / managers;
+
+	uint32 hits = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		for (vector<Internal::CompatOptionManager*>::iterator it = coms.begin(); it != coms.end(); ++it)
+		{
+			hits += (*it)->GetFlagBool(Internal::COMPAT_FLAG_CREATEVARS);
+			hits += (*it)->GetFlagByte(Internal::COMPAT_FLAG_OVERRIDEPRECISION);
+			hits += (*it)->GetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, pass & 3);
+			hits += (*it)->GetFlagBool(Internal::COMPAT_FLAG_NO_REFRESH_AFTER_SET, pass & 3);
+		}
+	}
+	double ns = ElapsedNs(start) / (passes * managers * 4.0);
+	EXPECT_EQ(passes * managers + passes * managers / 4, hits);
+
+	for (vector<Internal::CompatOptionManager*>::iterator it = coms.begin(); it != coms.end(); ++it)
+	{
+		delete *it;
+	}
+
+	printf("%u managers: %.1f ns per flag read, %.0f bytes per manager\n", managers, ns, bytesPerManager);
+}
+
+// The work the built in tables save at startup: parsing the three config files
+// they are made from.  Then look up each sensor unit in the tables, which must
+// not touch the heap.
+TEST(Benchmark, DISABLED_ConfigTableLookup)
+{
+	string configPath = FindConfigPath();
+	ASSERT_FALSE(configPath.empty());
+	char userPath[] = "/tmp/ozw_config_benchXXXXXX";
+	ASSERT_TRUE(mkdtemp(userPath) != NULL);
+	Options::Create(configPath, string(userPath) + "/", "--XMLConfigTables false");
+	Options::Get()->Lock();
+
+	char const* files[] =
+	{ "device_classes.xml", "NotificationCCTypes.xml", "SensorMultiLevelCCTypes.xml" };
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+	{
+		TiXmlDocument doc;
+		EXPECT_TRUE(doc.LoadFile((configPath + files[i]).c_str(), TIXML_ENCODING_UTF8));
+	}
+	double parseMs = ElapsedNs(start) / 1e6;
+
+	Internal::ConfigTables::SensorData const& sensors = Internal::ConfigTables::GetBuiltinSensorTypes();
+	vector<std::pair<uint32, uint32> > keys;
+	for (Internal::ConfigTables::SensorType const* type = sensors.m_types.begin(); type != sensors.m_types.end(); ++type)
+	{
+		Internal::ConfigTables::Table<Internal::ConfigTables::SensorScale> scales = sensors.m_scales.Slice(type->m_firstScale, type->m_scaleCount);
+		for (Internal::ConfigTables::SensorScale const* scale = scales.begin(); scale != scales.end(); ++scale)
+		{
+			keys.push_back(std::make_pair(type->m_id, scale->m_id));
+		}
+	}
+	ASSERT_FALSE(keys.empty());
+
+	uint32 const passes = 2000;
+	size_t length = 0;
+	Internal::SensorMultiLevelCCTypes* types = Internal::SensorMultiLevelCCTypes::Get();
+	size_t heapBefore = HeapInUse();
+	start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		for (vector<std::pair<uint32, uint32> >::iterator it = keys.begin(); it != keys.end(); ++it)
+		{
+			length += strlen(types->GetSensorUnit(it->first, it->second));
+		}
+	}
+	double tableNs = ElapsedNs(start) / (passes * keys.size());
+	EXPECT_EQ(heapBefore, HeapInUse());
+	EXPECT_LT(0u, length);
+
+	rmdir(userPath);
+	Options::Destroy();
+
+	printf("Parsing the config files the tables are built from: %.1f ms\n", parseMs);
+	printf("%u sensor units: %.1f ns per lookup\n", (uint32) keys.size(), tableNs);
+}
+
+// Every xml file under _folder and its subfolders
+static void FindXmlFiles(string const& _folder, vector<string>* o_files)
+{
+	DIR* dir = opendir(_folder.c_str());
+	if (dir == NULL)
+	{
+		return;
+	}
+	while (struct dirent* entry = readdir(dir))
+	{
+		string name = entry->d_name;
+		if (entry->d_type == DT_DIR && name[0] != '.')
+		{
+			FindXmlFiles(_folder + name + "/", o_files);
+		}
+		else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".xml") == 0)
+		{
+			o_files->push_back(_folder + name);
+		}
+	}
+	closedir(dir);
+}
+
+static uint32 CountElements(TiXmlElement const* _element)
+{
+	uint32 count = 1;
+	for (TiXmlElement const* child = _element->FirstChildElement(); child; child = child->NextSiblingElement())
+	{
+		count += CountElements(child);
+	}
+	return count;
+}
+
+// Parse each file with TinyXML or the XmlReader and count its elements.  The
+// most heap in use while a file was open is returned in o_peakHeap.
+static uint32 ReadConfigTree(vector<string> const& _files, bool _streaming, size_t* o_peakHeap)
+{
+	size_t heapBefore = HeapInUse();
+	size_t peakHeap = 0;
+	uint32 elements = 0;
+	for (vector<string>::const_iterator it = _files.begin(); it != _files.end(); ++it)
+	{
+		if (_streaming)
+		{
+			Internal::XmlReader reader;
+			if (reader.Open(*it))
+			{
+				Internal::XmlReader::Token token;
+				while ((token = reader.Next()) != Internal::XmlReader::Token_EndOfDocument && token != Internal::XmlReader::Token_Error)
+				{
+					if (token == Internal::XmlReader::Token_StartElement)
+					{
+						++elements;
+					}
+				}
+			}
+			peakHeap = std::max(peakHeap, HeapInUse() - std::min(heapBefore, HeapInUse()));
+		}
+		else
+		{
+			TiXmlDocument doc;
+			if (doc.LoadFile(it->c_str(), TIXML_ENCODING_UTF8))
+			{
+				elements += CountElements(doc.RootElement());
+			}
+			peakHeap = std::max(peakHeap, HeapInUse() - std::min(heapBefore, HeapInUse()));
+		}
+	}
+	*o_peakHeap = peakHeap;
+	return elements;
+}
+
+// The peak resident set of a child process that reads the files, or of one
+// that does nothing when _files is NULL.  The child starts with the pages of
+// this process, so only the difference between the two means anything.
+static long ChildPeakRssKb(vector<string> const* _files, bool _streaming)
+{
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		if (_files != NULL)
+		{
+			size_t peakHeap;
+			ReadConfigTree(*_files, _streaming, &peakHeap);
+		}
+		_exit(0);
+	}
+	int status;
+	struct rusage usage;
+	if (pid < 0 || wait4(pid, &status, 0, &usage) != pid)
+	{
+		return 0;
+	}
+	return usage.ru_maxrss;
+}
+
+// Read the whole config tree with the TinyXML DOM and with the XmlReader that
+// the config database and the localization file now use
+TEST(Benchmark, DISABLED_XmlReaderConfigTree)
+{
+	string configPath = FindConfigPath();
+	ASSERT_FALSE(configPath.empty());
+	vector<string> files;
+	FindXmlFiles(configPath, &files);
+	ASSERT_FALSE(files.empty());
+	uint64 bytes = 0;
+	for (vector<string>::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		bytes += FileSize(it->c_str());
+	}
+
+	// Once to bring the files into the page cache
+	size_t domPeakHeap;
+	size_t streamingPeakHeap;
+	ReadConfigTree(files, false, &domPeakHeap);
+
+	uint32 const passes = 5;
+	uint32 domElements = 0;
+	uint32 streamingElements = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		domElements = ReadConfigTree(files, false, &domPeakHeap);
+	}
+	double domNs = ElapsedNs(start) / passes;
+	start = std::chrono::steady_clock::now();
+	for (uint32 pass = 0; pass < passes; ++pass)
+	{
+		streamingElements = ReadConfigTree(files, true, &streamingPeakHeap);
+	}
+	double streamingNs = ElapsedNs(start) / passes;
+	EXPECT_EQ(domElements, streamingElements);
+
+	long baseRss = ChildPeakRssKb(NULL, false);
+	long domRss = ChildPeakRssKb(&files, false) - baseRss;
+	long streamingRss = ChildPeakRssKb(&files, true) - baseRss;
+
+	double mb = bytes / (1024.0 * 1024.0);
+	printf("Reading %u config files, %.1f MB, %u elements\n", (uint32) files.size(), mb, domElements);
+	printf("TinyXML DOM: %.1f MB/s, peak heap %lu KB, peak RSS +%ld KB\n", mb / (domNs / 1e9), (unsigned long) domPeakHeap / 1024, domRss);
+	printf("XmlReader:   %.1f MB/s, peak heap %lu KB, peak RSS +%ld KB\n", mb / (streamingNs / 1e9), (unsigned long) streamingPeakHeap / 1024, streamingRss);
+}
+
+// An S0 frame encrypted the way ZWSecurity did it with the aes_* mode
+// functions: OFB, then the MAC one aes_ecb_encrypt per block
+static void EncryptFrameWithModes(aes_encrypt_ctx* _encCtx, aes_encrypt_ctx* _authCtx, uint8 const _iv[16], uint8 const* _plaintext, uint8* _frame, uint32 _length)
+{
+	uint8 iv[16];
+	memcpy(iv, _iv, 16);
+	aes_mode_reset(_encCtx);
+	aes_ofb_encrypt(_plaintext, &_frame[4], _length, iv, _encCtx);
+	uint8 mac[16];
+	aes_mode_reset(_authCtx);
+	aes_ecb_encrypt(_iv, mac, 16, _authCtx);
+	for (uint32 offset = 0; offset < _length + 4; offset += 16)
+	{
+		for (uint32 i = 0; i < 16 && offset + i < _length + 4; ++i)
+		{
+			mac[i] ^= _frame[offset + i];
+		}
+		aes_mode_reset(_authCtx);
+		aes_ecb_encrypt(mac, mac, 16, _authCtx);
+	}
+	memcpy(&_frame[4 + _length], mac, 8);
+}
+
+// Encrypting and authenticating a 20 byte S0 payload, which is about what a
+// lock or sensor report carries, with each AES backend this machine has
+TEST(Benchmark, DISABLED_AesS0Frame)
+{
+	uint8 const encKey[16] =
+	{ 0x10, 0x21, 0x32, 0x43, 0x54, 0x65, 0x76, 0x87, 0x98, 0xa9, 0xba, 0xcb, 0xdc, 0xed, 0xfe, 0x0f };
+	uint8 const authKey[16] =
+	{ 0x0f, 0xfe, 0xed, 0xdc, 0xcb, 0xba, 0xa9, 0x98, 0x87, 0x76, 0x65, 0x54, 0x43, 0x32, 0x21, 0x10 };
+	uint8 const iv[16] =
+	{ 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18 };
+	uint32 const length = 20;
+	uint8 plaintext[length];
+	for (uint32 i = 0; i < length; ++i)
+	{
+		plaintext[i] = (uint8) i;
+	}
+	uint8 const header[4] =
+	{ 0x81, 0x01, 0x02, length };
+	uint32 const frames = 200000;
+
+	aes_encrypt_ctx encCtx;
+	aes_encrypt_ctx authCtx;
+	aes_encrypt_key128(encKey, &encCtx);
+	aes_encrypt_key128(authKey, &authCtx);
+	uint8 expected[4 + length + 8];
+	memcpy(expected, header, 4);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < frames; ++i)
+	{
+		EncryptFrameWithModes(&encCtx, &authCtx, iv, plaintext, expected, length);
+	}
+	double modesNs = ElapsedNs(start) / frames;
+	printf("S0 frame of %u bytes with the aes_* mode functions: %.0f ns\n", length, modesNs);
+
+	// Deriving the two keys from a network key, which GetAuthKey and GetEncKey
+	// used to repeat on every call while a node was being added
+	start = std::chrono::steady_clock::now();
+	for (uint32 i = 0; i < frames / 10; ++i)
+	{
+		uint8 derived[16];
+		Internal::AesKey network(encKey);
+		network.Encrypt(plaintext, derived);
+		Internal::AesKey enc(derived);
+		network.Encrypt(iv, derived);
+		Internal::AesKey auth(derived);
+	}
+	printf("Key derivation: %.0f ns\n", ElapsedNs(start) / (frames / 10));
+
+	Internal::AesKey::Backend previous = Internal::AesKey::GetBackend();
+	for (int backend = 0; backend < Internal::AesKey::Backend_Count; ++backend)
+	{
+		if (!Internal::AesKey::SetBackend((Internal::AesKey::Backend) backend))
+		{
+			continue;
+		}
+		Internal::AesKey enc(encKey);
+		Internal::AesKey auth(authKey);
+		uint8 frame[4 + length + 8];
+		memcpy(frame, header, 4);
+		uint8 mac[16];
+
+		start = std::chrono::steady_clock::now();
+		for (uint32 i = 0; i < frames; ++i)
+		{
+			enc.Ofb(iv, plaintext, &frame[4], length);
+			auth.CbcMac(iv, frame, length + 4, mac);
+		}
+		double separateNs = ElapsedNs(start) / frames;
+
+		start = std::chrono::steady_clock::now();
+		for (uint32 i = 0; i < frames; ++i)
+		{
+			Internal::AesKey::EncryptAndMac(enc, auth, iv, header, 4, plaintext, &frame[4], length, mac);
+		}
+		double fusedNs = ElapsedNs(start) / frames;
+		memcpy(&frame[4 + length], mac, 8);
+		EXPECT_EQ(0, memcmp(frame, expected, sizeof(frame)));
+
+		printf("%s: OFB then CBC-MAC %.0f ns, fused %.0f ns\n", Internal::AesKey::GetBackendName((Internal::AesKey::Backend) backend), separateNs, fusedNs);
+	}
+	Internal::AesKey::SetBackend(previous);
+}
+
+// Frames exchanged with the controller per second of startup, counting both directions
+static double FramesPerSecond(VirtualNetworkRun const* _run)
+{
+	Driver::DriverData data;
+	Manager::Get()->GetDriverStatistics(_run->m_homeId, &data);
+	return (data.m_readCnt + data.m_writeCnt) / (_run->m_startupMs / 1e3);
+}
+
+// Time to query every node of a new network, and the frame rate the driver
+// reaches while doing it.  The simulated nodes answer at once, so this is the
+// cost of the driver and the command classes.
+TEST(Benchmark, DISABLED_VirtualNetworkStartup)
+{
+	uint32 const sizes[] =
+	{ 10, 50, 100, 232 };
+	for (uint32 i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+	{
+		char path[64];
+		snprintf(path, sizeof(path), "virtual:nodes=%u", sizes[i] - 1);
+		VirtualNetworkRun run;
+		ASSERT_TRUE(StartVirtualNetwork(&run, path, Driver::ControllerInterface_Virtual));
+		double framesPerSecond = FramesPerSecond(&run);
+		StopVirtualNetwork(&run);
+		printf("%3u nodes: startup %.0f ms, %.0f frames/s\n", sizes[i], run.m_startupMs, framesPerSecond);
+	}
+}
+
+// From Manager::SetValue to the ValueChanged notification for a binary switch,
+// which takes a Set, a Get and the node's Report.  There is no loss, as the
+// driver only resends after RetryTimeout.
+TEST(Benchmark, DISABLED_VirtualNetworkSetValueLatency)
+{
+	char const* paths[] =
+	{ "virtual:nodes=9", "virtual:nodes=9,latency=10,jitter=10" };
+	uint32 const rounds = 100;
+	for (uint32 i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i)
+	{
+		VirtualNetworkRun run;
+		ASSERT_TRUE(StartVirtualNetwork(&run, paths[i], Driver::ControllerInterface_Virtual));
+		run.m_watched = run.m_switch;
+		Manager::Get()->ResetNodeLatencyStats(run.m_switch.GetHomeId(), run.m_switch.GetNodeId());
+
+		vector<double> latencies;
+		for (uint32 r = 0; r < rounds; ++r)
+		{
+			run.m_changed->Reset();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			ASSERT_TRUE(Manager::Get()->SetValue(run.m_switch, (r & 1) == 0));
+			ASSERT_EQ(0, Internal::Platform::Wait::Single(run.m_changed, 120000));
+			latencies.push_back(ElapsedNs(start) / 1e3);
+		}
+		Node::NodeLatencyStats stats;
+		Manager::Get()->GetNodeLatencyStats(run.m_switch.GetHomeId(), run.m_switch.GetNodeId(), &stats);
+		StopVirtualNetwork(&run);
+
+		sort(latencies.begin(), latencies.end());
+		printf("%-40s SetValue to ValueChanged: median %.0f us, 99th percentile %.0f us\n", paths[i], latencies[rounds / 2], latencies[rounds * 99 / 100]);
+
+		// Every round sends a Set and then a Get, and only the Get is answered
+		Node::LatencyData const* data[] =
+		{ &stats.m_requestRTT, &stats.m_responseRTT, &stats.m_ack, &stats.m_queueWait };
+		char const* names[] =
+		{ "request RTT", "response RTT", "ACK", "queue wait" };
+		for (uint32 j = 0; j < sizeof(data) / sizeof(data[0]); ++j)
+		{
+			EXPECT_LE(data[j]->m_p50, data[j]->m_p90);
+			EXPECT_LE(data[j]->m_p90, data[j]->m_p99);
+			EXPECT_LE(data[j]->m_p99, data[j]->m_max);
+			printf("%-40s   %-13s %4u samples: p50 %u us, p90 %u us, p99 %u us, max %u us\n", "", names[j], data[j]->m_count, data[j]->m_p50, data[j]->m_p90, data[j]->m_p99, data[j]->m_max);
+		}
+		EXPECT_GE(stats.m_requestRTT.m_count, rounds);
+	}
+}
+
+// Refresh the main value of every node, where one node in ten takes 300 ms to
+// prepare its report.  With MaxOutstandingRequests at 0 every slow report holds
+// up the whole network; otherwise the other nodes are served while it is awaited.
+TEST(Benchmark, DISABLED_VirtualNetworkSlowNodes)
+{
+	string path = "virtual:nodes=30";
+	for (uint32 nodeId = 2; nodeId <= 31; nodeId += 10)
+	{
+		char slow[32];
+		snprintf(slow, sizeof(slow), ",reply.%u=300", nodeId);
+		path += slow;
+	}
+	uint32 const rounds = 5;
+	int32 const limits[] =
+	{ 0, 8 };
+	for (uint32 i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i)
+	{
+		char options[64];
+		snprintf(options, sizeof(options), "--MaxOutstandingRequests %d", limits[i]);
+		VirtualNetworkRun run;
+		ASSERT_TRUE(StartVirtualNetwork(&run, path, Driver::ControllerInterface_Virtual, options));
+		ASSERT_EQ(30u, run.m_reports.size());
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		uint32 expected = run.m_reported;
+		for (uint32 r = 0; r < rounds; ++r)
+		{
+			for (vector<ValueID>::const_iterator it = run.m_reports.begin(); it != run.m_reports.end(); ++it)
+			{
+				Manager::Get()->RefreshValue(*it);
+			}
+			expected += run.m_reports.size();
+			while (run.m_reported < expected && ElapsedNs(start) < 120e9)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+		double seconds = ElapsedNs(start) / 1e9;
+		uint32 reported = run.m_reported;
+		StopVirtualNetwork(&run);
+
+		EXPECT_GE(reported, expected);
+		printf("MaxOutstandingRequests %d: %u reports in %.2f s, %.0f reports/s\n", limits[i], rounds * 30, seconds, rounds * 30 / seconds);
+	}
+}
+
+// Startup of a new network of 60 nodes, five of which are slow to report,
+// with the queries handed out as they arise and with the query scheduler.
+// Reports when AwakeNodesQueried arrives and how long the nodes took to
+// become interactive, which is when their dynamic values had been read.
+TEST(Benchmark, DISABLED_VirtualNetworkTimeToInteractive)
+{
+	string path = "virtual:nodes=59,latency=2,jitter=2";
+	for (uint32 nodeId = 2; nodeId <= 60; nodeId += 12)
+	{
+		char slow[32];
+		snprintf(slow, sizeof(slow), ",reply.%u=200", nodeId);
+		path += slow;
+	}
+	int32 const limits[] =
+	{ 0, 8 };
+	for (uint32 i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i)
+	{
+		char options[64];
+		snprintf(options, sizeof(options), "--MaxQueryNodes %d", limits[i]);
+		VirtualNetworkRun run;
+		ASSERT_TRUE(StartVirtualNetwork(&run, path, Driver::ControllerInterface_Virtual, options));
+
+		vector<uint32> times;
+		for (uint32 nodeId = 1; nodeId <= 60; ++nodeId)
+		{
+			Node::NodeData data;
+			Manager::Get()->GetNodeStatistics(run.m_homeId, (uint8) nodeId, &data);
+			times.push_back(data.m_timeToInteractive);
+		}
+		StopVirtualNetwork(&run);
+
+		sort(times.begin(), times.end());
+		EXPECT_GT(times[0], 0u);
+		printf("MaxQueryNodes %d: all nodes queried after %.0f ms, interactive after %u ms (median), %u ms (90th percentile), %u ms (last)\n", limits[i], run.m_startupMs, times[times.size() / 2], times[times.size() * 9 / 10], times.back());
+	}
+}
+
+// The same network served on a pseudo terminal and opened through the serial
+// port code, as an application that cannot use the virtual interface would
+TEST(Benchmark, DISABLED_VirtualNetworkPtyStartup)
+{
+	Internal::Platform::VirtualNetwork network("nodes=9", NULL, NULL);
+	string pty;
+	ASSERT_TRUE(network.OpenPty(&pty));
+
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, pty, Driver::ControllerInterface_Serial));
+	double framesPerSecond = FramesPerSecond(&run);
+	StopVirtualNetwork(&run);
+
+	uint32 received, sent;
+	network.GetStatistics(&received, &sent);
+	EXPECT_GT(received, 0u);
+	printf(" 10 nodes on %s: startup %.0f ms, %.0f frames/s\n", pty.c_str(), run.m_startupMs, framesPerSecond);
+}
+
+} // namespace Testing
+} // namespace OpenZWave
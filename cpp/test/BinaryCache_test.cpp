@@ -0,0 +1,203 @@
+//-----------------------------------------------------------------------------
+//
+//	BinaryCache_test.cpp
+//
+//	Tests of the binary network cache format
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "BinaryCache.h"
+#include "Manager.h"
+#include "tinyxml.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+// A small cache with the features a real one uses: attributes, text with
+// characters that need escaping, empty elements and several nodes
+static char const c_cacheXml[] = "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n"
+		"<Driver xmlns=\"https://github.com/OpenZWave/open-zwave\" version=\"4\" home_id=\"0xc0ffee00\" node_id=\"1\">\n"
+		"    <Node id=\"2\" name=\"Kitchen &amp; &quot;hall&quot;\" location=\"K\xc3\xbc" "che\" listening=\"true\">\n"
+		"        <Manufacturer id=\"7fff\" name=\"Virtual\">\n"
+		"            <Product type=\"0\" id=\"2\" name=\"Switch\" />\n"
+		"        </Manufacturer>\n"
+		"        <CommandClasses>\n"
+		"            <CommandClass id=\"37\" name=\"COMMAND_CLASS_SWITCH_BINARY\" version=\"1\">\n"
+		"                <Instance index=\"1\" />\n"
+		"                <Value type=\"bool\" genre=\"user\" instance=\"1\" index=\"0\" label=\"Switch\" value=\"False\">\n"
+		"                    <Help>Turn the switch &lt;on&gt; or off</Help>\n"
+		"                </Value>\n"
+		"            </CommandClass>\n"
+		"        </CommandClasses>\n"
+		"    </Node>\n"
+		"    <Node id=\"3\" name=\"\" listening=\"true\">\n"
+		"        <CommandClasses />\n"
+		"    </Node>\n"
+		"</Driver>\n";
+
+// Print a document the way the driver writes the XML cache
+static string Print(TiXmlDocument const& _doc)
+{
+	TiXmlPrinter printer;
+	_doc.Accept(&printer);
+	return string(printer.CStr(), printer.Size());
+}
+
+static string ReadFile(string const& _filename)
+{
+	std::ifstream in(_filename.c_str(), std::ios_base::in | std::ios_base::binary);
+	std::stringstream contents;
+	contents << in.rdbuf();
+	return contents.str();
+}
+
+static void WriteFile(string const& _filename, string const& _contents)
+{
+	std::ofstream out(_filename.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	out.write(_contents.data(), _contents.size());
+}
+
+class BinaryCacheTest: public ::testing::Test
+{
+	protected:
+		void SetUp()
+		{
+			char path[] = "/tmp/ozw_binary_cacheXXXXXX";
+			ASSERT_TRUE(mkdtemp(path) != NULL);
+			m_path = path;
+			m_xml = m_path + "/ozwcache_0xc0ffee00.xml";
+			m_binary = m_path + "/ozwcache_0xc0ffee00.bin";
+			m_result = m_path + "/result.xml";
+			WriteFile(m_xml, c_cacheXml);
+		}
+		void TearDown()
+		{
+			unlink(m_xml.c_str());
+			unlink(m_binary.c_str());
+			unlink(m_result.c_str());
+			rmdir(m_path.c_str());
+		}
+
+		string m_path;
+		string m_xml;
+		string m_binary;
+		string m_result;
+};
+
+TEST_F(BinaryCacheTest, RoundTrip)
+{
+	TiXmlDocument original;
+	ASSERT_TRUE(original.LoadFile(m_xml.c_str(), TIXML_ENCODING_UTF8));
+
+	ASSERT_TRUE(Manager::ConvertCache(m_xml, m_binary));
+	string binary = ReadFile(m_binary);
+	ASSERT_GT(binary.size(), 12u);
+	EXPECT_EQ(0, binary.compare(0, 4, "OZWB"));
+
+	TiXmlDocument loaded;
+	ASSERT_TRUE(Internal::BinaryCache::Load(m_binary, &loaded));
+	EXPECT_EQ(Print(original), Print(loaded));
+
+	ASSERT_TRUE(Manager::ConvertCache(m_binary, m_result));
+	EXPECT_EQ(Print(original), ReadFile(m_result));
+
+	// And back again gives the same binary file
+	ASSERT_TRUE(Manager::ConvertCache(m_result, m_binary));
+	EXPECT_EQ(binary, ReadFile(m_binary));
+}
+
+TEST_F(BinaryCacheTest, MissingFile)
+{
+	TiXmlDocument doc;
+	EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc));
+	EXPECT_FALSE(Manager::ConvertCache(m_binary, m_result));
+	EXPECT_FALSE(Manager::ConvertCache(m_path + "/missing.xml", m_binary));
+}
+
+// Every proper prefix of the file is rejected
+TEST_F(BinaryCacheTest, TruncatedFile)
+{
+	ASSERT_TRUE(Manager::ConvertCache(m_xml, m_binary));
+	string binary = ReadFile(m_binary);
+	for (size_t length = 0; length < binary.size(); ++length)
+	{
+		WriteFile(m_binary, binary.substr(0, length));
+		TiXmlDocument doc;
+		EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc)) << "truncated to " << length << " bytes";
+	}
+}
+
+TEST_F(BinaryCacheTest, CorruptFile)
+{
+	ASSERT_TRUE(Manager::ConvertCache(m_xml, m_binary));
+	string binary = ReadFile(m_binary);
+	TiXmlDocument doc;
+
+	// The wrong magic or version
+	string corrupt = binary;
+	corrupt[0] = 'X';
+	WriteFile(m_binary, corrupt);
+	EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc));
+	corrupt = binary;
+	corrupt[4] = 2;
+	WriteFile(m_binary, corrupt);
+	EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc));
+
+	// More blocks than there are, or bytes after the last one
+	corrupt = binary;
+	corrupt[8] = (char) (corrupt[8] + 1);
+	WriteFile(m_binary, corrupt);
+	EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc));
+	WriteFile(m_binary, binary + "garbage");
+	EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc));
+
+	// The size of the first block, and the number of strings in it, too large
+	for (size_t offset = 12; offset < 20; offset += 4)
+	{
+		corrupt = binary;
+		corrupt[offset + 3] = (char) 0x7f;
+		WriteFile(m_binary, corrupt);
+		EXPECT_FALSE(Internal::BinaryCache::Load(m_binary, &doc)) << "offset " << offset;
+	}
+
+	// Damage to any single byte must not crash the reader.  Damaged strings
+	// cannot be told apart from real ones, but sizes, counts and string
+	// indexes out of range are rejected.
+	for (size_t offset = 0; offset < binary.size(); ++offset)
+	{
+		corrupt = binary;
+		corrupt[offset] = (char) ~corrupt[offset];
+		WriteFile(m_binary, corrupt);
+		Internal::BinaryCache::Load(m_binary, &doc);
+	}
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,174 @@
+//-----------------------------------------------------------------------------
+//
+//	CompatOptionManager_test.cpp
+//
+//	Tests of the compatibility and discovery flags of the command classes
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "gtest/gtest.h"
+#include "CompatOptionManager.h"
+#include "command_classes/SwitchBinary.h"
+#include "tinyxml.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+class CompatOptionManagerTest: public ::testing::Test
+{
+	protected:
+		void SetUp()
+		{
+			m_cc = Internal::CC::SwitchBinary::Create(0x01020304, 2);
+		}
+		void TearDown()
+		{
+			delete m_cc;
+		}
+
+		Internal::CC::CommandClass* m_cc;
+};
+
+TEST_F(CompatOptionManagerTest, ScalarFlags)
+{
+	Internal::CompatOptionManager com(Internal::CompatOptionType_Compatibility, m_cc);
+	com.EnableFlag(Internal::COMPAT_FLAG_GETSUPPORTED, true);
+	com.EnableFlag(Internal::COMPAT_FLAG_FORCEVERSION, 3);
+	com.EnableFlag(Internal::COMPAT_FLAG_WAKEUP_DELAYNMI, 100000);
+
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_GETSUPPORTED));
+	EXPECT_EQ(3, com.GetFlagByte(Internal::COMPAT_FLAG_FORCEVERSION));
+	EXPECT_EQ(100000u, com.GetFlagInt(Internal::COMPAT_FLAG_WAKEUP_DELAYNMI));
+
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_GETSUPPORTED, false));
+	EXPECT_TRUE(com.SetFlagByte(Internal::COMPAT_FLAG_FORCEVERSION, 7));
+	EXPECT_TRUE(com.SetFlagInt(Internal::COMPAT_FLAG_WAKEUP_DELAYNMI, 5));
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_GETSUPPORTED));
+	EXPECT_EQ(7, com.GetFlagByte(Internal::COMPAT_FLAG_FORCEVERSION));
+	EXPECT_EQ(5u, com.GetFlagInt(Internal::COMPAT_FLAG_WAKEUP_DELAYNMI));
+
+	// The wrong type, or a flag that was not enabled, is refused
+	EXPECT_FALSE(com.SetFlagByte(Internal::COMPAT_FLAG_GETSUPPORTED, 1));
+	EXPECT_EQ(0, com.GetFlagByte(Internal::COMPAT_FLAG_GETSUPPORTED));
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_FORCEVERSION));
+	EXPECT_FALSE(com.SetFlagBool(Internal::COMPAT_FLAG_CREATEVARS, true));
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_CREATEVARS));
+	EXPECT_EQ(0u, com.GetFlagInt(Internal::COMPAT_FLAG_COUNT));
+
+	// Out of range defaults fall back to zero
+	Internal::CompatOptionManager dom(Internal::CompatOptionType_Discovery, m_cc);
+	dom.EnableFlag(Internal::STATE_FLAG_CCVERSION, 300);
+	dom.EnableFlag(Internal::STATE_FLAG_COLOR_CHANNELS, 0x1ffff);
+	EXPECT_EQ(0, dom.GetFlagByte(Internal::STATE_FLAG_CCVERSION));
+	EXPECT_EQ(0, dom.GetFlagShort(Internal::STATE_FLAG_COLOR_CHANNELS));
+	EXPECT_TRUE(dom.SetFlagShort(Internal::STATE_FLAG_COLOR_CHANNELS, 0x1234));
+	EXPECT_EQ(0x1234, dom.GetFlagShort(Internal::STATE_FLAG_COLOR_CHANNELS));
+
+	// Compatibility flags are not discovery flags
+	dom.EnableFlag(Internal::COMPAT_FLAG_GETSUPPORTED, true);
+	EXPECT_FALSE(dom.GetFlagBool(Internal::COMPAT_FLAG_GETSUPPORTED));
+}
+
+TEST_F(CompatOptionManagerTest, ArrayFlags)
+{
+	Internal::CompatOptionManager com(Internal::CompatOptionType_Compatibility, m_cc);
+	com.EnableFlag(Internal::COMPAT_FLAG_MI_REMOVECC, false);
+	com.EnableFlag(Internal::COMPAT_FLAG_VERIFYCHANGED, true);
+
+	// Unset indexes return the default
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x25));
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, 3));
+
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, true, 0x25));
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, true, 0x20));
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, false, 3));
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x25));
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x20));
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x26));
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, 3));
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, 0x25));
+
+	// Setting an index again replaces its value
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, false, 0x25));
+	EXPECT_FALSE(com.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x25));
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x20));
+
+	// An array flag needs an index to be set, and without one reads its default
+	EXPECT_FALSE(com.SetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED, false));
+	EXPECT_TRUE(com.GetFlagBool(Internal::COMPAT_FLAG_VERIFYCHANGED));
+}
+
+TEST_F(CompatOptionManagerTest, XmlRoundTrip)
+{
+	Internal::CompatOptionManager com(Internal::CompatOptionType_Compatibility, m_cc);
+	com.EnableFlag(Internal::COMPAT_FLAG_GETSUPPORTED, true);
+	com.EnableFlag(Internal::COMPAT_FLAG_FORCEVERSION, 0);
+	com.EnableFlag(Internal::COMPAT_FLAG_CREATEVARS, true);
+	com.EnableFlag(Internal::COMPAT_FLAG_MI_REMOVECC, false);
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_GETSUPPORTED, false));
+	EXPECT_TRUE(com.SetFlagByte(Internal::COMPAT_FLAG_FORCEVERSION, 2));
+	EXPECT_TRUE(com.SetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, true, 0x26));
+
+	// Only the flags that were changed are written
+	TiXmlElement ccElement("CommandClass");
+	com.WriteXML(&ccElement);
+	TiXmlElement const* compat = ccElement.FirstChildElement("Compatibility");
+	ASSERT_TRUE(compat != NULL);
+	ASSERT_TRUE(compat->FirstChildElement("GetSupported") != NULL);
+	EXPECT_STREQ("false", compat->FirstChildElement("GetSupported")->GetText());
+	ASSERT_TRUE(compat->FirstChildElement("ForceVersion") != NULL);
+	EXPECT_STREQ("2", compat->FirstChildElement("ForceVersion")->GetText());
+	EXPECT_TRUE(compat->FirstChildElement("CreateVars") == NULL);
+	TiXmlElement const* removeCC = compat->FirstChildElement("RemoveCC");
+	ASSERT_TRUE(removeCC != NULL);
+	EXPECT_STREQ("38", removeCC->Attribute("index"));
+	EXPECT_STREQ("true", removeCC->GetText());
+
+	Internal::CompatOptionManager loaded(Internal::CompatOptionType_Compatibility, m_cc);
+	loaded.EnableFlag(Internal::COMPAT_FLAG_GETSUPPORTED, true);
+	loaded.EnableFlag(Internal::COMPAT_FLAG_FORCEVERSION, 0);
+	loaded.EnableFlag(Internal::COMPAT_FLAG_CREATEVARS, true);
+	loaded.EnableFlag(Internal::COMPAT_FLAG_MI_REMOVECC, false);
+	loaded.ReadXML(&ccElement);
+	EXPECT_FALSE(loaded.GetFlagBool(Internal::COMPAT_FLAG_GETSUPPORTED));
+	EXPECT_EQ(2, loaded.GetFlagByte(Internal::COMPAT_FLAG_FORCEVERSION));
+	EXPECT_TRUE(loaded.GetFlagBool(Internal::COMPAT_FLAG_CREATEVARS));
+	EXPECT_TRUE(loaded.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x26));
+	EXPECT_FALSE(loaded.GetFlagBool(Internal::COMPAT_FLAG_MI_REMOVECC, 0x25));
+
+	// Values too large for their type are ignored
+	TiXmlElement stateElement("CommandClass");
+	TiXmlElement* state = new TiXmlElement("State");
+	TiXmlElement* ccVersion = new TiXmlElement("CCVersion");
+	ccVersion->LinkEndChild(new TiXmlText("300"));
+	state->LinkEndChild(ccVersion);
+	stateElement.LinkEndChild(state);
+	Internal::CompatOptionManager dom(Internal::CompatOptionType_Discovery, m_cc);
+	dom.EnableFlag(Internal::STATE_FLAG_CCVERSION, 1);
+	dom.ReadXML(&stateElement);
+	EXPECT_EQ(0, dom.GetFlagByte(Internal::STATE_FLAG_CCVERSION));
+}
+
+} // namespace Testing
+} // namespace OpenZWave
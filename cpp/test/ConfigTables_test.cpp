@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigTables_test.cpp
+//
+//	Tests of the device class, notification and sensor tables
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "gtest/gtest.h"
+#include "ConfigTables.h"
+#include "tinyxml.h"
+#include "VirtualNetworkRun.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+static int32 FileRevision(string const& _filename)
+{
+	TiXmlDocument doc;
+	if (!doc.LoadFile((FindConfigPath() + _filename).c_str(), TIXML_ENCODING_UTF8))
+	{
+		return -1;
+	}
+	int32 revision = -1;
+	doc.RootElement()->QueryIntAttribute("Revision", &revision);
+	return revision;
+}
+
+// Units keep their UTF-8 characters when they are trimmed
+TEST(ConfigTables, Trim)
+{
+	string unit = " \t\xc2\xb0" "C\n";
+	EXPECT_EQ("\xc2\xb0" "C", Internal::ConfigTables::Trim(unit));
+	unit = "k\xce\xa9 ";
+	EXPECT_EQ("k\xce\xa9", Internal::ConfigTables::Trim(unit));
+	unit = " \t ";
+	EXPECT_EQ("", Internal::ConfigTables::Trim(unit));
+}
+
+// The compiled tables were generated from the files that ship with them, so
+// a stock install does not warn that they differ
+TEST(ConfigTables, BuiltinRevisions)
+{
+	ASSERT_FALSE(FindConfigPath().empty());
+	EXPECT_EQ((int32) Internal::ConfigTables::GetBuiltinNotificationTypes().m_revision, FileRevision("NotificationCCTypes.xml"));
+	EXPECT_EQ((int32) Internal::ConfigTables::GetBuiltinSensorTypes().m_revision, FileRevision("SensorMultiLevelCCTypes.xml"));
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,695 @@
+//-----------------------------------------------------------------------------
+//
+//	Driver_test.cpp
+//
+//	Tests of the driver's send queues against a simulated network
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "BinaryCache.h"
+#include "Manager.h"
+#include "Notification.h"
+#include "tinyxml.h"
+#include "platform/FileOps.h"
+#include "value_classes/ValueBool.h"
+#include "platform/VirtualNetwork.h"
+#include "VirtualNetworkRun.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+typedef Internal::Platform::VirtualNetwork::Command Command;
+
+static uint8 const c_switchBinary = 0x25;
+
+// The commands of one command class, in the order they were sent
+static vector<Command> FilterCommands(vector<Command> const& _commands, uint8 const _commandClass)
+{
+	vector<Command> filtered;
+	for (vector<Command>::const_iterator it = _commands.begin(); it != _commands.end(); ++it)
+	{
+		if (!it->m_data.empty() && it->m_data[0] == _commandClass)
+		{
+			filtered.push_back(*it);
+		}
+	}
+	return filtered;
+}
+
+// Position of the first singlecast command to _nodeId with the given command, or -1
+static int32 FindCommand(vector<Command> const& _commands, uint8 const _nodeId, uint8 const _command)
+{
+	for (size_t i = 0; i < _commands.size(); ++i)
+	{
+		if (_commands[i].m_nodes.size() == 1 && _commands[i].m_nodes[0] == _nodeId && _commands[i].m_data.size() > 1 && _commands[i].m_data[1] == _command)
+		{
+			return (int32) i;
+		}
+	}
+	return -1;
+}
+
+// Sets in a multicast batch go out as one multicast frame and then one by one.
+// The Gets that read the new state back must only follow them.
+TEST(Driver, MulticastBatchOrder)
+{
+	Internal::Platform::VirtualNetwork network("nodes=9,trace=1", NULL, NULL);
+	string pty;
+	ASSERT_TRUE(network.OpenPty(&pty));
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, pty, Driver::ControllerInterface_Serial));
+
+	vector<ValueID> switches;
+	for (vector<ValueID>::const_iterator it = run.m_reports.begin(); it != run.m_reports.end(); ++it)
+	{
+		if (it->GetCommandClassId() == c_switchBinary)
+		{
+			switches.push_back(*it);
+		}
+	}
+	ASSERT_EQ(3u, switches.size());
+
+	vector<Command> commands;
+	network.GetCommands(&commands);
+	vector<uint32> reported;
+	for (size_t i = 0; i < switches.size(); ++i)
+	{
+		reported.push_back(run.m_nodeReported[switches[i].GetNodeId()]);
+	}
+
+	Manager::Get()->BeginMulticast(run.m_homeId);
+	for (size_t i = 0; i < switches.size(); ++i)
+	{
+		EXPECT_TRUE(Manager::Get()->SetValue(switches[i], true));
+	}
+	Manager::Get()->EndMulticast(run.m_homeId);
+
+	bool done = WaitUntil([&]()
+	{
+		for (size_t i = 0; i < switches.size(); ++i)
+		{
+			if (run.m_nodeReported[switches[i].GetNodeId()] == reported[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}, 30000);
+	network.GetCommands(&commands);
+	StopVirtualNetwork(&run);
+	ASSERT_TRUE(done);
+
+	commands = FilterCommands(commands, c_switchBinary);
+	ASSERT_EQ(1 + 2 * switches.size(), commands.size());
+
+	// The multicast comes first, and carries the Set for all the switches
+	ASSERT_EQ(switches.size(), commands[0].m_nodes.size());
+	for (size_t i = 0; i < switches.size(); ++i)
+	{
+		EXPECT_NE(commands[0].m_nodes.end(), find(commands[0].m_nodes.begin(), commands[0].m_nodes.end(), switches[i].GetNodeId()));
+	}
+	ASSERT_LE(2u, commands[0].m_data.size());
+	EXPECT_EQ(0x01, commands[0].m_data[1]);
+
+	// Then each switch gets its Set, and only after that its Get
+	for (size_t i = 0; i < switches.size(); ++i)
+	{
+		int32 set = FindCommand(commands, switches[i].GetNodeId(), 0x01);
+		int32 get = FindCommand(commands, switches[i].GetNodeId(), 0x02);
+		EXPECT_GT(set, 0) << "node " << (int) switches[i].GetNodeId();
+		EXPECT_GT(get, set) << "node " << (int) switches[i].GetNodeId();
+	}
+}
+
+// Count the singlecast commands to _nodeId with the given command
+static uint32 CountCommands(vector<Command> const& _commands, uint8 const _nodeId, uint8 const _command)
+{
+	uint32 count = 0;
+	for (size_t i = 0; i < _commands.size(); ++i)
+	{
+		if (_commands[i].m_nodes.size() == 1 && _commands[i].m_nodes[0] == _nodeId && _commands[i].m_data.size() > 1 && _commands[i].m_data[1] == _command)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+// A node that is slow to reply does not hold up the others, and its reply is
+// matched to its request when it arrives.  A request whose reply is overdue
+// goes back to be sent again, which drops it once its attempts are used up,
+// and a reply that only arrives after that is unsolicited.
+TEST(Driver, OutstandingReplies)
+{
+	Internal::Platform::VirtualNetwork network("nodes=9,trace=1", NULL, NULL);
+	string pty;
+	ASSERT_TRUE(network.OpenPty(&pty));
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, pty, Driver::ControllerInterface_Serial, "--RetryTimeout 1500 --MaxOutstandingRequests 8"));
+
+	vector<ValueID> switches;
+	for (vector<ValueID>::const_iterator it = run.m_reports.begin(); it != run.m_reports.end(); ++it)
+	{
+		if (it->GetCommandClassId() == c_switchBinary)
+		{
+			switches.push_back(*it);
+		}
+	}
+	ASSERT_EQ(3u, switches.size());
+	uint8 slow = switches[0].GetNodeId();
+	network.SetReply(slow, 700);
+
+	vector<Command> commands;
+	network.GetCommands(&commands);
+	Node::NodeData before;
+	Manager::Get()->GetNodeStatistics(run.m_homeId, slow, &before);
+	vector<uint32> reported;
+	for (size_t i = 0; i < switches.size(); ++i)
+	{
+		reported.push_back(run.m_nodeReported[switches[i].GetNodeId()]);
+		EXPECT_TRUE(Manager::Get()->RefreshValue(switches[i]));
+	}
+
+	// The other switches answer while the slow one still owes its reply
+	bool othersFirst = WaitUntil([&]()
+	{
+		return (run.m_nodeReported[switches[1].GetNodeId()] != reported[1]) && (run.m_nodeReported[switches[2].GetNodeId()] != reported[2]);
+	}, 5000) && (run.m_nodeReported[slow] == reported[0]);
+	bool slowReplied = WaitUntil([&]()
+	{
+		return run.m_nodeReported[slow] != reported[0];
+	}, 5000);
+	network.GetCommands(&commands);
+	Node::NodeData after;
+	Manager::Get()->GetNodeStatistics(run.m_homeId, slow, &after);
+
+	// Now the reply takes longer than the driver waits for it
+	network.SetReply(slow, 2500);
+	uint32 slowReported = run.m_nodeReported[slow];
+	EXPECT_TRUE(Manager::Get()->RefreshValue(switches[0]));
+	bool lateReplied = WaitUntil([&]()
+	{
+		return run.m_nodeReported[slow] != slowReported;
+	}, 5000);
+	vector<Command> expired;
+	network.GetCommands(&expired);
+	Node::NodeData late;
+	Manager::Get()->GetNodeStatistics(run.m_homeId, slow, &late);
+
+	// The node is not waited on any more, so the next request goes straight out
+	network.SetReply(slow, 0);
+	slowReported = run.m_nodeReported[slow];
+	EXPECT_TRUE(Manager::Get()->RefreshValue(switches[0]));
+	bool recovered = WaitUntil([&]()
+	{
+		return run.m_nodeReported[slow] != slowReported;
+	}, 1000);
+	StopVirtualNetwork(&run);
+
+	EXPECT_TRUE(othersFirst);
+	EXPECT_TRUE(slowReplied);
+	for (size_t i = 0; i < switches.size(); ++i)
+	{
+		EXPECT_EQ(1u, CountCommands(commands, switches[i].GetNodeId(), 0x02)) << "node " << (int) switches[i].GetNodeId();
+	}
+	EXPECT_GE(after.m_lastResponseRTT, 700u);
+	EXPECT_EQ(before.m_receivedUnsolicited, after.m_receivedUnsolicited);
+	EXPECT_TRUE(lateReplied);
+	EXPECT_EQ(1u, CountCommands(expired, slow, 0x02));
+	EXPECT_EQ(after.m_receivedUnsolicited + 1, late.m_receivedUnsolicited);
+	EXPECT_TRUE(recovered);
+}
+
+// The cache is saved in either format once the network has been queried.
+// The XML cache is put together from the nodes printed one by one.
+TEST(Driver, CacheFormats)
+{
+	char const* formats[] =
+	{ "XML", "BINARY" };
+	for (uint32 i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i)
+	{
+		bool binary = (i == 1);
+		VirtualNetworkRun run;
+		ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9", Driver::ControllerInterface_Virtual, string("--CacheSaveDelay 0 --CacheFormat ") + formats[i]));
+
+		char name[64];
+		snprintf(name, sizeof(name), "/ozwcache_0x%08x.%s", run.m_homeId, binary ? "bin" : "xml");
+		string filename = string(run.m_userPath) + name;
+		bool saved = WaitUntil([&]()
+		{
+			return Internal::Platform::FileOps::Create()->FileExists(filename);
+		}, 30000);
+
+		TiXmlDocument doc;
+		bool loaded = saved && (binary ? Internal::BinaryCache::Load(filename, &doc) : doc.LoadFile(filename.c_str(), TIXML_ENCODING_UTF8));
+		string contents;
+		if (loaded && !binary)
+		{
+			std::ifstream in(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+			std::stringstream stream;
+			stream << in.rdbuf();
+			contents = stream.str();
+		}
+		StopVirtualNetwork(&run);
+		ASSERT_TRUE(saved) << formats[i];
+		ASSERT_TRUE(loaded) << formats[i];
+
+		uint32 nodes = 0;
+		for (TiXmlElement const* node = doc.RootElement()->FirstChildElement("Node"); node; node = node->NextSiblingElement("Node"))
+		{
+			EXPECT_TRUE(node->FirstChildElement("CommandClasses") != NULL) << formats[i];
+			++nodes;
+		}
+		EXPECT_EQ(10u, nodes) << formats[i];
+
+		if (!binary)
+		{
+			// Each node starts on its own line, one level into the Driver element
+			uint32 lines = 0;
+			for (size_t pos = contents.find("\n\t<Node "); pos != string::npos; pos = contents.find("\n\t<Node ", pos + 1))
+			{
+				++lines;
+			}
+			EXPECT_EQ(10u, lines);
+			EXPECT_EQ(0u, contents.find("<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n<Driver xmlns="));
+			EXPECT_EQ(contents.size() - 11, contents.rfind("\n</Driver>\n"));
+		}
+	}
+}
+
+// Sets and Gets for a node that is busy wait in the queue.  A newer Set
+// replaces the one waiting for the same value, and a Get that is already
+// waiting is not queued again.
+TEST(Driver, CoalesceQueuedMessages)
+{
+	Internal::Platform::VirtualNetwork network("nodes=9,trace=1", NULL, NULL);
+	string pty;
+	ASSERT_TRUE(network.OpenPty(&pty));
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, pty, Driver::ControllerInterface_Serial, "--MaxOutstandingRequests 8"));
+	uint8 nodeId = run.m_switch.GetNodeId();
+
+	vector<Command> commands;
+	network.GetCommands(&commands);
+	Driver::DriverData before;
+	Manager::Get()->GetDriverStatistics(run.m_homeId, &before);
+
+	// Hold the node up with a Get whose reply is slow, and queue behind it
+	network.SetReply(nodeId, 1000);
+	uint32 reported = run.m_nodeReported[nodeId];
+	EXPECT_TRUE(Manager::Get()->RefreshValue(run.m_switch));
+	for (uint32 i = 0; i < 10; ++i)
+	{
+		EXPECT_TRUE(Manager::Get()->SetValue(run.m_switch, (i % 2) == 1));
+	}
+	for (uint32 i = 0; i < 10; ++i)
+	{
+		EXPECT_TRUE(Manager::Get()->RefreshValue(run.m_switch));
+	}
+	Driver::DriverData queued;
+	Manager::Get()->GetDriverStatistics(run.m_homeId, &queued);
+
+	// The slow reply, and then the ones to the Gets that are left
+	network.SetReply(nodeId, 0);
+	WaitUntil([&]()
+	{
+		return run.m_nodeReported[nodeId] - reported >= 2;
+	}, 5000);
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	network.GetCommands(&commands);
+	StopVirtualNetwork(&run);
+
+	commands = FilterCommands(commands, c_switchBinary);
+	EXPECT_EQ(1u, CountCommands(commands, nodeId, 0x01));
+	int32 set = FindCommand(commands, nodeId, 0x01);
+	ASSERT_GE(set, 0);
+	ASSERT_GE(commands[set].m_data.size(), 3u);
+	EXPECT_EQ(0xff, commands[set].m_data[2]);
+	EXPECT_EQ(9u, queued.m_coalescedSets - before.m_coalescedSets);
+
+	// The first Get, and one behind the Set, as the Set changes what it reads
+	uint32 gets = CountCommands(commands, nodeId, 0x02);
+	EXPECT_GE(gets, 2u);
+	EXPECT_LE(gets, 3u);
+	EXPECT_GE(queued.m_coalescedGets - before.m_coalescedGets, 9u);
+}
+
+// A new poll interval applies straight away to the polls that were scheduled
+// with the old one, and a legacy interval in seconds is converted to ms
+TEST(Driver, PollInterval)
+{
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9", Driver::ControllerInterface_Virtual, "--PollInterval 3600000 --IntervalBetweenPolls true"));
+
+	Driver::PollStatistics stats;
+	ASSERT_TRUE(Manager::Get()->EnablePoll(run.m_switch));
+	bool first = WaitUntil([&]()
+	{
+		return Manager::Get()->GetPollStatistics(run.m_switch, &stats) && (stats.m_polls == 1);
+	}, 5000);
+
+	// The next poll is an hour away, until the interval changes
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	Manager::Get()->GetPollStatistics(run.m_switch, &stats);
+	uint32 polls = stats.m_polls;
+	Manager::Get()->SetPollInterval(100, true);
+	bool rescheduled = WaitUntil([&]()
+	{
+		return Manager::Get()->GetPollStatistics(run.m_switch, &stats) && (stats.m_polls >= 4);
+	}, 5000);
+	uint32 period = stats.m_period;
+
+	// One second over all the polled values, which is just this one
+	Manager::Get()->SetPollInterval(1, false);
+	std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+	Manager::Get()->GetPollStatistics(run.m_switch, &stats);
+	uint32 legacyPeriod = stats.m_period;
+
+	Manager::Get()->DisablePoll(run.m_switch);
+	StopVirtualNetwork(&run);
+	ASSERT_TRUE(first);
+	EXPECT_EQ(1u, polls);
+	EXPECT_TRUE(rescheduled);
+	EXPECT_EQ(100u, period);
+	EXPECT_EQ(1000u, legacyPeriod);
+}
+
+// The name of a node in a saved XML cache
+static string SavedNodeName(TiXmlDocument const& _doc, uint8 const _nodeId)
+{
+	for (TiXmlElement const* node = _doc.RootElement()->FirstChildElement("Node"); node; node = node->NextSiblingElement("Node"))
+	{
+		int id = 0;
+		if (node->QueryIntAttribute("id", &id) == TIXML_SUCCESS && id == _nodeId && node->Attribute("name"))
+		{
+			return node->Attribute("name");
+		}
+	}
+	return "";
+}
+
+// The value attribute of the binary switch of a node in a saved XML cache
+static string SavedSwitchValue(TiXmlDocument const& _doc, uint8 const _nodeId)
+{
+	for (TiXmlElement const* node = _doc.RootElement()->FirstChildElement("Node"); node; node = node->NextSiblingElement("Node"))
+	{
+		int id = 0;
+		if (node->QueryIntAttribute("id", &id) != TIXML_SUCCESS || id != _nodeId || !node->FirstChildElement("CommandClasses"))
+		{
+			continue;
+		}
+		for (TiXmlElement const* cc = node->FirstChildElement("CommandClasses")->FirstChildElement("CommandClass"); cc; cc = cc->NextSiblingElement("CommandClass"))
+		{
+			int ccId = 0;
+			if (cc->QueryIntAttribute("id", &ccId) == TIXML_SUCCESS && ccId == c_switchBinary && cc->FirstChildElement("Value"))
+			{
+				char const* value = cc->FirstChildElement("Value")->Attribute("value");
+				return value ? value : "";
+			}
+		}
+	}
+	return "";
+}
+
+// A save that was scheduled for one node also writes the changes that other
+// nodes have had since the last save
+TEST(Driver, CacheDirtyNodes)
+{
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9", Driver::ControllerInterface_Virtual, "--CacheSaveDelay 0 --CacheFormat XML"));
+	char name[64];
+	snprintf(name, sizeof(name), "/ozwcache_0x%08x.xml", run.m_homeId);
+	string filename = string(run.m_userPath) + name;
+	bool saved = WaitUntil([&]()
+	{
+		return Internal::Platform::FileOps::Create()->FileExists(filename);
+	}, 30000);
+
+	// Turn the switch of node 2 on, and then change the name of node 3
+	uint32 reported = run.m_nodeReported[run.m_switch.GetNodeId()];
+	EXPECT_TRUE(Manager::Get()->SetValue(run.m_switch, true));
+	bool changed = WaitUntil([&]()
+	{
+		return run.m_nodeReported[run.m_switch.GetNodeId()] != reported;
+	}, 5000);
+	Manager::Get()->SetNodeName(run.m_homeId, 3, "Renamed");
+
+	TiXmlDocument doc;
+	bool renamed = WaitUntil([&]()
+	{
+		return doc.LoadFile(filename.c_str(), TIXML_ENCODING_UTF8) && SavedNodeName(doc, 3) == "Renamed";
+	}, 5000);
+	StopVirtualNetwork(&run);
+
+	ASSERT_TRUE(saved);
+	ASSERT_TRUE(changed);
+	ASSERT_TRUE(renamed);
+	EXPECT_EQ("True", SavedSwitchValue(doc, run.m_switch.GetNodeId()));
+}
+
+// Records the notifications it receives, and removes the driver from inside
+// the watcher when the armed value changes
+struct OrderWatcher
+{
+		std::mutex m_mutex;
+		vector<Notification::NotificationType> m_types;
+		std::atomic<uint32> m_depth;
+		std::atomic<bool> m_nested;
+		std::atomic<bool> m_armed;
+		std::atomic<bool> m_removed;
+		std::atomic<bool> m_threw;
+		std::atomic<bool> m_valid;
+		ValueID m_value;
+		string m_path;
+};
+
+static void OnOrderNotification(Notification const* _notification, void* _context)
+{
+	OrderWatcher* watcher = (OrderWatcher*) _context;
+	if (++watcher->m_depth > 1)
+	{
+		watcher->m_nested = true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(watcher->m_mutex);
+		watcher->m_types.push_back(_notification->GetType());
+	}
+	if (watcher->m_armed && (_notification->GetType() == Notification::Type_ValueChanged) && (_notification->GetValueID() == watcher->m_value))
+	{
+		watcher->m_armed = false;
+		Manager::Get()->RemoveDriver(watcher->m_path);
+	}
+	if (_notification->GetType() == Notification::Type_DriverRemoved)
+	{
+		// The value has gone with the driver.  IsValueValid says so
+		// without throwing, while the getters still throw.
+		watcher->m_valid = Manager::Get()->IsValueValid(watcher->m_value);
+		try
+		{
+			bool value;
+			Manager::Get()->GetValueAsBool(watcher->m_value, &value);
+		} catch (OZWException& e)
+		{
+			watcher->m_threw = (e.GetType() == OZWException::OZWEXCEPTION_INVALID_HOMEID);
+		}
+		watcher->m_removed = true;
+	}
+	--watcher->m_depth;
+}
+
+// A watcher that removes the driver gets the driver's last notifications
+// after the one it is handling, in order, and not from inside its own call
+TEST(Driver, NotificationOrder)
+{
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9", Driver::ControllerInterface_Virtual));
+
+	OrderWatcher watcher;
+	watcher.m_depth = 0;
+	watcher.m_nested = false;
+	watcher.m_armed = true;
+	watcher.m_removed = false;
+	watcher.m_threw = false;
+	watcher.m_valid = true;
+	watcher.m_value = run.m_switch;
+	watcher.m_path = "virtual:nodes=9";
+	Manager::Get()->AddWatcher(OnOrderNotification, &watcher);
+	EXPECT_TRUE(Manager::Get()->SetValue(run.m_switch, true));
+	bool removed = WaitUntil([&]()
+	{
+		return watcher.m_removed.load();
+	}, 10000);
+	Manager::Get()->RemoveWatcher(OnOrderNotification, &watcher);
+	StopVirtualNetwork(&run);
+
+	ASSERT_TRUE(removed);
+	EXPECT_FALSE(watcher.m_nested);
+	EXPECT_TRUE(watcher.m_threw);
+	EXPECT_FALSE(watcher.m_valid);
+	vector<Notification::NotificationType>::iterator changed = std::find(watcher.m_types.begin(), watcher.m_types.end(), Notification::Type_ValueChanged);
+	vector<Notification::NotificationType>::iterator driverRemoved = std::find(watcher.m_types.begin(), watcher.m_types.end(), Notification::Type_DriverRemoved);
+	EXPECT_TRUE(changed < driverRemoved);
+	EXPECT_TRUE(driverRemoved == watcher.m_types.end() - 1);
+}
+
+// A watcher that removes the driver posts all of the driver's last notifications
+// from the notification thread.  Past its limit the queue counts the overflow,
+// and still delivers every notification that cannot be dropped.
+TEST(Driver, NotificationSelfPostOverflow)
+{
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9", Driver::ControllerInterface_Virtual, "--NotificationQueueSize 2 --NotifyOnDriverUnload true"));
+
+	OrderWatcher watcher;
+	watcher.m_depth = 0;
+	watcher.m_nested = false;
+	watcher.m_armed = true;
+	watcher.m_removed = false;
+	watcher.m_threw = false;
+	watcher.m_valid = true;
+	watcher.m_value = run.m_switch;
+	watcher.m_path = "virtual:nodes=9";
+	Manager::Get()->AddWatcher(OnOrderNotification, &watcher);
+	Manager::NotificationData before;
+	Manager::Get()->GetNotificationStatistics(&before);
+	EXPECT_TRUE(Manager::Get()->SetValue(run.m_switch, true));
+	uint32 nodesRemoved = 0;
+	WaitUntil([&]()
+	{
+		std::lock_guard<std::mutex> lock(watcher.m_mutex);
+		nodesRemoved = (uint32) std::count(watcher.m_types.begin(), watcher.m_types.end(), Notification::Type_NodeRemoved);
+		return nodesRemoved == 10;
+	}, 10000);
+	Manager::NotificationData after;
+	Manager::Get()->GetNotificationStatistics(&after);
+	Manager::Get()->RemoveWatcher(OnOrderNotification, &watcher);
+	StopVirtualNetwork(&run);
+
+	EXPECT_TRUE(watcher.m_removed);
+	EXPECT_FALSE(watcher.m_nested);
+	EXPECT_EQ(10u, nodesRemoved);
+	EXPECT_GT(after.m_overflowed, before.m_overflowed);
+}
+
+// With room for one node at a time, and replies that other traffic waits
+// alongside, every node is still queried in turn.  A node that is done frees
+// its place, so nodes queried again afterwards get through too.
+TEST(Driver, QueryNodeLimit)
+{
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9,reply.3=20,reply.6=20", Driver::ControllerInterface_Virtual, "--MaxQueryNodes 1 --MaxOutstandingRequests 8"));
+
+	uint32 reported3 = run.m_nodeReported[3];
+	uint32 reported4 = run.m_nodeReported[4];
+	EXPECT_TRUE(Manager::Get()->RefreshNodeInfo(run.m_homeId, 3));
+	EXPECT_TRUE(Manager::Get()->RefreshNodeInfo(run.m_homeId, 4));
+	bool queried = WaitUntil([&]()
+	{
+		return run.m_nodeReported[3] > reported3 && run.m_nodeReported[4] > reported4;
+	}, 10000);
+	StopVirtualNetwork(&run);
+
+	EXPECT_TRUE(queried);
+}
+
+// Counts the value notifications of one value
+struct ValueWatcher
+{
+		ValueID m_value;
+		std::atomic<uint32> m_changed;
+		std::atomic<uint32> m_refreshed;
+};
+
+static void OnValueNotification(Notification const* _notification, void* _context)
+{
+	ValueWatcher* watcher = (ValueWatcher*) _context;
+	if (_notification->GetValueID() != watcher->m_value)
+	{
+		return;
+	}
+	if (_notification->GetType() == Notification::Type_ValueChanged)
+	{
+		++watcher->m_changed;
+	}
+	else if (_notification->GetType() == Notification::Type_ValueRefreshed)
+	{
+		++watcher->m_refreshed;
+	}
+}
+
+// Value notifications for a value that already has one waiting are merged
+// into it, and a merged change is still reported as a change
+TEST(Driver, CoalesceValueNotifications)
+{
+	VirtualNetworkRun run;
+	ASSERT_TRUE(StartVirtualNetwork(&run, "virtual:nodes=9", Driver::ControllerInterface_Virtual, "--CoalesceValueNotifications true"));
+
+	ValueWatcher watcher;
+	watcher.m_value = run.m_switch;
+	watcher.m_changed = 0;
+	watcher.m_refreshed = 0;
+	Manager::Get()->AddWatcher(OnValueNotification, &watcher);
+	Driver::DriverData before;
+	Manager::Get()->GetDriverStatistics(run.m_homeId, &before);
+
+	// A copy of the switch value reports on its behalf, faster than the
+	// driver thread hands the notifications on.  Its first report is a change.
+	uint32 const reports = 2000;
+	Internal::VC::ValueBool* value = new Internal::VC::ValueBool(run.m_homeId, run.m_switch.GetNodeId(), run.m_switch.GetGenre(), run.m_switch.GetCommandClassId(), run.m_switch.GetInstance(), run.m_switch.GetIndex(), "Switch", "", false, false, false, 0);
+	ASSERT_TRUE(value->GetID() == run.m_switch);
+	for (uint32 i = 0; i < reports; ++i)
+	{
+		value->OnValueRefreshed(false);
+	}
+	value->Release();
+
+	Driver::DriverData after;
+	bool delivered = WaitUntil([&]()
+	{
+		Manager::Get()->GetDriverStatistics(run.m_homeId, &after);
+		return watcher.m_changed + watcher.m_refreshed + (after.m_coalescedNotifications - before.m_coalescedNotifications) >= reports;
+	}, 5000);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	Manager::Get()->GetDriverStatistics(run.m_homeId, &after);
+	Manager::Get()->RemoveWatcher(OnValueNotification, &watcher);
+	StopVirtualNetwork(&run);
+
+	ASSERT_TRUE(delivered);
+	uint32 coalesced = after.m_coalescedNotifications - before.m_coalescedNotifications;
+	EXPECT_GT(coalesced, 0u);
+	EXPECT_EQ(reports, watcher.m_changed + watcher.m_refreshed + coalesced);
+	EXPECT_EQ(1u, watcher.m_changed.load());
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------
+//
+//	Log_test.cpp
+//
+//	Tests of the logger switching while other threads write to it
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "platform/Log.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+static uint32 const c_loggers = 40;
+static std::atomic<bool> s_retired[c_loggers];
+static std::atomic<uint32> s_lateWrites;
+
+// A logger that counts its messages and notices any that reach it once it is being deleted
+class CountingLog: public i_LogImpl
+{
+	public:
+		CountingLog(uint32 _id) :
+				m_id(_id), m_writes(0)
+		{
+		}
+		~CountingLog()
+		{
+			s_retired[m_id] = true;
+			// Give a writer that is still inside Write the chance to be seen
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		void Write(LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args)
+		{
+			if (s_retired[m_id])
+			{
+				++s_lateWrites;
+			}
+			++m_writes;
+		}
+		void QueueDump()
+		{
+		}
+		void QueueClear()
+		{
+		}
+		void SetLoggingState(LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger)
+		{
+		}
+		void SetLogFileName(const string &_filename)
+		{
+		}
+
+		uint32 m_id;
+		std::atomic<uint32> m_writes;
+};
+
+// Replace the asynchronous built-in logger, change the levels and replace
+// the custom logger again while four threads keep writing
+TEST(Log, SwapUnderConcurrentWrites)
+{
+	char filename[] = "/tmp/ozw_log_swapXXXXXX";
+	int fd = mkstemp(filename);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	s_lateWrites = 0;
+	for (uint32 i = 0; i < c_loggers; ++i)
+	{
+		s_retired[i] = false;
+	}
+
+	uint32 missed = 0;
+	for (uint32 round = 0; round < c_loggers / 2; ++round)
+	{
+		Log::Create(filename, false, false, LogLevel_Detail, LogLevel_Debug, LogLevel_None);
+		ASSERT_TRUE(Log::SetAsyncLogging(true));
+
+		std::atomic<bool> stop(false);
+		std::atomic<uint32> written(0);
+		vector<std::thread> writers;
+		for (uint8 i = 0; i < 4; ++i)
+		{
+			writers.push_back(std::thread([&stop, &written, i]()
+			{
+				while (!stop)
+				{
+					Log::Write(LogLevel_Info, i, "Writer %d, message %u", i, written.load());
+					++written;
+				}
+			}));
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		Log::SetLoggingState(LogLevel_Info, LogLevel_Debug, LogLevel_None);
+
+		// Deletes the built-in logger, and then the first counting one, while the writers are busy
+		for (uint32 i = 0; i < 2; ++i)
+		{
+			CountingLog* counting = new CountingLog(round * 2 + i);
+			Log::SetLoggingClass(counting, false);
+			Log::SetLoggingState(LogLevel_Detail, LogLevel_Debug, LogLevel_None);
+			uint32 start = written;
+			while (written - start < 100)
+			{
+				std::this_thread::yield();
+			}
+			if (counting->m_writes == 0)
+			{
+				++missed;
+			}
+		}
+
+		stop = true;
+		for (size_t i = 0; i < writers.size(); ++i)
+		{
+			writers[i].join();
+		}
+		Log::Destroy();
+	}
+	unlink(filename);
+
+	EXPECT_EQ(0u, missed);
+	EXPECT_EQ(0u, s_lateWrites.load());
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+//
+//	Msg_test.cpp
+//
+//	Tests of Z-Wave messages
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "gtest/gtest.h"
+#include "Msg.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+// A SwitchBinary command for a node, as the command classes build them
+static Internal::Msg* SwitchBinaryMsg(uint8 const _nodeId, uint8 const _command, uint8 const _value, bool const _final)
+{
+	uint8 const length = (_command == 0x01) ? 3 : 2;
+	Internal::Msg* msg = new Internal::Msg("SwitchBinary", _nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, (_command == 0x01) ? 0 : FUNC_ID_APPLICATION_COMMAND_HANDLER, 0x25);
+	msg->Append(_nodeId);
+	msg->Append(length);
+	msg->Append(0x25);
+	msg->Append(_command);
+	if (_command == 0x01)
+	{
+		msg->Append(_value);
+	}
+	msg->Append(TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE);
+	if (_final)
+	{
+		msg->Finalize();
+	}
+	return msg;
+}
+
+// Messages that only differ in their callback id, and so in their checksum, are the same
+TEST(Msg, EqualityIgnoresCallbackId)
+{
+	Internal::Msg* first = SwitchBinaryMsg(2, 0x02, 0, true);
+	Internal::Msg* second = SwitchBinaryMsg(2, 0x02, 0, true);
+	EXPECT_NE(first->GetCallbackId(), second->GetCallbackId());
+	EXPECT_TRUE(*first == *second);
+	EXPECT_TRUE(*second == *first);
+	EXPECT_EQ(0x25, first->GetCommandClassId());
+	EXPECT_EQ(0x02, first->GetCommand());
+
+	// A new callback id for a resend does not change that either
+	second->UpdateCallbackId();
+	EXPECT_TRUE(*first == *second);
+	delete second;
+	delete first;
+}
+
+TEST(Msg, EqualityComparesPayload)
+{
+	Internal::Msg* get = SwitchBinaryMsg(2, 0x02, 0, true);
+	Internal::Msg* otherNode = SwitchBinaryMsg(5, 0x02, 0, true);
+	Internal::Msg* on = SwitchBinaryMsg(2, 0x01, 0xff, true);
+	Internal::Msg* off = SwitchBinaryMsg(2, 0x01, 0x00, true);
+	EXPECT_FALSE(*get == *otherNode);
+	EXPECT_FALSE(*get == *on);
+	EXPECT_FALSE(*on == *off);
+
+	// Only finalized messages can be compared
+	Internal::Msg* unfinished = SwitchBinaryMsg(2, 0x02, 0, false);
+	Internal::Msg* unfinishedToo = SwitchBinaryMsg(2, 0x02, 0, false);
+	EXPECT_FALSE(*unfinished == *get);
+	EXPECT_FALSE(*unfinished == *unfinishedToo);
+	EXPECT_EQ(0, unfinished->GetCommandClassId());
+
+	delete unfinishedToo;
+	delete unfinished;
+	delete off;
+	delete on;
+	delete otherNode;
+	delete get;
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,148 @@
+//-----------------------------------------------------------------------------
+//
+//	SharedMutex_test.cpp
+//
+//	Tests of the reader/writer lock
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "platform/SharedMutex.h"
+#include "VirtualNetworkRun.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+// Wait for the threads, or give up on them if they are deadlocked.  The lock
+// is leaked then, as they still use it.
+static bool JoinOrAbandon(std::thread& _a, std::thread& _b, std::atomic<uint32> const& _done)
+{
+	bool finished = WaitUntil([&]()
+	{
+		return _done.load() == 2;
+	}, 5000);
+	if (finished)
+	{
+		_a.join();
+		_b.join();
+	}
+	else
+	{
+		_a.detach();
+		_b.detach();
+	}
+	return finished;
+}
+
+// A reader that takes the lock exclusively goes ahead of a writer that is
+// already waiting for it, rather than deadlocking with it
+TEST(SharedMutex, UpgradeAheadOfWaitingWriter)
+{
+	Internal::Platform::SharedMutex* mutex = new Internal::Platform::SharedMutex();
+	std::atomic<bool> readLocked(false);
+	std::atomic<bool> writerWaiting(false);
+	std::atomic<bool> upgraded(false);
+	std::atomic<bool> writerAfterUpgrade(false);
+	std::atomic<uint32> done(0);
+
+	std::thread upgrader([&]()
+	{
+		mutex->LockShared();
+		readLocked = true;
+		while (!writerWaiting)
+		{
+			usleep(1000);
+		}
+		// Give the writer time to queue
+		usleep(50000);
+		mutex->Lock();
+		upgraded = true;
+		mutex->Unlock();
+		mutex->UnlockShared();
+		++done;
+	});
+	std::thread writer([&]()
+	{
+		while (!readLocked)
+		{
+			usleep(1000);
+		}
+		writerWaiting = true;
+		mutex->Lock();
+		writerAfterUpgrade = upgraded.load();
+		mutex->Unlock();
+		++done;
+	});
+
+	ASSERT_TRUE(JoinOrAbandon(upgrader, writer, done));
+	EXPECT_TRUE(writerAfterUpgrade);
+	EXPECT_FALSE(mutex->IsLocked());
+	delete mutex;
+}
+
+// Two readers that take the lock exclusively at the same time both get it,
+// one after the other
+TEST(SharedMutex, ConcurrentUpgrades)
+{
+	Internal::Platform::SharedMutex* mutex = new Internal::Platform::SharedMutex();
+	std::atomic<uint32> readers(0);
+	std::atomic<uint32> inside(0);
+	std::atomic<bool> overlapped(false);
+	std::atomic<uint32> done(0);
+
+	std::function<void()> upgrade = [&]()
+	{
+		mutex->LockShared();
+		++readers;
+		while (readers < 2)
+		{
+			usleep(1000);
+		}
+		mutex->Lock();
+		if (++inside > 1)
+		{
+			overlapped = true;
+		}
+		usleep(10000);
+		--inside;
+		mutex->Unlock();
+		mutex->UnlockShared();
+		++done;
+	};
+	std::thread first(upgrade);
+	std::thread second(upgrade);
+
+	ASSERT_TRUE(JoinOrAbandon(first, second, done));
+	EXPECT_FALSE(overlapped);
+	EXPECT_FALSE(mutex->IsLocked());
+	delete mutex;
+}
+
+} // namespace Testing
+} // namespace OpenZWave
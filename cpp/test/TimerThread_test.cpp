@@ -0,0 +1,140 @@
+//-----------------------------------------------------------------------------
+//
+//	TimerThread_test.cpp
+//
+//	Tests of the timer thread
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <unistd.h>
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "TimerThread.h"
+#include "platform/Thread.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+class CountingTimer: public Internal::Timer
+{
+	public:
+		CountingTimer(Internal::TimerThread* _timerThread) :
+				Internal::Timer(_timerThread), m_fired(0)
+		{
+		}
+		void Fired(uint32 _id)
+		{
+			++m_fired;
+		}
+		std::atomic<uint32> m_fired;
+};
+
+// A handle to an event that was deleted must not delete the event that now
+// uses the same, recycled, entry
+TEST(TimerThread, StaleHandle)
+{
+	Internal::TimerThread timerThread(NULL);
+	Internal::Platform::Thread* thread = new Internal::Platform::Thread("timer");
+	thread->Start(Internal::TimerThread::TimerThreadEntryPoint, &timerThread);
+
+	CountingTimer timer(&timerThread);
+	Internal::TimerThread::TimerHandle first = timer.TimerSetEvent(60000, bind(&CountingTimer::Fired, &timer, std::placeholders::_1), 1);
+	timer.TimerDelEvent(first);
+	Internal::TimerThread::TimerHandle second = timer.TimerSetEvent(20, bind(&CountingTimer::Fired, &timer, std::placeholders::_1), 2);
+	EXPECT_EQ(first.entry, second.entry);
+	EXPECT_NE(first.generation, second.generation);
+
+	timer.TimerDelEvent(first);
+	for (uint32 wait = 0; (timer.m_fired == 0) && (wait < 2000); ++wait)
+	{
+		usleep(1000);
+	}
+	EXPECT_EQ(1u, timer.m_fired.load());
+
+	// And once it has fired, its own handle is stale too
+	timer.TimerSetEvent(20, bind(&CountingTimer::Fired, &timer, std::placeholders::_1), 3);
+	timer.TimerDelEvent(second);
+	for (uint32 wait = 0; (timer.m_fired < 2) && (wait < 2000); ++wait)
+	{
+		usleep(1000);
+	}
+	EXPECT_EQ(2u, timer.m_fired.load());
+
+	timer.TimerDelEvents();
+	thread->Stop();
+	thread->Release();
+}
+
+class SelfDeletingTimer: public Internal::Timer
+{
+	public:
+		SelfDeletingTimer(Internal::TimerThread* _timerThread) :
+				Internal::Timer(_timerThread), m_fired(0)
+		{
+		}
+		void Fired(uint32 _id)
+		{
+			// The event is firing, so it is no longer pending and this must do nothing
+			TimerDelEvent(m_handle);
+			++m_fired;
+		}
+		Internal::TimerThread::TimerHandle m_handle;
+		std::atomic<uint32> m_fired;
+};
+
+// Deleting an event from inside its own callback must not disturb the other
+// events, nor return its entry to the pool twice
+TEST(TimerThread, DeleteFiringEvent)
+{
+	Internal::TimerThread timerThread(NULL);
+	Internal::Platform::Thread* thread = new Internal::Platform::Thread("timer");
+	thread->Start(Internal::TimerThread::TimerThreadEntryPoint, &timerThread);
+
+	CountingTimer other(&timerThread);
+	other.TimerSetEvent(60000, bind(&CountingTimer::Fired, &other, std::placeholders::_1), 1);
+	other.TimerSetEvent(100, bind(&CountingTimer::Fired, &other, std::placeholders::_1), 2);
+
+	SelfDeletingTimer timer(&timerThread);
+	timer.m_handle = timer.TimerSetEvent(10, bind(&SelfDeletingTimer::Fired, &timer, std::placeholders::_1), 1);
+	for (uint32 wait = 0; ((timer.m_fired == 0) || (other.m_fired == 0)) && (wait < 2000); ++wait)
+	{
+		usleep(1000);
+	}
+	EXPECT_EQ(1u, timer.m_fired.load());
+	EXPECT_EQ(1u, other.m_fired.load());
+
+	// The entry was recycled once, so two new events get two different entries
+	Internal::TimerThread::TimerHandle first = other.TimerSetEvent(60000, bind(&CountingTimer::Fired, &other, std::placeholders::_1), 3);
+	Internal::TimerThread::TimerHandle second = other.TimerSetEvent(60000, bind(&CountingTimer::Fired, &other, std::placeholders::_1), 4);
+	EXPECT_NE(first.entry, second.entry);
+
+	other.TimerDelEvents();
+	timer.TimerDelEvents();
+	thread->Stop();
+	thread->Release();
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,230 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueSnapshotTable_test.cpp
+//
+//	Tests of the lock-free value snapshot table
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "value_classes/ValueSnapshotTable.h"
+#include "value_classes/ValueString.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+static uint32 const c_homeId = 0x01020304;
+
+// The value constructors look up their driver, so the test values only set their ID and text
+class TextValue: public Internal::VC::ValueString
+{
+	public:
+		TextValue(uint8 const _nodeId, uint16 const _index)
+		{
+			m_id = ValueID(c_homeId, _nodeId, ValueID::ValueGenre_User, 0x70, 1, _index, ValueID::ValueType_String);
+		}
+		string const GetAsString() const
+		{
+			return m_text;
+		}
+		string m_text;
+};
+
+// The same eight digit number seven times over, so a torn copy can be recognised
+static string Pattern(uint32 const _counter)
+{
+	char digits[16];
+	snprintf(digits, sizeof(digits), "%08u", _counter);
+	string text;
+	for (uint32 i = 0; i < 7; ++i)
+	{
+		text += digits;
+	}
+	return text;
+}
+
+static bool IsPattern(char const* _text, uint32* o_counter)
+{
+	if (strlen(_text) != 56 || sscanf(_text, "%8u", o_counter) != 1)
+	{
+		return false;
+	}
+	return Pattern(*o_counter) == _text;
+}
+
+TEST(ValueSnapshotTable, PublishGetRemove)
+{
+	Internal::VC::ValueSnapshotTable table;
+	TextValue* first = new TextValue(2, 1);
+	TextValue* second = new TextValue(2, 0);
+	TextValue* other = new TextValue(3, 0);
+	first->m_text = "first";
+	second->m_text = "second";
+	other->m_text = "other";
+
+	ValueSnapshot snapshot;
+	EXPECT_FALSE(table.Get(first->GetID(), &snapshot));
+	table.Publish(first);
+	table.Publish(second);
+	table.Publish(other);
+
+	ASSERT_TRUE(table.Get(first->GetID(), &snapshot));
+	EXPECT_TRUE(snapshot.m_id == first->GetID());
+	EXPECT_STREQ("first", snapshot.m_text);
+	EXPECT_FALSE(snapshot.m_textTruncated);
+	uint64 firstVersion = snapshot.m_version;
+	EXPECT_GT(firstVersion, 0u);
+	ASSERT_TRUE(table.Get(other->GetID(), &snapshot));
+	uint64 otherVersion = snapshot.m_version;
+	EXPECT_GT(otherVersion, firstVersion);
+
+	// Publishing again updates the snapshot in place, with a newer version
+	first->m_text = string(100, 'x');
+	table.Publish(first);
+	ASSERT_TRUE(table.Get(first->GetID(), &snapshot));
+	EXPECT_GT(snapshot.m_version, otherVersion);
+	EXPECT_TRUE(snapshot.m_textTruncated);
+	EXPECT_EQ(string(ValueSnapshot::TextSize - 1, 'x'), snapshot.m_text);
+
+	// A node's values come in value store order, and can be limited to the changed ones
+	vector<ValueSnapshot> snapshots;
+	EXPECT_EQ(2u, table.GetNode(2, 0, &snapshots));
+	ASSERT_EQ(2u, snapshots.size());
+	EXPECT_TRUE(snapshots[0].m_id == second->GetID());
+	EXPECT_TRUE(snapshots[1].m_id == first->GetID());
+	snapshots.clear();
+	EXPECT_EQ(1u, table.GetNode(2, otherVersion, &snapshots));
+	ASSERT_EQ(1u, snapshots.size());
+	EXPECT_TRUE(snapshots[0].m_id == first->GetID());
+	EXPECT_EQ(0u, table.GetNode(4, 0, &snapshots));
+
+	table.Remove(second->GetID());
+	EXPECT_FALSE(table.Get(second->GetID(), &snapshot));
+	table.Remove(second->GetID());
+	snapshots.clear();
+	EXPECT_EQ(1u, table.GetNode(2, 0, &snapshots));
+	EXPECT_TRUE(table.Get(first->GetID(), &snapshot));
+	EXPECT_TRUE(table.Get(other->GetID(), &snapshot));
+
+	// A removed value can come back
+	table.Publish(second);
+	EXPECT_TRUE(table.Get(second->GetID(), &snapshot));
+	EXPECT_STREQ("second", snapshot.m_text);
+
+	other->Release();
+	second->Release();
+	first->Release();
+}
+
+// Readers never see a half written snapshot or a version going backwards,
+// while a writer updates one value and keeps adding and removing another
+TEST(ValueSnapshotTable, ConcurrentReaders)
+{
+	Internal::VC::ValueSnapshotTable table;
+	TextValue* updated = new TextValue(2, 0);
+	TextValue* churned = new TextValue(2, 1);
+	updated->m_text = Pattern(0);
+	churned->m_text = Pattern(0);
+	table.Publish(updated);
+
+	std::atomic<bool> done(false);
+	std::atomic<uint32> torn(0);
+	std::atomic<uint32> backwards(0);
+	std::atomic<uint32> reads(0);
+	vector<std::thread> readers;
+	for (uint32 r = 0; r < 3; ++r)
+	{
+		readers.push_back(std::thread([&]()
+		{
+			uint64 lastVersion = 0;
+			uint32 lastCounter = 0;
+			vector<ValueSnapshot> snapshots;
+			while (!done)
+			{
+				ValueSnapshot snapshot;
+				uint32 counter;
+				if (!table.Get(updated->GetID(), &snapshot) || !IsPattern(snapshot.m_text, &counter))
+				{
+					++torn;
+					continue;
+				}
+				if (snapshot.m_version < lastVersion || counter < lastCounter)
+				{
+					++backwards;
+				}
+				lastVersion = snapshot.m_version;
+				lastCounter = counter;
+
+				snapshots.clear();
+				table.GetNode(2, 0, &snapshots);
+				for (vector<ValueSnapshot>::const_iterator it = snapshots.begin(); it != snapshots.end(); ++it)
+				{
+					if (!IsPattern(it->m_text, &counter))
+					{
+						++torn;
+					}
+				}
+				++reads;
+			}
+		}));
+	}
+
+	for (uint32 i = 1; i <= 20000; ++i)
+	{
+		updated->m_text = Pattern(i);
+		table.Publish(updated);
+		if ((i % 16) == 0)
+		{
+			table.Remove(churned->GetID());
+		}
+		else if ((i % 16) == 8)
+		{
+			churned->m_text = Pattern(i);
+			table.Publish(churned);
+		}
+	}
+	done = true;
+	for (size_t r = 0; r < readers.size(); ++r)
+	{
+		readers[r].join();
+	}
+
+	ValueSnapshot snapshot;
+	ASSERT_TRUE(table.Get(updated->GetID(), &snapshot));
+	EXPECT_EQ(Pattern(20000), snapshot.m_text);
+	EXPECT_GT(reads.load(), 0u);
+	EXPECT_EQ(0u, torn.load());
+	EXPECT_EQ(0u, backwards.load());
+
+	churned->Release();
+	updated->Release();
+}
+
+} // namespace Testing
+} // namespace OpenZWave
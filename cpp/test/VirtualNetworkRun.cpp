@@ -0,0 +1,188 @@
+//-----------------------------------------------------------------------------
+//
+//	VirtualNetworkRun.cpp
+//
+//	A Manager on a simulated network, shared by the tests and benchmarks
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <chrono>
+#include <thread>
+
+#include "VirtualNetworkRun.h"
+#include "Manager.h"
+#include "Notification.h"
+#include "Options.h"
+#include "platform/Wait.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+string FindConfigPath()
+{
+	char const* candidates[] =
+	{ "config/", "../config/", "../../config/" };
+	for (uint32 i = 0; i < sizeof(candidates) / sizeof(candidates[0]); ++i)
+	{
+		if (access((string(candidates[i]) + "manufacturer_specific.xml").c_str(), R_OK) == 0)
+		{
+			return candidates[i];
+		}
+	}
+	return "";
+}
+
+static void OnVirtualNetworkNotification(Notification const* _notification, void* _context)
+{
+	VirtualNetworkRun* run = (VirtualNetworkRun*) _context;
+	switch (_notification->GetType())
+	{
+		case Notification::Type_ValueAdded:
+		{
+			ValueID const& id = _notification->GetValueID();
+			if ((id.GetNodeId() == 2) && (id.GetCommandClassId() == 0x25) && (id.GetIndex() == 0))
+			{
+				run->m_switch = id;
+			}
+			uint8 ccId = id.GetCommandClassId();
+			if (((ccId == 0x25 || ccId == 0x26) && id.GetIndex() == 0) || (ccId == 0x31 && id.GetIndex() == 1))
+			{
+				run->m_reports.push_back(id);
+				run->m_reportIds[id.GetNodeId()] = id.GetId();
+			}
+			break;
+		}
+		case Notification::Type_ValueChanged:
+		{
+			if (_notification->GetValueID() == run->m_watched)
+			{
+				run->m_changed->Set();
+			}
+			if (_notification->GetValueID().GetId() == run->m_reportIds[_notification->GetNodeId()])
+			{
+				++run->m_reported;
+				++run->m_nodeReported[_notification->GetNodeId()];
+			}
+			break;
+		}
+		case Notification::Type_ValueRefreshed:
+		{
+			if (_notification->GetValueID().GetId() == run->m_reportIds[_notification->GetNodeId()])
+			{
+				++run->m_reported;
+				++run->m_nodeReported[_notification->GetNodeId()];
+			}
+			break;
+		}
+		case Notification::Type_DriverFailed:
+		{
+			run->m_failed = true;
+			run->m_queried->Set();
+			break;
+		}
+		case Notification::Type_AllNodesQueried:
+		case Notification::Type_AllNodesQueriedSomeDead:
+		{
+			run->m_queried->Set();
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+bool StartVirtualNetwork(VirtualNetworkRun* _run, string const& _path, Driver::ControllerInterface _interface, string const& _options)
+{
+	string configPath = FindConfigPath();
+	strcpy(_run->m_userPath, "/tmp/ozw_virtual_benchXXXXXX");
+	if (configPath.empty() || !mkdtemp(_run->m_userPath))
+	{
+		return false;
+	}
+	_run->m_queried = new Internal::Platform::Event();
+	_run->m_changed = new Internal::Platform::Event();
+	_run->m_failed = false;
+	_run->m_homeId = 0;
+	_run->m_reports.clear();
+	memset(_run->m_reportIds, 0, sizeof(_run->m_reportIds));
+	_run->m_reported = 0;
+	for (uint32 i = 0; i < 256; ++i)
+	{
+		_run->m_nodeReported[i] = 0;
+	}
+
+	Options::Create(configPath, string(_run->m_userPath) + "/", "--Logging false --ConsoleOutput false --SaveConfiguration false " + _options);
+	Options::Get()->Lock();
+	Manager::Create();
+	Manager::Get()->AddWatcher(OnVirtualNetworkNotification, _run);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Manager::Get()->AddDriver(_path, _interface);
+	bool queried = Internal::Platform::Wait::Single(_run->m_queried, 600000) == 0;
+	_run->m_startupMs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1e3;
+	_run->m_homeId = _run->m_switch.GetHomeId();
+	return queried && !_run->m_failed;
+}
+
+void StopVirtualNetwork(VirtualNetworkRun* _run)
+{
+	Manager::Get()->RemoveWatcher(OnVirtualNetworkNotification, _run);
+	Manager::Destroy();
+	Options::Destroy();
+	_run->m_changed->Release();
+	_run->m_queried->Release();
+
+	if (DIR* dir = opendir(_run->m_userPath))
+	{
+		while (struct dirent* entry = readdir(dir))
+		{
+			if (entry->d_name[0] != '.')
+			{
+				unlink((string(_run->m_userPath) + "/" + entry->d_name).c_str());
+			}
+		}
+		closedir(dir);
+	}
+	rmdir(_run->m_userPath);
+}
+
+bool WaitUntil(std::function<bool()> const& _condition, uint32 _timeoutMs)
+{
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(_timeoutMs);
+	while (!_condition())
+	{
+		if (std::chrono::steady_clock::now() >= end)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+} // namespace Testing
+} // namespace OpenZWave
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+//
+//	VirtualNetworkRun.h
+//
+//	A Manager on a simulated network, shared by the tests and benchmarks
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _VirtualNetworkRun_H
+#define _VirtualNetworkRun_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Defs.h"
+#include "Driver.h"
+#include "value_classes/ValueID.h"
+#include "platform/Event.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+// A Manager with one driver on a simulated network.  Each run gets an empty
+// user path, so there is no cache and every node is queried from scratch.
+struct VirtualNetworkRun
+{
+		Internal::Platform::Event* m_queried;
+		Internal::Platform::Event* m_changed;
+		std::atomic<bool> m_failed;
+		ValueID m_switch;				// The binary switch of node 2
+		ValueID m_watched;				// ValueChanged for this value sets m_changed
+		vector<ValueID> m_reports;		// The main report of each node: switch level or temperature
+		uint64 m_reportIds[256];		// Id of the value in m_reports for each node, or zero
+		std::atomic<uint32> m_reported;	// Refreshes and changes of the values in m_reports
+		std::atomic<uint32> m_nodeReported[256];	// The same, for each node
+		char m_userPath[32];
+		uint32 m_homeId;
+		double m_startupMs;
+};
+
+// The tests run from the source tree or a build folder next to it
+string FindConfigPath();
+
+// Start a Manager on the controller and wait until all the nodes have been queried
+bool StartVirtualNetwork(VirtualNetworkRun* _run, string const& _path, Driver::ControllerInterface _interface, string const& _options = "");
+
+void StopVirtualNetwork(VirtualNetworkRun* _run);
+
+// Poll _condition every millisecond until it holds or _timeoutMs have passed
+bool WaitUntil(std::function<bool()> const& _condition, uint32 _timeoutMs);
+
+} // namespace Testing
+} // namespace OpenZWave
+
+#endif //_VirtualNetworkRun_H
@@ -0,0 +1,296 @@
+//-----------------------------------------------------------------------------
+//
+//	XmlReader_test.cpp
+//
+//	Tests of the streaming XML reader
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "XmlReader.h"
+#include "tinyxml.h"
+#include "VirtualNetworkRun.h"
+
+namespace OpenZWave
+{
+
+namespace Testing
+{
+
+typedef Internal::XmlReader XmlReader;
+
+static void OpenString(XmlReader* _reader, char const* _xml)
+{
+	_reader->Open(_xml, strlen(_xml), "test.xml");
+}
+
+// The error a document stops with, or an empty string if it reads to the end
+static string ReadToEnd(char const* _xml)
+{
+	XmlReader reader;
+	OpenString(&reader, _xml);
+	while (true)
+	{
+		XmlReader::Token token = reader.Next();
+		if (token == XmlReader::Token_Error)
+		{
+			return reader.GetError();
+		}
+		if (token == XmlReader::Token_EndOfDocument)
+		{
+			return "";
+		}
+	}
+}
+
+// Walk the reader through _element and compare everything TinyXML read
+static void CompareElement(TiXmlElement const* _element, XmlReader* _reader)
+{
+	ASSERT_EQ(XmlReader::Token_StartElement, _reader->GetToken()) << _reader->GetFilename() << " line " << _reader->GetLine();
+	ASSERT_TRUE(_reader->GetName() == _element->Value()) << _element->Value() << " at line " << _reader->GetLine();
+	for (TiXmlAttribute const* attribute = _element->FirstAttribute(); attribute; attribute = attribute->Next())
+	{
+		string value;
+		ASSERT_TRUE(_reader->GetAttribute(attribute->Name(), &value)) << attribute->Name() << " at line " << _reader->GetLine();
+		ASSERT_EQ(string(attribute->Value()), value) << attribute->Name() << " at line " << _reader->GetLine();
+	}
+
+	for (TiXmlNode const* child = _element->FirstChild(); child; child = child->NextSibling())
+	{
+		if (TiXmlElement const* childElement = child->ToElement())
+		{
+			_reader->Next();
+			CompareElement(childElement, _reader);
+			if (::testing::Test::HasFatalFailure())
+			{
+				return;
+			}
+		}
+		else if (TiXmlText const* text = child->ToText())
+		{
+			ASSERT_EQ(XmlReader::Token_Text, _reader->Next()) << "line " << _reader->GetLine();
+			string value;
+			_reader->GetText(&value);
+			ASSERT_EQ(string(text->Value()), value) << "line " << _reader->GetLine();
+		}
+	}
+	ASSERT_EQ(XmlReader::Token_EndElement, _reader->Next()) << "line " << _reader->GetLine();
+	ASSERT_TRUE(_reader->GetName() == _element->Value());
+}
+
+TEST(XmlReader, Tokens)
+{
+	XmlReader reader;
+	OpenString(&reader, "\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+			"<!DOCTYPE Root [ <!ELEMENT Root ANY> ]>\n"
+			"<!-- a comment -->\n"
+			"<Root version='2'>\n"
+			"  <Empty/>\n"
+			"  <Item id=\"1\">text</Item>\n"
+			"</Root>\n");
+
+	EXPECT_EQ(XmlReader::Token_None, reader.GetToken());
+	ASSERT_EQ(XmlReader::Token_StartElement, reader.Next());
+	EXPECT_TRUE(reader.GetName() == "Root");
+	EXPECT_FALSE(reader.GetName() == "Roo");
+	EXPECT_FALSE(reader.GetName() == "Roots");
+	EXPECT_EQ(1u, reader.GetDepth());
+	EXPECT_EQ(4u, reader.GetLine());
+	int32 version = 0;
+	EXPECT_TRUE(reader.GetAttribute("version", &version));
+	EXPECT_EQ(2, version);
+	EXPECT_FALSE(reader.GetAttribute("missing").Exists());
+
+	ASSERT_EQ(XmlReader::Token_StartElement, reader.Next());
+	EXPECT_TRUE(reader.GetName() == "Empty");
+	EXPECT_EQ(2u, reader.GetDepth());
+	ASSERT_EQ(XmlReader::Token_EndElement, reader.Next());
+	EXPECT_TRUE(reader.GetName() == "Empty");
+	EXPECT_EQ(2u, reader.GetDepth());
+
+	ASSERT_EQ(XmlReader::Token_StartElement, reader.Next());
+	EXPECT_TRUE(reader.GetName() == "Item");
+	EXPECT_EQ(6u, reader.GetLine());
+	ASSERT_EQ(XmlReader::Token_Text, reader.Next());
+	string text;
+	reader.GetText(&text);
+	EXPECT_EQ("text", text);
+	EXPECT_EQ(XmlReader::Token_EndElement, reader.Next());
+	EXPECT_EQ(XmlReader::Token_EndElement, reader.Next());
+	EXPECT_TRUE(reader.GetName() == "Root");
+	EXPECT_EQ(1u, reader.GetDepth());
+	EXPECT_EQ(XmlReader::Token_EndOfDocument, reader.Next());
+	EXPECT_EQ(0u, reader.GetDepth());
+	EXPECT_EQ(XmlReader::Token_EndOfDocument, reader.Next());
+	EXPECT_FALSE(reader.HasError());
+}
+
+TEST(XmlReader, TextAndEntities)
+{
+	XmlReader reader;
+	OpenString(&reader, "<Root a=\"&lt;&amp;&gt;&quot;&apos;&#65;&#x42;&#xe9;&unknown;&\" b='x\r\ny'>\r\n"
+			"  Some\r\n   spaced \t text &amp; more  \r\n"
+			"  <![CDATA[  <kept>  as  is  ]]>\n"
+			"</Root>");
+
+	ASSERT_EQ(XmlReader::Token_StartElement, reader.Next());
+	string value;
+	EXPECT_TRUE(reader.GetAttribute("a", &value));
+	EXPECT_EQ("<&>\"'AB\xc3\xa9&unknown;&", value);
+	EXPECT_TRUE(reader.GetAttribute("b", &value));
+	EXPECT_EQ("x\ny", value);
+	EXPECT_EQ(XmlReader::Token_Text, reader.Next());
+	reader.GetText(&value);
+	EXPECT_EQ("Some spaced text & more", value);
+	EXPECT_EQ(XmlReader::Token_Text, reader.Next());
+	reader.GetText(&value);
+	EXPECT_EQ("  <kept>  as  is  ", value);
+	EXPECT_EQ(XmlReader::Token_EndElement, reader.Next());
+	EXPECT_EQ(XmlReader::Token_EndOfDocument, reader.Next());
+}
+
+TEST(XmlReader, Numbers)
+{
+	XmlReader reader;
+	OpenString(&reader, "<Root dec=\"-12\" hex=\"0x1F\" big=\"18446744073709551615\" text=\"abc\" empty=\"\"/>");
+	ASSERT_EQ(XmlReader::Token_StartElement, reader.Next());
+	int32 value = 0;
+	EXPECT_TRUE(reader.GetAttribute("dec", &value));
+	EXPECT_EQ(-12, value);
+	EXPECT_TRUE(reader.GetAttribute("hex", &value, 16));
+	EXPECT_EQ(0x1f, value);
+	uint64 big = 0;
+	EXPECT_TRUE(reader.GetAttribute("big").ToUInt64(&big));
+	EXPECT_EQ(18446744073709551615ULL, big);
+	value = 7;
+	EXPECT_FALSE(reader.GetAttribute("text", &value));
+	EXPECT_FALSE(reader.GetAttribute("empty", &value));
+	EXPECT_FALSE(reader.GetAttribute("missing", &value));
+	EXPECT_EQ(7, value);
+}
+
+// NextChild skips whatever the caller did not read, and ReadText ignores the
+// text inside child elements
+TEST(XmlReader, NextChildAndReadText)
+{
+	XmlReader reader;
+	OpenString(&reader, "<Root>\n"
+			"  <A><Deep><Deeper>x</Deeper></Deep>skipped</A>\n"
+			"  <B>first <Child>inner</Child> second</B>\n"
+			"  <C/>\n"
+			"  <D><E/></D>\n"
+			"</Root>");
+
+	ASSERT_TRUE(reader.NextChild(0));
+	EXPECT_TRUE(reader.GetName() == "Root");
+	uint32 depth = reader.GetDepth();
+	vector<string> names;
+	string text;
+	while (reader.NextChild(depth))
+	{
+		names.push_back(string(reader.GetName().GetData(), reader.GetName().GetLength()));
+		if (reader.GetName() == "B")
+		{
+			EXPECT_TRUE(reader.ReadText(&text));
+		}
+		else if (reader.GetName() == "C")
+		{
+			string none;
+			EXPECT_FALSE(reader.ReadText(&none));
+		}
+		else if (reader.GetName() == "D")
+		{
+			EXPECT_TRUE(reader.SkipElement());
+		}
+	}
+	EXPECT_FALSE(reader.HasError()) << reader.GetError();
+	ASSERT_EQ(4u, names.size());
+	EXPECT_EQ("A", names[0]);
+	EXPECT_EQ("B", names[1]);
+	EXPECT_EQ("C", names[2]);
+	EXPECT_EQ("D", names[3]);
+	EXPECT_EQ("first", text);
+	EXPECT_EQ(XmlReader::Token_EndElement, reader.GetToken());
+	EXPECT_TRUE(reader.GetName() == "Root");
+	EXPECT_EQ(XmlReader::Token_EndOfDocument, reader.Next());
+}
+
+TEST(XmlReader, Errors)
+{
+	EXPECT_EQ("", ReadToEnd("<Root/>"));
+	EXPECT_EQ("The document has no root element at line 1", ReadToEnd("<!-- nothing -->"));
+	EXPECT_EQ("The document ends inside an element at line 2", ReadToEnd("<Root>\n<Child>"));
+	EXPECT_EQ("The end tag does not match the start tag at line 1", ReadToEnd("<Root><Child></Root>"));
+	EXPECT_EQ("The end tag does not match the start tag at line 1", ReadToEnd("<Root></Roots>"));
+	EXPECT_EQ("More than one root element at line 1", ReadToEnd("<Root/><Root/>"));
+	EXPECT_EQ("Text outside of the root element at line 1", ReadToEnd("text<Root/>"));
+	EXPECT_EQ("Unterminated comment at line 1", ReadToEnd("<Root><!-- open"));
+	EXPECT_EQ("Unterminated CDATA section at line 1", ReadToEnd("<Root><![CDATA[ open"));
+	EXPECT_EQ("Unterminated start tag at line 1", ReadToEnd("<Root a=\"1\""));
+	EXPECT_EQ("Unterminated attribute value at line 1", ReadToEnd("<Root a=\"1>"));
+	EXPECT_EQ("Attribute value without quotes at line 1", ReadToEnd("<Root a=1/>"));
+	EXPECT_EQ("Attribute without a value at line 1", ReadToEnd("<Root a/>"));
+	EXPECT_EQ("Bad element name at line 3", ReadToEnd("<Root>\n\n< Child/></Root>"));
+	EXPECT_EQ("Bad end tag at line 1", ReadToEnd("<Root></Root"));
+
+	// An error sticks, and the helpers give up on it
+	XmlReader reader;
+	OpenString(&reader, "<Root><A></B><C/></Root>");
+	ASSERT_TRUE(reader.NextChild(0));
+	EXPECT_TRUE(reader.NextChild(1));
+	EXPECT_FALSE(reader.NextChild(1));
+	EXPECT_TRUE(reader.HasError());
+	EXPECT_EQ(XmlReader::Token_Error, reader.Next());
+
+	EXPECT_FALSE(reader.Open("/nonexistent/ozw.xml"));
+	EXPECT_TRUE(reader.HasError());
+	EXPECT_FALSE(reader.GetError().empty());
+}
+
+// The config files the reader loads give the same elements, attributes and
+// text as TinyXML reads from them
+TEST(XmlReader, MatchesTinyXml)
+{
+	string configPath = FindConfigPath();
+	ASSERT_FALSE(configPath.empty());
+	char const* files[] =
+	{ "manufacturer_specific.xml", "Localization.xml", "NotificationCCTypes.xml", "aeotec/zw100.xml", "wink/wnk-mot1.xml" };
+	for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+	{
+		string filename = configPath + files[i];
+		TiXmlDocument doc;
+		ASSERT_TRUE(doc.LoadFile(filename.c_str(), TIXML_ENCODING_UTF8)) << filename;
+		XmlReader reader;
+		ASSERT_TRUE(reader.Open(filename)) << filename;
+		ASSERT_TRUE(reader.NextChild(0)) << reader.GetError();
+		CompareElement(doc.RootElement(), &reader);
+		if (HasFatalFailure())
+		{
+			return;
+		}
+		EXPECT_EQ(XmlReader::Token_EndOfDocument, reader.Next()) << filename;
+	}
+}
+
+} // namespace Testing
+} // namespace OpenZWave
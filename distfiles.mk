@@ -1411,6 +1411,7 @@ DISTFILES =	.gitignore \
 	cpp/build/LeakSanitizer-Suppressions.txt \
 	cpp/build/Makefile \
 	cpp/build/OZW_RunTests.sh \
+	cpp/build/configtables.pl \
 	cpp/build/libopenzwave.pc.in \
 	cpp/build/ozw_config.in \
 	cpp/build/sh2ju.sh \
@@ -1481,10 +1482,19 @@ DISTFILES =	.gitignore \
 	cpp/hidapi/windows/hidapi.sln \
 	cpp/hidapi/windows/hidapi.vcproj \
 	cpp/hidapi/windows/hidtest.vcproj \
+	cpp/src/AesKey.cpp \
+	cpp/src/AesKey.h \
+	cpp/src/BinaryCache.cpp \
+	cpp/src/BinaryCache.h \
 	cpp/src/Bitfield.cpp \
 	cpp/src/Bitfield.h \
+	cpp/src/BlockPool.cpp \
+	cpp/src/BlockPool.h \
 	cpp/src/CompatOptionManager.cpp \
 	cpp/src/CompatOptionManager.h \
+	cpp/src/ConfigTableData.h \
+	cpp/src/ConfigTables.cpp \
+	cpp/src/ConfigTables.h \
 	cpp/src/DNSThread.cpp \
 	cpp/src/DNSThread.h \
 	cpp/src/Defs.h \
@@ -1495,6 +1505,8 @@ DISTFILES =	.gitignore \
 	cpp/src/Group.h \
 	cpp/src/Http.cpp \
 	cpp/src/Http.h \
+	cpp/src/LatencyHistogram.cpp \
+	cpp/src/LatencyHistogram.h \
 	cpp/src/Localization.cpp \
 	cpp/src/Localization.h \
 	cpp/src/Manager.cpp \
@@ -1509,7 +1521,10 @@ DISTFILES =	.gitignore \
 	cpp/src/Notification.h \
 	cpp/src/NotificationCCTypes.cpp \
 	cpp/src/NotificationCCTypes.h \
+	cpp/src/NotificationDispatcher.cpp \
+	cpp/src/NotificationDispatcher.h \
 	cpp/src/OZWException.h \
+	cpp/src/OptionList.h \
 	cpp/src/Options.cpp \
 	cpp/src/Options.h \
 	cpp/src/Scene.cpp \
@@ -1523,6 +1538,8 @@ DISTFILES =	.gitignore \
 	cpp/src/ValueIDIndexes.h \
 	cpp/src/ValueIDIndexesDefines.def \
 	cpp/src/ValueIDIndexesDefines.h \
+	cpp/src/XmlReader.cpp \
+	cpp/src/XmlReader.h \
 	cpp/src/ZWSecurity.cpp \
 	cpp/src/ZWSecurity.h \
 	cpp/src/aes/aes.h \
@@ -1675,12 +1692,18 @@ DISTFILES =	.gitignore \
 	cpp/src/platform/Ref.h \
 	cpp/src/platform/SerialController.cpp \
 	cpp/src/platform/SerialController.h \
+	cpp/src/platform/SharedMutex.cpp \
+	cpp/src/platform/SharedMutex.h \
 	cpp/src/platform/Stream.cpp \
 	cpp/src/platform/Stream.h \
 	cpp/src/platform/Thread.cpp \
 	cpp/src/platform/Thread.h \
 	cpp/src/platform/TimeStamp.cpp \
 	cpp/src/platform/TimeStamp.h \
+	cpp/src/platform/VirtualController.cpp \
+	cpp/src/platform/VirtualController.h \
+	cpp/src/platform/VirtualNetwork.cpp \
+	cpp/src/platform/VirtualNetwork.h \
 	cpp/src/platform/Wait.cpp \
 	cpp/src/platform/Wait.h \
 	cpp/src/platform/unix/DNSImpl.cpp \
@@ -1764,12 +1787,29 @@ DISTFILES =	.gitignore \
 	cpp/src/value_classes/ValueSchedule.h \
 	cpp/src/value_classes/ValueShort.cpp \
 	cpp/src/value_classes/ValueShort.h \
+	cpp/src/value_classes/ValueSnapshot.h \
+	cpp/src/value_classes/ValueSnapshotTable.cpp \
+	cpp/src/value_classes/ValueSnapshotTable.h \
 	cpp/src/value_classes/ValueStore.cpp \
 	cpp/src/value_classes/ValueStore.h \
 	cpp/src/value_classes/ValueString.cpp \
 	cpp/src/value_classes/ValueString.h \
+	cpp/test/AesKey_test.cpp \
+	cpp/test/Benchmark_test.cpp \
+	cpp/test/BinaryCache_test.cpp \
+	cpp/test/CompatOptionManager_test.cpp \
+	cpp/test/ConfigTables_test.cpp \
+	cpp/test/Driver_test.cpp \
+	cpp/test/Log_test.cpp \
 	cpp/test/Makefile \
+	cpp/test/Msg_test.cpp \
+	cpp/test/SharedMutex_test.cpp \
+	cpp/test/TimerThread_test.cpp \
 	cpp/test/ValueID_test.cpp \
+	cpp/test/ValueSnapshotTable_test.cpp \
+	cpp/test/VirtualNetworkRun.cpp \
+	cpp/test/VirtualNetworkRun.h \
+	cpp/test/XmlReader_test.cpp \
 	cpp/test/include/gtest/gtest-death-test.h \
 	cpp/test/include/gtest/gtest-matchers.h \
 	cpp/test/include/gtest/gtest-message.h \